@@ -98,6 +98,7 @@ set(OGRE_SET_DISABLE_PVRTC 0)
 set(OGRE_SET_DISABLE_ETC 0)
 set(OGRE_SET_DISABLE_STBI 0)
 set(OGRE_SET_DISABLE_ZIP 0)
+set(OGRE_SET_DISABLE_PACK 0)
 set(OGRE_SET_DISABLE_VIEWPORT_ORIENTATIONMODE 0)
 set(OGRE_SET_DISABLE_GLES2_CG_SUPPORT 0)
 set(OGRE_SET_DISABLE_GLES2_GLSL_OPTIMISER 0)
@@ -149,6 +150,9 @@ endif()
 if (NOT OGRE_CONFIG_ENABLE_ZIP)
   set(OGRE_SET_DISABLE_ZIP 1)
 endif()
+if (NOT OGRE_CONFIG_ENABLE_PACK)
+  set(OGRE_SET_DISABLE_PACK 1)
+endif()
 if (NOT OGRE_CONFIG_ENABLE_VIEWPORT_ORIENTATIONMODE)
   set(OGRE_SET_DISABLE_VIEWPORT_ORIENTATIONMODE 1)
 endif()
@@ -83,6 +83,10 @@ if (ZLIB_FOUND)
   macro_log_feature(ZZip_FOUND "zziplib" "Extract data from zip archives" "http://zziplib.sourceforge.net" FALSE "" "")
 endif ()
 
+# Find LZ4
+find_package(LZ4)
+macro_log_feature(LZ4_FOUND "lz4" "Fast compression library, used by pack archives" "http://www.lz4.org" FALSE "" "")
+
 # Find FreeImage
 find_package(FreeImage)
 macro_log_feature(FreeImage_FOUND "freeimage" "Support for commonly used graphics image formats" "http://freeimage.sourceforge.net" FALSE "" "")
@@ -297,6 +301,7 @@ MACRO_DISPLAY_FEATURE_LOG()
 include_directories(
   ${ZLIB_INCLUDE_DIRS}
   ${ZZip_INCLUDE_DIRS}
+  ${LZ4_INCLUDE_DIRS}
   ${FreeImage_INCLUDE_DIRS}
   ${FREETYPE_INCLUDE_DIRS}
   ${OPENGL_INCLUDE_DIRS}
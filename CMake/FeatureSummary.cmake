@@ -57,6 +57,9 @@ endif ()
 if (OGRE_BUILD_PLUGIN_BSP)
 	set(_plugins "${_plugins}  + BSP scene manager\n")
 endif ()
+if (OGRE_BUILD_PLUGIN_BVH)
+	set(_plugins "${_plugins}  + BVH scene manager\n")
+endif ()
 if (OGRE_BUILD_PLUGIN_CG)
 	set(_plugins "${_plugins}  + Cg program manager\n")
 endif ()
@@ -93,6 +96,9 @@ endif ()
 if (OGRE_BUILD_RENDERSYSTEM_GLES2)
 	set(_rendersystems "${_rendersystems}  + OpenGL ES 2.x\n")
 endif ()
+if (OGRE_BUILD_RENDERSYSTEM_NULL)
+	set(_rendersystems "${_rendersystems}  + Null (headless)\n")
+endif ()
 
 if (DEFINED _rendersystems)
 	set(_features "${_features}Building rendersystems:\n${_rendersystems}")
@@ -135,6 +141,9 @@ endif ()
 if (OGRE_CONFIG_ENABLE_ZIP)
 	set(_core "${_core}  + ZIP archives\n")
 endif ()
+if (OGRE_CONFIG_ENABLE_PACK)
+	set(_core "${_core}  + Pack archives\n")
+endif ()
 if (OGRE_CONFIG_ENABLE_VIEWPORT_ORIENTATIONMODE)
 	set(_core "${_core}  + Viewport orientation mode support\n")
 endif ()
@@ -0,0 +1,50 @@
+#-------------------------------------------------------------------
+# This file is part of the CMake build system for OGRE
+#     (Object-oriented Graphics Rendering Engine)
+# For the latest info, see http://www.ogre3d.org/
+#
+# The contents of this file are placed in the public domain. Feel
+# free to make use of it in any way you like.
+#-------------------------------------------------------------------
+
+# - Try to find the LZ4 compression library
+# Once done, this will define
+#
+#  LZ4_FOUND - system has LZ4
+#  LZ4_INCLUDE_DIRS - the LZ4 include directories 
+#  LZ4_LIBRARIES - link these to use LZ4
+
+include(FindPkgMacros)
+findpkg_begin(LZ4)
+
+# Get path, convert backslashes as ${ENV_${var}}
+getenv_path(LZ4_HOME)
+
+
+# construct search paths
+set(LZ4_PREFIX_PATH ${LZ4_HOME} ${ENV_LZ4_HOME})
+create_search_paths(LZ4)
+# redo search if prefix path changed
+clear_if_changed(LZ4_PREFIX_PATH
+  LZ4_LIBRARY_FWK
+  LZ4_LIBRARY_REL
+  LZ4_LIBRARY_DBG
+  LZ4_INCLUDE_DIR
+)
+
+set(LZ4_LIBRARY_NAMES lz4 liblz4)
+get_debug_names(LZ4_LIBRARY_NAMES)
+
+use_pkgconfig(LZ4_PKGC liblz4)
+
+findpkg_framework(LZ4)
+
+find_path(LZ4_INCLUDE_DIR NAMES lz4.h HINTS ${LZ4_INC_SEARCH_PATH} ${LZ4_PKGC_INCLUDE_DIRS})
+
+find_library(LZ4_LIBRARY_REL NAMES ${LZ4_LIBRARY_NAMES} HINTS ${LZ4_LIB_SEARCH_PATH} ${LZ4_PKGC_LIBRARY_DIRS} PATH_SUFFIXES "" Release RelWithDebInfo MinSizeRel)
+find_library(LZ4_LIBRARY_DBG NAMES ${LZ4_LIBRARY_NAMES_DBG} HINTS ${LZ4_LIB_SEARCH_PATH} ${LZ4_PKGC_LIBRARY_DIRS} PATH_SUFFIXES "" Debug)
+
+make_library_set(LZ4_LIBRARY)
+
+findpkg_finish(LZ4)
+
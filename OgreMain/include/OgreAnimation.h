@@ -258,8 +258,11 @@ namespace Ogre {
             other animations.
         @param scale The scale to apply to translations and scalings, useful for 
             adapting an animation to a different size target.
+        @param cursor Optional key positions cached between calls, used by
+            compressed node tracks (@see AnimationState::_getKeyCursor).
         */
-        void apply(Skeleton* skeleton, Real timePos, Real weight = 1.0, Real scale = 1.0f);
+        void apply(Skeleton* skeleton, Real timePos, Real weight = 1.0, Real scale = 1.0f,
+            AnimationState::KeyCursor* cursor = 0);
 
         /** Applies all node tracks given a specific time point and weight to a given skeleton.
         @remarks
@@ -272,9 +275,12 @@ namespace Ogre {
             be modulated with the weight factor.
         @param scale The scale to apply to translations and scalings, useful for 
             adapting an animation to a different size target.
+        @param cursor Optional key positions cached between calls, used by
+            compressed node tracks (@see AnimationState::_getKeyCursor).
         */
         void apply(Skeleton* skeleton, Real timePos, float weight,
-          const AnimationState::BoneBlendMask* blendMask, Real scale);
+          const AnimationState::BoneBlendMask* blendMask, Real scale,
+          AnimationState::KeyCursor* cursor = 0);
 
         /** Applies all vertex tracks given a specific time point and weight to a given entity.
         @param entity The Entity to which this animation should be applied
@@ -418,6 +424,40 @@ namespace Ogre {
         */
         void optimise(bool discardIdentityNodeTracks = true);
 
+        /** Replaces the node tracks of this animation with a compressed copy.
+        @remarks
+            The compressed data takes a fraction of the memory and is cheaper to
+            apply to a skeleton, at the price of quantisation and of keys being
+            dropped where interpolation reproduces them within the given
+            tolerances (@see CompressedNodeTracks). Node tracks are destroyed,
+            so node track accessors return nothing afterwards; use
+            decompressNodeTracks to get editable tracks back.
+        @par
+            Any base keyframe is applied first. Rotations are interpolated
+            linearly from then on, and tracks are applied to skeletons only.
+        @param positionTolerance Maximum translation error allowed
+        @param rotationTolerance Maximum rotation error allowed
+        @param scaleTolerance Maximum scale error allowed
+        */
+        void compressNodeTracks(Real positionTolerance = 0.001f,
+            const Radian& rotationTolerance = Degree(0.1f), Real scaleTolerance = 0.001f);
+
+        /** Recreates regular node tracks from the compressed data, if any.
+        @param skeleton Optional skeleton whose bones to associate the tracks with.
+        */
+        void decompressNodeTracks(const Skeleton* skeleton = 0);
+
+        /** Returns whether this animation holds compressed node tracks. */
+        bool hasCompressedNodeTracks(void) const { return mCompressedNodeTracks != 0; }
+
+        /** Gets the compressed node tracks of this animation, or 0 if none. */
+        const CompressedNodeTracks* getCompressedNodeTracks(void) const { return mCompressedNodeTracks; }
+
+        /** Internal method to set the compressed node tracks, which this
+            animation takes ownership of (used when loading).
+        */
+        void _setCompressedNodeTracks(CompressedNodeTracks* tracks);
+
         /// A list of track handles
         typedef set<ushort>::type TrackHandleList;
 
@@ -457,6 +497,14 @@ namespace Ogre {
             global keyframe time list.
         */
         TimeIndex _getTimeIndex(Real timePos) const;
+
+        /** Internal method which builds the data otherwise built on demand the
+            first time the animation is applied.
+        @remarks
+            Applying an animation is then free of side effects on the animation
+            itself, so it can be applied from several threads at once.
+        */
+        void _prepareConcurrentApply(void) const;
         
         /** Sets a base keyframe which for the skeletal / pose keyframes 
             in this animation. 
@@ -527,6 +575,8 @@ namespace Ogre {
         Real mBaseKeyFrameTime;
         String mBaseKeyFrameAnimationName;
         AnimationContainer* mContainer;
+        /// Compressed replacement of the node tracks, if any
+        CompressedNodeTracks* mCompressedNodeTracks;
 
         void optimiseNodeTracks(bool discardIdentityTracks);
         void optimiseVertexTracks(void);
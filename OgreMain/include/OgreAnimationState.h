@@ -57,6 +57,8 @@ namespace Ogre {
 
         /// Typedef for an array of float values used as a bone blend mask
         typedef vector<float>::type BoneBlendMask;
+        /// Typedef for the per track key positions kept between applications
+        typedef vector<uint32>::type KeyCursor;
 
         /** Normal constructor with all params supplied
             @param
@@ -169,9 +171,15 @@ namespace Ogre {
           assert(mBlendMask && mBlendMask->size() > boneHandle);
           return (*mBlendMask)[boneHandle];
       }
+        /** Internal access to the key positions compressed node tracks
+            stopped at the last time this state was applied (@see CompressedNodeTracks).
+        */
+        KeyCursor& _getKeyCursor(void) const { return mKeyCursor; }
     protected:
         /// The blend mask (containing per bone weights)
         BoneBlendMask* mBlendMask;
+        /// Key positions cached by compressed node tracks
+        mutable KeyCursor mKeyCursor;
 
         String mAnimationName;
         AnimationStateSet* mParent;
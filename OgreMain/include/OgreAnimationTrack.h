@@ -384,6 +384,12 @@ namespace Ogre
         NodeAnimationTrack* _clone(Animation* newParent) const;
         
         void _applyBaseKeyFrame(const KeyFrame* base);
+
+        /** Internal method which builds the interpolation splines now if the
+            parent animation uses them, rather than on demand.
+        @see Animation::_prepareConcurrentApply
+        */
+        void _prepareConcurrentApply(void) const;
         
     protected:
         /// Specialised keyframe creation
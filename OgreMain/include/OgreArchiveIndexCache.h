@@ -0,0 +1,144 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ArchiveIndexCache_H__
+#define __ArchiveIndexCache_H__
+
+#include "OgrePrerequisites.h"
+
+#include "OgreArchive.h"
+#include "OgreDataStream.h"
+#include "OgreHeaderPrefix.h"
+#include "Threading/OgreThreadHeaders.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** Remembers the files of archives, so they don't have to be listed again
+        every time the application starts.
+    @remarks
+        ResourceGroupManager lists all the files of a resource location when it
+        is added, to index them, and searches them again for every script
+        pattern when its group is initialised. For a file system location, each
+        of these walks the whole folder tree. This cache keeps the files of each
+        archive, as Archive::findFileInfo finds them with "*", by type, name and
+        whether it is searched recursively, and can be saved to a stream and
+        loaded back on the next run.
+    @par
+        A list is reused as long as the archive hasn't changed, which is
+        checked cheaply: for a file system archive, by the modification times
+        of its folders, which change whenever a file is added to, removed from
+        or renamed in them; for an archive in a single file, like a zip, by the
+        modification time and size of the file. Lists are only kept for
+        archives which were last changed before they were listed, so changes
+        made within the resolution of the modification times are not missed.
+        Other archives, like those in an Android package, are always listed.
+        The sizes of files changed in place are not updated, the lists are
+        meant for finding files.
+    */
+    class _OgreExport ArchiveIndexCache : public ArchiveAlloc
+    {
+    public:
+        ArchiveIndexCache();
+        ~ArchiveIndexCache();
+
+        /** Finds the files of an archive matching a pattern, like
+            Archive::findFileInfo, reusing the cached list if it's still valid.
+        @remarks
+            Only patterns with a '*' and no folder or other wildcards are looked
+            up in the cache, which all archives match against the base names of
+            the files they find with "*"; others are passed on to the archive.
+        */
+        FileInfoListPtr findFileInfo(Archive* arch, const String& pattern, bool recursive);
+
+        /** Writes the cached lists to a stream. */
+        void save(const DataStreamPtr& stream) const;
+
+        /** Replaces the cached lists with those read from a stream, as written
+            by save.
+        @remarks
+            A cache which can't be read, like one written by another version
+            of OGRE, is ignored, leaving the cache empty.
+        */
+        void load(const DataStreamPtr& stream);
+
+        /// Returns whether lists were added or replaced since the cache was loaded or saved
+        bool isDirty(void) const { return mDirty; }
+
+        /// Forgets all lists
+        void clear(void);
+
+    protected:
+        /// What an archive, or one of its folders, looked like when listed
+        struct Stamp
+        {
+            /// Folder within the archive, empty for the archive itself
+            String path;
+            int64 modified;
+            uint64 size;
+        };
+        typedef vector<Stamp>::type StampList;
+
+        struct Entry
+        {
+            StampList stamps;
+            /// Files found with "*", as the archive names them, with no archive set
+            FileInfoList files;
+        };
+        /// Entries by type, recursion and name of their archive
+        typedef map<String, Entry>::type EntryMap;
+
+        EntryMap mEntries;
+        mutable bool mDirty;
+        OGRE_AUTO_MUTEX;
+
+        /** Reads the stamps of an archive as it is now.
+        @param folders The folders of the archive, for a file system archive
+        @return Whether the archive can be cached
+        */
+        bool readStamps(Archive* arch, const StringVector& folders, StampList& stamps) const;
+        /** Returns the valid entry of an archive, listing it again if needed.
+        @param uncached Filled in and returned instead for an archive changed
+            too recently to be cached
+        @return Null if the archive can't be cached at all
+        */
+        const Entry* getEntry(Archive* arch, bool recursive, Entry& uncached);
+    };
+
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -594,6 +594,14 @@ namespace Ogre {
 
         /// @copydoc Frustum::isVisible(const AxisAlignedBox&, FrustumPlane*) const
         bool isVisible(const AxisAlignedBox& bound, FrustumPlane* culledBy = 0) const;
+        /** @copydoc Frustum::areVisible
+        @note
+            Unless a custom culling frustum is set, the boxes are tested together
+            (see Frustum::cullBoxes), so subclasses overriding
+            isVisible(const AxisAlignedBox&, FrustumPlane*) must override this
+            method as well.
+        */
+        void areVisible(const AxisAlignedBox* const* bounds, size_t count, bool* visible) const;
         /// @copydoc Frustum::isVisible(const Sphere&, FrustumPlane*) const
         bool isVisible(const Sphere& bound, FrustumPlane* culledBy = 0) const;
         /// @copydoc Frustum::isVisible(const Vector3&, FrustumPlane*) const
@@ -0,0 +1,196 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __CompressedNodeTracks_H__
+#define __CompressedNodeTracks_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAnimationState.h"
+#include "OgreQuaternion.h"
+#include "OgreVector3.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+
+    /** \addtogroup Animation
+    *  @{
+    */
+
+    /** Compact, read-only storage for all the node tracks of an Animation.
+    @remarks
+        Regular NodeAnimationTrack instances hold one heap allocated
+        TransformKeyFrame per key, which is convenient for editing but costs
+        ~100 bytes per key and a pointer chase for every key visited when
+        sampling. This class holds the same data packed contiguously:
+        <ul>
+        <li>Rotations are stored 'smallest three' style in 3 x 16 bits, the
+            largest component being rebuilt from the unit length.</li>
+        <li>Translations and scales are quantised to 3 x 16 bits within the
+            range covered by each track, and are not stored at all for
+            tracks where they are constant.</li>
+        <li>Keys which linear interpolation of their neighbours reproduces
+            within a given tolerance are dropped.</li>
+        </ul>
+    @par
+        Sampling evaluates all tracks together, a block of tracks at a time,
+        using SIMD where available. The key each track stopped at is kept in
+        a cursor (usually the one owned by the AnimationState), so advancing
+        time never searches the keys.
+    @note
+        Interpolation is always linear, with rotations normalised-lerped along
+        the shortest path, whatever the interpolation modes of the parent
+        Animation. Use Animation::compressNodeTracks to create an instance.
+    */
+    class _OgreExport CompressedNodeTracks : public AnimationAlloc
+    {
+    public:
+        /// Maximum error allowed when dropping keys
+        struct Tolerance
+        {
+            /// Maximum distance between original and reconstructed translations
+            Real position;
+            /// Maximum angle between original and reconstructed rotations
+            Radian rotation;
+            /// Maximum distance between original and reconstructed scales
+            Real scale;
+
+            Tolerance(Real pos = 0.001f, const Radian& rot = Degree(0.1f), Real scl = 0.001f)
+                : position(pos), rotation(rot), scale(scl) {}
+        };
+
+        /// Transform of a single track at a given time
+        struct SampledTransform
+        {
+            Quaternion rotation;
+            Vector3 translation;
+            Vector3 scale;
+        };
+
+        /// Constructor, does not compress anything yet (@see build)
+        CompressedNodeTracks(Animation* parent);
+        ~CompressedNodeTracks();
+
+        /** Compresses the node tracks of the parent animation.
+        @remarks
+            Any previously compressed data is discarded. The node tracks of the
+            parent are left alone, it is up to the caller to destroy them.
+        */
+        void build(const Tolerance& tolerance);
+
+        /// Gets the Animation this data belongs to
+        Animation* getParent(void) const { return mParent; }
+        /// Gets the number of tracks held
+        size_t getNumTracks(void) const { return mTracks.size(); }
+        /// Gets the handle of the track at the given index
+        unsigned short getTrackHandle(size_t index) const;
+        /// Gets the number of keys left over all tracks after reduction
+        size_t getNumKeyFrames(void) const { return mKeyTimes.size(); }
+        /// Gets the number of bytes used by this data
+        size_t getMemoryUsage(void) const;
+
+        /** Samples every track at the given time.
+        @param timePos The time position in the animation, wrapped like
+            Animation::_getTimeIndex does.
+        @param cursor Key positions to start searching from, updated on
+            return. May be 0, in which case every track is searched.
+        @param result Array of getNumTracks() transforms receiving the
+            samples, in track order.
+        */
+        void sample(Real timePos, AnimationState::KeyCursor* cursor,
+            SampledTransform* result) const;
+
+        /** Applies every track to the bones of a skeleton, with the same
+            semantics as Animation::apply.
+        @param blendMask Optional per bone weights, may be 0.
+        @param cursor As for sample, may be 0.
+        */
+        void apply(Skeleton* skeleton, Real timePos, Real weight,
+            const AnimationState::BoneBlendMask* blendMask, Real scale,
+            AnimationState::KeyCursor* cursor) const;
+
+        /** Recreates regular node tracks in the parent animation from this data.
+        @param skeleton Optional skeleton whose bones to associate the
+            recreated tracks with.
+        */
+        void decompress(const Skeleton* skeleton = 0) const;
+
+        /** Clone this data (internal use only) */
+        CompressedNodeTracks* _clone(Animation* newParent) const;
+
+    protected:
+        friend class SkeletonSerializer;
+
+        /// Marks a channel held as a single value in the track info
+        static const uint32 CONSTANT_CHANNEL = 0xFFFFFFFF;
+
+        struct TrackInfo
+        {
+            unsigned short handle;
+            /// Index of the first key in mKeyTimes & mRotations
+            uint32 firstKey;
+            uint32 numKeys;
+            /// Index of the first key in mTranslations, or CONSTANT_CHANNEL
+            uint32 firstTranslation;
+            /// Index of the first key in mScales, or CONSTANT_CHANNEL
+            uint32 firstScale;
+            /// Quantisation range (or the value itself when constant)
+            Vector3 translationMin;
+            Vector3 translationExtent;
+            Vector3 scaleMin;
+            Vector3 scaleExtent;
+        };
+        typedef vector<TrackInfo>::type TrackInfoList;
+        typedef vector<float>::type KeyTimeList;
+        typedef vector<uint16>::type PackedValueList;
+
+        Animation* mParent;
+        TrackInfoList mTracks;
+        /// Key times, contiguous per track
+        KeyTimeList mKeyTimes;
+        /// 3 packed components per key, contiguous per track
+        PackedValueList mRotations;
+        PackedValueList mTranslations;
+        PackedValueList mScales;
+
+        /// Samples the tracks [first, first + count), count <= SAMPLE_BLOCK_SIZE
+        void sampleBlock(Real timePos, size_t first, size_t count,
+            AnimationState::KeyCursor* cursor, SampledTransform* result) const;
+        /// Wraps the time position to the parent animation length
+        Real wrapTime(Real timePos) const;
+    };
+
+    /** @} */
+    /** @} */
+} // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __CompressedNodeTracks_H__
@@ -193,4 +193,10 @@ WARNING: Disabling this will make the samples unusable.
 #define OGRE_NO_ZIP_ARCHIVE 0
 #endif
 
+/** Disables use of the pack archive support, which needs the LZ4 library.
+*/
+#ifndef OGRE_NO_PACK_ARCHIVE
+#define OGRE_NO_PACK_ARCHIVE 0
+#endif
+
 #endif
@@ -475,6 +475,46 @@ namespace Ogre {
         void setFreeOnClose(bool free) { mFreeOnClose = free; }
     };
 
+    /** Subclass of MemoryDataStream reading a file through a read-only memory
+        mapping of it.
+    @remarks
+        The file is mapped rather than read, so getPtr and getCurrentPtr give
+        access to its contents without any copy, the pages being read in by
+        the operating system as they are first touched. Serializers and codecs
+        which need the whole of a stream in memory can therefore parse it in
+        place instead of buffering it in a MemoryDataStream of their own.
+    @par
+        The stream is always read-only; the mapped memory must not be written
+        to through getPtr. Memory mapping is only available on platforms with
+        POSIX mmap, see isSupported.
+    */
+    class _OgreExport MappedFileDataStream : public MemoryDataStream
+    {
+    protected:
+        /// Start of the mapping, if any
+        void* mMapping;
+        /// Size of the mapping in bytes
+        size_t mMappingSize;
+    public:
+        /** Map a file into memory.
+        @param name The name to give the stream
+        @param path The path of the file in the file system
+        @remarks
+            Throws if the file cannot be opened or mapped. Empty files are
+            not mapped, the stream simply holds no data.
+        */
+        MappedFileDataStream(const String& name, const String& path);
+
+        ~MappedFileDataStream();
+
+        /** @copydoc DataStream::close
+        */
+        void close(void);
+
+        /** Returns whether files can be memory mapped on this platform. */
+        static bool isSupported(void);
+    };
+
     /** Common subclass of DataStream for handling data from 
         std::basic_istream.
     */
@@ -56,6 +56,17 @@ namespace Ogre
     */
     class _OgreExport DeflateStream : public DataStream
     {
+    public:
+        /** Requested stream type. Both use the same deflate algorithm, they
+            differ in the headers around the compressed data.
+        */
+        enum StreamType
+        {
+            /// Data with zlib headers, as this stream writes by default
+            ZLib,
+            /// Raw deflated data without any headers, as found in zip archives
+            Deflate
+        };
     protected:
         DataStreamPtr mCompressedStream;
         DataStreamPtr mTmpWriteStream;
@@ -72,6 +83,8 @@ namespace Ogre
         
         /// Whether the underlying stream is valid compressed data
         bool mIsCompressedValid;
+
+        StreamType mStreamType;
         
         void init();
         void destroy();
@@ -85,9 +98,10 @@ namespace Ogre
          @param tmpFileName Path/Filename to be used for temporary storage of incoming data
          @param avail_in Available data length to be uncompressed. With it we can uncompress
             DataStream partly.
+         @param streamType The headers the compressed data has
         */
         DeflateStream(const DataStreamPtr& compressedStream, const String& tmpFileName = "",
-            size_t avail_in = 0);
+            size_t avail_in = 0, StreamType streamType = ZLib);
         /** Constructor for creating named stream wrapping another stream.
          @param name The name to give this stream
          @param compressedStream The stream that this stream will use when reading / 
@@ -95,9 +109,10 @@ namespace Ogre
          @param tmpFileName Path/Filename to be used for temporary storage of incoming data
          @param avail_in Available data length to be uncompressed. With it we can uncompress
             DataStream partly.
+         @param streamType The headers the compressed data has
          */
         DeflateStream(const String& name, const DataStreamPtr& compressedStream, const String& tmpFileName="",
-            size_t avail_in = 0);
+            size_t avail_in = 0, StreamType streamType = ZLib);
         
         ~DeflateStream();
         
@@ -35,6 +35,8 @@ THE SOFTWARE.
 #include "OgreQuaternion.h"
 #include "OgreVector3.h"
 #include "OgreHardwareBufferManager.h"
+#include "OgreMesh.h"
+#include "OgreMeshTriangleBvh.h"
 #include "OgreRenderable.h"
 #include "OgreResourceGroupManager.h"
 #include "OgreHeaderPrefix.h"
@@ -87,6 +89,21 @@ namespace Ogre {
         typedef set<Entity*>::type EntitySet;
         typedef map<unsigned short, bool>::type SchemeHardwareAnimMap;
 
+        /** One level of reduced skeletal animation detail, see setAnimationLodLevels. */
+        struct AnimationLodLevel
+        {
+            /// LOD value from which the level is used, in the units of the mesh LOD strategy
+            Real userValue;
+            /// Frames between evaluations of the animation, 1 to evaluate it every frame
+            ushort updateInterval;
+            /// Weight per bone handle, 0 to stop animating a bone; empty to animate all bones
+            AnimationState::BoneBlendMask boneMask;
+
+            AnimationLodLevel(Real value = 0, ushort interval = 1)
+                : userValue(value), updateInterval(interval) {}
+        };
+        typedef vector<AnimationLodLevel>::type AnimationLodLevelList;
+
     protected:
 
         /** Private constructor (instances cannot be created directly).
@@ -135,6 +152,17 @@ namespace Ogre {
             any SubMesh, finds the corresponding SubEntity.
         */
         SubEntity* findSubEntityForVertexData(const VertexData* orig);
+        /** Internal method - brings the shadow renderables up to date for a
+            light, extruding vertices in software if requested, ahead of
+            finding the silhouette.
+        @param lightPos
+            Receives the position of the light in object space.
+        @return
+            The edge list, or null if there is none.
+        */
+        EdgeData* prepareShadowRenderables(const Light* light,
+            HardwareIndexBufferSharedPtr* indexBuffer, bool extrude,
+            Real extrusionDistance, Vector4& lightPos);
 
         /** Internal method for extracting metadata out of source vertex data
             for fast assignment of temporary buffers later.
@@ -201,6 +229,59 @@ namespace Ogre {
         */
         bool cacheBoneMatrices(void);
 
+        /// Skeletal animation LOD, see setAnimationLodLevels
+        AnimationLodLevelList mAnimationLodLevels;
+        /// Values of mAnimationLodLevels transformed by the mesh LOD strategy, preceded by its base value
+        vector<Real>::type mAnimationLodValues;
+        /// Index of the animation LOD level in use, 0 for full detail
+        ushort mAnimationLodIndex;
+        /// Frames between evaluations of the animation while off screen, 0 for none
+        ushort mOffscreenAnimationInterval;
+        /// Last frame in which the entity was queued for a camera other than a shadow camera
+        unsigned long mFrameLastOnScreen;
+        /// Set when the entity comes back on screen, the animation must then be evaluated
+        bool mAnimationWoken;
+        /// Frame of the last evaluation of the animation under animation LOD
+        unsigned long mFrameAnimationLastEvaluated;
+        /// The previous and the last evaluation of the bone matrices, blended by animation LOD
+        Matrix4* mLodBoneMatrices;
+        /// Whether mLodBoneMatrices holds the last evaluation
+        bool mLodBoneMatricesValid;
+        /// Whether mBoneMatrices has yet to reach the last evaluation in mLodBoneMatrices
+        bool mBoneMatricesInterpolating;
+
+        /// Skinned pose of the mesh last tested by intersects
+        MeshTriangleBvh::Pose mIntersectPose;
+        /// Bone matrices mIntersectPose was skinned with
+        vector<Matrix4>::type mIntersectPoseBoneMatrices;
+
+        /** Fills in bone matrices from the skeleton instance, applying the
+            animation state first if requested, through the SkeletonAnimationCache
+            of the scene manager when it has one and the bones are not needed.
+        */
+        void evaluateBoneMatrices(Matrix4* pMatrices, bool applyAnimation,
+            const AnimationState::BoneBlendMask* boneMask);
+        /// Whether cacheBoneMatrices goes through animation LOD
+        bool isAnimationLodActive(void) const;
+        /// Records that the entity is queued for the current camera
+        void notifyOnScreen(void);
+        /** Brings the bone matrices up to date under animation LOD.
+        @return
+            True if the bone matrices have changed.
+        */
+        bool updateLodBoneMatrices(unsigned long frameNumber);
+
+        /// Software blend staged by _prepareConcurrentAnimationUpdate
+        struct ConcurrentVertexBlend
+        {
+            Mesh::SoftwareVertexBlendData data;
+            const Mesh::IndexMap* indexMap;
+        };
+        typedef vector<ConcurrentVertexBlend>::type ConcurrentVertexBlendList;
+        ConcurrentVertexBlendList mConcurrentVertexBlends;
+        /// Whether _updateAnimationConcurrently must also calculate mBoneWorldMatrices
+        bool mConcurrentBoneWorldMatrices;
+
         /// Flag determines whether or not to display skeleton.
         bool mDisplaySkeleton;
         /** Flag indicating whether hardware animation is supported by this entities materials
@@ -437,6 +518,21 @@ namespace Ogre {
         */
         void _updateRenderQueue(RenderQueue* queue);
 
+        /** @copydoc MovableObject::_canUpdateRenderQueueConcurrently
+        @remarks
+            True for entities without animation whose materials are all loaded.
+        */
+        bool _canUpdateRenderQueueConcurrently(void) const;
+
+        /** @copydoc MovableObject::_getRenderQueueSignature
+        @remarks
+            Covers the LOD in use and the visibility, material and queue
+            settings of each SubEntity, along with the active material scheme.
+            Entities which are animated, have objects attached to bones or
+            have a material which is not loaded always update the queue.
+        */
+        uint32 _getRenderQueueSignature(void) const;
+
         /** @copydoc MovableObject::getMovableType */
         const String& getMovableType(void) const;
 
@@ -606,6 +702,23 @@ namespace Ogre {
         /** @copydoc MovableObject::getWorldBoundingSphere */
         const Sphere& getWorldBoundingSphere(bool derive = false) const;
 
+        /** Finds the nearest triangle of the mesh hit by a ray.
+        @remarks
+            The triangles are found with the tree built by Mesh::getTriangleBvh.
+            If the skeleton is animated, its current pose is applied to the
+            vertices in software and the bounds of the tree are refitted
+            around them; both are kept until the bone matrices change, so
+            further rays in the same frame reuse them. Vertex animation and
+            LOD levels are not taken into account.
+        @param ray
+            Ray in world space.
+        @param hit
+            Receives the nearest hit, the distance being along the ray.
+        @return
+            Whether any triangle was hit.
+        */
+        bool intersects(const Ray& ray, MeshTriangleBvh::Hit& hit);
+
         /** @copydoc ShadowCaster::getEdgeList. */
         EdgeData* getEdgeList(void);
         /** @copydoc ShadowCaster::hasEdgeList. */
@@ -615,6 +728,16 @@ namespace Ogre {
             ShadowTechnique shadowTechnique, const Light* light,
             HardwareIndexBufferSharedPtr* indexBuffer, size_t* indexBufferUsedSize,
             bool extrudeVertices, Real extrusionDistance, unsigned long flags = 0);
+        /** @copydoc ShadowCaster::_prepareShadowVolume
+        @remarks
+            Animated entities update the face normals of the edge list of their
+            mesh, so they are left to getShadowVolumeRenderableIterator.
+        */
+        bool _prepareShadowVolume(
+            ShadowTechnique shadowTechnique, const Light* light,
+            HardwareIndexBufferSharedPtr* indexBuffer,
+            bool extrudeVertices, Real extrusionDistance, unsigned long flags,
+            ShadowVolumeBuild& build);
 
         /** Internal method for retrieving bone matrix information. */
         const Matrix4* _getBoneMatrices(void) const { return mBoneMatrices;}
@@ -735,6 +858,33 @@ namespace Ogre {
         */
         void _updateAnimation(void);
 
+        /** Prepares the update of the animation of this entity for this frame
+            to be performed by _updateAnimationConcurrently.
+        @remarks
+            Internal method called by the SceneManager on the main thread. The
+            animations to apply are made ready, and the temporary blend
+            buffers are checked out, bound and locked into @a locks, which the
+            caller unlocks once _updateAnimationConcurrently has returned.
+            Entities sharing their skeleton, with vertex animation, objects
+            attached to bones or manual LOD levels are not supported, and
+            left to update their animation when queued as usual.
+        @par
+            The animation LOD is calculated for @a cam here, as
+            _notifyCurrentCamera is only called once the update is done.
+        @return
+            True if _updateAnimationConcurrently must be called, false if
+            there is nothing to update or the update is not supported.
+        */
+        bool _prepareConcurrentAnimationUpdate(Camera* cam, Mesh::VertexBlendLockMap& locks);
+
+        /** Evaluates the skeleton and software skinning prepared by
+            _prepareConcurrentAnimationUpdate.
+        @remarks
+            May be called from a worker thread, concurrently with the same call
+            on other entities.
+        */
+        void _updateAnimationConcurrently(void);
+
         /** Tests if any animation applied to this entity.
         @remarks
             An entity is animated if any animation state is enabled, or any manual bone
@@ -885,6 +1035,48 @@ namespace Ogre {
             return mUpdateBoundingBoxFromSkeleton;
         }
 
+        /** Sets levels of reduced detail for the skeletal animation of this entity.
+        @remarks
+            The level is picked each time the entity is seen from a camera, from the
+            same biased LOD value as the mesh LOD level, so the user values are given
+            as for the LOD levels of the mesh (e.g. distances for the default strategy)
+            and must be sorted from the highest detail to the lowest.
+            Closer than the first level, the animation is evaluated every frame for
+            all bones.
+        @par
+            With an update interval greater than 1, the bone matrices are blended
+            from one evaluation of the animation to the next over the frames in
+            between, which keeps the motion smooth but makes it trail the animation
+            by up to updateInterval - 1 frames. Bones with a weight of 0 in the
+            bone mask are left in their binding pose.
+        @par
+            Ignored while the skeleton instance is shared with other entities or
+            while setSkipAnimationStateUpdate is enabled.
+        @see SceneManager::getSkeletonUpdateStats
+        */
+        void setAnimationLodLevels(const AnimationLodLevelList& levels);
+
+        /** Gets the levels of reduced skeletal animation detail. */
+        const AnimationLodLevelList& getAnimationLodLevels(void) const { return mAnimationLodLevels; }
+
+        /** Gets the skeletal animation LOD level in use, 0 for full detail and
+            i for the level at index i - 1 of getAnimationLodLevels. */
+        ushort getCurrentAnimationLodIndex(void) const { return mAnimationLodIndex; }
+
+        /** Sets how often the skeletal animation is evaluated while the entity is off screen.
+        @remarks
+            The entity counts as on screen in a frame in which it is queued for a
+            camera, other than a texture shadow camera, and in the frame after. Off
+            screen, for instance while it only casts shadows, its animation is only
+            evaluated every given number of frames, or not at all with 0, until it
+            comes back on screen where it is evaluated straight away. The default
+            of 1 evaluates it every frame. Ignored in the same cases as 
+            setAnimationLodLevels.
+        */
+        void setOffscreenAnimationInterval(ushort frames) { mOffscreenAnimationInterval = frames; }
+
+        /** Gets how often the skeletal animation is evaluated while the entity is off screen. */
+        ushort getOffscreenAnimationInterval(void) const { return mOffscreenAnimationInterval; }
         
     };
 
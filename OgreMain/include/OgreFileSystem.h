@@ -64,6 +64,9 @@ namespace Ogre {
         void findFiles(const String& pattern, bool recursive, bool dirs,
             StringVector* simpleList, FileInfoList* detailList);
 
+        /// Whether files opened read-only are memory mapped
+        bool mUseMemoryMapping;
+
         OGRE_AUTO_MUTEX;
     public:
         FileSystemArchive(const String& name, const String& archType, bool readOnly );
@@ -120,6 +123,22 @@ namespace Ogre {
             return msIgnoreHidden;
         }
 
+        /** Set whether files opened read-only from this archive are memory mapped.
+        @remarks
+            If enabled, open returns a MappedFileDataStream for files opened
+            read-only, whose contents can be parsed in place through
+            MemoryDataStream::getPtr rather than copied into memory first.
+            This has no effect on platforms not supporting memory mapped
+            files, see MappedFileDataStream::isSupported. The default is
+            false (files are read through a FileStreamDataStream). The
+            archive of a resource location can be found through
+            ResourceGroupManager::getResourceLocationList or ArchiveManager.
+        */
+        void setUseMemoryMapping(bool mapping) { mUseMemoryMapping = mapping; }
+
+        /// Get whether files opened read-only from this archive are memory mapped.
+        bool getUseMemoryMapping() const { return mUseMemoryMapping; }
+
         static bool msIgnoreHidden;
     };
 
@@ -0,0 +1,222 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __FrameAllocator_H__
+#define __FrameAllocator_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreSingleton.h"
+#include "OgreAtomicScalar.h"
+#include "Threading/OgreThreadHeaders.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Memory
+    *  @{
+    */
+    /** Linear arena for transient data which only lives within one frame.
+    @remarks
+        This is the allocator behind MEMCATEGORY_FRAME and FrameAllocPolicy. 
+        Allocating is a pointer bump in the current block, deallocating does 
+        nothing, and the whole arena is reset by Root at the end of every frame. 
+        When the blocks of a frame overflowed, they are merged into a single 
+        block on reset, so after a few frames the arena no longer touches the 
+        general allocator at all.
+    @par
+        Arenas nest: a Scope remembers the position of the arena when it is 
+        opened and rolls the arena back when it is closed, so memory used by 
+        one stage of the frame (eg. rendering one viewport) is reused by the 
+        next one. Containers allocated inside a Scope must therefore be 
+        destroyed before it closes, and a container allocated outside must 
+        not grow while a nested Scope is open.
+    @par
+        The arena belongs to the thread which created it. Allocations made from 
+        other threads, or while the arena is disabled, go to the general 
+        allocator instead and are counted as fallbacks. Memory from the arena 
+        must be released on the thread owning it.
+    @par
+        By default, Root will instantiate a FrameAllocator on construction.
+    */
+    class _OgreExport FrameAllocator : public Singleton<FrameAllocator>, public GeneralAllocatedObject
+    {
+    public:
+        /// A position in the arena, see getMarker
+        struct Marker
+        {
+            size_t block;
+            size_t offset;
+        };
+
+        /// Usage of the arena during a frame
+        struct Stats
+        {
+            /// Number of allocations served by the arena
+            size_t allocations;
+            /// Number of bytes requested from the arena
+            size_t bytes;
+            /// Number of allocations which went to the general allocator instead
+            size_t fallbacks;
+        };
+
+        /** Rolls the arena back to its current position when going out of scope.
+        @param allocator The arena, may be null in which case this does nothing
+        */
+        class Scope
+        {
+        public:
+            explicit Scope(FrameAllocator* allocator)
+                : mAllocator(allocator)
+            {
+                if (mAllocator)
+                    mMarker = mAllocator->getMarker();
+            }
+            ~Scope()
+            {
+                if (mAllocator)
+                    mAllocator->rollback(mMarker);
+            }
+        private:
+            // no copying allowed
+            Scope(const Scope&);
+            Scope& operator=(const Scope&);
+
+            FrameAllocator* mAllocator;
+            Marker mMarker;
+        };
+
+        /** Constructor.
+        @param blockSize Size in bytes of the blocks the arena is made of
+        */
+        FrameAllocator(size_t blockSize = 64 * 1024);
+        ~FrameAllocator();
+
+        /** Allocates memory from the arena.
+        @param count Number of bytes
+        @param align Alignment of the memory, 0 for the default alignment
+        @note
+            Must be called from the thread owning the arena, see isArenaThread.
+        */
+        void* allocate(size_t count, size_t align = 0);
+
+        /// Returns whether the given memory was allocated from this arena
+        bool owns(const void* ptr) const;
+
+        /// Returns the current position of the arena
+        Marker getMarker() const;
+
+        /** Releases everything allocated since the marker was taken.
+        @remarks
+            Markers must be rolled back to in the reverse order they were taken.
+        */
+        void rollback(const Marker& marker);
+
+        /** Releases everything allocated from the arena.
+        @remarks
+            If the arena grew beyond its first block, the blocks are merged so 
+            that the next frame fits in a single block.
+        */
+        void reset();
+
+        /** Enables or disables the arena.
+        @remarks
+            A disabled arena sends all requests to the general allocator, which 
+            is useful to compare the general allocator traffic with and without 
+            the arena. Enabled by default.
+        */
+        void setEnabled(bool enabled) { mEnabled = enabled; }
+
+        /// Returns whether the arena serves allocations
+        bool isEnabled() const { return mEnabled; }
+
+        /// Returns whether the calling thread may allocate from the arena
+        bool isArenaThread() const;
+
+        /// Returns the total size of the blocks of the arena
+        size_t getCapacity() const;
+
+        /// Returns the usage of the arena for the frame in progress
+        Stats getFrameStats() const;
+
+        /// Returns the usage of the arena during the last complete frame
+        const Stats& getLastFrameStats() const { return mLastFrameStats; }
+
+        /** Records the statistics of the frame and resets the arena.
+        @note
+            Called by Root at the end of every frame.
+        */
+        void _frameEnded();
+
+        /// Counts an allocation which had to go to the general allocator
+        void _notifyFallback() { ++mFallbacks; }
+
+        /// @copydoc Singleton::getSingleton()
+        static FrameAllocator& getSingleton(void);
+        /// @copydoc Singleton::getSingleton()
+        static FrameAllocator* getSingletonPtr(void);
+
+    protected:
+        struct Block
+        {
+            char* data;
+            size_t size;
+        };
+        typedef vector<Block>::type BlockList;
+
+        /// Allocates a block and appends it to the arena
+        void addBlock(size_t size);
+        /// Releases all the blocks
+        void freeBlocks();
+
+        BlockList mBlocks;
+        /// Block allocations are currently made from
+        size_t mCurrentBlock;
+        /// Offset of the first free byte in the current block
+        size_t mOffset;
+        size_t mBlockSize;
+        bool mEnabled;
+
+        size_t mAllocations;
+        size_t mBytes;
+        AtomicScalar<size_t> mFallbacks;
+        Stats mLastFrameStats;
+
+#if OGRE_THREAD_SUPPORT
+        OGRE_THREAD_ID_TYPE mThreadId;
+#endif
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -161,6 +161,11 @@ namespace Ogre
         virtual void invalidateFrustum(void) const;
         /// Signal to update view information.
         virtual void invalidateView(void) const;
+        /** Tests the given boxes against the frustum planes together using
+            OptimisedUtil::cullBoxes, giving the same results as
+            Frustum::isVisible(const AxisAlignedBox&, FrustumPlane*) for each box.
+        */
+        void cullBoxes(const AxisAlignedBox* const* bounds, size_t count, bool* visible) const;
 
         /// Shared class-level name for Movable type
         static String msMovableType;
@@ -442,6 +447,21 @@ namespace Ogre
         */
         virtual bool isVisible(const AxisAlignedBox& bound, FrustumPlane* culledBy = 0) const;
 
+        /** Tests whether each of the given bounding boxes is visible in the Frustum.
+        @remarks
+            The default implementation calls isVisible for each box. Camera
+            overrides it to test the boxes together using OptimisedUtil::cullBoxes,
+            which is much faster when many boxes have to be tested against the
+            same frustum.
+        @param bounds
+            Array of pointers to the bounding boxes to be checked (world space).
+        @param count
+            Number of bounding boxes.
+        @param visible
+            Array of count elements receiving the visibility of each box.
+        */
+        virtual void areVisible(const AxisAlignedBox* const* bounds, size_t count, bool* visible) const;
+
         /** Tests whether the given container is visible in the Frustum.
         @param bound
             Bounding sphere to be checked (world space).
@@ -0,0 +1,188 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __IndexedZip_H__
+#define __IndexedZip_H__
+
+#include "OgrePrerequisites.h"
+
+#if OGRE_NO_ZIP_ARCHIVE == 0
+
+#include "OgreArchive.h"
+#include "OgreArchiveFactory.h"
+#include "OgreHeaderPrefix.h"
+#include "Threading/OgreThreadHeaders.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** Specialisation of the Archive class reading zip archives through an
+        index of their central directory, so files can be opened concurrently.
+    @remarks
+        The central directory is read once when the archive is loaded and
+        hashed by path and by file name, so finding an entry doesn't scan the
+        file list. Unlike ZipArchive, which has to serialise every access to
+        zziplib, opening a file only reads the index, which doesn't change
+        until the archive is unloaded, and the file on its own file handle.
+        Several threads, like the workers of the WorkQueue, can therefore open
+        and inflate files of the same archive at the same time.
+    @par
+        Files are inflated completely when opened, on the thread opening them,
+        and returned as memory streams. Only stored and deflated entries
+        without encryption are supported, which is what zip tools write by
+        default; Zip64 archives are not.
+    */
+    class _OgreExport IndexedZipArchive : public Archive
+    {
+    protected:
+        /// Where an entry is in the archive and how it is stored
+        struct Entry
+        {
+            /// Offset of the local file header
+            size_t headerOffset;
+            size_t compressedSize;
+            size_t uncompressedSize;
+            uint32 crc;
+            uint16 method;
+            uint16 flags;
+        };
+        typedef vector<Entry>::type EntryList;
+        /// Index of entries by lower case name, npos if a file name is ambiguous
+        typedef OGRE_HashMap<String, size_t> EntryIndex;
+
+        /// Files in the archive, in the order of the central directory
+        EntryList mEntries;
+        /// Entries by path within the archive
+        EntryIndex mPathIndex;
+        /// Entries by file name, for names opened without their path
+        EntryIndex mNameIndex;
+        /// File list in the format ZipArchive uses
+        FileInfoList mFileList;
+        bool mLoaded;
+
+        /// Reads the central directory into the entries and file list
+        void readCentralDirectory(std::ifstream& file);
+        /// Finds the entry of a file, npos if there is none
+        size_t findEntry(const String& filename) const;
+        /// Reads an entry into a buffer of its uncompressed size
+        void readEntry(const Entry& entry, const String& filename, void* buffer) const;
+
+        OGRE_AUTO_MUTEX;
+    public:
+        IndexedZipArchive(const String& name, const String& archType);
+        ~IndexedZipArchive();
+        /// @copydoc Archive::isCaseSensitive
+        bool isCaseSensitive(void) const { return false; }
+
+        /// @copydoc Archive::load
+        void load();
+        /// @copydoc Archive::unload
+        void unload();
+
+        /** @copydoc Archive::open
+        @remarks
+            Safe to call from several threads at once while the archive is loaded.
+        */
+        DataStreamPtr open(const String& filename, bool readOnly = true);
+
+        /// @copydoc Archive::create
+        DataStreamPtr create(const String& filename);
+
+        /// @copydoc Archive::remove
+        void remove(const String& filename);
+
+        /// @copydoc Archive::list
+        StringVectorPtr list(bool recursive = true, bool dirs = false);
+
+        /// @copydoc Archive::listFileInfo
+        FileInfoListPtr listFileInfo(bool recursive = true, bool dirs = false);
+
+        /// @copydoc Archive::find
+        StringVectorPtr find(const String& pattern, bool recursive = true,
+            bool dirs = false);
+
+        /// @copydoc Archive::findFileInfo
+        FileInfoListPtr findFileInfo(const String& pattern, bool recursive = true,
+            bool dirs = false);
+
+        /// @copydoc Archive::exists
+        bool exists(const String& filename);
+
+        /// @copydoc Archive::getModifiedTime
+        time_t getModifiedTime(const String& filename);
+
+        /** Decompresses a file straight into a buffer owned by the caller.
+        @remarks
+            This avoids the copy of the memory stream open returns, for
+            callers which know where the data has to end up, for example a
+            buffer sized from listFileInfo. Stored entries are read into the
+            buffer directly, deflated ones are inflated into it through a
+            DeflateStream. Safe to call from several threads at once while
+            the archive is loaded.
+        @param filename The file to decompress, with or without its path
+        @param buffer Where to put the uncompressed data
+        @param bufferSize The size of the buffer, which must be at least
+            the uncompressed size of the file
+        @return The uncompressed size of the file
+        */
+        size_t decompress(const String& filename, void* buffer, size_t bufferSize);
+    };
+
+    /** Specialisation of ArchiveFactory for indexed Zip files. */
+    class _OgrePrivate IndexedZipArchiveFactory : public ArchiveFactory
+    {
+    public:
+        virtual ~IndexedZipArchiveFactory() {}
+        /// @copydoc FactoryObj::getType
+        const String& getType(void) const;
+        /// @copydoc FactoryObj::createInstance
+        Archive *createInstance( const String& name, bool readOnly )
+        {
+            if(!readOnly)
+                return NULL;
+
+            return OGRE_NEW IndexedZipArchive(name, "IndexedZip");
+        }
+        /// @copydoc FactoryObj::destroyInstance
+        void destroyInstance( Archive* ptr) { OGRE_DELETE ptr; }
+    };
+
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
+
+#endif
@@ -106,6 +106,7 @@ namespace Ogre
         size_t                  mIdCount;
 
         InstanceBatchVec        mDirtyBatches;
+        OGRE_MUTEX(mDirtyBatchesMutex);
 
         RenderOperation         mSharedRenderOperation;
 
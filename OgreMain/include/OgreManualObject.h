@@ -399,6 +399,12 @@ namespace Ogre
             ShadowTechnique shadowTechnique, const Light* light, 
             HardwareIndexBufferSharedPtr* indexBuffer, size_t* indexBufferUsedSize,
             bool extrudeVertices, Real extrusionDist, unsigned long flags = 0);
+        /// @copydoc ShadowCaster::_prepareShadowVolume
+        bool _prepareShadowVolume(
+            ShadowTechnique shadowTechnique, const Light* light,
+            HardwareIndexBufferSharedPtr* indexBuffer,
+            bool extrudeVertices, Real extrusionDist, unsigned long flags,
+            ShadowVolumeBuild& build);
 
 
         /// Built, renderable section of geometry
@@ -548,6 +554,13 @@ namespace Ogre
         /// Copy current temp vertex into buffer
         virtual void copyTempVertexToBuffer(void);
 
+        /** Brings the shadow renderables up to date for a light, ahead of
+            finding the silhouette; returns the edge list, or null if none.
+        */
+        EdgeData* prepareShadowRenderables(const Light* light,
+            HardwareIndexBufferSharedPtr* indexBuffer, bool extrude,
+            Real extrusionDistance, Vector4& lightPos);
+
     };
 
 
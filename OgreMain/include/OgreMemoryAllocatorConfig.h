@@ -174,10 +174,12 @@ namespace Ogre
         MEMCATEGORY_SCRIPTING = 6,
         /// Rendersystem structures
         MEMCATEGORY_RENDERSYS = 7,
+        /// Transient data released at the end of the frame, see FrameAllocator
+        MEMCATEGORY_FRAME = 8,
 
         
         // sentinel value, do not use 
-        MEMCATEGORY_COUNT = 8
+        MEMCATEGORY_COUNT = 9
     };
     /** @} */
     /** @} */
@@ -244,8 +246,14 @@ namespace Ogre
 
 #endif
 
+#include "OgreMemoryFrameAlloc.h"
+
 namespace Ogre
 {
+    // transient per-frame data always comes from the frame arena
+    template <> class CategorisedAllocPolicy<MEMCATEGORY_FRAME> : public FrameArenaPolicy{};
+    template <size_t align> class CategorisedAlignAllocPolicy<MEMCATEGORY_FRAME, align> : public FrameArenaAlignedPolicy<align>{};
+
     // Useful shortcuts
     typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_GENERAL> GeneralAllocPolicy;
     typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_GEOMETRY> GeometryAllocPolicy;
@@ -255,6 +263,7 @@ namespace Ogre
     typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_RESOURCE> ResourceAllocPolicy;
     typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_SCRIPTING> ScriptingAllocPolicy;
     typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_RENDERSYS> RenderSysAllocPolicy;
+    typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_FRAME> FrameAllocPolicy;
 
     // Now define all the base classes for each allocation
     typedef AllocatedObject<GeneralAllocPolicy> GeneralAllocatedObject;
@@ -0,0 +1,154 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __MemoryFrameAlloc_H__
+#define __MemoryFrameAlloc_H__
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Memory
+    *  @{
+    */
+    /** Non-templated utility class just to hide the FrameAllocator.
+    */
+    class _OgreExport FrameArenaImpl
+    {
+    public:
+        /** Allocates from the frame arena.
+        @return
+            0 if the arena cannot serve the request (no arena, arena disabled or
+            called from another thread than the one owning the arena), in which 
+            case the caller has to fall back on the general allocator.
+        */
+        static void* allocBytes(size_t count);
+        /** Allocates from the frame arena at the given boundary, 0 for the
+            SIMD alignment of the platform.
+        @copydetails allocBytes
+        */
+        static void* allocBytesAligned(size_t align, size_t count);
+        /** Releases memory allocated with allocBytes.
+        @return
+            false if the memory was not allocated from the arena.
+        */
+        static bool deallocBytes(void* ptr);
+    };
+
+    /** An allocation policy for use with AllocatedObject and 
+    STLAllocator, which allocates from the FrameAllocator.
+    @remarks
+        The memory is taken from a linear arena which is reset at the end of 
+        every frame, so deallocation does nothing and everything allocated 
+        through this policy must be released before Root::_fireFrameEnded 
+        returns. It is meant for transient containers that would otherwise 
+        go through the general allocator every frame.
+    @par
+        Requests which cannot be served by the arena transparently fall back
+        on the general allocator.
+    */
+    class FrameArenaPolicy
+    {
+    public:
+        static inline void* allocateBytes(size_t count, 
+            const char* file = 0, int line = 0, const char* func = 0)
+        {
+            void* ptr = FrameArenaImpl::allocBytes(count);
+            if (!ptr)
+                ptr = CategorisedAllocPolicy<MEMCATEGORY_GENERAL>::allocateBytes(count, file, line, func);
+            return ptr;
+        }
+        static inline void deallocateBytes(void* ptr)
+        {
+            if (!FrameArenaImpl::deallocBytes(ptr))
+                CategorisedAllocPolicy<MEMCATEGORY_GENERAL>::deallocateBytes(ptr);
+        }
+        /// Get the maximum size of a single allocation
+        static inline size_t getMaxAllocationSize()
+        {
+            return std::numeric_limits<size_t>::max();
+        }
+
+    private:
+        // No instantiation
+        FrameArenaPolicy()
+        { }
+    };
+
+    /** An allocation policy for use with AllocatedObject and 
+    STLAllocator, which allocates from the FrameAllocator at a given 
+    boundary (which should be a power of 2).
+    @see FrameArenaPolicy
+    @note
+        template parameter Alignment equal to zero means use default
+        platform dependent alignment.
+    */
+    template <size_t Alignment = 0>
+    class FrameArenaAlignedPolicy
+    {
+    public:
+        // compile-time check alignment is available.
+        typedef int IsValidAlignment
+            [Alignment <= 128 && ((Alignment & (Alignment-1)) == 0) ? +1 : -1];
+
+        static inline void* allocateBytes(size_t count, 
+            const char* file = 0, int line = 0, const char* func = 0)
+        {
+            void* ptr = FrameArenaImpl::allocBytesAligned(Alignment, count);
+            if (!ptr)
+                ptr = CategorisedAlignAllocPolicy<MEMCATEGORY_GENERAL, Alignment>::allocateBytes(count, file, line, func);
+            return ptr;
+        }
+
+        static inline void deallocateBytes(void* ptr)
+        {
+            if (!FrameArenaImpl::deallocBytes(ptr))
+                CategorisedAlignAllocPolicy<MEMCATEGORY_GENERAL, Alignment>::deallocateBytes(ptr);
+        }
+
+        /// Get the maximum size of a single allocation
+        static inline size_t getMaxAllocationSize()
+        {
+            return std::numeric_limits<size_t>::max();
+        }
+    private:
+        // no instantiation allowed
+        FrameArenaAlignedPolicy()
+        { }
+    };
+
+    /** @} */
+    /** @} */
+
+}// namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __MemoryFrameAlloc_H__
@@ -115,12 +115,24 @@ namespace Ogre
         AllocationsByPool mAllocationsByPool;
         bool mRecordEnable;
 
+        // Per frame statistics
+        size_t mAllocationCount;
+        size_t mFrameStartAllocationCount;
+        size_t mLastFrameAllocationCount;
+        size_t mLastFrameArenaAllocationCount;
+        size_t mFrameCount;
+        size_t mFramesAllocationCount;
+        size_t mFramesArenaAllocationCount;
+
         void reportLeaks();
 
         // protected ctor
         MemoryTracker()
             : mLeakFileName("OgreLeaks.log"), mDumpToStdOut(true),
-            mTotalAllocations(0), mRecordEnable(true)
+            mTotalAllocations(0), mRecordEnable(true),
+            mAllocationCount(0), mFrameStartAllocationCount(0),
+            mLastFrameAllocationCount(0), mLastFrameArenaAllocationCount(0),
+            mFrameCount(0), mFramesAllocationCount(0), mFramesArenaAllocationCount(0)
         {
         }
     public:
@@ -152,6 +164,15 @@ namespace Ogre
         size_t getTotalMemoryAllocated() const;
         /// Get the amount of memory allocated in a given pool
         size_t getMemoryAllocatedForPool(unsigned int pool) const;
+        /// Get the number of allocations recorded so far
+        size_t getAllocationCount() const { return mAllocationCount; }
+        /// Get the number of allocations recorded during the last frame
+        size_t getLastFrameAllocationCount() const { return mLastFrameAllocationCount; }
+        /** Get the number of allocations served by the frame arena during the 
+            last frame, which are not part of getLastFrameAllocationCount.
+        @see FrameAllocator
+        */
+        size_t getLastFrameArenaAllocationCount() const { return mLastFrameArenaAllocationCount; }
 
 
         /** Record an allocation that has been made. Only to be called by
@@ -167,6 +188,11 @@ namespace Ogre
                           const char* file = 0, size_t ln = 0, const char* func = 0);
         /** Record the deallocation of memory. */
         void _recordDealloc(void* ptr);
+        /** Record the end of a frame. Only to be called by Root.
+            @param arenaAllocations The number of allocations the frame arena
+                served during the frame
+        */
+        void _frameEnded(size_t arenaAllocations);
 
         /// Sets whether the record alloc/dealloc enabled.
         void setRecordEnable(bool recordEnable)
@@ -176,6 +176,10 @@ namespace Ogre {
         bool mEdgeListsBuilt;
         bool mAutoBuildEdgeLists;
 
+        /// Triangles for ray queries, built on demand
+        MeshTriangleBvh* mTriangleBvh;
+        OGRE_MUTEX(mTriangleBvhMutex);
+
         /// Storage of morph animations, lookup by name
         typedef map<String, Animation*>::type AnimationList;
         AnimationList mAnimationsList;
@@ -739,6 +743,19 @@ namespace Ogre {
         /** Returns whether this mesh has an attached edge list. */
         bool isEdgeListBuilt(void) const { return mEdgeListsBuilt; }
 
+        /** Gets the tree of the triangles of this mesh used to find where rays
+            hit it, building it if required.
+        @remarks
+            Building reads every index and vertex buffer back, so keeping shadow
+            buffers makes it cheaper. The tree is then kept until the mesh is
+            unloaded; call freeTriangleBvh after changing its geometry.
+            May be called from several threads at once.
+        */
+        const MeshTriangleBvh* getTriangleBvh(void);
+
+        /** Destroys the tree built by getTriangleBvh, if any. */
+        void freeTriangleBvh(void);
+
         /** Prepare matrices for software indexed vertex blend.
         @remarks
             This function organise bone indexed matrices to blend indexed matrices,
@@ -784,6 +801,61 @@ namespace Ogre {
             const Matrix4* const* blendMatrices, size_t numMatrices,
             bool blendNormals);
 
+        /// Buffers locked for a batch of software vertex blends, with their locked memory
+        typedef map<HardwareVertexBuffer*, void*>::type VertexBlendLockMap;
+
+        /** Source and destination pointers of a software vertex blend whose
+            buffers have been locked by _lockForSoftwareVertexBlend.
+        */
+        struct SoftwareVertexBlendData
+        {
+            const float* srcPos;
+            const float* srcNorm;
+            float* destPos;
+            float* destNorm;
+            const float* blendWeight;
+            const unsigned char* blendIdx;
+            size_t srcPosStride;
+            size_t srcNormStride;
+            size_t destPosStride;
+            size_t destNormStride;
+            size_t blendWeightStride;
+            size_t blendIdxStride;
+            unsigned short numWeightsPerVertex;
+            size_t vertexCount;
+        };
+
+        /** Locks the buffers involved in a software vertex blend ahead of
+            performing it.
+        @remarks
+            This splits softwareVertexBlend in three, so that the blend itself,
+            which does not touch any buffer object, can be performed on another
+            thread while the buffers are locked and unlocked on this one.
+            Buffers which are already present in @a locks are not locked again,
+            so several blends reading from the same mesh can be prepared
+            together. Parameters are the same as softwareVertexBlend.
+        @param locks
+            Buffers locked so far, to be unlocked with _unlockForSoftwareVertexBlend
+            once all the blends have been performed.
+        @param data
+            Receives the pointers and strides to pass to _softwareVertexBlend.
+        */
+        static void _lockForSoftwareVertexBlend(const VertexData* sourceVertexData,
+            const VertexData* targetVertexData, bool blendNormals,
+            VertexBlendLockMap& locks, SoftwareVertexBlendData& data);
+
+        /** Performs a software vertex blend prepared by _lockForSoftwareVertexBlend.
+        @remarks
+            May be called from any thread, as long as the buffers remain locked.
+        */
+        static void _softwareVertexBlend(const SoftwareVertexBlendData& data,
+            const Matrix4* const* blendMatrices);
+
+        /** Unlocks all the buffers locked by _lockForSoftwareVertexBlend, and
+            empties @a locks.
+        */
+        static void _unlockForSoftwareVertexBlend(VertexBlendLockMap& locks);
+
         /** Performs a software vertex morph, of the kind used for
             morph animation although it can be used for other purposes. 
         @remarks
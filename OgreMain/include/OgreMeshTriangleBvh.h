@@ -0,0 +1,233 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __MeshTriangleBvh_H__
+#define __MeshTriangleBvh_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreRay.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+
+    /** \addtogroup Resources
+    *  @{
+    */
+
+    /** Bounding volume hierarchy over the triangles of a mesh, for finding
+        where a ray hits its geometry.
+    @remarks
+        The positions and indexes of every triangle list, strip and fan
+        submesh are copied when the tree is built, from the shadow buffers
+        when the mesh has them. Later queries touch no hardware buffer. Only
+        the full detail geometry is used, not the LOD levels.
+    @par
+        The positions of all the vertex data of the mesh are stored one after
+        the other: the shared vertex data first, then the dedicated vertex
+        data of each submesh in order. skinPositions fills a Pose with
+        positions laid out the same way, and refit fits the bounds of the
+        nodes around them, so that intersects can walk the same tree over
+        the triangles in that pose instead of the stored ones.
+    @par
+        The tree is built by Mesh::getTriangleBvh and is immutable afterwards,
+        so it may be queried from several threads at once.
+    */
+    class _OgreExport MeshTriangleBvh : public EdgeDataAlloc
+    {
+    public:
+        /// Nearest intersection of a ray with the triangles
+        struct Hit
+        {
+            /// Distance along the ray, in units of its direction
+            Real distance;
+            /// Submesh the triangle belongs to
+            unsigned short subMeshIndex;
+            /// Triangle within the submesh, in the order of its index data
+            size_t triangleIndex;
+            /** Barycentric coordinates of the hit point relative to the second
+                and third vertex of the triangle, the weight of the first being
+                1 - u - v.
+            */
+            Real u;
+            Real v;
+        };
+
+        /// Bounds of a node of the tree
+        struct Bounds
+        {
+            Vector3 min;
+            Vector3 max;
+        };
+        typedef vector<Bounds>::type BoundsList;
+
+        /** Another pose of the triangles, such as a skinned one, with the
+            bounds of the nodes of the tree refitted around it.
+        */
+        struct Pose
+        {
+            /// Three floats per vertex, laid out as getPositions
+            vector<float>::type positions;
+            /// Bounds of each node, see refit
+            BoundsList bounds;
+        };
+
+        /** Copies the geometry of the mesh and builds the tree over it.
+        @remarks
+            The mesh must be loaded.
+        */
+        MeshTriangleBvh(const Mesh* mesh);
+        ~MeshTriangleBvh();
+
+        /** Finds the nearest triangle hit by the ray, both faces being hit.
+        @param ray
+            Ray in the space of the mesh.
+        @param hit
+            Receives the nearest hit.
+        @return
+            Whether any triangle was hit.
+        */
+        bool intersects(const Ray& ray, Hit& hit) const;
+
+        /** Finds the nearest triangle hit by the ray, with the triangles in
+            the given pose instead of that of the mesh.
+        @param ray
+            Ray in the space of the pose.
+        @param pose
+            The pose, refitted since its positions last changed.
+        @param hit
+            Receives the nearest hit.
+        */
+        bool intersects(const Ray& ray, const Pose& pose, Hit& hit) const;
+
+        /** Finds the nearest triangle hit by the ray, with the given positions
+            instead of those of the mesh.
+        @remarks
+            Every triangle is tested, without walking the tree.
+        @param ray
+            Ray in the space of the positions.
+        @param positions
+            Three floats per vertex, laid out as getPositions.
+        @param hit
+            Receives the nearest hit.
+        */
+        bool intersects(const Ray& ray, const float* positions, Hit& hit) const;
+
+        /** Calculates the positions of the vertices of the mesh skinned with
+            the given bone matrices.
+        @remarks
+            Vertex data without blend weights is copied as is.
+        @param mesh
+            The mesh the tree was built for.
+        @param boneMatrices
+            The object space matrices of the bones, see Entity::_getBoneMatrices.
+        @param positions
+            Resized to three floats per vertex and filled in, laid out as getPositions.
+        */
+        void skinPositions(const Mesh* mesh, const Matrix4* boneMatrices,
+            vector<float>::type& positions) const;
+
+        /** Fits the bounds of the nodes of the pose around its positions.
+        @remarks
+            The nodes keep the triangles they were built with, so the tree
+            gets looser as the pose moves away from the mesh, but never gives
+            wrong results.
+        */
+        void refit(Pose& pose) const;
+
+        /** Gets the stored positions, three floats per vertex. */
+        const vector<float>::type& getPositions(void) const { return mPositions; }
+        /** Gets the number of triangles in the tree. */
+        size_t getTriangleCount(void) const { return mTriangles.size(); }
+        /** Gets the number of nodes in the tree. */
+        size_t getNodeCount(void) const { return mNodes.size(); }
+
+    protected:
+        /// Triangle of the mesh
+        struct Triangle
+        {
+            /// Vertices, as indexes into the positions
+            uint32 vertices[3];
+            /// Triangle within its submesh
+            uint32 index;
+            unsigned short subMeshIndex;
+        };
+        typedef vector<Triangle>::type TriangleList;
+
+        /// Node of the tree, the left child of an internal node following it
+        struct Node
+        {
+            /// First triangle of a leaf, right child of an internal node
+            uint32 first;
+            /// Number of triangles of a leaf, 0 for an internal node
+            uint32 count;
+        };
+        typedef vector<Node>::type NodeList;
+
+        /// Bounds of a triangle while the tree is built
+        struct BuildItem
+        {
+            Vector3 min;
+            Vector3 max;
+            Vector3 centre;
+            uint32 triangle;
+        };
+
+        /// Appends the positions of the vertex data, returning the first index
+        size_t addPositions(const VertexData* vertexData);
+        /// Appends the triangles of a submesh
+        void addTriangles(const SubMesh* subMesh, unsigned short subMeshIndex,
+            size_t vertexOffset);
+        /// Builds the subtree of the given items, which it reorders
+        void build(BuildItem* items, uint32 first, uint32 count, size_t depth);
+        /// Tests one triangle, updating hit if it is nearer
+        bool intersectTriangle(const Ray& ray, const float* positions,
+            const Triangle& tri, Hit& hit) const;
+        /// Walks the tree with the given node bounds over the given positions
+        bool intersectsTree(const Ray& ray, const float* positions, const Bounds* bounds,
+            Hit& hit) const;
+
+        vector<float>::type mPositions;
+        /// First vertex of the shared vertex data then of each submesh with its own
+        vector<size_t>::type mVertexOffsets;
+        TriangleList mTriangles;
+        NodeList mNodes;
+        /// Bounds of each node around the stored positions
+        BoundsList mBounds;
+        /// Number of levels of the tree
+        size_t mDepth;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -41,6 +41,7 @@ namespace Ogre {
 
     // Forward declaration
     class MovableObjectFactory;
+    class RenderQueueEntryCache;
 
     /** \addtogroup Core
     *  @{
@@ -158,6 +159,9 @@ namespace Ogre {
         /// the light mask defined for this movable. This will be taken into consideration when deciding which light should affect this movable
         uint32 mLightMask;
 
+        /// Renderables last queued per camera by render queue entry cache passes, created on demand
+        RenderQueueEntryCache* mRenderQueueEntryCache;
+
         // Static members
         /// Default query flags
         static uint32 msDefaultQueryFlags;
@@ -275,6 +279,35 @@ namespace Ogre {
         */
         virtual void _updateRenderQueue(RenderQueue* queue) = 0;
 
+        /** Internal method returning whether _notifyCurrentCamera and _updateRenderQueue
+            may currently be called on this object from a thread other than the render
+            thread, concurrently with the same calls on other objects.
+        @remarks
+            This is the case when queueing the object only involves its own state and
+            resources which are already loaded, e.g. no GPU buffer has to be updated.
+            Objects for which this returns false are queued on the render thread when
+            visibility culling is split across threads (see
+            SceneManager::setCullingThreadCount). The default is false.
+        */
+        virtual bool _canUpdateRenderQueueConcurrently(void) const { return false; }
+
+        /** Internal method returning a value summarising everything which decides
+            what _updateRenderQueue adds to the queue, apart from visibility.
+        @remarks
+            When a RenderQueue reuses cached entries (see 
+            SceneManager::setRenderQueueEntryCacheEnabled), an object queued for the
+            same camera in the previous pass whose signature has not changed has
+            the renderables, techniques, groups and priorities it queued then
+            added again, without _updateRenderQueue being called. It is
+            computed for every visible object each frame, so it has to be
+            much cheaper than _updateRenderQueue. Objects which
+            must update the queue every time should return 0, which is the default.
+        */
+        virtual uint32 _getRenderQueueSignature(void) const { return 0; }
+
+        /// Internal method returning the cache used by render queue entry cache passes
+        RenderQueueEntryCache* _getRenderQueueEntryCache(void);
+
         /** Tells this object whether to be visible or not, if it has a renderable component. 
         @note An alternative approach of making an object invisible is to detach it
             from it's SceneNode, or to remove the SceneNode entirely. 
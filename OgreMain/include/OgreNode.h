@@ -201,6 +201,14 @@ namespace Ogre {
         */
         virtual void updateFromParentImpl(void) const;
 
+        /** Called whenever the derived transform of this node has been recalculated,
+            either by updateFromParentImpl or by _setDerivedTransform.
+        @remarks
+            Subclasses can override this to react to the node having moved
+            without having to know how the new transform was calculated.
+        */
+        virtual void derivedTransformUpdated(void) const {}
+
 
         /** Internal method for creating a new child node - must be overridden per subclass. */
         virtual Node* createChildImpl(void) = 0;
@@ -652,6 +660,63 @@ namespace Ogre {
         */
         virtual void _update(bool updateChildren, bool parentHasChanged);
 
+        typedef vector<Node*>::type NodeList;
+
+        /** Internal method to update this Node only, collecting the children the
+            update would have cascaded to instead of visiting them.
+        @remarks
+            This allows a SceneManager to split the update of a hierarchy, e.g. to
+            process independent subtrees on several threads. Each collected child
+            must then be updated with _update(true, x) where x is the value returned
+            by this method, and once they are all done _update(false, false) must be
+            called on this node to finish it (e.g. SceneNode merges child bounds).
+        @param parentHasChanged
+            As for _update.
+        @param children
+            List to which the children needing an update are appended.
+        @return
+            The parentHasChanged flag to pass to the collected children.
+        */
+        bool _updateAndCollectChildren(bool parentHasChanged, NodeList& children);
+
+        /** Internal method which behaves as _updateAndCollectChildren except that
+            this Node's own transform is not updated.
+        @remarks
+            Used by SceneManager implementations which calculate derived transforms
+            themselves, in which case _isUpdateFromParentNeeded must be checked
+            before calling this, and _setDerivedTransform called when it was true.
+        */
+        bool _collectChildrenToUpdate(bool parentHasChanged, NodeList& children);
+
+        /** Internal method returning whether _update would recalculate the
+            derived transform of this Node given the same parentHasChanged flag.
+        */
+        bool _isUpdateFromParentNeeded(bool parentHasChanged) const
+        { return mNeedParentUpdate || parentHasChanged; }
+
+        /** Internal method returning whether the derived transform of this Node is
+            simply the concatenation of its parent's and its own, so that it may be
+            calculated externally in bulk (see OptimisedUtil::concatenateNodeTransforms).
+        */
+        bool _canConcatenateTransforms(void) const
+        {
+#if OGRE_NODE_INHERIT_TRANSFORM
+            return false;
+#else
+            return mParent && mInheritOrientation && mInheritScale;
+#endif
+        }
+
+        /** Internal method to set the derived transform of this Node, as calculated
+            externally on behalf of _updateFromParent.
+        @remarks
+            Only meant for nodes for which _canConcatenateTransforms returns true, and
+            the values given must be equal to what _updateFromParent would produce.
+            The Node is considered up to date afterwards and listeners are notified.
+        */
+        void _setDerivedTransform(const Vector3& position, const Quaternion& orientation,
+            const Vector3& scale);
+
         /** Sets a listener for this Node.
         @remarks
             Note for size and performance reasons only one listener per node is
@@ -0,0 +1,108 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NodeTransformBatch_H__
+#define __NodeTransformBatch_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Scratch storage copying the transforms of a set of nodes into
+        structure-of-arrays blocks so that their derived transforms can be
+        calculated together.
+    @remarks
+        Each block holds the position, orientation and scale of 4 nodes, one
+        float per node for each component, for the parents' derived transforms,
+        the nodes' own transforms and the resulting derived transforms (see
+        OptimisedUtil::concatenateNodeTransforms). The nodes keep owning their
+        transforms: the results are written back to them through
+        Node::_setDerivedTransform. The memory is kept between uses, so a
+        SceneManager can keep one batch per depth of its hierarchy and refill
+        it every frame without allocating.
+    @par
+        Only nodes for which Node::_canConcatenateTransforms returns true may be
+        added, and their parents must be up to date.
+    */
+    class _OgreExport NodeTransformBatch : public SceneMgtAlloc
+    {
+    public:
+        /// Number of nodes per block
+        static const size_t NODES_PER_BLOCK = 4;
+        /// Number of floats in a block
+        static const size_t FLOATS_PER_BLOCK = 10 * NODES_PER_BLOCK;
+
+        NodeTransformBatch();
+        ~NodeTransformBatch();
+
+        /// Removes all nodes from the batch, keeping the memory allocated
+        void clear(void) { mNodes.clear(); }
+
+        /// Adds a node, packing its transform and its parent's derived transform
+        void addNode(Node* node);
+
+        /// Gets the number of nodes in the batch
+        size_t getNumNodes(void) const { return mNodes.size(); }
+
+        /// Gets the number of blocks used by the nodes in the batch
+        size_t getNumBlocks(void) const 
+        { return (mNodes.size() + NODES_PER_BLOCK - 1) / NODES_PER_BLOCK; }
+
+        /** Calculates the derived transforms of the nodes in a range of blocks
+            and assigns them to the nodes.
+        @remarks
+            Different ranges may be processed concurrently.
+        */
+        void update(size_t firstBlock, size_t numBlocks);
+
+    protected:
+        typedef vector<Node*>::type NodeList;
+        NodeList mNodes;
+        /// Number of blocks allocated in each buffer
+        size_t mCapacity;
+        float* mParentTransforms;
+        float* mLocalTransforms;
+        float* mDerivedTransforms;
+
+        /// Grows the buffers to hold at least numBlocks blocks
+        void reserve(size_t numBlocks);
+    };
+    /** @} */
+    /** @} */
+
+} // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif // __NodeTransformBatch_H__
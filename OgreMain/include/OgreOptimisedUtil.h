@@ -72,6 +72,24 @@ namespace Ogre {
         */
         static OptimisedUtil* getImplementation(void) { return msImplementation; }
 
+        /// The implementations that may be picked at run-time
+        enum ImplementationType
+        {
+            IMPL_GENERAL,
+            IMPL_SSE,
+            IMPL_AVX2
+        };
+
+        /** Gets a particular implementation of this class.
+        @remarks
+            This is meant for testing and benchmarking the implementations
+            against each other, use getImplementation otherwise.
+        @return
+            The implementation, or NULL if it isn't compiled in or the CPU
+            doesn't support it.
+        */
+        static OptimisedUtil* _getImplementation(ImplementationType type);
+
         /** Performs software vertex skinning.
         @param srcPosPtr Pointer to source position buffer.
         @param destPosPtr Pointer to destination position buffer.
@@ -203,6 +221,76 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) = 0;
+
+        /** Calculates the derived transforms of nodes from their own transforms
+            and the derived transforms of their parents.
+        @remarks
+            Transforms are packed in blocks of 4 nodes using a structure-of-arrays
+            layout: each block holds 10 groups of 4 floats, one float per node,
+            being position x, y, z, orientation w, x, y, z and scale x, y, z.
+            The derived transform is calculated as Node::_updateFromParent does
+            for a node inheriting both orientation and scale.
+        @param parentTransforms Blocks of parent derived transforms, must be
+            aligned to SIMD alignment.
+        @param localTransforms Blocks of node transforms relative to their
+            parent, must be aligned to SIMD alignment.
+        @param derivedTransforms Blocks receiving the derived transforms, must
+            be aligned to SIMD alignment.
+        @param numBlocks Number of blocks (i.e. a quarter of the number of nodes,
+            rounded up) to process.
+        */
+        virtual void concatenateNodeTransforms(
+            const float* parentTransforms,
+            const float* localTransforms,
+            float* derivedTransforms,
+            size_t numBlocks) = 0;
+
+        /** Tests axis aligned boxes against a set of planes, e.g. a view frustum,
+            4 boxes at a time.
+        @remarks
+            A box is culled when it lies entirely on the negative side of any of
+            the planes, as Plane::getSide would report for its centre and
+            half-size; otherwise it is considered visible.
+        @param planes Planes to test against, 4 floats per plane being the normal
+            x, y, z and the constant d.
+        @param numPlanes Number of planes.
+        @param boxes Blocks of 4 boxes using a structure-of-arrays layout: each
+            block holds 6 groups of 4 floats, one float per box, being the centre
+            x, y, z and the half-size x, y, z. Must be aligned to SIMD alignment.
+        @param numBlocks Number of blocks (i.e. a quarter of the number of boxes,
+            rounded up) to test.
+        @param visibleMasks Receives one value per block, in which bit i is set
+            if box i of the block is visible.
+        */
+        virtual void cullBoxes(
+            const float* planes,
+            size_t numPlanes,
+            const float* boxes,
+            size_t numBlocks,
+            uint8* visibleMasks) = 0;
+
+        /** Interpolates node transforms between two keyframes, 4 nodes at a time.
+        @remarks
+            Transforms use the block layout of concatenateNodeTransforms.
+            Orientations are interpolated as Quaternion::nlerp does along the
+            shortest path, positions and scales linearly.
+        @param weights Interpolation factor of each node, from 0 for the first
+            keyframe to 1 for the second, must be aligned to SIMD alignment.
+        @param srcTransforms1 Blocks of transforms of the first keyframe, must
+            be aligned to SIMD alignment.
+        @param srcTransforms2 Blocks of transforms of the second keyframe, must
+            be aligned to SIMD alignment.
+        @param dstTransforms Blocks receiving the interpolated transforms, must
+            be aligned to SIMD alignment, may be the same as srcTransforms1.
+        @param numBlocks Number of blocks (i.e. a quarter of the number of nodes,
+            rounded up) to interpolate.
+        */
+        virtual void interpolateNodeTransforms(
+            const float* weights,
+            const float* srcTransforms1,
+            const float* srcTransforms2,
+            float* dstTransforms,
+            size_t numBlocks) = 0;
     };
 
     /** Returns raw offseted of the given pointer.
@@ -0,0 +1,283 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __PackArchive_H__
+#define __PackArchive_H__
+
+#include "OgrePrerequisites.h"
+
+#include "OgreArchive.h"
+#include "OgreArchiveFactory.h"
+#include "OgreDataStream.h"
+#include "OgreHeaderPrefix.h"
+#include "Threading/OgreThreadHeaders.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** Specialisation of the Archive class reading OGRE pack files, an archive
+        format built for loading many small files quickly.
+    @remarks
+        A pack holds the contents of its files one after the other, as if they
+        were a single stream, cut into chunks of a fixed size (64 KiB by
+        default) which are compressed independently. Small files share chunks,
+        so they compress as well as a solid archive would, while reading a
+        file only decompresses the chunks it spans. The table of contents is
+        sorted by a hash of the lower case file paths, so a file is found by
+        binary search without building any index, and there are no per file
+        headers to parse.
+    @par
+        Chunks are compressed in the LZ4 block format with the LZ4 library,
+        which decompresses several times faster than zip's deflate, or
+        optionally with zlib for smaller packs when OGRE is built with zip
+        support. Pack support is only built when LZ4 is available, see
+        OGRE_NO_PACK_ARCHIVE. Chunks which do not shrink are stored. The chunk
+        data starts on a page boundary and every chunk on a 16 byte boundary,
+        so the pack can be memory mapped and stored chunks used in place; the
+        pack is mapped whenever the platform supports it, see
+        MappedFileDataStream, and read through file streams otherwise.
+    @par
+        Files are decompressed completely when opened, on the thread opening
+        them, and returned as memory streams. As nothing changes while the
+        archive is loaded, files can be opened from several threads at once.
+        Packs are built with PackArchiveWriter, or the OgrePackBuilder tool.
+    */
+    class _OgreExport PackArchive : public Archive
+    {
+    public:
+        /// How a chunk is compressed
+        enum Codec
+        {
+            /// Stored as it is
+            CODEC_NONE = 0,
+            /// LZ4 block format
+            CODEC_LZ4 = 1,
+            /// zlib format, only available with zip support
+            CODEC_ZLIB = 2
+        };
+
+        /// Chunk size packs are written with by default
+        static const size_t DEFAULT_CHUNK_SIZE = 65536;
+
+        /// Whether chunks compressed with a codec can be read and written in this build
+        static bool isCodecSupported(Codec codec);
+
+    protected:
+        /// A file in the table of contents
+        struct Entry
+        {
+            uint32 hash;
+            /// Lower case path, which the entries are sorted by after the hash
+            String key;
+            /// Offset of the contents in the stream of all files
+            uint64 offset;
+            uint64 size;
+        };
+        typedef vector<Entry>::type EntryList;
+
+        /// A chunk of the stream of all files
+        struct Chunk
+        {
+            /// Offset of the chunk data in the pack
+            uint64 offset;
+            size_t compressedSize;
+            Codec codec;
+        };
+        typedef vector<Chunk>::type ChunkList;
+
+        EntryList mEntries;
+        ChunkList mChunks;
+        size_t mChunkSize;
+        /// Size of the stream of all files
+        uint64 mDataSize;
+        /// File list in the format FileSystemArchive uses
+        FileInfoList mFileList;
+        /// The whole pack when it is memory mapped, null otherwise
+        MemoryDataStreamPtr mMapping;
+        bool mLoaded;
+
+        /// Reads size bytes of the pack at offset, into buffer, from the mapping or a file stream
+        void readPack(std::ifstream* file, uint64 offset, void* buffer, size_t size) const;
+        /// Finds the entry of a file, null if there is none
+        const Entry* findEntry(const String& filename) const;
+        /// Decompresses part of the stream of all files into a buffer
+        void readData(uint64 offset, size_t size, uchar* buffer, const String& filename) const;
+
+        OGRE_AUTO_MUTEX;
+    public:
+        PackArchive(const String& name, const String& archType);
+        ~PackArchive();
+        /// @copydoc Archive::isCaseSensitive
+        bool isCaseSensitive(void) const { return false; }
+
+        /// @copydoc Archive::load
+        void load();
+        /// @copydoc Archive::unload
+        void unload();
+
+        /** @copydoc Archive::open
+        @remarks
+            Safe to call from several threads at once while the archive is loaded.
+        */
+        DataStreamPtr open(const String& filename, bool readOnly = true);
+
+        /// @copydoc Archive::create
+        DataStreamPtr create(const String& filename);
+
+        /// @copydoc Archive::remove
+        void remove(const String& filename);
+
+        /// @copydoc Archive::list
+        StringVectorPtr list(bool recursive = true, bool dirs = false);
+
+        /// @copydoc Archive::listFileInfo
+        FileInfoListPtr listFileInfo(bool recursive = true, bool dirs = false);
+
+        /// @copydoc Archive::find
+        StringVectorPtr find(const String& pattern, bool recursive = true,
+            bool dirs = false);
+
+        /// @copydoc Archive::findFileInfo
+        FileInfoListPtr findFileInfo(const String& pattern, bool recursive = true,
+            bool dirs = false);
+
+        /// @copydoc Archive::exists
+        bool exists(const String& filename);
+
+        /// @copydoc Archive::getModifiedTime
+        time_t getModifiedTime(const String& filename);
+
+        /// Returns whether the pack is read through a memory mapping
+        bool isMemoryMapped(void) const { return !mMapping.isNull(); }
+    };
+
+    /** Specialisation of ArchiveFactory for OGRE pack files. */
+    class _OgrePrivate PackArchiveFactory : public ArchiveFactory
+    {
+    public:
+        virtual ~PackArchiveFactory() {}
+        /// @copydoc FactoryObj::getType
+        const String& getType(void) const;
+        /// @copydoc FactoryObj::createInstance
+        Archive *createInstance( const String& name, bool readOnly )
+        {
+            if(!readOnly)
+                return NULL;
+
+            return OGRE_NEW PackArchive(name, "Pack");
+        }
+        /// @copydoc FactoryObj::destroyInstance
+        void destroyInstance( Archive* ptr) { OGRE_DELETE ptr; }
+    };
+
+    /** Writes OGRE pack files, see PackArchive.
+    @remarks
+        Files are compressed and written out as they are added, so only one
+        chunk of them is held in memory; the table of contents is written
+        when the pack is finished.
+    */
+    class _OgreExport PackArchiveWriter : public ArchiveAlloc
+    {
+    protected:
+        struct Entry
+        {
+            String path;
+            uint64 offset;
+            uint64 size;
+        };
+        typedef vector<Entry>::type EntryList;
+
+        struct Chunk
+        {
+            uint64 offset;
+            uint32 compressedSize;
+            PackArchive::Codec codec;
+        };
+        typedef vector<Chunk>::type ChunkList;
+
+        String mPath;
+        std::ofstream mFile;
+        PackArchive::Codec mCodec;
+        size_t mChunkSize;
+        EntryList mEntries;
+        ChunkList mChunks;
+        /// Lower case paths of the files added, which must be unique
+        set<String>::type mKeys;
+        /// Data of the chunk being filled
+        vector<uchar>::type mChunk;
+        /// Size of the stream of all files so far
+        uint64 mDataSize;
+        bool mFinished;
+
+        /// Compresses and writes out the chunk being filled
+        void flushChunk(void);
+        /// Pads the pack with zeros up to a multiple of alignment
+        void align(size_t alignment);
+    public:
+        /** Starts writing a pack.
+        @param path The file to write
+        @param codec The codec to compress the chunks with, which must be supported
+        @param chunkSize The uncompressed size of the chunks
+        */
+        PackArchiveWriter(const String& path, PackArchive::Codec codec = PackArchive::CODEC_LZ4,
+            size_t chunkSize = PackArchive::DEFAULT_CHUNK_SIZE);
+        /// Finishes the pack if it hasn't been already
+        ~PackArchiveWriter();
+
+        /** Adds a file to the pack.
+        @param filename The path of the file within the pack, using '/' between folders
+        @param stream The contents of the file
+        */
+        void addFile(const String& filename, const DataStreamPtr& stream);
+
+        /** Adds all files of an archive, with their paths within it.
+        @return The number of files added
+        */
+        size_t addArchive(Archive* archive);
+
+        /** Writes the table of contents, after which no more files can be added. */
+        void finish(void);
+
+        /// Returns the uncompressed size of the files added so far
+        uint64 getDataSize(void) const { return mDataSize; }
+        /// Returns the size of the chunks written so far, once compressed
+        uint64 getCompressedSize(void) const;
+    };
+
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
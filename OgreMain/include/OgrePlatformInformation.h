@@ -130,6 +130,23 @@ namespace Ogre {
 
 #ifndef __OGRE_HAVE_MSA
 #   define __OGRE_HAVE_MSA  0
+#endif
+
+/* Define whether or not Ogre compiled with AVX2/FMA support. Unlike SSE, the
+   rest of Ogre is never compiled for AVX2, the code using it is only reached
+   after checking the CPU features at run-time, so this only requires the
+   compiler to understand the intrinsics.
+*/
+#if __OGRE_HAVE_SSE && OGRE_COMPILER == OGRE_COMPILER_MSVC && OGRE_COMP_VER >= 1700
+#   define __OGRE_HAVE_AVX2 1
+#elif __OGRE_HAVE_SSE && OGRE_COMPILER == OGRE_COMPILER_GNUC && OGRE_COMP_VER >= 490
+#   define __OGRE_HAVE_AVX2 1
+#elif __OGRE_HAVE_SSE && OGRE_COMPILER == OGRE_COMPILER_CLANG && OGRE_COMP_VER >= 380
+#   define __OGRE_HAVE_AVX2 1
+#endif
+
+#ifndef __OGRE_HAVE_AVX2
+#   define __OGRE_HAVE_AVX2 0
 #endif
 
     /** \addtogroup Core
@@ -176,6 +193,9 @@ namespace Ogre {
             CPU_FEATURE_FPU             = 1 << 12,
             CPU_FEATURE_PRO             = 1 << 13,
             CPU_FEATURE_HTT             = 1 << 14,
+            CPU_FEATURE_AVX             = 1 << 18,
+            CPU_FEATURE_AVX2            = 1 << 19,
+            CPU_FEATURE_FMA             = 1 << 20,
 #elif OGRE_CPU == OGRE_CPU_ARM          
             CPU_FEATURE_VFP             = 1 << 15,
             CPU_FEATURE_NEON            = 1 << 16,
@@ -143,6 +143,7 @@ namespace Ogre {
     class AnimationStateSet;
     class AnimationTrack;
     class Archive;
+    class ArchiveIndexCache;
     class ArchiveFactory;
     class ArchiveManager;
     class AutoParamDataSource;
@@ -155,6 +156,7 @@ namespace Ogre {
     class Camera;
     class Codec;
     class ColourValue;
+    class CompressedNodeTracks;
     class ConfigDialog;
     template <typename T> class Controller;
     template <typename T> class ControllerFunction;
@@ -173,6 +175,7 @@ namespace Ogre {
     class ExternalTextureSourceManager;
     class Factory;
     struct FrameEvent;
+    class FrameAllocator;
     class FrameListener;
     class Frustum;
     struct GpuLogicalBufferStruct;
@@ -220,6 +223,7 @@ namespace Ogre {
     class MeshSerializer;
     class MeshSerializerImpl;
     class MeshManager;
+    class MeshTriangleBvh;
     class MovableObject;
     class MovablePlane;
     class Node;
@@ -245,6 +249,7 @@ namespace Ogre {
     class Plugin;
     class Pose;
     class Profile;
+    class ProfileName;
     class Profiler;
     class Quaternion;
     class Radian;
@@ -292,6 +297,7 @@ namespace Ogre {
     class SimpleRenderable;
     class SimpleSpline;
     class Skeleton;
+    class SkeletonAnimationCache;
     class SkeletonInstance;
     class SkeletonManager;
     class Sphere;
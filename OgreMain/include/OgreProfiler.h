@@ -43,6 +43,9 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 
 #include "OgrePrerequisites.h"
 #include "OgreSingleton.h"
+#include "OgreAtomicScalar.h"
+#include "OgreStringVector.h"
+#include "Threading/OgreThreadHeaders.h"
 #include "OgreHeaderPrefix.h"
 
 #if OGRE_PROFILING == 1
@@ -52,6 +55,12 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #   define OgreProfileGroup( a, g ) Ogre::Profile _OgreProfileInstance( (a), (g) )
 #   define OgreProfileBeginGroup( a, g ) Ogre::Profiler::getSingleton().beginProfile( (a), (g) )
 #   define OgreProfileEndGroup( a, g ) Ogre::Profiler::getSingleton().endProfile( (a), (g) )
+    // Same as OgreProfile and OgreProfileGroup for names which never change, such as
+    // string literals; the name is interned once, the first time the macro is reached
+#   define OgreProfileLiteral( a ) static const Ogre::ProfileName _OgreProfileName( (a) ); \
+        Ogre::Profile _OgreProfileInstance( _OgreProfileName )
+#   define OgreProfileGroupLiteral( a, g ) static const Ogre::ProfileName _OgreProfileName( (a) ); \
+        Ogre::Profile _OgreProfileInstance( _OgreProfileName, (g) )
 #   define OgreProfileBeginGPUEvent( g ) Ogre::Profiler::getSingleton().beginGPUEvent(g)
 #   define OgreProfileEndGPUEvent( g ) Ogre::Profiler::getSingleton().endGPUEvent(g)
 #   define OgreProfileMarkGPUEvent( e ) Ogre::Profiler::getSingleton().markGPUEvent(e)
@@ -62,6 +71,8 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #   define OgreProfileGroup( a, g ) 
 #   define OgreProfileBeginGroup( a, g ) 
 #   define OgreProfileEndGroup( a, g ) 
+#   define OgreProfileLiteral( a )
+#   define OgreProfileGroupLiteral( a, g )
 #   define OgreProfileBeginGPUEvent( e )
 #   define OgreProfileEndGPUEvent( e )
 #   define OgreProfileMarkGPUEvent( e )
@@ -90,6 +101,23 @@ namespace Ogre {
         OGREPROF_RENDERING = 0x20000000
     };
 
+    /** The name of a profile, interned for the trace when it is created.
+        @remarks
+            OgreProfileLiteral and OgreProfileGroupLiteral keep one of these in a
+            function-local static, so the name is only looked up the first time
+            the macro is reached rather than on every begin and end event.
+    */
+    class _OgreExport ProfileName : public ProfilerAlloc
+    {
+        public:
+            explicit ProfileName(const String& profileName);
+
+            /// The name of the profile
+            const String name;
+            /// Identifier of the name in traces, see Profiler::getTraceNameId
+            const uint32 traceNameId;
+    };
+
     /** An individual profile that will be processed by the Profiler
         @remarks
             Use the macro OgreProfile(name) instead of instantiating this profile directly
@@ -106,12 +134,15 @@ namespace Ogre {
 
         public:
             Profile(const String& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
+            Profile(const ProfileName& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
             ~Profile();
 
         protected:
 
-            /// The name of this profile
+            /// The name of this profile, if it was not given as a ProfileName
             String mName;
+            /// The interned name of this profile, or null
+            const ProfileName* mInternedName;
             /// The group ID
             uint32 mGroupID;
             
@@ -220,6 +251,84 @@ namespace Ogre {
         uint            hierarchicalLvl;
     };
 
+    /** A single begin or end event recorded by the trace backend of the Profiler */
+    struct ProfileTraceEvent
+    {
+        /// Time of the event in microseconds, as given by the Profiler's timer
+        ulong time;
+        /// Interned name of the profile, see Profiler::getTraceName
+        uint32 nameId;
+        /// True for the start of a profile, false for its end
+        bool begin;
+    };
+
+    /** Ring of trace events written by a single thread.
+    @remarks
+        Only the owning thread appends, without taking any lock. Readers take
+        a copy with getEvents, which drops anything the writer may have
+        overwritten while it was being copied. Once full the oldest events
+        are overwritten, so a trace always holds the most recent activity.
+    */
+    class _OgreExport ProfileTraceBuffer : public ProfilerAlloc
+    {
+    public:
+        typedef vector<ProfileTraceEvent>::type EventList;
+
+        /** Constructor
+        @param capacity Number of events held, rounded up to a power of two
+        @param threadIndex Index identifying the owning thread in exported traces
+        */
+        ProfileTraceBuffer(size_t capacity, uint32 threadIndex);
+        ~ProfileTraceBuffer();
+
+        /// Appends an event; must only be called from the owning thread
+        void push(ulong time, uint32 nameId, bool begin)
+        {
+            // storage is only allocated once a thread records something
+            if (!mEvents)
+                allocate();
+
+            ProfileTraceEvent& e = mEvents[mWriteSlot];
+            e.time = time;
+            e.nameId = nameId;
+            e.begin = begin;
+            if (++mWriteSlot > mCapacity)
+                mWriteSlot = 0;
+            // atomic increment also orders the writes above before publishing
+            ++mHead;
+        }
+
+        /** Appends a copy of the events recorded since the last clear to the given list.
+        @remarks
+            The ring has one slot more than its capacity, which is the one the
+            owner writes next, so up to capacity events can be copied while
+            the owner keeps recording.
+        @return The number of events that were lost to the ring wrapping around
+        */
+        size_t getEvents(EventList& events) const;
+
+        /// Forgets the events recorded so far, safe to call while the owner writes
+        void clear() { mStart.set(mHead.get()); }
+
+        uint32 getThreadIndex() const { return mThreadIndex; }
+
+        /// Name shown for the owning thread in exported traces
+        String threadName;
+
+    protected:
+        void allocate();
+
+        ProfileTraceEvent* mEvents;
+        size_t mCapacity;
+        /// Slot of the next event, only used by the owner
+        size_t mWriteSlot;
+        /// Number of events recorded
+        AtomicScalar<size_t> mHead;
+        /// Written by clear on any thread, read by getEvents on another
+        AtomicScalar<size_t> mStart;
+        uint32 mThreadIndex;
+    };
+
     /** ProfileSessionListener should be used to visualize profile results.
         Concrete impl. could be done using Overlay's but its not limited to 
         them you can also create a custom listener which sends the profile
@@ -272,6 +381,13 @@ namespace Ogre {
             OgreProfile(name) and braces to limit the scope. You must enable the Profile
             before you can used it with setEnabled(true). If you want to disable profiling
             in Ogre, simply set the macro OGRE_PROFILING to 0.
+        @par
+            The hierarchical statistics are only gathered on the thread which created
+            the profiler. Independently of those, setTraceEnabled(true) records every
+            begin and end from any thread into a per thread ring buffer, with the names
+            interned, which exportTrace writes out in the Chrome trace event format
+            (viewable in chrome://tracing). This makes it possible to see WorkQueue
+            workers and background resource loading alongside the render loop.
         @author Amit Mathew (amitmathew (at) yahoo (dot) com)
         @todo resolve artificial cap on number of profiles displayed
         @todo fix display ordering of profiles not called every frame
@@ -305,6 +421,11 @@ namespace Ogre {
             */
             void beginProfile(const String& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
 
+            /** Starts a profile whose name has already been interned for the trace
+            @copydetails Profiler::beginProfile(const String&, uint32)
+            */
+            void beginProfile(const ProfileName& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
+
             /** Ends a profile
             @remarks 
                 Use the macro OgreProfileEnd(name) instead of calling this directly so that
@@ -321,6 +442,11 @@ namespace Ogre {
             */
             void endProfile(const String& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
 
+            /** Ends a profile whose name has already been interned for the trace
+            @copydetails Profiler::endProfile(const String&, uint32)
+            */
+            void endProfile(const ProfileName& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
+
             /** Mark the beginning of a GPU event group
              @remarks Can be safely called in the middle of the profile.
              */
@@ -416,6 +542,52 @@ namespace Ogre {
             */
             void removeListener(ProfileSessionListener* listener);
 
+            /** Sets whether begin and end events are recorded for export as a trace.
+            @remarks
+                Takes effect immediately, on all threads. Events are subject to the
+                profile group mask but not to disableProfile. This does not depend on
+                setEnabled; either can be used without the other.
+            */
+            void setTraceEnabled(bool enabled) { mTraceEnabled.set(enabled); }
+
+            /** Gets whether begin and end events are recorded for export as a trace */
+            bool getTraceEnabled() const { return mTraceEnabled.get(); }
+
+            /** Sets the number of events each thread can hold before the oldest are
+                overwritten. Only affects threads which have not recorded anything yet.
+            */
+            void setTraceBufferCapacity(size_t events) { mTraceBufferCapacity = events; }
+
+            /** Gets the number of events each thread can hold */
+            size_t getTraceBufferCapacity() const { return mTraceBufferCapacity; }
+
+            /** Names the calling thread in exported traces */
+            void setTraceThreadName(const String& name);
+
+            /** Returns the identifier the trace uses for the given profile name,
+                interning it if it has not been seen before
+            @remarks
+                Identifiers are shared by all profilers and stay valid for the
+                lifetime of the process.
+            */
+            static uint32 getTraceNameId(const String& profileName);
+
+            /** Returns the profile name for an interned identifier */
+            static String getTraceName(uint32 nameId);
+
+            /** Writes the recorded trace events as Chrome trace event JSON.
+            @remarks
+                Can be called while other threads are still recording; events
+                recorded during the export may or may not be included.
+            */
+            void exportTrace(std::ostream& stream) const;
+
+            /** Writes the recorded trace events to a file as Chrome trace event JSON */
+            void exportTrace(const String& filename) const;
+
+            /** Discards all recorded trace events */
+            void clearTrace();
+
             /** Override standard Singleton retrieval.
             @remarks
             Why do we do this? Well, it's because the Singleton
@@ -468,6 +640,18 @@ namespace Ogre {
             /** Handles a change of the profiler's enabled state*/
             void changeEnableState();
 
+            /** Returns the trace buffer of the calling thread, creating it if needed */
+            ProfileTraceBuffer* getThreadTraceBuffer();
+
+            /** Whether the calling thread is the one the hierarchical profile is kept for */
+            bool isProfilerThread() const;
+
+            /// Begins a profile, interned is null if the name has not been interned
+            void beginProfileImpl(const String& profileName, uint32 groupID, const ProfileName* interned);
+
+            /// Ends a profile, interned is null if the name has not been interned
+            void endProfileImpl(const String& profileName, uint32 groupID, const ProfileName* interned);
+
             // lol. Uses typedef; put's original container type in name.
             typedef set<String>::type DisabledProfileMap;
             typedef ProfileInstance::ProfileChildren ProfileChildren;
@@ -512,6 +696,36 @@ namespace Ogre {
             Real mAverageFrameTime;
             bool mResetExtents;
 
+            /// Whether begin and end events are recorded for the trace, read by all threads
+            AtomicScalar<bool> mTraceEnabled;
+
+            /// Number of events each new trace buffer holds
+            size_t mTraceBufferCapacity;
+
+            struct TraceThread : public ProfilerAlloc
+            {
+                ProfileTraceBuffer* buffer;
+            };
+            /// Per thread handle of the trace buffer, the buffers themselves outlive their threads
+            OGRE_THREAD_POINTER(TraceThread, mTraceThread);
+
+            typedef vector<ProfileTraceBuffer*>::type TraceBufferList;
+            TraceBufferList mTraceBuffers;
+
+            /// Guards the buffer list, not the buffers' contents
+            OGRE_MUTEX(mTraceMutex);
+
+            typedef map<String, uint32>::type TraceNameMap;
+            static TraceNameMap msTraceNameIds;
+            static StringVector msTraceNames;
+            /// Guards the name table
+            OGRE_STATIC_MUTEX(msTraceNameMutex);
+
+#if OGRE_THREAD_SUPPORT
+            /// The thread which created the profiler
+            OGRE_THREAD_ID_TYPE mProfilerThreadId;
+#endif
+
 
     }; // end class
     /** @} */
@@ -79,7 +79,8 @@ namespace Ogre {
         internal storage is then avoided.
     @note
         Radix sorting is often associated with just unsigned integer values. Our
-        implementation can handle both unsigned and signed integers, as well as
+        implementation can handle both unsigned and signed 32-bit integers, unsigned
+        64-bit integers (e.g. keys packing several sort criteria), as well as
         floats (which are often not supported by other radix sorters). doubles
         are not supported; you will need to implement your functor object to convert
         to float if you wish to use this sort routine.
@@ -91,8 +92,8 @@ namespace Ogre {
         typedef typename TContainer::iterator ContainerIter;
     protected:
         /// Alpha-pass counters of values (histogram)
-        /// 4 of them so we can radix sort a maximum of a 32bit value
-        int mCounters[4][256];
+        /// 8 of them so we can radix sort a maximum of a 64bit value
+        int mCounters[8][256];
         /// Beta-pass offsets 
         int mOffsets[256];
         /// Sort area size
@@ -78,6 +78,51 @@ namespace Ogre {
 
     #define OGRE_RENDERABLE_DEFAULT_PRIORITY  100
 
+    /** Renderables queued by a MovableObject for the cameras it was last seen
+        from, which a RenderQueue doing entry cache passes can queue again 
+        without calling MovableObject::_updateRenderQueue.
+    @see RenderQueue::_beginEntryCachePass
+    */
+    class _OgreExport RenderQueueEntryCache : public RenderQueueAlloc
+    {
+    public:
+        /// A renderable as it was added to a queue group
+        struct Entry
+        {
+            Renderable* renderable;
+            Technique* technique;
+            ushort priority;
+            uint8 groupID;
+
+            Entry(Renderable* rend, Technique* tech, uint8 group, ushort prio)
+                : renderable(rend), technique(tech), priority(prio), groupID(group) {}
+        };
+        typedef vector<Entry>::type EntryList;
+
+        /// Entries queued for one camera
+        struct CameraEntries
+        {
+            const Camera* camera;
+            /// Entry cache pass the entries were queued in
+            uint32 pass;
+            /// MovableObject::_getRenderQueueSignature at the time
+            uint32 signature;
+            EntryList entries;
+        };
+        typedef vector<CameraEntries>::type CameraEntriesList;
+
+        /// Maximum number of cameras entries are kept for
+        static const size_t MAX_CAMERAS = 8;
+
+        /** Gets the entries for the given camera, replacing those of the camera
+            least recently queued for if there are too many.
+        */
+        CameraEntries& getCameraEntries(const Camera* cam);
+
+    protected:
+        CameraEntriesList mCameras;
+    };
+
     /** Class to manage the scene object rendering queue.
         @remarks
             Objects are grouped by material to minimise rendering state changes. The map from
@@ -131,6 +176,33 @@ namespace Ogre {
             virtual bool renderableQueued(Renderable* rend, uint8 groupID, 
                 ushort priority, Technique** ppTech, RenderQueue* pQueue) = 0;
         };
+        typedef vector<MovableObject*>::type MovableObjectList;
+
+        /// Counts of objects and renderables queued by entry cache passes
+        struct EntryCacheStats
+        {
+            /// Renderables queued again from the object caches
+            size_t reusedRenderables;
+            /// Renderables queued by MovableObject::_updateRenderQueue
+            size_t reinsertedRenderables;
+            /// Objects queued which were not queued in the previous pass
+            size_t enteredObjects;
+            /// Objects queued in the previous pass but not in this one
+            size_t leftObjects;
+
+            EntryCacheStats() { reset(); }
+            void reset(void)
+            {
+                reusedRenderables = reinsertedRenderables = enteredObjects = leftObjects = 0;
+            }
+            void merge(const EntryCacheStats& rhs)
+            {
+                reusedRenderables += rhs.reusedRenderables;
+                reinsertedRenderables += rhs.reinsertedRenderables;
+                enteredObjects += rhs.enteredObjects;
+                leftObjects += rhs.leftObjects;
+            }
+        };
     protected:
         RenderQueueGroupMap mGroups;
         /// The current default queue group
@@ -143,6 +215,40 @@ namespace Ogre {
         bool mShadowCastersCannotBeReceivers;
 
         RenderableListener* mRenderableListener;
+        /// Receives the objects processVisibleObject must not queue itself, if set
+        MovableObjectList* mDeferredObjects;
+
+        /// What was queued for a camera by its last entry cache pass
+        struct EntryCacheCamera
+        {
+            uint32 pass;
+            size_t numObjects;
+            uint32 epoch;
+            /// Defaults used by objects which do not set their own group or priority
+            uint8 defaultGroup;
+            ushort defaultPriority;
+        };
+        typedef map<const Camera*, EntryCacheCamera>::type EntryCacheCameraMap;
+        EntryCacheCameraMap mEntryCacheCameras;
+        /// Camera of the current entry cache pass
+        const Camera* mEntryCacheCamera;
+        /// Current entry cache pass, 0 if none
+        uint32 mEntryCachePass;
+        /// Previous pass for the same camera, 0 if the cached entries cannot be reused
+        uint32 mPreviousEntryCachePass;
+        /// Last pass number handed out
+        uint32 mEntryCachePassCounter;
+        /// Objects queued by the current pass, and those of them also queued by the previous one
+        size_t mEntryCacheObjects;
+        size_t mEntryCacheContinuingObjects;
+        EntryCacheStats mEntryCacheStats;
+        /// Entry list recording the renderables added, while an object's entries are being cached
+        RenderQueueEntryCache::EntryList* mRecordedEntries;
+        /// Incremented when passes are destroyed, invalidating the entries cached for this queue
+        uint32 mEntryCacheEpoch;
+
+        /// Queues an object during an entry cache pass
+        void updateRenderQueueCached(MovableObject* mo);
     public:
         RenderQueue();
         virtual ~RenderQueue();
@@ -287,8 +393,45 @@ namespace Ogre {
         { return mRenderableListener; }
 
         /** Merge render queue.
+        @remarks
+            The entry cache pass counts of rhs are added in as well.
         */
         void merge( const RenderQueue* rhs );
+
+        /** Sets a list receiving the objects given to processVisibleObject which
+            cannot be queued from the current thread, rather than queueing them.
+        @remarks
+            Used when this queue is filled by a worker thread, the objects returning
+            false from MovableObject::_canUpdateRenderQueueConcurrently being added
+            to the list so that they can be processed afterwards on the render
+            thread. Set to 0 (the default) to queue all objects.
+        */
+        void _setDeferredObjectList(MovableObjectList* deferred) { mDeferredObjects = deferred; }
+
+        /** Starts queueing the visible objects of a camera from the entries
+            cached by its previous pass where possible.
+        @remarks
+            Until _endEntryCachePass is called, visible objects given to
+            processVisibleObject which were also queued by the previous pass for
+            this camera, and whose MovableObject::_getRenderQueueSignature has
+            not changed since, have the renderables they queued then added again
+            from their RenderQueueEntryCache, rather than being asked to update
+            the queue. Only _updateRenderQueue is skipped: the queue groups are
+            still cleared, filled and sorted as usual. The cached entries are
+            discarded whenever a Pass is destroyed, and are not used while a
+            RenderableListener is set.
+        */
+        void _beginEntryCachePass(const Camera* cam);
+        /** Ends the current entry cache pass.
+        @return Counts for the pass
+        */
+        const EntryCacheStats& _endEntryCachePass(void);
+        /** Makes this queue take part in the entry cache pass of another one,
+            used for queues filled by worker threads and merged into it afterwards.
+        */
+        void _joinEntryCachePass(const RenderQueue* rhs);
+        /// Forgets what was last queued for a camera which is being destroyed
+        void _notifyCameraRemoved(const Camera* cam) { mEntryCacheCameras.erase(cam); }
         /** Utility method to perform the standard actions associated with 
             getting a visible object to add itself to the queue. This is 
             a replacement for SceneManager implementations of the associated
@@ -127,7 +127,20 @@ namespace Ogre {
             /** Sort ascending camera distance 
                 Note value overlaps with descending since both use same sort
             */
-            OM_SORT_ASCENDING = 6
+            OM_SORT_ASCENDING = 6,
+            /** Group by pass through a single sorted list, rather than a map of 
+                pass to renderables.
+            @remarks
+                Each renderable / pass pair is given a 64-bit key made of the pass
+                hash (high 32 bits) and the squared view depth (low 32 bits), which
+                is radix sorted once per frame. Renderables are thus grouped by
+                pass as with OM_PASS_GROUP, and ordered front to back within each
+                pass, without allocating map nodes or per-pass lists. Passes
+                sharing a hash may be interleaved, at the cost of some extra state
+                changes. Visiting a collection using this mode with OM_PASS_GROUP
+                uses the sorted list.
+            */
+            OM_SORT_KEY = 8
         };
 
     protected:
@@ -228,6 +241,29 @@ namespace Ogre {
         /// Radix sorter for sort value 2 (distance)
         static RadixSort<RenderablePassList, RenderablePass, float> msRadixSorter2;
 
+        /// Functor for the 64-bit pass / distance key used by OM_SORT_KEY
+        struct RadixSortFunctorKey
+        {
+            const Camera* camera;
+
+            RadixSortFunctorKey(const Camera* cam)
+                : camera(cam)
+            {
+            }
+
+            uint64 operator()(const RenderablePass& p) const
+            {
+                // Non-negative floats sort like their bit patterns, so the depth
+                // can be stored as is in the low bits (front to back)
+                union { float f; uint32 u; } depth;
+                depth.f = std::max(0.0f, static_cast<float>(p.renderable->getSquaredViewDepth(camera)));
+                return (static_cast<uint64>(p.pass->getHash()) << 32) | depth.u;
+            }
+        };
+
+        /// Radix sorter for the OM_SORT_KEY key
+        static RadixSort<RenderablePassList, RenderablePass, uint64> msRadixSorterKey;
+
         /// Bitmask of the organisation modes requested
         uint8 mOrganisationMode;
 
@@ -235,6 +271,8 @@ namespace Ogre {
         PassGroupRenderableMap mGrouped;
         /// Sorted descending (can iterate backwards to get ascending)
         RenderablePassList mSortedDescending;
+        /// Sorted by pass hash then ascending distance, for OM_SORT_KEY
+        RenderablePassList mSortedByKey;
 
         /// Internal visitor implementation
         void acceptVisitorGrouped(QueuedRenderableVisitor* visitor) const;
@@ -242,6 +280,8 @@ namespace Ogre {
         void acceptVisitorDescending(QueuedRenderableVisitor* visitor) const;
         /// Internal visitor implementation
         void acceptVisitorAscending(QueuedRenderableVisitor* visitor) const;
+        /// Internal visitor implementation
+        void acceptVisitorKeyed(QueuedRenderableVisitor* visitor) const;
 
     public:
         QueuedRenderableCollection();
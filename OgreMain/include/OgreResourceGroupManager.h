@@ -34,8 +34,11 @@ THE SOFTWARE.
 #include "OgreArchive.h"
 #include "OgreIteratorWrappers.h"
 #include "OgreCommon.h"
+#include "OgreWorkQueue.h"
+#include "OgreAtomicScalar.h"
 #include "Threading/OgreThreadHeaders.h"
 #include <ctime>
+#include <cctype>
 #include "OgreHeaderPrefix.h"
 
 // If X11/Xlib.h gets included before this header (for example it happens when
@@ -258,7 +261,8 @@ namespace Ogre {
         @see ResourceGroupManager::unloadResourceGroup
         @see ResourceGroupManager::clearResourceGroup
     */
-    class _OgreExport ResourceGroupManager : public Singleton<ResourceGroupManager>, public ResourceAlloc
+    class _OgreExport ResourceGroupManager : public Singleton<ResourceGroupManager>, public ResourceAlloc,
+        public WorkQueue::RequestHandler
     {
     public:
         OGRE_AUTO_MUTEX; // public to allow external locking
@@ -307,7 +311,40 @@ namespace Ogre {
         ResourceLoadingListener *mLoadingListener;
 
         /// Resource index entry, resourcename->location 
-        typedef map<String, Archive*>::type ResourceLocationIndex;
+        typedef OGRE_HashMap<String, Archive*> ResourceLocationIndex;
+
+        /// Hashes resource names regardless of their case
+        struct CaseInsensitiveHash
+        {
+            size_t operator()(const String& name) const
+            {
+                // FNV-1a
+                uint32 hash = 2166136261u;
+                for (String::const_iterator i = name.begin(); i != name.end(); ++i)
+                {
+                    hash ^= static_cast<uint32>(tolower(static_cast<unsigned char>(*i)));
+                    hash *= 16777619u;
+                }
+                return hash;
+            }
+        };
+        /// Compares resource names regardless of their case
+        struct CaseInsensitiveEqual
+        {
+            bool operator()(const String& a, const String& b) const
+            {
+                if (a.size() != b.size())
+                    return false;
+                for (size_t i = 0; i < a.size(); ++i)
+                {
+                    if (tolower(static_cast<unsigned char>(a[i])) != tolower(static_cast<unsigned char>(b[i])))
+                        return false;
+                }
+                return true;
+            }
+        };
+        /// Resource index entry for case insensitive archives, looked up without lower casing names
+        typedef OGRE_HashMap<String, Archive*, CaseInsensitiveHash, CaseInsensitiveEqual> CaseInsensitiveResourceLocationIndex;
 
         /// List of resources which can be loaded / unloaded
         typedef list<ResourcePtr>::type LoadUnloadResourceList;
@@ -335,7 +372,7 @@ namespace Ogre {
             /// Index of resource names to locations, built for speedy access (case sensitive archives)
             ResourceLocationIndex resourceIndexCaseSensitive;
             /// Index of resource names to locations, built for speedy access (case insensitive archives)
-            ResourceLocationIndex resourceIndexCaseInsensitive;
+            CaseInsensitiveResourceLocationIndex resourceIndexCaseInsensitive;
             /// Pre-declared resources, ready to be created
             ResourceDeclarationList resourceDeclarations;
             /// Created resources which are ready to be loaded / unloaded
@@ -422,6 +459,47 @@ namespace Ogre {
 
         /// Stored current group - optimisation for when bulk loading a group
         ResourceGroup* mCurrentGroup;
+
+        /// Lists of the files of resource locations, null unless enabled
+        ArchiveIndexCache* mIndexCache;
+        /// Finds files in the locations of a group, through the index cache if enabled
+        FileInfoListPtr findGroupFileInfo(ResourceGroup* grp, const String& pattern);
+
+        /// Number of threads resources are prepared on when a group is loaded
+        size_t mLoadingThreadCount;
+#if OGRE_THREAD_SUPPORT
+        /// The thread which created the manager, the only one preparing groups in parallel
+        OGRE_THREAD_ID_TYPE mCreatorThreadId;
+#endif
+        /// The work queue preparing resources, and our channel on it
+        WorkQueue* mWorkQueue;
+        uint16 mWorkQueueChannel;
+        /// Resources of the loading order being prepared in parallel
+        vector<ResourcePtr>::type mParallelResources;
+        /// Next of mParallelResources to prepare, shared by all threads
+        AtomicScalar<size_t> mNextParallelResource;
+        /// Requests for preparing resources still being processed
+        AtomicScalar<size_t> mPendingPrepareTasks;
+        /// Whether resources are being prepared in parallel right now
+        bool mPreparingInParallel;
+
+        /** Prepares the resources of a group on mLoadingThreadCount threads.
+        @remarks
+            The resources are prepared one loading order after the other, the
+            way they're loaded, and those of each loading order are shared out
+            between this thread and requests to the Root's WorkQueue. Nothing
+            is prepared unless this is the thread which created the manager,
+            and it must not have the manager or the group locked, as preparing
+            resources does. Failures are left for the serial pass which
+            follows to raise.
+        */
+        void prepareResourcesInParallel(const String& name);
+        /// Prepares resources of mParallelResources until there are none left
+        void prepareParallelResources(void);
+        /// Registers as a handler of the Root's WorkQueue if not already
+        void registerWorkQueueHandler(void);
+        /// Stops handling requests of the WorkQueue
+        void unregisterWorkQueueHandler(void);
     public:
         ResourceGroupManager();
         virtual ~ResourceGroupManager();
@@ -552,6 +630,75 @@ namespace Ogre {
         void loadResourceGroup(const String& name, bool loadMainResources = true, 
             bool loadWorldGeom = true);
 
+        /** Sets the number of threads resources are prepared on when a group is
+            prepared or loaded.
+        @remarks
+            With more than one thread, prepareResourceGroup and loadResourceGroup
+            start by preparing the resources of the group in parallel, sharing
+            them out between the calling thread and the workers of the Root's
+            WorkQueue; that is, reading and decoding their files, which is most
+            of the work of loading textures and meshes. The resources are then
+            loaded one after the other on the calling thread, as before, which
+            only leaves the work done with the render system, like uploading
+            textures, to it.
+        @par
+            Resources are prepared one loading order after the other (skeletons
+            before meshes, for instance) and manually loaded resources are left
+            to the calling thread. Like with background loading, this requires
+            the preparation of the resources in the group to be thread safe,
+            and resource listeners may be told a resource has been prepared
+            from any of the threads. Groups are only prepared in parallel when
+            prepared or loaded from the thread which created this manager, not
+            from the WorkQueue itself, and that thread must not have the
+            manager locked while doing so. Until the WorkQueue has been
+            started, which Root::initialise does, or if it has no worker
+            threads, resources are prepared on the calling thread only.
+        @param count The number of threads, including the calling one; 1, the
+            default, prepares resources on the calling thread only
+        */
+        void setLoadingThreadCount(size_t count);
+
+        /** Gets the number of threads resources are prepared on when a group is
+            prepared or loaded.
+        @see ResourceGroupManager::setLoadingThreadCount
+        */
+        size_t getLoadingThreadCount(void) const { return mLoadingThreadCount; }
+
+        /** Sets whether the files of resource locations are listed through an
+            ArchiveIndexCache.
+        @remarks
+            Adding a resource location lists all its files, and initialising
+            its group searches them again for scripts, which for a large folder
+            tree can take a good part of the start up time. With the cache
+            enabled, the lists are kept, and saved with saveIndexCache, so the
+            next run can load them with loadIndexCache and only list the
+            locations which have changed since. Disabling the cache forgets
+            the lists. Only the listings made when adding locations and
+            parsing scripts go through the cache.
+        */
+        void setUseIndexCache(bool use);
+
+        /** Gets whether the files of resource locations are listed through an
+            ArchiveIndexCache.
+        */
+        bool getUseIndexCache(void) const { return mIndexCache != 0; }
+
+        /** Enables the index cache and loads the lists of files saved by
+            saveIndexCache, usually before adding resource locations.
+        @see ArchiveIndexCache::load
+        */
+        void loadIndexCache(const DataStreamPtr& stream);
+
+        /** Saves the lists of files of the index cache, once resource
+            locations have been added and their groups initialised.
+        */
+        void saveIndexCache(const DataStreamPtr& stream) const;
+
+        /** Returns whether the index cache has lists which haven't been saved,
+            so it's only written back when a location has changed.
+        */
+        bool isIndexCacheDirty(void) const;
+
         /** Unloads a resource group.
         @remarks
             This method unloads all the resources that have been declared as
@@ -1063,6 +1210,11 @@ namespace Ogre {
         /// Returns the current loading listener
         ResourceLoadingListener *getLoadingListener();
 
+        /// @copydoc WorkQueue::RequestHandler::canHandleRequest
+        bool canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
+        /// @copydoc WorkQueue::RequestHandler::handleRequest
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
+
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
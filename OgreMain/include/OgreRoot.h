@@ -92,7 +92,9 @@ namespace Ogre
         
         ArchiveFactory *mZipArchiveFactory;
         ArchiveFactory *mEmbeddedZipArchiveFactory;
+        ArchiveFactory *mIndexedZipArchiveFactory;
         ArchiveFactory *mFileSystemArchiveFactory;
+        ArchiveFactory *mPackArchiveFactory;
         
 #if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
         AndroidLogListener* mAndroidLogger;
@@ -106,6 +108,7 @@ namespace Ogre
         LodStrategyManager *mLodStrategyManager;
 
         Timer* mTimer;
+        FrameAllocator* mFrameAllocator;
         RenderWindow* mAutoWindow;
         Profiler* mProfiler;
         HighLevelGpuProgramManager* mHighLevelGpuProgramManager;
@@ -561,7 +564,10 @@ namespace Ogre
                 string in order to indicate the type of location, which
                 should map onto one of the provided plugins. Ogre comes
                 configured with the 'FileSystem' (folders) and 'Zip' (archive
-                compressed with the pkzip / WinZip etc utilities) types.
+                compressed with the pkzip / WinZip etc utilities) types, and
+                'IndexedZip' for zip archives whose files are opened from
+                several threads at once, as well as 'Pack' for OGRE's own
+                chunk compressed packs when built with LZ4, see PackArchive.
             @par
                 You can also supply the name of a resource group which should
                 have this location applied to it. The 
@@ -47,6 +47,8 @@ Torus Knot Software Ltd.
 #include "OgreInstanceManager.h"
 #include "OgreRenderSystem.h"
 #include "OgreLodListener.h"
+#include "OgreWorkQueue.h"
+#include "OgreAtomicScalar.h"
 #include "OgreHeaderPrefix.h"
 #include "OgreNameGenerator.h"
 
@@ -70,6 +72,7 @@ namespace Ogre {
     class InstancedGeometry;
     class Rectangle2D;
     class LodListener;
+    class NodeTransformBatch;
     struct MovableObjectLodChangedEvent;
     struct EntityMeshLodChangedEvent;
     struct EntityMaterialLodChangedEvent;
@@ -101,6 +104,8 @@ namespace Ogre {
         */
         void mergeNonRenderedButInFrustum(const AxisAlignedBox& boxBounds, 
             const Sphere& sphereBounds, const Camera* cam);
+        /// Merge the bounds gathered separately into another instance
+        void merge(const VisibleObjectsBoundsInfo& rhs);
 
 
     };
@@ -134,7 +139,7 @@ namespace Ogre {
         dependent on the Camera, which will always call back the SceneManager
         which created it to render the scene. 
      */
-    class _OgreExport SceneManager : public SceneMgtAlloc
+    class _OgreExport SceneManager : public SceneMgtAlloc, public WorkQueue::RequestHandler
     {
     public:
         /// Query type mask which will be used for world geometry @see SceneQuery
@@ -174,6 +179,26 @@ namespace Ogre {
             IRS_RENDER_RECEIVER_PASS
         };
 
+        /// How the bone matrices of a skeleton were brought up to date for a frame
+        enum SkeletonUpdateType
+        {
+            /// The animation was applied to the skeleton, or its result found in the SkeletonAnimationCache
+            SUT_EVALUATED,
+            /// The matrices were interpolated between two earlier evaluations
+            SUT_INTERPOLATED,
+            /// The matrices were left as they were
+            SUT_SKIPPED,
+            SUT_COUNT
+        };
+
+        /// Number of skeletons per SkeletonUpdateType in a frame
+        struct SkeletonUpdateStats
+        {
+            size_t evaluatedSkeletons;
+            size_t interpolatedSkeletons;
+            size_t skippedSkeletons;
+        };
+
         /** Enumeration of the possible modes allowed for processing the special case
         render queue list.
         @see SceneManager::setSpecialCaseRenderQueueMode
@@ -186,6 +211,18 @@ namespace Ogre {
             SCRQM_EXCLUDE
         };
 
+        /** Describes how the derived transforms of nodes are calculated
+            during the scene graph update.
+        @see SceneManager::setNodeTransformStorage
+        */
+        enum NodeTransformStorage
+        {
+            /// Each node calculates its own derived transform from its parent's
+            NTS_PER_NODE,
+            /// Transforms are copied into scratch SoA blocks per hierarchy depth, calculated 4 at a time and written back to the nodes
+            NTS_SOA_BLOCKS
+        };
+
         struct SkyDomeGenParameters
         {
             Real skyDomeCurvature;
@@ -529,6 +566,10 @@ namespace Ogre {
         LightInfoList mTestLightInfos; // potentially new list
         ulong mLightsDirtyCounter;
         LightList mShadowTextureCurrentCasterLightList;
+        /// Storage lent to the light list of the additive shadowed render loops, kept across frames
+        LightList mAdditiveLightList;
+        /// Storage lent to the light list of renderShadowVolumesToStencil, kept across frames
+        LightList mShadowVolumeLightList;
 
         typedef map<String, MovableObject*>::type MovableObjectMap;
         /// Simple structure to hold MovableObject map and a mutex to go with it.
@@ -650,6 +691,8 @@ namespace Ogre {
         RenderObjectListenerList mRenderObjectListeners;
         typedef vector<Listener*>::type ListenerList;
         ListenerList mListeners;
+        /// Copy of mListeners taken to fire an event, transient so it lives in the frame arena
+        typedef std::vector<Listener*, STLAllocator<Listener*, FrameAllocPolicy> > FrameListenerList;
         /// Internal method for firing the queue start event
         virtual void firePreRenderQueues();
         /// Internal method for firing the queue end event
@@ -793,6 +836,7 @@ namespace Ogre {
         typedef vector<InstanceManager*>::type      InstanceManagerVec;
         InstanceManagerVec mDirtyInstanceManagers;
         InstanceManagerVec mDirtyInstanceMgrsTmp;
+        OGRE_MUTEX(mDirtyInstanceManagersMutex);
 
         /** Updates all instance managaers with dirty instance batches. @see _addDirtyInstanceManager */
         void updateDirtyInstanceManagers(void);
@@ -1000,12 +1044,265 @@ namespace Ogre {
         virtual void bindGpuProgram(GpuProgram* prog);
         virtual void updateGpuProgramParameters(const Pass* p);
 
+        /// Kinds of per-frame work which can be split across WorkQueue workers
+        enum WorkerTaskType
+        {
+            WTT_UPDATE_SCENE_GRAPH = 0,
+            WTT_UPDATE_NODE_TRANSFORMS = 1,
+            WTT_FIND_VISIBLE_OBJECTS = 2,
+            WTT_UPDATE_ANIMATIONS = 3,
+            WTT_FIND_SHADOW_SILHOUETTES = 4,
+            WTT_WRITE_SHADOW_VOLUMES = 5,
+            WTT_EXECUTE_SCENE_QUERIES = 6
+        };
 
+        /// WorkQueue channel used to dispatch worker tasks
+        uint16 mWorkQueueChannel;
+        /// WorkQueue this SceneManager is registered with as a request handler, if any
+        WorkQueue* mWorkerTaskQueue;
+        /// Number of dispatched worker tasks which have not completed yet
+        AtomicScalar<uint32> mPendingWorkerTasks;
+        /// Description of the first exception raised by a worker task, if any
+        String mWorkerTaskError;
+        OGRE_MUTEX(mWorkerTaskErrorMutex);
+
+        /** Runs a task of the given type on this thread and numTasks - 1 further
+            copies of it on the WorkQueue worker threads, returning once all of
+            them have completed.
+        @remarks
+            Tasks must share their work out between themselves, typically by
+            pulling items off a list through an AtomicScalar index.
+        */
+        void fireWorkerTasksAndWait(WorkerTaskType type, size_t numTasks);
+        /// Executes one worker task, on whichever thread picked it up
+        virtual void executeWorkerTask(uint16 type);
+        /// Registers this SceneManager with the current WorkQueue if not done yet
+        void registerWorkerTaskHandler(void);
+        /// Unregisters this SceneManager from the WorkQueue, if registered
+        void unregisterWorkerTaskHandler(void);
+
+        /// Number of threads sharing the scene graph update (1 = serial update)
+        size_t mSceneGraphUpdateThreadCount;
+        /// Subtree roots to update in parallel, with the parentHasChanged flag for each
+        typedef std::pair<Node*, bool> NodeUpdateEntry;
+        typedef vector<NodeUpdateEntry>::type NodeUpdateEntryList;
+        NodeUpdateEntryList mSceneGraphUpdateSubtrees;
+        /// Nodes above the subtrees, in top-down order, to complete once those are done
+        typedef vector<Node*>::type NodeList;
+        NodeList mSceneGraphUpdateParents;
+        /// Scratch lists used while splitting the scene graph into subtrees
+        NodeUpdateEntryList mSceneGraphUpdateSplitTmp;
+        NodeList mSceneGraphUpdateChildrenTmp;
+        /// Index of the next subtree to be picked up by a worker task
+        AtomicScalar<uint32> mNextSceneGraphUpdateSubtree;
+
+        /** Updates the scene graph from the root, splitting it into independent
+            subtrees processed by mSceneGraphUpdateThreadCount threads.
+        */
+        virtual void updateSceneGraphParallel(void);
+        /// Worker task updating subtrees gathered by updateSceneGraphParallel
+        void updateSceneGraphSubtrees(void);
+
+        /// How derived node transforms are calculated in _updateSceneGraph
+        NodeTransformStorage mNodeTransformStorage;
+        /// Nodes to update at each depth of the hierarchy, for NTS_SOA_BLOCKS
+        typedef vector<NodeUpdateEntryList>::type NodeUpdateLevelList;
+        NodeUpdateLevelList mSceneGraphUpdateLevels;
+        /// Scratch copies of the transforms of the nodes being updated at each depth, for NTS_SOA_BLOCKS
+        typedef vector<NodeTransformBatch*>::type NodeTransformBatchList;
+        NodeTransformBatchList mNodeTransformBatches;
+        /// Batch currently shared out between worker tasks
+        NodeTransformBatch* mCurrentNodeTransformBatch;
+        /// Index of the next range of mCurrentNodeTransformBatch blocks to be picked up
+        AtomicScalar<uint32> mNextNodeTransformRange;
+
+        /** Updates the scene graph from the root one depth at a time, calculating
+            the derived transforms of the nodes at each depth in scratch SoA blocks
+            and writing them back to the nodes.
+        */
+        virtual void updateSceneGraphBatched(void);
+        /// Worker task updating ranges of blocks of mCurrentNodeTransformBatch
+        void updateNodeTransformRanges(void);
+
+        /// Number of threads sharing the search for visible objects (1 = serial search)
+        size_t mCullingThreadCount;
+        /// Scene nodes whose objects are searched in parallel, with whether to include their children
+        typedef std::pair<SceneNode*, bool> VisibleObjectsItem;
+        typedef vector<VisibleObjectsItem>::type VisibleObjectsItemList;
+        VisibleObjectsItemList mVisibleObjectsItems;
+        /// Scratch lists used while splitting the scene graph into items
+        NodeList mVisibleObjectsSplitTmp[2];
+        /// Render queue, bounds and deferred objects filled from a contiguous range of items
+        struct VisibleObjectsChunk;
+        typedef vector<VisibleObjectsChunk*>::type VisibleObjectsChunkList;
+        /// Pool of chunks, reused every frame
+        VisibleObjectsChunkList mVisibleObjectsChunks;
+        /// Number of chunks used by the current search
+        size_t mNumVisibleObjectsChunks;
+        /// Parameters of the current search, for the worker tasks
+        Camera* mVisibleObjectsCamera;
+        bool mVisibleObjectsOnlyShadowCasters;
+        /// Index of the next chunk to be picked up by a worker task
+        AtomicScalar<uint32> mNextVisibleObjectsChunk;
+
+        /** Returns whether _findVisibleObjects should search the scene graph on
+            several threads, given the current settings.
+        */
+        virtual bool isParallelCullingEnabled(void) const;
+        /** Fills mVisibleObjectsItems by descending from the root node, skipping
+            the nodes outside the camera frustum.
+        */
+        virtual void splitVisibleObjectsItems(Camera* cam);
+        /** Queues the visible objects of the items in mVisibleObjectsItems using
+            mCullingThreadCount threads.
+        @remarks
+            The items are split into a fixed number of chunks, each of them being
+            processed into a render queue of its own. The queues are then merged
+            into the main render queue in item order, so the result does not
+            depend on the number of threads. Objects which cannot be queued
+            concurrently (see MovableObject::_canUpdateRenderQueueConcurrently)
+            are queued last, on this thread.
+        */
+        virtual void findVisibleObjectsParallel(Camera* cam, 
+            VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+        /** Queues the visible objects of one item of mVisibleObjectsItems.
+        @remarks
+            Called from worker threads, so it must only add to the given queue
+            and bounds. Scene managers which fill mVisibleObjectsItems
+            themselves may override this to match.
+        */
+        virtual void findVisibleObjectsInItem(const VisibleObjectsItem& item, Camera* cam, 
+            RenderQueue* queue, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+        /// Worker task processing chunks of mVisibleObjectsItems
+        void findVisibleObjectsInChunks(void);
+
+        /// Number of threads sharing the animation of visible entities (1 = updated when queued)
+        size_t mAnimationThreadCount;
+        /// Entities whose animation update has been prepared for the worker tasks
+        typedef vector<Entity*>::type EntityList;
+        EntityList mAnimationUpdateEntities;
+        /// Index of the next batch of mAnimationUpdateEntities to be picked up by a worker task
+        AtomicScalar<uint32> mNextAnimationUpdateBatch;
+
+        /** Updates the skeletal animation and software skinning of the
+            entities visible from the camera using mAnimationThreadCount threads.
+        @see Entity::_prepareConcurrentAnimationUpdate
+        */
+        virtual void updateAnimationsParallel(Camera* cam);
+        /// Worker task processing batches of mAnimationUpdateEntities
+        void updateAnimationBatches(void);
+        /// Skeleton updates of the current frame per SkeletonUpdateType, counted from worker threads
+        AtomicScalar<uint32> mSkeletonUpdateCounts[SUT_COUNT];
+        /// Bone matrices shared between entities within a frame, null unless enabled
+        SkeletonAnimationCache* mSkeletonAnimationCache;
+
+        /// Number of threads generating the stencil shadow volumes of a light (1 = one caster at a time)
+        size_t mShadowVolumeThreadCount;
+        /// A shadow volume whose indexes are generated by the worker tasks
+        struct ShadowVolumeItem
+        {
+            ShadowCaster::ShadowVolumeBuild build;
+            /// Whether to render the volume using the zfail method
+            bool zfail;
+        };
+        typedef vector<ShadowVolumeItem>::type ShadowVolumeItemList;
+        /// Shadow volumes of the light being rendered, only the first mNumShadowVolumeItems are in use
+        ShadowVolumeItemList mShadowVolumeItems;
+        size_t mNumShadowVolumeItems;
+        /// Range of mShadowVolumeItems whose indexes are being written
+        size_t mShadowVolumeItemsBegin;
+        size_t mShadowVolumeItemsEnd;
+        /// Locked area of the shadow index buffer, and the index it starts at
+        unsigned short* mShadowVolumeIndexes;
+        size_t mShadowVolumeIndexStart;
+        /// Index of the next shadow volume to be picked up by a worker task
+        AtomicScalar<uint32> mNextShadowVolumeItem;
+
+        /** Renders a shadow volume into the stencil buffer, and the debug
+            shadow marker if enabled.
+        */
+        void renderShadowVolume(ShadowCaster::ShadowRenderableListIterator iShadowRenderables,
+            const LightList* manualLightList, unsigned long flags, bool zfailAlgo, bool stencil2sided);
+        /** Generates the indexes of the shadow volumes prepared in mShadowVolumeItems
+            using mShadowVolumeThreadCount threads, and renders them.
+        @see ShadowCaster::_prepareShadowVolume
+        */
+        virtual void renderShadowVolumesParallel(const LightList* manualLightList, bool stencil2sided);
+        /// Worker task finding the silhouettes of mShadowVolumeItems
+        void findShadowVolumeSilhouettes(void);
+        /// Worker task writing the indexes of mShadowVolumeItems from mShadowVolumeItemsBegin to mShadowVolumeItemsEnd
+        void writeShadowVolumeIndexes(void);
+
+        /// Number of threads sharing the batched scene queries (1 = on the calling thread only)
+        size_t mSceneQueryThreadCount;
+        /// Kinds of batched scene queries
+        enum BatchQueryType
+        {
+            BQT_RAY,
+            BQT_SPHERE,
+            BQT_BOX
+        };
+        /// Batched scene queries being executed, and where their results go
+        struct BatchQuery
+        {
+            BatchQueryType type;
+            /// Volumes of the queries, only the array matching the type is set
+            const Ray* rays;
+            const Sphere* spheres;
+            const AxisAlignedBox* boxes;
+            size_t count;
+            /// Caller storage for the results, see executeRayQueries
+            SceneQueryBatchHit* hits;
+            size_t maxHitsPerQuery;
+            size_t* hitCounts;
+            uint32 queryMask;
+            uint32 queryTypeMask;
+        };
+        BatchQuery mBatchQuery;
+        /// Largest number of queries handed to executeBatchQueryPacket at once
+        static const size_t BATCH_QUERY_PACKET_SIZE = 32;
+        /// Objects passing the masks of mBatchQuery, with their world bounds
+        typedef std::pair<MovableObject*, AxisAlignedBox> BatchQueryObject;
+        typedef vector<BatchQueryObject>::type BatchQueryObjectList;
+        BatchQueryObjectList mBatchQueryObjects;
+        /// Index of the next packet of mBatchQuery to be picked up by a worker task
+        AtomicScalar<uint32> mNextBatchQueryPacket;
+
+        /** Executes the queries described by mBatchQuery, returning the number
+            of hits stored.
+        */
+        size_t executeBatchQueries(void);
+        /** Gets the scene ready for executing mBatchQuery, on the calling thread.
+        @remarks
+            The default gathers the objects passing the masks into
+            mBatchQueryObjects. Scene managers overriding
+            executeBatchQueryPacket to traverse their own structure should
+            bring that structure up to date here instead.
+        */
+        virtual void prepareBatchQueries(void);
+        /** Executes the queries of mBatchQuery from first to first + count - 1.
+        @remarks
+            The scene is traversed once for all of them, testing each object
+            against every query of the packet. This is called from worker
+            threads, so it must only read the scene and record its results
+            through addBatchQueryHit. count is at most BATCH_QUERY_PACKET_SIZE.
+        */
+        virtual void executeBatchQueryPacket(size_t first, size_t count);
+        /// Worker task processing packets of mBatchQuery
+        void executeBatchQueryPackets(void);
+        /** Tests a query of mBatchQuery against a box, giving the distance to it
+            along the ray for ray queries and 0 otherwise.
+        */
+        bool testBatchQuery(size_t query, const AxisAlignedBox& box, Real& distance) const;
+        /** Records that a query of mBatchQuery hit an object, keeping the
+            nearest hits of ray queries.
+        */
+        void addBatchQueryHit(size_t query, MovableObject* movable, Real distance);
 
-
-
-
-
+        /// Whether visible objects are queued through RenderQueue entry cache passes
+        bool mRenderQueueEntryCacheEnabled;
+        /// Entry cache pass counts summed over the current frame
+        RenderQueue::EntryCacheStats mRenderQueueEntryCacheStats;
 
         /// Set of registered LOD listeners
         typedef set<LodListener*>::type LodListenerSet;
@@ -1022,6 +1319,8 @@ namespace Ogre {
         /// List of entity material LOD changed events
         typedef vector<EntityMaterialLodChangedEvent>::type EntityMaterialLodChangedEventList;
         EntityMaterialLodChangedEventList mEntityMaterialLodChangedEvents;
+        /// Protects the LOD event lists, which may be appended to while culling on several threads
+        OGRE_MUTEX(mLodEventsMutex);
 
     public:
         /** Constructor.
@@ -1748,8 +2047,7 @@ namespace Ogre {
             @par
                 On failure, false is returned.
         */
-        virtual bool setOption( const String& strKey, const void* pValue )
-        { (void)strKey; (void)pValue; return false; }
+        virtual bool setOption( const String& strKey, const void* pValue );
 
         /** Method for getting the value of an implementation-specific Scene Manager option.
             @param
@@ -1764,8 +2062,7 @@ namespace Ogre {
             @par
                 On failure, false is returned and pDestValue is set to NULL.
         */
-        virtual bool getOption( const String& strKey, void* pDestValue )
-        { (void)strKey; (void)pDestValue; return false; }
+        virtual bool getOption( const String& strKey, void* pDestValue );
 
         /** Method for verifying whether the scene manager has an implementation-specific
             option.
@@ -1776,8 +2073,7 @@ namespace Ogre {
             @remarks
                 If it does not, false is returned.
         */
-        virtual bool hasOption( const String& strKey ) const
-        { (void)strKey; return false; }
+        virtual bool hasOption( const String& strKey ) const;
 
         /** Method for getting all possible values for a specific option. When this list is too large
             (i.e. the option expects, for example, a float), the return value will be true, but the
@@ -1802,8 +2098,7 @@ namespace Ogre {
             @return
                 On success, true is returned. On failure, false is returned.
         */
-        virtual bool getOptionKeys( StringVector& refKeys )
-        { (void)refKeys; return false; }
+        virtual bool getOptionKeys( StringVector& refKeys );
 
         /** Internal method for updating the scene graph ie the tree of SceneNode instances managed by this class.
             @remarks
@@ -2671,6 +2966,74 @@ namespace Ogre {
         /** Destroys a scene query of any type. */
         virtual void destroyQuery(SceneQuery* query);
 
+        /** Tests many rays at once against the world bounding boxes of the
+            movable objects, writing the results into storage provided by the
+            caller.
+        @remarks
+            This suits running large numbers of line of sight checks every
+            frame: no query object is created, and nothing is allocated once
+            the internal storage has grown with the scene. The rays are
+            processed in packets, the scene being traversed once per packet
+            rather than once per ray, and the packets are shared out between
+            the threads set with setSceneQueryThreadCount. The results are the
+            same whatever the number of threads.
+        @par
+            As with RaySceneQuery only movable objects are tested, but only
+            against their bounding boxes: world geometry and triangle results
+            (see RaySceneQuery::setQueryTriangles) are not supported. The scene
+            must not be changed while the queries run, and batched queries must
+            not be executed from several threads at once.
+        @param rays Array of count rays to test.
+        @param count Number of queries.
+        @param hits Storage for count * maxHitsPerQuery results, those of the
+            query i starting at hits[i * maxHitsPerQuery]. The nearest hits of
+            each ray are stored, nearest first.
+        @param maxHitsPerQuery Number of results stored for each query.
+        @param hitCounts Storage for count values, receiving the number of
+            objects hit by each query. This may be more than maxHitsPerQuery,
+            in which case only maxHitsPerQuery of them were stored.
+        @param queryMask Mask compared with MovableObject::getQueryFlags.
+        @param queryTypeMask Mask compared with MovableObject::getTypeFlags, by
+            default everything but lights and effects as for SceneQuery.
+        @return The total number of results stored.
+        */
+        size_t executeRayQueries(const Ray* rays, size_t count, SceneQueryBatchHit* hits,
+            size_t maxHitsPerQuery, size_t* hitCounts, uint32 queryMask = 0xFFFFFFFF,
+            uint32 queryTypeMask = ~(FX_TYPE_MASK | LIGHT_TYPE_MASK));
+
+        /** Tests many spheres at once against the world bounding boxes of the
+            movable objects, see executeRayQueries.
+        @remarks
+            The distance of the results is 0. When a sphere hits more than
+            maxHitsPerQuery objects, which of them are stored is unspecified.
+        */
+        size_t executeSphereQueries(const Sphere* spheres, size_t count, SceneQueryBatchHit* hits,
+            size_t maxHitsPerQuery, size_t* hitCounts, uint32 queryMask = 0xFFFFFFFF,
+            uint32 queryTypeMask = ~(FX_TYPE_MASK | LIGHT_TYPE_MASK));
+
+        /** Tests many boxes at once against the world bounding boxes of the
+            movable objects, see executeRayQueries.
+        @remarks
+            The distance of the results is 0. When a box hits more than
+            maxHitsPerQuery objects, which of them are stored is unspecified.
+        */
+        size_t executeBoxQueries(const AxisAlignedBox* boxes, size_t count, SceneQueryBatchHit* hits,
+            size_t maxHitsPerQuery, size_t* hitCounts, uint32 queryMask = 0xFFFFFFFF,
+            uint32 queryTypeMask = ~(FX_TYPE_MASK | LIGHT_TYPE_MASK));
+
+        /** Sets the number of threads executing batched scene queries, see
+            executeRayQueries.
+        @remarks
+            The default of 1 executes them on the calling thread. With higher
+            values, packets of queries are also picked up by the worker
+            threads of the WorkQueue (see Root::getWorkQueue), the calling
+            thread waiting for all of them to be done.
+        */
+        void setSceneQueryThreadCount(size_t count);
+
+        /** Gets the number of threads executing batched scene queries. */
+        size_t getSceneQueryThreadCount(void) const { return mSceneQueryThreadCount; }
+
         typedef MapIterator<CameraList> CameraIterator;
         typedef MapIterator<AnimationList> AnimationIterator;
 
@@ -3380,6 +3743,209 @@ namespace Ogre {
         */
         virtual bool getFindVisibleObjects(void) { return mFindVisibleObjects; }
 
+        /** Sets the number of threads used to update the scene graph transforms
+            and bounds in _updateSceneGraph.
+        @remarks
+            The default of 1 updates the scene graph serially from the root. With
+            higher values the top of the hierarchy is split into independent
+            subtrees which are updated by this thread together with the worker
+            threads of the WorkQueue (see Root::getWorkQueue), all of them being
+            finished before visible objects are searched for. The number of
+            worker threads actually available is set on the WorkQueue itself.
+        @par
+            When enabled, Node::Listener and MovableObject::Listener callbacks
+            triggered by the update may be invoked from worker threads. Scene
+            managers which cannot update nodes concurrently (see
+            supportsParallelSceneGraphUpdate) always use the serial update, as
+            do builds without OGRE_THREAD_SUPPORT.
+        */
+        void setSceneGraphUpdateThreadCount(size_t count);
+
+        /** Gets the number of threads used to update the scene graph. */
+        size_t getSceneGraphUpdateThreadCount(void) const { return mSceneGraphUpdateThreadCount; }
+
+        /** Returns whether nodes created by this SceneManager may be updated
+            from several threads at once.
+        @remarks
+            Scene managers whose nodes maintain shared spatial structures while
+            being updated without synchronisation should return false.
+        */
+        virtual bool supportsParallelSceneGraphUpdate(void) const { return true; }
+
+        /** Sets how the derived transforms of nodes are calculated in _updateSceneGraph.
+        @remarks
+            With NTS_SOA_BLOCKS the nodes needing an update are gathered one depth
+            of the hierarchy at a time, and the transforms of those inheriting
+            both orientation and scale from their parent are copied into
+            structure-of-arrays scratch blocks (see NodeTransformBatch) which are
+            processed 4 nodes at a time by OptimisedUtil. The results are written
+            back to each node with Node::_setDerivedTransform, so the nodes still
+            own their transforms and are traversed as usual; only the arithmetic
+            is batched. The scratch storage is kept by the SceneManager and reused
+            every frame. If several threads are set with
+            setSceneGraphUpdateThreadCount, the blocks of each depth are shared
+            between them.
+        @par
+            Results are equal to those of the per-node update within floating
+            point tolerance, since the SIMD path may round differently. Nodes
+            are visited breadth first, which changes the order in which Node::Listener
+            callbacks are made. The option is ignored by scene managers which do
+            not support splitting the update (see supportsParallelSceneGraphUpdate)
+            and by builds with OGRE_DOUBLE_PRECISION or OGRE_NODE_INHERIT_TRANSFORM.
+            It can also be set through setOption with the "NodeTransformStorage"
+            key and a NodeTransformStorage value, e.g. right after creating the
+            SceneManager.
+        */
+        void setNodeTransformStorage(NodeTransformStorage storage) { mNodeTransformStorage = storage; }
+
+        /** Gets how the derived transforms of nodes are calculated. */
+        NodeTransformStorage getNodeTransformStorage(void) const { return mNodeTransformStorage; }
+
+        /** Sets the number of threads used to search for visible objects in
+            _findVisibleObjects, for the main cameras as well as the texture
+            shadow cameras.
+        @remarks
+            The default of 1 searches the scene graph serially. With higher
+            values the scene graph is split into items whose objects are queued
+            by this thread together with the worker threads of the WorkQueue
+            (see Root::getWorkQueue) into render queues of their own, which are
+            then merged into the main render queue in a fixed order. The
+            resulting queue is thus the same whatever the number of threads,
+            although objects may be queued in a different order than with the
+            serial search.
+        @par
+            Objects are only queued from worker threads when
+            MovableObject::_canUpdateRenderQueueConcurrently returns true, which
+            for the standard objects is the case of entities without animation
+            whose materials are loaded; the others are queued afterwards on this
+            thread. MovableObject::Listener, RenderQueue::RenderableListener,
+            LodListener and MaterialManager::Listener callbacks may however be
+            invoked from worker threads. Displaying scene nodes or bounding
+            boxes through the SceneManager reverts to the serial search, and
+            scene managers overriding _findVisibleObjects may ignore this
+            setting.
+        */
+        void setCullingThreadCount(size_t count);
+
+        /** Gets the number of threads used to search for visible objects. */
+        size_t getCullingThreadCount(void) const { return mCullingThreadCount; }
+
+        /** Sets the number of threads evaluating the animation of visible
+            entities before they are queued for rendering.
+        @remarks
+            The default of 1 leaves each entity to update its skeleton and
+            software skinning when it is queued, on the rendering thread. With
+            higher values, the entities in view of the camera are collected
+            once the scene graph has been updated, and their bone matrices
+            and skinned vertices calculated by this thread together with the
+            worker threads of the WorkQueue (see Root::getWorkQueue), so that
+            queueing them finds the animation up to date.
+        @par
+            Vertex buffers are locked and unlocked on this thread, only the
+            blend itself runs on the workers. Entities sharing a skeleton,
+            with vertex animation, with objects attached to bones or with
+            manual LOD levels are not updated ahead of time, see 
+            Entity::_prepareConcurrentAnimationUpdate. 
+            AnimationTrack::Listener callbacks may be invoked from worker threads.
+        */
+        void setAnimationThreadCount(size_t count);
+
+        /** Gets the number of threads evaluating the animation of visible entities. */
+        size_t getAnimationThreadCount(void) const { return mAnimationThreadCount; }
+
+        /** Sets the number of threads generating the stencil shadow volumes of
+            the casters of a light.
+        @remarks
+            The default of 1 leaves each caster to generate its shadow volume
+            just before it is rendered, locking the shadow index buffer each
+            time. With higher values, the casters which support it (see
+            ShadowCaster::_prepareShadowVolume) are prepared on the rendering
+            thread, then their silhouettes found and their indexes written into
+            the shadow index buffer, locked once for all of them, by this thread
+            together with the worker threads of the WorkQueue (see
+            Root::getWorkQueue), before they are rendered.
+        @par
+            Animated entities are still generated one at a time since they
+            update the edge list of their mesh, and rendered before the others.
+        */
+        void setShadowVolumeThreadCount(size_t count);
+
+        /** Gets the number of threads generating stencil shadow volumes. */
+        size_t getShadowVolumeThreadCount(void) const { return mShadowVolumeThreadCount; }
+
+        /** Gets how many skeletons had their bone matrices evaluated, interpolated
+            or left untouched during the current frame so far.
+        @remarks
+            A skeleton instance is counted once per frame, when the first Entity
+            using it is updated, and again if its entity comes back on screen after
+            it was skipped earlier in the frame. Interpolated and skipped updates only 
+            happen for entities with animation LOD, see Entity::setAnimationLodLevels
+            and Entity::setOffscreenAnimationInterval. The counts are reset when 
+            the first camera of a frame is rendered.
+        */
+        SkeletonUpdateStats getSkeletonUpdateStats(void) const;
+
+        /** Counts one skeleton update of the current frame.
+        @remarks
+            Internal use, called by Entity, possibly from worker threads.
+        */
+        void _notifySkeletonUpdate(SkeletonUpdateType type) { ++mSkeletonUpdateCounts[type]; }
+
+        /** Sets whether entities posed identically share their bone matrices within a frame.
+        @remarks
+            When enabled, entities and instanced entities evaluating their
+            skeleton look up the bone matrices in a SkeletonAnimationCache
+            first, keyed by skeleton and animation states, and the cache is
+            emptied when the first camera of each frame is rendered. This pays
+            off for crowds whose members play the same animations in step; use
+            SkeletonAnimationCache::setTimeQuantum on getSkeletonAnimationCache
+            to let nearby time positions match too. Entities whose bones are
+            used beyond skinning (objects attached to bones, bounding box from
+            the skeleton, displayed skeleton, manual bones) or whose animation
+            LOD masks bones always evaluate their own skeleton. The default is
+            false.
+        */
+        void setSkeletonAnimationCacheEnabled(bool enabled);
+
+        /** Gets whether entities posed identically share their bone matrices within a frame. */
+        bool getSkeletonAnimationCacheEnabled(void) const { return mSkeletonAnimationCache != 0; }
+
+        /** Gets the cache of bone matrices, null unless enabled with setSkeletonAnimationCacheEnabled. */
+        SkeletonAnimationCache* getSkeletonAnimationCache(void) const { return mSkeletonAnimationCache; }
+
+        /** Sets whether render queue entries are reused from one frame to
+            the next.
+        @remarks
+            When enabled, each search for the visible objects of a camera is
+            an entry cache pass of the render queue (see 
+            RenderQueue::_beginEntryCachePass): objects which stay visible
+            and whose MovableObject::_getRenderQueueSignature is unchanged
+            have the renderables they queued for that camera the last time
+            added again directly, instead of being asked to update the queue.
+            This only saves the MovableObject::_updateRenderQueue calls; the
+            queue is still cleared, filled and sorted every frame. The
+            default is false.
+        */
+        void setRenderQueueEntryCacheEnabled(bool enabled) { mRenderQueueEntryCacheEnabled = enabled; }
+
+        /** Gets whether render queue entries are reused from one frame to the next. */
+        bool getRenderQueueEntryCacheEnabled(void) const { return mRenderQueueEntryCacheEnabled; }
+
+        /** Gets the number of renderables reused and re-inserted, and of
+            objects which entered and left the visible set, summed over the
+            cameras rendered during the current frame so far.
+        @remarks
+            The counts are reset when the first camera of a frame is rendered
+            and are all 0 unless setRenderQueueEntryCacheEnabled is enabled.
+        */
+        const RenderQueue::EntryCacheStats& getRenderQueueEntryCacheStats(void) const
+        { return mRenderQueueEntryCacheStats; }
+
+        /// @copydoc WorkQueue::RequestHandler::canHandleRequest
+        bool canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
+        /// @copydoc WorkQueue::RequestHandler::handleRequest
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
+
         /** Set whether to automatically normalise normals on objects whenever they
             are scaled.
         @remarks
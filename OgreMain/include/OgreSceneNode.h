@@ -76,8 +76,8 @@ namespace Ogre {
         /// World-Axis aligned bounding box, updated only through _update
         AxisAlignedBox mWorldAABB;
 
-        /** @copydoc Node::updateFromParentImpl. */
-        void updateFromParentImpl(void) const;
+        /** @copydoc Node::derivedTransformUpdated. */
+        void derivedTransformUpdated(void) const;
 
         /** See Node. */
         Node* createChildImpl(void);
@@ -204,6 +204,9 @@ namespace Ogre {
             @param
                 displayNodes If true, the nodes themselves are rendered as a set of 3 axes as well
                     as the objects being rendered. For debugging purposes.
+            @note
+                Children are culled in batches (see Camera::areVisible) before the
+                call is cascaded to the visible ones.
         */
         virtual void _findVisibleObjects(Camera* cam, RenderQueue* queue, 
             VisibleObjectsBoundsInfo* visibleBounds, 
@@ -357,6 +357,13 @@ namespace Ogre {
         MovableObject* movable;
         /// The world fragment, or NULL if this is not a fragment result
         SceneQuery::WorldFragment* worldFragment;
+        /// Submesh of the triangle hit, or -1 if this is not a triangle result
+        int subMeshIndex;
+        /// Triangle hit within the submesh, see MeshTriangleBvh::Hit
+        size_t triangleIndex;
+        /// Barycentric coordinates of the hit point in the triangle, see MeshTriangleBvh::Hit
+        Real u;
+        Real v;
         /// Comparison operator for sorting
         bool operator < (const RaySceneQueryResultEntry& rhs) const
         {
@@ -366,6 +373,17 @@ namespace Ogre {
     };
     typedef vector<RaySceneQueryResultEntry>::type RaySceneQueryResult;
 
+    /** A result of the batched scene queries.
+    @see SceneManager::executeRayQueries
+    */
+    struct _OgreExport SceneQueryBatchHit
+    {
+        /// The object whose world bounding box was hit
+        MovableObject* movable;
+        /// Distance along the ray to the box, 0 for the volume queries
+        Real distance;
+    };
+
     /** Specialises the SceneQuery class for querying along a ray. */
     class _OgreExport RaySceneQuery : public SceneQuery, public RaySceneQueryListener
     {
@@ -373,6 +391,7 @@ namespace Ogre {
         Ray mRay;
         bool mSortByDistance;
         ushort mMaxResults;
+        bool mQueryTriangles;
         RaySceneQueryResult mResult;
 
     public:
@@ -406,6 +425,22 @@ namespace Ogre {
         /** Gets the maximum number of results returned from the query (only relevant if 
         results are being sorted) */
         virtual ushort getMaxResults(void) const;
+        /** Sets whether entities are tested against the triangles of their mesh
+            rather than their bounding box.
+        @remarks
+            Entities whose bounding box the ray hits are tested against the tree
+            of triangles of their mesh, see Entity::intersects. Those missed are
+            dropped, and the others are reported with the distance of the nearest
+            triangle hit, its submesh, index and barycentric coordinates. Other
+            movable objects are still reported with their bounding box; use the
+            query type mask to leave them out.
+        @par
+            This only applies to the results of execute(void); a listener
+            passed to execute receives bounding box results.
+        */
+        virtual void setQueryTriangles(bool enabled);
+        /** Gets whether entities are tested against the triangles of their mesh. */
+        virtual bool getQueryTriangles(void) const;
         /** Executes the query, returning the results back in one list.
         @remarks
             This method executes the scene query as configured, gathers the results
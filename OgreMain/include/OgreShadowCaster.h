@@ -163,6 +163,91 @@ namespace Ogre {
             HardwareIndexBufferSharedPtr* indexBuffer, size_t* indexBufferUsedSize,
             bool extrudeVertices, Real extrusionDistance, unsigned long flags = 0 ) = 0;
 
+        /** The shadow volume of a caster for a light, set up by _prepareShadowVolume
+            so that its indexes can be generated apart from the rendering thread.
+        @remarks
+            Objects of this type are intended to be reused from one frame to the
+            next, so that their working arrays keep their capacity.
+        */
+        struct ShadowVolumeBuild
+        {
+            /// Edge list of the caster
+            EdgeData* edgeData;
+            /// Shadow renderables of the caster, 1:1 with the edge groups
+            ShadowRenderableList* shadowRenderables;
+            /// Light position in object space, w is 0 for a directional light
+            Vector4 lightPos;
+            /// Whether the light is directional
+            bool directionalLight;
+            /// Whether the dark cap is a triangle fan covering the silhouette
+            bool useMcGuire;
+            /// Technique-specific flags, see ShadowRenderableFlags
+            unsigned long flags;
+            /// Light facing state of the triangles of the edge list
+            vector<char>::type lightFacings;
+            /// Silhouette edges of each edge group, in edge group order
+            vector<size_t>::type silhouetteEdges;
+            /// Start of each edge group in silhouetteEdges, plus the end of the last one
+            vector<size_t>::type silhouetteEdgeStarts;
+            /// Number of light facing triangles of each edge group
+            vector<size_t>::type lightFacingCounts;
+            /// Number of indexes of the shadow volume, set by _findShadowVolumeSilhouette
+            size_t indexCount;
+            /// Position of the first index in the index buffer, set by the caller
+            size_t indexStart;
+
+            ShadowVolumeBuild() : edgeData(0), shadowRenderables(0), directionalLight(false),
+                useMcGuire(false), flags(0), indexCount(0), indexStart(0) {}
+        };
+
+        /** Prepares the shadow volume of this caster so that its indexes can be
+            generated apart from the rendering thread.
+        @remarks
+            This does everything getShadowVolumeRenderableIterator does before
+            looking for the silhouette, i.e. creating the shadow renderables and
+            extruding vertices in software, and must be called from the
+            rendering thread. The shadow volume is then completed by
+            _findShadowVolumeSilhouette and _writeShadowVolumeIndexes, which
+            only read the edge list and can be run concurrently for any number
+            of casters, including casters sharing the same edge list.
+        @par
+            Casters which cannot be completed that way, e.g. because they update
+            their edge list for animation, return false and must be dealt with
+            by getShadowVolumeRenderableIterator. This is the default.
+        @param build
+            Receives the state of the shadow volume.
+        @return
+            Whether the shadow volume has been prepared.
+        */
+        virtual bool _prepareShadowVolume(
+            ShadowTechnique shadowTechnique, const Light* light,
+            HardwareIndexBufferSharedPtr* indexBuffer,
+            bool extrudeVertices, Real extrusionDistance, unsigned long flags,
+            ShadowVolumeBuild& build);
+
+        /** Finds which triangles of a prepared shadow volume face the light,
+            its silhouette edges and the number of indexes needed to render it,
+            stored in build.indexCount.
+        @remarks
+            Thread safe, as long as the edge list isn't updated concurrently.
+        */
+        static void _findShadowVolumeSilhouette(ShadowVolumeBuild& build);
+
+        /** Writes the indexes of a shadow volume once its silhouette has been
+            found, and updates the index ranges of its shadow renderables.
+        @remarks
+            Thread safe, as long as the edge list isn't updated concurrently. The
+            shadow renderables must already be bound to the index buffer written to.
+        @param build
+            The shadow volume, whose indexStart is the position of the first
+            index in the index buffer.
+        @param pIndexes
+            Where to write the build.indexCount indexes, i.e. the locked index
+            buffer at build.indexStart.
+        */
+        static void _writeShadowVolumeIndexes(const ShadowVolumeBuild& build,
+            unsigned short* pIndexes);
+
         /** Common implementation of releasing shadow renderables.*/
         static void clearShadowRenderableList(ShadowRenderableList& shadowRenderables);
 
@@ -243,6 +328,22 @@ namespace Ogre {
         */
         virtual void extrudeBounds(AxisAlignedBox& box, const Vector4& lightPos, 
             Real extrudeDist) const;
+        /** Sets up the state of a shadow volume shared by generateShadowVolume
+            and _prepareShadowVolume, i.e. all but the light position.
+        @param build
+            The shadow volume to set up.
+        @param edgeData
+            The edge information to use.
+        @param light
+            The light casting the shadow.
+        @param shadowRenderables
+            The shadow renderables of this caster, 1:1 with the edge groups.
+        @param flags
+            Additional controller flags, see ShadowRenderableFlags.
+        */
+        void initShadowVolumeBuild(ShadowVolumeBuild& build, EdgeData* edgeData,
+            const Light* light, ShadowRenderableList& shadowRenderables,
+            unsigned long flags) const;
 
 
     };
@@ -253,6 +253,19 @@ namespace Ogre {
         */
         virtual void setAnimationState(const AnimationStateSet& animSet);
 
+        /** Changes the state of the skeleton, animating only a subset of the bones.
+        @remarks
+            As setAnimationState, with every animation weighted per bone by boneMask
+            on top of any blend mask of its own. Bones with a weight of 0 are left in
+            their binding pose, which is how the skeleton animation LOD of Entity
+            drops bones at a distance.
+        @param boneMask
+            Weight per bone handle, bones beyond its size keep a weight of 1. 
+            May be null to animate every bone.
+        */
+        virtual void setAnimationState(const AnimationStateSet& animSet,
+            const AnimationState::BoneBlendMask* boneMask);
+
 
         /** Initialise an animation set suitable for use with this skeleton. 
         @remarks
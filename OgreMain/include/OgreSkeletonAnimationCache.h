@@ -0,0 +1,188 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __SkeletonAnimationCache_H__
+#define __SkeletonAnimationCache_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAnimationState.h"
+#include "OgreSkeleton.h"
+#include "Threading/OgreThreadHeaders.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+
+    /** \addtogroup Animation
+    *  @{
+    */
+
+    /** Shares the bone matrices of identically posed skeletons within a frame.
+    @remarks
+        In crowds, many entities of the same mesh play the same animations,
+        often in step. This cache remembers the bone matrices computed for
+        each combination of master skeleton, blend mode, and enabled
+        animation states (name, time position and weight) seen during a frame,
+        so that the next skeleton instance posed the same way copies them
+        instead of applying the animations again.
+    @par
+        Time positions are compared once rounded down to a multiple of the
+        time quantum. With a quantum greater than 0, instances within the
+        same step of time share the pose at the start of the step, which
+        trades accuracy (up to one quantum) for hits. Weights are
+        compared exactly. States with blend masks are never cached.
+    @par
+        On a hit the bones of the skeleton instance are left as they were,
+        only the matrices are filled in, so callers must not use the cache
+        for instances whose bones are read back (e.g. through tag points).
+        The cache may be used from several threads at once; it is meant to
+        be cleared every frame, see SceneManager::setSkeletonAnimationCacheEnabled.
+    */
+    class _OgreExport SkeletonAnimationCache : public AnimationAlloc
+    {
+    public:
+        /// Lookup counts since the last clear
+        struct Stats
+        {
+            /// Skeletons which went through the cache
+            size_t lookups;
+            /// Lookups which found their bone matrices in the cache
+            size_t hits;
+            /// Distinct poses stored
+            size_t entries;
+        };
+
+        SkeletonAnimationCache();
+        ~SkeletonAnimationCache();
+
+        /** Sets the step time positions are rounded down to before being compared.
+        @remarks
+            The default is 0, where only identical time positions match.
+        */
+        void setTimeQuantum(Real quantum);
+
+        /** Gets the step time positions are rounded down to before being compared. */
+        Real getTimeQuantum(void) const { return mTimeQuantum; }
+
+        /** Poses the skeleton instance with the animation states and
+            retrieves its bone matrices, from the cache when possible.
+        @param skeleton
+            The skeleton instance to pose, evaluated on a miss.
+        @param animSet
+            The animation states applied to it, as for Skeleton::setAnimationState.
+        @param pMatrices
+            Array of at least skeleton->getNumBones() matrices to fill in.
+        @return
+            True if the matrices were found in the cache, in which case the
+            bones of the skeleton instance have not been touched.
+        */
+        bool getBoneMatrices(SkeletonInstance* skeleton, const AnimationStateSet& animSet,
+            Matrix4* pMatrices);
+
+        /** Forgets every stored pose and resets the stats. */
+        void clear(void);
+
+        /** Gets the lookup counts since the last clear. */
+        Stats getStats(void) const;
+
+    protected:
+        /// Most enabled animation states a cached pose can have
+        static const size_t MAX_STATES = 8;
+
+        /// Enabled animation state looked up
+        struct StateKey
+        {
+            const String* animationName;
+            /// Time position rounded down to the quantum
+            Real time;
+            Real weight;
+        };
+
+        /// Enabled animation state of a stored pose
+        struct StoredState
+        {
+            String animationName;
+            Real time;
+            Real weight;
+        };
+        typedef vector<StoredState>::type StoredStateList;
+
+        /// A stored pose
+        struct Entry
+        {
+            /// Handle of the master skeleton
+            ResourceHandle skeleton;
+            SkeletonAnimationBlendMode blendMode;
+            /// Range of mStates
+            size_t firstState;
+            size_t numStates;
+            /// Range of mMatrices
+            size_t firstMatrix;
+            size_t numBones;
+            /// Next entry with the same hash, or NO_ENTRY
+            size_t next;
+        };
+        typedef vector<Entry>::type EntryList;
+        typedef map<uint32, size_t>::type EntryIndex;
+        static const size_t NO_ENTRY = ~(size_t)0;
+
+        /** Builds the key of the enabled animation states.
+        @return
+            The number of states in the key, or NO_ENTRY if they cannot be cached.
+        */
+        size_t buildKey(const AnimationStateSet& animSet, StateKey* key, uint32& hash) const;
+        /// Finds the entry matching a key, or NO_ENTRY
+        size_t findEntry(const SkeletonInstance* skeleton, const StateKey* key, size_t numStates,
+            uint32 hash) const;
+        /** Poses the skeleton instance at the times of the key and retrieves
+            its bone matrices, so that stored poses are those of their key.
+        */
+        void evaluate(SkeletonInstance* skeleton, const AnimationStateSet& animSet,
+            const StateKey* key, Matrix4* pMatrices) const;
+
+        Real mTimeQuantum;
+        EntryList mEntries;
+        /// Last entry stored per hash, the others follow Entry::next
+        EntryIndex mEntryIndex;
+        StoredStateList mStates;
+        vector<Matrix4>::type mMatrices;
+        size_t mLookups;
+        size_t mHits;
+
+        OGRE_MUTEX(mMutex);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
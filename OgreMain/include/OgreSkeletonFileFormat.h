@@ -101,6 +101,29 @@ namespace Ogre {
                     // Quaternion rotate            : Rotation to apply at this keyframe
                     // Vector3 translate            : Translation to apply at this keyframe
                     // Vector3 scale                : Scale to apply at this keyframe
+
+            SKELETON_ANIMATION_COMPRESSED_TRACKS = 0x4200,
+            // [Optional] all node tracks of the animation, packed (see CompressedNodeTracks)
+            // Only in v1.100+, mutually exclusive with SKELETON_ANIMATION_TRACK
+
+                // uint32 numTracks
+                // uint32 numKeys
+                // uint32 numTranslations
+                // uint32 numScales
+                // Repeating section (numTracks)
+                    // unsigned short boneIndex     : Index of bone to apply to
+                    // uint32 firstKey              : Index of the first key of the track
+                    // uint32 numKeys               : Number of keys of the track
+                    // uint32 firstTranslation      : Index of the first translation, 0xFFFFFFFF if constant
+                    // uint32 firstScale            : Index of the first scale, 0xFFFFFFFF if constant
+                    // Vector3 translationMin       : Quantisation origin, or the translation if constant
+                    // Vector3 translationExtent    : Quantisation range
+                    // Vector3 scaleMin             : Quantisation origin, or the scale if constant
+                    // Vector3 scaleExtent          : Quantisation range
+                // float keyTimes[numKeys]
+                // uint16 rotations[numKeys * 3]            : Smallest three quaternion components
+                // uint16 translations[numTranslations * 3] : Quantised to the track range
+                // uint16 scales[numScales * 3]             : Quantised to the track range
         SKELETON_ANIMATION_LINK         = 0x5000
         // Link to another skeleton, to re-use its animations
 
@@ -43,6 +43,8 @@ namespace Ogre {
         SKELETON_VERSION_1_0,
         /// OGRE version v1.8+
         SKELETON_VERSION_1_8,
+        /// Serializer v1.100, adds compressed animation tracks
+        SKELETON_VERSION_1_100,
         
         /// Latest version available
         SKELETON_VERSION_LATEST = 100
@@ -109,6 +111,8 @@ namespace Ogre {
     protected:
         
         void setWorkingVersion(SkeletonVersion ver);
+        /// Whether any animation of the skeleton uses compressed node tracks
+        static bool hasCompressedNodeTracks(const Skeleton* pSkel);
         
         // Internal export methods
         void writeSkeleton(const Skeleton* pSkel, SkeletonVersion ver);
@@ -116,6 +120,7 @@ namespace Ogre {
         void writeBoneParent(const Skeleton* pSkel, unsigned short boneId, unsigned short parentId);
         void writeAnimation(const Skeleton* pSkel, const Animation* anim, SkeletonVersion ver);
         void writeAnimationTrack(const Skeleton* pSkel, const NodeAnimationTrack* track);
+        void writeCompressedNodeTracks(const CompressedNodeTracks* tracks);
         void writeKeyFrame(const Skeleton* pSkel, const TransformKeyFrame* key);
         void writeSkeletonAnimationLink(const Skeleton* pSkel, 
             const LinkedSkeletonAnimationSource& link);
@@ -126,6 +131,7 @@ namespace Ogre {
         void readBoneParent(DataStreamPtr& stream, Skeleton* pSkel);
         void readAnimation(DataStreamPtr& stream, Skeleton* pSkel);
         void readAnimationTrack(DataStreamPtr& stream, Animation* anim, Skeleton* pSkel);
+        void readCompressedNodeTracks(DataStreamPtr& stream, Animation* anim);
         void readKeyFrame(DataStreamPtr& stream, NodeAnimationTrack* track, Skeleton* pSkel);
         void readSkeletonAnimationLink(DataStreamPtr& stream, Skeleton* pSkel);
 
@@ -134,6 +140,7 @@ namespace Ogre {
         size_t calcBoneParentSize(const Skeleton* pSkel);
         size_t calcAnimationSize(const Skeleton* pSkel, const Animation* pAnim, SkeletonVersion ver);
         size_t calcAnimationTrackSize(const Skeleton* pSkel, const NodeAnimationTrack* pTrack);
+        size_t calcCompressedNodeTracksSize(const CompressedNodeTracks* pTracks);
         size_t calcKeyFrameSize(const Skeleton* pSkel, const TransformKeyFrame* pKey);
         size_t calcKeyFrameSizeWithoutScale(const Skeleton* pSkel, const TransformKeyFrame* pKey);
         size_t calcSkeletonAnimationLinkSize(const Skeleton* pSkel, 
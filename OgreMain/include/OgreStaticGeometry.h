@@ -431,6 +431,13 @@ namespace Ogre {
             /// Cached squared view depth value to avoid recalculation by GeometryBucket
             Real mSquaredViewDepth;
 
+            /** Brings the shadow renderables of the current LOD up to date for a
+                light, ahead of finding the silhouette; returns its edge list.
+            */
+            EdgeData* prepareShadowRenderables(ShadowTechnique shadowTechnique,
+                const Light* light, HardwareIndexBufferSharedPtr* indexBuffer,
+                bool extrude, Real extrusionDistance, unsigned long flags, Vector4& lightPos);
+
         public:
             Region(StaticGeometry* parent, const String& name, SceneManager* mgr, 
                 uint32 regionID, const Vector3& centre);
@@ -464,6 +471,12 @@ namespace Ogre {
                 ShadowTechnique shadowTechnique, const Light* light, 
                 HardwareIndexBufferSharedPtr* indexBuffer, size_t* indexBufferUsedSize,
                 bool extrudeVertices, Real extrusionDistance, unsigned long flags = 0 );
+            /// @copydoc ShadowCaster::_prepareShadowVolume
+            bool _prepareShadowVolume(
+                ShadowTechnique shadowTechnique, const Light* light,
+                HardwareIndexBufferSharedPtr* indexBuffer,
+                bool extrudeVertices, Real extrusionDistance, unsigned long flags,
+                ShadowVolumeBuild& build);
             /// Overridden from MovableObject
             EdgeData* getEdgeList(void);
             /** Overridden member from ShadowCaster. */
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgrePass.h"
 #include "OgreRenderSystemCapabilities.h"
 #include "OgreUserObjectBindings.h"
+#include "OgreAtomicScalar.h"
 
 namespace Ogre {
     /** \addtogroup Core
@@ -66,7 +67,10 @@ namespace Ogre {
         // Raw pointer since we don't want child to stop parent's destruction
         Material* mParent;
         bool mIsSupported;
-        IlluminationPassesState mIlluminationPassesCompilationPhase;
+        /// Read without locking, so that compiled passes can be used from several threads at once
+        AtomicScalar<IlluminationPassesState> mIlluminationPassesCompilationPhase;
+        /// Held while compiling illumination passes, in case several threads request them first
+        OGRE_MUTEX(mIlluminationPassesMutex);
         /// LOD level
         unsigned short mLodIndex;
         /** Scheme index, derived from scheme name but the names are held on
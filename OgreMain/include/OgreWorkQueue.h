@@ -370,6 +370,10 @@ namespace Ogre
         virtual ~DefaultWorkQueueBase();
         /// Get the name of the work queue
         const String& getName() const;
+        /** Get whether the worker threads have been started by startup(), and
+            not stopped by shutdown() since.
+        */
+        bool isRunning() const { return mIsRunning; }
         /** Get the number of worker threads that this queue will start when 
             startup() is called. 
         */
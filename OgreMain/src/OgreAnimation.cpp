@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgreAnimation.h"
+#include "OgreCompressedNodeTracks.h"
 #include "OgreKeyFrame.h"
 #include "OgreException.h"
 #include "OgreEntity.h"
@@ -52,12 +53,14 @@ namespace Ogre {
         , mBaseKeyFrameTime(0.0f)
         , mBaseKeyFrameAnimationName(BLANKSTRING)
         , mContainer(0)
+        , mCompressedNodeTracks(0)
     {
     }
     //---------------------------------------------------------------------
     Animation::~Animation()
     {
         destroyAllTracks();
+        OGRE_DELETE mCompressedNodeTracks;
     }
     //---------------------------------------------------------------------
     Real Animation::getLength(void) const
@@ -348,10 +351,15 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void Animation::apply(Skeleton* skel, Real timePos, Real weight, 
-        Real scale)
+        Real scale, AnimationState::KeyCursor* cursor)
     {
         _applyBaseKeyFrame();
 
+        if (mCompressedNodeTracks)
+        {
+            mCompressedNodeTracks->apply(skel, timePos, weight, 0, scale, cursor);
+        }
+
         // Calculate time index for fast keyframe search
         TimeIndex timeIndex = _getTimeIndex(timePos);
 
@@ -367,10 +375,16 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void Animation::apply(Skeleton* skel, Real timePos, float weight,
-      const AnimationState::BoneBlendMask* blendMask, Real scale)
+      const AnimationState::BoneBlendMask* blendMask, Real scale,
+      AnimationState::KeyCursor* cursor)
     {
         _applyBaseKeyFrame();
 
+        if (mCompressedNodeTracks)
+        {
+            mCompressedNodeTracks->apply(skel, timePos, weight, blendMask, scale, cursor);
+        }
+
         // Calculate time index for fast keyframe search
       TimeIndex timeIndex = _getTimeIndex(timePos);
 
@@ -629,6 +643,11 @@ namespace Ogre {
             i->second->_clone(newAnim);
         }
 
+        if (mCompressedNodeTracks)
+        {
+            newAnim->mCompressedNodeTracks = mCompressedNodeTracks->_clone(newAnim);
+        }
+
         newAnim->_keyFrameListChanged();
         return newAnim;
 
@@ -658,6 +677,57 @@ namespace Ogre {
         return TimeIndex(timePos, static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it)));
     }
     //-----------------------------------------------------------------------
+    void Animation::compressNodeTracks(Real positionTolerance,
+        const Radian& rotationTolerance, Real scaleTolerance)
+    {
+        // Base keyframes are relative to the uncompressed data
+        _applyBaseKeyFrame();
+
+        // Fold any previously compressed tracks back in
+        decompressNodeTracks();
+        if (mNodeTrackList.empty())
+            return;
+
+        CompressedNodeTracks* compressed = OGRE_NEW CompressedNodeTracks(this);
+        compressed->build(CompressedNodeTracks::Tolerance(
+            positionTolerance, rotationTolerance, scaleTolerance));
+
+        destroyAllNodeTracks();
+        _setCompressedNodeTracks(compressed);
+    }
+    //-----------------------------------------------------------------------
+    void Animation::decompressNodeTracks(const Skeleton* skeleton)
+    {
+        if (mCompressedNodeTracks)
+        {
+            mCompressedNodeTracks->decompress(skeleton);
+            _setCompressedNodeTracks(0);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Animation::_setCompressedNodeTracks(CompressedNodeTracks* tracks)
+    {
+        if (tracks != mCompressedNodeTracks)
+        {
+            OGRE_DELETE mCompressedNodeTracks;
+            mCompressedNodeTracks = tracks;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Animation::_prepareConcurrentApply(void) const
+    {
+        if (mKeyFrameTimesDirty)
+        {
+            buildKeyFrameTimeList();
+        }
+
+        NodeTrackList::const_iterator i, iend = mNodeTrackList.end();
+        for (i = mNodeTrackList.begin(); i != iend; ++i)
+        {
+            i->second->_prepareConcurrentApply();
+        }
+    }
+    //-----------------------------------------------------------------------
     void Animation::buildKeyFrameTimeList(void) const
     {
         NodeTrackList::const_iterator i;
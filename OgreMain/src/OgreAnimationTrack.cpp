@@ -693,6 +693,14 @@ namespace Ogre {
             
     }
     //--------------------------------------------------------------------------
+    void NodeAnimationTrack::_prepareConcurrentApply(void) const
+    {
+        if (mSplineBuildNeeded && mParent->getInterpolationMode() == Animation::IM_SPLINE)
+        {
+            buildInterpolationSplines();
+        }
+    }
+    //--------------------------------------------------------------------------
     VertexAnimationTrack::VertexAnimationTrack(Animation* parent,
         unsigned short handle, VertexAnimationType animType)
         : AnimationTrack(parent, handle)
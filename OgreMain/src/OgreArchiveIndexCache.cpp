@@ -0,0 +1,309 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreArchiveIndexCache.h"
+#include "OgreLogManager.h"
+#include "OgreException.h"
+
+#include <sys/stat.h>
+#include <ctime>
+
+namespace Ogre {
+
+    /// Identifies cache streams, followed by the version of their format
+    static const char INDEX_CACHE_MAGIC[8] = { 'O', 'G', 'R', 'E', 'I', 'N', 'D', 'X' };
+    static const uint32 INDEX_CACHE_VERSION = 2;
+    /// Longest string read back, anything longer means the stream is broken
+    static const uint32 MAX_STRING_LENGTH = 65536;
+
+    //-----------------------------------------------------------------------
+    template <typename T> static void writeValue(const DataStreamPtr& stream, T value)
+    {
+        stream->write(&value, sizeof(T));
+    }
+    //-----------------------------------------------------------------------
+    template <typename T> static bool readValue(const DataStreamPtr& stream, T& value)
+    {
+        return stream->read(&value, sizeof(T)) == sizeof(T);
+    }
+    //-----------------------------------------------------------------------
+    static void writeString(const DataStreamPtr& stream, const String& str)
+    {
+        writeValue(stream, static_cast<uint32>(str.size()));
+        if (!str.empty())
+            stream->write(str.data(), str.size());
+    }
+    //-----------------------------------------------------------------------
+    static bool readString(const DataStreamPtr& stream, String& str)
+    {
+        uint32 length;
+        if (!readValue(stream, length) || length > MAX_STRING_LENGTH)
+            return false;
+        str.resize(length);
+        return !length || stream->read(&str[0], length) == length;
+    }
+    //-----------------------------------------------------------------------
+    static String entryKey(Archive* arch, bool recursive)
+    {
+        return arch->getType() + (recursive ? "\n1\n" : "\n0\n") + arch->getName();
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    ArchiveIndexCache::ArchiveIndexCache()
+        : mDirty(false)
+    {
+    }
+    //-----------------------------------------------------------------------
+    ArchiveIndexCache::~ArchiveIndexCache()
+    {
+    }
+    //-----------------------------------------------------------------------
+    bool ArchiveIndexCache::readStamps(Archive* arch, const StringVector& folders, StampList& stamps) const
+    {
+        struct stat tagStat;
+        const String& name = arch->getName();
+        stamps.clear();
+
+        if (arch->getType() == "FileSystem")
+        {
+            for (StringVector::const_iterator i = folders.begin(); i != folders.end(); ++i)
+            {
+                String path = i->empty() ? name : name + "/" + *i;
+                if (stat(path.c_str(), &tagStat) != 0 || (tagStat.st_mode & S_IFMT) != S_IFDIR)
+                    return false;
+
+                Stamp stamp = { *i, static_cast<int64>(tagStat.st_mtime), 0 };
+                stamps.push_back(stamp);
+            }
+            return true;
+        }
+
+        // archives in a single file
+        if (stat(name.c_str(), &tagStat) != 0 || (tagStat.st_mode & S_IFMT) != S_IFREG)
+            return false;
+
+        Stamp stamp = { BLANKSTRING, static_cast<int64>(tagStat.st_mtime),
+            static_cast<uint64>(tagStat.st_size) };
+        stamps.push_back(stamp);
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    const ArchiveIndexCache::Entry* ArchiveIndexCache::getEntry(Archive* arch, bool recursive, Entry& uncached)
+    {
+        // internal, assumes mutex lock has already been obtained
+        String key = entryKey(arch, recursive);
+        StringVector folders;
+        StampList stamps;
+
+        EntryMap::iterator i = mEntries.find(key);
+        if (i != mEntries.end())
+        {
+            const StampList& cached = i->second.stamps;
+            for (StampList::const_iterator s = cached.begin(); s != cached.end(); ++s)
+                folders.push_back(s->path);
+
+            bool valid = readStamps(arch, folders, stamps) && stamps.size() == cached.size();
+            for (size_t s = 0; valid && s < stamps.size(); ++s)
+            {
+                valid = stamps[s].modified == cached[s].modified && stamps[s].size == cached[s].size;
+            }
+            if (valid)
+                return &i->second;
+
+            mEntries.erase(i);
+            mDirty = true;
+        }
+
+        // Anything changed from now on will have a later modification time
+        int64 listed = static_cast<int64>(time(0));
+
+        folders.clear();
+        if (arch->getType() == "FileSystem")
+        {
+            folders.push_back(BLANKSTRING);
+            if (recursive)
+            {
+                FileInfoListPtr dirs = arch->listFileInfo(true, true);
+                for (FileInfoList::iterator d = dirs->begin(); d != dirs->end(); ++d)
+                    folders.push_back(d->filename);
+            }
+        }
+        if (!readStamps(arch, folders, stamps))
+            return 0;
+        bool keep = true;
+        for (StampList::iterator s = stamps.begin(); s != stamps.end(); ++s)
+        {
+            if (s->modified >= listed)
+                keep = false;
+        }
+
+        Entry& entry = keep ? mEntries[key] : uncached;
+        entry.stamps.swap(stamps);
+        entry.files = *arch->findFileInfo("*", recursive, false);
+        for (FileInfoList::iterator f = entry.files.begin(); f != entry.files.end(); ++f)
+            f->archive = 0;
+        if (keep)
+            mDirty = true;
+        return &entry;
+    }
+    //-----------------------------------------------------------------------
+    FileInfoListPtr ArchiveIndexCache::findFileInfo(Archive* arch, const String& pattern, bool recursive)
+    {
+        // A zip, for one, finds every file with a wildcard, however recursive
+        if (pattern.find('*') != String::npos && pattern.find_first_of("/\\?[") == String::npos)
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+            Entry uncached;
+            const Entry* entry = getEntry(arch, recursive, uncached);
+            if (entry)
+            {
+                // MEMCATEGORY_GENERAL is the only category supported for SharedPtr
+                FileInfoListPtr ret(OGRE_NEW_T(FileInfoList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+                bool caseSensitive = arch->isCaseSensitive();
+                for (FileInfoList::const_iterator f = entry->files.begin(); f != entry->files.end(); ++f)
+                {
+                    if (StringUtil::match(f->basename, pattern, caseSensitive))
+                    {
+                        ret->push_back(*f);
+                        ret->back().archive = arch;
+                    }
+                }
+                return ret;
+            }
+        }
+
+        return arch->findFileInfo(pattern, recursive, false);
+    }
+    //-----------------------------------------------------------------------
+    void ArchiveIndexCache::save(const DataStreamPtr& stream) const
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+
+        if (!stream->isWriteable())
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Unable to write to stream " + stream->getName(),
+                "ArchiveIndexCache::save");
+        }
+
+        stream->write(INDEX_CACHE_MAGIC, sizeof(INDEX_CACHE_MAGIC));
+        writeValue(stream, INDEX_CACHE_VERSION);
+        writeValue(stream, static_cast<uint32>(mEntries.size()));
+        for (EntryMap::const_iterator i = mEntries.begin(); i != mEntries.end(); ++i)
+        {
+            writeString(stream, i->first);
+
+            const StampList& stamps = i->second.stamps;
+            writeValue(stream, static_cast<uint32>(stamps.size()));
+            for (StampList::const_iterator s = stamps.begin(); s != stamps.end(); ++s)
+            {
+                writeString(stream, s->path);
+                writeValue(stream, s->modified);
+                writeValue(stream, s->size);
+            }
+
+            const FileInfoList& files = i->second.files;
+            writeValue(stream, static_cast<uint32>(files.size()));
+            for (FileInfoList::const_iterator f = files.begin(); f != files.end(); ++f)
+            {
+                writeString(stream, f->filename);
+                writeString(stream, f->path);
+                writeString(stream, f->basename);
+                writeValue(stream, static_cast<uint64>(f->compressedSize));
+                writeValue(stream, static_cast<uint64>(f->uncompressedSize));
+            }
+        }
+
+        mDirty = false;
+    }
+    //-----------------------------------------------------------------------
+    void ArchiveIndexCache::load(const DataStreamPtr& stream)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+
+        mEntries.clear();
+        mDirty = false;
+
+        EntryMap entries;
+        char magic[sizeof(INDEX_CACHE_MAGIC)];
+        uint32 version, entryCount;
+        bool valid = stream->read(magic, sizeof(magic)) == sizeof(magic) &&
+            memcmp(magic, INDEX_CACHE_MAGIC, sizeof(magic)) == 0 &&
+            readValue(stream, version) && version == INDEX_CACHE_VERSION &&
+            readValue(stream, entryCount);
+
+        for (uint32 i = 0; valid && i < entryCount; ++i)
+        {
+            String key;
+            uint32 stampCount, fileCount;
+            valid = readString(stream, key) && readValue(stream, stampCount);
+            if (!valid)
+                break;
+            Entry& entry = entries[key];
+
+            for (uint32 s = 0; valid && s < stampCount; ++s)
+            {
+                Stamp stamp;
+                valid = readString(stream, stamp.path) && readValue(stream, stamp.modified) &&
+                    readValue(stream, stamp.size);
+                entry.stamps.push_back(stamp);
+            }
+
+            valid = valid && readValue(stream, fileCount);
+            for (uint32 f = 0; valid && f < fileCount; ++f)
+            {
+                FileInfo file;
+                uint64 compressedSize, uncompressedSize;
+                valid = readString(stream, file.filename) && readString(stream, file.path) &&
+                    readString(stream, file.basename) &&
+                    readValue(stream, compressedSize) && readValue(stream, uncompressedSize);
+                file.archive = 0;
+                file.compressedSize = static_cast<size_t>(compressedSize);
+                file.uncompressedSize = static_cast<size_t>(uncompressedSize);
+                entry.files.push_back(file);
+            }
+        }
+
+        if (!valid)
+        {
+            LogManager::getSingleton().logMessage(
+                "ArchiveIndexCache: ignoring invalid cache " + stream->getName());
+            return;
+        }
+        mEntries.swap(entries);
+    }
+    //-----------------------------------------------------------------------
+    void ArchiveIndexCache::clear(void)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        mEntries.clear();
+        mDirty = false;
+    }
+
+}
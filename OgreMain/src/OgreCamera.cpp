@@ -877,6 +877,18 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Camera::areVisible(const AxisAlignedBox* const* bounds, size_t count, bool* visible) const
+    {
+        if (mCullFrustum)
+        {
+            mCullFrustum->areVisible(bounds, count, visible);
+        }
+        else
+        {
+            cullBoxes(bounds, count, visible);
+        }
+    }
+    //-----------------------------------------------------------------------
     bool Camera::isVisible(const Sphere& bound, FrustumPlane* culledBy) const
     {
         if (mCullFrustum)
@@ -0,0 +1,584 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreCompressedNodeTracks.h"
+#include "OgreAnimation.h"
+#include "OgreKeyFrame.h"
+#include "OgreSkeleton.h"
+#include "OgreBone.h"
+#include "OgrePlatformInformation.h"
+#include "OgreOptimisedUtil.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        /// Number of tracks sampled together, a multiple of the SIMD width
+        const size_t SAMPLE_BLOCK_SIZE = 16;
+        /// Range of the three smallest components of a unit quaternion (1 / sqrt(2))
+        const float ROTATION_RANGE = 0.707106781f;
+        /// Rotation components are stored in 15 bits, the top bits hold the largest index
+        const float ROTATION_QUANTUM = 32767.0f;
+        const float VALUE_QUANTUM = 65535.0f;
+
+        /// Packs a rotation into 3 x 16 bits, dropping its largest component
+        void encodeRotation(const Quaternion& rotation, uint16* packed)
+        {
+            Quaternion q = rotation;
+            q.normalise();
+
+            size_t largest = 0;
+            for (size_t c = 1; c < 4; ++c)
+            {
+                if (Math::Abs(q[c]) > Math::Abs(q[largest]))
+                    largest = c;
+            }
+            // q and -q are the same rotation, keep the dropped component positive
+            Real sign = q[largest] < 0 ? -1.0f : 1.0f;
+
+            size_t i = 0;
+            for (size_t c = 0; c < 4; ++c)
+            {
+                if (c == largest)
+                    continue;
+                Real v = (q[c] * sign / ROTATION_RANGE) * 0.5f + 0.5f;
+                packed[i++] = static_cast<uint16>(
+                    Math::Clamp<Real>(v, 0, 1) * ROTATION_QUANTUM + 0.5f);
+            }
+            packed[0] |= static_cast<uint16>((largest >> 1) << 15);
+            packed[1] |= static_cast<uint16>((largest & 1) << 15);
+        }
+        /// Unpacks a rotation into w, x, y, z
+        void decodeRotation(const uint16* packed, float* q)
+        {
+            size_t largest = ((packed[0] >> 15) << 1) | (packed[1] >> 15);
+            float sumSq = 0;
+            size_t i = 0;
+            for (size_t c = 0; c < 4; ++c)
+            {
+                if (c == largest)
+                    continue;
+                float v = ((packed[i++] & 0x7FFF) / ROTATION_QUANTUM * 2.0f - 1.0f) * ROTATION_RANGE;
+                q[c] = v;
+                sumSq += v * v;
+            }
+            q[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSq));
+        }
+        /// Packs a value into 3 x 16 bits within the range [min, min + extent]
+        void encodeValue(const Vector3& v, const Vector3& min, const Vector3& extent, uint16* packed)
+        {
+            for (size_t c = 0; c < 3; ++c)
+            {
+                Real n = extent[c] > 0 ? (v[c] - min[c]) / extent[c] : 0;
+                packed[c] = static_cast<uint16>(Math::Clamp<Real>(n, 0, 1) * VALUE_QUANTUM + 0.5f);
+            }
+        }
+        void decodeValue(const uint16* packed, const Vector3& min, const Vector3& extent, float* v)
+        {
+            for (size_t c = 0; c < 3; ++c)
+            {
+                v[c] = static_cast<float>(min[c] + packed[c] * (extent[c] / VALUE_QUANTUM));
+            }
+        }
+        /** Works out the quantisation range of a channel.
+        @return true if every value is within tolerance of a single one,
+            which is then returned in min, with a zero extent.
+        */
+        bool computeRange(const vector<Vector3>::type& values, Real tolerance,
+            Vector3& min, Vector3& extent)
+        {
+            Vector3 max = values[0];
+            min = values[0];
+            for (size_t k = 1; k < values.size(); ++k)
+            {
+                min.makeFloor(values[k]);
+                max.makeCeil(values[k]);
+            }
+
+            Vector3 centre = (min + max) * 0.5f;
+            bool constant = true;
+            for (size_t k = 0; k < values.size() && constant; ++k)
+            {
+                constant = centre.distance(values[k]) <= tolerance;
+            }
+
+            if (constant)
+            {
+                min = centre;
+                extent = Vector3::ZERO;
+            }
+            else
+            {
+                extent = max - min;
+            }
+            return constant;
+        }
+
+        /// Original and quantised keys of a track, used to decide which keys to drop
+        struct KeyReducer
+        {
+            CompressedNodeTracks::Tolerance tolerance;
+            vector<Real>::type times;
+            vector<Quaternion>::type rotations, decodedRotations;
+            vector<Vector3>::type translations, decodedTranslations;
+            vector<Vector3>::type scales, decodedScales;
+
+            /** Whether interpolating the quantised keys 'from' and 'to'
+                reproduces every original key in between within tolerance. */
+            bool canSkipKeysBetween(size_t from, size_t to) const
+            {
+                Real span = times[to] - times[from];
+                if (span <= 0)
+                    return false;
+
+                for (size_t k = from + 1; k < to; ++k)
+                {
+                    Real t = (times[k] - times[from]) / span;
+
+                    Quaternion q = Quaternion::nlerp(t, decodedRotations[from], decodedRotations[to], true);
+                    Real cosHalfAngle = std::min(Math::Abs(q.Dot(rotations[k])), Real(1.0f));
+                    if (Math::ACos(cosHalfAngle) * 2.0f > tolerance.rotation)
+                        return false;
+
+                    Vector3 p = decodedTranslations[from] + (decodedTranslations[to] - decodedTranslations[from]) * t;
+                    if (p.distance(translations[k]) > tolerance.position)
+                        return false;
+
+                    Vector3 s = decodedScales[from] + (decodedScales[to] - decodedScales[from]) * t;
+                    if (s.distance(scales[k]) > tolerance.scale)
+                        return false;
+                }
+                return true;
+            }
+        };
+
+        /** Keys of the tracks of a block being sampled, in the block layout
+            of OptimisedUtil::interpolateNodeTransforms */
+        struct SampleBlock
+        {
+            OGRE_SIMD_ALIGNED_DECL(float, weights[SAMPLE_BLOCK_SIZE]);
+            OGRE_SIMD_ALIGNED_DECL(float, keys1[SAMPLE_BLOCK_SIZE * 10]);
+            OGRE_SIMD_ALIGNED_DECL(float, keys2[SAMPLE_BLOCK_SIZE * 10]);
+
+            /// Offset of component c of track i, see OptimisedUtil::concatenateNodeTransforms
+            static size_t offset(size_t i, size_t c) { return (i / 4) * 40 + c * 4 + (i & 3); }
+        };
+        /// First component of each channel in a SampleBlock
+        const size_t POSITION = 0, ORIENTATION = 3, SCALE = 7;
+    }
+    //---------------------------------------------------------------------
+    CompressedNodeTracks::CompressedNodeTracks(Animation* parent)
+        : mParent(parent)
+    {
+    }
+    //---------------------------------------------------------------------
+    CompressedNodeTracks::~CompressedNodeTracks()
+    {
+    }
+    //---------------------------------------------------------------------
+    void CompressedNodeTracks::build(const Tolerance& tolerance)
+    {
+        mTracks.clear();
+        mKeyTimes.clear();
+        mRotations.clear();
+        mTranslations.clear();
+        mScales.clear();
+
+        KeyReducer reducer;
+        reducer.tolerance = tolerance;
+        PackedValueList packedRotations, packedTranslations, packedScales;
+        vector<size_t>::type keptKeys;
+
+        const Animation::NodeTrackList& nodeTracks = mParent->_getNodeTrackList();
+        Animation::NodeTrackList::const_iterator i, iend = nodeTracks.end();
+        for (i = nodeTracks.begin(); i != iend; ++i)
+        {
+            const NodeAnimationTrack* track = i->second;
+            const size_t numKeys = track->getNumKeyFrames();
+            if (numKeys == 0)
+                continue;
+
+            reducer.times.resize(numKeys);
+            reducer.rotations.resize(numKeys);
+            reducer.translations.resize(numKeys);
+            reducer.scales.resize(numKeys);
+            for (size_t k = 0; k < numKeys; ++k)
+            {
+                const TransformKeyFrame* kf = track->getNodeKeyFrame(static_cast<unsigned short>(k));
+                reducer.times[k] = kf->getTime();
+                reducer.rotations[k] = kf->getRotation();
+                reducer.rotations[k].normalise();
+                reducer.translations[k] = kf->getTranslate();
+                reducer.scales[k] = kf->getScale();
+            }
+
+            TrackInfo info;
+            info.handle = i->first;
+            bool constantTranslation = computeRange(reducer.translations, tolerance.position,
+                info.translationMin, info.translationExtent);
+            bool constantScale = computeRange(reducer.scales, tolerance.scale,
+                info.scaleMin, info.scaleExtent);
+
+            // Quantise every key up front, so that dropping keys takes the
+            // quantisation error into account
+            packedRotations.resize(numKeys * 3);
+            packedTranslations.resize(numKeys * 3);
+            packedScales.resize(numKeys * 3);
+            reducer.decodedRotations.resize(numKeys);
+            reducer.decodedTranslations.resize(numKeys);
+            reducer.decodedScales.resize(numKeys);
+            for (size_t k = 0; k < numKeys; ++k)
+            {
+                float v[4];
+                encodeRotation(reducer.rotations[k], &packedRotations[k * 3]);
+                decodeRotation(&packedRotations[k * 3], v);
+                reducer.decodedRotations[k] = Quaternion(v[0], v[1], v[2], v[3]);
+
+                encodeValue(reducer.translations[k], info.translationMin, info.translationExtent,
+                    &packedTranslations[k * 3]);
+                decodeValue(&packedTranslations[k * 3], info.translationMin, info.translationExtent, v);
+                reducer.decodedTranslations[k] = Vector3(v[0], v[1], v[2]);
+
+                encodeValue(reducer.scales[k], info.scaleMin, info.scaleExtent, &packedScales[k * 3]);
+                decodeValue(&packedScales[k * 3], info.scaleMin, info.scaleExtent, v);
+                reducer.decodedScales[k] = Vector3(v[0], v[1], v[2]);
+            }
+
+            // Greedily extend each segment from the last kept key for as long
+            // as the keys it spans can be dropped. The first and last keys are
+            // always kept, the latter being needed to wrap around.
+            keptKeys.clear();
+            keptKeys.push_back(0);
+            if (numKeys > 1)
+            {
+                size_t anchor = 0;
+                for (size_t end = 2; end < numKeys; )
+                {
+                    if (reducer.canSkipKeysBetween(anchor, end))
+                    {
+                        ++end;
+                    }
+                    else
+                    {
+                        anchor = end - 1;
+                        keptKeys.push_back(anchor);
+                        end = anchor + 2;
+                    }
+                }
+                keptKeys.push_back(numKeys - 1);
+            }
+
+            info.firstKey = static_cast<uint32>(mKeyTimes.size());
+            info.numKeys = static_cast<uint32>(keptKeys.size());
+            info.firstTranslation = constantTranslation ?
+                CONSTANT_CHANNEL : static_cast<uint32>(mTranslations.size() / 3);
+            info.firstScale = constantScale ?
+                CONSTANT_CHANNEL : static_cast<uint32>(mScales.size() / 3);
+
+            for (size_t k = 0; k < keptKeys.size(); ++k)
+            {
+                size_t src = keptKeys[k] * 3;
+                mKeyTimes.push_back(static_cast<float>(reducer.times[keptKeys[k]]));
+                mRotations.insert(mRotations.end(),
+                    packedRotations.begin() + src, packedRotations.begin() + src + 3);
+                if (!constantTranslation)
+                {
+                    mTranslations.insert(mTranslations.end(),
+                        packedTranslations.begin() + src, packedTranslations.begin() + src + 3);
+                }
+                if (!constantScale)
+                {
+                    mScales.insert(mScales.end(),
+                        packedScales.begin() + src, packedScales.begin() + src + 3);
+                }
+            }
+
+            mTracks.push_back(info);
+        }
+    }
+    //---------------------------------------------------------------------
+    unsigned short CompressedNodeTracks::getTrackHandle(size_t index) const
+    {
+        assert(index < mTracks.size() && "Index out of bounds");
+        return mTracks[index].handle;
+    }
+    //---------------------------------------------------------------------
+    size_t CompressedNodeTracks::getMemoryUsage(void) const
+    {
+        return sizeof(*this) +
+            mTracks.size() * sizeof(TrackInfo) +
+            mKeyTimes.size() * sizeof(float) +
+            (mRotations.size() + mTranslations.size() + mScales.size()) * sizeof(uint16);
+    }
+    //---------------------------------------------------------------------
+    Real CompressedNodeTracks::wrapTime(Real timePos) const
+    {
+        Real length = mParent->getLength();
+        if (timePos > length && length > 0.0f)
+            timePos = fmod(timePos, length);
+        return timePos;
+    }
+    //---------------------------------------------------------------------
+    void CompressedNodeTracks::sample(Real timePos, AnimationState::KeyCursor* cursor,
+        SampledTransform* result) const
+    {
+        timePos = wrapTime(timePos);
+        if (cursor)
+            cursor->resize(mTracks.size(), 0);
+
+        for (size_t first = 0; first < mTracks.size(); first += SAMPLE_BLOCK_SIZE)
+        {
+            sampleBlock(timePos, first, std::min(SAMPLE_BLOCK_SIZE, mTracks.size() - first),
+                cursor, result + first);
+        }
+    }
+    //---------------------------------------------------------------------
+    void CompressedNodeTracks::sampleBlock(Real timePos, size_t first, size_t count,
+        AnimationState::KeyCursor* cursor, SampledTransform* result) const
+    {
+        // Every lane up to the SIMD width is written below, but through offsets
+        // the compiler can't follow, so clear the block to keep it from guessing
+        SampleBlock block = SampleBlock();
+
+        // Find the keys of each track and unpack them
+        for (size_t i = 0; i < count; ++i)
+        {
+            const TrackInfo& info = mTracks[first + i];
+            const float* times = &mKeyTimes[info.firstKey];
+
+            // Walk forward from where we stopped last time, search if time went back
+            uint32 key = cursor ? std::min((*cursor)[first + i], info.numKeys - 1) : 0;
+            if (!cursor || times[key] > timePos)
+            {
+                key = static_cast<uint32>(
+                    std::upper_bound(times, times + info.numKeys, timePos) - times);
+                if (key > 0)
+                    --key;
+            }
+            else
+            {
+                while (key + 1 < info.numKeys && times[key + 1] <= timePos)
+                    ++key;
+            }
+            if (cursor)
+                (*cursor)[first + i] = key;
+
+            // Interpolate towards the next key, or towards the first one
+            // past the last key, like AnimationTrack::getKeyFramesAtTime
+            uint32 nextKey = key;
+            float t = 0;
+            if (timePos > times[key])
+            {
+                Real nextTime;
+                if (key + 1 < info.numKeys)
+                {
+                    nextKey = key + 1;
+                    nextTime = times[nextKey];
+                }
+                else
+                {
+                    nextKey = 0;
+                    nextTime = mParent->getLength() + times[0];
+                }
+                if (nextTime > times[key])
+                    t = static_cast<float>((timePos - times[key]) / (nextTime - times[key]));
+            }
+            block.weights[i] = t;
+
+            float a[4], b[4];
+            decodeRotation(&mRotations[(info.firstKey + key) * 3], a);
+            decodeRotation(&mRotations[(info.firstKey + nextKey) * 3], b);
+            for (size_t c = 0; c < 4; ++c)
+            {
+                block.keys1[SampleBlock::offset(i, ORIENTATION + c)] = a[c];
+                block.keys2[SampleBlock::offset(i, ORIENTATION + c)] = b[c];
+            }
+
+            if (info.firstTranslation == CONSTANT_CHANNEL)
+            {
+                for (size_t c = 0; c < 3; ++c)
+                    a[c] = b[c] = static_cast<float>(info.translationMin[c]);
+            }
+            else
+            {
+                decodeValue(&mTranslations[(info.firstTranslation + key) * 3],
+                    info.translationMin, info.translationExtent, a);
+                decodeValue(&mTranslations[(info.firstTranslation + nextKey) * 3],
+                    info.translationMin, info.translationExtent, b);
+            }
+            for (size_t c = 0; c < 3; ++c)
+            {
+                block.keys1[SampleBlock::offset(i, POSITION + c)] = a[c];
+                block.keys2[SampleBlock::offset(i, POSITION + c)] = b[c];
+            }
+
+            if (info.firstScale == CONSTANT_CHANNEL)
+            {
+                for (size_t c = 0; c < 3; ++c)
+                    a[c] = b[c] = static_cast<float>(info.scaleMin[c]);
+            }
+            else
+            {
+                decodeValue(&mScales[(info.firstScale + key) * 3],
+                    info.scaleMin, info.scaleExtent, a);
+                decodeValue(&mScales[(info.firstScale + nextKey) * 3],
+                    info.scaleMin, info.scaleExtent, b);
+            }
+            for (size_t c = 0; c < 3; ++c)
+            {
+                block.keys1[SampleBlock::offset(i, SCALE + c)] = a[c];
+                block.keys2[SampleBlock::offset(i, SCALE + c)] = b[c];
+            }
+        }
+
+        // Pad to the SIMD width with harmless identity lanes
+        size_t padded = (count + 3) & ~size_t(3);
+        for (size_t i = count; i < padded; ++i)
+        {
+            block.weights[i] = 0;
+            for (size_t c = 0; c < 10; ++c)
+            {
+                float identity = (c == ORIENTATION || c >= SCALE) ? 1.0f : 0.0f;
+                block.keys1[SampleBlock::offset(i, c)] = block.keys2[SampleBlock::offset(i, c)] = identity;
+            }
+        }
+
+        // the results replace the keys of the first keyframe
+        OptimisedUtil::getImplementation()->interpolateNodeTransforms(
+            block.weights, block.keys1, block.keys2, block.keys1, padded / 4);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float* k = block.keys1;
+            SampledTransform& out = result[i];
+            out.rotation = Quaternion(k[SampleBlock::offset(i, ORIENTATION)], k[SampleBlock::offset(i, ORIENTATION + 1)],
+                k[SampleBlock::offset(i, ORIENTATION + 2)], k[SampleBlock::offset(i, ORIENTATION + 3)]);
+            out.translation = Vector3(k[SampleBlock::offset(i, POSITION)], k[SampleBlock::offset(i, POSITION + 1)],
+                k[SampleBlock::offset(i, POSITION + 2)]);
+            out.scale = Vector3(k[SampleBlock::offset(i, SCALE)], k[SampleBlock::offset(i, SCALE + 1)],
+                k[SampleBlock::offset(i, SCALE + 2)]);
+        }
+    }
+    //---------------------------------------------------------------------
+    void CompressedNodeTracks::apply(Skeleton* skeleton, Real timePos, Real weight,
+        const AnimationState::BoneBlendMask* blendMask, Real scale,
+        AnimationState::KeyCursor* cursor) const
+    {
+        if (!weight)
+            return;
+
+        timePos = wrapTime(timePos);
+        if (cursor)
+            cursor->resize(mTracks.size(), 0);
+
+        SampledTransform transforms[SAMPLE_BLOCK_SIZE];
+        for (size_t first = 0; first < mTracks.size(); first += SAMPLE_BLOCK_SIZE)
+        {
+            size_t count = std::min(SAMPLE_BLOCK_SIZE, mTracks.size() - first);
+            sampleBlock(timePos, first, count, cursor, transforms);
+
+            // Same as NodeAnimationTrack::applyToNode
+            for (size_t i = 0; i < count; ++i)
+            {
+                unsigned short handle = mTracks[first + i].handle;
+                Real trackWeight = blendMask ? (*blendMask)[handle] * weight : weight;
+                if (!trackWeight)
+                    continue;
+
+                const SampledTransform& transform = transforms[i];
+                Bone* bone = skeleton->getBone(handle);
+                bone->translate(transform.translation * trackWeight * scale);
+                bone->rotate(Quaternion::nlerp(trackWeight, Quaternion::IDENTITY, transform.rotation, true));
+
+                Vector3 boneScale = transform.scale;
+                if (boneScale != Vector3::UNIT_SCALE)
+                {
+                    if (scale != 1.0f)
+                        boneScale = Vector3::UNIT_SCALE + (boneScale - Vector3::UNIT_SCALE) * scale;
+                    else if (trackWeight != 1.0f)
+                        boneScale = Vector3::UNIT_SCALE + (boneScale - Vector3::UNIT_SCALE) * trackWeight;
+                }
+                bone->scale(boneScale);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void CompressedNodeTracks::decompress(const Skeleton* skeleton) const
+    {
+        TrackInfoList::const_iterator i, iend = mTracks.end();
+        for (i = mTracks.begin(); i != iend; ++i)
+        {
+            const TrackInfo& info = *i;
+            NodeAnimationTrack* track = skeleton ?
+                mParent->createNodeTrack(info.handle, skeleton->getBone(info.handle)) :
+                mParent->createNodeTrack(info.handle);
+
+            for (uint32 k = 0; k < info.numKeys; ++k)
+            {
+                TransformKeyFrame* kf = track->createNodeKeyFrame(mKeyTimes[info.firstKey + k]);
+
+                float v[4];
+                decodeRotation(&mRotations[(info.firstKey + k) * 3], v);
+                kf->setRotation(Quaternion(v[0], v[1], v[2], v[3]));
+
+                if (info.firstTranslation == CONSTANT_CHANNEL)
+                {
+                    kf->setTranslate(info.translationMin);
+                }
+                else
+                {
+                    decodeValue(&mTranslations[(info.firstTranslation + k) * 3],
+                        info.translationMin, info.translationExtent, v);
+                    kf->setTranslate(Vector3(v[0], v[1], v[2]));
+                }
+
+                if (info.firstScale == CONSTANT_CHANNEL)
+                {
+                    kf->setScale(info.scaleMin);
+                }
+                else
+                {
+                    decodeValue(&mScales[(info.firstScale + k) * 3],
+                        info.scaleMin, info.scaleExtent, v);
+                    kf->setScale(Vector3(v[0], v[1], v[2]));
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    CompressedNodeTracks* CompressedNodeTracks::_clone(Animation* newParent) const
+    {
+        CompressedNodeTracks* ret = OGRE_NEW CompressedNodeTracks(newParent);
+        ret->mTracks = mTracks;
+        ret->mKeyTimes = mKeyTimes;
+        ret->mRotations = mRotations;
+        ret->mTranslations = mTranslations;
+        ret->mScales = mScales;
+        return ret;
+    }
+}
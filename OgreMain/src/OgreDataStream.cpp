@@ -30,6 +30,17 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreException.h"
 
+#if OGRE_PLATFORM != OGRE_PLATFORM_WIN32 && OGRE_PLATFORM != OGRE_PLATFORM_WINRT && \
+    OGRE_PLATFORM != OGRE_PLATFORM_NACL
+#   define OGRE_MAPPED_FILES 1
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#else
+#   define OGRE_MAPPED_FILES 0
+#endif
+
 namespace Ogre {
 
     //-----------------------------------------------------------------------
@@ -470,6 +481,76 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+    MappedFileDataStream::MappedFileDataStream(const String& name, const String& path)
+        : MemoryDataStream(name, 0, 0, false, true), mMapping(0), mMappingSize(0)
+    {
+#if OGRE_MAPPED_FILES
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                "Cannot open file: " + name,
+                "MappedFileDataStream::MappedFileDataStream");
+        }
+
+        struct stat tagStat;
+        if (fstat(fd, &tagStat) == 0 && tagStat.st_size > 0)
+        {
+            mMappingSize = static_cast<size_t>(tagStat.st_size);
+            mMapping = mmap(0, mMappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        // the mapping keeps the file referenced by itself
+        ::close(fd);
+
+        if (mMapping == MAP_FAILED)
+        {
+            mMapping = 0;
+            mMappingSize = 0;
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                "Cannot map file: " + name,
+                "MappedFileDataStream::MappedFileDataStream");
+        }
+
+        if (mMapping)
+        {
+            // files are mostly parsed front to back, let the system read ahead
+            posix_madvise(mMapping, mMappingSize, POSIX_MADV_SEQUENTIAL);
+        }
+
+        mData = mPos = static_cast<uchar*>(mMapping);
+        mSize = mMappingSize;
+        mEnd = mData + mSize;
+#else
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+            "Memory mapped files are not supported on this platform",
+            "MappedFileDataStream::MappedFileDataStream");
+#endif
+    }
+    //-----------------------------------------------------------------------
+    MappedFileDataStream::~MappedFileDataStream()
+    {
+        close();
+    }
+    //-----------------------------------------------------------------------
+    void MappedFileDataStream::close(void)
+    {
+#if OGRE_MAPPED_FILES
+        if (mMapping)
+        {
+            munmap(mMapping, mMappingSize);
+            mMapping = 0;
+            mMappingSize = 0;
+            mData = mPos = mEnd = 0;
+        }
+#endif
+    }
+    //-----------------------------------------------------------------------
+    bool MappedFileDataStream::isSupported(void)
+    {
+        return OGRE_MAPPED_FILES != 0;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     FileStreamDataStream::FileStreamDataStream(std::ifstream* s, bool freeOnClose)
         : DataStream(), mInStream(s), mFStreamRO(s), mFStream(0), mFreeOnClose(freeOnClose)
     {
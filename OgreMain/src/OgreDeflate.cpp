@@ -50,7 +50,8 @@ namespace Ogre
     }
     #define OGRE_DEFLATE_TMP_SIZE 16384
     //---------------------------------------------------------------------
-    DeflateStream::DeflateStream(const DataStreamPtr& compressedStream, const String& tmpFileName, size_t avail_in)
+    DeflateStream::DeflateStream(const DataStreamPtr& compressedStream, const String& tmpFileName, size_t avail_in,
+        StreamType streamType)
     : DataStream(compressedStream->getAccessMode())
     , mCompressedStream(compressedStream)
     , mTempFileName(tmpFileName)
@@ -59,11 +60,13 @@ namespace Ogre
     , mAvailIn(avail_in)
     , mTmp(0)
     , mIsCompressedValid(true)
+    , mStreamType(streamType)
     {
         init();
     }
     //---------------------------------------------------------------------
-    DeflateStream::DeflateStream(const String& name, const DataStreamPtr& compressedStream, const String& tmpFileName, size_t avail_in)
+    DeflateStream::DeflateStream(const String& name, const DataStreamPtr& compressedStream, const String& tmpFileName, size_t avail_in,
+        StreamType streamType)
     : DataStream(name, compressedStream->getAccessMode())
     , mCompressedStream(compressedStream)
     , mTempFileName(tmpFileName)
@@ -72,6 +75,7 @@ namespace Ogre
     , mAvailIn(avail_in)
     , mTmp(0)
     , mIsCompressedValid(true)
+    , mStreamType(streamType)
     {
         init();
     }
@@ -105,7 +109,9 @@ namespace Ogre
             mZStream->next_in = mTmp;
             mZStream->avail_in = static_cast<uint>(mCompressedStream->read(mTmp, getAvailInForSinglePass()));
             
-            if (inflateInit(mZStream) != Z_OK)
+            // negative window bits mean raw deflate data without headers
+            int windowBits = mStreamType == Deflate ? -MAX_WBITS : MAX_WBITS;
+            if (inflateInit2(mZStream, windowBits) != Z_OK)
             {
                 mIsCompressedValid = false;
             }
@@ -120,7 +126,9 @@ namespace Ogre
                 size_t savedIn = mZStream->avail_in;
                 mZStream->avail_out = 4;
                 mZStream->next_out = testOut;
-                if (inflate(mZStream, Z_SYNC_FLUSH) != Z_OK)
+                // data which inflates to less than that is at its end already
+                int status = inflate(mZStream, Z_SYNC_FLUSH);
+                if (status != Z_OK && status != Z_STREAM_END)
                     mIsCompressedValid = false;
                 // restore for reading
                 mZStream->avail_in = static_cast<uint>(savedIn);
@@ -285,7 +293,8 @@ namespace Ogre
         char in[OGRE_DEFLATE_TMP_SIZE];
         char out[OGRE_DEFLATE_TMP_SIZE];
         
-        if (deflateInit(mZStream, Z_DEFAULT_COMPRESSION) != Z_OK)
+        int windowBits = mStreamType == Deflate ? -MAX_WBITS : MAX_WBITS;
+        if (deflateInit2(mZStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
         {
             destroy();
             OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
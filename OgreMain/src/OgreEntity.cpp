@@ -45,6 +45,7 @@ Copyright (c) 2000-2016 Torus Knot Software Ltd
 #include "OgreTechnique.h"
 #include "OgrePass.h"
 #include "OgreSkeletonInstance.h"
+#include "OgreSkeletonAnimationCache.h"
 #include "OgreOptimisedUtil.h"
 #include "OgreSceneNode.h"
 #include "OgreLodStrategy.h"
@@ -68,6 +69,15 @@ namespace Ogre {
           mFrameAnimationLastUpdated(std::numeric_limits<unsigned long>::max()),
           mFrameBonesLastUpdated(NULL),
           mSharedSkeletonEntities(NULL),
+          mAnimationLodIndex(0),
+          mOffscreenAnimationInterval(1),
+          mFrameLastOnScreen(std::numeric_limits<unsigned long>::max()),
+          mAnimationWoken(false),
+          mFrameAnimationLastEvaluated(std::numeric_limits<unsigned long>::max()),
+          mLodBoneMatrices(NULL),
+          mLodBoneMatricesValid(false),
+          mBoneMatricesInterpolating(false),
+          mConcurrentBoneWorldMatrices(false),
           mDisplaySkeleton(false),
         mCurrentHWAnimationState(false),
         mHardwarePoseCount(0),
@@ -108,6 +118,15 @@ namespace Ogre {
         mFrameAnimationLastUpdated(std::numeric_limits<unsigned long>::max()),
         mFrameBonesLastUpdated(NULL),
         mSharedSkeletonEntities(NULL),
+        mAnimationLodIndex(0),
+        mOffscreenAnimationInterval(1),
+        mFrameLastOnScreen(std::numeric_limits<unsigned long>::max()),
+        mAnimationWoken(false),
+        mFrameAnimationLastEvaluated(std::numeric_limits<unsigned long>::max()),
+        mLodBoneMatrices(NULL),
+        mLodBoneMatricesValid(false),
+        mBoneMatricesInterpolating(false),
+        mConcurrentBoneWorldMatrices(false),
         mDisplaySkeleton(false),
         mCurrentHWAnimationState(false),
         mVertexProgramInUse(false),
@@ -271,6 +290,10 @@ namespace Ogre {
         // Delete shadow renderables
         clearShadowRenderableList(mShadowRenderables);
 
+        // The mesh may be another one once initialised again
+        mIntersectPose = MeshTriangleBvh::Pose();
+        vector<Matrix4>::type().swap(mIntersectPoseBoneMatrices);
+
         // Detach all child objects, do this manually to avoid needUpdate() call
         // which can fail because of deleted items
         detachAllObjectsImpl();
@@ -278,6 +301,11 @@ namespace Ogre {
         if (mSkeletonInstance) {
             OGRE_FREE_SIMD(mBoneWorldMatrices, MEMCATEGORY_ANIMATION);
             mBoneWorldMatrices = 0;
+            OGRE_FREE_SIMD(mLodBoneMatrices, MEMCATEGORY_ANIMATION);
+            mLodBoneMatrices = 0;
+            mLodBoneMatricesValid = false;
+            mBoneMatricesInterpolating = false;
+            mFrameAnimationLastEvaluated = std::numeric_limits<unsigned long>::max();
 
             if (mSharedSkeletonEntities) {
                 mSharedSkeletonEntities->erase(this);
@@ -452,6 +480,10 @@ namespace Ogre {
             // Change LOD index
             mMeshLodIndex = evt.newLodIndex;
 
+            // Animation LOD follows the same biased value
+            if (!mAnimationLodLevels.empty())
+                mAnimationLodIndex = meshStrategy->getIndex(biasedMeshLodValue, mAnimationLodValues);
+
             // Now do material LOD
             lodValue *= mMaterialLodFactorTransformed;
 #endif
@@ -660,6 +692,109 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    bool Entity::intersects(const Ray& ray, MeshTriangleBvh::Hit& hit)
+    {
+        if (!mInitialised)
+            return false;
+
+        const MeshTriangleBvh* bvh = mMesh->getTriangleBvh();
+
+        // an affine transform of the ray leaves distances along it unchanged
+        Matrix4 toLocal = _getParentNodeFullTransform().inverseAffine();
+        Ray localRay(toLocal.transformAffine(ray.getOrigin()),
+            toLocal.transformDirectionAffine(ray.getDirection()));
+
+        if (_isSkeletonAnimated())
+        {
+            // bring mBoneMatrices up to date with the current pose
+            _updateAnimation();
+            if (mIntersectPoseBoneMatrices.size() != mNumBoneMatrices ||
+                !std::equal(mBoneMatrices, mBoneMatrices + mNumBoneMatrices,
+                    mIntersectPoseBoneMatrices.begin()))
+            {
+                mIntersectPoseBoneMatrices.assign(mBoneMatrices, mBoneMatrices + mNumBoneMatrices);
+                bvh->skinPositions(mMesh.get(), mBoneMatrices, mIntersectPose.positions);
+                bvh->refit(mIntersectPose);
+            }
+            return bvh->intersects(localRay, mIntersectPose, hit);
+        }
+
+        return bvh->intersects(localRay, hit);
+    }
+    //-----------------------------------------------------------------------
+    bool Entity::_canUpdateRenderQueueConcurrently(void) const
+    {
+        // Animation may update hardware buffers, and so may reinitialising
+        // after the mesh has been reloaded
+        if (!mInitialised || hasSkeleton() || hasVertexAnimation() || 
+            mMesh->getStateCount() != mMeshStateCount)
+            return false;
+
+        // Queueing loads or compiles materials which need it
+        SubEntityList::const_iterator i, iend = mSubEntityList.end();
+        for (i = mSubEntityList.begin(); i != iend; ++i)
+        {
+            const MaterialPtr& mat = (*i)->getMaterial();
+            if (!mat.isNull() && (!mat->isLoaded() || mat->getCompilationRequired()))
+                return false;
+        }
+
+#if !OGRE_NO_MESHLOD
+        LODEntityList::const_iterator l, lend = mLodEntityList.end();
+        for (l = mLodEntityList.begin(); l != lend; ++l)
+        {
+            if (!(*l)->_canUpdateRenderQueueConcurrently())
+                return false;
+        }
+#endif
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    uint32 Entity::_getRenderQueueSignature(void) const
+    {
+        // Animation and attached objects are updated while queueing
+        if (!mInitialised || hasSkeleton() || hasVertexAnimation() || 
+            mMesh->getStateCount() != mMeshStateCount || !mChildObjectList.empty())
+            return 0;
+
+        const Entity* displayEntity = this;
+#if !OGRE_NO_MESHLOD
+        if (mMeshLodIndex > 0 && mMesh->hasManualLodLevel())
+            displayEntity = mLodEntityList[mMeshLodIndex-1];
+#endif
+        // This runs for every visible entity each frame, so rather than looking
+        // the techniques up it covers what they are chosen from: the material,
+        // which is recompiled by reloading it, its LOD and the active scheme
+        uint32 hash = HashCombine(0, displayEntity);
+        hash = HashCombine(hash, MaterialManager::getSingleton()._getActiveSchemeIndex());
+        hash = HashCombine(hash, mRenderQueueID | (mRenderQueuePriority << 8) |
+            (mRenderQueueIDSet ? 1 << 24 : 0) | (mRenderQueuePrioritySet ? 1 << 25 : 0));
+
+        SubEntityList::const_iterator i, iend;
+        iend = displayEntity->mSubEntityList.end();
+        for (i = displayEntity->mSubEntityList.begin(); i != iend; ++i)
+        {
+            const SubEntity* sub = *i;
+            if (!sub->isVisible())
+            {
+                hash = HashCombine(hash, 0);
+                continue;
+            }
+            const Material* material = sub->mMaterialPtr.get();
+            // the technique is only known once the material is loaded again
+            if (!material || !material->isLoaded())
+                return 0;
+            hash = HashCombine(hash, material);
+            hash = HashCombine(hash, material->getStateCount());
+            hash = HashCombine(hash, sub->mMaterialLodIndex | (sub->mRenderQueueID << 16) |
+                (sub->mRenderQueueIDSet ? 1 << 24 : 0) | (sub->mRenderQueuePrioritySet ? 1 << 25 : 0));
+            hash = HashCombine(hash, sub->mRenderQueuePriority);
+        }
+
+        // 0 means the queued renderables cannot be reused
+        return hash ? hash : 1;
+    }
+    //-----------------------------------------------------------------------
     void Entity::_updateRenderQueue(RenderQueue* queue)
     {
         // Do nothing if not initialised yet
@@ -673,6 +808,8 @@ namespace Ogre {
             _initialise(true);
         }
 
+        notifyOnScreen();
+
         Entity* displayEntity = this;
 #if !OGRE_NO_MESHLOD
         // Check we're not using a manual LOD
@@ -683,6 +820,8 @@ namespace Ogre {
                     "No LOD EntityList - did you build the manual LODs after creating the entity?");
             // index - 1 as we skip index 0 (original LOD)
             displayEntity = mLodEntityList[mMeshLodIndex-1];
+            if (displayEntity != this)
+                displayEntity->notifyOnScreen();
 
             if (displayEntity != this && hasSkeleton() && displayEntity->hasSkeleton())
             {
@@ -895,7 +1034,8 @@ namespace Ogre {
         // Animation dirty if animation state modified or manual bones modified
         bool animationDirty =
             (mFrameAnimationLastUpdated != mAnimationState->getDirtyFrameNumber()) ||
-            (hasSkeleton() && getSkeleton()->getManualBonesDirty());
+            (hasSkeleton() && getSkeleton()->getManualBonesDirty()) ||
+            mAnimationWoken || mBoneMatricesInterpolating;
         
         //update the current hardware animation state
         mCurrentHWAnimationState = hwAnimation;
@@ -1047,6 +1187,126 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    bool Entity::_prepareConcurrentAnimationUpdate(Camera* cam, Mesh::VertexBlendLockMap& locks)
+    {
+        mConcurrentVertexBlends.clear();
+
+        if (!mInitialised || !hasSkeleton() || sharesSkeletonInstance() ||
+            hasVertexAnimation() || !mChildObjectList.empty() ||
+            getNumManualLodLevels() > 0 || mMesh->getStateCount() != mMeshStateCount)
+            return false;
+
+#if !OGRE_NO_MESHLOD
+        // _notifyCurrentCamera only runs once the animation has been updated,
+        // so pick the animation LOD for this frame the same way it does
+        if (!mAnimationLodLevels.empty() && mParentNode)
+        {
+            const LodStrategy *meshStrategy = mMesh->getLodStrategy();
+            Real biasedMeshLodValue = meshStrategy->getValue(this, cam) * mMeshLodFactorTransformed;
+            mAnimationLodIndex = meshStrategy->getIndex(biasedMeshLodValue, mAnimationLodValues);
+        }
+#endif
+
+        notifyOnScreen();
+
+        // Same decisions as updateAnimation
+        Root& root = Root::getSingleton();
+        bool hwAnimation = isHardwareAnimationEnabled();
+        bool stencilShadows = false;
+        if (getCastShadows() && hasEdgeList() && root._getCurrentSceneManager())
+            stencilShadows =  root._getCurrentSceneManager()->isShadowTechniqueStencilBased();
+        bool softwareAnimation = !hwAnimation || stencilShadows || getSoftwareAnimationRequests()>0;
+        bool blendNormals = !hwAnimation || getSoftwareAnimationNormalsRequests()>0;
+        bool animationDirty =
+            (mFrameAnimationLastUpdated != mAnimationState->getDirtyFrameNumber()) ||
+            getSkeleton()->getManualBonesDirty() || mAnimationWoken || mBoneMatricesInterpolating;
+
+        if (!animationDirty && !(softwareAnimation && !tempSkelAnimBuffersBound(blendNormals)))
+            return false;
+
+        // Build the data animations build on demand, as they are shared
+        if (!mSkipAnimStateUpdates)
+        {
+            ConstEnabledAnimationStateIterator stateIt =
+                mAnimationState->getEnabledAnimationStateIterator();
+            while (stateIt.hasMoreElements())
+            {
+                const LinkedSkeletonAnimationSource* linked = 0;
+                Animation* anim = mSkeletonInstance->_getAnimationImpl(
+                    stateIt.getNext()->getAnimationName(), &linked);
+                if (anim)
+                    anim->_prepareConcurrentApply();
+            }
+        }
+
+        // Leave updateAnimation nothing to do for hardware animation either
+        mCurrentHWAnimationState = hwAnimation;
+        mLastParentXform = _getParentNodeFullTransform();
+        mConcurrentBoneWorldMatrices = hwAnimation && _isSkeletonAnimated();
+        if (mConcurrentBoneWorldMatrices && !mBoneWorldMatrices)
+        {
+            mBoneWorldMatrices =
+                static_cast<Matrix4*>(OGRE_MALLOC_SIMD(sizeof(Matrix4) * mNumBoneMatrices, MEMCATEGORY_ANIMATION));
+        }
+
+        if (softwareAnimation)
+        {
+            // Without vertex animation the source is always the mesh data
+            ConcurrentVertexBlend blend;
+            if (mSkelAnimVertexData)
+            {
+                mTempSkelAnimInfo.checkoutTempCopies(true, blendNormals);
+                mTempSkelAnimInfo.bindTempCopies(mSkelAnimVertexData, hwAnimation);
+                Mesh::_lockForSoftwareVertexBlend(mMesh->sharedVertexData, 
+                    mSkelAnimVertexData, blendNormals, locks, blend.data);
+                blend.indexMap = &mMesh->sharedBlendIndexToBoneIndexMap;
+                mConcurrentVertexBlends.push_back(blend);
+            }
+            SubEntityList::iterator i, iend;
+            iend = mSubEntityList.end();
+            for (i = mSubEntityList.begin(); i != iend; ++i)
+            {
+                SubEntity* se = *i;
+                if (se->isVisible() && se->mSkelAnimVertexData)
+                {
+                    se->mTempSkelAnimInfo.checkoutTempCopies(true, blendNormals);
+                    se->mTempSkelAnimInfo.bindTempCopies(se->mSkelAnimVertexData, hwAnimation);
+                    Mesh::_lockForSoftwareVertexBlend(se->mSubMesh->vertexData, 
+                        se->mSkelAnimVertexData, blendNormals, locks, blend.data);
+                    blend.indexMap = &se->mSubMesh->blendIndexToBoneIndexMap;
+                    mConcurrentVertexBlends.push_back(blend);
+                }
+            }
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void Entity::_updateAnimationConcurrently(void)
+    {
+        cacheBoneMatrices();
+
+        const Matrix4* blendMatrices[256];
+        ConcurrentVertexBlendList::iterator i, iend = mConcurrentVertexBlends.end();
+        for (i = mConcurrentVertexBlends.begin(); i != iend; ++i)
+        {
+            Mesh::prepareMatricesForVertexBlend(blendMatrices, mBoneMatrices, *i->indexMap);
+            Mesh::_softwareVertexBlend(i->data, blendMatrices);
+        }
+        mConcurrentVertexBlends.clear();
+
+        if (mConcurrentBoneWorldMatrices)
+        {
+            OptimisedUtil::getImplementation()->concatenateAffineMatrices(
+                mLastParentXform,
+                mBoneMatrices,
+                mBoneWorldMatrices,
+                mNumBoneMatrices);
+        }
+
+        mFrameAnimationLastUpdated = mAnimationState->getDirtyFrameNumber();
+    }
+    //-----------------------------------------------------------------------
     ushort Entity::initHardwareAnimationElements(VertexData* vdata,
                                                  ushort numberOfElements, bool animateNormals)
     {
@@ -1460,12 +1720,24 @@ namespace Ogre {
     {
         Root& root = Root::getSingleton();
         unsigned long currentFrameNumber = root.getNextFrameNumber();
+        bool lodActive = isAnimationLodActive();
         if ((*mFrameBonesLastUpdated != currentFrameNumber) ||
-            (hasSkeleton() && getSkeleton()->getManualBonesDirty()))
+            (hasSkeleton() && getSkeleton()->getManualBonesDirty()) ||
+            (lodActive && mAnimationWoken))
         {
-            if ((!mSkipAnimStateUpdates) && (*mFrameBonesLastUpdated != currentFrameNumber))
-                mSkeletonInstance->setAnimationState(*mAnimationState);
-            mSkeletonInstance->_getBoneMatrices(mBoneMatrices);
+            if (lodActive)
+            {
+                bool updated = updateLodBoneMatrices(currentFrameNumber);
+                *mFrameBonesLastUpdated = currentFrameNumber;
+                return updated;
+            }
+            mAnimationWoken = false;
+            mBoneMatricesInterpolating = false;
+
+            bool newFrame = *mFrameBonesLastUpdated != currentFrameNumber;
+            evaluateBoneMatrices(mBoneMatrices, newFrame && !mSkipAnimStateUpdates, 0);
+            if (newFrame && mManager)
+                mManager->_notifySkeletonUpdate(SceneManager::SUT_EVALUATED);
             *mFrameBonesLastUpdated  = currentFrameNumber;
 
             return true;
@@ -1473,6 +1745,172 @@ namespace Ogre {
         return false;
     }
     //-----------------------------------------------------------------------
+    void Entity::evaluateBoneMatrices(Matrix4* pMatrices, bool applyAnimation,
+        const AnimationState::BoneBlendMask* boneMask)
+    {
+        if (!applyAnimation)
+        {
+            mSkeletonInstance->_getBoneMatrices(pMatrices);
+            return;
+        }
+
+        // Only when the bones themselves are not needed past this point
+        SkeletonAnimationCache* cache = mManager ? mManager->getSkeletonAnimationCache() : 0;
+        if (cache && !boneMask && mChildObjectList.empty() && !mUpdateBoundingBoxFromSkeleton &&
+            !mDisplaySkeleton)
+        {
+            cache->getBoneMatrices(mSkeletonInstance, *mAnimationState, pMatrices);
+            return;
+        }
+
+        mSkeletonInstance->setAnimationState(*mAnimationState, boneMask);
+        mSkeletonInstance->_getBoneMatrices(pMatrices);
+    }
+    //-----------------------------------------------------------------------
+    bool Entity::isAnimationLodActive(void) const
+    {
+        return (!mAnimationLodLevels.empty() || mOffscreenAnimationInterval != 1) &&
+            !mSharedSkeletonEntities && !mSkipAnimStateUpdates;
+    }
+    //-----------------------------------------------------------------------
+    void Entity::notifyOnScreen(void)
+    {
+        // Texture shadow cameras do not count
+        SceneManager* sceneMgr = Root::getSingleton()._getCurrentSceneManager();
+        if (sceneMgr && sceneMgr->_getCurrentRenderStage() == SceneManager::IRS_RENDER_TO_TEXTURE)
+            return;
+
+        unsigned long currentFrameNumber = Root::getSingleton().getNextFrameNumber();
+        if ((mFrameLastOnScreen == std::numeric_limits<unsigned long>::max() ||
+            mFrameLastOnScreen + 1 < currentFrameNumber) && isAnimationLodActive())
+        {
+            mAnimationWoken = true;
+        }
+        mFrameLastOnScreen = currentFrameNumber;
+    }
+    //-----------------------------------------------------------------------
+    /// Blends the 3x4 part of affine matrices component-wise
+    static void lerpAffineMatrices(const Matrix4* from, const Matrix4* to, Real t,
+        Matrix4* dest, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (size_t r = 0; r < 3; ++r)
+            {
+                for (size_t c = 0; c < 4; ++c)
+                    dest[i][r][c] = from[i][r][c] + (to[i][r][c] - from[i][r][c]) * t;
+            }
+            dest[i][3][0] = dest[i][3][1] = dest[i][3][2] = 0;
+            dest[i][3][3] = 1;
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool Entity::updateLodBoneMatrices(unsigned long frameNumber)
+    {
+        const unsigned long never = std::numeric_limits<unsigned long>::max();
+        bool newFrame = *mFrameBonesLastUpdated != frameNumber;
+        bool onScreen = mFrameLastOnScreen != never && mFrameLastOnScreen + 1 >= frameNumber;
+
+        ushort interval = mOffscreenAnimationInterval;
+        const AnimationState::BoneBlendMask* boneMask = 0;
+        if (mAnimationLodIndex > 0 && mAnimationLodIndex <= mAnimationLodLevels.size())
+        {
+            const AnimationLodLevel& level = mAnimationLodLevels[mAnimationLodIndex - 1];
+            if (onScreen)
+                interval = level.updateInterval;
+            if (!level.boneMask.empty())
+                boneMask = &level.boneMask;
+        }
+        else if (onScreen)
+        {
+            interval = 1;
+        }
+
+        unsigned long elapsed = frameNumber - mFrameAnimationLastEvaluated;
+        bool evaluate = mFrameAnimationLastEvaluated == never || mAnimationWoken ||
+            getSkeleton()->getManualBonesDirty() || (interval > 0 && elapsed >= interval);
+
+        if (evaluate)
+        {
+            // Once per frame, though coming back on screen overrides a skip earlier in the frame
+            bool applyAnimation = mFrameAnimationLastEvaluated != frameNumber;
+
+            if (onScreen && interval > 1)
+            {
+                if (!mLodBoneMatrices)
+                {
+                    mLodBoneMatrices = static_cast<Matrix4*>(
+                        OGRE_MALLOC_SIMD(sizeof(Matrix4) * mNumBoneMatrices * 2, MEMCATEGORY_ANIMATION));
+                }
+                Matrix4* previous = mLodBoneMatrices;
+                Matrix4* last = mLodBoneMatrices + mNumBoneMatrices;
+
+                // Blend on from the last evaluation only when keeping to the interval
+                bool blend = mLodBoneMatricesValid && !mAnimationWoken && elapsed == interval;
+                if (blend)
+                    memcpy(previous, last, sizeof(Matrix4) * mNumBoneMatrices);
+                evaluateBoneMatrices(last, applyAnimation, boneMask);
+                if (!blend)
+                    memcpy(previous, last, sizeof(Matrix4) * mNumBoneMatrices);
+                mLodBoneMatricesValid = true;
+
+                lerpAffineMatrices(previous, last, Real(1) / interval, mBoneMatrices, mNumBoneMatrices);
+                mBoneMatricesInterpolating = blend;
+            }
+            else
+            {
+                evaluateBoneMatrices(mBoneMatrices, applyAnimation, boneMask);
+                mLodBoneMatricesValid = false;
+                mBoneMatricesInterpolating = false;
+            }
+
+            mFrameAnimationLastEvaluated = frameNumber;
+            mAnimationWoken = false;
+            if (applyAnimation && mManager)
+                mManager->_notifySkeletonUpdate(SceneManager::SUT_EVALUATED);
+            return true;
+        }
+
+        if (!newFrame)
+            return false;
+
+        if (onScreen && mBoneMatricesInterpolating && mLodBoneMatricesValid)
+        {
+            Real t = std::min(Real(elapsed + 1) / interval, Real(1));
+            lerpAffineMatrices(mLodBoneMatrices, mLodBoneMatrices + mNumBoneMatrices, t,
+                mBoneMatrices, mNumBoneMatrices);
+            mBoneMatricesInterpolating = t < 1;
+            if (mManager)
+                mManager->_notifySkeletonUpdate(SceneManager::SUT_INTERPOLATED);
+            return true;
+        }
+
+        if (mManager)
+            mManager->_notifySkeletonUpdate(SceneManager::SUT_SKIPPED);
+        return false;
+    }
+    //-----------------------------------------------------------------------
+    void Entity::setAnimationLodLevels(const AnimationLodLevelList& levels)
+    {
+        const LodStrategy* strategy = mMesh->getLodStrategy();
+
+        mAnimationLodValues.clear();
+        mAnimationLodValues.push_back(strategy->getBaseValue());
+        AnimationLodLevelList::const_iterator i, iend = levels.end();
+        for (i = levels.begin(); i != iend; ++i)
+        {
+            if (i->updateInterval == 0)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "The update interval of an animation LOD level must be at least 1.",
+                    "Entity::setAnimationLodLevels");
+            }
+            mAnimationLodValues.push_back(strategy->transformUserValue(i->userValue));
+        }
+        mAnimationLodLevels = levels;
+        mAnimationLodIndex = 0;
+    }
+    //-----------------------------------------------------------------------
     void Entity::setDisplaySkeleton(bool display)
     {
         mDisplaySkeleton = display;
@@ -2012,6 +2450,75 @@ namespace Ogre {
         }
 #endif
 
+        Vector4 lightPos;
+        EdgeData* edgeList = prepareShadowRenderables(light, indexBuffer, extrude,
+            extrusionDistance, lightPos);
+
+        if (!edgeList)
+        {
+            // we can't get an edge list for some reason, return blank
+            // really we shouldn't be able to get here, but this is a safeguard
+            return ShadowRenderableListIterator(mShadowRenderables.begin(), mShadowRenderables.end());
+        }
+
+        // Calc triangle light facing
+        updateEdgeListLightFacing(edgeList, lightPos);
+
+        // Generate indexes and update renderables
+        generateShadowVolume(edgeList, *indexBuffer, *indexBufferUsedSize,
+            light, mShadowRenderables, flags);
+
+
+        return ShadowRenderableListIterator(mShadowRenderables.begin(), mShadowRenderables.end());
+    }
+    //-----------------------------------------------------------------------
+    bool Entity::_prepareShadowVolume(
+        ShadowTechnique shadowTechnique, const Light* light,
+        HardwareIndexBufferSharedPtr* indexBuffer,
+        bool extrude, Real extrusionDistance, unsigned long flags,
+        ShadowVolumeBuild& build)
+    {
+        assert(indexBuffer && "Only external index buffers are supported right now");
+        assert((*indexBuffer)->getType() == HardwareIndexBuffer::IT_16BIT &&
+            "Only 16-bit indexes supported for now");
+
+        // Check mesh state count, will be incremented if reloaded
+        if (mMesh->getStateCount() != mMeshStateCount)
+        {
+            // force reinitialise
+            _initialise(true);
+        }
+
+#if !OGRE_NO_MESHLOD
+        // Manual LOD entities share their animation state, leave them to
+        // getShadowVolumeRenderableIterator
+        if (mMesh->hasManualLodLevel() && mMeshLodIndex > 0)
+        {
+            return false;
+        }
+#endif
+        // Animation updates the face normals of the shared edge list
+        if (hasSkeleton() || hasVertexAnimation())
+        {
+            return false;
+        }
+
+        EdgeData* edgeList = prepareShadowRenderables(light, indexBuffer, extrude,
+            extrusionDistance, build.lightPos);
+        if (!edgeList)
+        {
+            // Leave the safeguard to getShadowVolumeRenderableIterator
+            return false;
+        }
+
+        initShadowVolumeBuild(build, edgeList, light, mShadowRenderables, flags);
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    EdgeData* Entity::prepareShadowRenderables(const Light* light,
+        HardwareIndexBufferSharedPtr* indexBuffer, bool extrude,
+        Real extrusionDistance, Vector4& lightPos)
+    {
         // Prepare temp buffers if required
         if (!mPreparedForShadowVolumes)
         {
@@ -2033,7 +2540,7 @@ namespace Ogre {
         }
 
         // Calculate the object space light details
-        Vector4 lightPos = light->getAs4DVector();
+        lightPos = light->getAs4DVector();
         Matrix4 world2Obj = mParentNode->_getFullTransform().inverseAffine();
         lightPos = world2Obj.transformAffine(lightPos);
         Matrix3 world2Obj3x3;
@@ -2045,9 +2552,7 @@ namespace Ogre {
 
         if (!edgeList)
         {
-            // we can't get an edge list for some reason, return blank
-            // really we shouldn't be able to get here, but this is a safeguard
-            return ShadowRenderableListIterator(mShadowRenderables.begin(), mShadowRenderables.end());
+            return 0;
         }
 
         // Init shadow renderable list if required
@@ -2138,15 +2643,8 @@ namespace Ogre {
             esrPositionBuffer->suppressHardwareUpdate(false);
 
         }
-        // Calc triangle light facing
-        updateEdgeListLightFacing(edgeList, lightPos);
 
-        // Generate indexes and update renderables
-        generateShadowVolume(edgeList, *indexBuffer, *indexBufferUsedSize,
-            light, mShadowRenderables, flags);
-
-
-        return ShadowRenderableListIterator(mShadowRenderables.begin(), mShadowRenderables.end());
+        return edgeList;
     }
     //-----------------------------------------------------------------------
     const VertexData* Entity::findBlendedVertexData(const VertexData* orig)
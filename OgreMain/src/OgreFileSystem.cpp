@@ -58,7 +58,7 @@ namespace Ogre {
 
     //-----------------------------------------------------------------------
     FileSystemArchive::FileSystemArchive(const String& name, const String& archType, bool readOnly )
-        : Archive(name, archType)
+        : Archive(name, archType), mUseMemoryMapping(false)
     {
         // Even failed attempt to write to read only location violates Apple AppStore validation process.
         // And successful writing to some probe file does not prove that whole location with subfolders 
@@ -225,6 +225,11 @@ namespace Ogre {
                         "FileSystemArchive::open");
         }
 
+        if (readOnly && mUseMemoryMapping && MappedFileDataStream::isSupported())
+        {
+            return DataStreamPtr(OGRE_NEW MappedFileDataStream(filename, full_path));
+        }
+
         if (!readOnly)
         {
             mode |= std::ios::out;
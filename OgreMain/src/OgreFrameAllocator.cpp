@@ -0,0 +1,227 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreFrameAllocator.h"
+#include "OgrePlatformInformation.h"
+
+namespace Ogre {
+
+    /// Alignment used when none is requested, matching the general allocator
+    static const size_t FRAME_ARENA_DEFAULT_ALIGNMENT = 2 * sizeof(void*);
+
+    //-----------------------------------------------------------------------
+    void* FrameArenaImpl::allocBytes(size_t count)
+    {
+        return allocBytesAligned(FRAME_ARENA_DEFAULT_ALIGNMENT, count);
+    }
+    //-----------------------------------------------------------------------
+    void* FrameArenaImpl::allocBytesAligned(size_t align, size_t count)
+    {
+        FrameAllocator* arena = FrameAllocator::getSingletonPtr();
+        if (!arena)
+            return 0;
+
+        if (!arena->isEnabled() || !arena->isArenaThread())
+        {
+            arena->_notifyFallback();
+            return 0;
+        }
+
+        return arena->allocate(count, align ? align : OGRE_SIMD_ALIGNMENT);
+    }
+    //-----------------------------------------------------------------------
+    bool FrameArenaImpl::deallocBytes(void* ptr)
+    {
+        // memory of the arena is only released on reset; other threads never 
+        // get arena memory, and must not look at the blocks while they change
+        FrameAllocator* arena = FrameAllocator::getSingletonPtr();
+        return arena && arena->isArenaThread() && arena->owns(ptr);
+    }
+    //-----------------------------------------------------------------------
+    template<> FrameAllocator* Singleton<FrameAllocator>::msSingleton = 0;
+    FrameAllocator* FrameAllocator::getSingletonPtr(void)
+    {
+        return msSingleton;
+    }
+    FrameAllocator& FrameAllocator::getSingleton(void)
+    {  
+        assert( msSingleton );  return ( *msSingleton );  
+    }
+    //-----------------------------------------------------------------------
+    FrameAllocator::FrameAllocator(size_t blockSize)
+        : mCurrentBlock(0)
+        , mOffset(0)
+        , mBlockSize(blockSize)
+        , mEnabled(true)
+        , mAllocations(0)
+        , mBytes(0)
+        , mFallbacks(0)
+    {
+        mLastFrameStats.allocations = 0;
+        mLastFrameStats.bytes = 0;
+        mLastFrameStats.fallbacks = 0;
+#if OGRE_THREAD_SUPPORT
+        mThreadId = OGRE_THREAD_CURRENT_ID;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    FrameAllocator::~FrameAllocator()
+    {
+        freeBlocks();
+    }
+    //-----------------------------------------------------------------------
+    void* FrameAllocator::allocate(size_t count, size_t align)
+    {
+        assert(isArenaThread() && "Frame arena used from another thread");
+
+        if (!align)
+            align = FRAME_ARENA_DEFAULT_ALIGNMENT;
+
+        for (;;)
+        {
+            if (mCurrentBlock < mBlocks.size())
+            {
+                const Block& block = mBlocks[mCurrentBlock];
+                size_t address = reinterpret_cast<size_t>(block.data) + mOffset;
+                size_t start = mOffset + ((align - (address & (align - 1))) & (align - 1));
+                if (start + count <= block.size)
+                {
+                    mOffset = start + count;
+                    ++mAllocations;
+                    mBytes += count;
+                    return block.data + start;
+                }
+
+                // does not fit, the rest of the block is wasted until the next reset
+                if (mCurrentBlock + 1 < mBlocks.size())
+                {
+                    ++mCurrentBlock;
+                    mOffset = 0;
+                    continue;
+                }
+            }
+
+            addBlock(std::max(mBlockSize, count + align));
+            mCurrentBlock = mBlocks.size() - 1;
+            mOffset = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool FrameAllocator::owns(const void* ptr) const
+    {
+        const char* p = static_cast<const char*>(ptr);
+        for (BlockList::const_iterator i = mBlocks.begin(); i != mBlocks.end(); ++i)
+        {
+            if (p >= i->data && p < i->data + i->size)
+                return true;
+        }
+        return false;
+    }
+    //-----------------------------------------------------------------------
+    FrameAllocator::Marker FrameAllocator::getMarker() const
+    {
+        Marker marker;
+        marker.block = mCurrentBlock;
+        marker.offset = mOffset;
+        return marker;
+    }
+    //-----------------------------------------------------------------------
+    void FrameAllocator::rollback(const Marker& marker)
+    {
+        assert((marker.block < mCurrentBlock || 
+            (marker.block == mCurrentBlock && marker.offset <= mOffset)) &&
+            "Frame arena markers must be rolled back in reverse order");
+
+        mCurrentBlock = marker.block;
+        mOffset = marker.offset;
+    }
+    //-----------------------------------------------------------------------
+    void FrameAllocator::reset()
+    {
+        if (mBlocks.size() > 1)
+        {
+            size_t capacity = getCapacity();
+            freeBlocks();
+            addBlock(capacity);
+        }
+
+        mCurrentBlock = 0;
+        mOffset = 0;
+    }
+    //-----------------------------------------------------------------------
+    bool FrameAllocator::isArenaThread() const
+    {
+#if OGRE_THREAD_SUPPORT
+        return OGRE_THREAD_CURRENT_ID == mThreadId;
+#else
+        return true;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    size_t FrameAllocator::getCapacity() const
+    {
+        size_t capacity = 0;
+        for (BlockList::const_iterator i = mBlocks.begin(); i != mBlocks.end(); ++i)
+            capacity += i->size;
+        return capacity;
+    }
+    //-----------------------------------------------------------------------
+    FrameAllocator::Stats FrameAllocator::getFrameStats() const
+    {
+        Stats stats;
+        stats.allocations = mAllocations;
+        stats.bytes = mBytes;
+        stats.fallbacks = mFallbacks.get();
+        return stats;
+    }
+    //-----------------------------------------------------------------------
+    void FrameAllocator::_frameEnded()
+    {
+        mLastFrameStats = getFrameStats();
+        mAllocations = 0;
+        mBytes = 0;
+        mFallbacks.set(0);
+
+        reset();
+    }
+    //-----------------------------------------------------------------------
+    void FrameAllocator::addBlock(size_t size)
+    {
+        Block block;
+        block.data = OGRE_ALLOC_T(char, size, MEMCATEGORY_GENERAL);
+        block.size = size;
+        mBlocks.push_back(block);
+    }
+    //-----------------------------------------------------------------------
+    void FrameAllocator::freeBlocks()
+    {
+        for (BlockList::iterator i = mBlocks.begin(); i != mBlocks.end(); ++i)
+            OGRE_FREE(i->data, MEMCATEGORY_GENERAL);
+        mBlocks.clear();
+    }
+}
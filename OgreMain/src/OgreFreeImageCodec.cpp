@@ -398,11 +398,16 @@ namespace Ogre {
     //---------------------------------------------------------------------
     Codec::DecodeResult FreeImageCodec::decode(DataStreamPtr& input) const
     {
-        // Buffer stream into memory (TODO: override IO functions instead?)
-        MemoryDataStream memStream(input, true);
+        // Decode in place from streams already in memory, such as memory
+        // mapped files, buffer any other stream into memory first
+        MemoryDataStreamPtr memStream = input.dynamicCast<MemoryDataStream>();
+        if (memStream.isNull())
+            memStream.bind(OGRE_NEW MemoryDataStream(input, true));
+        uchar* data = memStream->getCurrentPtr();
+        size_t dataSize = memStream->size() - memStream->tell();
 
         FIMEMORY* fiMem = 
-            FreeImage_OpenMemory(memStream.getPtr(), static_cast<DWORD>(memStream.size()));
+            FreeImage_OpenMemory(data, static_cast<DWORD>(dataSize));
 
         FIBITMAP* fiBitmap = FreeImage_LoadFromMemory(
             (FREE_IMAGE_FORMAT)mFreeImageType, fiMem);
@@ -39,6 +39,7 @@ THE SOFTWARE.
 #include "OgreMaterialManager.h"
 #include "OgreRenderSystem.h"
 #include "OgreMovablePlane.h"
+#include "OgreOptimisedUtil.h"
 
 namespace Ogre {
 
@@ -259,6 +260,93 @@ namespace Ogre {
         return true;
     }
 
+    //-----------------------------------------------------------------------
+    void Frustum::areVisible(const AxisAlignedBox* const* bounds, size_t count, bool* visible) const
+    {
+        // Go through isVisible so that subclasses overriding it are respected
+        for (size_t i = 0; i < count; ++i)
+        {
+            visible[i] = isVisible(*bounds[i]);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Frustum::cullBoxes(const AxisAlignedBox* const* bounds, size_t count, bool* visible) const
+    {
+#if OGRE_DOUBLE_PRECISION
+        // OptimisedUtil works on single precision values only
+        for (size_t i = 0; i < count; ++i)
+        {
+            visible[i] = Frustum::isVisible(*bounds[i]);
+        }
+#else
+        // Boxes are packed and tested in fixed size chunks
+        const size_t chunkBoxes = 64;
+        const size_t chunkBlocks = chunkBoxes / 4;
+
+        // Make any pending updates to the calculated frustum planes
+        updateFrustumPlanes();
+
+        float planes[6 * 4];
+        size_t numPlanes = 0;
+        for (int plane = 0; plane < 6; ++plane)
+        {
+            // Skip far plane if infinite view frustum
+            if (plane == FRUSTUM_PLANE_FAR && mFarDist == 0)
+                continue;
+
+            const Plane& p = mFrustumPlanes[plane];
+            planes[numPlanes * 4 + 0] = p.normal.x;
+            planes[numPlanes * 4 + 1] = p.normal.y;
+            planes[numPlanes * 4 + 2] = p.normal.z;
+            planes[numPlanes * 4 + 3] = p.d;
+            ++numPlanes;
+        }
+
+        // Local buffer aligned by hand, so this can be called concurrently
+        float boxBuffer[chunkBlocks * 24 + 4];
+        float* boxes = reinterpret_cast<float*>(
+            (reinterpret_cast<size_t>(boxBuffer) + 15) & ~static_cast<size_t>(15));
+        uint8 masks[chunkBlocks];
+
+        for (size_t first = 0; first < count; first += chunkBoxes)
+        {
+            size_t num = std::min(chunkBoxes, count - first);
+            size_t numBlocks = (num + 3) / 4;
+
+            for (size_t i = 0; i < numBlocks * 4; ++i)
+            {
+                float* b = boxes + (i / 4) * 24 + (i % 4);
+                const AxisAlignedBox* box = i < num ? bounds[first + i] : 0;
+                if (box && box->isFinite())
+                {
+                    Vector3 centre = box->getCenter();
+                    Vector3 halfSize = box->getHalfSize();
+                    b[0] = centre.x; b[4] = centre.y; b[8] = centre.z;
+                    b[12] = halfSize.x; b[16] = halfSize.y; b[20] = halfSize.z;
+                }
+                else
+                {
+                    // Padding, null and infinite boxes are resolved below
+                    b[0] = b[4] = b[8] = b[12] = b[16] = b[20] = 0;
+                }
+            }
+
+            OptimisedUtil::getImplementation()->cullBoxes(
+                planes, numPlanes, boxes, numBlocks, masks);
+
+            for (size_t i = 0; i < num; ++i)
+            {
+                const AxisAlignedBox* box = bounds[first + i];
+                if (box->isNull())
+                    visible[first + i] = false;
+                else if (box->isInfinite())
+                    visible[first + i] = true;
+                else
+                    visible[first + i] = (masks[i / 4] & (1 << (i % 4))) != 0;
+            }
+        }
+#endif
+    }
     //-----------------------------------------------------------------------
     bool Frustum::isVisible(const Vector3& vert, FrustumPlane* culledBy) const
     {
@@ -0,0 +1,471 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#if OGRE_NO_ZIP_ARCHIVE == 0
+
+#include "OgreIndexedZip.h"
+#include "OgreDeflate.h"
+#include "OgreLogManager.h"
+#include "OgreException.h"
+
+#include <sys/stat.h>
+#include <zlib.h>
+
+namespace Ogre {
+
+    // Record signatures and sizes, see the zip file format specification
+    #define OGRE_ZIP_LOCAL_HEADER_SIGNATURE 0x04034b50
+    #define OGRE_ZIP_LOCAL_HEADER_SIZE 30
+    #define OGRE_ZIP_CENTRAL_HEADER_SIGNATURE 0x02014b50
+    #define OGRE_ZIP_CENTRAL_HEADER_SIZE 46
+    #define OGRE_ZIP_END_RECORD_SIGNATURE 0x06054b50
+    #define OGRE_ZIP_END_RECORD_SIZE 22
+    #define OGRE_ZIP_MAX_COMMENT_SIZE 65535
+
+    #define OGRE_ZIP_METHOD_STORED 0
+    #define OGRE_ZIP_METHOD_DEFLATED 8
+    #define OGRE_ZIP_FLAG_ENCRYPTED 1
+
+    /// Zip archives are little endian whatever the platform
+    static uint16 readUInt16(const uchar* data)
+    {
+        return static_cast<uint16>(data[0] | (data[1] << 8));
+    }
+    static uint32 readUInt32(const uchar* data)
+    {
+        return static_cast<uint32>(data[0]) | (static_cast<uint32>(data[1]) << 8) |
+            (static_cast<uint32>(data[2]) << 16) | (static_cast<uint32>(data[3]) << 24);
+    }
+    /// Key of a name in the entry indices
+    static String indexKey(const String& name)
+    {
+        String key = name;
+        std::replace(key.begin(), key.end(), '\\', '/');
+        StringUtil::toLowerCase(key);
+        return key;
+    }
+    //-----------------------------------------------------------------------
+    IndexedZipArchive::IndexedZipArchive(const String& name, const String& archType)
+        : Archive(name, archType), mLoaded(false)
+    {
+    }
+    //-----------------------------------------------------------------------
+    IndexedZipArchive::~IndexedZipArchive()
+    {
+        unload();
+    }
+    //-----------------------------------------------------------------------
+    void IndexedZipArchive::load()
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        if (!mLoaded)
+        {
+            std::ifstream file(mName.c_str(), std::ios::in | std::ios::binary);
+            if (!file)
+            {
+                OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                    mName + " - error whilst opening archive: Unable to read zip file.",
+                    "IndexedZipArchive::load");
+            }
+
+            try
+            {
+                readCentralDirectory(file);
+            }
+            catch (Exception&)
+            {
+                mEntries.clear();
+                mPathIndex.clear();
+                mNameIndex.clear();
+                mFileList.clear();
+                throw;
+            }
+            mLoaded = true;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void IndexedZipArchive::readCentralDirectory(std::ifstream& file)
+    {
+        file.seekg(0, std::ios::end);
+        size_t fileSize = static_cast<size_t>(file.tellg());
+
+        // The end record is at the very end, only followed by the archive comment
+        size_t tailSize = std::min(fileSize, (size_t)(OGRE_ZIP_END_RECORD_SIZE + OGRE_ZIP_MAX_COMMENT_SIZE));
+        vector<uchar>::type tail(tailSize);
+        file.seekg(fileSize - tailSize);
+        file.read(reinterpret_cast<char*>(tail.empty() ? 0 : &tail[0]), tailSize);
+
+        const uchar* end = 0;
+        for (size_t i = tailSize; i >= OGRE_ZIP_END_RECORD_SIZE && !end; --i)
+        {
+            const uchar* record = &tail[i - OGRE_ZIP_END_RECORD_SIZE];
+            if (readUInt32(record) == OGRE_ZIP_END_RECORD_SIGNATURE)
+                end = record;
+        }
+        if (!file || !end)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                mName + " - error whilst opening archive: Zip-file's central directory record missing.",
+                "IndexedZipArchive::readCentralDirectory");
+        }
+
+        size_t entryCount = readUInt16(end + 10);
+        size_t directorySize = readUInt32(end + 12);
+        size_t directoryOffset = readUInt32(end + 16);
+        if (entryCount == 0xFFFF || directorySize == 0xFFFFFFFF || directoryOffset == 0xFFFFFFFF)
+        {
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                mName + " - Zip64 archives are not supported",
+                "IndexedZipArchive::readCentralDirectory");
+        }
+        if (directoryOffset + directorySize > fileSize)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                mName + " - error whilst opening archive: Corrupted archive.",
+                "IndexedZipArchive::readCentralDirectory");
+        }
+
+        vector<uchar>::type directory(directorySize);
+        file.seekg(directoryOffset);
+        file.read(reinterpret_cast<char*>(directory.empty() ? 0 : &directory[0]), directorySize);
+
+        mEntries.reserve(entryCount);
+        mFileList.reserve(entryCount);
+        size_t pos = 0;
+        for (size_t i = 0; i < entryCount; ++i)
+        {
+            const uchar* header = directory.empty() ? 0 : &directory[0] + pos;
+            if (!file || pos + OGRE_ZIP_CENTRAL_HEADER_SIZE > directorySize ||
+                readUInt32(header) != OGRE_ZIP_CENTRAL_HEADER_SIGNATURE)
+            {
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                    mName + " - error whilst opening archive: Corrupted archive.",
+                    "IndexedZipArchive::readCentralDirectory");
+            }
+
+            Entry entry;
+            entry.flags = readUInt16(header + 8);
+            entry.method = readUInt16(header + 10);
+            entry.crc = readUInt32(header + 16);
+            entry.compressedSize = readUInt32(header + 20);
+            entry.uncompressedSize = readUInt32(header + 24);
+            entry.headerOffset = readUInt32(header + 42);
+            size_t nameLength = readUInt16(header + 28);
+            size_t recordSize = OGRE_ZIP_CENTRAL_HEADER_SIZE + nameLength +
+                readUInt16(header + 30) + readUInt16(header + 32);
+            if (pos + recordSize > directorySize)
+            {
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                    mName + " - error whilst opening archive: Corrupted archive.",
+                    "IndexedZipArchive::readCentralDirectory");
+            }
+            String name(reinterpret_cast<const char*>(header + OGRE_ZIP_CENTRAL_HEADER_SIZE), nameLength);
+            pos += recordSize;
+
+            // Same file list as ZipArchive builds
+            FileInfo info;
+            info.archive = this;
+            StringUtil::splitFilename(name, info.basename, info.path);
+            info.filename = name;
+            info.compressedSize = entry.compressedSize;
+            info.uncompressedSize = entry.uncompressedSize;
+            // folder entries
+            if (info.basename.empty())
+            {
+                info.filename = info.filename.substr(0, info.filename.length() - 1);
+                StringUtil::splitFilename(info.filename, info.basename, info.path);
+                info.compressedSize = size_t(-1);
+                mFileList.push_back(info);
+                continue;
+            }
+            info.filename = info.basename;
+            mFileList.push_back(info);
+
+            size_t index = mEntries.size();
+            mEntries.push_back(entry);
+            mPathIndex[indexKey(name)] = index;
+            // Files opened by name alone can only be found if the name is unique
+            std::pair<EntryIndex::iterator, bool> inserted =
+                mNameIndex.insert(EntryIndex::value_type(indexKey(info.basename), index));
+            if (!inserted.second)
+                inserted.first->second = String::npos;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void IndexedZipArchive::unload()
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        if (mLoaded)
+        {
+            mEntries.clear();
+            mPathIndex.clear();
+            mNameIndex.clear();
+            mFileList.clear();
+            mLoaded = false;
+        }
+    }
+    //-----------------------------------------------------------------------
+    size_t IndexedZipArchive::findEntry(const String& filename) const
+    {
+        String key = indexKey(filename);
+        EntryIndex::const_iterator i = mPathIndex.find(key);
+        if (i != mPathIndex.end())
+            return i->second;
+
+        // Like ZipArchive, fall back on a file of that name in any folder
+        if (key.find('/') == String::npos)
+        {
+            i = mNameIndex.find(key);
+            if (i != mNameIndex.end())
+                return i->second;
+        }
+        return String::npos;
+    }
+    //-----------------------------------------------------------------------
+    void IndexedZipArchive::readEntry(const Entry& entry, const String& filename, void* buffer) const
+    {
+        if (entry.flags & OGRE_ZIP_FLAG_ENCRYPTED)
+        {
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                mName + " - Encrypted file " + filename + " is not supported",
+                "IndexedZipArchive::readEntry");
+        }
+        if (entry.method != OGRE_ZIP_METHOD_STORED && entry.method != OGRE_ZIP_METHOD_DEFLATED)
+        {
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                mName + " - Unsupported compression format of file " + filename,
+                "IndexedZipArchive::readEntry");
+        }
+
+        // Every reader has its own handle, so nothing is shared between threads
+        std::ifstream file(mName.c_str(), std::ios::in | std::ios::binary);
+        uchar header[OGRE_ZIP_LOCAL_HEADER_SIZE];
+        file.seekg(entry.headerOffset);
+        file.read(reinterpret_cast<char*>(header), OGRE_ZIP_LOCAL_HEADER_SIZE);
+        if (!file || readUInt32(header) != OGRE_ZIP_LOCAL_HEADER_SIGNATURE)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                mName + " - Unable to read file " + filename + ": Corrupted archive.",
+                "IndexedZipArchive::readEntry");
+        }
+        // The local header's name and extra field may differ from the central one's
+        file.seekg(entry.headerOffset + OGRE_ZIP_LOCAL_HEADER_SIZE +
+            readUInt16(header + 26) + readUInt16(header + 28));
+
+        size_t size = entry.uncompressedSize;
+        if (entry.method == OGRE_ZIP_METHOD_STORED)
+        {
+            file.read(static_cast<char*>(buffer), size);
+            if (static_cast<size_t>(file.gcount()) != size)
+                size = 0;
+        }
+        else
+        {
+            // DeflateStream only inflates read only streams
+            MemoryDataStream* compressed = OGRE_NEW MemoryDataStream(entry.compressedSize, true, true);
+            DataStreamPtr compressedPtr(compressed);
+            file.read(reinterpret_cast<char*>(compressed->getPtr()), entry.compressedSize);
+            if (static_cast<size_t>(file.gcount()) != entry.compressedSize)
+                size = 0;
+            else if (size)
+            {
+                DeflateStream inflated(compressedPtr, "", entry.compressedSize, DeflateStream::Deflate);
+                if (!inflated.isCompressedStreamValid() || inflated.read(buffer, size) != size)
+                    size = 0;
+            }
+        }
+
+        if (size != entry.uncompressedSize || crc32(0, static_cast<const Bytef*>(buffer), static_cast<uInt>(size)) != entry.crc)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                mName + " - Unable to read file " + filename + ": Corrupted archive.",
+                "IndexedZipArchive::readEntry");
+        }
+    }
+    //-----------------------------------------------------------------------
+    DataStreamPtr IndexedZipArchive::open(const String& filename, bool readOnly)
+    {
+        // No lock, the index doesn't change while the archive is loaded
+        size_t index = findEntry(filename);
+        if (index == String::npos)
+        {
+            LogManager::getSingleton().logMessage(
+                mName + " - Unable to open file " + filename + ", error was 'File not found.'", LML_CRITICAL);
+
+            // return null pointer
+            return DataStreamPtr();
+        }
+
+        const Entry& entry = mEntries[index];
+        MemoryDataStream* stream = OGRE_NEW MemoryDataStream(filename, entry.uncompressedSize, true, true);
+        DataStreamPtr ret(stream);
+        readEntry(entry, filename, stream->getPtr());
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    size_t IndexedZipArchive::decompress(const String& filename, void* buffer, size_t bufferSize)
+    {
+        size_t index = findEntry(filename);
+        if (index == String::npos)
+        {
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                mName + " - Unable to find file " + filename,
+                "IndexedZipArchive::decompress");
+        }
+
+        const Entry& entry = mEntries[index];
+        if (bufferSize < entry.uncompressedSize)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                mName + " - Buffer is too small for file " + filename + ", it needs " +
+                StringConverter::toString(entry.uncompressedSize) + " bytes",
+                "IndexedZipArchive::decompress");
+        }
+
+        readEntry(entry, filename, buffer);
+        return entry.uncompressedSize;
+    }
+    //---------------------------------------------------------------------
+    DataStreamPtr IndexedZipArchive::create(const String& filename)
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+            "Modification of zipped archives is not supported",
+            "IndexedZipArchive::create");
+    }
+    //---------------------------------------------------------------------
+    void IndexedZipArchive::remove(const String& filename)
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+            "Modification of zipped archives is not supported",
+            "IndexedZipArchive::remove");
+    }
+    //-----------------------------------------------------------------------
+    StringVectorPtr IndexedZipArchive::list(bool recursive, bool dirs)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        StringVectorPtr ret = StringVectorPtr(OGRE_NEW_T(StringVector, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+
+        FileInfoList::iterator i, iend;
+        iend = mFileList.end();
+        for (i = mFileList.begin(); i != iend; ++i)
+            if ((dirs == (i->compressedSize == size_t (-1))) &&
+                (recursive || i->path.empty()))
+                ret->push_back(i->filename);
+
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    FileInfoListPtr IndexedZipArchive::listFileInfo(bool recursive, bool dirs)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        FileInfoList* fil = OGRE_NEW_T(FileInfoList, MEMCATEGORY_GENERAL)();
+        FileInfoList::const_iterator i, iend;
+        iend = mFileList.end();
+        for (i = mFileList.begin(); i != iend; ++i)
+            if ((dirs == (i->compressedSize == size_t (-1))) &&
+                (recursive || i->path.empty()))
+                fil->push_back(*i);
+
+        return FileInfoListPtr(fil, SPFM_DELETE_T);
+    }
+    //-----------------------------------------------------------------------
+    StringVectorPtr IndexedZipArchive::find(const String& pattern, bool recursive, bool dirs)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        StringVectorPtr ret = StringVectorPtr(OGRE_NEW_T(StringVector, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+        // If pattern contains a directory name, do a full match
+        bool full_match = (pattern.find ('/') != String::npos) ||
+                          (pattern.find ('\\') != String::npos);
+        bool wildCard = pattern.find("*") != String::npos;
+
+        FileInfoList::iterator i, iend;
+        iend = mFileList.end();
+        for (i = mFileList.begin(); i != iend; ++i)
+            if ((dirs == (i->compressedSize == size_t (-1))) &&
+                (recursive || full_match || wildCard))
+                // Check basename matches pattern (zip is case insensitive)
+                if (StringUtil::match(full_match ? i->filename : i->basename, pattern, false))
+                    ret->push_back(i->filename);
+
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    FileInfoListPtr IndexedZipArchive::findFileInfo(const String& pattern,
+        bool recursive, bool dirs)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        FileInfoListPtr ret = FileInfoListPtr(OGRE_NEW_T(FileInfoList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+        // If pattern contains a directory name, do a full match
+        bool full_match = (pattern.find ('/') != String::npos) ||
+                          (pattern.find ('\\') != String::npos);
+        bool wildCard = pattern.find("*") != String::npos;
+
+        FileInfoList::const_iterator i, iend;
+        iend = mFileList.end();
+        for (i = mFileList.begin(); i != iend; ++i)
+            if ((dirs == (i->compressedSize == size_t (-1))) &&
+                (recursive || full_match || wildCard))
+                // Check name matches pattern (zip is case insensitive)
+                if (StringUtil::match(full_match ? i->filename : i->basename, pattern, false))
+                    ret->push_back(*i);
+
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    bool IndexedZipArchive::exists(const String& filename)
+    {
+        // Same lookup as open, so that whatever exists can be opened
+        return findEntry(filename) != String::npos;
+    }
+    //---------------------------------------------------------------------
+    time_t IndexedZipArchive::getModifiedTime(const String& filename)
+    {
+        // Entries only have DOS times in local time, so check the mod time of the zip itself
+        struct stat tagStat;
+        bool ret = (stat(mName.c_str(), &tagStat) == 0);
+
+        if (ret)
+        {
+            return tagStat.st_mtime;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    const String& IndexedZipArchiveFactory::getType(void) const
+    {
+        static String name = "IndexedZip";
+        return name;
+    }
+
+}
+
+#endif
@@ -491,6 +491,9 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void InstanceManager::_addDirtyBatch( InstanceBatch *dirtyBatch )
     {
+        //Instances may be moved from several threads during a parallel scene graph update
+        OGRE_LOCK_MUTEX(mDirtyBatchesMutex);
+
         if( mDirtyBatches.empty() )
             mSceneManager->_addDirtyInstanceManager( this );
 
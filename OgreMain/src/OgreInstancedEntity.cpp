@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "OgreInstancedEntity.h"
 #include "OgreInstanceBatch.h"
 #include "OgreSkeletonInstance.h"
+#include "OgreSkeletonAnimationCache.h"
+#include "OgreSceneManager.h"
 #include "OgreAnimationState.h"
 #include "OgreOptimisedUtil.h"
 #include "OgreCamera.h"
@@ -415,8 +417,17 @@ namespace Ogre
 
             if( animationDirty || (mNeedAnimTransformUpdate &&  mBatchOwner->useBoneWorldMatrices()))
             {
-                mSkeletonInstance->setAnimationState( *mAnimationState );
-                mSkeletonInstance->_getBoneMatrices( mBoneMatrices );
+                SceneManager* sceneMgr = mBatchOwner->_getManager();
+                SkeletonAnimationCache* cache = sceneMgr ? sceneMgr->getSkeletonAnimationCache() : 0;
+                if( cache )
+                {
+                    cache->getBoneMatrices( mSkeletonInstance, *mAnimationState, mBoneMatrices );
+                }
+                else
+                {
+                    mSkeletonInstance->setAnimationState( *mAnimationState );
+                    mSkeletonInstance->_getBoneMatrices( mBoneMatrices );
+                }
 
                 // Cache last parent transform for next frame use too.
                 if (mBatchOwner->useBoneWorldMatrices())
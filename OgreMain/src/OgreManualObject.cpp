@@ -976,15 +976,60 @@ namespace Ogre {
     {
         assert(indexBuffer && "Only external index buffers are supported right now");       
 
-        EdgeData* edgeList = getEdgeList();
+        Vector4 lightPos;
+        EdgeData* edgeList = prepareShadowRenderables(light, indexBuffer, extrude,
+            extrusionDistance, lightPos);
         if (!edgeList)
         {
             return ShadowRenderableListIterator(
                 mShadowRenderables.begin(), mShadowRenderables.end());
         }
 
+        // Calc triangle light facing
+        updateEdgeListLightFacing(edgeList, lightPos);
+
+        // Generate indexes and update renderables
+        generateShadowVolume(edgeList, *indexBuffer, *indexBufferUsedSize, 
+            light, mShadowRenderables, flags);
+
+
+        return ShadowRenderableListIterator(
+            mShadowRenderables.begin(), mShadowRenderables.end());
+
+
+    }
+    //-----------------------------------------------------------------------------
+    bool ManualObject::_prepareShadowVolume(
+        ShadowTechnique shadowTechnique, const Light* light,
+        HardwareIndexBufferSharedPtr* indexBuffer,
+        bool extrude, Real extrusionDistance, unsigned long flags,
+        ShadowVolumeBuild& build)
+    {
+        assert(indexBuffer && "Only external index buffers are supported right now");
+
+        EdgeData* edgeList = prepareShadowRenderables(light, indexBuffer, extrude,
+            extrusionDistance, build.lightPos);
+        if (!edgeList)
+        {
+            return false;
+        }
+
+        initShadowVolumeBuild(build, edgeList, light, mShadowRenderables, flags);
+        return true;
+    }
+    //-----------------------------------------------------------------------------
+    EdgeData* ManualObject::prepareShadowRenderables(const Light* light,
+        HardwareIndexBufferSharedPtr* indexBuffer, bool extrude,
+        Real extrusionDistance, Vector4& lightPos)
+    {
+        EdgeData* edgeList = getEdgeList();
+        if (!edgeList)
+        {
+            return 0;
+        }
+
         // Calculate the object space light details
-        Vector4 lightPos = light->getAs4DVector();
+        lightPos = light->getAs4DVector();
         Matrix4 world2Obj = mParentNode->_getFullTransform().inverseAffine();
         lightPos = world2Obj.transformAffine(lightPos);
         Matrix3 world2Obj3x3;
@@ -1049,18 +1094,8 @@ namespace Ogre {
             ++si;
             ++egi;
         }
-        // Calc triangle light facing
-        updateEdgeListLightFacing(edgeList, lightPos);
-
-        // Generate indexes and update renderables
-        generateShadowVolume(edgeList, *indexBuffer, *indexBufferUsedSize, 
-            light, mShadowRenderables, flags);
-
-
-        return ShadowRenderableListIterator(
-            mShadowRenderables.begin(), mShadowRenderables.end());
-
 
+        return edgeList;
     }
     //-----------------------------------------------------------------------------
     //-----------------------------------------------------------------------------
@@ -68,6 +68,7 @@ namespace Ogre
                 mAllocationsByPool.resize(pool+1, 0);
             mAllocationsByPool[pool] += sz;
             mTotalAllocations += sz;
+            ++mAllocationCount;
         }
     
     }
@@ -94,6 +95,19 @@ namespace Ogre
         }
     }   
     //--------------------------------------------------------------------------
+    void MemoryTracker::_frameEnded(size_t arenaAllocations)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+
+        mLastFrameAllocationCount = mAllocationCount - mFrameStartAllocationCount;
+        mLastFrameArenaAllocationCount = arenaAllocations;
+        mFrameStartAllocationCount = mAllocationCount;
+
+        ++mFrameCount;
+        mFramesAllocationCount += mLastFrameAllocationCount;
+        mFramesArenaAllocationCount += arenaAllocations;
+    }
+    //--------------------------------------------------------------------------
     size_t MemoryTracker::getTotalMemoryAllocated() const
     {
         return mTotalAllocations;
@@ -135,6 +149,15 @@ namespace Ogre
                 os << std::endl;            
             }
 
+            if (mFrameCount)
+            {
+                // what the frame arena saved: without it, its allocations would have been on the heap
+                os << "Ogre Memory: " << mFrameCount << " frame(s), "
+                   << mFramesAllocationCount / mFrameCount << " heap allocation(s) and "
+                   << mFramesArenaAllocationCount / mFrameCount << " frame arena allocation(s) per frame on average." 
+                   << std::endl;
+            }
+
             if (mDumpToStdOut)        
                 Ogre_OutputCString(os.str().c_str());
 
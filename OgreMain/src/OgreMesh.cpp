@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgreException.h"
 #include "OgreMeshManager.h"
 #include "OgreEdgeListBuilder.h"
+#include "OgreMeshTriangleBvh.h"
 #include "OgreAnimation.h"
 #include "OgreAnimationState.h"
 #include "OgreAnimationTrack.h"
@@ -65,6 +66,7 @@ namespace Ogre {
         mPreparedForShadowVolumes(false),
         mEdgeListsBuilt(false),
         mAutoBuildEdgeLists(true), // will be set to false by serializers of 1.30 and above
+        mTriangleBvh(0),
         mSharedVertexDataAnimationType(VAT_NONE),
         mSharedVertexDataAnimationIncludesNormals(false),
         mAnimationTypesDirty(true),
@@ -229,8 +231,10 @@ namespace Ogre {
             ResourceGroupManager::getSingleton().openResource(
                 mName, mGroup, true, this);
  
-        // fully prebuffer into host RAM
-        mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
+        // fully prebuffer into host RAM, unless it already is there, such as
+        // a memory mapped file which the serializer can read in place
+        if (mFreshFromDisk.dynamicCast<MemoryDataStream>().isNull())
+            mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
     }
     //-----------------------------------------------------------------------
     void Mesh::unprepareImpl()
@@ -282,6 +286,7 @@ namespace Ogre {
         mSubMeshNameMap.clear();
 
         freeEdgeList();
+        freeTriangleBvh();
 #if !OGRE_NO_MESHLOD
         // Removes all LOD data
         removeLodLevels();
@@ -1800,6 +1805,21 @@ namespace Ogre {
         mEdgeListsBuilt = false;
     }
     //---------------------------------------------------------------------
+    const MeshTriangleBvh* Mesh::getTriangleBvh(void)
+    {
+        OGRE_LOCK_MUTEX(mTriangleBvhMutex);
+        if (!mTriangleBvh)
+            mTriangleBvh = OGRE_NEW MeshTriangleBvh(this);
+        return mTriangleBvh;
+    }
+    //---------------------------------------------------------------------
+    void Mesh::freeTriangleBvh(void)
+    {
+        OGRE_LOCK_MUTEX(mTriangleBvhMutex);
+        OGRE_DELETE mTriangleBvh;
+        mTriangleBvh = 0;
+    }
+    //---------------------------------------------------------------------
     void Mesh::prepareForShadowVolume(void)
     {
         if (mPreparedForShadowVolumes)
@@ -1866,6 +1886,30 @@ namespace Ogre {
         const VertexData* targetVertexData,
         const Matrix4* const* blendMatrices, size_t numMatrices,
         bool blendNormals)
+    {
+        VertexBlendLockMap locks;
+        SoftwareVertexBlendData data;
+        _lockForSoftwareVertexBlend(sourceVertexData, targetVertexData, blendNormals,
+            locks, data);
+        _softwareVertexBlend(data, blendMatrices);
+        _unlockForSoftwareVertexBlend(locks);
+    }
+    //---------------------------------------------------------------------
+    static void* lockForSoftwareVertexBlend(HardwareVertexBuffer* buf,
+        HardwareBuffer::LockOptions options, Mesh::VertexBlendLockMap& locks)
+    {
+        Mesh::VertexBlendLockMap::iterator i = locks.find(buf);
+        if (i != locks.end())
+            return i->second;
+
+        void* pBuffer = buf->lock(options);
+        locks[buf] = pBuffer;
+        return pBuffer;
+    }
+    //---------------------------------------------------------------------
+    void Mesh::_lockForSoftwareVertexBlend(const VertexData* sourceVertexData,
+        const VertexData* targetVertexData, bool blendNormals,
+        VertexBlendLockMap& locks, SoftwareVertexBlendData& data)
     {
         float *pSrcPos = 0;
         float *pSrcNorm = 0;
@@ -1873,13 +1917,6 @@ namespace Ogre {
         float *pDestNorm = 0;
         float *pBlendWeight = 0;
         unsigned char* pBlendIdx = 0;
-        size_t srcPosStride = 0;
-        size_t srcNormStride = 0;
-        size_t destPosStride = 0;
-        size_t destNormStride = 0;
-        size_t blendWeightStride = 0;
-        size_t blendIdxStride = 0;
-
 
         // Get elements for source
         const VertexElement* srcElemPos =
@@ -1903,107 +1940,99 @@ namespace Ogre {
 
 
         // Get buffers for source
-        HardwareVertexBufferSharedPtr srcPosBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemPos->getSource());
-        HardwareVertexBufferSharedPtr srcIdxBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemBlendIndices->getSource());
-        HardwareVertexBufferSharedPtr srcWeightBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemBlendWeights->getSource());
-        HardwareVertexBufferSharedPtr srcNormBuf;
-
-        srcPosStride = srcPosBuf->getVertexSize();
-        
-        blendIdxStride = srcIdxBuf->getVertexSize();
-        
-        blendWeightStride = srcWeightBuf->getVertexSize();
+        HardwareVertexBuffer* srcPosBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemPos->getSource()).get();
+        HardwareVertexBuffer* srcIdxBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemBlendIndices->getSource()).get();
+        HardwareVertexBuffer* srcWeightBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemBlendWeights->getSource()).get();
+        HardwareVertexBuffer* srcNormBuf = 0;
+
+        data.srcPosStride = srcPosBuf->getVertexSize();
+        data.srcNormStride = 0;
+        data.blendIdxStride = srcIdxBuf->getVertexSize();
+        data.blendWeightStride = srcWeightBuf->getVertexSize();
         if (includeNormals)
         {
-            srcNormBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemNorm->getSource());
-            srcNormStride = srcNormBuf->getVertexSize();
+            srcNormBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemNorm->getSource()).get();
+            data.srcNormStride = srcNormBuf->getVertexSize();
         }
         // Get buffers for target
-        HardwareVertexBufferSharedPtr destPosBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemPos->getSource());
-        HardwareVertexBufferSharedPtr destNormBuf;
-        destPosStride = destPosBuf->getVertexSize();
+        HardwareVertexBuffer* destPosBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemPos->getSource()).get();
+        HardwareVertexBuffer* destNormBuf = 0;
+        data.destPosStride = destPosBuf->getVertexSize();
+        data.destNormStride = 0;
         if (includeNormals)
         {
-            destNormBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemNorm->getSource());
-            destNormStride = destNormBuf->getVertexSize();
+            destNormBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemNorm->getSource()).get();
+            data.destNormStride = destNormBuf->getVertexSize();
         }
 
         void* pBuffer;
 
         // Lock source buffers for reading
-        pBuffer = srcPosBuf->lock(HardwareBuffer::HBL_READ_ONLY);
+        pBuffer = lockForSoftwareVertexBlend(srcPosBuf, HardwareBuffer::HBL_READ_ONLY, locks);
         srcElemPos->baseVertexPointerToElement(pBuffer, &pSrcPos);
         if (includeNormals)
         {
-            if (srcNormBuf != srcPosBuf)
-            {
-                // Different buffer
-                pBuffer = srcNormBuf->lock(HardwareBuffer::HBL_READ_ONLY);
-            }
+            pBuffer = lockForSoftwareVertexBlend(srcNormBuf, HardwareBuffer::HBL_READ_ONLY, locks);
             srcElemNorm->baseVertexPointerToElement(pBuffer, &pSrcNorm);
         }
 
         // Indices must be 4 bytes
         assert(srcElemBlendIndices->getType() == VET_UBYTE4 &&
                "Blend indices must be VET_UBYTE4");
-        pBuffer = srcIdxBuf->lock(HardwareBuffer::HBL_READ_ONLY);
+        pBuffer = lockForSoftwareVertexBlend(srcIdxBuf, HardwareBuffer::HBL_READ_ONLY, locks);
         srcElemBlendIndices->baseVertexPointerToElement(pBuffer, &pBlendIdx);
-        if (srcWeightBuf != srcIdxBuf)
-        {
-            // Lock buffer
-            pBuffer = srcWeightBuf->lock(HardwareBuffer::HBL_READ_ONLY);
-        }
+        pBuffer = lockForSoftwareVertexBlend(srcWeightBuf, HardwareBuffer::HBL_READ_ONLY, locks);
         srcElemBlendWeights->baseVertexPointerToElement(pBuffer, &pBlendWeight);
-        unsigned short numWeightsPerVertex =
+        data.numWeightsPerVertex =
             VertexElement::getTypeCount(srcElemBlendWeights->getType());
 
 
         // Lock destination buffers for writing
-        pBuffer = destPosBuf->lock(
+        pBuffer = lockForSoftwareVertexBlend(destPosBuf,
             (destNormBuf != destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize()) ||
             (destNormBuf == destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize() + destElemNorm->getSize()) ?
-            HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL);
+            HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL, locks);
         destElemPos->baseVertexPointerToElement(pBuffer, &pDestPos);
         if (includeNormals)
         {
-            if (destNormBuf != destPosBuf)
-            {
-                pBuffer = destNormBuf->lock(
-                    destNormBuf->getVertexSize() == destElemNorm->getSize() ?
-                    HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL);
-            }
+            pBuffer = lockForSoftwareVertexBlend(destNormBuf,
+                destNormBuf->getVertexSize() == destElemNorm->getSize() ?
+                HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL, locks);
             destElemNorm->baseVertexPointerToElement(pBuffer, &pDestNorm);
         }
 
+        data.srcPos = pSrcPos;
+        data.srcNorm = pSrcNorm;
+        data.destPos = pDestPos;
+        data.destNorm = pDestNorm;
+        data.blendWeight = pBlendWeight;
+        data.blendIdx = pBlendIdx;
+        data.vertexCount = targetVertexData->vertexCount;
+    }
+    //---------------------------------------------------------------------
+    void Mesh::_softwareVertexBlend(const SoftwareVertexBlendData& data,
+        const Matrix4* const* blendMatrices)
+    {
         OptimisedUtil::getImplementation()->softwareVertexSkinning(
-            pSrcPos, pDestPos,
-            pSrcNorm, pDestNorm,
-            pBlendWeight, pBlendIdx,
+            data.srcPos, data.destPos,
+            data.srcNorm, data.destNorm,
+            data.blendWeight, data.blendIdx,
             blendMatrices,
-            srcPosStride, destPosStride,
-            srcNormStride, destNormStride,
-            blendWeightStride, blendIdxStride,
-            numWeightsPerVertex,
-            targetVertexData->vertexCount);
-
-        // Unlock source buffers
-        srcPosBuf->unlock();
-        srcIdxBuf->unlock();
-        if (srcWeightBuf != srcIdxBuf)
-        {
-            srcWeightBuf->unlock();
-        }
-        if (includeNormals && srcNormBuf != srcPosBuf)
-        {
-            srcNormBuf->unlock();
-        }
-        // Unlock destination buffers
-        destPosBuf->unlock();
-        if (includeNormals && destNormBuf != destPosBuf)
+            data.srcPosStride, data.destPosStride,
+            data.srcNormStride, data.destNormStride,
+            data.blendWeightStride, data.blendIdxStride,
+            data.numWeightsPerVertex,
+            data.vertexCount);
+    }
+    //---------------------------------------------------------------------
+    void Mesh::_unlockForSoftwareVertexBlend(VertexBlendLockMap& locks)
+    {
+        VertexBlendLockMap::iterator i, iend = locks.end();
+        for (i = locks.begin(); i != iend; ++i)
         {
-            destNormBuf->unlock();
+            i->first->unlock();
         }
-
+        locks.clear();
     }
     //---------------------------------------------------------------------
     void Mesh::softwareVertexMorph(Real t,
@@ -0,0 +1,586 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreMeshTriangleBvh.h"
+#include "OgreMesh.h"
+#include "OgreSubMesh.h"
+#include "OgreOptimisedUtil.h"
+
+namespace Ogre {
+    namespace
+    {
+        /// Largest number of triangles in a leaf
+        const uint32 MAX_LEAF_TRIANGLES = 4;
+        /// Number of bins of the split candidates
+        const size_t NUM_BINS = 12;
+
+        /// Half the surface area of a box, enough to compare costs
+        inline Real halfArea(const Vector3& min, const Vector3& max)
+        {
+            Vector3 d = max - min;
+            return d.x * d.y + d.y * d.z + d.z * d.x;
+        }
+
+        /// Slab test of a box, giving the distance the ray enters it at
+        inline bool intersectsBox(const Vector3& origin, const Vector3& invDirection,
+            const Vector3& min, const Vector3& max, Real maxDistance, Real& entry)
+        {
+            Real tmin = 0, tmax = maxDistance;
+            for (int i = 0; i < 3; ++i)
+            {
+                Real t1 = (min[i] - origin[i]) * invDirection[i];
+                Real t2 = (max[i] - origin[i]) * invDirection[i];
+                if (t1 > t2)
+                    std::swap(t1, t2);
+                // a NaN from a ray in the plane of a face leaves the range as is
+                tmin = std::max(tmin, t1);
+                tmax = std::min(tmax, t2);
+            }
+            entry = tmin;
+            return tmin <= tmax;
+        }
+
+        /// Locks a buffer for reading unless it already is
+        const unsigned char* lockForReading(const VertexData* vertexData,
+            const VertexElement* elem, Mesh::VertexBlendLockMap& locks)
+        {
+            HardwareVertexBuffer* buf =
+                vertexData->vertexBufferBinding->getBuffer(elem->getSource()).get();
+            Mesh::VertexBlendLockMap::iterator i = locks.find(buf);
+            void* base = i != locks.end() ? i->second :
+                (locks[buf] = buf->lock(HardwareBuffer::HBL_READ_ONLY));
+            return static_cast<const unsigned char*>(base) +
+                vertexData->vertexStart * buf->getVertexSize() + elem->getOffset();
+        }
+
+        size_t getVertexSize(const VertexData* vertexData, const VertexElement* elem)
+        {
+            return vertexData->vertexBufferBinding->getBuffer(elem->getSource())->getVertexSize();
+        }
+    }
+    //---------------------------------------------------------------------
+    MeshTriangleBvh::MeshTriangleBvh(const Mesh* mesh)
+        : mDepth(0)
+    {
+        mVertexOffsets.push_back(mesh->sharedVertexData ? addPositions(mesh->sharedVertexData) : 0);
+        for (unsigned short i = 0; i < mesh->getNumSubMeshes(); ++i)
+        {
+            const SubMesh* sub = mesh->getSubMesh(i);
+            size_t offset = sub->useSharedVertices ? mVertexOffsets[0] : addPositions(sub->vertexData);
+            mVertexOffsets.push_back(offset);
+            addTriangles(sub, i, offset);
+        }
+
+        if (mTriangles.empty())
+            return;
+
+        vector<BuildItem>::type items(mTriangles.size());
+        for (size_t t = 0; t < mTriangles.size(); ++t)
+        {
+            BuildItem& item = items[t];
+            for (int v = 0; v < 3; ++v)
+            {
+                const float* p = &mPositions[mTriangles[t].vertices[v] * 3];
+                Vector3 pos(p[0], p[1], p[2]);
+                if (v == 0)
+                {
+                    item.min = item.max = pos;
+                }
+                else
+                {
+                    item.min.makeFloor(pos);
+                    item.max.makeCeil(pos);
+                }
+            }
+            item.centre = (item.min + item.max) * 0.5f;
+            item.triangle = static_cast<uint32>(t);
+        }
+
+        // at most one internal node per leaf
+        mNodes.reserve(mTriangles.size() * 2);
+        mBounds.reserve(mTriangles.size() * 2);
+        mDepth = 0;
+        build(&items[0], 0, static_cast<uint32>(items.size()), 1);
+
+        // store the triangles in the order of the leaves
+        TriangleList sorted(mTriangles.size());
+        for (size_t t = 0; t < items.size(); ++t)
+            sorted[t] = mTriangles[items[t].triangle];
+        mTriangles.swap(sorted);
+    }
+    //---------------------------------------------------------------------
+    MeshTriangleBvh::~MeshTriangleBvh()
+    {
+    }
+    //---------------------------------------------------------------------
+    size_t MeshTriangleBvh::addPositions(const VertexData* vertexData)
+    {
+        size_t first = mPositions.size() / 3;
+        const VertexElement* posElem =
+            vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        if (!posElem || vertexData->vertexCount == 0)
+            return first;
+
+        HardwareVertexBufferSharedPtr vbuf =
+            vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+        HardwareBufferLockGuard<HardwareVertexBufferSharedPtr> lock(vbuf,
+            vertexData->vertexStart * vbuf->getVertexSize(),
+            vertexData->vertexCount * vbuf->getVertexSize(), HardwareBuffer::HBL_READ_ONLY);
+
+        mPositions.resize((first + vertexData->vertexCount) * 3);
+        float* dest = &mPositions[first * 3];
+        unsigned char* vertex = static_cast<unsigned char*>(lock.pData);
+        for (size_t v = 0; v < vertexData->vertexCount; ++v, vertex += vbuf->getVertexSize())
+        {
+            float* pos;
+            posElem->baseVertexPointerToElement(vertex, &pos);
+            *dest++ = pos[0];
+            *dest++ = pos[1];
+            *dest++ = pos[2];
+        }
+        return first;
+    }
+    //---------------------------------------------------------------------
+    void MeshTriangleBvh::addTriangles(const SubMesh* subMesh, unsigned short subMeshIndex,
+        size_t vertexOffset)
+    {
+        RenderOperation::OperationType op = subMesh->operationType;
+        if (op != RenderOperation::OT_TRIANGLE_LIST && op != RenderOperation::OT_TRIANGLE_STRIP &&
+            op != RenderOperation::OT_TRIANGLE_FAN)
+            return;
+
+        const VertexData* vertexData = subMesh->useSharedVertices ?
+            subMesh->parent->sharedVertexData : subMesh->vertexData;
+        if (!vertexData || vertexData->vertexCount == 0)
+            return;
+        size_t vertexCount = vertexData->vertexCount;
+
+        // the vertex indexes, in the order of the operation
+        vector<uint32>::type indexes;
+        const IndexData* indexData = subMesh->indexData;
+        if (indexData && indexData->indexCount > 0 && !indexData->indexBuffer.isNull())
+        {
+            const HardwareIndexBufferSharedPtr& ibuf = indexData->indexBuffer;
+            HardwareBufferLockGuard<HardwareIndexBufferSharedPtr> lock(ibuf,
+                indexData->indexStart * ibuf->getIndexSize(),
+                indexData->indexCount * ibuf->getIndexSize(), HardwareBuffer::HBL_READ_ONLY);
+
+            indexes.resize(indexData->indexCount);
+            if (ibuf->getType() == HardwareIndexBuffer::IT_32BIT)
+            {
+                const uint32* src = static_cast<const uint32*>(lock.pData);
+                std::copy(src, src + indexData->indexCount, indexes.begin());
+            }
+            else
+            {
+                const uint16* src = static_cast<const uint16*>(lock.pData);
+                std::copy(src, src + indexData->indexCount, indexes.begin());
+            }
+        }
+        else
+        {
+            indexes.resize(vertexCount);
+            for (size_t i = 0; i < vertexCount; ++i)
+                indexes[i] = static_cast<uint32>(i);
+        }
+
+        if (indexes.size() < 3)
+            return;
+        size_t numTriangles = op == RenderOperation::OT_TRIANGLE_LIST ?
+            indexes.size() / 3 : indexes.size() - 2;
+        for (size_t t = 0; t < numTriangles; ++t)
+        {
+            uint32 v[3];
+            if (op == RenderOperation::OT_TRIANGLE_LIST)
+            {
+                v[0] = indexes[t * 3];
+                v[1] = indexes[t * 3 + 1];
+                v[2] = indexes[t * 3 + 2];
+            }
+            else if (op == RenderOperation::OT_TRIANGLE_STRIP)
+            {
+                // keep the winding of odd triangles consistent
+                v[0] = indexes[t];
+                v[1] = indexes[t + (t & 1 ? 2 : 1)];
+                v[2] = indexes[t + (t & 1 ? 1 : 2)];
+            }
+            else
+            {
+                v[0] = indexes[0];
+                v[1] = indexes[t + 1];
+                v[2] = indexes[t + 2];
+            }
+
+            // skip out of range and degenerate triangles, such as strip restarts
+            if (v[0] >= vertexCount || v[1] >= vertexCount || v[2] >= vertexCount ||
+                v[0] == v[1] || v[1] == v[2] || v[0] == v[2])
+                continue;
+
+            Triangle tri;
+            for (int i = 0; i < 3; ++i)
+                tri.vertices[i] = static_cast<uint32>(vertexOffset + v[i]);
+            tri.index = static_cast<uint32>(t);
+            tri.subMeshIndex = subMeshIndex;
+            mTriangles.push_back(tri);
+        }
+    }
+    //---------------------------------------------------------------------
+    void MeshTriangleBvh::build(BuildItem* items, uint32 first, uint32 count, size_t depth)
+    {
+        mDepth = std::max(mDepth, depth);
+        size_t index = mNodes.size();
+        mNodes.push_back(Node());
+        mBounds.push_back(Bounds());
+
+        Vector3 min = items[first].min, max = items[first].max;
+        Vector3 centreMin = items[first].centre, centreMax = items[first].centre;
+        for (uint32 i = first + 1; i < first + count; ++i)
+        {
+            min.makeFloor(items[i].min);
+            max.makeCeil(items[i].max);
+            centreMin.makeFloor(items[i].centre);
+            centreMax.makeCeil(items[i].centre);
+        }
+        mBounds[index].min = min;
+        mBounds[index].max = max;
+
+        // split along the largest extent of the centres
+        Vector3 extent = centreMax - centreMin;
+        int axis = 0;
+        if (extent.y > extent[axis])
+            axis = 1;
+        if (extent.z > extent[axis])
+            axis = 2;
+
+        uint32 split = 0;
+        if (count > MAX_LEAF_TRIANGLES && extent[axis] > 0)
+        {
+            Real scale = NUM_BINS * (1 - 1e-5f) / extent[axis];
+            size_t binCounts[NUM_BINS];
+            Vector3 binMin[NUM_BINS], binMax[NUM_BINS];
+            for (size_t b = 0; b < NUM_BINS; ++b)
+            {
+                binCounts[b] = 0;
+                binMin[b] = Vector3(Math::POS_INFINITY);
+                binMax[b] = Vector3(Math::NEG_INFINITY);
+            }
+            for (uint32 i = first; i < first + count; ++i)
+            {
+                size_t b = std::min(static_cast<size_t>((items[i].centre[axis] - centreMin[axis]) * scale),
+                    NUM_BINS - 1);
+                ++binCounts[b];
+                binMin[b].makeFloor(items[i].min);
+                binMax[b].makeCeil(items[i].max);
+            }
+
+            // area and count of the right side of each split, sweeping from the right
+            Real rightArea[NUM_BINS];
+            size_t rightCount[NUM_BINS];
+            Vector3 sweepMin(Math::POS_INFINITY), sweepMax(Math::NEG_INFINITY);
+            size_t n = 0;
+            for (size_t b = NUM_BINS - 1; b > 0; --b)
+            {
+                sweepMin.makeFloor(binMin[b]);
+                sweepMax.makeCeil(binMax[b]);
+                n += binCounts[b];
+                rightArea[b] = n ? halfArea(sweepMin, sweepMax) : 0;
+                rightCount[b] = n;
+            }
+
+            // sweep from the left, keeping the cheapest split if it beats a leaf
+            Real bestCost = count * halfArea(min, max);
+            size_t bestSplit = 0;
+            sweepMin = Vector3(Math::POS_INFINITY);
+            sweepMax = Vector3(Math::NEG_INFINITY);
+            n = 0;
+            for (size_t b = 1; b < NUM_BINS; ++b)
+            {
+                sweepMin.makeFloor(binMin[b - 1]);
+                sweepMax.makeCeil(binMax[b - 1]);
+                n += binCounts[b - 1];
+                if (n == 0 || rightCount[b] == 0)
+                    continue;
+
+                Real cost = n * halfArea(sweepMin, sweepMax) + rightCount[b] * rightArea[b];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestSplit = b;
+                }
+            }
+
+            if (bestSplit)
+            {
+                BuildItem* left = items + first;
+                BuildItem* right = items + first + count;
+                while (left < right)
+                {
+                    size_t b = std::min(static_cast<size_t>((left->centre[axis] - centreMin[axis]) * scale),
+                        NUM_BINS - 1);
+                    if (b < bestSplit)
+                        ++left;
+                    else
+                        std::swap(*left, *--right);
+                }
+                split = static_cast<uint32>(left - (items + first));
+            }
+        }
+
+        if (split == 0 || split == count)
+        {
+            // small enough, or too costly to split
+            mNodes[index].first = first;
+            mNodes[index].count = count;
+            return;
+        }
+
+        mNodes[index].count = 0;
+        build(items, first, split, depth + 1);
+        mNodes[index].first = static_cast<uint32>(mNodes.size());
+        build(items, first + split, count - split, depth + 1);
+    }
+    //---------------------------------------------------------------------
+    bool MeshTriangleBvh::intersectTriangle(const Ray& ray, const float* positions,
+        const Triangle& tri, Hit& hit) const
+    {
+        const float* p0 = positions + tri.vertices[0] * 3;
+        const float* p1 = positions + tri.vertices[1] * 3;
+        const float* p2 = positions + tri.vertices[2] * 3;
+        Vector3 a(p0[0], p0[1], p0[2]);
+        Vector3 e1 = Vector3(p1[0], p1[1], p1[2]) - a;
+        Vector3 e2 = Vector3(p2[0], p2[1], p2[2]) - a;
+
+        // Moller-Trumbore, hitting both faces
+        const Vector3& dir = ray.getDirection();
+        Vector3 p = dir.crossProduct(e2);
+        Real det = e1.dotProduct(p);
+        if (det == 0)
+            return false;
+        Real invDet = 1 / det;
+
+        Vector3 s = ray.getOrigin() - a;
+        Real u = s.dotProduct(p) * invDet;
+        if (u < 0 || u > 1)
+            return false;
+
+        Vector3 q = s.crossProduct(e1);
+        Real v = dir.dotProduct(q) * invDet;
+        if (v < 0 || u + v > 1)
+            return false;
+
+        Real t = e2.dotProduct(q) * invDet;
+        if (t < 0 || t >= hit.distance)
+            return false;
+
+        hit.distance = t;
+        hit.subMeshIndex = tri.subMeshIndex;
+        hit.triangleIndex = tri.index;
+        hit.u = u;
+        hit.v = v;
+        return true;
+    }
+    //---------------------------------------------------------------------
+    bool MeshTriangleBvh::intersects(const Ray& ray, Hit& hit) const
+    {
+        hit.distance = Math::POS_INFINITY;
+        if (mNodes.empty())
+            return false;
+        return intersectsTree(ray, &mPositions[0], &mBounds[0], hit);
+    }
+    //---------------------------------------------------------------------
+    bool MeshTriangleBvh::intersects(const Ray& ray, const Pose& pose, Hit& hit) const
+    {
+        hit.distance = Math::POS_INFINITY;
+        if (mNodes.empty() || pose.bounds.size() != mNodes.size())
+            return false;
+        return intersectsTree(ray, &pose.positions[0], &pose.bounds[0], hit);
+    }
+    //---------------------------------------------------------------------
+    bool MeshTriangleBvh::intersectsTree(const Ray& ray, const float* positions,
+        const Bounds* bounds, Hit& hit) const
+    {
+        const Vector3& origin = ray.getOrigin();
+        const Vector3& dir = ray.getDirection();
+        Vector3 invDirection(1 / dir.x, 1 / dir.y, 1 / dir.z);
+        bool found = false;
+
+        // a walk never holds more than one node per level
+        uint32 localStack[64];
+        vector<uint32>::type heapStack;
+        uint32* stack = localStack;
+        if (mDepth >= sizeof(localStack) / sizeof(localStack[0]))
+        {
+            heapStack.resize(mDepth + 1);
+            stack = &heapStack[0];
+        }
+
+        Real entry;
+        if (!intersectsBox(origin, invDirection, bounds[0].min, bounds[0].max, hit.distance, entry))
+            return false;
+        size_t stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize)
+        {
+            uint32 index = stack[--stackSize];
+            const Node& node = mNodes[index];
+            if (node.count)
+            {
+                for (uint32 t = node.first; t < node.first + node.count; ++t)
+                    found |= intersectTriangle(ray, positions, mTriangles[t], hit);
+                continue;
+            }
+
+            // visit the nearer child first, skipping those beyond the nearest hit
+            uint32 children[2] = { index + 1, node.first };
+            Real entries[2];
+            bool hits[2];
+            for (int c = 0; c < 2; ++c)
+            {
+                const Bounds& child = bounds[children[c]];
+                hits[c] = intersectsBox(origin, invDirection, child.min, child.max,
+                    hit.distance, entries[c]);
+            }
+            if (hits[0] && hits[1] && entries[1] < entries[0])
+            {
+                std::swap(children[0], children[1]);
+                std::swap(hits[0], hits[1]);
+            }
+            if (hits[1])
+                stack[stackSize++] = children[1];
+            if (hits[0])
+                stack[stackSize++] = children[0];
+        }
+
+        return found;
+    }
+    //---------------------------------------------------------------------
+    bool MeshTriangleBvh::intersects(const Ray& ray, const float* positions, Hit& hit) const
+    {
+        hit.distance = Math::POS_INFINITY;
+        bool found = false;
+        for (TriangleList::const_iterator t = mTriangles.begin(); t != mTriangles.end(); ++t)
+            found |= intersectTriangle(ray, positions, *t, hit);
+        return found;
+    }
+    //---------------------------------------------------------------------
+    void MeshTriangleBvh::skinPositions(const Mesh* mesh, const Matrix4* boneMatrices,
+        vector<float>::type& positions) const
+    {
+        positions = mPositions;
+        if (positions.empty())
+            return;
+
+        const Matrix4* blendMatrices[256];
+        Mesh::VertexBlendLockMap locks;
+        for (unsigned short i = 0; i <= mesh->getNumSubMeshes(); ++i)
+        {
+            // the shared vertex data, then that of each submesh which has its own
+            const VertexData* vertexData;
+            const Mesh::IndexMap* indexMap;
+            if (i == 0)
+            {
+                vertexData = mesh->sharedVertexData;
+                indexMap = &mesh->sharedBlendIndexToBoneIndexMap;
+            }
+            else
+            {
+                const SubMesh* sub = mesh->getSubMesh(i - 1);
+                vertexData = sub->useSharedVertices ? 0 : sub->vertexData;
+                indexMap = &sub->blendIndexToBoneIndexMap;
+            }
+            if (!vertexData || vertexData->vertexCount == 0 || indexMap->empty())
+                continue;
+
+            const VertexDeclaration* decl = vertexData->vertexDeclaration;
+            const VertexElement* posElem = decl->findElementBySemantic(VES_POSITION);
+            const VertexElement* idxElem = decl->findElementBySemantic(VES_BLEND_INDICES);
+            const VertexElement* weightElem = decl->findElementBySemantic(VES_BLEND_WEIGHTS);
+            if (!posElem || !idxElem || !weightElem)
+                continue;
+
+            Mesh::prepareMatricesForVertexBlend(blendMatrices, boneMatrices, *indexMap);
+            OptimisedUtil::getImplementation()->softwareVertexSkinning(
+                reinterpret_cast<const float*>(lockForReading(vertexData, posElem, locks)),
+                &positions[mVertexOffsets[i] * 3],
+                0, 0,
+                reinterpret_cast<const float*>(lockForReading(vertexData, weightElem, locks)),
+                lockForReading(vertexData, idxElem, locks),
+                blendMatrices,
+                getVertexSize(vertexData, posElem), sizeof(float) * 3,
+                0, 0,
+                getVertexSize(vertexData, weightElem), getVertexSize(vertexData, idxElem),
+                VertexElement::getTypeCount(weightElem->getType()),
+                vertexData->vertexCount);
+        }
+        Mesh::_unlockForSoftwareVertexBlend(locks);
+    }
+    //---------------------------------------------------------------------
+    void MeshTriangleBvh::refit(Pose& pose) const
+    {
+        // a pose of another mesh is never walked
+        if (pose.positions.size() != mPositions.size())
+        {
+            pose.bounds.clear();
+            return;
+        }
+        pose.bounds.resize(mNodes.size());
+
+        // children come after their parent, so walking backwards visits them first
+        const float* positions = &pose.positions[0];
+        for (size_t index = mNodes.size(); index-- > 0;)
+        {
+            const Node& node = mNodes[index];
+            Bounds& bounds = pose.bounds[index];
+            if (node.count)
+            {
+                bounds.min = Vector3(Math::POS_INFINITY);
+                bounds.max = Vector3(Math::NEG_INFINITY);
+                for (uint32 t = node.first; t < node.first + node.count; ++t)
+                {
+                    for (int v = 0; v < 3; ++v)
+                    {
+                        const float* p = positions + mTriangles[t].vertices[v] * 3;
+                        Vector3 pos(p[0], p[1], p[2]);
+                        bounds.min.makeFloor(pos);
+                        bounds.max.makeCeil(pos);
+                    }
+                }
+            }
+            else
+            {
+                const Bounds& left = pose.bounds[index + 1];
+                const Bounds& right = pose.bounds[node.first];
+                bounds.min = left.min;
+                bounds.min.makeFloor(right.min);
+                bounds.max = left.max;
+                bounds.max.makeCeil(right.max);
+            }
+        }
+    }
+}
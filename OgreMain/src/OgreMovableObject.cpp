@@ -66,6 +66,7 @@ namespace Ogre {
         , mListener(0)
         , mLightListUpdated(0)
         , mLightMask(0xFFFFFFFF)
+        , mRenderQueueEntryCache(0)
     {
         if (Root::getSingletonPtr())
             mMinPixelSize = Root::getSingleton().getDefaultMinPixelSize();
@@ -94,6 +95,7 @@ namespace Ogre {
         , mListener(0)
         , mLightListUpdated(0)
         , mLightMask(0xFFFFFFFF)
+        , mRenderQueueEntryCache(0)
     {
         if (Root::getSingletonPtr())
             mMinPixelSize = Root::getSingleton().getDefaultMinPixelSize();
@@ -123,6 +125,15 @@ namespace Ogre {
                 static_cast<SceneNode*>(mParentNode)->detachObject(this);
             }
         }
+
+        OGRE_DELETE mRenderQueueEntryCache;
+    }
+    //-----------------------------------------------------------------------
+    RenderQueueEntryCache* MovableObject::_getRenderQueueEntryCache(void)
+    {
+        if (!mRenderQueueEntryCache)
+            mRenderQueueEntryCache = OGRE_NEW RenderQueueEntryCache();
+        return mRenderQueueEntryCache;
     }
     //-----------------------------------------------------------------------
     void MovableObject::_notifyAttached(Node* parent, bool isTagPoint)
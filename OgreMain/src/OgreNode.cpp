@@ -248,6 +248,58 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    bool Node::_updateAndCollectChildren(bool parentHasChanged, NodeList& children)
+    {
+        if (mNeedParentUpdate || parentHasChanged)
+        {
+            _updateFromParent();
+        }
+
+        return _collectChildrenToUpdate(parentHasChanged, children);
+    }
+    //-----------------------------------------------------------------------
+    bool Node::_collectChildrenToUpdate(bool parentHasChanged, NodeList& children)
+    {
+        mParentNotified = false;
+
+        bool childParentHasChanged = mNeedChildUpdate || parentHasChanged;
+        if (childParentHasChanged)
+        {
+            ChildNodeMap::iterator it, itend;
+            itend = mChildren.end();
+            for (it = mChildren.begin(); it != itend; ++it)
+            {
+                children.push_back(it->second);
+            }
+        }
+        else
+        {
+            children.insert(children.end(), mChildrenToUpdate.begin(), mChildrenToUpdate.end());
+        }
+
+        mChildrenToUpdate.clear();
+        mNeedChildUpdate = false;
+
+        return childParentHasChanged;
+    }
+    //-----------------------------------------------------------------------
+    void Node::_setDerivedTransform(const Vector3& position, const Quaternion& orientation,
+        const Vector3& scale)
+    {
+        mDerivedPosition = position;
+        mDerivedOrientation = orientation;
+        mDerivedScale = scale;
+        mCachedTransformOutOfDate = true;
+        mNeedParentUpdate = false;
+
+        derivedTransformUpdated();
+
+        if (mListener)
+        {
+            mListener->nodeUpdated(this);
+        }
+    }
+    //-----------------------------------------------------------------------
     void Node::_updateFromParent(void) const
     {
         updateFromParentImpl();
@@ -313,6 +365,7 @@ namespace Ogre {
 
         mNeedParentUpdate = false;
 
+        derivedTransformUpdated();
     }
     //-----------------------------------------------------------------------
     Node* Node::createChild(const Vector3& inTranslate, const Quaternion& inRotate)
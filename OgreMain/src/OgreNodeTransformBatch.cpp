@@ -0,0 +1,147 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreNodeTransformBatch.h"
+
+#include "OgreNode.h"
+#include "OgreOptimisedUtil.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        /// Copies a transform into the given lane of a block
+        void packTransform(float* block, size_t lane, const Vector3& position,
+            const Quaternion& orientation, const Vector3& scale)
+        {
+            float* p = block + lane;
+            p[0] = position.x; p[4] = position.y; p[8] = position.z;
+            p[12] = orientation.w; p[16] = orientation.x;
+            p[20] = orientation.y; p[24] = orientation.z;
+            p[28] = scale.x; p[32] = scale.y; p[36] = scale.z;
+        }
+    }
+    //-----------------------------------------------------------------------
+    NodeTransformBatch::NodeTransformBatch()
+        : mCapacity(0)
+        , mParentTransforms(0)
+        , mLocalTransforms(0)
+        , mDerivedTransforms(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    NodeTransformBatch::~NodeTransformBatch()
+    {
+        OGRE_FREE_SIMD(mParentTransforms, MEMCATEGORY_SCENE_CONTROL);
+        OGRE_FREE_SIMD(mLocalTransforms, MEMCATEGORY_SCENE_CONTROL);
+        OGRE_FREE_SIMD(mDerivedTransforms, MEMCATEGORY_SCENE_CONTROL);
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformBatch::reserve(size_t numBlocks)
+    {
+        if (numBlocks <= mCapacity)
+            return;
+
+        size_t capacity = std::max(numBlocks, mCapacity * 2);
+        size_t bytes = capacity * FLOATS_PER_BLOCK * sizeof(float);
+        size_t usedBytes = mCapacity * FLOATS_PER_BLOCK * sizeof(float);
+
+        float* parent = static_cast<float*>(OGRE_MALLOC_SIMD(bytes, MEMCATEGORY_SCENE_CONTROL));
+        float* local = static_cast<float*>(OGRE_MALLOC_SIMD(bytes, MEMCATEGORY_SCENE_CONTROL));
+        float* derived = static_cast<float*>(OGRE_MALLOC_SIMD(bytes, MEMCATEGORY_SCENE_CONTROL));
+        if (usedBytes)
+        {
+            memcpy(parent, mParentTransforms, usedBytes);
+            memcpy(local, mLocalTransforms, usedBytes);
+        }
+
+        OGRE_FREE_SIMD(mParentTransforms, MEMCATEGORY_SCENE_CONTROL);
+        OGRE_FREE_SIMD(mLocalTransforms, MEMCATEGORY_SCENE_CONTROL);
+        OGRE_FREE_SIMD(mDerivedTransforms, MEMCATEGORY_SCENE_CONTROL);
+
+        mParentTransforms = parent;
+        mLocalTransforms = local;
+        mDerivedTransforms = derived;
+        mCapacity = capacity;
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformBatch::addNode(Node* node)
+    {
+        assert(node->_canConcatenateTransforms() && 
+            "Node transform cannot be calculated by concatenation");
+
+        size_t block = mNodes.size() / NODES_PER_BLOCK;
+        size_t lane = mNodes.size() % NODES_PER_BLOCK;
+        reserve(block + 1);
+
+        float* parentBlock = mParentTransforms + block * FLOATS_PER_BLOCK;
+        float* localBlock = mLocalTransforms + block * FLOATS_PER_BLOCK;
+        if (lane == 0)
+        {
+            // Fill unused lanes of the last block with identity transforms
+            for (size_t i = 1; i < NODES_PER_BLOCK; ++i)
+            {
+                packTransform(parentBlock, i, Vector3::ZERO, Quaternion::IDENTITY, Vector3::UNIT_SCALE);
+                packTransform(localBlock, i, Vector3::ZERO, Quaternion::IDENTITY, Vector3::UNIT_SCALE);
+            }
+        }
+
+        Node* parent = node->getParent();
+        packTransform(parentBlock, lane, parent->_getDerivedPosition(),
+            parent->_getDerivedOrientation(), parent->_getDerivedScale());
+        packTransform(localBlock, lane, node->getPosition(),
+            node->getOrientation(), node->getScale());
+
+        mNodes.push_back(node);
+    }
+    //-----------------------------------------------------------------------
+    void NodeTransformBatch::update(size_t firstBlock, size_t numBlocks)
+    {
+        assert(firstBlock + numBlocks <= getNumBlocks());
+
+        size_t offset = firstBlock * FLOATS_PER_BLOCK;
+        OptimisedUtil::getImplementation()->concatenateNodeTransforms(
+            mParentTransforms + offset,
+            mLocalTransforms + offset,
+            mDerivedTransforms + offset,
+            numBlocks);
+
+        size_t first = firstBlock * NODES_PER_BLOCK;
+        size_t last = std::min(first + numBlocks * NODES_PER_BLOCK, mNodes.size());
+        for (size_t n = first; n < last; ++n)
+        {
+            const float* d = mDerivedTransforms + 
+                (n / NODES_PER_BLOCK) * FLOATS_PER_BLOCK + (n % NODES_PER_BLOCK);
+            mNodes[n]->_setDerivedTransform(
+                Vector3(d[0], d[4], d[8]),
+                Quaternion(d[12], d[16], d[20], d[24]),
+                Vector3(d[28], d[32], d[36]));
+        }
+    }
+
+}
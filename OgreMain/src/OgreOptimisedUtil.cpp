@@ -43,6 +43,9 @@ namespace Ogre {
     extern OptimisedUtil* _getOptimisedUtilGeneral(void);
 #if __OGRE_HAVE_SSE
     extern OptimisedUtil* _getOptimisedUtilSSE(void);
+#if __OGRE_HAVE_AVX2
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void);
+#endif
 //#elif __OGRE_HAVE_NEON
 //    extern OptimisedUtil* _getOptimisedUtilNEON(void);
 //#elif __OGRE_HAVE_VFP
@@ -86,6 +89,9 @@ namespace Ogre {
             IMPL_DEFAULT,
 #if __OGRE_HAVE_SSE
             IMPL_SSE,
+#if __OGRE_HAVE_AVX2
+            IMPL_AVX2,
+#endif
 //#elif __OGRE_HAVE_NEON
 //            IMPL_NEON,
 //#elif __OGRE_HAVE_VFP
@@ -137,6 +143,12 @@ namespace Ogre {
             {
                 mOptimisedUtils.push_back(_getOptimisedUtilSSE());
             }
+#if __OGRE_HAVE_AVX2
+            if (_getImplementation(OptimisedUtil::IMPL_AVX2))
+            {
+                mOptimisedUtils.push_back(_getOptimisedUtilAVX2());
+            }
+#endif
 //#elif __OGRE_HAVE_VFP
 //            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_VFP)
 //            {
@@ -348,6 +360,85 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        virtual void concatenateNodeTransforms(
+            const float* parentTransforms,
+            const float* localTransforms,
+            float* derivedTransforms,
+            size_t numBlocks)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->concatenateNodeTransforms(
+                parentTransforms,
+                localTransforms,
+                derivedTransforms,
+                numBlocks);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void cullBoxes(
+            const float* planes,
+            size_t numPlanes,
+            const float* boxes,
+            size_t numBlocks,
+            uint8* visibleMasks)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->cullBoxes(
+                planes,
+                numPlanes,
+                boxes,
+                numBlocks,
+                visibleMasks);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void interpolateNodeTransforms(
+            const float* weights,
+            const float* srcTransforms1,
+            const float* srcTransforms2,
+            float* dstTransforms,
+            size_t numBlocks)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->interpolateNodeTransforms(
+                weights,
+                srcTransforms1,
+                srcTransforms2,
+                dstTransforms,
+                numBlocks);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
     };
 #endif // __DO_PROFILE__
 
@@ -401,6 +492,13 @@ namespace Ogre {
 
 #else   // !__DO_PROFILE__
 
+#if __OGRE_HAVE_AVX2
+        if (OptimisedUtil* avx2 = _getImplementation(IMPL_AVX2))
+        {
+            return avx2;
+        }
+        else
+#endif  // __OGRE_HAVE_AVX2
 #if __OGRE_HAVE_SSE
         if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
         {
@@ -430,5 +528,37 @@ namespace Ogre {
 
 #endif  // __DO_PROFILE__
     }
+    //---------------------------------------------------------------------
+    OptimisedUtil* OptimisedUtil::_getImplementation(ImplementationType type)
+    {
+        uint features = PlatformInformation::getCpuFeatures();
+        (void)features;
+
+        switch (type)
+        {
+        case IMPL_GENERAL:
+            return _getOptimisedUtilGeneral();
+        case IMPL_SSE:
+#if __OGRE_HAVE_SSE
+            if (features & PlatformInformation::CPU_FEATURE_SSE)
+                return _getOptimisedUtilSSE();
+#endif
+            break;
+        case IMPL_AVX2:
+#if __OGRE_HAVE_AVX2
+            {
+                const uint avx2Features = PlatformInformation::CPU_FEATURE_SSE |
+                    PlatformInformation::CPU_FEATURE_AVX |
+                    PlatformInformation::CPU_FEATURE_AVX2 |
+                    PlatformInformation::CPU_FEATURE_FMA;
+                if ((features & avx2Features) == avx2Features)
+                    return _getOptimisedUtilAVX2();
+            }
+#endif
+            break;
+        }
+
+        return 0;
+    }
 
 }
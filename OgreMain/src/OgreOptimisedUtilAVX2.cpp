@@ -0,0 +1,769 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreOptimisedUtil.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_AVX2
+
+#include "OgreMatrix4.h"
+#include "OgreVector3.h"
+#include "OgreVector4.h"
+#include "OgreMath.h"
+
+// Should keep this includes at latest to avoid potential "xmmintrin.h" included by
+// other header file on some platform for some reason.
+#include "OgreSIMDHelper.h"
+#include <immintrin.h>
+
+//-------------------------------------------------------------------------
+//
+// Unlike the SSE implementation, this file isn't compiled with the
+// instruction set enabled for the whole file: only the functions below
+// are, so that nothing from the headers included above is compiled to
+// AVX and picked by the linker for other files. Every function using
+// the intrinsics, including the inlined helpers, must be marked with
+// __OGRE_AVX2_TARGET.
+//
+// The routines process 8 floats per register: vertices are either
+// loaded two at a time, one per 128-bit half, or eight at a time as
+// structure-of-arrays. Results differ from the SSE and general versions
+// by rounding only, since fused multiply-add skips the intermediate
+// rounding of the product.
+//
+//-------------------------------------------------------------------------
+
+#if OGRE_COMPILER == OGRE_COMPILER_MSVC
+#   define __OGRE_AVX2_TARGET
+#else
+#   define __OGRE_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+
+namespace Ogre {
+
+    extern OptimisedUtil* _getOptimisedUtilSSE(void);
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** AVX2 implementation of OptimisedUtil.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilAVX2 : public OptimisedUtil
+    {
+    protected:
+        /// The SSE implementation, for the functions that work on blocks of 4
+        OptimisedUtil* mSSE;
+
+    public:
+        /// Constructor
+        OptimisedUtilAVX2(void);
+
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Matrix4* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET softwareVertexMorph(
+            Real t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize, 
+            size_t numVertices,
+            bool morphNormals);
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET concatenateAffineMatrices(
+            const Matrix4& baseMatrix,
+            const Matrix4* srcMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices);
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles);
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces);
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::concatenateNodeTransforms
+        virtual void concatenateNodeTransforms(
+            const float* parentTransforms,
+            const float* localTransforms,
+            float* derivedTransforms,
+            size_t numBlocks);
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        virtual void cullBoxes(
+            const float* planes,
+            size_t numPlanes,
+            const float* boxes,
+            size_t numBlocks,
+            uint8* visibleMasks);
+
+        /// @copydoc OptimisedUtil::interpolateNodeTransforms
+        virtual void interpolateNodeTransforms(
+            const float* weights,
+            const float* srcTransforms1,
+            const float* srcTransforms2,
+            float* dstTransforms,
+            size_t numBlocks);
+    };
+
+//---------------------------------------------------------------------
+// Helpers, inlined in the implementation below
+//---------------------------------------------------------------------
+
+    /// Loads x, y, z without reading past them, w is zero
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m128 __mm_load3_ps(const float* p)
+    {
+        return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p))),
+            _mm_load_ss(p + 2));
+    }
+    //---------------------------------------------------------------------
+    /// Stores x, y, z without writing past them
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void __mm_store3_ps(float* p, __m128 v)
+    {
+        _mm_store_sd(reinterpret_cast<double*>(p), _mm_castps_pd(v));
+        _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+    }
+    //---------------------------------------------------------------------
+    /// Puts lo in the lower and hi in the upper 128 bits
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m256 __mm256_combine_ps(__m128 lo, __m128 hi)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+    }
+    //---------------------------------------------------------------------
+    /// Transposes the 4x4 matrices held in the lower and upper halves of the rows at once
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void __mm256_transpose4x4_ps(
+        __m256& r0, __m256& r1, __m256& r2, __m256& r3)
+    {
+        __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+        __m256 t1 = _mm256_unpacklo_ps(r2, r3);
+        __m256 t2 = _mm256_unpackhi_ps(r0, r1);
+        __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+        r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+        r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+        r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    //---------------------------------------------------------------------
+    /// Normalises the xyz vectors in each half, leaving those too short to normalise unchanged
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m256 __mm256_normalise3_ps(__m256 v)
+    {
+        // Same threshold as Vector3::normalise
+        __m256 len = _mm256_sqrt_ps(_mm256_dp_ps(v, v, 0x7F));
+        __m256 valid = _mm256_cmp_ps(len, _mm256_set1_ps(1e-08f), _CMP_GT_OQ);
+        return _mm256_blendv_ps(v, _mm256_div_ps(v, len), valid);
+    }
+    //---------------------------------------------------------------------
+    /** Splits 8 packed xyz vectors, held in a, b and c, into a register per
+        component.
+    */
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void __mm256_deinterleave3_ps(
+        __m256 a, __m256 b, __m256 c, __m256& x, __m256& y, __m256& z)
+    {
+        // a = x0 y0 z0 x1 y1 z1 x2 y2
+        // b = z2 x3 y3 z3 x4 y4 z4 x5
+        // c = y5 z5 x6 y6 z6 x7 y7 z7
+        __m256 tx = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x92), c, 0x24);
+        __m256 ty = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x24), c, 0x49);
+        __m256 tz = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x49), c, 0x92);
+        x = _mm256_permutevar8x32_ps(tx, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+        y = _mm256_permutevar8x32_ps(ty, _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6));
+        z = _mm256_permutevar8x32_ps(tz, _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+    }
+    //---------------------------------------------------------------------
+    /// The reverse of __mm256_deinterleave3_ps
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void __mm256_interleave3_ps(
+        __m256 x, __m256 y, __m256 z, __m256& a, __m256& b, __m256& c)
+    {
+        __m256 tx = _mm256_permutevar8x32_ps(x, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+        __m256 ty = _mm256_permutevar8x32_ps(y, _mm256_setr_epi32(5, 0, 3, 6, 1, 4, 7, 2));
+        __m256 tz = _mm256_permutevar8x32_ps(z, _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+        a = _mm256_blend_ps(_mm256_blend_ps(tx, ty, 0x92), tz, 0x24);
+        b = _mm256_blend_ps(_mm256_blend_ps(tx, ty, 0x24), tz, 0x49);
+        c = _mm256_blend_ps(_mm256_blend_ps(tx, ty, 0x49), tz, 0x92);
+    }
+    //---------------------------------------------------------------------
+    /** Loads the given corner of 8 triangles into a register per component.
+    */
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void __mm256_load_corners_ps(
+        const float* positions, const EdgeData::Triangle* triangles, size_t corner,
+        __m256& x, __m256& y, __m256& z)
+    {
+        // Triangles i and i + 4 share a row, so the transpose puts them in order
+        __m256 r0 = __mm256_combine_ps(
+            __mm_load3_ps(positions + triangles[0].vertIndex[corner] * 3),
+            __mm_load3_ps(positions + triangles[4].vertIndex[corner] * 3));
+        __m256 r1 = __mm256_combine_ps(
+            __mm_load3_ps(positions + triangles[1].vertIndex[corner] * 3),
+            __mm_load3_ps(positions + triangles[5].vertIndex[corner] * 3));
+        __m256 r2 = __mm256_combine_ps(
+            __mm_load3_ps(positions + triangles[2].vertIndex[corner] * 3),
+            __mm_load3_ps(positions + triangles[6].vertIndex[corner] * 3));
+        __m256 r3 = __mm256_combine_ps(
+            __mm_load3_ps(positions + triangles[3].vertIndex[corner] * 3),
+            __mm_load3_ps(positions + triangles[7].vertIndex[corner] * 3));
+        __mm256_transpose4x4_ps(r0, r1, r2, r3);
+        x = r0;
+        y = r1;
+        z = r2;
+    }
+    //---------------------------------------------------------------------
+    /** Blends two vertices, one per half of the registers. If the second
+        vertex's destination pointers are null it's blended but not stored.
+    */
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void softwareVertexSkinning_AVX2_Pair(
+        const float *pSrcPos0, const float *pSrcPos1,
+        float *pDestPos0, float *pDestPos1,
+        const float *pSrcNorm0, const float *pSrcNorm1,
+        float *pDestNorm0, float *pDestNorm1,
+        const float *pBlendWeight0, const float *pBlendWeight1,
+        const unsigned char* pBlendIndex0, const unsigned char* pBlendIndex1,
+        const Matrix4* const* blendMatrices,
+        size_t numWeightsPerVertex)
+    {
+        // Blend the matrices first, the rows of both vertices side by side
+        __m256 r0 = _mm256_setzero_ps();
+        __m256 r1 = _mm256_setzero_ps();
+        __m256 r2 = _mm256_setzero_ps();
+        for (size_t i = 0; i < numWeightsPerVertex; ++i)
+        {
+            const float* m0 = (*blendMatrices[pBlendIndex0[i]])[0];
+            const float* m1 = (*blendMatrices[pBlendIndex1[i]])[0];
+            __m256 weight = __mm256_combine_ps(
+                _mm_set1_ps(pBlendWeight0[i]), _mm_set1_ps(pBlendWeight1[i]));
+
+            r0 = _mm256_fmadd_ps(__mm256_combine_ps(_mm_loadu_ps(m0 + 0), _mm_loadu_ps(m1 + 0)), weight, r0);
+            r1 = _mm256_fmadd_ps(__mm256_combine_ps(_mm_loadu_ps(m0 + 4), _mm_loadu_ps(m1 + 4)), weight, r1);
+            r2 = _mm256_fmadd_ps(__mm256_combine_ps(_mm_loadu_ps(m0 + 8), _mm_loadu_ps(m1 + 8)), weight, r2);
+        }
+
+        // Columns of the blended matrices, the last row is zero so is the w
+        __m256 r3 = _mm256_setzero_ps();
+        __mm256_transpose4x4_ps(r0, r1, r2, r3);
+
+        __m256 pos = __mm256_combine_ps(__mm_load3_ps(pSrcPos0), __mm_load3_ps(pSrcPos1));
+        pos = _mm256_fmadd_ps(r0, _mm256_permute_ps(pos, 0x00),
+              _mm256_fmadd_ps(r1, _mm256_permute_ps(pos, 0x55),
+              _mm256_fmadd_ps(r2, _mm256_permute_ps(pos, 0xAA), r3)));
+        __mm_store3_ps(pDestPos0, _mm256_castps256_ps128(pos));
+        if (pDestPos1)
+            __mm_store3_ps(pDestPos1, _mm256_extractf128_ps(pos, 1));
+
+        if (pSrcNorm0)
+        {
+            // Rotational part only, as the general version
+            __m256 norm = __mm256_combine_ps(__mm_load3_ps(pSrcNorm0), __mm_load3_ps(pSrcNorm1));
+            norm = _mm256_fmadd_ps(r0, _mm256_permute_ps(norm, 0x00),
+                   _mm256_fmadd_ps(r1, _mm256_permute_ps(norm, 0x55),
+                   _mm256_mul_ps(r2, _mm256_permute_ps(norm, 0xAA))));
+            norm = __mm256_normalise3_ps(norm);
+            __mm_store3_ps(pDestNorm0, _mm256_castps256_ps128(norm));
+            if (pDestNorm1)
+                __mm_store3_ps(pDestNorm1, _mm256_extractf128_ps(norm, 1));
+        }
+    }
+    //---------------------------------------------------------------------
+    /** Morphs two vertices, one per half of the registers. If the second
+        vertex's destination pointer is null it's morphed but not stored.
+    */
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void softwareVertexMorph_AVX2_Pair(
+        __m256 t,
+        const float *pSrc1_0, const float *pSrc1_1,
+        const float *pSrc2_0, const float *pSrc2_1,
+        float *pDst0, float *pDst1,
+        bool morphNormals)
+    {
+        __m256 src1 = __mm256_combine_ps(__mm_load3_ps(pSrc1_0), __mm_load3_ps(pSrc1_1));
+        __m256 src2 = __mm256_combine_ps(__mm_load3_ps(pSrc2_0), __mm_load3_ps(pSrc2_1));
+        __m256 pos = _mm256_fmadd_ps(t, _mm256_sub_ps(src2, src1), src1);
+        __mm_store3_ps(pDst0, _mm256_castps256_ps128(pos));
+        if (pDst1)
+            __mm_store3_ps(pDst1, _mm256_extractf128_ps(pos, 1));
+
+        if (morphNormals)
+        {
+            // Normals must be in the same buffer as positions, perform an nlerp
+            src1 = __mm256_combine_ps(__mm_load3_ps(pSrc1_0 + 3), __mm_load3_ps(pSrc1_1 + 3));
+            src2 = __mm256_combine_ps(__mm_load3_ps(pSrc2_0 + 3), __mm_load3_ps(pSrc2_1 + 3));
+            __m256 norm = __mm256_normalise3_ps(
+                _mm256_fmadd_ps(t, _mm256_sub_ps(src2, src1), src1));
+            __mm_store3_ps(pDst0 + 3, _mm256_castps256_ps128(norm));
+            if (pDst1)
+                __mm_store3_ps(pDst1 + 3, _mm256_extractf128_ps(norm, 1));
+        }
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    OptimisedUtilAVX2::OptimisedUtilAVX2(void)
+        : mSSE(_getOptimisedUtilSSE())
+    {
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Matrix4* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        // Two vertices per iteration, works for any stride so there is no
+        // need for separate shared/separate buffer versions
+        for (; numVertices >= 2; numVertices -= 2)
+        {
+            softwareVertexSkinning_AVX2_Pair(
+                pSrcPos, rawOffsetPointer(pSrcPos, srcPosStride),
+                pDestPos, rawOffsetPointer(pDestPos, destPosStride),
+                pSrcNorm, pSrcNorm ? rawOffsetPointer(pSrcNorm, srcNormStride) : 0,
+                pDestNorm, pSrcNorm ? rawOffsetPointer(pDestNorm, destNormStride) : 0,
+                pBlendWeight, rawOffsetPointer(pBlendWeight, blendWeightStride),
+                pBlendIndex, rawOffsetPointer(pBlendIndex, blendIndexStride),
+                blendMatrices,
+                numWeightsPerVertex);
+
+            advanceRawPointer(pSrcPos, 2 * srcPosStride);
+            advanceRawPointer(pDestPos, 2 * destPosStride);
+            if (pSrcNorm)
+            {
+                advanceRawPointer(pSrcNorm, 2 * srcNormStride);
+                advanceRawPointer(pDestNorm, 2 * destNormStride);
+            }
+            advanceRawPointer(pBlendWeight, 2 * blendWeightStride);
+            advanceRawPointer(pBlendIndex, 2 * blendIndexStride);
+        }
+
+        // The last vertex goes in both halves
+        if (numVertices)
+        {
+            softwareVertexSkinning_AVX2_Pair(
+                pSrcPos, pSrcPos,
+                pDestPos, 0,
+                pSrcNorm, pSrcNorm,
+                pDestNorm, 0,
+                pBlendWeight, pBlendWeight,
+                pBlendIndex, pBlendIndex,
+                blendMatrices,
+                numWeightsPerVertex);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::softwareVertexMorph(
+        Real t,
+        const float *pSrc1, const float *pSrc2,
+        float *pDst,
+        size_t pos1VSize, size_t pos2VSize, size_t dstVSize, 
+        size_t numVertices,
+        bool morphNormals)
+    {
+        __m256 t8 = _mm256_set1_ps(t);
+
+        if (!morphNormals &&
+            pos1VSize == sizeof(float) * 3 && pos2VSize == sizeof(float) * 3 && dstVSize == sizeof(float) * 3)
+        {
+            // All buffers are packed positions, so morph them as a stream of floats
+            size_t numFloats = numVertices * 3;
+            for (; numFloats >= 8; numFloats -= 8)
+            {
+                __m256 src1 = _mm256_loadu_ps(pSrc1);
+                __m256 src2 = _mm256_loadu_ps(pSrc2);
+                _mm256_storeu_ps(pDst, _mm256_fmadd_ps(t8, _mm256_sub_ps(src2, src1), src1));
+
+                pSrc1 += 8;
+                pSrc2 += 8;
+                pDst += 8;
+            }
+
+            for (; numFloats; --numFloats)
+            {
+                *pDst++ = *pSrc1 + t * (*pSrc2 - *pSrc1);
+                ++pSrc1; ++pSrc2;
+            }
+            return;
+        }
+
+        for (; numVertices >= 2; numVertices -= 2)
+        {
+            softwareVertexMorph_AVX2_Pair(t8,
+                pSrc1, rawOffsetPointer(pSrc1, pos1VSize),
+                pSrc2, rawOffsetPointer(pSrc2, pos2VSize),
+                pDst, rawOffsetPointer(pDst, dstVSize),
+                morphNormals);
+
+            advanceRawPointer(pSrc1, 2 * pos1VSize);
+            advanceRawPointer(pSrc2, 2 * pos2VSize);
+            advanceRawPointer(pDst, 2 * dstVSize);
+        }
+
+        // The last vertex goes in both halves
+        if (numVertices)
+        {
+            softwareVertexMorph_AVX2_Pair(t8,
+                pSrc1, pSrc1,
+                pSrc2, pSrc2,
+                pDst, 0,
+                morphNormals);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::concatenateAffineMatrices(
+        const Matrix4& baseMatrix,
+        const Matrix4* pSrcMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        const Matrix4& m = baseMatrix;
+
+        // Rows 0 and 1 of the result are calculated together, as are rows 2
+        // and 3: each is a sum of the source rows weighted by the base matrix
+        __m256 a0 = __mm256_combine_ps(_mm_set1_ps(m[0][0]), _mm_set1_ps(m[1][0]));
+        __m256 a1 = __mm256_combine_ps(_mm_set1_ps(m[0][1]), _mm_set1_ps(m[1][1]));
+        __m256 a2 = __mm256_combine_ps(_mm_set1_ps(m[0][2]), _mm_set1_ps(m[1][2]));
+        __m256 a3 = __mm256_combine_ps(_mm_set1_ps(m[0][3]), _mm_set1_ps(m[1][3]));
+        __m256 b0 = __mm256_combine_ps(_mm_set1_ps(m[2][0]), _mm_setzero_ps());
+        __m256 b1 = __mm256_combine_ps(_mm_set1_ps(m[2][1]), _mm_setzero_ps());
+        __m256 b2 = __mm256_combine_ps(_mm_set1_ps(m[2][2]), _mm_setzero_ps());
+        __m256 b3 = __mm256_combine_ps(_mm_set1_ps(m[2][3]), _mm_setzero_ps());
+        // The implicit last row of both matrices
+        __m256 unitW = _mm256_setr_ps(0, 0, 0, 1, 0, 0, 0, 1);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const float* s = (*pSrcMat)[0];
+            float* d = (*pDstMat)[0];
+
+            __m256 s0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(s + 0));
+            __m256 s1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(s + 4));
+            __m256 s2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(s + 8));
+
+            __m256 d01 = _mm256_fmadd_ps(a0, s0, _mm256_fmadd_ps(a1, s1,
+                         _mm256_fmadd_ps(a2, s2, _mm256_mul_ps(a3, unitW))));
+            __m256 d23 = _mm256_fmadd_ps(b0, s0, _mm256_fmadd_ps(b1, s1,
+                         _mm256_fmadd_ps(b2, s2, _mm256_mul_ps(b3, unitW))));
+            // Exactly 0, 0, 0, 1 whatever the source holds
+            d23 = _mm256_blend_ps(d23, unitW, 0xF0);
+
+            _mm256_storeu_ps(d + 0, d01);
+            _mm256_storeu_ps(d + 8, d23);
+
+            ++pSrcMat;
+            ++pDstMat;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::calculateFaceNormals(
+        const float *positions,
+        const EdgeData::Triangle *triangles,
+        Vector4 *faceNormals,
+        size_t numTriangles)
+    {
+        // Eight triangles per iteration, as a register per component. Gather
+        // instructions aren't used, loading and transposing is faster.
+        for ( ; numTriangles >= 8; numTriangles -= 8)
+        {
+            __m256 v1x, v1y, v1z, v2x, v2y, v2z, v3x, v3y, v3z;
+            __mm256_load_corners_ps(positions, triangles, 0, v1x, v1y, v1z);
+            __mm256_load_corners_ps(positions, triangles, 1, v2x, v2y, v2z);
+            __mm256_load_corners_ps(positions, triangles, 2, v3x, v3y, v3z);
+
+            // Edges from the first vertex
+            __m256 e1x = _mm256_sub_ps(v2x, v1x);
+            __m256 e1y = _mm256_sub_ps(v2y, v1y);
+            __m256 e1z = _mm256_sub_ps(v2z, v1z);
+            __m256 e2x = _mm256_sub_ps(v3x, v1x);
+            __m256 e2y = _mm256_sub_ps(v3y, v1y);
+            __m256 e2z = _mm256_sub_ps(v3z, v1z);
+
+            // Cross product, then the distance from the origin
+            __m256 nx = _mm256_fmsub_ps(e1y, e2z, _mm256_mul_ps(e1z, e2y));
+            __m256 ny = _mm256_fmsub_ps(e1z, e2x, _mm256_mul_ps(e1x, e2z));
+            __m256 nz = _mm256_fmsub_ps(e1x, e2y, _mm256_mul_ps(e1y, e2x));
+            __m256 nw = _mm256_fnmsub_ps(nx, v1x, _mm256_fmadd_ps(ny, v1y, _mm256_mul_ps(nz, v1z)));
+
+            // Back to a Vector4 per triangle: triangles i and i + 4 share a row
+            __mm256_transpose4x4_ps(nx, ny, nz, nw);
+            float* dst = faceNormals->ptr();
+            _mm256_storeu_ps(dst + 0, _mm256_permute2f128_ps(nx, ny, 0x20));
+            _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(nz, nw, 0x20));
+            _mm256_storeu_ps(dst + 16, _mm256_permute2f128_ps(nx, ny, 0x31));
+            _mm256_storeu_ps(dst + 24, _mm256_permute2f128_ps(nz, nw, 0x31));
+
+            triangles += 8;
+            faceNormals += 8;
+        }
+
+        // Left over triangles
+        for ( ; numTriangles; --numTriangles)
+        {
+            const EdgeData::Triangle& t = *triangles++;
+            size_t offset;
+
+            offset = t.vertIndex[0] * 3;
+            Vector3 v1(positions[offset+0], positions[offset+1], positions[offset+2]);
+
+            offset = t.vertIndex[1] * 3;
+            Vector3 v2(positions[offset+0], positions[offset+1], positions[offset+2]);
+
+            offset = t.vertIndex[2] * 3;
+            Vector3 v3(positions[offset+0], positions[offset+1], positions[offset+2]);
+
+            *faceNormals++ = Math::calculateFaceNormalWithoutNormalize(v1, v2, v3);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::calculateLightFacing(
+        const Vector4& lightPos,
+        const Vector4* faceNormals,
+        char* lightFacings,
+        size_t numFaces)
+    {
+        // Map to convert 4-bits mask to the even bytes of 8 byte values
+        static const uint64 msMaskMapping[16] =
+        {
+            0x0000000000000000ULL, 0x0000000000000001ULL, 0x0000000000010000ULL, 0x0000000000010001ULL,
+            0x0000000100000000ULL, 0x0000000100000001ULL, 0x0000000100010000ULL, 0x0000000100010001ULL,
+            0x0001000000000000ULL, 0x0001000000000001ULL, 0x0001000000010000ULL, 0x0001000000010001ULL,
+            0x0001000100000000ULL, 0x0001000100000001ULL, 0x0001000100010000ULL, 0x0001000100010001ULL,
+        };
+
+        __m256 light = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lightPos.ptr()));
+        __m256 zero = _mm256_setzero_ps();
+
+        // Eight faces per iteration, two per register
+        for ( ; numFaces >= 8; numFaces -= 8)
+        {
+            const float* n = faceNormals->ptr();
+            __m256 n01 = _mm256_mul_ps(_mm256_loadu_ps(n + 0), light);    // face 0 | face 1
+            __m256 n23 = _mm256_mul_ps(_mm256_loadu_ps(n + 8), light);    // face 2 | face 3
+            __m256 n45 = _mm256_mul_ps(_mm256_loadu_ps(n + 16), light);   // face 4 | face 5
+            __m256 n67 = _mm256_mul_ps(_mm256_loadu_ps(n + 24), light);   // face 6 | face 7
+
+            // Horizontal add, as the SSE version does for each half
+            __m256 t0 = _mm256_add_ps(_mm256_unpacklo_ps(n01, n23), _mm256_unpackhi_ps(n01, n23));
+            __m256 t1 = _mm256_add_ps(_mm256_unpacklo_ps(n45, n67), _mm256_unpackhi_ps(n45, n67));
+            __m256 dp = _mm256_add_ps(                                  // dp0 dp2 dp4 dp6 | dp1 dp3 dp5 dp7
+                _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0)),
+                _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2)));
+
+            // Even faces are in the low 4 bits of the mask, odd faces in the high 4 bits
+            int bitmask = _mm256_movemask_ps(_mm256_cmp_ps(dp, zero, _CMP_GT_OQ));
+            uint64 facings = msMaskMapping[bitmask & 0xF] | (msMaskMapping[bitmask >> 4] << 8);
+            memcpy(lightFacings, &facings, sizeof(uint64));
+
+            faceNormals += 8;
+            lightFacings += 8;
+        }
+
+        // Left over faces
+        for ( ; numFaces; --numFaces)
+        {
+            *lightFacings++ = (lightPos.dotProduct(*faceNormals++) > 0);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::extrudeVertices(
+        const Vector4& lightPos,
+        Real extrudeDist,
+        const float* pSrcPos,
+        float* pDestPos,
+        size_t numVertices)
+    {
+        if (lightPos.w == 0.0f)
+        {
+            // Directional light, extrusion is along light direction
+
+            Vector3 extrusionDir(
+                -lightPos.x,
+                -lightPos.y,
+                -lightPos.z);
+            extrusionDir.normalise();
+            extrusionDir *= extrudeDist;
+
+            // Eight vertices per iteration, the offset repeats every 3 floats
+            __m256 dir0 = _mm256_setr_ps(
+                extrusionDir.x, extrusionDir.y, extrusionDir.z, extrusionDir.x,
+                extrusionDir.y, extrusionDir.z, extrusionDir.x, extrusionDir.y);
+            __m256 dir1 = _mm256_setr_ps(
+                extrusionDir.z, extrusionDir.x, extrusionDir.y, extrusionDir.z,
+                extrusionDir.x, extrusionDir.y, extrusionDir.z, extrusionDir.x);
+            __m256 dir2 = _mm256_setr_ps(
+                extrusionDir.y, extrusionDir.z, extrusionDir.x, extrusionDir.y,
+                extrusionDir.z, extrusionDir.x, extrusionDir.y, extrusionDir.z);
+
+            for ( ; numVertices >= 8; numVertices -= 8)
+            {
+                _mm256_storeu_ps(pDestPos + 0, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 0), dir0));
+                _mm256_storeu_ps(pDestPos + 8, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 8), dir1));
+                _mm256_storeu_ps(pDestPos + 16, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 16), dir2));
+
+                pSrcPos += 24;
+                pDestPos += 24;
+            }
+
+            for ( ; numVertices; --numVertices)
+            {
+                *pDestPos++ = *pSrcPos++ + extrusionDir.x;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.y;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.z;
+            }
+        }
+        else
+        {
+            // Point light, calculate extrusionDir for every vertex
+            assert(lightPos.w == 1.0f);
+
+            __m256 lightX = _mm256_set1_ps(lightPos.x);
+            __m256 lightY = _mm256_set1_ps(lightPos.y);
+            __m256 lightZ = _mm256_set1_ps(lightPos.z);
+            __m256 dist = _mm256_set1_ps(extrudeDist);
+            // Same threshold as Vector3::normalise
+            __m256 minLength = _mm256_set1_ps(1e-08f);
+
+            // Eight vertices per iteration, as a register per component
+            for ( ; numVertices >= 8; numVertices -= 8)
+            {
+                __m256 x, y, z;
+                __mm256_deinterleave3_ps(
+                    _mm256_loadu_ps(pSrcPos + 0),
+                    _mm256_loadu_ps(pSrcPos + 8),
+                    _mm256_loadu_ps(pSrcPos + 16),
+                    x, y, z);
+
+                __m256 dx = _mm256_sub_ps(x, lightX);
+                __m256 dy = _mm256_sub_ps(y, lightY);
+                __m256 dz = _mm256_sub_ps(z, lightZ);
+                __m256 len = _mm256_sqrt_ps(_mm256_fmadd_ps(dx, dx,
+                    _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz))));
+                __m256 scale = _mm256_blendv_ps(dist, _mm256_div_ps(dist, len),
+                    _mm256_cmp_ps(len, minLength, _CMP_GT_OQ));
+
+                __m256 a, b, c;
+                __mm256_interleave3_ps(
+                    _mm256_fmadd_ps(dx, scale, x),
+                    _mm256_fmadd_ps(dy, scale, y),
+                    _mm256_fmadd_ps(dz, scale, z),
+                    a, b, c);
+                _mm256_storeu_ps(pDestPos + 0, a);
+                _mm256_storeu_ps(pDestPos + 8, b);
+                _mm256_storeu_ps(pDestPos + 16, c);
+
+                pSrcPos += 24;
+                pDestPos += 24;
+            }
+
+            for ( ; numVertices; --numVertices)
+            {
+                Vector3 extrusionDir(
+                    pSrcPos[0] - lightPos.x,
+                    pSrcPos[1] - lightPos.y,
+                    pSrcPos[2] - lightPos.z);
+                extrusionDir.normalise();
+                extrusionDir *= extrudeDist;
+
+                *pDestPos++ = *pSrcPos++ + extrusionDir.x;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.y;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.z;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::concatenateNodeTransforms(
+        const float* pParent,
+        const float* pLocal,
+        float* pDerived,
+        size_t numBlocks)
+    {
+        // The data is laid out in blocks of 4 nodes, the SSE version suits it
+        mSSE->concatenateNodeTransforms(pParent, pLocal, pDerived, numBlocks);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::cullBoxes(
+        const float* planes,
+        size_t numPlanes,
+        const float* pBoxes,
+        size_t numBlocks,
+        uint8* visibleMasks)
+    {
+        // The data is laid out in blocks of 4 boxes, the SSE version suits it
+        mSSE->cullBoxes(planes, numPlanes, pBoxes, numBlocks, visibleMasks);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::interpolateNodeTransforms(
+        const float* pWeights,
+        const float* pSrc1,
+        const float* pSrc2,
+        float* pDest,
+        size_t numBlocks)
+    {
+        // The data is laid out in blocks of 4 nodes, the SSE version suits it
+        mSSE->interpolateNodeTransforms(pWeights, pSrc1, pSrc2, pDest, numBlocks);
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void)
+    {
+        static OptimisedUtilAVX2 msOptimisedUtilAVX2;
+        return &msOptimisedUtilAVX2;
+    }
+
+}
+
+#endif // __OGRE_HAVE_AVX2
@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include "OgreVector3.h"
 #include "OgreMatrix4.h"
+#include "OgreQuaternion.h"
 
 namespace Ogre {
 
@@ -94,6 +95,29 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::concatenateNodeTransforms
+        virtual void concatenateNodeTransforms(
+            const float* parentTransforms,
+            const float* localTransforms,
+            float* derivedTransforms,
+            size_t numBlocks);
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        virtual void cullBoxes(
+            const float* planes,
+            size_t numPlanes,
+            const float* boxes,
+            size_t numBlocks,
+            uint8* visibleMasks);
+
+        /// @copydoc OptimisedUtil::interpolateNodeTransforms
+        virtual void interpolateNodeTransforms(
+            const float* weights,
+            const float* srcTransforms1,
+            const float* srcTransforms2,
+            float* dstTransforms,
+            size_t numBlocks);
     };
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -392,6 +416,126 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::concatenateNodeTransforms(
+        const float* pParent,
+        const float* pLocal,
+        float* pDerived,
+        size_t numBlocks)
+    {
+        for (size_t block = 0; block < numBlocks; ++block)
+        {
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const float* p = pParent + i;
+                const float* l = pLocal + i;
+                float* d = pDerived + i;
+
+                const Vector3 parentPosition(p[0], p[4], p[8]);
+                const Quaternion parentOrientation(p[12], p[16], p[20], p[24]);
+                const Vector3 parentScale(p[28], p[32], p[36]);
+
+                Quaternion orientation = parentOrientation * 
+                    Quaternion(l[12], l[16], l[20], l[24]);
+                Vector3 scale = parentScale * Vector3(l[28], l[32], l[36]);
+                Vector3 position = parentOrientation * 
+                    (parentScale * Vector3(l[0], l[4], l[8]));
+                position += parentPosition;
+
+                d[0] = position.x; d[4] = position.y; d[8] = position.z;
+                d[12] = orientation.w; d[16] = orientation.x;
+                d[20] = orientation.y; d[24] = orientation.z;
+                d[28] = scale.x; d[32] = scale.y; d[36] = scale.z;
+            }
+
+            pParent += 40;
+            pLocal += 40;
+            pDerived += 40;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::cullBoxes(
+        const float* planes,
+        size_t numPlanes,
+        const float* pBoxes,
+        size_t numBlocks,
+        uint8* visibleMasks)
+    {
+        for (size_t block = 0; block < numBlocks; ++block)
+        {
+            uint8 mask = 0;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const float* b = pBoxes + i;
+                const Vector3 centre(b[0], b[4], b[8]);
+                const Vector3 halfSize(b[12], b[16], b[20]);
+
+                bool visible = true;
+                for (size_t p = 0; p < numPlanes && visible; ++p)
+                {
+                    const float* plane = planes + p * 4;
+                    const Vector3 normal(plane[0], plane[1], plane[2]);
+
+                    // Same test as Plane::getSide(centre, halfSize) == NEGATIVE_SIDE
+                    Real dist = normal.dotProduct(centre) + plane[3];
+                    Real maxAbsDist = normal.absDotProduct(halfSize);
+                    visible = !(dist < -maxAbsDist);
+                }
+
+                if (visible)
+                    mask |= static_cast<uint8>(1 << i);
+            }
+
+            visibleMasks[block] = mask;
+            pBoxes += 24;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::interpolateNodeTransforms(
+        const float* pWeights,
+        const float* pSrc1,
+        const float* pSrc2,
+        float* pDest,
+        size_t numBlocks)
+    {
+        for (size_t block = 0; block < numBlocks; ++block)
+        {
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const float t = pWeights[i];
+                const float* a = pSrc1 + i;
+                const float* b = pSrc2 + i;
+                float* d = pDest + i;
+
+                // Orientation, nlerp along the shortest path
+                float dot = a[12] * b[12] + a[16] * b[16] + a[20] * b[20] + a[24] * b[24];
+                float sign = dot < 0 ? -1.0f : 1.0f;
+                float q[4];
+                float lenSq = 0;
+                for (size_t c = 0; c < 4; ++c)
+                {
+                    float qa = a[12 + c * 4];
+                    q[c] = qa + (b[12 + c * 4] * sign - qa) * t;
+                    lenSq += q[c] * q[c];
+                }
+                float invLen = 1.0f / std::sqrt(lenSq);
+
+                // Position and scale, lerp
+                for (size_t c = 0; c < 12; c += 4)
+                {
+                    d[c] = a[c] + (b[c] - a[c]) * t;
+                    d[28 + c] = a[28 + c] + (b[28 + c] - a[28 + c]) * t;
+                }
+                for (size_t c = 0; c < 4; ++c)
+                    d[12 + c * 4] = q[c] * invLen;
+            }
+
+            pWeights += 4;
+            pSrc1 += 40;
+            pSrc2 += 40;
+            pDest += 40;
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilGeneral(void)
@@ -65,6 +65,8 @@ THE SOFTWARE.
 
 namespace Ogre {
 
+    extern OptimisedUtil* _getOptimisedUtilGeneral(void);
+
 //-------------------------------------------------------------------------
 // Local classes
 //-------------------------------------------------------------------------
@@ -132,6 +134,29 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::concatenateNodeTransforms
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE concatenateNodeTransforms(
+            const float* parentTransforms,
+            const float* localTransforms,
+            float* derivedTransforms,
+            size_t numBlocks);
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE cullBoxes(
+            const float* planes,
+            size_t numPlanes,
+            const float* boxes,
+            size_t numBlocks,
+            uint8* visibleMasks);
+
+        /// @copydoc OptimisedUtil::interpolateNodeTransforms
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE interpolateNodeTransforms(
+            const float* weights,
+            const float* srcTransforms1,
+            const float* srcTransforms2,
+            float* dstTransforms,
+            size_t numBlocks);
     };
 
 #if defined(__OGRE_SIMD_ALIGN_STACK)
@@ -271,6 +296,58 @@ namespace Ogre {
                 destPositions,
                 numVertices);
         }
+
+        /// @copydoc OptimisedUtil::concatenateNodeTransforms
+        virtual void concatenateNodeTransforms(
+            const float* parentTransforms,
+            const float* localTransforms,
+            float* derivedTransforms,
+            size_t numBlocks)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->concatenateNodeTransforms(
+                parentTransforms,
+                localTransforms,
+                derivedTransforms,
+                numBlocks);
+        }
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        virtual void cullBoxes(
+            const float* planes,
+            size_t numPlanes,
+            const float* boxes,
+            size_t numBlocks,
+            uint8* visibleMasks)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->cullBoxes(
+                planes,
+                numPlanes,
+                boxes,
+                numBlocks,
+                visibleMasks);
+        }
+
+        /// @copydoc OptimisedUtil::interpolateNodeTransforms
+        virtual void interpolateNodeTransforms(
+            const float* weights,
+            const float* srcTransforms1,
+            const float* srcTransforms2,
+            float* dstTransforms,
+            size_t numBlocks)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->interpolateNodeTransforms(
+                weights,
+                srcTransforms1,
+                srcTransforms2,
+                dstTransforms,
+                numBlocks);
+        }
     };
 #endif  // !defined(__OGRE_SIMD_ALIGN_STACK)
 
@@ -1496,18 +1573,18 @@ namespace Ogre {
                 norm = _mm_loadh_pi(norm, (__m64*)(pNorm + 0));
                 
                 // Fill a 4-vec with vector length
-                // square
+                // square, which is yy | xx | 0 | zz
                 __m128 tmp = _mm_mul_ps(norm, norm);
                 // Add - for this we want this effect:
                 // orig   3 | 2 | 1 | 0
-                // add1   0 | 0 | 0 | 2
-                // add2   2 | 3 | 0 | 3
+                // add1   1 | 0 | 3 | 2
+                // add2   0 | 1 | 3 | 1
                 // This way elements 0, 2 and 3 have the sum of all entries (except 1 which is unused)
                 
-                tmp = _mm_add_ps(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(0,0,0,2)));
+                tmp = _mm_add_ps(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(1,0,3,2)));
                 // Add final combination & sqrt 
-                // bottom 3 elements of l will have length, we don't care about 4
-                tmp = _mm_add_ps(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(2,3,0,3)));
+                // elements 0, 2 and 3 of tmp will have length squared, we don't care about 1
+                tmp = _mm_add_ps(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(0,1,3,1)));
                 // Then divide to normalise
                 norm = _mm_div_ps(norm, _mm_sqrt_ps(tmp));
                 
@@ -2136,6 +2213,211 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilSSE::concatenateNodeTransforms(
+        const float* pParent,
+        const float* pLocal,
+        float* pDerived,
+        size_t numBlocks)
+    {
+        assert(_isAlignedForSSE(pParent) && _isAlignedForSSE(pLocal) && _isAlignedForSSE(pDerived));
+
+        __m128 two = _mm_set_ps1(2.0f);
+
+        for (size_t block = 0; block < numBlocks; ++block)
+        {
+            // Same operations, in the same order, as the scalar version,
+            // done for 4 nodes at a time
+            __m128 ppx = _mm_load_ps(pParent + 0);
+            __m128 ppy = _mm_load_ps(pParent + 4);
+            __m128 ppz = _mm_load_ps(pParent + 8);
+            __m128 pqw = _mm_load_ps(pParent + 12);
+            __m128 pqx = _mm_load_ps(pParent + 16);
+            __m128 pqy = _mm_load_ps(pParent + 20);
+            __m128 pqz = _mm_load_ps(pParent + 24);
+
+            // Orientation: parentOrientation * orientation
+            {
+                __m128 lqw = _mm_load_ps(pLocal + 12);
+                __m128 lqx = _mm_load_ps(pLocal + 16);
+                __m128 lqy = _mm_load_ps(pLocal + 20);
+                __m128 lqz = _mm_load_ps(pLocal + 24);
+
+                __m128 qw = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(
+                    _mm_mul_ps(pqw, lqw), _mm_mul_ps(pqx, lqx)), _mm_mul_ps(pqy, lqy)), _mm_mul_ps(pqz, lqz));
+                __m128 qx = _mm_sub_ps(_mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(pqw, lqx), _mm_mul_ps(pqx, lqw)), _mm_mul_ps(pqy, lqz)), _mm_mul_ps(pqz, lqy));
+                __m128 qy = _mm_sub_ps(_mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(pqw, lqy), _mm_mul_ps(pqy, lqw)), _mm_mul_ps(pqz, lqx)), _mm_mul_ps(pqx, lqz));
+                __m128 qz = _mm_sub_ps(_mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(pqw, lqz), _mm_mul_ps(pqz, lqw)), _mm_mul_ps(pqx, lqy)), _mm_mul_ps(pqy, lqx));
+
+                _mm_store_ps(pDerived + 12, qw);
+                _mm_store_ps(pDerived + 16, qx);
+                _mm_store_ps(pDerived + 20, qy);
+                _mm_store_ps(pDerived + 24, qz);
+            }
+
+            __m128 psx = _mm_load_ps(pParent + 28);
+            __m128 psy = _mm_load_ps(pParent + 32);
+            __m128 psz = _mm_load_ps(pParent + 36);
+
+            // Scale: parentScale * scale
+            _mm_store_ps(pDerived + 28, _mm_mul_ps(psx, _mm_load_ps(pLocal + 28)));
+            _mm_store_ps(pDerived + 32, _mm_mul_ps(psy, _mm_load_ps(pLocal + 32)));
+            _mm_store_ps(pDerived + 36, _mm_mul_ps(psz, _mm_load_ps(pLocal + 36)));
+
+            // Position: parentOrientation * (parentScale * position) + parentPosition
+            {
+                __m128 vx = _mm_mul_ps(psx, _mm_load_ps(pLocal + 0));
+                __m128 vy = _mm_mul_ps(psy, _mm_load_ps(pLocal + 4));
+                __m128 vz = _mm_mul_ps(psz, _mm_load_ps(pLocal + 8));
+
+                // uv = qvec x v
+                __m128 uvx = _mm_sub_ps(_mm_mul_ps(pqy, vz), _mm_mul_ps(pqz, vy));
+                __m128 uvy = _mm_sub_ps(_mm_mul_ps(pqz, vx), _mm_mul_ps(pqx, vz));
+                __m128 uvz = _mm_sub_ps(_mm_mul_ps(pqx, vy), _mm_mul_ps(pqy, vx));
+
+                // uuv = qvec x uv
+                __m128 uuvx = _mm_sub_ps(_mm_mul_ps(pqy, uvz), _mm_mul_ps(pqz, uvy));
+                __m128 uuvy = _mm_sub_ps(_mm_mul_ps(pqz, uvx), _mm_mul_ps(pqx, uvz));
+                __m128 uuvz = _mm_sub_ps(_mm_mul_ps(pqx, uvy), _mm_mul_ps(pqy, uvx));
+
+                __m128 w2 = _mm_mul_ps(two, pqw);
+                uvx = _mm_mul_ps(uvx, w2);
+                uvy = _mm_mul_ps(uvy, w2);
+                uvz = _mm_mul_ps(uvz, w2);
+                uuvx = _mm_mul_ps(uuvx, two);
+                uuvy = _mm_mul_ps(uuvy, two);
+                uuvz = _mm_mul_ps(uuvz, two);
+
+                _mm_store_ps(pDerived + 0, _mm_add_ps(_mm_add_ps(_mm_add_ps(vx, uvx), uuvx), ppx));
+                _mm_store_ps(pDerived + 4, _mm_add_ps(_mm_add_ps(_mm_add_ps(vy, uvy), uuvy), ppy));
+                _mm_store_ps(pDerived + 8, _mm_add_ps(_mm_add_ps(_mm_add_ps(vz, uvz), uuvz), ppz));
+            }
+
+            pParent += 40;
+            pLocal += 40;
+            pDerived += 40;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::cullBoxes(
+        const float* planes,
+        size_t numPlanes,
+        const float* pBoxes,
+        size_t numBlocks,
+        uint8* visibleMasks)
+    {
+        assert(_isAlignedForSSE(pBoxes));
+
+        __m128 zero = _mm_setzero_ps();
+
+        for (size_t block = 0; block < numBlocks; ++block)
+        {
+            __m128 cx = _mm_load_ps(pBoxes + 0);
+            __m128 cy = _mm_load_ps(pBoxes + 4);
+            __m128 cz = _mm_load_ps(pBoxes + 8);
+            __m128 hx = _mm_load_ps(pBoxes + 12);
+            __m128 hy = _mm_load_ps(pBoxes + 16);
+            __m128 hz = _mm_load_ps(pBoxes + 20);
+
+            // All lanes visible until culled by a plane
+            __m128 visible = _mm_cmpeq_ps(zero, zero);
+            int mask = 0xF;
+            for (size_t p = 0; p < numPlanes && mask; ++p)
+            {
+                const float* plane = planes + p * 4;
+                __m128 nx = _mm_load_ps1(plane + 0);
+                __m128 ny = _mm_load_ps1(plane + 1);
+                __m128 nz = _mm_load_ps1(plane + 2);
+                __m128 d = _mm_load_ps1(plane + 3);
+
+                // Same test as Plane::getSide(centre, halfSize) == NEGATIVE_SIDE
+                __m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_mul_ps(nz, cz)), d);
+                __m128 ax = _mm_mul_ps(nx, hx);
+                __m128 ay = _mm_mul_ps(ny, hy);
+                __m128 az = _mm_mul_ps(nz, hz);
+                __m128 maxAbsDist = _mm_add_ps(_mm_add_ps(
+                    _mm_max_ps(ax, _mm_sub_ps(zero, ax)),
+                    _mm_max_ps(ay, _mm_sub_ps(zero, ay))),
+                    _mm_max_ps(az, _mm_sub_ps(zero, az)));
+
+                __m128 culled = _mm_cmplt_ps(dist, _mm_sub_ps(zero, maxAbsDist));
+                visible = _mm_andnot_ps(culled, visible);
+                mask = _mm_movemask_ps(visible);
+            }
+
+            visibleMasks[block] = static_cast<uint8>(mask);
+            pBoxes += 24;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::interpolateNodeTransforms(
+        const float* pWeights,
+        const float* pSrc1,
+        const float* pSrc2,
+        float* pDest,
+        size_t numBlocks)
+    {
+        assert(_isAlignedForSSE(pWeights) && _isAlignedForSSE(pSrc1) &&
+               _isAlignedForSSE(pSrc2) && _isAlignedForSSE(pDest));
+
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set_ps1(1.0f);
+        const __m128 signBit = _mm_set_ps1(-0.0f);
+
+        for (size_t block = 0; block < numBlocks; ++block)
+        {
+            __m128 t = _mm_load_ps(pWeights);
+
+            // Positions: plain lerp
+            for (size_t c = 0; c < 12; c += 4)
+            {
+                _mm_store_ps(pDest + c, __MM_LERP_PS(t,
+                    _mm_load_ps(pSrc1 + c), _mm_load_ps(pSrc2 + c)));
+            }
+
+            // Orientations: nlerp along the shortest path
+            {
+                __m128 a0 = _mm_load_ps(pSrc1 + 12);
+                __m128 a1 = _mm_load_ps(pSrc1 + 16);
+                __m128 a2 = _mm_load_ps(pSrc1 + 20);
+                __m128 a3 = _mm_load_ps(pSrc1 + 24);
+                __m128 b0 = _mm_load_ps(pSrc2 + 12);
+                __m128 b1 = _mm_load_ps(pSrc2 + 16);
+                __m128 b2 = _mm_load_ps(pSrc2 + 20);
+                __m128 b3 = _mm_load_ps(pSrc2 + 24);
+
+                __m128 flip = _mm_and_ps(
+                    _mm_cmplt_ps(__MM_DOT4x4_PS(a0, a1, a2, a3, b0, b1, b2, b3), zero), signBit);
+                a0 = __MM_LERP_PS(t, a0, _mm_xor_ps(b0, flip));
+                a1 = __MM_LERP_PS(t, a1, _mm_xor_ps(b1, flip));
+                a2 = __MM_LERP_PS(t, a2, _mm_xor_ps(b2, flip));
+                a3 = __MM_LERP_PS(t, a3, _mm_xor_ps(b3, flip));
+
+                __m128 invLen = _mm_div_ps(one,
+                    _mm_sqrt_ps(__MM_DOT4x4_PS(a0, a1, a2, a3, a0, a1, a2, a3)));
+                _mm_store_ps(pDest + 12, _mm_mul_ps(a0, invLen));
+                _mm_store_ps(pDest + 16, _mm_mul_ps(a1, invLen));
+                _mm_store_ps(pDest + 20, _mm_mul_ps(a2, invLen));
+                _mm_store_ps(pDest + 24, _mm_mul_ps(a3, invLen));
+            }
+
+            // Scales: plain lerp
+            for (size_t c = 28; c < 40; c += 4)
+            {
+                _mm_store_ps(pDest + c, __MM_LERP_PS(t,
+                    _mm_load_ps(pSrc1 + c), _mm_load_ps(pSrc2 + c)));
+            }
+
+            pWeights += 4;
+            pSrc1 += 40;
+            pSrc2 += 40;
+            pDest += 40;
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilSSE(void)
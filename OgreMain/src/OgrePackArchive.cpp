@@ -0,0 +1,826 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgrePackArchive.h"
+#include "OgreLogManager.h"
+#include "OgreException.h"
+
+#include <sys/stat.h>
+#include <lz4.h>
+#if OGRE_NO_ZIP_ARCHIVE == 0
+#include <zlib.h>
+#endif
+
+namespace Ogre {
+
+    /* Layout of a pack, all numbers little endian:
+       header       magic, version, chunk size, file and chunk counts, size of
+                    the stream of all files and where the table of contents is
+       chunks       from OGRE_PACK_DATA_ALIGNMENT on, each one 16 byte aligned
+       contents     one entry per file sorted by hash and lower case path,
+                    one record per chunk, then the paths of the files
+    */
+    #define OGRE_PACK_MAGIC "OGREPACK"
+    #define OGRE_PACK_VERSION 1
+    #define OGRE_PACK_HEADER_SIZE 64
+    #define OGRE_PACK_ENTRY_SIZE 32
+    #define OGRE_PACK_CHUNK_RECORD_SIZE 16
+    #define OGRE_PACK_DATA_ALIGNMENT 4096
+    #define OGRE_PACK_CHUNK_ALIGNMENT 16
+
+    static uint16 readUInt16(const uchar* data)
+    {
+        return static_cast<uint16>(data[0] | (data[1] << 8));
+    }
+    static uint32 readUInt32(const uchar* data)
+    {
+        return static_cast<uint32>(data[0]) | (static_cast<uint32>(data[1]) << 8) |
+            (static_cast<uint32>(data[2]) << 16) | (static_cast<uint32>(data[3]) << 24);
+    }
+    static uint64 readUInt64(const uchar* data)
+    {
+        return static_cast<uint64>(readUInt32(data)) | (static_cast<uint64>(readUInt32(data + 4)) << 32);
+    }
+    static void writeUInt(vector<uchar>::type& data, uint64 value, size_t bytes)
+    {
+        for (size_t i = 0; i < bytes; ++i)
+            data.push_back(static_cast<uchar>(value >> (i * 8)));
+    }
+    /// Lower case path with '/' between folders, which files are looked up by
+    static String entryKey(const String& path)
+    {
+        String key = path;
+        std::replace(key.begin(), key.end(), '\\', '/');
+        StringUtil::toLowerCase(key);
+        return key;
+    }
+    /// FNV-1a, which gives the same hash whatever the byte order
+    static uint32 hashKey(const String& key)
+    {
+        uint32 hash = 2166136261u;
+        for (String::const_iterator i = key.begin(); i != key.end(); ++i)
+        {
+            hash ^= static_cast<uchar>(*i);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    //-----------------------------------------------------------------------
+    bool PackArchive::isCodecSupported(Codec codec)
+    {
+        switch (codec)
+        {
+        case CODEC_NONE:
+        case CODEC_LZ4:
+            return true;
+        case CODEC_ZLIB:
+#if OGRE_NO_ZIP_ARCHIVE == 0
+            return true;
+#else
+            return false;
+#endif
+        }
+        return false;
+    }
+    //-----------------------------------------------------------------------
+    PackArchive::PackArchive(const String& name, const String& archType)
+        : Archive(name, archType), mChunkSize(0), mDataSize(0), mLoaded(false)
+    {
+    }
+    //-----------------------------------------------------------------------
+    PackArchive::~PackArchive()
+    {
+        unload();
+    }
+    //-----------------------------------------------------------------------
+    void PackArchive::readPack(std::ifstream* file, uint64 offset, void* buffer, size_t size) const
+    {
+        if (!mMapping.isNull())
+        {
+            if (offset > mMapping->size() || size > mMapping->size() - offset)
+            {
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                    mName + " - Corrupted pack.", "PackArchive::readPack");
+            }
+            memcpy(buffer, mMapping->getPtr() + offset, size);
+        }
+        else
+        {
+            file->seekg(static_cast<std::streamoff>(offset));
+            file->read(static_cast<char*>(buffer), size);
+            if (!*file || static_cast<size_t>(file->gcount()) != size)
+            {
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                    mName + " - Corrupted pack.", "PackArchive::readPack");
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void PackArchive::load()
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        if (mLoaded)
+            return;
+
+        std::ifstream stream;
+        std::ifstream* file = 0;
+        if (MappedFileDataStream::isSupported())
+        {
+            mMapping = MemoryDataStreamPtr(OGRE_NEW MappedFileDataStream(mName, mName));
+        }
+        else
+        {
+            stream.open(mName.c_str(), std::ios::in | std::ios::binary);
+            if (!stream)
+            {
+                OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                    mName + " - error whilst opening archive: Unable to read pack file.",
+                    "PackArchive::load");
+            }
+            file = &stream;
+        }
+
+        try
+        {
+            uchar header[OGRE_PACK_HEADER_SIZE];
+            readPack(file, 0, header, OGRE_PACK_HEADER_SIZE);
+            if (memcmp(header, OGRE_PACK_MAGIC, 8) != 0)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    mName + " - error whilst opening archive: Not a pack file.",
+                    "PackArchive::load");
+            }
+            if (readUInt32(header + 8) > OGRE_PACK_VERSION)
+            {
+                OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                    mName + " - Pack version " + StringConverter::toString(readUInt32(header + 8)) +
+                    " is not supported",
+                    "PackArchive::load");
+            }
+            mChunkSize = readUInt32(header + 12);
+            size_t fileCount = readUInt32(header + 16);
+            size_t chunkCount = readUInt32(header + 20);
+            mDataSize = readUInt64(header + 24);
+            uint64 contentsOffset = readUInt64(header + 32);
+            uint64 namesSize = readUInt64(header + 40);
+            // Chunks are handed to LZ4 with int sizes
+            if (mChunkSize == 0 || mChunkSize > LZ4_MAX_INPUT_SIZE ||
+                (mDataSize + mChunkSize - 1) / mChunkSize != chunkCount ||
+                namesSize > 0xFFFFFFFF)
+            {
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                    mName + " - error whilst opening archive: Corrupted pack.",
+                    "PackArchive::load");
+            }
+
+            size_t entriesSize = fileCount * OGRE_PACK_ENTRY_SIZE;
+            size_t chunksSize = chunkCount * OGRE_PACK_CHUNK_RECORD_SIZE;
+            vector<uchar>::type contents(entriesSize + chunksSize + static_cast<size_t>(namesSize));
+            if (!contents.empty())
+                readPack(file, contentsOffset, &contents[0], contents.size());
+            const uchar* names = contents.empty() ? 0 : &contents[0] + entriesSize + chunksSize;
+
+            mChunks.resize(chunkCount);
+            for (size_t i = 0; i < chunkCount; ++i)
+            {
+                const uchar* record = &contents[entriesSize + i * OGRE_PACK_CHUNK_RECORD_SIZE];
+                Chunk& chunk = mChunks[i];
+                chunk.offset = readUInt64(record);
+                chunk.compressedSize = readUInt32(record + 8);
+                chunk.codec = static_cast<Codec>(readUInt16(record + 12));
+                if (chunk.codec == CODEC_LZ4 &&
+                    chunk.compressedSize > static_cast<uint32>(LZ4_compressBound(static_cast<int>(mChunkSize))))
+                {
+                    OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        mName + " - error whilst opening archive: Corrupted pack.",
+                        "PackArchive::load");
+                }
+                if (!isCodecSupported(chunk.codec))
+                {
+                    OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                        mName + " - Unsupported compression format of chunk " + StringConverter::toString(i),
+                        "PackArchive::load");
+                }
+            }
+
+            // Files are listed in the order they were added, like the names are stored
+            typedef map<uint32, FileInfo>::type OrderedFileList;
+            OrderedFileList files;
+            set<String>::type dirs;
+            mEntries.resize(fileCount);
+            for (size_t i = 0; i < fileCount; ++i)
+            {
+                const uchar* record = &contents[i * OGRE_PACK_ENTRY_SIZE];
+                uint32 nameOffset = readUInt32(record + 4);
+                uint32 nameLength = readUInt32(record + 8);
+                Entry& entry = mEntries[i];
+                entry.hash = readUInt32(record);
+                entry.offset = readUInt64(record + 16);
+                entry.size = readUInt64(record + 24);
+                if (static_cast<uint64>(nameOffset) + nameLength > namesSize ||
+                    entry.offset > mDataSize || entry.size > mDataSize - entry.offset ||
+                    entry.size > std::numeric_limits<size_t>::max())
+                {
+                    OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        mName + " - error whilst opening archive: Corrupted pack.",
+                        "PackArchive::load");
+                }
+                String path(reinterpret_cast<const char*>(names + nameOffset), nameLength);
+                entry.key = entryKey(path);
+
+                // Same file list as FileSystemArchive builds
+                FileInfo info;
+                info.archive = this;
+                info.filename = path;
+                StringUtil::splitFilename(path, info.basename, info.path);
+                info.compressedSize = static_cast<size_t>(entry.size);
+                info.uncompressedSize = static_cast<size_t>(entry.size);
+                files[nameOffset] = info;
+
+                // Folders only exist as the paths of the files in them
+                for (size_t slash = path.find('/'); slash != String::npos; slash = path.find('/', slash + 1))
+                    dirs.insert(path.substr(0, slash));
+            }
+
+            // Packs are written sorted, but lookups must not depend on it
+            for (size_t i = 1; i < fileCount; ++i)
+            {
+                if (mEntries[i].hash < mEntries[i - 1].hash ||
+                    (mEntries[i].hash == mEntries[i - 1].hash && mEntries[i].key < mEntries[i - 1].key))
+                {
+                    OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        mName + " - error whilst opening archive: Corrupted pack.",
+                        "PackArchive::load");
+                }
+            }
+
+            mFileList.reserve(files.size() + dirs.size());
+            for (OrderedFileList::iterator i = files.begin(); i != files.end(); ++i)
+                mFileList.push_back(i->second);
+            for (set<String>::type::iterator i = dirs.begin(); i != dirs.end(); ++i)
+            {
+                FileInfo info;
+                info.archive = this;
+                info.filename = *i;
+                StringUtil::splitFilename(*i, info.basename, info.path);
+                info.compressedSize = size_t(-1);
+                info.uncompressedSize = 0;
+                mFileList.push_back(info);
+            }
+        }
+        catch (Exception&)
+        {
+            mEntries.clear();
+            mChunks.clear();
+            mFileList.clear();
+            mMapping.setNull();
+            throw;
+        }
+        mLoaded = true;
+    }
+    //-----------------------------------------------------------------------
+    void PackArchive::unload()
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        if (mLoaded)
+        {
+            mEntries.clear();
+            mChunks.clear();
+            mFileList.clear();
+            mMapping.setNull();
+            mLoaded = false;
+        }
+    }
+    //-----------------------------------------------------------------------
+    const PackArchive::Entry* PackArchive::findEntry(const String& filename) const
+    {
+        String key = entryKey(filename);
+        uint32 hash = hashKey(key);
+
+        // Binary search for the first entry of the hash
+        size_t first = 0, count = mEntries.size();
+        while (count > 0)
+        {
+            size_t step = count / 2;
+            if (mEntries[first + step].hash < hash)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+                count = step;
+        }
+        for (; first < mEntries.size() && mEntries[first].hash == hash; ++first)
+        {
+            if (mEntries[first].key == key)
+                return &mEntries[first];
+        }
+        return 0;
+    }
+    //-----------------------------------------------------------------------
+    void PackArchive::readData(uint64 offset, size_t size, uchar* buffer, const String& filename) const
+    {
+        if (size == 0)
+            return;
+
+        // Every reader has its own handle, so nothing is shared between threads
+        std::ifstream stream;
+        std::ifstream* file = 0;
+        if (mMapping.isNull())
+        {
+            stream.open(mName.c_str(), std::ios::in | std::ios::binary);
+            file = &stream;
+        }
+
+        vector<uchar>::type compressed, chunkData;
+        size_t firstChunk = static_cast<size_t>(offset / mChunkSize);
+        size_t lastChunk = static_cast<size_t>((offset + size - 1) / mChunkSize);
+        for (size_t c = firstChunk; c <= lastChunk; ++c)
+        {
+            const Chunk& chunk = mChunks[c];
+            uint64 chunkStart = static_cast<uint64>(c) * mChunkSize;
+            size_t chunkSize = static_cast<size_t>(std::min<uint64>(mChunkSize, mDataSize - chunkStart));
+            // Part of the chunk the file covers
+            size_t from = static_cast<size_t>(std::max(offset, chunkStart) - chunkStart);
+            size_t to = static_cast<size_t>(std::min(offset + size, chunkStart + chunkSize) - chunkStart);
+            uchar* dest = buffer + static_cast<size_t>(chunkStart + from - offset);
+
+            if (chunk.codec == CODEC_NONE)
+            {
+                if (chunk.compressedSize != chunkSize)
+                {
+                    OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        mName + " - Unable to read file " + filename + ": Corrupted pack.",
+                        "PackArchive::readData");
+                }
+                readPack(file, chunk.offset + from, dest, to - from);
+                continue;
+            }
+
+            const uchar* src;
+            if (!mMapping.isNull())
+            {
+                // Decompress straight from the mapping
+                if (chunk.offset > mMapping->size() || chunk.compressedSize > mMapping->size() - chunk.offset)
+                {
+                    OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                        mName + " - Unable to read file " + filename + ": Corrupted pack.",
+                        "PackArchive::readData");
+                }
+                src = mMapping->getPtr() + chunk.offset;
+            }
+            else
+            {
+                compressed.resize(chunk.compressedSize);
+                readPack(file, chunk.offset, &compressed[0], chunk.compressedSize);
+                src = &compressed[0];
+            }
+
+            // Whole chunks are decompressed in place, others up to the end of the
+            // file and cut
+            bool whole = (from == 0 && to == chunkSize);
+            if (!whole)
+                chunkData.resize(chunkSize);
+            uchar* out = whole ? dest : &chunkData[0];
+
+            bool valid = false;
+            if (chunk.codec == CODEC_LZ4)
+            {
+                const char* in = reinterpret_cast<const char*>(src);
+                char* dst = reinterpret_cast<char*>(out);
+                int compressedSize = static_cast<int>(chunk.compressedSize);
+                if (whole)
+                {
+                    valid = LZ4_decompress_safe(in, dst, compressedSize, static_cast<int>(chunkSize)) ==
+                        static_cast<int>(chunkSize);
+                }
+                else
+                {
+                    // Stops once the end of the file is out
+                    valid = LZ4_decompress_safe_partial(in, dst, compressedSize, static_cast<int>(to),
+                        static_cast<int>(chunkSize)) >= static_cast<int>(to);
+                }
+            }
+#if OGRE_NO_ZIP_ARCHIVE == 0
+            else if (chunk.codec == CODEC_ZLIB)
+            {
+                uLongf outSize = static_cast<uLongf>(chunkSize);
+                valid = uncompress(out, &outSize, src, static_cast<uLong>(chunk.compressedSize)) == Z_OK &&
+                    outSize == chunkSize;
+            }
+#endif
+            if (!valid)
+            {
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                    mName + " - Unable to read file " + filename + ": Corrupted pack.",
+                    "PackArchive::readData");
+            }
+            if (!whole)
+                memcpy(dest, out + from, to - from);
+        }
+    }
+    //-----------------------------------------------------------------------
+    DataStreamPtr PackArchive::open(const String& filename, bool readOnly)
+    {
+        // No lock, the contents don't change while the archive is loaded
+        const Entry* entry = findEntry(filename);
+        if (!entry)
+        {
+            LogManager::getSingleton().logMessage(
+                mName + " - Unable to open file " + filename + ", error was 'File not found.'", LML_CRITICAL);
+
+            // return null pointer
+            return DataStreamPtr();
+        }
+
+        size_t size = static_cast<size_t>(entry->size);
+        MemoryDataStream* stream = OGRE_NEW MemoryDataStream(filename, size, true, true);
+        DataStreamPtr ret(stream);
+        readData(entry->offset, size, stream->getPtr(), filename);
+        return ret;
+    }
+    //---------------------------------------------------------------------
+    DataStreamPtr PackArchive::create(const String& filename)
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+            "Modification of packs is not supported, write a new one with PackArchiveWriter",
+            "PackArchive::create");
+    }
+    //---------------------------------------------------------------------
+    void PackArchive::remove(const String& filename)
+    {
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+            "Modification of packs is not supported, write a new one with PackArchiveWriter",
+            "PackArchive::remove");
+    }
+    //-----------------------------------------------------------------------
+    StringVectorPtr PackArchive::list(bool recursive, bool dirs)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        StringVectorPtr ret = StringVectorPtr(OGRE_NEW_T(StringVector, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+
+        FileInfoList::iterator i, iend;
+        iend = mFileList.end();
+        for (i = mFileList.begin(); i != iend; ++i)
+            if ((dirs == (i->compressedSize == size_t (-1))) &&
+                (recursive || i->path.empty()))
+                ret->push_back(i->filename);
+
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    FileInfoListPtr PackArchive::listFileInfo(bool recursive, bool dirs)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        FileInfoList* fil = OGRE_NEW_T(FileInfoList, MEMCATEGORY_GENERAL)();
+        FileInfoList::const_iterator i, iend;
+        iend = mFileList.end();
+        for (i = mFileList.begin(); i != iend; ++i)
+            if ((dirs == (i->compressedSize == size_t (-1))) &&
+                (recursive || i->path.empty()))
+                fil->push_back(*i);
+
+        return FileInfoListPtr(fil, SPFM_DELETE_T);
+    }
+    //-----------------------------------------------------------------------
+    StringVectorPtr PackArchive::find(const String& pattern, bool recursive, bool dirs)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        StringVectorPtr ret = StringVectorPtr(OGRE_NEW_T(StringVector, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+        // If pattern contains a directory name, do a full match
+        bool full_match = (pattern.find ('/') != String::npos) ||
+                          (pattern.find ('\\') != String::npos);
+
+        FileInfoList::iterator i, iend;
+        iend = mFileList.end();
+        for (i = mFileList.begin(); i != iend; ++i)
+            if ((dirs == (i->compressedSize == size_t (-1))) &&
+                (recursive || full_match || i->path.empty()))
+                // Check basename matches pattern (packs are case insensitive)
+                if (StringUtil::match(full_match ? i->filename : i->basename, pattern, false))
+                    ret->push_back(i->filename);
+
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    FileInfoListPtr PackArchive::findFileInfo(const String& pattern,
+        bool recursive, bool dirs)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        FileInfoListPtr ret = FileInfoListPtr(OGRE_NEW_T(FileInfoList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+        // If pattern contains a directory name, do a full match
+        bool full_match = (pattern.find ('/') != String::npos) ||
+                          (pattern.find ('\\') != String::npos);
+
+        FileInfoList::const_iterator i, iend;
+        iend = mFileList.end();
+        for (i = mFileList.begin(); i != iend; ++i)
+            if ((dirs == (i->compressedSize == size_t (-1))) &&
+                (recursive || full_match || i->path.empty()))
+                // Check name matches pattern (packs are case insensitive)
+                if (StringUtil::match(full_match ? i->filename : i->basename, pattern, false))
+                    ret->push_back(*i);
+
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    bool PackArchive::exists(const String& filename)
+    {
+        return findEntry(filename) != 0;
+    }
+    //---------------------------------------------------------------------
+    time_t PackArchive::getModifiedTime(const String& filename)
+    {
+        // Files have no times of their own, so check the mod time of the pack
+        struct stat tagStat;
+        bool ret = (stat(mName.c_str(), &tagStat) == 0);
+
+        if (ret)
+        {
+            return tagStat.st_mtime;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    const String& PackArchiveFactory::getType(void) const
+    {
+        static String name = "Pack";
+        return name;
+    }
+    //-----------------------------------------------------------------------
+    PackArchiveWriter::PackArchiveWriter(const String& path, PackArchive::Codec codec, size_t chunkSize)
+        : mPath(path), mCodec(codec), mChunkSize(chunkSize), mDataSize(0), mFinished(false)
+    {
+        if (!PackArchive::isCodecSupported(codec))
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "The codec is not supported by this build",
+                "PackArchiveWriter::PackArchiveWriter");
+        }
+        if (chunkSize == 0 || chunkSize > LZ4_MAX_INPUT_SIZE)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Invalid chunk size " + StringConverter::toString(chunkSize),
+                "PackArchiveWriter::PackArchiveWriter");
+        }
+
+        mFile.open(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!mFile)
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Cannot open file " + path + " for writing",
+                "PackArchiveWriter::PackArchiveWriter");
+        }
+
+        // The header is filled in once everything else is written
+        static const char header[OGRE_PACK_HEADER_SIZE] = { 0 };
+        mFile.write(header, OGRE_PACK_HEADER_SIZE);
+        align(OGRE_PACK_DATA_ALIGNMENT);
+        mChunk.reserve(mChunkSize);
+    }
+    //-----------------------------------------------------------------------
+    PackArchiveWriter::~PackArchiveWriter()
+    {
+        if (!mFinished)
+        {
+            try
+            {
+                finish();
+            }
+            catch (Exception& e)
+            {
+                LogManager::getSingleton().logMessage(
+                    "Unable to finish pack " + mPath + ": " + e.getFullDescription(), LML_CRITICAL);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void PackArchiveWriter::align(size_t alignment)
+    {
+        static const char zeros[OGRE_PACK_DATA_ALIGNMENT] = { 0 };
+        size_t pos = static_cast<size_t>(mFile.tellp());
+        size_t padding = (alignment - pos % alignment) % alignment;
+        mFile.write(zeros, padding);
+    }
+    //-----------------------------------------------------------------------
+    void PackArchiveWriter::addFile(const String& filename, const DataStreamPtr& stream)
+    {
+        if (mFinished)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                "Cannot add " + filename + " to pack " + mPath + ", it is finished",
+                "PackArchiveWriter::addFile");
+        }
+
+        Entry entry;
+        entry.path = filename;
+        std::replace(entry.path.begin(), entry.path.end(), '\\', '/');
+        if (!mKeys.insert(entryKey(entry.path)).second)
+        {
+            OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM,
+                "Pack " + mPath + " already has a file " + filename,
+                "PackArchiveWriter::addFile");
+        }
+        entry.offset = mDataSize;
+        entry.size = 0;
+
+        // Read straight into the chunk, flushing it whenever it's full
+        while (!stream->eof())
+        {
+            size_t filled = mChunk.size();
+            mChunk.resize(mChunkSize);
+            size_t read = stream->read(&mChunk[filled], mChunkSize - filled);
+            mChunk.resize(filled + read);
+            entry.size += read;
+            mDataSize += read;
+            if (mChunk.size() == mChunkSize)
+                flushChunk();
+            else if (read == 0)
+                break;
+        }
+        mEntries.push_back(entry);
+    }
+    //-----------------------------------------------------------------------
+    size_t PackArchiveWriter::addArchive(Archive* archive)
+    {
+        FileInfoListPtr files = archive->listFileInfo(true);
+        for (FileInfoList::iterator i = files->begin(); i != files->end(); ++i)
+        {
+            // Archives don't agree on filename, but do on path and basename
+            String path = i->path + i->basename;
+            DataStreamPtr stream = archive->open(path);
+            if (stream.isNull())
+            {
+                OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                    "Cannot open " + path + " in " + archive->getName(),
+                    "PackArchiveWriter::addArchive");
+            }
+            addFile(path, stream);
+        }
+        return files->size();
+    }
+    //-----------------------------------------------------------------------
+    void PackArchiveWriter::flushChunk(void)
+    {
+        if (mChunk.empty())
+            return;
+
+        align(OGRE_PACK_CHUNK_ALIGNMENT);
+        Chunk chunk;
+        chunk.offset = static_cast<uint64>(mFile.tellp());
+        chunk.codec = mCodec;
+        size_t size = mChunk.size();
+
+        // Only worth keeping if it is smaller than the chunk
+        vector<uchar>::type compressed(size);
+        size_t compressedSize = 0;
+        if (mCodec == PackArchive::CODEC_LZ4)
+        {
+            int destSize = LZ4_compress_default(reinterpret_cast<const char*>(&mChunk[0]),
+                reinterpret_cast<char*>(&compressed[0]), static_cast<int>(size), static_cast<int>(size - 1));
+            compressedSize = static_cast<size_t>(std::max(destSize, 0));
+        }
+#if OGRE_NO_ZIP_ARCHIVE == 0
+        else if (mCodec == PackArchive::CODEC_ZLIB)
+        {
+            uLongf destSize = static_cast<uLongf>(size - 1);
+            if (size > 1 && compress2(&compressed[0], &destSize, &mChunk[0], static_cast<uLong>(size),
+                Z_BEST_COMPRESSION) == Z_OK)
+                compressedSize = destSize;
+        }
+#endif
+
+        if (compressedSize == 0)
+        {
+            chunk.codec = PackArchive::CODEC_NONE;
+            chunk.compressedSize = static_cast<uint32>(size);
+            mFile.write(reinterpret_cast<const char*>(&mChunk[0]), size);
+        }
+        else
+        {
+            chunk.compressedSize = static_cast<uint32>(compressedSize);
+            mFile.write(reinterpret_cast<const char*>(&compressed[0]), compressedSize);
+        }
+        if (!mFile)
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Error writing pack " + mPath,
+                "PackArchiveWriter::flushChunk");
+        }
+        mChunks.push_back(chunk);
+        mChunk.clear();
+    }
+    //-----------------------------------------------------------------------
+    void PackArchiveWriter::finish(void)
+    {
+        if (mFinished)
+            return;
+        mFinished = true;
+
+        flushChunk();
+        align(OGRE_PACK_CHUNK_ALIGNMENT);
+        uint64 contentsOffset = static_cast<uint64>(mFile.tellp());
+
+        // Names are stored in the order the files were added
+        vector<uchar>::type names;
+        vector<uint32>::type nameOffsets(mEntries.size());
+        for (size_t i = 0; i < mEntries.size(); ++i)
+        {
+            nameOffsets[i] = static_cast<uint32>(names.size());
+            names.insert(names.end(), mEntries[i].path.begin(), mEntries[i].path.end());
+        }
+
+        // Entries are sorted by hash, then lower case path for hashes that collide
+        typedef std::pair<std::pair<uint32, String>, size_t> SortKey;
+        vector<SortKey>::type order(mEntries.size());
+        for (size_t i = 0; i < mEntries.size(); ++i)
+        {
+            String key = entryKey(mEntries[i].path);
+            order[i] = SortKey(std::make_pair(hashKey(key), key), i);
+        }
+        std::sort(order.begin(), order.end());
+
+        vector<uchar>::type contents;
+        contents.reserve(mEntries.size() * OGRE_PACK_ENTRY_SIZE +
+            mChunks.size() * OGRE_PACK_CHUNK_RECORD_SIZE + names.size());
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            const Entry& entry = mEntries[order[i].second];
+            writeUInt(contents, order[i].first.first, 4);
+            writeUInt(contents, nameOffsets[order[i].second], 4);
+            writeUInt(contents, entry.path.size(), 4);
+            writeUInt(contents, 0, 4);
+            writeUInt(contents, entry.offset, 8);
+            writeUInt(contents, entry.size, 8);
+        }
+        for (size_t i = 0; i < mChunks.size(); ++i)
+        {
+            writeUInt(contents, mChunks[i].offset, 8);
+            writeUInt(contents, mChunks[i].compressedSize, 4);
+            writeUInt(contents, mChunks[i].codec, 2);
+            writeUInt(contents, 0, 2);
+        }
+        contents.insert(contents.end(), names.begin(), names.end());
+        if (!contents.empty())
+            mFile.write(reinterpret_cast<const char*>(&contents[0]), contents.size());
+
+        vector<uchar>::type header(OGRE_PACK_MAGIC, OGRE_PACK_MAGIC + 8);
+        writeUInt(header, OGRE_PACK_VERSION, 4);
+        writeUInt(header, mChunkSize, 4);
+        writeUInt(header, mEntries.size(), 4);
+        writeUInt(header, mChunks.size(), 4);
+        writeUInt(header, mDataSize, 8);
+        writeUInt(header, contentsOffset, 8);
+        writeUInt(header, names.size(), 8);
+        header.resize(OGRE_PACK_HEADER_SIZE, 0);
+        mFile.seekp(0);
+        mFile.write(reinterpret_cast<const char*>(&header[0]), header.size());
+
+        mFile.close();
+        if (mFile.fail())
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Error writing pack " + mPath,
+                "PackArchiveWriter::finish");
+        }
+    }
+    //-----------------------------------------------------------------------
+    uint64 PackArchiveWriter::getCompressedSize(void) const
+    {
+        uint64 size = 0;
+        for (size_t i = 0; i < mChunks.size(); ++i)
+            size += mChunks[i].compressedSize;
+        return size;
+    }
+
+}
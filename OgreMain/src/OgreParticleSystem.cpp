@@ -41,6 +41,7 @@ THE SOFTWARE.
 #include "OgreSceneManager.h"
 #include "OgreControllerManager.h"
 #include "OgreRoot.h"
+#include "OgreProfiler.h"
 
 namespace Ogre {
     // Init statics
@@ -72,7 +73,13 @@ namespace Ogre {
 
         Real getValue(void) const { return 0; } // N/A
 
-        void setValue(Real value) { mTarget->_update(value); }
+        void setValue(Real value)
+        {
+            // Profiled here rather than in _update so that fastForward calls
+            // made outside of a frame don't open a stray root profile
+            OgreProfileGroupLiteral("ParticleSystem::_update", OGREPROF_GENERAL);
+            mTarget->_update(value);
+        }
 
     };
     //-----------------------------------------------------------------------
@@ -151,10 +151,20 @@ namespace Ogre {
 
     //---------------------------------------------------------------------
     // Performs CPUID instruction with 'query', fill the results, and return value of eax.
+    // The sub-leaf in ecx is always zero, which is what the structured extended
+    // feature flags (query 7) need and is ignored by the other queries.
     static uint _performCpuid(int query, CpuidResult& result)
     {
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
-    #if _MSC_VER >= 1400 
+    #if _MSC_VER >= 1500
+        int CPUInfo[4];
+        __cpuidex(CPUInfo, query, 0);
+        result._eax = CPUInfo[0];
+        result._ebx = CPUInfo[1];
+        result._ecx = CPUInfo[2];
+        result._edx = CPUInfo[3];
+        return result._eax;
+    #elif _MSC_VER >= 1400 
         int CPUInfo[4];
         __cpuid(CPUInfo, query);
         result._eax = CPUInfo[0];
@@ -167,6 +177,7 @@ namespace Ogre {
         {
             mov     edi, result
             mov     eax, query
+            xor     ecx, ecx
             cpuid
             mov     [edi]._eax, eax
             mov     [edi]._ebx, ebx
@@ -179,7 +190,7 @@ namespace Ogre {
         #if OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_64
         __asm__
         (
-            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query)
+            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query), "c" (0)
         );
         #else
         __asm__
@@ -189,7 +200,7 @@ namespace Ogre {
             "movl   %%ebx, %%edi    \n\t"
             "popl   %%ebx           \n\t"
             : "=a" (result._eax), "=D" (result._ebx), "=c" (result._ecx), "=d" (result._edx)
-            : "a" (query)
+            : "a" (query), "c" (0)
         );
        #endif // OGRE_ARCHITECTURE_64
         return result._eax;
@@ -276,6 +287,30 @@ namespace Ogre {
 #endif
     }
 
+    //---------------------------------------------------------------------
+    // Detect whether or not os saves the AVX registers on context switches,
+    // must only be called if CPUID reports OSXSAVE.
+    static bool _checkOperatingSystemSupportAVX(void)
+    {
+#if OGRE_COMPILER == OGRE_COMPILER_MSVC && _MSC_FULL_VER >= 160040219
+        // XCR0 bits 1 and 2, SSE and AVX state
+        return (_xgetbv(0) & 6) == 6;
+#elif (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && OGRE_PLATFORM != OGRE_PLATFORM_NACL && OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN
+        uint xcr0Low, xcr0High;
+        // xgetbv, spelt out for assemblers that don't know it
+        __asm__ __volatile__
+        (
+            ".byte 0x0f, 0x01, 0xd0" : "=a" (xcr0Low), "=d" (xcr0High) : "c" (0)
+        );
+        (void)xcr0High;
+        // XCR0 bits 1 and 2, SSE and AVX state
+        return (xcr0Low & 6) == 6;
+#else
+        // TODO: Supports other compiler, assumed isn't supported by default
+        return false;
+#endif
+    }
+
     //---------------------------------------------------------------------
     // Compiler-independent routines
     //---------------------------------------------------------------------
@@ -300,6 +335,12 @@ namespace Ogre {
 #define CPUID_STD_SSE3              (1<<0)      // ECX[0]  - Bit 0 of standard function 1 indicate SSE3 supported
 #define CPUID_STD_SSE41             (1<<19)     // ECX[19] - Bit 0 of standard function 1 indicate SSE41 supported
 #define CPUID_STD_SSE42             (1<<20)     // ECX[20] - Bit 0 of standard function 1 indicate SSE42 supported
+#define CPUID_STD_FMA               (1<<12)     // ECX[12] - Bit 12 of standard function 1 indicate FMA supported
+#define CPUID_STD_OSXSAVE           (1<<27)     // ECX[27] - Bit 27 of standard function 1 indicate os uses XSAVE
+#define CPUID_STD_AVX               (1<<28)     // ECX[28] - Bit 28 of standard function 1 indicate AVX supported
+
+#define CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES 0x7
+#define CPUID_SEF_AVX2              (1<<5)      // EBX[5] - Bit 5 of function 7 indicate AVX2 supported
 
 #define CPUID_FAMILY_ID_MASK        0x0F00      // EAX[11:8] - Bit 11 thru 8 contains family  processor id
 #define CPUID_EXT_FAMILY_ID_MASK    0x0F00000   // EAX[23:20] - Bit 23 thru 20 contains extended family processor id
@@ -416,6 +457,26 @@ namespace Ogre {
                             features |= PlatformInformation::CPU_FEATURE_INVARIANT_TSC;
                     }
                 }
+
+                // AVX family, the same on every vendor
+                const uint maxStandardFunctionSupport = _performCpuid(CPUID_FUNC_VENDOR_ID, result);
+                _performCpuid(CPUID_FUNC_STANDARD_FEATURES, result);
+                if ((result._ecx & CPUID_STD_AVX) && (result._ecx & CPUID_STD_OSXSAVE) &&
+                    _checkOperatingSystemSupportAVX())
+                {
+                    features |= PlatformInformation::CPU_FEATURE_AVX;
+
+                    if (result._ecx & CPUID_STD_FMA)
+                        features |= PlatformInformation::CPU_FEATURE_FMA;
+
+                    if (maxStandardFunctionSupport >= CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES)
+                    {
+                        _performCpuid(CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES, result);
+
+                        if (result._ebx & CPUID_SEF_AVX2)
+                            features |= PlatformInformation::CPU_FEATURE_AVX2;
+                    }
+                }
             }
         }
 
@@ -431,7 +492,10 @@ namespace Ogre {
             | PlatformInformation::CPU_FEATURE_SSE2
             | PlatformInformation::CPU_FEATURE_SSE3
             | PlatformInformation::CPU_FEATURE_SSE41
-            | PlatformInformation::CPU_FEATURE_SSE42;
+            | PlatformInformation::CPU_FEATURE_SSE42
+            | PlatformInformation::CPU_FEATURE_AVX
+            | PlatformInformation::CPU_FEATURE_AVX2
+            | PlatformInformation::CPU_FEATURE_FMA;
 
         if ((features & sse_features) && !_checkOperatingSystemSupportSSE())
         {
@@ -696,6 +760,12 @@ namespace Ogre {
                 " *        SSE41: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_SSE41), true));
             pLog->logMessage(
                 " *        SSE42: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_SSE42), true));
+            pLog->logMessage(
+                " *          AVX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX), true));
+            pLog->logMessage(
+                " *         AVX2: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX2), true));
+            pLog->logMessage(
+                " *          FMA: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_FMA), true));
             pLog->logMessage(
                 " *          MMX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_MMX), true));
             pLog->logMessage(
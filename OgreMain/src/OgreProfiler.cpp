@@ -44,12 +44,18 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #include "OgreLogManager.h"
 #include "OgreRoot.h"
 #include "OgreRenderSystem.h"
+#include "OgreStringConverter.h"
+#include "OgreBitwise.h"
+#include <fstream>
 
 namespace Ogre {
     //-----------------------------------------------------------------------
     // PROFILE DEFINITIONS
     //-----------------------------------------------------------------------
     template<> Profiler* Singleton<Profiler>::msSingleton = 0;
+    Profiler::TraceNameMap Profiler::msTraceNameIds;
+    StringVector Profiler::msTraceNames;
+    OGRE_STATIC_MUTEX_INSTANCE(Profiler::msTraceNameMutex);
     Profiler* Profiler::getSingletonPtr(void)
     {
         return msSingleton;
@@ -61,6 +67,14 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     Profile::Profile(const String& profileName, uint32 groupID) 
         : mName(profileName)
+        , mInternedName(0)
+        , mGroupID(groupID)
+    {
+        Ogre::Profiler::getSingleton().beginProfile(profileName, groupID);
+    }
+    //-----------------------------------------------------------------------
+    Profile::Profile(const ProfileName& profileName, uint32 groupID) 
+        : mInternedName(&profileName)
         , mGroupID(groupID)
     {
         Ogre::Profiler::getSingleton().beginProfile(profileName, groupID);
@@ -68,7 +82,73 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     Profile::~Profile()
     {
-        Ogre::Profiler::getSingleton().endProfile(mName, mGroupID);
+        if (mInternedName)
+            Ogre::Profiler::getSingleton().endProfile(*mInternedName, mGroupID);
+        else
+            Ogre::Profiler::getSingleton().endProfile(mName, mGroupID);
+    }
+    //-----------------------------------------------------------------------
+    ProfileName::ProfileName(const String& profileName)
+        : name(profileName)
+        , traceNameId(Profiler::getTraceNameId(profileName))
+    {
+    }
+    //-----------------------------------------------------------------------
+
+
+    //-----------------------------------------------------------------------
+    // TRACE BUFFER DEFINITIONS
+    //-----------------------------------------------------------------------
+    ProfileTraceBuffer::ProfileTraceBuffer(size_t capacity, uint32 threadIndex)
+        : mEvents(0)
+        , mCapacity(0)
+        , mWriteSlot(0)
+        , mHead(0)
+        , mStart(0)
+        , mThreadIndex(threadIndex)
+    {
+        mCapacity = Bitwise::firstPO2From((uint32)std::max(capacity, (size_t)2));
+    }
+    //-----------------------------------------------------------------------
+    void ProfileTraceBuffer::allocate()
+    {
+        mEvents = OGRE_ALLOC_T(ProfileTraceEvent, mCapacity + 1, MEMCATEGORY_GENERAL);
+    }
+    //-----------------------------------------------------------------------
+    ProfileTraceBuffer::~ProfileTraceBuffer()
+    {
+        if (mEvents)
+            OGRE_FREE(mEvents, MEMCATEGORY_GENERAL);
+    }
+    //-----------------------------------------------------------------------
+    size_t ProfileTraceBuffer::getEvents(EventList& events) const
+    {
+        const size_t capacity = mCapacity;
+        const size_t numSlots = capacity + 1;
+        const size_t head = mHead.get();
+        const size_t start = mStart.get();
+        if (head == start)
+            return 0;
+
+        size_t first = std::max(start, head > capacity ? head - capacity : 0);
+        size_t lost = first - std::min(first, start);
+
+        const size_t base = events.size();
+        for (size_t i = first; i != head; ++i)
+            events.push_back(mEvents[i % numSlots]);
+
+        // the writer may have lapped the entries at the front while we copied;
+        // event i shares its slot with event i + numSlots, which is being
+        // written once the head has gone past i + capacity
+        const size_t newHead = mHead.get();
+        if (newHead > first + capacity)
+        {
+            size_t overwritten = std::min(newHead - capacity - first, head - first);
+            events.erase(events.begin() + base, events.begin() + base + overwritten);
+            lost += overwritten;
+        }
+
+        return lost;
     }
     //-----------------------------------------------------------------------
 
@@ -91,8 +171,14 @@ namespace Ogre {
         , mMaxTotalFrameTime(0)
         , mAverageFrameTime(0)
         , mResetExtents(false)
+        , mTraceEnabled(false)
+        , mTraceBufferCapacity(65536)
+        , OGRE_THREAD_POINTER_INIT(mTraceThread)
     {
         mRoot.hierarchicalLvl = 0 - 1;
+#if OGRE_THREAD_SUPPORT
+        mProfilerThreadId = OGRE_THREAD_CURRENT_ID;
+#endif
     }
     //-----------------------------------------------------------------------
     ProfileInstance::ProfileInstance(void)
@@ -135,6 +221,11 @@ namespace Ogre {
 
         // clear all our lists
         mDisabledProfiles.clear();
+
+        OGRE_THREAD_POINTER_DELETE(mTraceThread);
+        for (TraceBufferList::iterator i = mTraceBuffers.begin(); i != mTraceBuffers.end(); ++i)
+            OGRE_DELETE *i;
+        mTraceBuffers.clear();
     }
     //-----------------------------------------------------------------------
     void Profiler::setTimer(Timer* t)
@@ -196,6 +287,28 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Profiler::beginProfile(const String& profileName, uint32 groupID) 
     {
+        beginProfileImpl(profileName, groupID, 0);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::beginProfile(const ProfileName& profileName, uint32 groupID) 
+    {
+        beginProfileImpl(profileName.name, groupID, &profileName);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::beginProfileImpl(const String& profileName, uint32 groupID, const ProfileName* interned) 
+    {
+        if (mTraceEnabled.get() && (groupID & mProfileMask))
+        {
+            // read the time last, to leave the name lookup out of the profile
+            ProfileTraceBuffer* buffer = getThreadTraceBuffer();
+            uint32 nameId = interned ? interned->traceNameId : getTraceNameId(profileName);
+            buffer->push(mTimer->getMicroseconds(), nameId, true);
+        }
+
+        // the hierarchy is only built for one thread
+        if (!isProfilerThread())
+            return;
+
         // regardless of whether or not we are enabled, we need the application's root profile (ie the first profile started each frame)
         // we need this so bogus profiles don't show up when users enable profiling mid frame
         // so we check
@@ -255,6 +368,27 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Profiler::endProfile(const String& profileName, uint32 groupID) 
     {
+        endProfileImpl(profileName, groupID, 0);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::endProfile(const ProfileName& profileName, uint32 groupID) 
+    {
+        endProfileImpl(profileName.name, groupID, &profileName);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::endProfileImpl(const String& profileName, uint32 groupID, const ProfileName* interned) 
+    {
+        if (mTraceEnabled.get() && (groupID & mProfileMask))
+        {
+            // read the time first, to leave the name lookup out of the profile
+            ulong time = mTimer->getMicroseconds();
+            ProfileTraceBuffer* buffer = getThreadTraceBuffer();
+            buffer->push(time, interned ? interned->traceNameId : getTraceNameId(profileName), false);
+        }
+
+        if (!isProfilerThread())
+            return;
+
         if(!mEnabled) 
         {
             // if the profiler received a request to be enabled or disabled
@@ -614,4 +748,128 @@ namespace Ogre {
             mListeners.erase(i);
     }
     //-----------------------------------------------------------------------
+    bool Profiler::isProfilerThread() const
+    {
+#if OGRE_THREAD_SUPPORT
+        return OGRE_THREAD_CURRENT_ID == mProfilerThreadId;
+#else
+        return true;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    ProfileTraceBuffer* Profiler::getThreadTraceBuffer()
+    {
+        TraceThread* thread = OGRE_THREAD_POINTER_GET(mTraceThread);
+        if (thread)
+            return thread->buffer;
+
+        OGRE_LOCK_MUTEX(mTraceMutex);
+        ProfileTraceBuffer* buffer = OGRE_NEW ProfileTraceBuffer(mTraceBufferCapacity,
+                                                                 static_cast<uint32>(mTraceBuffers.size()));
+        buffer->threadName = isProfilerThread() ? String("Main") :
+            "Thread " + StringConverter::toString(mTraceBuffers.size());
+        mTraceBuffers.push_back(buffer);
+
+        thread = OGRE_NEW TraceThread();
+        thread->buffer = buffer;
+        OGRE_THREAD_POINTER_SET(mTraceThread, thread);
+
+        return buffer;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::setTraceThreadName(const String& name)
+    {
+        ProfileTraceBuffer* buffer = getThreadTraceBuffer();
+
+        OGRE_LOCK_MUTEX(mTraceMutex);
+        buffer->threadName = name;
+    }
+    //-----------------------------------------------------------------------
+    uint32 Profiler::getTraceNameId(const String& profileName)
+    {
+        OGRE_LOCK_MUTEX(msTraceNameMutex);
+        TraceNameMap::iterator i = msTraceNameIds.find(profileName);
+        if (i != msTraceNameIds.end())
+            return i->second;
+
+        uint32 nameId = static_cast<uint32>(msTraceNames.size());
+        msTraceNames.push_back(profileName);
+        msTraceNameIds[profileName] = nameId;
+        return nameId;
+    }
+    //-----------------------------------------------------------------------
+    String Profiler::getTraceName(uint32 nameId)
+    {
+        OGRE_LOCK_MUTEX(msTraceNameMutex);
+        return nameId < msTraceNames.size() ? msTraceNames[nameId] : BLANKSTRING;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::clearTrace()
+    {
+        OGRE_LOCK_MUTEX(mTraceMutex);
+        for (TraceBufferList::iterator i = mTraceBuffers.begin(); i != mTraceBuffers.end(); ++i)
+            (*i)->clear();
+    }
+    //-----------------------------------------------------------------------
+    static String escapeTraceString(const String& str)
+    {
+        String escaped;
+        escaped.reserve(str.size());
+        for (String::const_iterator i = str.begin(); i != str.end(); ++i)
+        {
+            if (*i == '"' || *i == '\\')
+                escaped += '\\';
+            if (static_cast<unsigned char>(*i) >= 0x20)
+                escaped += *i;
+        }
+        return escaped;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::exportTrace(std::ostream& stream) const
+    {
+        OGRE_LOCK_MUTEX(mTraceMutex);
+        OGRE_LOCK_MUTEX(msTraceNameMutex);
+
+        stream << "{\"traceEvents\":[";
+        bool first = true;
+
+        ProfileTraceBuffer::EventList events;
+        for (TraceBufferList::const_iterator b = mTraceBuffers.begin(); b != mTraceBuffers.end(); ++b)
+        {
+            const ProfileTraceBuffer* buffer = *b;
+            const uint32 tid = buffer->getThreadIndex();
+
+            stream << (first ? "\n" : ",\n")
+                   << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid
+                   << ",\"args\":{\"name\":\"" << escapeTraceString(buffer->threadName) << "\"}}";
+            first = false;
+
+            events.clear();
+            buffer->getEvents(events);
+
+            for (ProfileTraceBuffer::EventList::const_iterator e = events.begin(); e != events.end(); ++e)
+            {
+                const String& name = e->nameId < msTraceNames.size() ? msTraceNames[e->nameId] : BLANKSTRING;
+                stream << ",\n{\"name\":\"" << escapeTraceString(name)
+                       << "\",\"ph\":\"" << (e->begin ? 'B' : 'E')
+                       << "\",\"ts\":" << e->time
+                       << ",\"pid\":0,\"tid\":" << tid << "}";
+            }
+        }
+
+        stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::exportTrace(const String& filename) const
+    {
+        std::ofstream stream(filename.c_str());
+        if (!stream)
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Cannot open '" + filename + "' for writing", "Profiler::exportTrace");
+        }
+
+        exportTrace(stream);
+    }
+    //-----------------------------------------------------------------------
 }
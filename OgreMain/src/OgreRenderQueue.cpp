@@ -41,12 +41,52 @@ THE SOFTWARE.
 
 namespace Ogre {
 
+    //---------------------------------------------------------------------
+    RenderQueueEntryCache::CameraEntries& RenderQueueEntryCache::getCameraEntries(const Camera* cam)
+    {
+        CameraEntriesList::iterator i, iend, oldest;
+        iend = mCameras.end();
+        for (i = mCameras.begin(); i != iend; ++i)
+        {
+            if (i->camera == cam)
+                return *i;
+        }
+
+        if (mCameras.size() < MAX_CAMERAS)
+        {
+            mCameras.push_back(CameraEntries());
+            oldest = mCameras.end() - 1;
+        }
+        else
+        {
+            oldest = mCameras.begin();
+            for (i = mCameras.begin(); i != iend; ++i)
+            {
+                if (i->pass < oldest->pass)
+                    oldest = i;
+            }
+        }
+        oldest->camera = cam;
+        oldest->pass = 0;
+        oldest->signature = 0;
+        oldest->entries.clear();
+        return *oldest;
+    }
     //---------------------------------------------------------------------
     RenderQueue::RenderQueue()
         : mSplitPassesByLightingType(false)
         , mSplitNoShadowPasses(false)
         , mShadowCastersCannotBeReceivers(false)
         , mRenderableListener(0)
+        , mDeferredObjects(0)
+        , mEntryCacheCamera(0)
+        , mEntryCachePass(0)
+        , mPreviousEntryCachePass(0)
+        , mEntryCachePassCounter(0)
+        , mEntryCacheObjects(0)
+        , mEntryCacheContinuingObjects(0)
+        , mRecordedEntries(0)
+        , mEntryCacheEpoch(0)
     {
         // Create the 'main' queue up-front since we'll always need that
         mGroups.insert(
@@ -116,6 +156,9 @@ namespace Ogre {
             // tell material it's been used (incase changed)
             pTech->getParent()->touch();
         }
+
+        if (mRecordedEntries)
+            mRecordedEntries->push_back(RenderQueueEntryCache::Entry(pRend, pTech, groupID, priority));
         
         pGroup->addRenderable(pRend, pTech, priority);
 
@@ -127,6 +170,13 @@ namespace Ogre {
         SceneManagerEnumerator::SceneManagerIterator scnIt =
             SceneManagerEnumerator::getSingleton().getSceneManagerIterator();
 
+        // Passes about to be destroyed may be referenced by cached entries
+        bool passesDestroyed;
+        {
+            OGRE_LOCK_MUTEX(Pass::msPassGraveyardMutex);
+            passesDestroyed = !Pass::getPassGraveyard().empty();
+        }
+
         // Note: We clear dirty passes from all RenderQueues in all 
         // SceneManagers, because the following recalculation of pass hashes
         // also considers all RenderQueues and could become inconsistent, otherwise.
@@ -134,6 +184,8 @@ namespace Ogre {
         {
             SceneManager* sceneMgr = scnIt.getNext();
             RenderQueue* queue = sceneMgr->getRenderQueue();
+            if (passesDestroyed)
+                ++queue->mEntryCacheEpoch;
 
             RenderQueueGroupMap::iterator i, iend;
             i = queue->mGroups.begin();
@@ -286,6 +338,95 @@ namespace Ogre {
 
             pDstGroup->merge( pSrcGroup );
         }
+
+        if (mEntryCachePass && rhs->mEntryCachePass == mEntryCachePass)
+        {
+            mEntryCacheObjects += rhs->mEntryCacheObjects;
+            mEntryCacheContinuingObjects += rhs->mEntryCacheContinuingObjects;
+            mEntryCacheStats.merge(rhs->mEntryCacheStats);
+        }
+    }
+    //---------------------------------------------------------------------
+    void RenderQueue::_beginEntryCachePass(const Camera* cam)
+    {
+        mEntryCacheCamera = cam;
+        mEntryCachePass = ++mEntryCachePassCounter;
+        // 0 is reserved for 'no pass'
+        if (!mEntryCachePass)
+            mEntryCachePass = ++mEntryCachePassCounter;
+        mEntryCacheObjects = mEntryCacheContinuingObjects = 0;
+        mEntryCacheStats.reset();
+
+        mPreviousEntryCachePass = 0;
+        EntryCacheCameraMap::iterator i = mEntryCacheCameras.find(cam);
+        if (i != mEntryCacheCameras.end() && i->second.epoch == mEntryCacheEpoch &&
+            i->second.defaultGroup == mDefaultQueueGroup &&
+            i->second.defaultPriority == mDefaultRenderablePriority)
+            mPreviousEntryCachePass = i->second.pass;
+    }
+    //---------------------------------------------------------------------
+    const RenderQueue::EntryCacheStats& RenderQueue::_endEntryCachePass(void)
+    {
+        size_t previousObjects = 0;
+        EntryCacheCamera& state = mEntryCacheCameras[mEntryCacheCamera];
+        if (mPreviousEntryCachePass)
+            previousObjects = state.numObjects;
+
+        mEntryCacheStats.enteredObjects += mEntryCacheObjects - mEntryCacheContinuingObjects;
+        mEntryCacheStats.leftObjects += previousObjects - mEntryCacheContinuingObjects;
+
+        state.pass = mEntryCachePass;
+        state.numObjects = mEntryCacheObjects;
+        state.epoch = mEntryCacheEpoch;
+        state.defaultGroup = mDefaultQueueGroup;
+        state.defaultPriority = mDefaultRenderablePriority;
+
+        mEntryCacheCamera = 0;
+        mEntryCachePass = mPreviousEntryCachePass = 0;
+        return mEntryCacheStats;
+    }
+    //---------------------------------------------------------------------
+    void RenderQueue::_joinEntryCachePass(const RenderQueue* rhs)
+    {
+        mEntryCacheCamera = rhs->mEntryCacheCamera;
+        mEntryCachePass = rhs->mEntryCachePass;
+        mPreviousEntryCachePass = rhs->mPreviousEntryCachePass;
+        mEntryCacheObjects = mEntryCacheContinuingObjects = 0;
+        mEntryCacheStats.reset();
+    }
+    //---------------------------------------------------------------------
+    void RenderQueue::updateRenderQueueCached(MovableObject* mo)
+    {
+        RenderQueueEntryCache::CameraEntries& ce = 
+            mo->_getRenderQueueEntryCache()->getCameraEntries(mEntryCacheCamera);
+        uint32 signature = mRenderableListener ? 0 : mo->_getRenderQueueSignature();
+        bool continuing = mPreviousEntryCachePass && ce.pass == mPreviousEntryCachePass;
+
+        ++mEntryCacheObjects;
+        if (continuing)
+            ++mEntryCacheContinuingObjects;
+
+        if (continuing && signature && signature == ce.signature)
+        {
+            RenderQueueEntryCache::EntryList::const_iterator i, iend;
+            iend = ce.entries.end();
+            for (i = ce.entries.begin(); i != iend; ++i)
+            {
+                i->technique->getParent()->touch();
+                getQueueGroup(i->groupID)->addRenderable(i->renderable, i->technique, i->priority);
+            }
+            mEntryCacheStats.reusedRenderables += ce.entries.size();
+        }
+        else
+        {
+            ce.entries.clear();
+            mRecordedEntries = &ce.entries;
+            mo->_updateRenderQueue(this);
+            mRecordedEntries = 0;
+            ce.signature = signature;
+            mEntryCacheStats.reinsertedRenderables += ce.entries.size();
+        }
+        ce.pass = mEntryCachePass;
     }
 
     //---------------------------------------------------------------------
@@ -294,6 +435,12 @@ namespace Ogre {
         bool onlyShadowCasters, 
         VisibleObjectsBoundsInfo* visibleBounds)
     {
+        if (mDeferredObjects && !mo->_canUpdateRenderQueueConcurrently())
+        {
+            mDeferredObjects->push_back(mo);
+            return;
+        }
+
         mo->_notifyCurrentCamera(cam);
         if (mo->isVisible())
         {
@@ -302,7 +449,10 @@ namespace Ogre {
 
             if (!onlyShadowCasters || mo->getCastShadows())
             {
-                mo -> _updateRenderQueue( this );
+                if (mEntryCachePass)
+                    updateRenderQueueCached(mo);
+                else
+                    mo -> _updateRenderQueue( this );
                 if (visibleBounds)
                 {
                     visibleBounds->merge(mo->getWorldBoundingBox(true), 
@@ -36,6 +36,8 @@ namespace Ogre {
         RenderablePass, uint32> QueuedRenderableCollection::msRadixSorter1;
     RadixSort<QueuedRenderableCollection::RenderablePassList,
         RenderablePass, float> QueuedRenderableCollection::msRadixSorter2;
+    RadixSort<QueuedRenderableCollection::RenderablePassList,
+        RenderablePass, uint64> QueuedRenderableCollection::msRadixSorterKey;
 
 
     //-----------------------------------------------------------------------
@@ -306,8 +308,9 @@ namespace Ogre {
             i->second->clear();
         }
 
-        // Clear sorted list
+        // Clear sorted lists
         mSortedDescending.clear();
+        mSortedByKey.clear();
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::removePassGroup(Pass* p)
@@ -358,6 +361,13 @@ namespace Ogre {
             }
         }
 
+        if (mOrganisationMode & OM_SORT_KEY)
+        {
+            // Radix sorting is linear in the number of items, and returns early
+            // when the list is still in order from the last frame
+            msRadixSorterKey.sort(mSortedByKey, RadixSortFunctorKey(cam));
+        }
+
         // Nothing needs to be done for pass groups, they auto-organise
 
     }
@@ -370,6 +380,11 @@ namespace Ogre {
             mSortedDescending.push_back(RenderablePass(rend, pass));
         }
 
+        if (mOrganisationMode & OM_SORT_KEY)
+        {
+            mSortedByKey.push_back(RenderablePass(rend, pass));
+        }
+
         if (mOrganisationMode & OM_PASS_GROUP)
         {
             PassGroupRenderableMap::iterator i = mGrouped.find(pass);
@@ -402,10 +417,14 @@ namespace Ogre {
             // try to fall back
             if (OM_PASS_GROUP & mOrganisationMode)
                 om = OM_PASS_GROUP;
+            else if (OM_SORT_KEY & mOrganisationMode && om == OM_PASS_GROUP)
+                om = OM_SORT_KEY;
             else if (OM_SORT_ASCENDING & mOrganisationMode)
                 om = OM_SORT_ASCENDING;
             else if (OM_SORT_DESCENDING & mOrganisationMode)
                 om = OM_SORT_DESCENDING;
+            else if (OM_SORT_KEY & mOrganisationMode)
+                om = OM_SORT_KEY;
             else
                 OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
                     "Organisation mode requested in acceptVistor was not notified "
@@ -424,6 +443,9 @@ namespace Ogre {
         case OM_SORT_ASCENDING:
             acceptVisitorAscending(visitor);
             break;
+        case OM_SORT_KEY:
+            acceptVisitorKeyed(visitor);
+            break;
         }
         
     }
@@ -481,9 +503,34 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::acceptVisitorKeyed(
+        QueuedRenderableVisitor* visitor) const
+    {
+        // Visit the pass each time it changes along the sorted list
+        const Pass* currentPass = 0;
+        bool skipPass = false;
+        RenderablePassList::const_iterator i, iend;
+
+        iend = mSortedByKey.end();
+        for (i = mSortedByKey.begin(); i != iend; ++i)
+        {
+            if (i->pass != currentPass)
+            {
+                currentPass = i->pass;
+                // Visit Pass - allow skip
+                skipPass = !visitor->visit(currentPass);
+            }
+
+            if (!skipPass)
+                visitor->visit(i->renderable);
+        }
+    }
+    //-----------------------------------------------------------------------
     void QueuedRenderableCollection::merge( const QueuedRenderableCollection& rhs )
     {
         mSortedDescending.insert( mSortedDescending.end(), rhs.mSortedDescending.begin(), rhs.mSortedDescending.end() );
+        if (mOrganisationMode & OM_SORT_KEY)
+            mSortedByKey.insert( mSortedByKey.end(), rhs.mSortedByKey.begin(), rhs.mSortedByKey.end() );
 
         PassGroupRenderableMap::const_iterator srcGroup;
         for( srcGroup = rhs.mGrouped.begin(); srcGroup != rhs.mGrouped.end(); ++srcGroup )
@@ -30,10 +30,12 @@ THE SOFTWARE.
 #include "OgreException.h"
 #include "OgreArchive.h"
 #include "OgreArchiveManager.h"
+#include "OgreArchiveIndexCache.h"
 #include "OgreLogManager.h"
 #include "OgreScriptLoader.h"
 #include "OgreSceneManager.h"
 #include "OgreResourceManager.h"
+#include "OgreRoot.h"
 
 namespace Ogre {
 
@@ -56,8 +58,13 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mLoadingListener(0), mCurrentGroup(0)
+        : mLoadingListener(0), mCurrentGroup(0), mIndexCache(0), mLoadingThreadCount(1)
+        , mWorkQueue(0), mWorkQueueChannel(0), mNextParallelResource(0)
+        , mPendingPrepareTasks(0), mPreparingInParallel(false)
     {
+#if OGRE_THREAD_SUPPORT
+        mCreatorThreadId = OGRE_THREAD_CURRENT_ID;
+#endif
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME);
         // Create the 'Internal' group
@@ -70,6 +77,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     ResourceGroupManager::~ResourceGroupManager()
     {
+        unregisterWorkQueueHandler();
+
         // delete all resource groups
         ResourceGroupMap::iterator i, iend;
         iend = mResourceGroupMap.end();
@@ -78,6 +87,8 @@ namespace Ogre {
             deleteGroup(i->second);
         }
         mResourceGroupMap.clear();
+
+        OGRE_DELETE mIndexCache;
     }
     //-----------------------------------------------------------------------
     void ResourceGroupManager::createResourceGroup(const String& name, const bool inGlobalPool /* = true */)
@@ -160,6 +171,11 @@ namespace Ogre {
     void ResourceGroupManager::prepareResourceGroup(const String& name, 
         bool prepareMainResources, bool prepareWorldGeom)
     {
+        // Prepare what can be on other threads first, without any lock held,
+        // the loop below then skips the resources already prepared
+        if (prepareMainResources)
+            prepareResourcesInParallel(name);
+
         // Can only bulk-load one group at a time (reasonable limitation I think)
         OGRE_LOCK_AUTO_MUTEX;
 
@@ -257,6 +273,11 @@ namespace Ogre {
     void ResourceGroupManager::loadResourceGroup(const String& name, 
         bool loadMainResources, bool loadWorldGeom)
     {
+        // Prepare what can be on other threads first, without any lock held,
+        // so only the loading itself is left for the loop below
+        if (loadMainResources)
+            prepareResourcesInParallel(name);
+
         // Can only bulk-load one group at a time (reasonable limitation I think)
         OGRE_LOCK_AUTO_MUTEX;
 
@@ -354,6 +375,179 @@ namespace Ogre {
         LogManager::getSingleton().logMessage("Finished loading resource group " + name);
     }
     //-----------------------------------------------------------------------
+    void ResourceGroupManager::setLoadingThreadCount(size_t count)
+    {
+        mLoadingThreadCount = std::max(count, (size_t)1);
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::setUseIndexCache(bool use)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        if (use && !mIndexCache)
+        {
+            mIndexCache = OGRE_NEW ArchiveIndexCache();
+        }
+        else if (!use && mIndexCache)
+        {
+            OGRE_DELETE mIndexCache;
+            mIndexCache = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::loadIndexCache(const DataStreamPtr& stream)
+    {
+        setUseIndexCache(true);
+        mIndexCache->load(stream);
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::saveIndexCache(const DataStreamPtr& stream) const
+    {
+        if (!mIndexCache)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "The index cache is not enabled",
+                "ResourceGroupManager::saveIndexCache");
+        }
+        mIndexCache->save(stream);
+    }
+    //-----------------------------------------------------------------------
+    bool ResourceGroupManager::isIndexCacheDirty(void) const
+    {
+        return mIndexCache && mIndexCache->isDirty();
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::prepareResourcesInParallel(const String& name)
+    {
+#if OGRE_THREAD_SUPPORT
+        if (mLoadingThreadCount < 2 || mPreparingInParallel || !Root::getSingletonPtr() ||
+            OGRE_THREAD_CURRENT_ID != mCreatorThreadId)
+            return;
+
+        ResourceGroup* grp = getResourceGroup(name);
+        if (!grp)
+            return;
+
+        // Only hand the work out when there are workers to pick it up; before
+        // Root::initialise starts the queue, preparing falls back to serial
+        DefaultWorkQueueBase* queue = dynamic_cast<DefaultWorkQueueBase*>(
+            Root::getSingleton().getWorkQueue());
+        if (!queue || !queue->isRunning() || !queue->getWorkerThreadCount() ||
+            queue->isPaused() || !queue->getRequestsAccepted())
+            return;
+
+        registerWorkQueueHandler();
+
+        // Loading orders to prepare, more may be added while preparing
+        vector<Real>::type orders;
+        {
+            OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME);
+            ResourceGroup::LoadResourceOrderMap::iterator oi;
+            for (oi = grp->loadResourceOrderMap.begin(); oi != grp->loadResourceOrderMap.end(); ++oi)
+                orders.push_back(oi->first);
+        }
+
+        mPreparingInParallel = true;
+        for (size_t o = 0; o < orders.size(); ++o)
+        {
+            // Resources preparing earlier loading orders may have created are included
+            mParallelResources.clear();
+            {
+                OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME);
+                ResourceGroup::LoadResourceOrderMap::iterator oi = 
+                    grp->loadResourceOrderMap.find(orders[o]);
+                if (oi == grp->loadResourceOrderMap.end())
+                    continue;
+                LoadUnloadResourceList::iterator l;
+                for (l = oi->second->begin(); l != oi->second->end(); ++l)
+                {
+                    if ((*l)->getLoadingState() == Resource::LOADSTATE_UNLOADED &&
+                        !(*l)->isManuallyLoaded() && !(*l)->isBackgroundLoaded())
+                        mParallelResources.push_back(*l);
+                }
+            }
+            if (mParallelResources.size() < 2)
+                continue;
+
+            mNextParallelResource.set(0);
+            mPendingPrepareTasks.set(0);
+            size_t numTasks = std::min(mLoadingThreadCount, mParallelResources.size());
+            for (size_t i = 1; i < numTasks; ++i)
+            {
+                ++mPendingPrepareTasks;
+                if (!mWorkQueue->addRequest(mWorkQueueChannel, 0, Any(this)))
+                {
+                    --mPendingPrepareTasks;
+                    break;
+                }
+            }
+
+            // This thread does its share while the workers do theirs
+            prepareParallelResources();
+
+            // Wait for the loading order to be prepared before starting the next
+            while (mPendingPrepareTasks.get())
+            {
+                OGRE_THREAD_YIELD;
+            }
+        }
+        mParallelResources.clear();
+        mPreparingInParallel = false;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::prepareParallelResources(void)
+    {
+        for (size_t i = mNextParallelResource++; i < mParallelResources.size();
+            i = mNextParallelResource++)
+        {
+            try
+            {
+                mParallelResources[i]->prepare();
+            }
+            catch (...)
+            {
+                // The resource is back to unloaded, preparing it again on the
+                // calling thread raises the error where it always has been
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::registerWorkQueueHandler(void)
+    {
+        WorkQueue* wq = Root::getSingleton().getWorkQueue();
+        if (mWorkQueue != wq)
+        {
+            // a previous queue has been replaced (and destroyed) by Root
+            mWorkQueue = wq;
+            mWorkQueueChannel = wq->getChannel("Ogre/ResourceGroupManager");
+            wq->addRequestHandler(mWorkQueueChannel, this);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::unregisterWorkQueueHandler(void)
+    {
+        Root* root = Root::getSingletonPtr();
+        if (mWorkQueue && root && root->getWorkQueue() == mWorkQueue)
+        {
+            mWorkQueue->removeRequestHandler(mWorkQueueChannel, this);
+        }
+        mWorkQueue = 0;
+    }
+    //-----------------------------------------------------------------------
+    bool ResourceGroupManager::canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+    {
+        return any_cast<ResourceGroupManager*>(req->getData()) == this;
+    }
+    //-----------------------------------------------------------------------
+    WorkQueue::Response* ResourceGroupManager::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+    {
+        prepareParallelResources();
+
+        --mPendingPrepareTasks;
+
+        return OGRE_NEW WorkQueue::Response(req, true, Any());
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::unloadResourceGroup(const String& name, bool reloadableOnly)
     {
         // Can only bulk-unload one group at a time (reasonable limitation I think)
@@ -563,9 +757,18 @@ namespace Ogre {
         loc->recursive = recursive;
         grp->locationList.push_back(loc);
         // Index resources
-        StringVectorPtr vec = pArch->find("*", recursive);
-        for( StringVector::iterator it = vec->begin(); it != vec->end(); ++it )
-            grp->addToIndex(*it, pArch);
+        if (mIndexCache)
+        {
+            FileInfoListPtr files = mIndexCache->findFileInfo(pArch, "*", recursive);
+            for (FileInfoList::iterator it = files->begin(); it != files->end(); ++it)
+                grp->addToIndex(it->filename, pArch);
+        }
+        else
+        {
+            StringVectorPtr vec = pArch->find("*", recursive);
+            for( StringVector::iterator it = vec->begin(); it != vec->end(); ++it )
+                grp->addToIndex(*it, pArch);
+        }
         
         StringStream msg;
         msg << "Added resource location '" << name << "' of type '" << locType
@@ -705,13 +908,12 @@ namespace Ogre {
         else 
         {
             // try case insensitive
-            String lcResourceName = resourceName;
-            StringUtil::toLowerCase(lcResourceName);
-            rit = grp->resourceIndexCaseInsensitive.find(lcResourceName);
-            if (rit != grp->resourceIndexCaseInsensitive.end())
+            CaseInsensitiveResourceLocationIndex::iterator cit =
+                grp->resourceIndexCaseInsensitive.find(resourceName);
+            if (cit != grp->resourceIndexCaseInsensitive.end())
             {
                 // Found in the index
-                pArch = rit->second;
+                pArch = cit->second;
                 DataStreamPtr stream = pArch->open(resourceName);
                 if (mLoadingListener)
                     mLoadingListener->resourceStreamOpened(resourceName, groupName, resourceBeingLoaded, stream);
@@ -1043,7 +1245,7 @@ namespace Ogre {
             const StringVector& patterns = su->getScriptPatterns();
             for (StringVector::const_iterator p = patterns.begin(); p != patterns.end(); ++p)
             {
-                FileInfoListPtr fileList = findResourceFileInfo(grp->name, *p);
+                FileInfoListPtr fileList = findGroupFileInfo(grp, *p);
                 scriptCount += fileList->size();
                 fileListList->push_back(fileList);
             }
@@ -1655,6 +1857,25 @@ namespace Ogre {
         return vec;
     }
     //-----------------------------------------------------------------------
+    FileInfoListPtr ResourceGroupManager::findGroupFileInfo(ResourceGroup* grp, const String& pattern)
+    {
+        if (!mIndexCache)
+            return findResourceFileInfo(grp->name, pattern);
+
+        // MEMCATEGORY_GENERAL is the only category supported for SharedPtr
+        FileInfoListPtr vec(OGRE_NEW_T(FileInfoList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+
+        OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex
+
+        for (LocationList::iterator i = grp->locationList.begin(); i != grp->locationList.end(); ++i)
+        {
+            FileInfoListPtr lst = mIndexCache->findFileInfo((*i)->archive, pattern, (*i)->recursive);
+            vec->insert(vec->end(), lst->begin(), lst->end());
+        }
+
+        return vec;
+    }
+    //-----------------------------------------------------------------------
     bool ResourceGroupManager::resourceExists(const String& groupName, const String& resourceName)
     {
             OGRE_LOCK_AUTO_MUTEX;
@@ -1686,10 +1907,9 @@ namespace Ogre {
         else 
         {
             // try case insensitive
-            String lcResourceName = resourceName;
-            StringUtil::toLowerCase(lcResourceName);
-            rit = grp->resourceIndexCaseInsensitive.find(lcResourceName);
-            if (rit != grp->resourceIndexCaseInsensitive.end())
+            CaseInsensitiveResourceLocationIndex::iterator cit =
+                grp->resourceIndexCaseInsensitive.find(resourceName);
+            if (cit != grp->resourceIndexCaseInsensitive.end())
             {
                 // Found in the index
                 return true;
@@ -1744,12 +1964,11 @@ namespace Ogre {
         else 
         {
             // try case insensitive
-            String lcResourceName = resourceName;
-            StringUtil::toLowerCase(lcResourceName);
-            rit = grp->resourceIndexCaseInsensitive.find(lcResourceName);
-            if (rit != grp->resourceIndexCaseInsensitive.end())
+            CaseInsensitiveResourceLocationIndex::iterator cit =
+                grp->resourceIndexCaseInsensitive.find(resourceName);
+            if (cit != grp->resourceIndexCaseInsensitive.end())
             {
-                return rit->second->getModifiedTime(resourceName);
+                return cit->second->getModifiedTime(resourceName);
             }
             else
             {
@@ -1984,9 +2203,7 @@ namespace Ogre {
 
         if (!arch->isCaseSensitive())
         {
-            String lcase = filename;
-            StringUtil::toLowerCase(lcase);
-            this->resourceIndexCaseInsensitive[lcase] = arch;
+            this->resourceIndexCaseInsensitive[filename] = arch;
         }
     }
     //---------------------------------------------------------------------
@@ -1999,31 +2216,30 @@ namespace Ogre {
 
         if (!arch->isCaseSensitive())
         {
-            String lcase = filename;
-            StringUtil::toLowerCase(lcase);
-            i = this->resourceIndexCaseInsensitive.find(lcase);
-            if (i != this->resourceIndexCaseInsensitive.end() && i->second == arch)
-                this->resourceIndexCaseInsensitive.erase(i);
+            CaseInsensitiveResourceLocationIndex::iterator ci = this->resourceIndexCaseInsensitive.find(filename);
+            if (ci != this->resourceIndexCaseInsensitive.end() && ci->second == arch)
+                this->resourceIndexCaseInsensitive.erase(ci);
         }
     }
     //---------------------------------------------------------------------
     void ResourceGroupManager::ResourceGroup::removeFromIndex(Archive* arch)
     {
         // Delete indexes
-        ResourceLocationIndex::iterator rit, ritend;
-        ritend = this->resourceIndexCaseInsensitive.end();
-        for (rit = this->resourceIndexCaseInsensitive.begin(); rit != ritend;)
+        CaseInsensitiveResourceLocationIndex::iterator cit, citend;
+        citend = this->resourceIndexCaseInsensitive.end();
+        for (cit = this->resourceIndexCaseInsensitive.begin(); cit != citend;)
         {
-            if (rit->second == arch)
+            if (cit->second == arch)
             {
-                ResourceLocationIndex::iterator del = rit++;
+                CaseInsensitiveResourceLocationIndex::iterator del = cit++;
                 this->resourceIndexCaseInsensitive.erase(del);
             }
             else
             {
-                ++rit;
+                ++cit;
             }
         }
+        ResourceLocationIndex::iterator rit, ritend;
         ritend = this->resourceIndexCaseSensitive.end();
         for (rit = this->resourceIndexCaseSensitive.begin(); rit != ritend;)
         {
@@ -62,6 +62,8 @@ THE SOFTWARE.
 #include "OgreConvexBody.h"
 #include "OgreTimer.h"
 #include "OgreFrameListener.h"
+#include "OgreFrameAllocator.h"
+#include "OgreMemoryTracker.h"
 #include "OgreLodStrategyManager.h"
 #include "Threading/OgreDefaultWorkQueue.h"
 
@@ -76,6 +78,10 @@ THE SOFTWARE.
 #endif
 #if OGRE_NO_ZIP_ARCHIVE == 0
 #include "OgreZip.h"
+#include "OgreIndexedZip.h"
+#endif
+#if OGRE_NO_PACK_ARCHIVE == 0
+#include "OgrePackArchive.h"
 #endif
 
 #include "OgreHardwareBufferManager.h"
@@ -212,6 +218,9 @@ namespace Ogre {
 
         mTimer = OGRE_NEW Timer();
 
+        // Arena for transient per-frame data
+        mFrameAllocator = OGRE_NEW FrameAllocator();
+
         // LOD strategy manager
         mLodStrategyManager = OGRE_NEW LodStrategyManager();
 
@@ -224,11 +233,17 @@ namespace Ogre {
 
         mFileSystemArchiveFactory = OGRE_NEW FileSystemArchiveFactory();
         ArchiveManager::getSingleton().addArchiveFactory( mFileSystemArchiveFactory );
+#   if OGRE_NO_PACK_ARCHIVE == 0
+        mPackArchiveFactory = OGRE_NEW PackArchiveFactory();
+        ArchiveManager::getSingleton().addArchiveFactory( mPackArchiveFactory );
+#   endif
 #   if OGRE_NO_ZIP_ARCHIVE == 0
         mZipArchiveFactory = OGRE_NEW ZipArchiveFactory();
         ArchiveManager::getSingleton().addArchiveFactory( mZipArchiveFactory );
         mEmbeddedZipArchiveFactory = OGRE_NEW EmbeddedZipArchiveFactory();
         ArchiveManager::getSingleton().addArchiveFactory( mEmbeddedZipArchiveFactory );
+        mIndexedZipArchiveFactory = OGRE_NEW IndexedZipArchiveFactory();
+        ArchiveManager::getSingleton().addArchiveFactory( mIndexedZipArchiveFactory );
 #   endif
 
 #if OGRE_NO_DDS_CODEC == 0
@@ -325,8 +340,12 @@ namespace Ogre {
 #   if OGRE_NO_ZIP_ARCHIVE == 0
         OGRE_DELETE mZipArchiveFactory;
         OGRE_DELETE mEmbeddedZipArchiveFactory;
+        OGRE_DELETE mIndexedZipArchiveFactory;
 #   endif
         OGRE_DELETE mFileSystemArchiveFactory;
+#   if OGRE_NO_PACK_ARCHIVE == 0
+        OGRE_DELETE mPackArchiveFactory;
+#   endif
 
         OGRE_DELETE mSkeletonManager;
         OGRE_DELETE mMeshManager;
@@ -352,6 +371,8 @@ namespace Ogre {
 
         OGRE_DELETE mTimer;
 
+        OGRE_DELETE mFrameAllocator;
+
         OGRE_DELETE mDynLibManager;
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
@@ -880,6 +901,12 @@ namespace Ogre {
         // Tell the queue to process responses
         mWorkQueue->processResponses();
 
+        // Transient data of this frame is no longer used
+        mFrameAllocator->_frameEnded();
+#if OGRE_MEMORY_TRACKER
+        MemoryTracker::get()._frameEnded(mFrameAllocator->getLastFrameStats().allocations);
+#endif
+
         OgreProfileEndGroup("Frame", OGREPROF_GENERAL);
 
         return ret;
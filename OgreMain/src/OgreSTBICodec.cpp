@@ -123,11 +123,16 @@ namespace Ogre {
     //---------------------------------------------------------------------
     Codec::DecodeResult STBIImageCodec::decode(DataStreamPtr& input) const
     {
-        // Buffer stream into memory (TODO: override IO functions instead?)
-        MemoryDataStream memStream(input, true);
+        // Decode in place from streams already in memory, such as memory
+        // mapped files, buffer any other stream into memory first
+        MemoryDataStreamPtr memStream = input.dynamicCast<MemoryDataStream>();
+        if (memStream.isNull())
+            memStream.bind(OGRE_NEW MemoryDataStream(input, true));
+        uchar* data = memStream->getCurrentPtr();
+        size_t dataSize = memStream->size() - memStream->tell();
 
         int width, height, components;
-        stbi_uc* pixelData = stbi_load_from_memory(memStream.getPtr(), static_cast<int>(memStream.size()), &width, &height, &components, 0);
+        stbi_uc* pixelData = stbi_load_from_memory(data, static_cast<int>(dataSize), &width, &height, &components, 0);
         
         
         if (!pixelData)
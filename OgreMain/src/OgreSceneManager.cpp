@@ -64,6 +64,9 @@ THE SOFTWARE.
 #include "OgreLodListener.h"
 #include "OgreInstancedGeometry.h"
 #include "OgreUnifiedHighLevelGpuProgram.h"
+#include "OgreNodeTransformBatch.h"
+#include "OgreFrameAllocator.h"
+#include "OgreSkeletonAnimationCache.h"
 
 // This class implements the most basic scene manager
 
@@ -71,6 +74,55 @@ THE SOFTWARE.
 
 namespace Ogre {
 
+/// Number of node transform blocks processed by a worker task at a time
+static const size_t NODE_TRANSFORM_BLOCKS_PER_TASK = 64;
+/// Maximum number of chunks the items of a parallel visible object search are split into
+static const size_t VISIBLE_OBJECTS_MAX_CHUNKS = 32;
+/// Number of entities whose animation a worker task updates at a time
+static const size_t ANIMATION_UPDATE_BATCH_SIZE = 4;
+
+//-----------------------------------------------------------------------
+/** Lends the storage of a scratch light list to a local one for its lifetime,
+    so that the local list does not go through the allocator every frame. A
+    nested user finds the scratch list empty and allocates its own storage.
+*/
+struct BorrowedLightList
+{
+    LightList& scratch;
+    LightList list;
+
+    explicit BorrowedLightList(LightList& scratchList) : scratch(scratchList)
+    {
+        list.swap(scratch);
+        list.clear();
+    }
+    ~BorrowedLightList()
+    {
+        list.clear();
+        scratch.swap(list);
+    }
+private:
+    // no copying allowed
+    BorrowedLightList(const BorrowedLightList&);
+    BorrowedLightList& operator=(const BorrowedLightList&);
+};
+//-----------------------------------------------------------------------
+struct SceneManager::VisibleObjectsChunk : public SceneMgtAlloc
+{
+    RenderQueue* queue;
+    VisibleObjectsBoundsInfo bounds;
+    RenderQueue::MovableObjectList deferred;
+
+    VisibleObjectsChunk() : queue(OGRE_NEW RenderQueue())
+    {
+        queue->_setDeferredObjectList(&deferred);
+    }
+    ~VisibleObjectsChunk()
+    {
+        OGRE_DELETE queue;
+    }
+};
+
 //-----------------------------------------------------------------------
 uint32 SceneManager::WORLD_GEOMETRY_TYPE_MASK   = 0x80000000;
 uint32 SceneManager::ENTITY_TYPE_MASK           = 0x40000000;
@@ -151,7 +203,33 @@ mCameraRelativeRendering(false),
 mLastLightHash(0),
 mLastLightLimit(0),
 mLastLightHashGpuProgram(0),
-mGpuParamsDirty((uint16)GPV_ALL)
+mGpuParamsDirty((uint16)GPV_ALL),
+mWorkQueueChannel(0),
+mWorkerTaskQueue(0),
+mPendingWorkerTasks(0),
+mSceneGraphUpdateThreadCount(1),
+mNextSceneGraphUpdateSubtree(0),
+mNodeTransformStorage(NTS_PER_NODE),
+mCurrentNodeTransformBatch(0),
+mNextNodeTransformRange(0),
+mCullingThreadCount(1),
+mNumVisibleObjectsChunks(0),
+mVisibleObjectsCamera(0),
+mVisibleObjectsOnlyShadowCasters(false),
+mNextVisibleObjectsChunk(0),
+mAnimationThreadCount(1),
+mNextAnimationUpdateBatch(0),
+mSkeletonAnimationCache(0),
+mShadowVolumeThreadCount(1),
+mNumShadowVolumeItems(0),
+mShadowVolumeItemsBegin(0),
+mShadowVolumeItemsEnd(0),
+mShadowVolumeIndexes(0),
+mShadowVolumeIndexStart(0),
+mNextShadowVolumeItem(0),
+mSceneQueryThreadCount(1),
+mNextBatchQueryPacket(0),
+mRenderQueueEntryCacheEnabled(false)
 {
 
     // init sky
@@ -159,6 +237,10 @@ mGpuParamsDirty((uint16)GPV_ALL)
     {
         mSkyDomeEntity[i] = 0;
     }
+    for (int i = 0; i < SUT_COUNT; ++i)
+    {
+        mSkeletonUpdateCounts[i].set(0);
+    }
 
     mShadowCasterQueryListener = OGRE_NEW ShadowCasterSceneQueryListener(this);
 
@@ -188,6 +270,7 @@ mGpuParamsDirty((uint16)GPV_ALL)
 SceneManager::~SceneManager()
 {
     fireSceneManagerDestroyed();
+    unregisterWorkerTaskHandler();
     destroyShadowTextures();
     clearScene();
     destroyAllCameras();
@@ -212,6 +295,18 @@ SceneManager::~SceneManager()
     OGRE_DELETE mShadowCasterAABBQuery;
     OGRE_DELETE mRenderQueue;
     OGRE_DELETE mAutoParamDataSource;
+    OGRE_DELETE mSkeletonAnimationCache;
+
+    for (NodeTransformBatchList::iterator i = mNodeTransformBatches.begin();
+        i != mNodeTransformBatches.end(); ++i)
+    {
+        OGRE_DELETE *i;
+    }
+    for (VisibleObjectsChunkList::iterator i = mVisibleObjectsChunks.begin();
+        i != mVisibleObjectsChunks.end(); ++i)
+    {
+        OGRE_DELETE *i;
+    }
 }
 //-----------------------------------------------------------------------
 RenderQueue* SceneManager::getRenderQueue(void)
@@ -342,6 +437,9 @@ void SceneManager::destroyCamera(const String& name)
         if ( camLightIt != mShadowCamLightMapping.end() )
             mShadowCamLightMapping.erase( camLightIt );
 
+        if (mRenderQueue)
+            mRenderQueue->_notifyCameraRemoved(i->second);
+
         // Notify render system
         mDestRenderSystem->_notifyCameraRemoved(i->second);
         OGRE_DELETE i->second;
@@ -1362,7 +1460,10 @@ void SceneManager::prepareRenderQueue(void)
 //-----------------------------------------------------------------------
 void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverlays)
 {
-    OgreProfileGroup("_renderScene", OGREPROF_GENERAL);
+    OgreProfileGroupLiteral("_renderScene", OGREPROF_GENERAL);
+
+    // transient data of this viewport is released on return, so the next one reuses the memory
+    FrameAllocator::Scope frameScope(FrameAllocator::getSingletonPtr());
 
     Root::getSingleton()._pushCurrentSceneManager(this);
     mActiveQueuedRenderableVisitor->targetSceneMgr = this;
@@ -1412,6 +1513,11 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
         _applySceneAnimations();
         updateDirtyInstanceManagers();
         mLastFrameNumber = thisFrameNumber;
+        mRenderQueueEntryCacheStats.reset();
+        for (int i = 0; i < SUT_COUNT; ++i)
+            mSkeletonUpdateCounts[i].set(0);
+        if (mSkeletonAnimationCache)
+            mSkeletonAnimationCache->clear();
     }
 
     {
@@ -1420,7 +1526,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
         // Update scene graph for this camera (can happen multiple times per frame)
         {
-            OgreProfileGroup("_updateSceneGraph", OGREPROF_GENERAL);
+            OgreProfileGroupLiteral("_updateSceneGraph", OGREPROF_GENERAL);
             _updateSceneGraph(camera);
 
             // Auto-track nodes
@@ -1434,6 +1540,13 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
             camera->_autoTrack();
         }
 
+        // Evaluate the animation of the entities in view ahead of queueing them
+        if (mAnimationThreadCount > 1 && mFindVisibleObjects)
+        {
+            OgreProfileGroupLiteral("updateAnimationsParallel", OGREPROF_GENERAL);
+            updateAnimationsParallel(camera);
+        }
+
         if (mIlluminationStage != IRS_RENDER_TO_TEXTURE && mFindVisibleObjects)
         {
             // Locate any lights which could be affecting the frustum
@@ -1446,7 +1559,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
                 // technique in use
                 if (isShadowTechniqueTextureBased())
                 {
-                    OgreProfileGroup("prepareShadowTextures", OGREPROF_GENERAL);
+                    OgreProfileGroupLiteral("prepareShadowTextures", OGREPROF_GENERAL);
 
                     // *******
                     // WARNING
@@ -1505,13 +1618,13 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
         // Prepare render queue for receiving new objects
         {
-            OgreProfileGroup("prepareRenderQueue", OGREPROF_GENERAL);
+            OgreProfileGroupLiteral("prepareRenderQueue", OGREPROF_GENERAL);
             prepareRenderQueue();
         }
 
         if (mFindVisibleObjects)
         {
-            OgreProfileGroup("_findVisibleObjects", OGREPROF_CULLING);
+            OgreProfileGroupLiteral("_findVisibleObjects", OGREPROF_CULLING);
 
             // Assemble an AAB on the fly which contains the scene elements visible
             // by the camera.
@@ -1526,8 +1639,12 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
             // Parse the scene and tag visibles
             firePreFindVisibleObjects(vp);
+            if (mRenderQueueEntryCacheEnabled)
+                getRenderQueue()->_beginEntryCachePass(camera);
             _findVisibleObjects(camera, &(camVisObjIt->second),
                 mIlluminationStage == IRS_RENDER_TO_TEXTURE? true : false);
+            if (mRenderQueueEntryCacheEnabled)
+                mRenderQueueEntryCacheStats.merge(getRenderQueue()->_endEntryCachePass());
             firePostFindVisibleObjects(vp);
 
             mAutoParamDataSource->setMainCamBoundsInfo(&(camVisObjIt->second));
@@ -1571,7 +1688,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     // Render scene content
     {
-        OgreProfileGroup("_renderVisibleObjects", OGREPROF_RENDERING);
+        OgreProfileGroupLiteral("_renderVisibleObjects", OGREPROF_RENDERING);
         _renderVisibleObjects();
     }
 
@@ -2290,20 +2407,626 @@ void SceneManager::_updateSceneGraph(Camera* cam)
     // In this implementation, just update from the root
     // Smarter SceneManager subclasses may choose to update only
     //   certain scene graph branches
-    getRootSceneNode()->_update(true, false);
+#if !OGRE_DOUBLE_PRECISION && !OGRE_NODE_INHERIT_TRANSFORM
+    if (mNodeTransformStorage == NTS_SOA_BLOCKS && supportsParallelSceneGraphUpdate())
+        updateSceneGraphBatched();
+    else
+#endif
+    if (mSceneGraphUpdateThreadCount > 1 && supportsParallelSceneGraphUpdate())
+        updateSceneGraphParallel();
+    else
+        getRootSceneNode()->_update(true, false);
 
     firePostUpdateSceneGraph(cam);
 }
 //-----------------------------------------------------------------------
+void SceneManager::updateSceneGraphParallel(void)
+{
+    // Descend from the root until the hierarchy is split into enough
+    // independent subtrees to keep all threads busy. Nodes visited on the way
+    // have their own transform updated now, and are completed afterwards.
+    const size_t maxSplitDepth = 4;
+    const size_t minSubtrees = mSceneGraphUpdateThreadCount * 4;
+
+    mSceneGraphUpdateParents.clear();
+    mSceneGraphUpdateSubtrees.clear();
+    mSceneGraphUpdateSubtrees.push_back(NodeUpdateEntry(getRootSceneNode(), false));
+
+    for (size_t depth = 0; depth < maxSplitDepth && 
+        mSceneGraphUpdateSubtrees.size() < minSubtrees; ++depth)
+    {
+        mSceneGraphUpdateSplitTmp.clear();
+        NodeUpdateEntryList::iterator i, iend = mSceneGraphUpdateSubtrees.end();
+        for (i = mSceneGraphUpdateSubtrees.begin(); i != iend; ++i)
+        {
+            mSceneGraphUpdateChildrenTmp.clear();
+            bool childParentHasChanged = 
+                i->first->_updateAndCollectChildren(i->second, mSceneGraphUpdateChildrenTmp);
+            mSceneGraphUpdateParents.push_back(i->first);
+
+            NodeList::iterator c, cend = mSceneGraphUpdateChildrenTmp.end();
+            for (c = mSceneGraphUpdateChildrenTmp.begin(); c != cend; ++c)
+            {
+                mSceneGraphUpdateSplitTmp.push_back(NodeUpdateEntry(*c, childParentHasChanged));
+            }
+        }
+        mSceneGraphUpdateSubtrees.swap(mSceneGraphUpdateSplitTmp);
+
+        if (mSceneGraphUpdateSubtrees.empty())
+            break;
+    }
+
+    mNextSceneGraphUpdateSubtree.set(0);
+    fireWorkerTasksAndWait(WTT_UPDATE_SCENE_GRAPH, 
+        std::min(mSceneGraphUpdateThreadCount, mSceneGraphUpdateSubtrees.size()));
+
+    // Complete the split nodes bottom-up, now that their children are up to date
+    NodeList::reverse_iterator p, pend = mSceneGraphUpdateParents.rend();
+    for (p = mSceneGraphUpdateParents.rbegin(); p != pend; ++p)
+    {
+        (*p)->_update(false, false);
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateSceneGraphSubtrees(void)
+{
+    const uint32 count = static_cast<uint32>(mSceneGraphUpdateSubtrees.size());
+    for (uint32 i = mNextSceneGraphUpdateSubtree++; i < count; i = mNextSceneGraphUpdateSubtree++)
+    {
+        const NodeUpdateEntry& entry = mSceneGraphUpdateSubtrees[i];
+        entry.first->_update(true, entry.second);
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateSceneGraphBatched(void)
+{
+    if (mSceneGraphUpdateLevels.empty())
+        mSceneGraphUpdateLevels.resize(1);
+    mSceneGraphUpdateLevels[0].clear();
+    mSceneGraphUpdateLevels[0].push_back(NodeUpdateEntry(getRootSceneNode(), false));
+
+    // Top-down, one depth at a time: nodes whose transform is a plain
+    // concatenation with their parent's are packed into the batch of their
+    // depth, the others are updated individually. Either way the children
+    // needing an update make up the next depth.
+    size_t depth = 0;
+    for (; !mSceneGraphUpdateLevels[depth].empty(); ++depth)
+    {
+        if (mSceneGraphUpdateLevels.size() <= depth + 1)
+            mSceneGraphUpdateLevels.resize(depth + 2);
+        if (mNodeTransformBatches.size() <= depth)
+            mNodeTransformBatches.push_back(OGRE_NEW NodeTransformBatch());
+
+        NodeUpdateEntryList& level = mSceneGraphUpdateLevels[depth];
+        NodeUpdateEntryList& nextLevel = mSceneGraphUpdateLevels[depth + 1];
+        NodeTransformBatch* batch = mNodeTransformBatches[depth];
+        nextLevel.clear();
+        batch->clear();
+
+        NodeUpdateEntryList::iterator i, iend = level.end();
+        for (i = level.begin(); i != iend; ++i)
+        {
+            Node* node = i->first;
+            bool childParentHasChanged;
+            mSceneGraphUpdateChildrenTmp.clear();
+            if (node->_canConcatenateTransforms() && node->_isUpdateFromParentNeeded(i->second))
+            {
+                batch->addNode(node);
+                childParentHasChanged = 
+                    node->_collectChildrenToUpdate(i->second, mSceneGraphUpdateChildrenTmp);
+            }
+            else
+            {
+                childParentHasChanged = 
+                    node->_updateAndCollectChildren(i->second, mSceneGraphUpdateChildrenTmp);
+            }
+
+            NodeList::iterator c, cend = mSceneGraphUpdateChildrenTmp.end();
+            for (c = mSceneGraphUpdateChildrenTmp.begin(); c != cend; ++c)
+            {
+                nextLevel.push_back(NodeUpdateEntry(*c, childParentHasChanged));
+            }
+        }
+
+        // The next depth reads the transforms calculated here
+        size_t numBlocks = batch->getNumBlocks();
+        if (mSceneGraphUpdateThreadCount > 1 && numBlocks > NODE_TRANSFORM_BLOCKS_PER_TASK)
+        {
+            mCurrentNodeTransformBatch = batch;
+            mNextNodeTransformRange.set(0);
+            size_t numRanges = (numBlocks + NODE_TRANSFORM_BLOCKS_PER_TASK - 1) / 
+                NODE_TRANSFORM_BLOCKS_PER_TASK;
+            fireWorkerTasksAndWait(WTT_UPDATE_NODE_TRANSFORMS, 
+                std::min(mSceneGraphUpdateThreadCount, numRanges));
+            mCurrentNodeTransformBatch = 0;
+        }
+        else if (numBlocks)
+        {
+            batch->update(0, numBlocks);
+        }
+    }
+
+    // Complete the nodes bottom-up (e.g. SceneNode merges child bounds)
+    while (depth--)
+    {
+        NodeUpdateEntryList& level = mSceneGraphUpdateLevels[depth];
+        NodeUpdateEntryList::iterator i, iend = level.end();
+        for (i = level.begin(); i != iend; ++i)
+        {
+            i->first->_update(false, false);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateNodeTransformRanges(void)
+{
+    const size_t numBlocks = mCurrentNodeTransformBatch->getNumBlocks();
+    for (size_t first = (mNextNodeTransformRange++) * NODE_TRANSFORM_BLOCKS_PER_TASK; 
+        first < numBlocks; first = (mNextNodeTransformRange++) * NODE_TRANSFORM_BLOCKS_PER_TASK)
+    {
+        mCurrentNodeTransformBatch->update(first, 
+            std::min(NODE_TRANSFORM_BLOCKS_PER_TASK, numBlocks - first));
+    }
+}
+//-----------------------------------------------------------------------
+bool SceneManager::setOption( const String& strKey, const void* pValue )
+{
+    if (strKey == "NodeTransformStorage")
+    {
+        setNodeTransformStorage(*static_cast<const NodeTransformStorage*>(pValue));
+        return true;
+    }
+    return false;
+}
+//-----------------------------------------------------------------------
+bool SceneManager::getOption( const String& strKey, void* pDestValue )
+{
+    if (strKey == "NodeTransformStorage")
+    {
+        *static_cast<NodeTransformStorage*>(pDestValue) = mNodeTransformStorage;
+        return true;
+    }
+    return false;
+}
+//-----------------------------------------------------------------------
+bool SceneManager::hasOption( const String& strKey ) const
+{
+    return strKey == "NodeTransformStorage";
+}
+//-----------------------------------------------------------------------
+bool SceneManager::getOptionKeys( StringVector& refKeys )
+{
+    refKeys.push_back("NodeTransformStorage");
+    return true;
+}
+//-----------------------------------------------------------------------
+void SceneManager::setSceneGraphUpdateThreadCount(size_t count)
+{
+    mSceneGraphUpdateThreadCount = std::max(count, (size_t)1);
+    if (mSceneGraphUpdateThreadCount > 1)
+        registerWorkerTaskHandler();
+}
+//-----------------------------------------------------------------------
+void SceneManager::setCullingThreadCount(size_t count)
+{
+    mCullingThreadCount = std::max(count, (size_t)1);
+    if (mCullingThreadCount > 1)
+        registerWorkerTaskHandler();
+}
+//-----------------------------------------------------------------------
+void SceneManager::setAnimationThreadCount(size_t count)
+{
+    mAnimationThreadCount = std::max(count, (size_t)1);
+    if (mAnimationThreadCount > 1)
+        registerWorkerTaskHandler();
+}
+//-----------------------------------------------------------------------
+void SceneManager::setShadowVolumeThreadCount(size_t count)
+{
+    mShadowVolumeThreadCount = std::max(count, (size_t)1);
+    if (mShadowVolumeThreadCount > 1)
+        registerWorkerTaskHandler();
+}
+//-----------------------------------------------------------------------
+void SceneManager::setSceneQueryThreadCount(size_t count)
+{
+    mSceneQueryThreadCount = std::max(count, (size_t)1);
+    if (mSceneQueryThreadCount > 1)
+        registerWorkerTaskHandler();
+}
+//-----------------------------------------------------------------------
+void SceneManager::setSkeletonAnimationCacheEnabled(bool enabled)
+{
+    if (enabled && !mSkeletonAnimationCache)
+    {
+        mSkeletonAnimationCache = OGRE_NEW SkeletonAnimationCache();
+    }
+    else if (!enabled)
+    {
+        OGRE_DELETE mSkeletonAnimationCache;
+        mSkeletonAnimationCache = 0;
+    }
+}
+//-----------------------------------------------------------------------
+SceneManager::SkeletonUpdateStats SceneManager::getSkeletonUpdateStats(void) const
+{
+    SkeletonUpdateStats stats;
+    stats.evaluatedSkeletons = mSkeletonUpdateCounts[SUT_EVALUATED].get();
+    stats.interpolatedSkeletons = mSkeletonUpdateCounts[SUT_INTERPOLATED].get();
+    stats.skippedSkeletons = mSkeletonUpdateCounts[SUT_SKIPPED].get();
+    return stats;
+}
+//-----------------------------------------------------------------------
+void SceneManager::registerWorkerTaskHandler(void)
+{
+    WorkQueue* wq = Root::getSingleton().getWorkQueue();
+    if (mWorkerTaskQueue != wq)
+    {
+        // a previous queue has been replaced (and destroyed) by Root
+        mWorkerTaskQueue = wq;
+        mWorkQueueChannel = wq->getChannel("Ogre/SceneManager");
+        wq->addRequestHandler(mWorkQueueChannel, this);
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::unregisterWorkerTaskHandler(void)
+{
+    Root* root = Root::getSingletonPtr();
+    if (mWorkerTaskQueue && root && root->getWorkQueue() == mWorkerTaskQueue)
+    {
+        mWorkerTaskQueue->removeRequestHandler(mWorkQueueChannel, this);
+    }
+    mWorkerTaskQueue = 0;
+}
+//-----------------------------------------------------------------------
+void SceneManager::fireWorkerTasksAndWait(WorkerTaskType type, size_t numTasks)
+{
+    registerWorkerTaskHandler();
+
+    mWorkerTaskError.clear();
+    mPendingWorkerTasks.set(0);
+#if OGRE_THREAD_SUPPORT
+    // Only hand tasks out when there are workers to pick them up, otherwise
+    // they would never be processed and this would wait forever
+    DefaultWorkQueueBase* queue = dynamic_cast<DefaultWorkQueueBase*>(mWorkerTaskQueue);
+    if (queue && queue->isRunning() && queue->getWorkerThreadCount() &&
+        !queue->isPaused() && queue->getRequestsAccepted())
+    {
+        for (size_t i = 1; i < numTasks; ++i)
+        {
+            ++mPendingWorkerTasks;
+            if (!mWorkerTaskQueue->addRequest(mWorkQueueChannel, static_cast<uint16>(type), Any(this)))
+            {
+                --mPendingWorkerTasks;
+                break;
+            }
+        }
+    }
+#endif
+
+    // This thread does its share of the work while the workers do theirs;
+    // without workers, the tasks share out all the work between themselves
+    try
+    {
+        executeWorkerTask(type);
+    }
+    catch (Exception& e)
+    {
+        OGRE_LOCK_MUTEX(mWorkerTaskErrorMutex);
+        mWorkerTaskError = e.getFullDescription();
+    }
+    catch (...)
+    {
+        // the workers still use this scene manager's state, let them finish first
+        while (mPendingWorkerTasks.get())
+        {
+            OGRE_THREAD_YIELD;
+        }
+        throw;
+    }
+
+    // Tasks are short lived, so just yield until the workers are done
+    while (mPendingWorkerTasks.get())
+    {
+        OGRE_THREAD_YIELD;
+    }
+
+    if (!mWorkerTaskError.empty())
+    {
+        OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
+            "Worker task failed: " + mWorkerTaskError,
+            "SceneManager::fireWorkerTasksAndWait");
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::executeWorkerTask(uint16 type)
+{
+    switch (type)
+    {
+    case WTT_UPDATE_SCENE_GRAPH:
+        updateSceneGraphSubtrees();
+        break;
+    case WTT_UPDATE_NODE_TRANSFORMS:
+        updateNodeTransformRanges();
+        break;
+    case WTT_FIND_VISIBLE_OBJECTS:
+        findVisibleObjectsInChunks();
+        break;
+    case WTT_UPDATE_ANIMATIONS:
+        updateAnimationBatches();
+        break;
+    case WTT_FIND_SHADOW_SILHOUETTES:
+        findShadowVolumeSilhouettes();
+        break;
+    case WTT_WRITE_SHADOW_VOLUMES:
+        writeShadowVolumeIndexes();
+        break;
+    case WTT_EXECUTE_SCENE_QUERIES:
+        executeBatchQueryPackets();
+        break;
+    }
+}
+//-----------------------------------------------------------------------
+bool SceneManager::canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+{
+    return any_cast<SceneManager*>(req->getData()) == this;
+}
+//-----------------------------------------------------------------------
+WorkQueue::Response* SceneManager::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+{
+    String error;
+    try
+    {
+        executeWorkerTask(req->getType());
+    }
+    catch (Exception& e)
+    {
+        error = e.getFullDescription();
+    }
+    catch (std::exception& e)
+    {
+        error = e.what();
+    }
+    catch (...)
+    {
+        error = "unknown exception";
+    }
+
+    if (!error.empty())
+    {
+        OGRE_LOCK_MUTEX(mWorkerTaskErrorMutex);
+        if (mWorkerTaskError.empty())
+            mWorkerTaskError = error;
+    }
+
+    // always count the task as done, or fireWorkerTasksAndWait would never return
+    --mPendingWorkerTasks;
+
+    return OGRE_NEW WorkQueue::Response(req, error.empty(), Any(), error);
+}
+//-----------------------------------------------------------------------
 void SceneManager::_findVisibleObjects(
     Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
+    if (isParallelCullingEnabled())
+    {
+        splitVisibleObjectsItems(cam);
+        findVisibleObjectsParallel(cam, visibleBounds, onlyShadowCasters);
+        return;
+    }
+
     // Tell nodes to find, cascade down all nodes
     getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
         mDisplayNodes, onlyShadowCasters);
 
 }
 //-----------------------------------------------------------------------
+bool SceneManager::isParallelCullingEnabled(void) const
+{
+    // Debug renderables are shared between the nodes of the scene manager
+    return mCullingThreadCount > 1 && !mDisplayNodes && !getShowBoundingBoxes();
+}
+//-----------------------------------------------------------------------
+void SceneManager::splitVisibleObjectsItems(Camera* cam)
+{
+    // Descend breadth first from the root until there are enough items to
+    // share out. The split does not depend on the number of threads, so
+    // neither does the order in which objects end up in the render queue.
+    const size_t maxSplitDepth = 4;
+    const size_t minItems = 64;
+
+    mVisibleObjectsItems.clear();
+    SceneNode* root = getRootSceneNode();
+    if (!cam->isVisible(root->_getWorldAABB()))
+        return;
+
+    NodeList& frontier = mVisibleObjectsSplitTmp[0];
+    NodeList& next = mVisibleObjectsSplitTmp[1];
+    frontier.clear();
+    frontier.push_back(root);
+
+    for (size_t depth = 0; depth < maxSplitDepth && !frontier.empty() &&
+        mVisibleObjectsItems.size() + frontier.size() < minItems; ++depth)
+    {
+        next.clear();
+        NodeList::iterator i, iend = frontier.end();
+        for (i = frontier.begin(); i != iend; ++i)
+        {
+            SceneNode* node = static_cast<SceneNode*>(*i);
+            mVisibleObjectsItems.push_back(VisibleObjectsItem(node, false));
+
+            Node::ChildNodeIterator c = node->getChildIterator();
+            while (c.hasMoreElements())
+            {
+                SceneNode* child = static_cast<SceneNode*>(c.getNext());
+                if (cam->isVisible(child->_getWorldAABB()))
+                    next.push_back(child);
+            }
+        }
+        frontier.swap(next);
+    }
+
+    NodeList::iterator i, iend = frontier.end();
+    for (i = frontier.begin(); i != iend; ++i)
+    {
+        mVisibleObjectsItems.push_back(VisibleObjectsItem(static_cast<SceneNode*>(*i), true));
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::findVisibleObjectsParallel(Camera* cam, 
+    VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+{
+    if (mVisibleObjectsItems.empty())
+        return;
+
+    // Bring the camera up to date now, so that the worker threads only read it
+    cam->getViewMatrix(true);
+    cam->getLodCamera()->getDerivedPosition();
+    cam->isVisible(Vector3::ZERO);
+
+    RenderQueue* mainQueue = getRenderQueue();
+    mNumVisibleObjectsChunks = std::min(mVisibleObjectsItems.size(), VISIBLE_OBJECTS_MAX_CHUNKS);
+    while (mVisibleObjectsChunks.size() < mNumVisibleObjectsChunks)
+        mVisibleObjectsChunks.push_back(OGRE_NEW VisibleObjectsChunk());
+
+    for (size_t c = 0; c < mNumVisibleObjectsChunks; ++c)
+    {
+        VisibleObjectsChunk* chunk = mVisibleObjectsChunks[c];
+        RenderQueue* queue = chunk->queue;
+        chunk->bounds.reset();
+        chunk->deferred.clear();
+
+        queue->setSplitPassesByLightingType(mainQueue->getSplitPassesByLightingType());
+        queue->setSplitNoShadowPasses(mainQueue->getSplitNoShadowPasses());
+        queue->setShadowCastersCannotBeReceivers(mainQueue->getShadowCastersCannotBeReceivers());
+        queue->setRenderableListener(mainQueue->getRenderableListener());
+        queue->_joinEntryCachePass(mainQueue);
+
+        // Destroy rather than empty the groups, so that no pass entries are
+        // kept from one frame to the next (pass updates only reach main queues)
+        RenderQueue::QueueGroupIterator g = queue->_getQueueGroupIterator();
+        while (g.hasMoreElements())
+            g.getNext()->clear(true);
+
+        RenderQueue::QueueGroupIterator mg = mainQueue->_getQueueGroupIterator();
+        while (mg.hasMoreElements())
+        {
+            uint8 groupID = mg.peekNextKey();
+            queue->getQueueGroup(groupID)->setShadowsEnabled(mg.getNext()->getShadowsEnabled());
+        }
+
+        // Fill all the grouped and sorted lists, whichever the main queue uses
+        g = queue->_getQueueGroupIterator();
+        while (g.hasMoreElements())
+        {
+            RenderQueueGroup* group = g.getNext();
+            group->resetOrganisationModes();
+            group->addOrganisationMode(QueuedRenderableCollection::OM_PASS_GROUP);
+            group->addOrganisationMode(QueuedRenderableCollection::OM_SORT_DESCENDING);
+            group->addOrganisationMode(QueuedRenderableCollection::OM_SORT_KEY);
+        }
+    }
+
+    mVisibleObjectsCamera = cam;
+    mVisibleObjectsOnlyShadowCasters = onlyShadowCasters;
+    mNextVisibleObjectsChunk.set(0);
+    fireWorkerTasksAndWait(WTT_FIND_VISIBLE_OBJECTS, 
+        std::min(mCullingThreadCount, mNumVisibleObjectsChunks));
+    mVisibleObjectsCamera = 0;
+
+    for (size_t c = 0; c < mNumVisibleObjectsChunks; ++c)
+    {
+        VisibleObjectsChunk* chunk = mVisibleObjectsChunks[c];
+        mainQueue->merge(chunk->queue);
+        if (visibleBounds)
+            visibleBounds->merge(chunk->bounds);
+    }
+
+    for (size_t c = 0; c < mNumVisibleObjectsChunks; ++c)
+    {
+        VisibleObjectsChunk* chunk = mVisibleObjectsChunks[c];
+        RenderQueue::MovableObjectList::iterator i, iend = chunk->deferred.end();
+        for (i = chunk->deferred.begin(); i != iend; ++i)
+        {
+            mainQueue->processVisibleObject(*i, cam, onlyShadowCasters, visibleBounds);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::findVisibleObjectsInItem(const VisibleObjectsItem& item, Camera* cam, 
+    RenderQueue* queue, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+{
+    item.first->_findVisibleObjects(cam, queue, visibleBounds, item.second, 
+        false, onlyShadowCasters);
+}
+//-----------------------------------------------------------------------
+void SceneManager::findVisibleObjectsInChunks(void)
+{
+    const size_t numItems = mVisibleObjectsItems.size();
+    const uint32 numChunks = static_cast<uint32>(mNumVisibleObjectsChunks);
+    for (uint32 c = mNextVisibleObjectsChunk++; c < numChunks; c = mNextVisibleObjectsChunk++)
+    {
+        VisibleObjectsChunk* chunk = mVisibleObjectsChunks[c];
+        size_t first = c * numItems / numChunks;
+        size_t last = (c + 1) * numItems / numChunks;
+        for (size_t i = first; i < last; ++i)
+        {
+            findVisibleObjectsInItem(mVisibleObjectsItems[i], mVisibleObjectsCamera, 
+                chunk->queue, &chunk->bounds, mVisibleObjectsOnlyShadowCasters);
+        }
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateAnimationsParallel(Camera* cam)
+{
+    mAnimationUpdateEntities.clear();
+    Mesh::VertexBlendLockMap locks;
+
+    try
+    {
+        MovableObjectIterator it = getMovableObjectIterator(EntityFactory::FACTORY_TYPE_NAME);
+        while (it.hasMoreElements())
+        {
+            Entity* ent = static_cast<Entity*>(it.getNext());
+            if (ent->isVisible() && ent->isInScene() &&
+                cam->isVisible(ent->getWorldBoundingBox(true)) &&
+                ent->_prepareConcurrentAnimationUpdate(cam, locks))
+            {
+                mAnimationUpdateEntities.push_back(ent);
+            }
+        }
+
+        if (!mAnimationUpdateEntities.empty())
+        {
+            size_t numBatches = (mAnimationUpdateEntities.size() + ANIMATION_UPDATE_BATCH_SIZE - 1) /
+                ANIMATION_UPDATE_BATCH_SIZE;
+            mNextAnimationUpdateBatch.set(0);
+            fireWorkerTasksAndWait(WTT_UPDATE_ANIMATIONS, std::min(mAnimationThreadCount, numBatches));
+        }
+    }
+    catch (...)
+    {
+        Mesh::_unlockForSoftwareVertexBlend(locks);
+        throw;
+    }
+
+    Mesh::_unlockForSoftwareVertexBlend(locks);
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateAnimationBatches(void)
+{
+    const size_t numEntities = mAnimationUpdateEntities.size();
+    for (size_t first = mNextAnimationUpdateBatch++ * ANIMATION_UPDATE_BATCH_SIZE; first < numEntities;
+        first = mNextAnimationUpdateBatch++ * ANIMATION_UPDATE_BATCH_SIZE)
+    {
+        size_t last = std::min(first + ANIMATION_UPDATE_BATCH_SIZE, numEntities);
+        for (size_t i = first; i < last; ++i)
+        {
+            mAnimationUpdateEntities[i]->_updateAnimationConcurrently();
+        }
+    }
+}
+//-----------------------------------------------------------------------
 void SceneManager::_renderVisibleObjects(void)
 {
     RenderQueueInvocationSequence* invocationSequence = 
@@ -2429,7 +3152,8 @@ void SceneManager::renderAdditiveStencilShadowedQueueGroupObjects(
     QueuedRenderableCollection::OrganisationMode om)
 {
     RenderQueueGroup::PriorityMapIterator groupIt = pGroup->getIterator();
-    LightList lightList;
+    BorrowedLightList borrowedLightList(mAdditiveLightList);
+    LightList& lightList = borrowedLightList.list;
 
     while (groupIt.hasMoreElements())
     {
@@ -2805,7 +3529,8 @@ void SceneManager::renderAdditiveTextureShadowedQueueGroupObjects(
     QueuedRenderableCollection::OrganisationMode om)
 {
     RenderQueueGroup::PriorityMapIterator groupIt = pGroup->getIterator();
-    LightList lightList;
+    BorrowedLightList borrowedLightList(mAdditiveLightList);
+    LightList& lightList = borrowedLightList.list;
 
     while (groupIt.hasMoreElements())
     {
@@ -3820,6 +4545,8 @@ void SceneManager::destroyAllAnimationStates(void)
 //-----------------------------------------------------------------------
 void SceneManager::_applySceneAnimations(void)
 {
+    OgreProfileGroupLiteral("_applySceneAnimations", OGREPROF_GENERAL);
+
     // manual lock over states (extended duration required)
     OGRE_LOCK_MUTEX(mAnimationStates.OGRE_AUTO_MUTEX_NAME);
 
@@ -4158,8 +4885,8 @@ void SceneManager::fireRenderSingleObject(Renderable* rend, const Pass* pass,
 //---------------------------------------------------------------------
 void SceneManager::fireShadowTexturesUpdated(size_t numberOfShadowTextures)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    FrameListenerList listenersCopy(mListeners.begin(), mListeners.end());
+    FrameListenerList::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4170,8 +4897,8 @@ void SceneManager::fireShadowTexturesUpdated(size_t numberOfShadowTextures)
 //---------------------------------------------------------------------
 void SceneManager::fireShadowTexturesPreCaster(Light* light, Camera* camera, size_t iteration)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    FrameListenerList listenersCopy(mListeners.begin(), mListeners.end());
+    FrameListenerList::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4182,8 +4909,8 @@ void SceneManager::fireShadowTexturesPreCaster(Light* light, Camera* camera, siz
 //---------------------------------------------------------------------
 void SceneManager::fireShadowTexturesPreReceiver(Light* light, Frustum* f)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    FrameListenerList listenersCopy(mListeners.begin(), mListeners.end());
+    FrameListenerList::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4194,8 +4921,8 @@ void SceneManager::fireShadowTexturesPreReceiver(Light* light, Frustum* f)
 //---------------------------------------------------------------------
 void SceneManager::firePreUpdateSceneGraph(Camera* camera)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    FrameListenerList listenersCopy(mListeners.begin(), mListeners.end());
+    FrameListenerList::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4206,8 +4933,8 @@ void SceneManager::firePreUpdateSceneGraph(Camera* camera)
 //---------------------------------------------------------------------
 void SceneManager::firePostUpdateSceneGraph(Camera* camera)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    FrameListenerList listenersCopy(mListeners.begin(), mListeners.end());
+    FrameListenerList::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4219,8 +4946,8 @@ void SceneManager::firePostUpdateSceneGraph(Camera* camera)
 //---------------------------------------------------------------------
 void SceneManager::firePreFindVisibleObjects(Viewport* v)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    FrameListenerList listenersCopy(mListeners.begin(), mListeners.end());
+    FrameListenerList::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4232,8 +4959,8 @@ void SceneManager::firePreFindVisibleObjects(Viewport* v)
 //---------------------------------------------------------------------
 void SceneManager::firePostFindVisibleObjects(Viewport* v)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    FrameListenerList listenersCopy(mListeners.begin(), mListeners.end());
+    FrameListenerList::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4246,8 +4973,8 @@ void SceneManager::firePostFindVisibleObjects(Viewport* v)
 //---------------------------------------------------------------------
 void SceneManager::fireSceneManagerDestroyed()
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    FrameListenerList listenersCopy(mListeners.begin(), mListeners.end());
+    FrameListenerList::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -4519,8 +5246,8 @@ void SceneManager::findLightsAffectingFrustum(const Camera* camera)
             // Allow a Listener to override light sorting
             // Reverse iterate so last takes precedence
             bool overridden = false;
-            ListenerList listenersCopy = mListeners;
-            for (ListenerList::reverse_iterator ri = listenersCopy.rbegin();
+            FrameListenerList listenersCopy(mListeners.begin(), mListeners.end());
+            for (FrameListenerList::reverse_iterator ri = listenersCopy.rbegin();
                 ri != listenersCopy.rend(); ++ri)
             {
                 overridden = (*ri)->sortLightsAffectingFrustum(mLightsAffectingFrustum);
@@ -5521,6 +6248,8 @@ void SceneManager::resetLightClip()
 void SceneManager::renderShadowVolumesToStencil(const Light* light, 
     const Camera* camera, bool calcScissor)
 {
+    OgreProfileGroupLiteral("renderShadowVolumesToStencil", OGREPROF_RENDERING);
+
     // Get the shadow caster list
     const ShadowCasterList& casters = findShadowCastersForLight(light, camera);
     // Check there are some shadow casters to render
@@ -5531,7 +6260,8 @@ void SceneManager::renderShadowVolumesToStencil(const Light* light,
     }
 
     // Add light to internal list for use in render call
-    LightList lightList;
+    BorrowedLightList borrowedLightList(mShadowVolumeLightList);
+    LightList& lightList = borrowedLightList.list;
     // const_cast is forgiveable here since we pass this const
     lightList.push_back(const_cast<Light*>(light));
 
@@ -5633,6 +6363,7 @@ void SceneManager::renderShadowVolumesToStencil(const Light* light,
 
 
     // Now iterate over the casters and render
+    mNumShadowVolumeItems = 0;
     for (si = casters.begin(); si != siend; ++si)
     {
         ShadowCaster* caster = *si;
@@ -5697,40 +6428,35 @@ void SceneManager::renderShadowVolumesToStencil(const Light* light,
 
         }
 
+        // Leave the indexes to the worker tasks if the caster supports it
+        if (mShadowVolumeThreadCount > 1)
+        {
+            if (mNumShadowVolumeItems == mShadowVolumeItems.size())
+            {
+                mShadowVolumeItems.push_back(ShadowVolumeItem());
+            }
+            ShadowVolumeItem& item = mShadowVolumeItems[mNumShadowVolumeItems];
+            if (caster->_prepareShadowVolume(mShadowTechnique, light, &mShadowIndexBuffer,
+                extrudeInSoftware, extrudeDist, flags, item.build))
+            {
+                item.zfail = zfailAlgo;
+                ++mNumShadowVolumeItems;
+                continue;
+            }
+        }
+
         // Get shadow renderables           
         ShadowCaster::ShadowRenderableListIterator iShadowRenderables =
             caster->getShadowVolumeRenderableIterator(mShadowTechnique,
             light, &mShadowIndexBuffer, &mShadowIndexBufferUsedSize,
             extrudeInSoftware, extrudeDist, flags);
 
-        // Render a shadow volume here
-        //  - if we have 2-sided stencil, one render with no culling
-        //  - otherwise, 2 renders, one with each culling method and invert the ops
-        setShadowVolumeStencilState(false, zfailAlgo, stencil2sided);
-        renderShadowVolumeObjects(iShadowRenderables, mShadowStencilPass, &lightList, flags,
-            false, zfailAlgo, stencil2sided);
-        if (!stencil2sided)
-        {
-            // Second pass
-            setShadowVolumeStencilState(true, zfailAlgo, false);
-            renderShadowVolumeObjects(iShadowRenderables, mShadowStencilPass, &lightList, flags,
-                true, zfailAlgo, false);
-        }
+        renderShadowVolume(iShadowRenderables, &lightList, flags, zfailAlgo, stencil2sided);
+    }
 
-        // Do we need to render a debug shadow marker?
-        if (mDebugShadows)
-        {
-            // reset stencil & colour ops
-            mDestRenderSystem->setStencilBufferParams();
-            mShadowDebugPass->getTextureUnitState(0)->
-                setColourOperationEx(LBX_MODULATE, LBS_MANUAL, LBS_CURRENT,
-                zfailAlgo ? ColourValue(0.7, 0.0, 0.2) : ColourValue(0.0, 0.7, 0.2));
-            _setPass(mShadowDebugPass);
-            renderShadowVolumeObjects(iShadowRenderables, mShadowDebugPass, &lightList, flags,
-                true, false, false);
-            mDestRenderSystem->_setColourBufferWriteEnabled(false, false, false, false);
-            mDestRenderSystem->_setDepthBufferFunction(CMPF_LESS);
-        }
+    if (mNumShadowVolumeItems > 0)
+    {
+        renderShadowVolumesParallel(&lightList, stencil2sided);
     }
 
     // revert colour write state
@@ -5750,6 +6476,164 @@ void SceneManager::renderShadowVolumesToStencil(const Light* light,
 
 }
 //---------------------------------------------------------------------
+void SceneManager::renderShadowVolume(ShadowCaster::ShadowRenderableListIterator iShadowRenderables,
+                                      const LightList* manualLightList, unsigned long flags,
+                                      bool zfailAlgo, bool stencil2sided)
+{
+    // Render a shadow volume here
+    //  - if we have 2-sided stencil, one render with no culling
+    //  - otherwise, 2 renders, one with each culling method and invert the ops
+    setShadowVolumeStencilState(false, zfailAlgo, stencil2sided);
+    renderShadowVolumeObjects(iShadowRenderables, mShadowStencilPass, manualLightList, flags,
+        false, zfailAlgo, stencil2sided);
+    if (!stencil2sided)
+    {
+        // Second pass
+        setShadowVolumeStencilState(true, zfailAlgo, false);
+        renderShadowVolumeObjects(iShadowRenderables, mShadowStencilPass, manualLightList, flags,
+            true, zfailAlgo, false);
+    }
+
+    // Do we need to render a debug shadow marker?
+    if (mDebugShadows)
+    {
+        // reset stencil & colour ops
+        mDestRenderSystem->setStencilBufferParams();
+        mShadowDebugPass->getTextureUnitState(0)->
+            setColourOperationEx(LBX_MODULATE, LBS_MANUAL, LBS_CURRENT,
+            zfailAlgo ? ColourValue(0.7, 0.0, 0.2) : ColourValue(0.0, 0.7, 0.2));
+        _setPass(mShadowDebugPass);
+        renderShadowVolumeObjects(iShadowRenderables, mShadowDebugPass, manualLightList, flags,
+            true, false, false);
+        mDestRenderSystem->_setColourBufferWriteEnabled(false, false, false, false);
+        mDestRenderSystem->_setDepthBufferFunction(CMPF_LESS);
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::renderShadowVolumesParallel(const LightList* manualLightList, bool stencil2sided)
+{
+    // Find the silhouettes and count the indexes of all the shadow volumes
+    mNextShadowVolumeItem.set(0);
+    fireWorkerTasksAndWait(WTT_FIND_SHADOW_SILHOUETTES,
+        std::min(mShadowVolumeThreadCount, mNumShadowVolumeItems));
+
+    // Then write and render as many shadow volumes as the index buffer takes
+    // at a time, which is usually all of them
+    size_t begin = 0;
+    while (begin < mNumShadowVolumeItems)
+    {
+        const size_t bufferSize = mShadowIndexBuffer->getNumIndexes();
+        size_t end = begin;
+        size_t numIndexes = 0;
+        while (end < mNumShadowVolumeItems &&
+            numIndexes + mShadowVolumeItems[end].build.indexCount <= bufferSize)
+        {
+            numIndexes += mShadowVolumeItems[end].build.indexCount;
+            ++end;
+        }
+
+        if (end == begin)
+        {
+            // A single shadow volume doesn't fit, grow the index buffer as
+            // ShadowCaster::generateShadowVolume does
+            size_t indexCount = mShadowVolumeItems[begin].build.indexCount;
+            LogManager::getSingleton().logMessage(LML_CRITICAL, 
+                String("Warning: shadow index buffer size to small. Auto increasing buffer size to") + 
+                StringConverter::toString(sizeof(unsigned short) * indexCount));
+            setShadowIndexBufferSize(indexCount);
+            if (indexCount > mShadowIndexBuffer->getNumIndexes())
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "Lock request out of bounds.",
+                    "SceneManager::renderShadowVolumesParallel");
+            }
+            continue;
+        }
+
+        if (mShadowIndexBufferUsedSize + numIndexes > bufferSize)
+        {
+            mShadowIndexBufferUsedSize = 0;
+        }
+
+        // Lay the shadow volumes out one after the other
+        size_t indexStart = mShadowIndexBufferUsedSize;
+        for (size_t i = begin; i < end; ++i)
+        {
+            ShadowCaster::ShadowVolumeBuild& build = mShadowVolumeItems[i].build;
+            build.indexStart = indexStart;
+            indexStart += build.indexCount;
+
+            ShadowCaster::ShadowRenderableList::iterator si, siend;
+            siend = build.shadowRenderables->end();
+            for (si = build.shadowRenderables->begin(); si != siend; ++si)
+            {
+                if ((*si)->getRenderOperationForUpdate()->indexData->indexBuffer != mShadowIndexBuffer)
+                {
+                    (*si)->rebindIndexBuffer(mShadowIndexBuffer);
+                }
+            }
+        }
+
+        // Lock index buffer for writing, just enough length as we need
+        mShadowVolumeIndexes = 0;
+        mShadowVolumeIndexStart = mShadowIndexBufferUsedSize;
+        if (numIndexes > 0)
+        {
+            mShadowVolumeIndexes = static_cast<unsigned short*>(mShadowIndexBuffer->lock(
+                sizeof(unsigned short) * mShadowIndexBufferUsedSize, sizeof(unsigned short) * numIndexes,
+                mShadowIndexBufferUsedSize == 0 ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NO_OVERWRITE));
+        }
+
+        mShadowVolumeItemsBegin = begin;
+        mShadowVolumeItemsEnd = end;
+        mNextShadowVolumeItem.set(0);
+        try
+        {
+            fireWorkerTasksAndWait(WTT_WRITE_SHADOW_VOLUMES,
+                std::min(mShadowVolumeThreadCount, end - begin));
+        }
+        catch (...)
+        {
+            if (mShadowVolumeIndexes)
+                mShadowIndexBuffer->unlock();
+            throw;
+        }
+
+        if (mShadowVolumeIndexes)
+            mShadowIndexBuffer->unlock();
+        mShadowIndexBufferUsedSize += numIndexes;
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            const ShadowVolumeItem& item = mShadowVolumeItems[i];
+            renderShadowVolume(ShadowCaster::ShadowRenderableListIterator(
+                item.build.shadowRenderables->begin(), item.build.shadowRenderables->end()),
+                manualLightList, item.build.flags, item.zfail, stencil2sided);
+        }
+
+        begin = end;
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::findShadowVolumeSilhouettes(void)
+{
+    for (size_t i = mNextShadowVolumeItem++; i < mNumShadowVolumeItems; i = mNextShadowVolumeItem++)
+    {
+        ShadowCaster::_findShadowVolumeSilhouette(mShadowVolumeItems[i].build);
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::writeShadowVolumeIndexes(void)
+{
+    for (size_t i = mShadowVolumeItemsBegin + mNextShadowVolumeItem++; i < mShadowVolumeItemsEnd;
+        i = mShadowVolumeItemsBegin + mNextShadowVolumeItem++)
+    {
+        const ShadowCaster::ShadowVolumeBuild& build = mShadowVolumeItems[i].build;
+        ShadowCaster::_writeShadowVolumeIndexes(build, mShadowVolumeIndexes ?
+            mShadowVolumeIndexes + (build.indexStart - mShadowVolumeIndexStart) : 0);
+    }
+}
+//---------------------------------------------------------------------
 void SceneManager::renderShadowVolumeObjects(ShadowCaster::ShadowRenderableListIterator iShadowRenderables,
                                              Pass* pass,
                                              const LightList *manualLightList,
@@ -6747,6 +7631,7 @@ void SceneManager::destroyInstancedEntity( InstancedEntity *instancedEntity )
 //---------------------------------------------------------------------
 void SceneManager::_addDirtyInstanceManager( InstanceManager *dirtyManager )
 {
+    OGRE_LOCK_MUTEX(mDirtyInstanceManagersMutex);
     mDirtyInstanceManagers.push_back( dirtyManager );
 }
 //---------------------------------------------------------------------
@@ -6835,6 +7720,179 @@ void SceneManager::destroyQuery(SceneQuery* query)
     OGRE_DELETE query;
 }
 //---------------------------------------------------------------------
+size_t SceneManager::executeRayQueries(const Ray* rays, size_t count, SceneQueryBatchHit* hits,
+    size_t maxHitsPerQuery, size_t* hitCounts, uint32 queryMask, uint32 queryTypeMask)
+{
+    mBatchQuery.type = BQT_RAY;
+    mBatchQuery.rays = rays;
+    mBatchQuery.spheres = 0;
+    mBatchQuery.boxes = 0;
+    mBatchQuery.count = count;
+    mBatchQuery.hits = hits;
+    mBatchQuery.maxHitsPerQuery = maxHitsPerQuery;
+    mBatchQuery.hitCounts = hitCounts;
+    mBatchQuery.queryMask = queryMask;
+    mBatchQuery.queryTypeMask = queryTypeMask;
+    return executeBatchQueries();
+}
+//---------------------------------------------------------------------
+size_t SceneManager::executeSphereQueries(const Sphere* spheres, size_t count, SceneQueryBatchHit* hits,
+    size_t maxHitsPerQuery, size_t* hitCounts, uint32 queryMask, uint32 queryTypeMask)
+{
+    mBatchQuery.type = BQT_SPHERE;
+    mBatchQuery.rays = 0;
+    mBatchQuery.spheres = spheres;
+    mBatchQuery.boxes = 0;
+    mBatchQuery.count = count;
+    mBatchQuery.hits = hits;
+    mBatchQuery.maxHitsPerQuery = maxHitsPerQuery;
+    mBatchQuery.hitCounts = hitCounts;
+    mBatchQuery.queryMask = queryMask;
+    mBatchQuery.queryTypeMask = queryTypeMask;
+    return executeBatchQueries();
+}
+//---------------------------------------------------------------------
+size_t SceneManager::executeBoxQueries(const AxisAlignedBox* boxes, size_t count, SceneQueryBatchHit* hits,
+    size_t maxHitsPerQuery, size_t* hitCounts, uint32 queryMask, uint32 queryTypeMask)
+{
+    mBatchQuery.type = BQT_BOX;
+    mBatchQuery.rays = 0;
+    mBatchQuery.spheres = 0;
+    mBatchQuery.boxes = boxes;
+    mBatchQuery.count = count;
+    mBatchQuery.hits = hits;
+    mBatchQuery.maxHitsPerQuery = maxHitsPerQuery;
+    mBatchQuery.hitCounts = hitCounts;
+    mBatchQuery.queryMask = queryMask;
+    mBatchQuery.queryTypeMask = queryTypeMask;
+    return executeBatchQueries();
+}
+//---------------------------------------------------------------------
+size_t SceneManager::executeBatchQueries(void)
+{
+    const size_t count = mBatchQuery.count;
+    if (!count)
+        return 0;
+    std::fill(mBatchQuery.hitCounts, mBatchQuery.hitCounts + count, 0);
+
+    prepareBatchQueries();
+
+    const size_t numPackets = (count + BATCH_QUERY_PACKET_SIZE - 1) / BATCH_QUERY_PACKET_SIZE;
+    mNextBatchQueryPacket.set(0);
+    if (mSceneQueryThreadCount > 1 && numPackets > 1)
+    {
+        fireWorkerTasksAndWait(WTT_EXECUTE_SCENE_QUERIES, std::min(mSceneQueryThreadCount, numPackets));
+    }
+    else
+    {
+        executeBatchQueryPackets();
+    }
+    // keep the storage for the next batch, but not the objects
+    mBatchQueryObjects.clear();
+
+    size_t stored = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        stored += std::min(mBatchQuery.hitCounts[i], mBatchQuery.maxHitsPerQuery);
+    }
+    return stored;
+}
+//---------------------------------------------------------------------
+void SceneManager::prepareBatchQueries(void)
+{
+    mBatchQueryObjects.clear();
+
+    // Iterate over all movable types, as the default queries do
+    Root::MovableObjectFactoryIterator factIt = 
+        Root::getSingleton().getMovableObjectFactoryIterator();
+    while (factIt.hasMoreElements())
+    {
+        MovableObjectIterator it = getMovableObjectIterator(factIt.getNext()->getType());
+        while (it.hasMoreElements())
+        {
+            MovableObject* m = it.getNext();
+            // skip whole group if type doesn't match
+            if (!(m->getTypeFlags() & mBatchQuery.queryTypeMask))
+                break;
+
+            if ((m->getQueryFlags() & mBatchQuery.queryMask) && m->isInScene())
+                mBatchQueryObjects.push_back(BatchQueryObject(m, m->getWorldBoundingBox()));
+        }
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::executeBatchQueryPackets(void)
+{
+    const size_t count = mBatchQuery.count;
+    for (size_t first = mNextBatchQueryPacket++ * BATCH_QUERY_PACKET_SIZE; first < count;
+        first = mNextBatchQueryPacket++ * BATCH_QUERY_PACKET_SIZE)
+    {
+        executeBatchQueryPacket(first, std::min(count - first, (size_t)BATCH_QUERY_PACKET_SIZE));
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::executeBatchQueryPacket(size_t first, size_t count)
+{
+    // the bounds of each object are read once for the whole packet
+    const size_t last = first + count;
+    Real distance;
+    for (BatchQueryObjectList::const_iterator i = mBatchQueryObjects.begin();
+        i != mBatchQueryObjects.end(); ++i)
+    {
+        for (size_t q = first; q < last; ++q)
+        {
+            if (testBatchQuery(q, i->second, distance))
+                addBatchQueryHit(q, i->first, distance);
+        }
+    }
+}
+//---------------------------------------------------------------------
+bool SceneManager::testBatchQuery(size_t query, const AxisAlignedBox& box, Real& distance) const
+{
+    distance = 0;
+    switch (mBatchQuery.type)
+    {
+    case BQT_RAY:
+        {
+            std::pair<bool, Real> result = Math::intersects(mBatchQuery.rays[query], box);
+            distance = result.second;
+            return result.first;
+        }
+    case BQT_SPHERE:
+        return Math::intersects(mBatchQuery.spheres[query], box);
+    case BQT_BOX:
+        return mBatchQuery.boxes[query].intersects(box);
+    }
+    return false;
+}
+//---------------------------------------------------------------------
+void SceneManager::addBatchQueryHit(size_t query, MovableObject* movable, Real distance)
+{
+    // each query is handled by a single packet, so this needs no locking
+    const size_t maxHits = mBatchQuery.maxHitsPerQuery;
+    const size_t found = mBatchQuery.hitCounts[query]++;
+    SceneQueryBatchHit* hits = mBatchQuery.hits + query * maxHits;
+
+    size_t pos = found;
+    if (found >= maxHits)
+    {
+        // full: volume queries keep the first hits, rays the nearest ones
+        if (mBatchQuery.type != BQT_RAY || maxHits == 0 ||
+            distance >= hits[maxHits - 1].distance)
+        {
+            return;
+        }
+        pos = maxHits - 1;
+    }
+    if (mBatchQuery.type == BQT_RAY)
+    {
+        for (; pos > 0 && hits[pos - 1].distance > distance; --pos)
+            hits[pos] = hits[pos - 1];
+    }
+    hits[pos].movable = movable;
+    hits[pos].distance = distance;
+}
+//---------------------------------------------------------------------
 SceneManager::MovableObjectCollection* 
 SceneManager::getMovableObjectCollection(const String& typeName)
 {
@@ -7206,7 +8264,10 @@ void SceneManager::_notifyMovableObjectLodChanged(MovableObjectLodChangedEvent&
 
     // Push event onto queue if requested
     if (queueEvent)
+    {
+        OGRE_LOCK_MUTEX(mLodEventsMutex);
         mMovableObjectLodChangedEvents.push_back(evt);
+    }
 }
 //---------------------------------------------------------------------
 void SceneManager::_notifyEntityMeshLodChanged(EntityMeshLodChangedEvent& evt)
@@ -7221,7 +8282,10 @@ void SceneManager::_notifyEntityMeshLodChanged(EntityMeshLodChangedEvent& evt)
 
     // Push event onto queue if requested
     if (queueEvent)
+    {
+        OGRE_LOCK_MUTEX(mLodEventsMutex);
         mEntityMeshLodChangedEvents.push_back(evt);
+    }
 }
 //---------------------------------------------------------------------
 void SceneManager::_notifyEntityMaterialLodChanged(EntityMaterialLodChangedEvent& evt)
@@ -7236,7 +8300,10 @@ void SceneManager::_notifyEntityMaterialLodChanged(EntityMaterialLodChangedEvent
 
     // Push event onto queue if requested
     if (queueEvent)
+    {
+        OGRE_LOCK_MUTEX(mLodEventsMutex);
         mEntityMaterialLodChangedEvents.push_back(evt);
+    }
 }
 //---------------------------------------------------------------------
 void SceneManager::_handleLodEvents()
@@ -7411,6 +8478,16 @@ void VisibleObjectsBoundsInfo::merge(const AxisAlignedBox& boxBounds, const Sphe
     maxDistanceInFrustum = std::max(maxDistanceInFrustum, camDistToCenter + sphereBounds.getRadius());
 }
 //---------------------------------------------------------------------
+void VisibleObjectsBoundsInfo::merge(const VisibleObjectsBoundsInfo& rhs)
+{
+    aabb.merge(rhs.aabb);
+    receiverAabb.merge(rhs.receiverAabb);
+    minDistance = std::min(minDistance, rhs.minDistance);
+    maxDistance = std::max(maxDistance, rhs.maxDistance);
+    minDistanceInFrustum = std::min(minDistanceInFrustum, rhs.minDistanceInFrustum);
+    maxDistanceInFrustum = std::max(maxDistanceInFrustum, rhs.maxDistanceInFrustum);
+}
+//---------------------------------------------------------------------
 void VisibleObjectsBoundsInfo::mergeNonRenderedButInFrustum(const AxisAlignedBox& boxBounds, 
                                   const Sphere& sphereBounds, const Camera* cam)
 {
@@ -290,13 +290,34 @@ namespace Ogre {
 
         if (includeChildren)
         {
-            ChildNodeMap::iterator child, childend;
-            childend = mChildren.end();
-            for (child = mChildren.begin(); child != childend; ++child)
+            // Cull the children a batch at a time rather than one by one
+            const size_t batchSize = 32;
+            SceneNode* children[batchSize];
+            const AxisAlignedBox* bounds[batchSize];
+            bool visible[batchSize];
+
+            ChildNodeMap::iterator child = mChildren.begin(), childend = mChildren.end();
+            while (child != childend)
             {
-                SceneNode* sceneChild = static_cast<SceneNode*>(child->second);
-                sceneChild->_findVisibleObjects(cam, queue, visibleBounds, includeChildren, 
-                    displayNodes, onlyShadowCasters);
+                size_t count = 0;
+                for (; child != childend && count < batchSize; ++child, ++count)
+                {
+                    children[count] = static_cast<SceneNode*>(child->second);
+                    bounds[count] = &children[count]->mWorldAABB;
+                }
+
+                cam->areVisible(bounds, count, visible);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (visible[i])
+                    {
+                        // Go through the virtual method so subclasses get their say,
+                        // the visible ones are tested again there
+                        children[i]->_findVisibleObjects(cam, queue, visibleBounds, 
+                            includeChildren, displayNodes, onlyShadowCasters);
+                    }
+                }
             }
         }
 
@@ -349,10 +370,8 @@ namespace Ogre {
     }
 
     //-----------------------------------------------------------------------
-    void SceneNode::updateFromParentImpl(void) const
+    void SceneNode::derivedTransformUpdated(void) const
     {
-        Node::updateFromParentImpl();
-
         // Notify objects that it has been moved
         ObjectMap::const_iterator i;
         for (i = mObjectsByName.begin(); i != mObjectsByName.end(); ++i)
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreSceneQuery.h"
 #include "OgreException.h"
 #include "OgreSceneManager.h"
+#include "OgreEntity.h"
 
 namespace Ogre {
 
@@ -196,6 +197,7 @@ namespace Ogre {
     {
         mSortByDistance = false;
         mMaxResults = 0;
+        mQueryTriangles = false;
     }
     //-----------------------------------------------------------------------
     RaySceneQuery::~RaySceneQuery()
@@ -228,6 +230,16 @@ namespace Ogre {
         return mMaxResults;
     }
     //-----------------------------------------------------------------------
+    void RaySceneQuery::setQueryTriangles(bool enabled)
+    {
+        mQueryTriangles = enabled;
+    }
+    //-----------------------------------------------------------------------
+    bool RaySceneQuery::getQueryTriangles(void) const
+    {
+        return mQueryTriangles;
+    }
+    //-----------------------------------------------------------------------
     RaySceneQueryResult& RaySceneQuery::execute(void)
     {
         // Clear without freeing the vector buffer
@@ -272,6 +284,23 @@ namespace Ogre {
         dets.distance = distance;
         dets.movable = obj;
         dets.worldFragment = NULL;
+        dets.subMeshIndex = -1;
+        dets.triangleIndex = 0;
+        dets.u = dets.v = 0;
+
+        if (mQueryTriangles && obj->getMovableType() == EntityFactory::FACTORY_TYPE_NAME)
+        {
+            // replace the bounding box hit with the nearest triangle hit
+            MeshTriangleBvh::Hit hit;
+            if (!static_cast<Entity*>(obj)->intersects(mRay, hit))
+                return true;
+
+            dets.distance = hit.distance;
+            dets.subMeshIndex = hit.subMeshIndex;
+            dets.triangleIndex = hit.triangleIndex;
+            dets.u = hit.u;
+            dets.v = hit.v;
+        }
         mResult.push_back(dets);
         // Continue
         return true;
@@ -284,6 +313,9 @@ namespace Ogre {
         dets.distance = distance;
         dets.movable = NULL;
         dets.worldFragment = fragment;
+        dets.subMeshIndex = -1;
+        dets.triangleIndex = 0;
+        dets.u = dets.v = 0;
         mResult.push_back(dets);
         // Continue
         return true;
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreRoot.h"
 #include "OgreSceneManager.h"
+#include "OgreFrameAllocator.h"
 
 namespace Ogre {
     const LightList& ShadowRenderable::getLights(void) const 
@@ -57,257 +58,229 @@ namespace Ogre {
         edgeData->updateTriangleLightFacing(lightPos);
     }
     // ------------------------------------------------------------------------
-    void ShadowCaster::generateShadowVolume(EdgeData* edgeData, 
-        const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize, 
-        const Light* light, ShadowRenderableList& shadowRenderables, unsigned long flags)
+    /** Working arrays of a shadow volume generated by generateShadowVolume.
+    @remarks
+        They only live while one shadow volume is generated on the rendering
+        thread, so they come from the frame arena rather than being allocated
+        and freed again for every caster and light.
+    */
+    struct FrameSilhouette
     {
-        // Edge groups should be 1:1 with shadow renderables
-        assert(edgeData->edgeGroups.size() == shadowRenderables.size());
+        typedef std::vector<size_t, STLAllocator<size_t, FrameAllocPolicy> > SizeList;
+        /// Silhouette edges of each edge group, in edge group order
+        SizeList silhouetteEdges;
+        /// Start of each edge group in silhouetteEdges, plus the end of the last one
+        SizeList silhouetteEdgeStarts;
+        /// Number of light facing triangles of each edge group
+        SizeList lightFacingCounts;
+    };
+    // ------------------------------------------------------------------------
+    /** Finds the silhouette edges of a set of edges, writing their indexes in
+        ascending order and returning how many there are.
+    @remarks
+        An edge is a silhouette edge when its two triangles have opposite light
+        facing states, or when it is degenerate and its only triangle faces the
+        light. silhouetteEdges must have room for numEdges indexes.
+    */
+    static size_t findSilhouetteEdges(const char* lightFacings,
+        const EdgeData::Edge* edges, size_t numEdges, size_t* silhouetteEdges)
+    {
+        // Silhouette edges are sparse, so rather than branching on each edge,
+        // every index is written and the output only advanced past silhouettes
+        size_t numSilhouetteEdges = 0;
+        for (size_t i = 0; i < numEdges; ++i)
+        {
+            const EdgeData::Edge& edge = edges[i];
+            char lightFacing0 = lightFacings[edge.triIndex[0]];
+            char lightFacing1 = edge.degenerate ? 0 : lightFacings[edge.triIndex[1]];
 
-        Light::LightTypes lightType = light->getType();
+            silhouetteEdges[numSilhouetteEdges] = i;
+            numSilhouetteEdges += (lightFacing0 != lightFacing1);
+        }
+        return numSilhouetteEdges;
+    }
+    // ------------------------------------------------------------------------
+    /** Finds the silhouette edges of the edge groups of a shadow volume, and
+        counts the indexes needed to render it.
+    @param silhouette The build itself, or a FrameSilhouette
+    */
+    template <typename Silhouette>
+    static void findSilhouette(ShadowCaster::ShadowVolumeBuild& build, Silhouette& silhouette,
+        const char* lightFacings)
+    {
+        const EdgeData* edgeData = build.edgeData;
+        const size_t numGroups = edgeData->edgeGroups.size();
 
-        // Whether to use the McGuire method, a triangle fan covering all silhouette
-        // This won't work properly with multiple separate edge groups (should be one fan per group, not implemented)
-        // or when light position is inside light cap bound as extrusion could be in opposite directions
-        // and McGuire cap could intersect near clip plane of camera frustum without being noticed.
-        bool useMcGuire = edgeData->edgeGroups.size() <= 1 && 
-            (lightType == Light::LT_DIRECTIONAL || !getLightCapBounds().contains(light->getDerivedPosition()));
+        size_t numEdges = 0;
         EdgeData::EdgeGroupList::const_iterator egi, egiend;
-        ShadowRenderableList::const_iterator si;
-
-        // pre-count the size of index data we need since it makes a big perf difference
-        // to GL in particular if we lock a smaller area of the index buffer
-        size_t preCountIndexes = 0;
-
-        si = shadowRenderables.begin();
         egiend = edgeData->edgeGroups.end();
-        for (egi = edgeData->edgeGroups.begin(); egi != egiend; ++egi, ++si)
+        for (egi = edgeData->edgeGroups.begin(); egi != egiend; ++egi)
         {
-            const EdgeData::EdgeGroup& eg = *egi;
-            bool  firstDarkCapTri = true;
+            numEdges += egi->edges.size();
+        }
+        silhouette.silhouetteEdges.resize(numEdges);
+        silhouette.silhouetteEdgeStarts.resize(numGroups + 1);
+        silhouette.lightFacingCounts.resize(numGroups);
+
+        // 2 tris per silhouette edge if light is a point light, 1 if light is
+        // directional and the volume is extruded to infinity
+        const size_t edgeIndexes =
+            (build.directionalLight && (build.flags & SRF_EXTRUDE_TO_INFINITY)) ? 3 : 6;
+        const bool darkCap = (build.flags & SRF_INCLUDE_DARK_CAP) != 0;
+        const bool lightCap = (build.flags & SRF_INCLUDE_LIGHT_CAP) != 0;
+
+        size_t numIndexes = 0;
+        size_t numSilhouetteEdges = 0;
+        for (size_t g = 0; g < numGroups; ++g)
+        {
+            const EdgeData::EdgeGroup& eg = edgeData->edgeGroups[g];
 
-            EdgeData::EdgeList::const_iterator i, iend;
-            iend = eg.edges.end();
-            for (i = eg.edges.begin(); i != iend; ++i)
+            silhouette.silhouetteEdgeStarts[g] = numSilhouetteEdges;
+            size_t groupSilhouetteEdges = 0;
+            if (!eg.edges.empty())
             {
-                const EdgeData::Edge& edge = *i;
+                groupSilhouetteEdges = findSilhouetteEdges(lightFacings,
+                    &eg.edges.front(), eg.edges.size(), &silhouette.silhouetteEdges[numSilhouetteEdges]);
+            }
+            numSilhouetteEdges += groupSilhouetteEdges;
 
-                // Silhouette edge, when two tris has opposite light facing, or
-                // degenerate edge where only tri 1 is valid and the tri light facing
-                char lightFacing = edgeData->triangleLightFacings[edge.triIndex[0]];
-                if ((edge.degenerate && lightFacing) ||
-                    (!edge.degenerate && (lightFacing != edgeData->triangleLightFacings[edge.triIndex[1]])))
+            size_t groupLightFacings = 0;
+            if (darkCap || lightCap)
+            {
+                const char* lfi = lightFacings + eg.triStart;
+                for (size_t i = 0; i < eg.triCount; ++i)
                 {
-
-                    preCountIndexes += 3;
-
-                    // Are we extruding to infinity?
-                    if (!(lightType == Light::LT_DIRECTIONAL &&
-                        flags & SRF_EXTRUDE_TO_INFINITY))
-                    {
-                        preCountIndexes += 3;
-                    }
-
-                    if(useMcGuire)
-                    {
-                        // Do dark cap tri
-                        // Use McGuire et al method, a triangle fan covering all silhouette
-                        // edges and one point (taken from the initial tri)
-                        if (flags & SRF_INCLUDE_DARK_CAP)
-                        {
-                            if (firstDarkCapTri)
-                            {
-                                firstDarkCapTri = false;
-                            }
-                            else
-                            {
-                                preCountIndexes += 3;
-                            }
-                        }
-                    }
+                    groupLightFacings += (lfi[i] != 0);
                 }
-
             }
+            silhouette.lightFacingCounts[g] = groupLightFacings;
 
-            if(useMcGuire)
+            numIndexes += groupSilhouetteEdges * edgeIndexes;
+            if (build.useMcGuire)
             {
-                // Do light cap
-                if (flags & SRF_INCLUDE_LIGHT_CAP) 
+                // Dark cap is a triangle fan covering all silhouette edges and
+                // one point, taken from the first edge
+                if (darkCap && groupSilhouetteEdges > 1)
                 {
-                    // Iterate over the triangles which are using this vertex set
-                    EdgeData::TriangleList::const_iterator ti, tiend;
-                    EdgeData::TriangleLightFacingList::const_iterator lfi;
-                    ti = edgeData->triangles.begin() + eg.triStart;
-                    tiend = ti + eg.triCount;
-                    lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                    for ( ; ti != tiend; ++ti, ++lfi)
-                    {
-                        assert(ti->vertexSet == eg.vertexSet);
-                        // Check it's light facing
-                        if (*lfi)
-                        {
-                            preCountIndexes += 3;
-                        }
-                    }
-
+                    numIndexes += (groupSilhouetteEdges - 1) * 3;
                 }
-            }
-            else
-            {
-                // Do both caps
-                int increment = ((flags & SRF_INCLUDE_DARK_CAP) ? 3 : 0) + ((flags & SRF_INCLUDE_LIGHT_CAP) ? 3 : 0);
-                if(increment != 0)
+                if (lightCap)
                 {
-                    // Iterate over the triangles which are using this vertex set
-                    EdgeData::TriangleList::const_iterator ti, tiend;
-                    EdgeData::TriangleLightFacingList::const_iterator lfi;
-                    ti = edgeData->triangles.begin() + eg.triStart;
-                    tiend = ti + eg.triCount;
-                    lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                    for ( ; ti != tiend; ++ti, ++lfi)
-                    {
-                        assert(ti->vertexSet == eg.vertexSet);
-                        // Check it's light facing
-                        if (*lfi)
-                            preCountIndexes += increment;
-                    }
+                    numIndexes += groupLightFacings * 3;
                 }
             }
-        }
-        // End pre-count
-        
-        //Check if index buffer is to small 
-        if (preCountIndexes > indexBuffer->getNumIndexes())
-        {
-            LogManager::getSingleton().logMessage(LML_CRITICAL, 
-                String("Warning: shadow index buffer size to small. Auto increasing buffer size to") + 
-                StringConverter::toString(sizeof(unsigned short) * preCountIndexes));
-            
-            SceneManager* pManager = Root::getSingleton()._getCurrentSceneManager();
-            if (pManager)
-            {
-                pManager->setShadowIndexBufferSize(preCountIndexes);
-            }
-            
-            //Check that the index buffer size has actually increased
-            if (preCountIndexes > indexBuffer->getNumIndexes())
+            else
             {
-                //increasing index buffer size has failed
-                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
-                    "Lock request out of bounds.",
-                    "ShadowCaster::generateShadowVolume");
+                // Both caps use the light facing triangles
+                numIndexes += groupLightFacings * ((darkCap ? 3 : 0) + (lightCap ? 3 : 0));
             }
         }
-        else if(indexBufferUsedSize + preCountIndexes > indexBuffer->getNumIndexes())
-        {
-            indexBufferUsedSize = 0;
-        }
+        silhouette.silhouetteEdgeStarts[numGroups] = numSilhouetteEdges;
+        build.indexCount = numIndexes;
+    }
+    // ------------------------------------------------------------------------
+    /** Writes the indexes of a shadow volume whose silhouette has been found,
+        and updates the index ranges of its shadow renderables.
+    */
+    template <typename Silhouette>
+    static void writeIndexes(const ShadowCaster::ShadowVolumeBuild& build,
+        const Silhouette& silhouette, const char* lightFacings, unsigned short* pIdx)
+    {
+        const EdgeData* edgeData = build.edgeData;
+        const unsigned long flags = build.flags;
+        const bool useMcGuire = build.useMcGuire;
+        const size_t numGroups = edgeData->edgeGroups.size();
+
+        size_t numIndices = build.indexStart;
 
-        // Lock index buffer for writing, just enough length as we need
-        unsigned short* pIdx = static_cast<unsigned short*>(
-            indexBuffer->lock(sizeof(unsigned short) * indexBufferUsedSize, sizeof(unsigned short) * preCountIndexes,
-            indexBufferUsedSize == 0 ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NO_OVERWRITE));
-        size_t numIndices = indexBufferUsedSize;
-        
         // Iterate over the groups and form renderables for each based on their
         // lightFacing
-        si = shadowRenderables.begin();
-        egiend = edgeData->edgeGroups.end();
-        for (egi = edgeData->edgeGroups.begin(); egi != egiend; ++egi, ++si)
+        ShadowCaster::ShadowRenderableList::const_iterator si = build.shadowRenderables->begin();
+        for (size_t g = 0; g < numGroups; ++g, ++si)
         {
-            const EdgeData::EdgeGroup& eg = *egi;
+            const EdgeData::EdgeGroup& eg = edgeData->edgeGroups[g];
             // Initialise the index start for this shadow renderable
             IndexData* indexData = (*si)->getRenderOperationForUpdate()->indexData;
-
-            if (indexData->indexBuffer != indexBuffer)
-            {
-                (*si)->rebindIndexBuffer(indexBuffer);
-                indexData = (*si)->getRenderOperationForUpdate()->indexData;
-            }
-
             indexData->indexStart = numIndices;
             // original number of verts (without extruded copy)
             size_t originalVertexCount = eg.vertexData->vertexCount;
             bool  firstDarkCapTri = true;
             unsigned short darkCapStart = 0;
 
-            EdgeData::EdgeList::const_iterator i, iend;
-            iend = eg.edges.end();
-            for (i = eg.edges.begin(); i != iend; ++i)
+            const size_t* silhouetteEdge = silhouette.silhouetteEdges.empty() ? 0 :
+                &silhouette.silhouetteEdges.front() + silhouette.silhouetteEdgeStarts[g];
+            const size_t* silhouetteEdgeEnd = silhouetteEdge +
+                (silhouette.silhouetteEdgeStarts[g + 1] - silhouette.silhouetteEdgeStarts[g]);
+            for ( ; silhouetteEdge != silhouetteEdgeEnd; ++silhouetteEdge)
             {
-                const EdgeData::Edge& edge = *i;
+                const EdgeData::Edge& edge = eg.edges[*silhouetteEdge];
 
                 // Silhouette edge, when two tris has opposite light facing, or
                 // degenerate edge where only tri 1 is valid and the tri light facing
-                char lightFacing = edgeData->triangleLightFacings[edge.triIndex[0]];
-                if ((edge.degenerate && lightFacing) ||
-                    (!edge.degenerate && (lightFacing != edgeData->triangleLightFacings[edge.triIndex[1]])))
+                char lightFacing = lightFacings[edge.triIndex[0]];
+                size_t v0 = edge.vertIndex[0];
+                size_t v1 = edge.vertIndex[1];
+                if (!lightFacing)
                 {
-                    size_t v0 = edge.vertIndex[0];
-                    size_t v1 = edge.vertIndex[1];
-                    if (!lightFacing)
-                    {
-                        // Inverse edge indexes when t1 is light away
-                        std::swap(v0, v1);
-                    }
-
-                    /* Note edge(v0, v1) run anticlockwise along the edge from
-                    the light facing tri so to point shadow volume tris outward,
-                    light cap indexes have to be backwards
-
-                    We emit 2 tris if light is a point light, 1 if light 
-                    is directional, because directional lights cause all
-                    points to converge to a single point at infinity.
-
-                    First side tri = near1, near0, far0
-                    Second tri = far0, far1, near1
+                    // Inverse edge indexes when t1 is light away
+                    std::swap(v0, v1);
+                }
 
-                    'far' indexes are 'near' index + originalVertexCount
-                    because 'far' verts are in the second half of the 
-                    buffer
-                    */
-                    assert(v1 < 65536 && v0 < 65536 && (v0 + originalVertexCount) < 65536 &&
-                        "Vertex count exceeds 16-bit index limit!");
-                    *pIdx++ = static_cast<unsigned short>(v1);
-                    *pIdx++ = static_cast<unsigned short>(v0);
+                /* Note edge(v0, v1) run anticlockwise along the edge from
+                the light facing tri so to point shadow volume tris outward,
+                light cap indexes have to be backwards
+
+                We emit 2 tris if light is a point light, 1 if light 
+                is directional, because directional lights cause all
+                points to converge to a single point at infinity.
+
+                First side tri = near1, near0, far0
+                Second tri = far0, far1, near1
+
+                'far' indexes are 'near' index + originalVertexCount
+                because 'far' verts are in the second half of the 
+                buffer
+                */
+                assert(v1 < 65536 && v0 < 65536 && (v0 + originalVertexCount) < 65536 &&
+                    "Vertex count exceeds 16-bit index limit!");
+                *pIdx++ = static_cast<unsigned short>(v1);
+                *pIdx++ = static_cast<unsigned short>(v0);
+                *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
+                numIndices += 3;
+
+                // Are we extruding to infinity?
+                if (!(build.directionalLight &&
+                    flags & SRF_EXTRUDE_TO_INFINITY))
+                {
+                    // additional tri to make quad
                     *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
+                    *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
+                    *pIdx++ = static_cast<unsigned short>(v1);
                     numIndices += 3;
+                }
 
-                    // Are we extruding to infinity?
-                    if (!(lightType == Light::LT_DIRECTIONAL &&
-                        flags & SRF_EXTRUDE_TO_INFINITY))
-                    {
-                        // additional tri to make quad
-                        *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
-                        *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
-                        *pIdx++ = static_cast<unsigned short>(v1);
-                        numIndices += 3;
-                    }
-
-                    if(useMcGuire)
+                if(useMcGuire)
+                {
+                    // Do dark cap tri
+                    // Use McGuire et al method, a triangle fan covering all silhouette
+                    // edges and one point (taken from the initial tri)
+                    if (flags & SRF_INCLUDE_DARK_CAP)
                     {
-                        // Do dark cap tri
-                        // Use McGuire et al method, a triangle fan covering all silhouette
-                        // edges and one point (taken from the initial tri)
-                        if (flags & SRF_INCLUDE_DARK_CAP)
+                        if (firstDarkCapTri)
                         {
-                            if (firstDarkCapTri)
-                            {
-                                darkCapStart = static_cast<unsigned short>(v0 + originalVertexCount);
-                                firstDarkCapTri = false;
-                            }
-                            else
-                            {
-                                *pIdx++ = darkCapStart;
-                                *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
-                                *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
-                                numIndices += 3;
-                            }
-
+                            darkCapStart = static_cast<unsigned short>(v0 + originalVertexCount);
+                            firstDarkCapTri = false;
+                        }
+                        else
+                        {
+                            *pIdx++ = darkCapStart;
+                            *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
+                            *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
+                            numIndices += 3;
                         }
+
                     }
                 }
-
             }
 
             if(!useMcGuire)
@@ -317,10 +290,10 @@ namespace Ogre {
                 {
                     // Iterate over the triangles which are using this vertex set
                     EdgeData::TriangleList::const_iterator ti, tiend;
-                    EdgeData::TriangleLightFacingList::const_iterator lfi;
+                    const char* lfi;
                     ti = edgeData->triangles.begin() + eg.triStart;
                     tiend = ti + eg.triCount;
-                    lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
+                    lfi = lightFacings + eg.triStart;
                     for ( ; ti != tiend; ++ti, ++lfi)
                     {
                         const EdgeData::Triangle& t = *ti;
@@ -358,10 +331,10 @@ namespace Ogre {
 
                 // Iterate over the triangles which are using this vertex set
                 EdgeData::TriangleList::const_iterator ti, tiend;
-                EdgeData::TriangleLightFacingList::const_iterator lfi;
+                const char* lfi;
                 ti = edgeData->triangles.begin() + eg.triStart;
                 tiend = ti + eg.triCount;
-                lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
+                lfi = lightFacings + eg.triStart;
                 for ( ; ti != tiend; ++ti, ++lfi)
                 {
                     const EdgeData::Triangle& t = *ti;
@@ -386,16 +359,145 @@ namespace Ogre {
 
         }
 
+        // In debug mode, check the count was right
+        assert(numIndices == build.indexStart + build.indexCount);
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::initShadowVolumeBuild(ShadowVolumeBuild& build, EdgeData* edgeData,
+        const Light* light, ShadowRenderableList& shadowRenderables, unsigned long flags) const
+    {
+        // Edge groups should be 1:1 with shadow renderables
+        assert(edgeData->edgeGroups.size() == shadowRenderables.size());
+
+        build.edgeData = edgeData;
+        build.shadowRenderables = &shadowRenderables;
+        build.directionalLight = light->getType() == Light::LT_DIRECTIONAL;
+        // Whether to use the McGuire method, a triangle fan covering all silhouette
+        // This won't work properly with multiple separate edge groups (should be one fan per group, not implemented)
+        // or when light position is inside light cap bound as extrusion could be in opposite directions
+        // and McGuire cap could intersect near clip plane of camera frustum without being noticed.
+        build.useMcGuire = edgeData->edgeGroups.size() <= 1 && 
+            (build.directionalLight || !getLightCapBounds().contains(light->getDerivedPosition()));
+        build.flags = flags;
+        build.indexCount = 0;
+        build.indexStart = 0;
+    }
+    // ------------------------------------------------------------------------
+    bool ShadowCaster::_prepareShadowVolume(
+        ShadowTechnique shadowTechnique, const Light* light,
+        HardwareIndexBufferSharedPtr* indexBuffer,
+        bool extrudeVertices, Real extrusionDistance, unsigned long flags,
+        ShadowVolumeBuild& build)
+    {
+        // Left to getShadowVolumeRenderableIterator
+        return false;
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::_findShadowVolumeSilhouette(ShadowVolumeBuild& build)
+    {
+        const EdgeData* edgeData = build.edgeData;
+
+        // Same as EdgeData::updateTriangleLightFacing, but into the build so
+        // that casters sharing the edge list don't get in each other's way
+        build.lightFacings.resize(edgeData->triangles.size());
+        if (build.lightFacings.empty())
+        {
+            build.silhouetteEdges.clear();
+            build.silhouetteEdgeStarts.assign(edgeData->edgeGroups.size() + 1, 0);
+            build.lightFacingCounts.assign(edgeData->edgeGroups.size(), 0);
+            build.indexCount = 0;
+            return;
+        }
+
+        assert(edgeData->triangleFaceNormals.size() == build.lightFacings.size());
+        OptimisedUtil::getImplementation()->calculateLightFacing(
+            build.lightPos,
+            &edgeData->triangleFaceNormals.front(),
+            &build.lightFacings.front(),
+            build.lightFacings.size());
+
+        findSilhouette(build, build, &build.lightFacings.front());
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::_writeShadowVolumeIndexes(const ShadowVolumeBuild& build,
+        unsigned short* pIndexes)
+    {
+        writeIndexes(build, build, build.lightFacings.empty() ? 0 : &build.lightFacings.front(), pIndexes);
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::generateShadowVolume(EdgeData* edgeData, 
+        const HardwareIndexBufferSharedPtr& indexBuffer, size_t& indexBufferUsedSize, 
+        const Light* light, ShadowRenderableList& shadowRenderables, unsigned long flags)
+    {
+        // Only the parameters of the build are used, the arrays are taken from
+        // the frame arena and released when the volume has been written
+        FrameAllocator::Scope frameScope(FrameAllocator::getSingletonPtr());
+        FrameSilhouette silhouette;
+        ShadowVolumeBuild build;
+        initShadowVolumeBuild(build, edgeData, light, shadowRenderables, flags);
+
+        // The light facing state has been calculated by updateEdgeListLightFacing.
+        // Pre-count the size of index data we need since it makes a big perf difference
+        // to GL in particular if we lock a smaller area of the index buffer
+        const char* lightFacings = edgeData->triangleLightFacings.empty() ? 0 :
+            &edgeData->triangleLightFacings.front();
+        findSilhouette(build, silhouette, lightFacings);
+        size_t preCountIndexes = build.indexCount;
+        
+        //Check if index buffer is to small 
+        if (preCountIndexes > indexBuffer->getNumIndexes())
+        {
+            LogManager::getSingleton().logMessage(LML_CRITICAL, 
+                String("Warning: shadow index buffer size to small. Auto increasing buffer size to") + 
+                StringConverter::toString(sizeof(unsigned short) * preCountIndexes));
+            
+            SceneManager* pManager = Root::getSingleton()._getCurrentSceneManager();
+            if (pManager)
+            {
+                pManager->setShadowIndexBufferSize(preCountIndexes);
+            }
+            
+            //Check that the index buffer size has actually increased
+            if (preCountIndexes > indexBuffer->getNumIndexes())
+            {
+                //increasing index buffer size has failed
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "Lock request out of bounds.",
+                    "ShadowCaster::generateShadowVolume");
+            }
+        }
+        else if(indexBufferUsedSize + preCountIndexes > indexBuffer->getNumIndexes())
+        {
+            indexBufferUsedSize = 0;
+        }
+
+        // Lock index buffer for writing, just enough length as we need
+        unsigned short* pIdx = static_cast<unsigned short*>(
+            indexBuffer->lock(sizeof(unsigned short) * indexBufferUsedSize, sizeof(unsigned short) * preCountIndexes,
+            indexBufferUsedSize == 0 ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NO_OVERWRITE));
+
+        ShadowRenderableList::const_iterator si, siend;
+        siend = shadowRenderables.end();
+        for (si = shadowRenderables.begin(); si != siend; ++si)
+        {
+            if ((*si)->getRenderOperationForUpdate()->indexData->indexBuffer != indexBuffer)
+            {
+                (*si)->rebindIndexBuffer(indexBuffer);
+            }
+        }
+
+        build.indexStart = indexBufferUsedSize;
+        writeIndexes(build, silhouette, lightFacings, pIdx);
+
         // Unlock index buffer
         indexBuffer->unlock();
 
         // In debug mode, check we didn't overrun the index buffer
-        assert(numIndices == indexBufferUsedSize + preCountIndexes);
-        assert(numIndices <= indexBuffer->getNumIndexes() &&
+        assert(indexBufferUsedSize + preCountIndexes <= indexBuffer->getNumIndexes() &&
             "Index buffer overrun while generating shadow volume!! "
             "You must increase the size of the shadow index buffer.");
 
-        indexBufferUsedSize = numIndices;
+        indexBufferUsedSize += preCountIndexes;
     }
     // ------------------------------------------------------------------------
     void ShadowCaster::extrudeVertices(
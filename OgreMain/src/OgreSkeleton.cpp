@@ -203,6 +203,12 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void Skeleton::setAnimationState(const AnimationStateSet& animSet)
+    {
+        setAnimationState(animSet, 0);
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::setAnimationState(const AnimationStateSet& animSet,
+        const AnimationState::BoneBlendMask* boneMask)
     {
         /* 
         Algorithm:
@@ -249,15 +255,37 @@ namespace Ogre {
             // tolerate state entries for animations we're not aware of
             if (anim)
             {
-              if(animState->hasBlendMask())
+              const AnimationState::BoneBlendMask* blendMask =
+                  animState->hasBlendMask() ? animState->getBlendMask() : 0;
+              // Combine with the bone mask, padded so every handle can be looked up
+              AnimationState::BoneBlendMask combinedMask;
+              if (boneMask && (blendMask || boneMask->size() < mBoneList.size()))
+              {
+                  combinedMask.resize(mBoneList.size(), 1.0f);
+                  for (size_t h = 0; h < combinedMask.size(); ++h)
+                  {
+                      if (h < boneMask->size())
+                          combinedMask[h] = (*boneMask)[h];
+                      if (blendMask)
+                          combinedMask[h] *= (*blendMask)[h];
+                  }
+                  blendMask = &combinedMask;
+              }
+              else if (boneMask)
+              {
+                  blendMask = boneMask;
+              }
+
+              if(blendMask)
               {
                 anim->apply(this, animState->getTimePosition(), animState->getWeight() * weightFactor,
-                  animState->getBlendMask(), linked ? linked->scale : 1.0f);
+                  blendMask, linked ? linked->scale : 1.0f, &animState->_getKeyCursor());
               }
               else
               {
                 anim->apply(this, animState->getTimePosition(), 
-                  animState->getWeight() * weightFactor, linked ? linked->scale : 1.0f);
+                  animState->getWeight() * weightFactor, linked ? linked->scale : 1.0f,
+                  &animState->_getKeyCursor());
               }
             }
         }
@@ -930,6 +958,15 @@ namespace Ogre {
                 }
             }
 
+            // Copy from regular tracks if the source is compressed
+            Animation* expandedAnimation = 0;
+            if (srcAnimation->hasCompressedNodeTracks())
+            {
+                expandedAnimation = srcAnimation->clone(srcAnimation->getName());
+                expandedAnimation->decompressNodeTracks();
+                srcAnimation = expandedAnimation;
+            }
+
             // Create target animation
             Animation* dstAnimation = this->createAnimation(srcAnimation->getName(), srcAnimation->getLength());
 
@@ -990,6 +1027,8 @@ namespace Ogre {
                     dstKeyFrame->setScale(deltaTransform.scale);
                 }
             }
+
+            OGRE_DELETE expandedAnimation;
         }
     }
     //---------------------------------------------------------------------
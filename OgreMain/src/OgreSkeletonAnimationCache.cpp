@@ -0,0 +1,244 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSkeletonAnimationCache.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreAnimation.h"
+
+namespace Ogre {
+    const size_t SkeletonAnimationCache::MAX_STATES;
+    const size_t SkeletonAnimationCache::NO_ENTRY;
+    //---------------------------------------------------------------------
+    SkeletonAnimationCache::SkeletonAnimationCache()
+        : mTimeQuantum(0), mLookups(0), mHits(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    SkeletonAnimationCache::~SkeletonAnimationCache()
+    {
+    }
+    //---------------------------------------------------------------------
+    void SkeletonAnimationCache::setTimeQuantum(Real quantum)
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+        // stored poses were keyed with the previous quantum
+        mTimeQuantum = std::max(quantum, Real(0));
+        mEntries.clear();
+        mEntryIndex.clear();
+        mStates.clear();
+        mMatrices.clear();
+    }
+    //---------------------------------------------------------------------
+    size_t SkeletonAnimationCache::buildKey(const AnimationStateSet& animSet, StateKey* key,
+        uint32& hash) const
+    {
+        size_t numStates = 0;
+        ConstEnabledAnimationStateIterator stateIt = animSet.getEnabledAnimationStateIterator();
+        while (stateIt.hasMoreElements())
+        {
+            const AnimationState* animState = stateIt.getNext();
+            if (numStates == MAX_STATES || animState->hasBlendMask())
+                return NO_ENTRY;
+
+            StateKey& stateKey = key[numStates++];
+            stateKey.animationName = &animState->getAnimationName();
+            stateKey.time = animState->getTimePosition();
+            if (mTimeQuantum > 0)
+                stateKey.time = Math::Floor(stateKey.time / mTimeQuantum) * mTimeQuantum;
+            stateKey.weight = animState->getWeight();
+
+            hash = FastHash(stateKey.animationName->c_str(), 
+                static_cast<int>(stateKey.animationName->size()), hash);
+            hash = HashCombine(hash, stateKey.time);
+            hash = HashCombine(hash, stateKey.weight);
+        }
+        return numStates;
+    }
+    //---------------------------------------------------------------------
+    size_t SkeletonAnimationCache::findEntry(const SkeletonInstance* skeleton, const StateKey* key,
+        size_t numStates, uint32 hash) const
+    {
+        EntryIndex::const_iterator i = mEntryIndex.find(hash);
+        if (i == mEntryIndex.end())
+            return NO_ENTRY;
+
+        for (size_t e = i->second; e != NO_ENTRY; e = mEntries[e].next)
+        {
+            const Entry& entry = mEntries[e];
+            if (entry.skeleton != skeleton->getHandle() || entry.blendMode != skeleton->getBlendMode() ||
+                entry.numStates != numStates || entry.numBones != skeleton->getNumBones())
+                continue;
+
+            size_t s = 0;
+            for (; s < numStates; ++s)
+            {
+                const StoredState& stored = mStates[entry.firstState + s];
+                if (stored.time != key[s].time || stored.weight != key[s].weight ||
+                    stored.animationName != *key[s].animationName)
+                    break;
+            }
+            if (s == numStates)
+                return e;
+        }
+        return NO_ENTRY;
+    }
+    //---------------------------------------------------------------------
+    void SkeletonAnimationCache::evaluate(SkeletonInstance* skeleton,
+        const AnimationStateSet& animSet, const StateKey* key, Matrix4* pMatrices) const
+    {
+        if (mTimeQuantum <= 0)
+        {
+            skeleton->setAnimationState(animSet);
+            skeleton->_getBoneMatrices(pMatrices);
+            return;
+        }
+
+        // As Skeleton::setAnimationState, at the rounded time positions;
+        // the key has no blend masks and follows the enabled states in order
+        skeleton->reset();
+
+        Real weightFactor = 1.0f;
+        if (skeleton->getBlendMode() == ANIMBLEND_AVERAGE)
+        {
+            Real totalWeights = 0.0f;
+            ConstEnabledAnimationStateIterator stateIt = animSet.getEnabledAnimationStateIterator();
+            while (stateIt.hasMoreElements())
+            {
+                const AnimationState* animState = stateIt.getNext();
+                const LinkedSkeletonAnimationSource* linked = 0;
+                if (skeleton->_getAnimationImpl(animState->getAnimationName(), &linked))
+                    totalWeights += animState->getWeight();
+            }
+            if (totalWeights > 1.0f)
+                weightFactor = 1.0f / totalWeights;
+        }
+
+        ConstEnabledAnimationStateIterator stateIt = animSet.getEnabledAnimationStateIterator();
+        for (size_t s = 0; stateIt.hasMoreElements(); ++s)
+        {
+            const AnimationState* animState = stateIt.getNext();
+            const LinkedSkeletonAnimationSource* linked = 0;
+            Animation* anim = skeleton->_getAnimationImpl(animState->getAnimationName(), &linked);
+            if (anim)
+            {
+                anim->apply(skeleton, key[s].time, key[s].weight * weightFactor,
+                    linked ? linked->scale : 1.0f, &animState->_getKeyCursor());
+            }
+        }
+        skeleton->_getBoneMatrices(pMatrices);
+    }
+    //---------------------------------------------------------------------
+    bool SkeletonAnimationCache::getBoneMatrices(SkeletonInstance* skeleton,
+        const AnimationStateSet& animSet, Matrix4* pMatrices)
+    {
+        // Manually controlled bones make every instance unique
+        StateKey key[MAX_STATES];
+        uint32 hash = 0;
+        size_t numStates = skeleton->hasManualBones() ? NO_ENTRY : buildKey(animSet, key, hash);
+        if (numStates == NO_ENTRY)
+        {
+            skeleton->setAnimationState(animSet);
+            skeleton->_getBoneMatrices(pMatrices);
+            return false;
+        }
+        ResourceHandle handle = skeleton->getHandle();
+        hash = HashCombine(hash, handle);
+        hash = HashCombine(hash, skeleton->getBlendMode());
+
+        size_t numBones = skeleton->getNumBones();
+        {
+            OGRE_LOCK_MUTEX(mMutex);
+            ++mLookups;
+            size_t e = findEntry(skeleton, key, numStates, hash);
+            if (e != NO_ENTRY)
+            {
+                ++mHits;
+                memcpy(pMatrices, &mMatrices[mEntries[e].firstMatrix], sizeof(Matrix4) * numBones);
+                return true;
+            }
+        }
+
+        // Evaluate without holding the lock, the same pose may be stored
+        // by another thread meanwhile
+        evaluate(skeleton, animSet, key, pMatrices);
+
+        {
+            OGRE_LOCK_MUTEX(mMutex);
+            if (findEntry(skeleton, key, numStates, hash) == NO_ENTRY)
+            {
+                Entry entry;
+                entry.skeleton = handle;
+                entry.blendMode = skeleton->getBlendMode();
+                entry.firstState = mStates.size();
+                entry.numStates = numStates;
+                entry.firstMatrix = mMatrices.size();
+                entry.numBones = numBones;
+
+                for (size_t s = 0; s < numStates; ++s)
+                {
+                    StoredState stored;
+                    stored.animationName = *key[s].animationName;
+                    stored.time = key[s].time;
+                    stored.weight = key[s].weight;
+                    mStates.push_back(stored);
+                }
+                mMatrices.insert(mMatrices.end(), pMatrices, pMatrices + numBones);
+
+                // chain in front of the entries with the same hash
+                std::pair<EntryIndex::iterator, bool> inserted =
+                    mEntryIndex.insert(EntryIndex::value_type(hash, mEntries.size()));
+                entry.next = inserted.second ? NO_ENTRY : inserted.first->second;
+                inserted.first->second = mEntries.size();
+                mEntries.push_back(entry);
+            }
+        }
+        return false;
+    }
+    //---------------------------------------------------------------------
+    void SkeletonAnimationCache::clear(void)
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+        // keep the capacity, the next frame is likely to need as much
+        mEntries.clear();
+        mEntryIndex.clear();
+        mStates.clear();
+        mMatrices.clear();
+        mLookups = 0;
+        mHits = 0;
+    }
+    //---------------------------------------------------------------------
+    SkeletonAnimationCache::Stats SkeletonAnimationCache::getStats(void) const
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+        Stats stats;
+        stats.lookups = mLookups;
+        stats.hits = mHits;
+        stats.entries = mEntries.size();
+        return stats;
+    }
+}
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreSkeleton.h"
 #include "OgreAnimation.h"
 #include "OgreAnimationTrack.h"
+#include "OgreCompressedNodeTracks.h"
 #include "OgreKeyFrame.h"
 #include "OgreBone.h"
 #include "OgreLogManager.h"
@@ -68,6 +69,11 @@ namespace Ogre {
     void SkeletonSerializer::exportSkeleton(const Skeleton* pSkeleton, 
         DataStreamPtr stream, SkeletonVersion ver, Endian endianMode)
     {
+        // Only compressed tracks need v1.100, keep everything else readable by
+        // older versions of OGRE
+        if ((int)ver >= (int)SKELETON_VERSION_1_100 && !hasCompressedNodeTracks(pSkeleton))
+            ver = SKELETON_VERSION_1_8;
+
         setWorkingVersion(ver);
         // Decide on endian mode
         determineEndianness(endianMode);
@@ -165,7 +171,20 @@ namespace Ogre {
     {
         if (ver == SKELETON_VERSION_1_0)
             mVersion = "[Serializer_v1.10]";
-        else mVersion = "[Serializer_v1.80]";
+        else if (ver == SKELETON_VERSION_1_8)
+            mVersion = "[Serializer_v1.80]";
+        else mVersion = "[Serializer_v1.100]";
+    }
+    //---------------------------------------------------------------------
+    bool SkeletonSerializer::hasCompressedNodeTracks(const Skeleton* pSkel)
+    {
+        unsigned short numAnims = pSkel->getNumAnimations();
+        for (unsigned short i = 0; i < numAnims; ++i)
+        {
+            if (pSkel->getAnimation(i)->hasCompressedNodeTracks())
+                return true;
+        }
+        return false;
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeleton(const Skeleton* pSkel, SkeletonVersion ver)
@@ -239,6 +258,16 @@ namespace Ogre {
     void SkeletonSerializer::writeAnimation(const Skeleton* pSkel, 
         const Animation* anim, SkeletonVersion ver)
     {
+        if (anim->hasCompressedNodeTracks() && (int)ver < (int)SKELETON_VERSION_1_100)
+        {
+            // Older formats know nothing of compressed tracks, write them out in full
+            Animation* expanded = anim->clone(anim->getName());
+            expanded->decompressNodeTracks(pSkel);
+            writeAnimation(pSkel, expanded, ver);
+            OGRE_DELETE expanded;
+            return;
+        }
+
         writeChunkHeader(SKELETON_ANIMATION, calcAnimationSize(pSkel, anim, ver));
 
         // char* name                       : Name of the animation
@@ -269,6 +298,11 @@ namespace Ogre {
             }
         }
 
+        if (anim->hasCompressedNodeTracks())
+        {
+            writeCompressedNodeTracks(anim->getCompressedNodeTracks());
+        }
+
         // Write all tracks
         Animation::NodeTrackIterator trackIt = anim->getNodeTrackIterator();
         while(trackIt.hasMoreElements())
@@ -280,6 +314,53 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::writeCompressedNodeTracks(const CompressedNodeTracks* tracks)
+    {
+        writeChunkHeader(SKELETON_ANIMATION_COMPRESSED_TRACKS, calcCompressedNodeTracksSize(tracks));
+
+        uint32 counts[4];
+        // uint32 numTracks
+        counts[0] = static_cast<uint32>(tracks->mTracks.size());
+        // uint32 numKeys
+        counts[1] = static_cast<uint32>(tracks->mKeyTimes.size());
+        // uint32 numTranslations
+        counts[2] = static_cast<uint32>(tracks->mTranslations.size() / 3);
+        // uint32 numScales
+        counts[3] = static_cast<uint32>(tracks->mScales.size() / 3);
+        writeInts(counts, 4);
+
+        CompressedNodeTracks::TrackInfoList::const_iterator i, iend = tracks->mTracks.end();
+        for (i = tracks->mTracks.begin(); i != iend; ++i)
+        {
+            // unsigned short boneIndex     : Index of bone to apply to
+            writeShorts(&i->handle, 1);
+            // uint32 firstKey, numKeys, firstTranslation, firstScale
+            writeInts(&i->firstKey, 1);
+            writeInts(&i->numKeys, 1);
+            writeInts(&i->firstTranslation, 1);
+            writeInts(&i->firstScale, 1);
+            // Vector3 translationMin, translationExtent, scaleMin, scaleExtent
+            writeObject(i->translationMin);
+            writeObject(i->translationExtent);
+            writeObject(i->scaleMin);
+            writeObject(i->scaleExtent);
+        }
+
+        if (!tracks->mKeyTimes.empty())
+        {
+            // float keyTimes[numKeys]
+            writeFloats(&tracks->mKeyTimes[0], tracks->mKeyTimes.size());
+            // uint16 rotations[numKeys * 3]
+            writeShorts(&tracks->mRotations[0], tracks->mRotations.size());
+        }
+        // uint16 translations[numTranslations * 3]
+        if (!tracks->mTranslations.empty())
+            writeShorts(&tracks->mTranslations[0], tracks->mTranslations.size());
+        // uint16 scales[numScales * 3]
+        if (!tracks->mScales.empty())
+            writeShorts(&tracks->mScales[0], tracks->mScales.size());
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::writeAnimationTrack(const Skeleton* pSkel, 
         const NodeAnimationTrack* track)
     {
@@ -387,6 +468,11 @@ namespace Ogre {
             }
         }
 
+        if (pAnim->hasCompressedNodeTracks())
+        {
+            size += calcCompressedNodeTracksSize(pAnim->getCompressedNodeTracks());
+        }
+
         // Nested animation tracks
         Animation::NodeTrackIterator trackIt = pAnim->getNodeTrackIterator();
         while(trackIt.hasMoreElements())
@@ -414,6 +500,24 @@ namespace Ogre {
         return size;
     }
     //---------------------------------------------------------------------
+    size_t SkeletonSerializer::calcCompressedNodeTracksSize(const CompressedNodeTracks* pTracks)
+    {
+        size_t size = SSTREAM_OVERHEAD_SIZE;
+
+        // uint32 numTracks, numKeys, numTranslations, numScales
+        size += sizeof(uint32) * 4;
+        // Per track: boneIndex, 4 x uint32, 4 x Vector3
+        size += pTracks->mTracks.size() *
+            (sizeof(unsigned short) + sizeof(uint32) * 4 + sizeof(float) * 3 * 4);
+        // float keyTimes[numKeys]
+        size += pTracks->mKeyTimes.size() * sizeof(float);
+        // uint16 rotations, translations & scales
+        size += (pTracks->mRotations.size() + pTracks->mTranslations.size() +
+            pTracks->mScales.size()) * sizeof(uint16);
+
+        return size;
+    }
+    //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcKeyFrameSize(const Skeleton* pSkel, 
         const TransformKeyFrame* pKey)
     {
@@ -455,7 +559,8 @@ namespace Ogre {
             // Read version
             String ver = readString(stream);
             if ((ver != "[Serializer_v1.10]") &&
-                (ver != "[Serializer_v1.80]"))
+                (ver != "[Serializer_v1.80]") &&
+                (ver != "[Serializer_v1.100]"))
             {
                 OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
                     "Invalid file: version incompatible, file reports " + String(ver),
@@ -558,6 +663,18 @@ namespace Ogre {
                     streamID = readChunk(stream);
                 }
             }
+
+            // Optional compressed tracks
+            if (streamID == SKELETON_ANIMATION_COMPRESSED_TRACKS)
+            {
+                readCompressedNodeTracks(stream, pAnim);
+
+                if (!stream->eof())
+                {
+                    // Get next stream
+                    streamID = readChunk(stream);
+                }
+            }
             
             while(streamID == SKELETON_ANIMATION_TRACK && !stream->eof())
             {
@@ -578,6 +695,60 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::readCompressedNodeTracks(DataStreamPtr& stream, Animation* anim)
+    {
+        CompressedNodeTracks* tracks = OGRE_NEW CompressedNodeTracks(anim);
+        // Hand over straight away so that nothing leaks if the data is bad
+        anim->_setCompressedNodeTracks(tracks);
+
+        // uint32 numTracks, numKeys, numTranslations, numScales
+        uint32 counts[4];
+        readInts(stream, counts, 4);
+
+        tracks->mTracks.resize(counts[0]);
+        CompressedNodeTracks::TrackInfoList::iterator i, iend = tracks->mTracks.end();
+        for (i = tracks->mTracks.begin(); i != iend; ++i)
+        {
+            readShorts(stream, &i->handle, 1);
+            readInts(stream, &i->firstKey, 1);
+            readInts(stream, &i->numKeys, 1);
+            readInts(stream, &i->firstTranslation, 1);
+            readInts(stream, &i->firstScale, 1);
+            readObject(stream, i->translationMin);
+            readObject(stream, i->translationExtent);
+            readObject(stream, i->scaleMin);
+            readObject(stream, i->scaleExtent);
+
+            // Make sure the track stays within the packed data
+            bool valid = i->numKeys > 0 && i->firstKey + i->numKeys <= counts[1] &&
+                (i->firstTranslation == CompressedNodeTracks::CONSTANT_CHANNEL ||
+                 i->firstTranslation + i->numKeys <= counts[2]) &&
+                (i->firstScale == CompressedNodeTracks::CONSTANT_CHANNEL ||
+                 i->firstScale + i->numKeys <= counts[3]);
+            if (!valid)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "Invalid compressed track for bone " + StringConverter::toString(i->handle) +
+                    " in animation " + anim->getName(),
+                    "SkeletonSerializer::readCompressedNodeTracks");
+            }
+        }
+
+        tracks->mKeyTimes.resize(counts[1]);
+        tracks->mRotations.resize(counts[1] * 3);
+        tracks->mTranslations.resize(counts[2] * 3);
+        tracks->mScales.resize(counts[3] * 3);
+        if (counts[1])
+        {
+            readFloats(stream, &tracks->mKeyTimes[0], tracks->mKeyTimes.size());
+            readShorts(stream, &tracks->mRotations[0], tracks->mRotations.size());
+        }
+        if (counts[2])
+            readShorts(stream, &tracks->mTranslations[0], tracks->mTranslations.size());
+        if (counts[3])
+            readShorts(stream, &tracks->mScales[0], tracks->mScales.size());
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::readAnimationTrack(DataStreamPtr& stream, Animation* anim, 
         Skeleton* pSkel)
     {
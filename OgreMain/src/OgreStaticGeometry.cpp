@@ -915,19 +915,9 @@ namespace Ogre {
         HardwareIndexBufferSharedPtr* indexBuffer, size_t* indexBufferUsedSize,
         bool extrude, Real extrusionDistance, unsigned long flags)
     {
-        // Calculate the object space light details
-        Vector4 lightPos = light->getAs4DVector();
-        Matrix4 world2Obj = mParentNode->_getFullTransform().inverseAffine();
-        lightPos = world2Obj.transformAffine(lightPos);
-        Matrix3 world2Obj3x3;
-        world2Obj.extract3x3Matrix(world2Obj3x3);
-        extrusionDistance *= Math::Sqrt(std::min(std::min(world2Obj3x3.GetColumn(0).squaredLength(), world2Obj3x3.GetColumn(1).squaredLength()), world2Obj3x3.GetColumn(2).squaredLength()));
-
-        // per-LOD shadow lists & edge data
-        mLodBucketList[mCurrentLod]->updateShadowRenderables(
-            shadowTechnique, lightPos, indexBuffer, extrude, extrusionDistance, flags);
-        
-        EdgeData* edgeList = mLodBucketList[mCurrentLod]->getEdgeList();
+        Vector4 lightPos;
+        EdgeData* edgeList = prepareShadowRenderables(shadowTechnique, light, indexBuffer,
+            extrude, extrusionDistance, flags, lightPos);
         ShadowRenderableList& shadowRendList = mLodBucketList[mCurrentLod]->getShadowRenderableList();
 
         // Calc triangle light facing
@@ -942,6 +932,38 @@ namespace Ogre {
 
     }
     //--------------------------------------------------------------------------
+    bool StaticGeometry::Region::_prepareShadowVolume(
+        ShadowTechnique shadowTechnique, const Light* light,
+        HardwareIndexBufferSharedPtr* indexBuffer,
+        bool extrude, Real extrusionDistance, unsigned long flags,
+        ShadowVolumeBuild& build)
+    {
+        EdgeData* edgeList = prepareShadowRenderables(shadowTechnique, light, indexBuffer,
+            extrude, extrusionDistance, flags, build.lightPos);
+        initShadowVolumeBuild(build, edgeList, light,
+            mLodBucketList[mCurrentLod]->getShadowRenderableList(), flags);
+        return true;
+    }
+    //--------------------------------------------------------------------------
+    EdgeData* StaticGeometry::Region::prepareShadowRenderables(ShadowTechnique shadowTechnique,
+        const Light* light, HardwareIndexBufferSharedPtr* indexBuffer,
+        bool extrude, Real extrusionDistance, unsigned long flags, Vector4& lightPos)
+    {
+        // Calculate the object space light details
+        lightPos = light->getAs4DVector();
+        Matrix4 world2Obj = mParentNode->_getFullTransform().inverseAffine();
+        lightPos = world2Obj.transformAffine(lightPos);
+        Matrix3 world2Obj3x3;
+        world2Obj.extract3x3Matrix(world2Obj3x3);
+        extrusionDistance *= Math::Sqrt(std::min(std::min(world2Obj3x3.GetColumn(0).squaredLength(), world2Obj3x3.GetColumn(1).squaredLength()), world2Obj3x3.GetColumn(2).squaredLength()));
+
+        // per-LOD shadow lists & edge data
+        mLodBucketList[mCurrentLod]->updateShadowRenderables(
+            shadowTechnique, lightPos, indexBuffer, extrude, extrusionDistance, flags);
+
+        return mLodBucketList[mCurrentLod]->getEdgeList();
+    }
+    //--------------------------------------------------------------------------
     EdgeData* StaticGeometry::Region::getEdgeList(void)
     {
         return mLodBucketList[mCurrentLod]->getEdgeList();
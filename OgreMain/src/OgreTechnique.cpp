@@ -83,7 +83,7 @@ namespace Ogre {
 
         // Compile for categorised illumination on demand
         clearIlluminationPasses();
-        mIlluminationPassesCompilationPhase = IPS_NOT_COMPILED;
+        mIlluminationPassesCompilationPhase.set(IPS_NOT_COMPILED);
 
         return errors.str();
 
@@ -445,7 +445,7 @@ namespace Ogre {
         }
         // Compile for categorised illumination on demand
         clearIlluminationPasses();
-        mIlluminationPassesCompilationPhase = IPS_NOT_COMPILED;
+        mIlluminationPassesCompilationPhase.set(IPS_NOT_COMPILED);
         return *this;
     }
     //-----------------------------------------------------------------------------
@@ -874,7 +874,7 @@ namespace Ogre {
     void Technique::_notifyNeedsRecompile(void)
     {
         // Disable require to recompile when splitting illumination passes
-        if (mIlluminationPassesCompilationPhase != IPS_COMPILE_DISABLED)
+        if (mIlluminationPassesCompilationPhase.get() != IPS_COMPILE_DISABLED)
         {
             mParent->_notifyNeedsRecompile();
         }
@@ -1179,18 +1179,23 @@ namespace Ogre {
     Technique::getIlluminationPassIterator(void)
     {
         IlluminationPassesState targetState = IPS_COMPILED;
-        if(mIlluminationPassesCompilationPhase != targetState
-        && mIlluminationPassesCompilationPhase != IPS_COMPILE_DISABLED)
-        {
-            // prevents parent->_notifyNeedsRecompile() call during compile
-            mIlluminationPassesCompilationPhase = IPS_COMPILE_DISABLED;
-            // Splitting the passes into illumination passes
-            _compileIlluminationPasses();
-            // Post notification, so that technique owner can post-process created passes
-            if(MaterialManager::getSingletonPtr())
-                MaterialManager::getSingleton()._notifyAfterIlluminationPassesCreated(this);
-            // Mark that illumination passes compilation finished
-            mIlluminationPassesCompilationPhase = targetState;
+        // Passes may be requested concurrently when culling on several threads;
+        // once compiled they are only read, so only compiling takes the lock
+        if(mIlluminationPassesCompilationPhase.get() != targetState)
+        {
+            OGRE_LOCK_MUTEX(mIlluminationPassesMutex);
+            if(mIlluminationPassesCompilationPhase.get() == IPS_NOT_COMPILED)
+            {
+                // prevents parent->_notifyNeedsRecompile() call during compile
+                mIlluminationPassesCompilationPhase.set(IPS_COMPILE_DISABLED);
+                // Splitting the passes into illumination passes
+                _compileIlluminationPasses();
+                // Post notification, so that technique owner can post-process created passes
+                if(MaterialManager::getSingletonPtr())
+                    MaterialManager::getSingleton()._notifyAfterIlluminationPassesCreated(this);
+                // Mark that illumination passes compilation finished, after the passes
+                mIlluminationPassesCompilationPhase.cas(IPS_COMPILE_DISABLED, targetState);
+            }
         }
 
         return IlluminationPassIterator(mIlluminationPasses.begin(),
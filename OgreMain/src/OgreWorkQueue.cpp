@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreRoot.h"
 #include "OgreTimer.h"
+#include "OgreProfiler.h"
 
 namespace Ogre {
     //---------------------------------------------------------------------
@@ -618,6 +619,8 @@ namespace Ogre {
     //---------------------------------------------------------------------
     WorkQueue::Response* DefaultWorkQueueBase::processRequest(Request* r)
     {
+        OgreProfileGroupLiteral("WorkQueue::processRequest", OGREPROF_GENERAL);
+
         RequestHandlerListByChannel handlerListCopy;
         {
             // lock the list only to make a copy of it, to maximise parallelism
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreRoot.h"
 #include "OgreRenderSystem.h"
+#include "OgreProfiler.h"
 
 namespace Ogre
 {
@@ -172,6 +173,13 @@ namespace Ogre
             "DefaultWorkQueue('" << getName() << "')::WorkerFunc - thread " 
             << OGRE_THREAD_CURRENT_ID << " starting.";
 
+#if OGRE_PROFILING
+        // identify the worker in exported profile traces
+        Profiler* prof = Profiler::getSingletonPtr();
+        if (prof)
+            prof->setTraceThreadName(getName() + " worker");
+#endif
+
         // Initialise the thread for RS if necessary
         if (mWorkerRenderSystemAccess)
         {
@@ -99,6 +99,8 @@ namespace DirectX
 
 namespace Ogre {
 
+    extern OptimisedUtil* _getOptimisedUtilGeneral(void);
+
 //-------------------------------------------------------------------------
 // Local classes
 //-------------------------------------------------------------------------
@@ -159,6 +161,21 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::concatenateNodeTransforms
+        virtual void concatenateNodeTransforms(
+            const float* parentTransforms,
+            const float* localTransforms,
+            float* derivedTransforms,
+            size_t numBlocks);
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        virtual void cullBoxes(
+            const float* planes,
+            size_t numPlanes,
+            const float* boxes,
+            size_t numBlocks,
+            uint8* visibleMasks);
     };
 
 //---------------------------------------------------------------------
@@ -2032,6 +2049,29 @@ static OGRE_FORCE_INLINE bool _isAlignedForDirectXMath(const void *p)
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilDirectXMath::concatenateNodeTransforms(
+        const float* parentTransforms,
+        const float* localTransforms,
+        float* derivedTransforms,
+        size_t numBlocks)
+    {
+        // No DirectXMath specific version yet
+        _getOptimisedUtilGeneral()->concatenateNodeTransforms(
+            parentTransforms, localTransforms, derivedTransforms, numBlocks);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilDirectXMath::cullBoxes(
+        const float* planes,
+        size_t numPlanes,
+        const float* boxes,
+        size_t numBlocks,
+        uint8* visibleMasks)
+    {
+        // No DirectXMath specific version yet
+        _getOptimisedUtilGeneral()->cullBoxes(
+            planes, numPlanes, boxes, numBlocks, visibleMasks);
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilDirectXMath(void)
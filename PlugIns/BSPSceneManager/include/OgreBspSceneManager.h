@@ -122,6 +122,10 @@ namespace Ogre {
         /// @copydoc SceneManager::getTypeName
         const String& getTypeName(void) const;
 
+        /** Overridden from SceneManager, BspSceneNode updates move objects
+            between BSP leaves which cannot be done from several threads. */
+        bool supportsParallelSceneGraphUpdate(void) const { return false; }
+
         /** Specialised from SceneManager to support Quake3 bsp files. */
         void setWorldGeometry(const String& filename);
 
@@ -0,0 +1,138 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __Bvh_H__
+#define __Bvh_H__
+
+#include "OgreBvhPrerequisites.h"
+#include "OgreAxisAlignedBox.h"
+
+namespace Ogre
+{
+    /** Dynamic bounding volume hierarchy over the scene nodes of a BvhSceneManager.
+    @remarks
+        The tree is binary and each leaf holds exactly one node, with the world
+        bounds of the objects attached to it. Tree nodes live in a flat array
+        and are addressed by index, unused entries being kept in a free list.
+    @par
+        Nodes which move are refitted in place, new nodes are inserted where
+        they increase the total surface area of the tree the least and a
+        removed node collapses its parent. Refitting degrades the tree over
+        time; rebuild recreates it with a binned surface area heuristic.
+    */
+    class _OgreBvhPluginExport Bvh : public NodeAlloc
+    {
+    public:
+        typedef uint32 NodeIndex;
+        /// Index of no node
+        static const NodeIndex NULL_NODE = 0xFFFFFFFF;
+
+        /// Node of the tree
+        struct Node
+        {
+            /// Bounds of the node
+            Vector3 min;
+            Vector3 max;
+            /// Parent node, NULL_NODE for the root
+            NodeIndex parent;
+            /// Child nodes, NULL_NODE for a leaf
+            NodeIndex children[2];
+            /// Scene node of a leaf, 0 for an internal or free node
+            BvhNode* item;
+
+            bool isLeaf(void) const { return children[0] == NULL_NODE; }
+        };
+        typedef vector<Node>::type NodeList;
+
+        Bvh();
+        ~Bvh();
+
+        /** Adds a leaf for the given node.
+        @remarks
+            The leaf index is passed to BvhNode::_setBvhLeaf.
+        */
+        void insert(BvhNode* item, const AxisAlignedBox& box);
+        /** Removes the leaf of the given node. */
+        void remove(BvhNode* item);
+        /** Sets the bounds of the leaf of the given node, enlarging or
+            shrinking its ancestors as far as needed.
+        */
+        void refit(BvhNode* item, const AxisAlignedBox& box);
+        /** Recreates the tree from its leaves with a binned surface area heuristic. */
+        void rebuild(void);
+        /** Removes all the leaves. */
+        void clear(void);
+
+        /** Gets the surface area heuristic cost of the tree.
+        @remarks
+            This is the sum of the surface areas of all the nodes relative to the
+            surface area of the root: the expected number of nodes visited by a
+            random ray hitting the scene.
+        */
+        Real calculateCost(void) const;
+        /** Gets the cost of the tree when it was last rebuilt. */
+        Real getBuildCost(void) const { return mBuildCost; }
+
+        /** Gets the root node, NULL_NODE if the tree is empty. */
+        NodeIndex getRoot(void) const { return mRoot; }
+        /** Gets a node of the tree. */
+        const Node& getNode(NodeIndex index) const { return mNodes[index]; }
+        /** Gets the number of leaves. */
+        size_t getLeafCount(void) const { return mLeafCount; }
+        /** Gets the number of levels of the tree. */
+        size_t getDepth(void) const;
+
+    protected:
+        /// Leaf bounds used by rebuild
+        struct BuildItem
+        {
+            BvhNode* item;
+            Vector3 min;
+            Vector3 max;
+            Vector3 centre;
+        };
+        typedef vector<BuildItem>::type BuildItemList;
+
+        NodeIndex allocateNode(void);
+        void freeNode(NodeIndex index);
+        /// Recomputes the bounds of index and its ancestors until one is unchanged
+        void refitAncestors(NodeIndex index);
+        /// Creates the subtree of the given items, returning its root
+        NodeIndex build(BuildItem* items, size_t count, NodeIndex parent);
+
+        NodeList mNodes;
+        NodeIndex mRoot;
+        /// First free node, linked through children[1]
+        NodeIndex mFreeList;
+        size_t mLeafCount;
+        Real mBuildCost;
+        /// Scratch storage for rebuild
+        BuildItemList mBuildItems;
+    };
+}
+
+#endif
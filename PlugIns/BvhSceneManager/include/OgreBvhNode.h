@@ -0,0 +1,103 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BvhNode_H__
+#define __BvhNode_H__
+
+#include "OgreBvhPrerequisites.h"
+#include "OgreSceneNode.h"
+#include "OgreBvh.h"
+
+namespace Ogre
+{
+    /** Specialised SceneNode kept in the Bvh of a BvhSceneManager.
+    @remarks
+        Like OctreeNode, each node is bounded by its own attached objects only,
+        not by its children, so that the tree does not have to contain the
+        nested boxes of the scene graph. Nodes whose bounds change are queued
+        on the scene manager, which moves them in the tree after the scene
+        graph update.
+    */
+    class _OgreBvhPluginExport BvhNode : public SceneNode
+    {
+    public:
+        /// Value of an unset position in a list of the scene manager
+        static const size_t NO_POSITION = ~static_cast<size_t>(0);
+
+        /** Standard constructor */
+        BvhNode(SceneManager* creator);
+        /** Standard constructor */
+        BvhNode(SceneManager* creator, const String& name);
+        /** Standard destructor */
+        ~BvhNode();
+
+        /** Adds the attached objects of this node to the render queue. */
+        void _addToRenderQueue(Camera* cam, RenderQueue* queue, bool onlyShadowCasters,
+            VisibleObjectsBoundsInfo* visibleBounds);
+
+        /** Gets the leaf of this node in the Bvh, Bvh::NULL_NODE if it is not in the tree. */
+        Bvh::NodeIndex _getBvhLeaf(void) const { return mBvhLeaf; }
+        /** Sets the leaf of this node in the Bvh. */
+        void _setBvhLeaf(Bvh::NodeIndex leaf) { mBvhLeaf = leaf; }
+        /** Gets the position of this node in the list of nodes to update, or NO_POSITION. */
+        size_t _getPendingPosition(void) const { return mPendingPosition; }
+        /** Sets the position of this node in the list of nodes to update. */
+        void _setPendingPosition(size_t pos) { mPendingPosition = pos; }
+        /** Gets the position of this node in the list of infinite nodes, or NO_POSITION. */
+        size_t _getInfinitePosition(void) const { return mInfinitePosition; }
+        /** Sets the position of this node in the list of infinite nodes. */
+        void _setInfinitePosition(size_t pos) { mInfinitePosition = pos; }
+
+        /** Returns whether this node is referenced by the scene manager. */
+        bool _isTracked(void) const
+        {
+            return mBvhLeaf != Bvh::NULL_NODE || mPendingPosition != NO_POSITION ||
+                mInfinitePosition != NO_POSITION;
+        }
+        /** Forgets all references of the scene manager to this node. */
+        void _untrack(void);
+
+    protected:
+        /** Internal method for updating the bounds of this node.
+        @remarks
+            The bounds are determined solely from the attached objects, not
+            any children. If they changed the node is queued on the scene manager.
+        */
+        void _updateBounds(void);
+
+        /** Overridden from SceneNode to remove the node from the tree when
+            it leaves the scene graph.
+        */
+        void setInSceneGraph(bool inGraph);
+
+        Bvh::NodeIndex mBvhLeaf;
+        size_t mPendingPosition;
+        size_t mInfinitePosition;
+    };
+}
+
+#endif
@@ -0,0 +1,230 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BvhSceneManager_H__
+#define __BvhSceneManager_H__
+
+#include "OgreBvhPrerequisites.h"
+#include "OgreSceneManager.h"
+#include "OgreBvh.h"
+
+namespace Ogre
+{
+    /** Specialised SceneManager organising the scene nodes in a dynamic bounding
+        volume hierarchy.
+    @remarks
+        Unlike OctreeSceneManager the tree has no fixed extents or depth: it
+        adapts to the distribution of the objects, which suits large scenes of
+        objects of very different sizes, many of them moving. Nodes whose bounds
+        changed are refitted, inserted or removed after the scene graph update,
+        and the tree is rebuilt when refitting has degraded it too much.
+    @par
+        Options are:
+        "RebuildThreshold", Real *: ratio of the cost of the tree to its cost
+        after the last rebuild above which it is rebuilt, 1.3 by default;
+        "RebuildCheckInterval", size_t *: number of updates of the scene graph
+        between checks of the cost of the tree, 30 by default, 0 to never
+        rebuild automatically;
+        "ShowBvh", bool *: whether the boxes of the visited tree nodes are shown.
+    */
+    class _OgreBvhPluginExport BvhSceneManager : public SceneManager
+    {
+    public:
+        /// Counters of the changes made to the tree
+        struct Statistics
+        {
+            /// Number of nodes in the tree
+            size_t leafCount;
+            /// Number of nodes with infinite bounds, kept outside the tree
+            size_t infiniteCount;
+            /// Number of levels of the tree
+            size_t depth;
+            /// Current cost of the tree, see Bvh::calculateCost
+            Real cost;
+            /// Cost of the tree after the last rebuild
+            Real buildCost;
+            /// Total number of nodes refitted, inserted and removed
+            size_t refitCount;
+            size_t insertCount;
+            size_t removeCount;
+            /// Total number of rebuilds of the tree
+            size_t rebuildCount;
+        };
+
+        typedef vector<SceneNode*>::type SceneNodeVector;
+        typedef vector<std::pair<SceneNode*, SceneNode*> >::type SceneNodePairList;
+
+        BvhSceneManager(const String& name);
+        ~BvhSceneManager();
+
+        /// @copydoc SceneManager::getTypeName
+        const String& getTypeName(void) const;
+
+        /** Creates a specialised BvhNode */
+        SceneNode* createSceneNodeImpl(void);
+        /** Creates a specialised BvhNode */
+        SceneNode* createSceneNodeImpl(const String& name);
+
+        /** Updates the scene graph, then applies the changes of bounds to the tree. */
+        void _updateSceneGraph(Camera* cam);
+        /** Walks the tree, adding the visible objects to the render queue. */
+        void _findVisibleObjects(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds,
+            bool onlyShadowCasters);
+        /** Queues the objects of a visible node gathered by walkBvh, when
+            searching for visible objects on several threads.
+        */
+        void findVisibleObjectsInItem(const VisibleObjectsItem& item, Camera* cam,
+            RenderQueue* queue, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+
+        /** Queues a node whose bounds changed, to be moved in the tree by _updateBvh.
+        @remarks
+            Called by BvhNode::_updateBounds, possibly from several threads.
+        */
+        void _notifyBvhNodeUpdated(BvhNode* node);
+        /** Removes a node from the tree and from the lists of the scene manager. */
+        void _removeBvhNode(BvhNode* node);
+        /** Applies the changes of bounds queued by _notifyBvhNodeUpdated to the tree.
+        @remarks
+            This is done after each update of the scene graph, and before any
+            query so that nodes moved since are found where they are.
+        */
+        void _updateBvh(void);
+        /** Recreates the tree from scratch. */
+        void rebuildBvh(void);
+        /** Gets the tree of the scene nodes. */
+        const Bvh& getBvh(void) const { return *mBvh; }
+        /** Gets the statistics of the tree. */
+        const Statistics& getBvhStatistics(void);
+
+        /** Adds the nodes intersecting the box to the list, ignoring the exclude node. */
+        void findNodesIn(const AxisAlignedBox& box, SceneNodeVector& list, SceneNode* exclude = 0);
+        /** Adds the nodes intersecting the sphere to the list, ignoring the exclude node. */
+        void findNodesIn(const Sphere& sphere, SceneNodeVector& list, SceneNode* exclude = 0);
+        /** Adds the nodes intersecting the volume to the list, ignoring the exclude node. */
+        void findNodesIn(const PlaneBoundedVolume& volume, SceneNodeVector& list, SceneNode* exclude = 0);
+        /** Adds the nodes intersecting the ray to the list, ignoring the exclude node. */
+        void findNodesIn(const Ray& ray, SceneNodeVector& list, SceneNode* exclude = 0);
+        /** Adds the pairs of nodes whose bounds intersect to the list.
+        @remarks
+            Each pair is reported once, infinite nodes being paired with every node.
+        */
+        void findIntersectingNodes(SceneNodePairList& pairs);
+
+        /** Sets the given option for the SceneManager, see the class description. */
+        bool setOption(const String& key, const void* val);
+        /** Gets the given option for the SceneManager, see setOption. */
+        bool getOption(const String& key, void* val);
+        bool getOptionValues(const String& key, StringVector& refValueList);
+        bool getOptionKeys(StringVector& refKeys);
+
+        /** Overridden from SceneManager */
+        void clearScene(void);
+
+        AxisAlignedBoxSceneQuery* createAABBQuery(const AxisAlignedBox& box, uint32 mask = 0xFFFFFFFF);
+        SphereSceneQuery* createSphereQuery(const Sphere& sphere, uint32 mask = 0xFFFFFFFF);
+        PlaneBoundedVolumeListSceneQuery* createPlaneBoundedVolumeQuery(
+            const PlaneBoundedVolumeList& volumes, uint32 mask = 0xFFFFFFFF);
+        RaySceneQuery* createRayQuery(const Ray& ray, uint32 mask = 0xFFFFFFFF);
+        IntersectionSceneQuery* createIntersectionQuery(uint32 mask = 0xFFFFFFFF);
+
+    protected:
+        typedef vector<BvhNode*>::type BvhNodeList;
+
+        /** Walks the tree, queuing the visible nodes.
+        @remarks
+            With a null queue the visible nodes are only gathered in mVisible.
+        */
+        void walkBvh(Camera* cam, RenderQueue* queue, VisibleObjectsBoundsInfo* visibleBounds,
+            bool onlyShadowCasters);
+        /** Queues a visible node and its debug renderables. */
+        void addVisibleNode(BvhNode* node, Camera* cam, RenderQueue* queue,
+            VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+        /** Adds the box of a tree node to the render queue. */
+        void addTreeBox(const Bvh::Node& node);
+        /** Brings the tree up to date before executing batched queries. */
+        void prepareBatchQueries(void);
+        /** Walks the tree once for a packet of batched queries, each tree
+            node being tested against the queries which reached its parent.
+        */
+        void executeBatchQueryPacket(size_t first, size_t count);
+        /// Node tests of the queries of a packet
+        struct BatchQueryPacket;
+        /** Walks the subtree of a tree node with the queries of the packet
+            whose bits are set in mask.
+        */
+        void walkBatchQueryPacket(Bvh::NodeIndex root, uint32 mask, const BatchQueryPacket& packet);
+        /** Tests the objects of a node against the queries of the packet
+            starting at first whose bits are set in mask.
+        */
+        void testBatchQueryObjects(SceneNode* node, size_t first, uint32 mask);
+        /** Tests an object against the queries of a packet, see testBatchQueryObjects. */
+        void testBatchQueryObject(MovableObject* object, size_t first, uint32 mask);
+        /** Adds a node to the list of infinite nodes. */
+        void addInfiniteNode(BvhNode* node);
+        /** Removes a node from the list of infinite nodes. */
+        void removeInfiniteNode(BvhNode* node);
+
+        /// Tree of the nodes with finite bounds
+        Bvh* mBvh;
+        /// Nodes with infinite bounds, always visible and intersecting everything
+        BvhNodeList mInfiniteNodes;
+        /// Nodes whose bounds changed since the last _updateBvh
+        BvhNodeList mPendingNodes;
+        /// Serialises the queuing of nodes updated from several threads
+        OGRE_MUTEX(mPendingNodesMutex);
+        /// Nodes found visible by the last walkBvh
+        BvhNodeList mVisible;
+        /// Stack of walkBvh and the queries
+        vector<std::pair<Bvh::NodeIndex, uint32> >::type mStack;
+
+        /// Boxes drawn for the visited tree nodes
+        vector<WireBoundingBox*>::type mBoxes;
+        size_t mBoxesUsed;
+        bool mShowBoxes;
+
+        Real mRebuildThreshold;
+        size_t mRebuildCheckInterval;
+        size_t mUpdatesSinceCheck;
+        Statistics mStats;
+    };
+
+    /// Factory for BvhSceneManager
+    class BvhSceneManagerFactory : public SceneManagerFactory
+    {
+    protected:
+        void initMetaData(void) const;
+    public:
+        BvhSceneManagerFactory() {}
+        ~BvhSceneManagerFactory() {}
+        /// Factory type name
+        static const String FACTORY_TYPE_NAME;
+        SceneManager* createInstance(const String& instanceName);
+        void destroyInstance(SceneManager* instance);
+    };
+}
+
+#endif
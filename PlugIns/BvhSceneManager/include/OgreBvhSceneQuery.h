@@ -0,0 +1,96 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BvhSceneQuery_H__
+#define __BvhSceneQuery_H__
+
+#include "OgreBvhPrerequisites.h"
+#include "OgreSceneManager.h"
+
+namespace Ogre
+{
+    /** BVH implementation of IntersectionSceneQuery.
+    @remarks
+        Only the objects of nodes whose bounds intersect are tested, the pairs
+        of nodes being found by descending the tree against itself.
+    */
+    class _OgreBvhPluginExport BvhIntersectionSceneQuery : public DefaultIntersectionSceneQuery
+    {
+    public:
+        BvhIntersectionSceneQuery(SceneManager* creator);
+        ~BvhIntersectionSceneQuery();
+
+        /** See IntersectionSceneQuery. */
+        void execute(IntersectionSceneQueryListener* listener);
+    };
+
+    /** BVH implementation of RaySceneQuery. */
+    class _OgreBvhPluginExport BvhRaySceneQuery : public DefaultRaySceneQuery
+    {
+    public:
+        BvhRaySceneQuery(SceneManager* creator);
+        ~BvhRaySceneQuery();
+
+        /** See RaySceneQuery. */
+        void execute(RaySceneQueryListener* listener);
+    };
+
+    /** BVH implementation of SphereSceneQuery. */
+    class _OgreBvhPluginExport BvhSphereSceneQuery : public DefaultSphereSceneQuery
+    {
+    public:
+        BvhSphereSceneQuery(SceneManager* creator);
+        ~BvhSphereSceneQuery();
+
+        /** See SceneQuery. */
+        void execute(SceneQueryListener* listener);
+    };
+
+    /** BVH implementation of PlaneBoundedVolumeListSceneQuery. */
+    class _OgreBvhPluginExport BvhPlaneBoundedVolumeListSceneQuery : public DefaultPlaneBoundedVolumeListSceneQuery
+    {
+    public:
+        BvhPlaneBoundedVolumeListSceneQuery(SceneManager* creator);
+        ~BvhPlaneBoundedVolumeListSceneQuery();
+
+        /** See SceneQuery. */
+        void execute(SceneQueryListener* listener);
+    };
+
+    /** BVH implementation of AxisAlignedBoxSceneQuery. */
+    class _OgreBvhPluginExport BvhAxisAlignedBoxSceneQuery : public DefaultAxisAlignedBoxSceneQuery
+    {
+    public:
+        BvhAxisAlignedBoxSceneQuery(SceneManager* creator);
+        ~BvhAxisAlignedBoxSceneQuery();
+
+        /** See SceneQuery. */
+        void execute(SceneQueryListener* listener);
+    };
+}
+
+#endif
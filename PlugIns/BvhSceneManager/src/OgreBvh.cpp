@@ -0,0 +1,480 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBvh.h"
+#include "OgreBvhNode.h"
+
+#include <algorithm>
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Half the surface area of a box, enough to compare costs
+        inline Real halfArea(const Vector3& min, const Vector3& max)
+        {
+            Vector3 d = max - min;
+            return d.x * d.y + d.y * d.z + d.z * d.x;
+        }
+        /// Half the surface area of the union of two boxes
+        inline Real mergedHalfArea(const Vector3& min0, const Vector3& max0,
+            const Vector3& min1, const Vector3& max1)
+        {
+            Vector3 mn = min0, mx = max0;
+            mn.makeFloor(min1);
+            mx.makeCeil(max1);
+            return halfArea(mn, mx);
+        }
+
+        /// Number of bins of the split candidates of rebuild
+        const size_t NUM_BINS = 12;
+
+        /// Bin of the centre of a build item along an axis
+        struct BinOf
+        {
+            int axis;
+            Real min;
+            Real scale;
+
+            size_t operator()(const Vector3& centre) const
+            {
+                size_t bin = static_cast<size_t>((centre[axis] - min) * scale);
+                return std::min(bin, NUM_BINS - 1);
+            }
+        };
+        template <class T>
+        struct IsLeftOfBin
+        {
+            BinOf binOf;
+            size_t split;
+
+            bool operator()(const T& item) const { return binOf(item.centre) < split; }
+        };
+        template <class T>
+        struct IsLeftOfCentre
+        {
+            int axis;
+
+            bool operator()(const T& a, const T& b) const { return a.centre[axis] < b.centre[axis]; }
+        };
+    }
+    //-----------------------------------------------------------------------
+    Bvh::Bvh()
+        : mRoot(NULL_NODE)
+        , mFreeList(NULL_NODE)
+        , mLeafCount(0)
+        , mBuildCost(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    Bvh::~Bvh()
+    {
+    }
+    //-----------------------------------------------------------------------
+    Bvh::NodeIndex Bvh::allocateNode(void)
+    {
+        NodeIndex index;
+        if (mFreeList != NULL_NODE)
+        {
+            index = mFreeList;
+            mFreeList = mNodes[index].children[1];
+        }
+        else
+        {
+            index = static_cast<NodeIndex>(mNodes.size());
+            mNodes.push_back(Node());
+        }
+
+        Node& node = mNodes[index];
+        node.parent = NULL_NODE;
+        node.children[0] = NULL_NODE;
+        node.children[1] = NULL_NODE;
+        node.item = 0;
+        return index;
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::freeNode(NodeIndex index)
+    {
+        Node& node = mNodes[index];
+        node.parent = NULL_NODE;
+        node.children[0] = NULL_NODE;
+        node.children[1] = mFreeList;
+        node.item = 0;
+        mFreeList = index;
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::refitAncestors(NodeIndex index)
+    {
+        while (index != NULL_NODE)
+        {
+            Node& node = mNodes[index];
+            const Node& child0 = mNodes[node.children[0]];
+            const Node& child1 = mNodes[node.children[1]];
+
+            Vector3 min = child0.min, max = child0.max;
+            min.makeFloor(child1.min);
+            max.makeCeil(child1.max);
+
+            // bounds are tight, so the ancestors of an unchanged node are unchanged
+            if (min == node.min && max == node.max)
+                break;
+
+            node.min = min;
+            node.max = max;
+            index = node.parent;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::insert(BvhNode* item, const AxisAlignedBox& box)
+    {
+        NodeIndex leaf = allocateNode();
+        {
+            Node& node = mNodes[leaf];
+            node.min = box.getMinimum();
+            node.max = box.getMaximum();
+            node.item = item;
+        }
+        item->_setBvhLeaf(leaf);
+        ++mLeafCount;
+
+        if (mRoot == NULL_NODE)
+        {
+            mRoot = leaf;
+            return;
+        }
+
+        // descend to the sibling for which the tree grows the least
+        const Vector3 leafMin = mNodes[leaf].min, leafMax = mNodes[leaf].max;
+        NodeIndex index = mRoot;
+        while (!mNodes[index].isLeaf())
+        {
+            const Node& node = mNodes[index];
+            Real area = halfArea(node.min, node.max);
+            Real combinedArea = mergedHalfArea(node.min, node.max, leafMin, leafMax);
+
+            // cost of making a new parent for this node and the leaf
+            Real cost = 2 * combinedArea;
+            // minimum cost of pushing the leaf further down
+            Real inheritanceCost = 2 * (combinedArea - area);
+
+            Real childCosts[2];
+            for (int c = 0; c < 2; ++c)
+            {
+                const Node& child = mNodes[node.children[c]];
+                childCosts[c] = mergedHalfArea(child.min, child.max, leafMin, leafMax) +
+                    inheritanceCost;
+                if (!child.isLeaf())
+                    childCosts[c] -= halfArea(child.min, child.max);
+            }
+
+            if (cost < childCosts[0] && cost < childCosts[1])
+                break;
+
+            index = node.children[childCosts[0] < childCosts[1] ? 0 : 1];
+        }
+
+        NodeIndex sibling = index;
+        NodeIndex oldParent = mNodes[sibling].parent;
+        NodeIndex newParent = allocateNode();
+        {
+            Node& node = mNodes[newParent];
+            node.parent = oldParent;
+            node.children[0] = sibling;
+            node.children[1] = leaf;
+            node.min = mNodes[sibling].min;
+            node.max = mNodes[sibling].max;
+            node.min.makeFloor(leafMin);
+            node.max.makeCeil(leafMax);
+        }
+        mNodes[sibling].parent = newParent;
+        mNodes[leaf].parent = newParent;
+
+        if (oldParent != NULL_NODE)
+        {
+            Node& node = mNodes[oldParent];
+            node.children[node.children[0] == sibling ? 0 : 1] = newParent;
+            refitAncestors(oldParent);
+        }
+        else
+        {
+            mRoot = newParent;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::remove(BvhNode* item)
+    {
+        NodeIndex leaf = item->_getBvhLeaf();
+        assert(leaf != NULL_NODE && mNodes[leaf].item == item);
+        item->_setBvhLeaf(NULL_NODE);
+        --mLeafCount;
+
+        if (leaf == mRoot)
+        {
+            mRoot = NULL_NODE;
+            freeNode(leaf);
+            return;
+        }
+
+        // replace the parent of the leaf by its sibling
+        NodeIndex parent = mNodes[leaf].parent;
+        NodeIndex grandParent = mNodes[parent].parent;
+        NodeIndex sibling = mNodes[parent].children[mNodes[parent].children[0] == leaf ? 1 : 0];
+
+        mNodes[sibling].parent = grandParent;
+        if (grandParent != NULL_NODE)
+        {
+            Node& node = mNodes[grandParent];
+            node.children[node.children[0] == parent ? 0 : 1] = sibling;
+            refitAncestors(grandParent);
+        }
+        else
+        {
+            mRoot = sibling;
+        }
+
+        freeNode(parent);
+        freeNode(leaf);
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::refit(BvhNode* item, const AxisAlignedBox& box)
+    {
+        NodeIndex leaf = item->_getBvhLeaf();
+        assert(leaf != NULL_NODE && mNodes[leaf].item == item);
+
+        Node& node = mNodes[leaf];
+        node.min = box.getMinimum();
+        node.max = box.getMaximum();
+        refitAncestors(node.parent);
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::rebuild(void)
+    {
+        mBuildItems.clear();
+        mBuildItems.reserve(mLeafCount);
+        for (NodeList::iterator i = mNodes.begin(); i != mNodes.end(); ++i)
+        {
+            if (!i->item)
+                continue;
+
+            BuildItem b;
+            b.item = i->item;
+            b.min = i->min;
+            b.max = i->max;
+            b.centre = (i->min + i->max) * 0.5f;
+            mBuildItems.push_back(b);
+        }
+
+        mNodes.clear();
+        mRoot = NULL_NODE;
+        mFreeList = NULL_NODE;
+
+        if (!mBuildItems.empty())
+        {
+            // build never reallocates the nodes
+            mNodes.reserve(mBuildItems.size() * 2 - 1);
+            mRoot = build(&mBuildItems[0], mBuildItems.size(), NULL_NODE);
+        }
+        mBuildItems.clear();
+
+        mBuildCost = calculateCost();
+    }
+    //-----------------------------------------------------------------------
+    Bvh::NodeIndex Bvh::build(BuildItem* items, size_t count, NodeIndex parent)
+    {
+        NodeIndex index = allocateNode();
+        Node& node = mNodes[index];
+        node.parent = parent;
+
+        node.min = items[0].min;
+        node.max = items[0].max;
+        Vector3 centreMin = items[0].centre, centreMax = items[0].centre;
+        for (size_t i = 1; i < count; ++i)
+        {
+            node.min.makeFloor(items[i].min);
+            node.max.makeCeil(items[i].max);
+            centreMin.makeFloor(items[i].centre);
+            centreMax.makeCeil(items[i].centre);
+        }
+
+        if (count == 1)
+        {
+            node.item = items[0].item;
+            node.item->_setBvhLeaf(index);
+            return index;
+        }
+
+        // split along the largest extent of the centres
+        Vector3 extent = centreMax - centreMin;
+        int axis = 0;
+        if (extent.y > extent[axis])
+            axis = 1;
+        if (extent.z > extent[axis])
+            axis = 2;
+
+        size_t split = 0;
+        if (extent[axis] > 0)
+        {
+            BinOf binOf;
+            binOf.axis = axis;
+            binOf.min = centreMin[axis];
+            binOf.scale = NUM_BINS * (1 - 1e-5f) / extent[axis];
+
+            size_t binCounts[NUM_BINS];
+            Vector3 binMin[NUM_BINS], binMax[NUM_BINS];
+            for (size_t b = 0; b < NUM_BINS; ++b)
+            {
+                binCounts[b] = 0;
+                binMin[b] = Vector3(Math::POS_INFINITY);
+                binMax[b] = Vector3(Math::NEG_INFINITY);
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                size_t b = binOf(items[i].centre);
+                ++binCounts[b];
+                binMin[b].makeFloor(items[i].min);
+                binMax[b].makeCeil(items[i].max);
+            }
+
+            // area and count of the right side of each split, sweeping from the right
+            Real rightArea[NUM_BINS];
+            size_t rightCount[NUM_BINS];
+            Vector3 min(Math::POS_INFINITY), max(Math::NEG_INFINITY);
+            size_t n = 0;
+            for (size_t b = NUM_BINS - 1; b > 0; --b)
+            {
+                min.makeFloor(binMin[b]);
+                max.makeCeil(binMax[b]);
+                n += binCounts[b];
+                rightArea[b] = n ? halfArea(min, max) : 0;
+                rightCount[b] = n;
+            }
+
+            // sweep from the left, keeping the cheapest split
+            Real bestCost = Math::POS_INFINITY;
+            size_t bestSplit = 0;
+            min = Vector3(Math::POS_INFINITY);
+            max = Vector3(Math::NEG_INFINITY);
+            n = 0;
+            for (size_t b = 1; b < NUM_BINS; ++b)
+            {
+                min.makeFloor(binMin[b - 1]);
+                max.makeCeil(binMax[b - 1]);
+                n += binCounts[b - 1];
+                if (n == 0 || rightCount[b] == 0)
+                    continue;
+
+                Real cost = n * halfArea(min, max) + rightCount[b] * rightArea[b];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestSplit = b;
+                }
+            }
+
+            if (bestSplit)
+            {
+                IsLeftOfBin<BuildItem> isLeft;
+                isLeft.binOf = binOf;
+                isLeft.split = bestSplit;
+                split = std::partition(items, items + count, isLeft) - items;
+            }
+        }
+
+        // centres too close to be binned, split at the median
+        if (split == 0 || split == count)
+        {
+            split = count / 2;
+            IsLeftOfCentre<BuildItem> isLeft;
+            isLeft.axis = axis;
+            std::nth_element(items, items + split, items + count, isLeft);
+        }
+
+        NodeIndex child0 = build(items, split, index);
+        NodeIndex child1 = build(items + split, count - split, index);
+        mNodes[index].children[0] = child0;
+        mNodes[index].children[1] = child1;
+        return index;
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::clear(void)
+    {
+        for (NodeList::iterator i = mNodes.begin(); i != mNodes.end(); ++i)
+        {
+            if (i->item)
+                i->item->_setBvhLeaf(NULL_NODE);
+        }
+        mNodes.clear();
+        mRoot = NULL_NODE;
+        mFreeList = NULL_NODE;
+        mLeafCount = 0;
+        mBuildCost = 0;
+    }
+    //-----------------------------------------------------------------------
+    Real Bvh::calculateCost(void) const
+    {
+        if (mRoot == NULL_NODE)
+            return 0;
+
+        Real rootArea = halfArea(mNodes[mRoot].min, mNodes[mRoot].max);
+        if (rootArea <= 0)
+            return 0;
+
+        Real area = 0;
+        for (NodeList::const_iterator i = mNodes.begin(); i != mNodes.end(); ++i)
+        {
+            // free nodes are neither leaves with an item nor internal nodes
+            if (i->item || !i->isLeaf())
+                area += halfArea(i->min, i->max);
+        }
+        return area / rootArea;
+    }
+    //-----------------------------------------------------------------------
+    size_t Bvh::getDepth(void) const
+    {
+        if (mRoot == NULL_NODE)
+            return 0;
+
+        size_t depth = 0;
+        vector<std::pair<NodeIndex, size_t> >::type stack;
+        stack.push_back(std::make_pair(mRoot, static_cast<size_t>(1)));
+        while (!stack.empty())
+        {
+            NodeIndex index = stack.back().first;
+            size_t level = stack.back().second;
+            stack.pop_back();
+
+            depth = std::max(depth, level);
+            const Node& node = mNodes[index];
+            if (!node.isLeaf())
+            {
+                stack.push_back(std::make_pair(node.children[0], level + 1));
+                stack.push_back(std::make_pair(node.children[1], level + 1));
+            }
+        }
+        return depth;
+    }
+}
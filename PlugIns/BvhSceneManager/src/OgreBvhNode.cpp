@@ -0,0 +1,99 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBvhNode.h"
+#include "OgreBvhSceneManager.h"
+
+namespace Ogre
+{
+    //-----------------------------------------------------------------------
+    BvhNode::BvhNode(SceneManager* creator)
+        : SceneNode(creator)
+        , mBvhLeaf(Bvh::NULL_NODE)
+        , mPendingPosition(NO_POSITION)
+        , mInfinitePosition(NO_POSITION)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BvhNode::BvhNode(SceneManager* creator, const String& name)
+        : SceneNode(creator, name)
+        , mBvhLeaf(Bvh::NULL_NODE)
+        , mPendingPosition(NO_POSITION)
+        , mInfinitePosition(NO_POSITION)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BvhNode::~BvhNode()
+    {
+        if (_isTracked())
+            static_cast<BvhSceneManager*>(mCreator)->_removeBvhNode(this);
+    }
+    //-----------------------------------------------------------------------
+    void BvhNode::_untrack(void)
+    {
+        mBvhLeaf = Bvh::NULL_NODE;
+        mPendingPosition = NO_POSITION;
+        mInfinitePosition = NO_POSITION;
+    }
+    //-----------------------------------------------------------------------
+    void BvhNode::setInSceneGraph(bool inGraph)
+    {
+        if (!inGraph && _isTracked())
+            static_cast<BvhSceneManager*>(mCreator)->_removeBvhNode(this);
+
+        SceneNode::setInSceneGraph(inGraph);
+    }
+    //-----------------------------------------------------------------------
+    void BvhNode::_updateBounds(void)
+    {
+        AxisAlignedBox oldBounds = mWorldAABB;
+
+        // same as SceneNode, only it doesn't care about children
+        mWorldAABB.setNull();
+        ObjectMap::iterator i, iend = mObjectsByName.end();
+        for (i = mObjectsByName.begin(); i != iend; ++i)
+        {
+            mWorldAABB.merge(i->second->getWorldBoundingBox(true));
+        }
+
+        if (mIsInSceneGraph && mPendingPosition == NO_POSITION &&
+            (mWorldAABB != oldBounds || (!_isTracked() && !mWorldAABB.isNull())))
+        {
+            static_cast<BvhSceneManager*>(mCreator)->_notifyBvhNodeUpdated(this);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BvhNode::_addToRenderQueue(Camera* cam, RenderQueue* queue,
+        bool onlyShadowCasters, VisibleObjectsBoundsInfo* visibleBounds)
+    {
+        ObjectMap::iterator i, iend = mObjectsByName.end();
+        for (i = mObjectsByName.begin(); i != iend; ++i)
+        {
+            queue->processVisibleObject(i->second, cam, onlyShadowCasters, visibleBounds);
+        }
+    }
+}
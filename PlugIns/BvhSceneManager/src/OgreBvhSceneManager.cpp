@@ -0,0 +1,921 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBvhSceneManager.h"
+#include "OgreBvhSceneQuery.h"
+#include "OgreBvhNode.h"
+#include "OgreCamera.h"
+#include "OgreRenderQueue.h"
+#include "OgreWireBoundingBox.h"
+#include "OgreEntity.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Node test of the box queries
+        struct BoxTest
+        {
+            Vector3 min;
+            Vector3 max;
+
+            bool operator()(const Vector3& nodeMin, const Vector3& nodeMax) const
+            {
+                return nodeMin.x <= max.x && nodeMax.x >= min.x &&
+                    nodeMin.y <= max.y && nodeMax.y >= min.y &&
+                    nodeMin.z <= max.z && nodeMax.z >= min.z;
+            }
+        };
+        /// Node test of the sphere queries
+        struct SphereTest
+        {
+            Vector3 centre;
+            Real squaredRadius;
+
+            bool operator()(const Vector3& nodeMin, const Vector3& nodeMax) const
+            {
+                Real d = 0;
+                for (int i = 0; i < 3; ++i)
+                {
+                    if (centre[i] < nodeMin[i])
+                        d += Math::Sqr(centre[i] - nodeMin[i]);
+                    else if (centre[i] > nodeMax[i])
+                        d += Math::Sqr(centre[i] - nodeMax[i]);
+                }
+                return d <= squaredRadius;
+            }
+        };
+        /// Node test of the volume queries
+        struct VolumeTest
+        {
+            const PlaneBoundedVolume* volume;
+
+            bool operator()(const Vector3& nodeMin, const Vector3& nodeMax) const
+            {
+                return volume->intersects(AxisAlignedBox(nodeMin, nodeMax));
+            }
+        };
+        /// Node test of the ray queries, a slab test
+        struct RayTest
+        {
+            Vector3 origin;
+            Vector3 invDirection;
+
+            bool operator()(const Vector3& nodeMin, const Vector3& nodeMax) const
+            {
+                Real tmin = 0, tmax = Math::POS_INFINITY;
+                for (int i = 0; i < 3; ++i)
+                {
+                    Real t1 = (nodeMin[i] - origin[i]) * invDirection[i];
+                    Real t2 = (nodeMax[i] - origin[i]) * invDirection[i];
+                    if (t1 > t2)
+                        std::swap(t1, t2);
+                    // a NaN from a ray in the plane of a face leaves the range as is
+                    tmin = std::max(tmin, t1);
+                    tmax = std::min(tmax, t2);
+                }
+                return tmin <= tmax;
+            }
+        };
+
+        /// Adds the nodes of the tree passing the test to the list
+        template <class Test>
+        void findBvhNodes(const Bvh& bvh, const Test& test,
+            BvhSceneManager::SceneNodeVector& list, SceneNode* exclude)
+        {
+            if (bvh.getRoot() == Bvh::NULL_NODE)
+                return;
+
+            // the stack is local so that queries may run concurrently
+            vector<Bvh::NodeIndex>::type stack;
+            stack.reserve(64);
+            stack.push_back(bvh.getRoot());
+            while (!stack.empty())
+            {
+                const Bvh::Node& node = bvh.getNode(stack.back());
+                stack.pop_back();
+
+                if (!test(node.min, node.max))
+                    continue;
+
+                if (node.isLeaf())
+                {
+                    if (node.item != exclude)
+                        list.push_back(node.item);
+                }
+                else
+                {
+                    stack.push_back(node.children[1]);
+                    stack.push_back(node.children[0]);
+                }
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    BvhSceneManager::BvhSceneManager(const String& name)
+        : SceneManager(name)
+        , mBvh(OGRE_NEW Bvh())
+        , mBoxesUsed(0)
+        , mShowBoxes(false)
+        , mRebuildThreshold(1.3f)
+        , mRebuildCheckInterval(30)
+        , mUpdatesSinceCheck(0)
+    {
+        mStats.leafCount = 0;
+        mStats.infiniteCount = 0;
+        mStats.depth = 0;
+        mStats.cost = 0;
+        mStats.buildCost = 0;
+        mStats.refitCount = 0;
+        mStats.insertCount = 0;
+        mStats.removeCount = 0;
+        mStats.rebuildCount = 0;
+    }
+    //-----------------------------------------------------------------------
+    BvhSceneManager::~BvhSceneManager()
+    {
+        // the nodes are destroyed by ~SceneManager, after the tree
+        for (SceneNodeList::iterator i = mSceneNodes.begin(); i != mSceneNodes.end(); ++i)
+        {
+            static_cast<BvhNode*>(i->second)->_untrack();
+        }
+        if (mSceneRoot)
+            static_cast<BvhNode*>(mSceneRoot)->_untrack();
+
+        OGRE_DELETE mBvh;
+        mBvh = 0;
+
+        for (size_t i = 0; i < mBoxes.size(); ++i)
+        {
+            OGRE_DELETE mBoxes[i];
+        }
+    }
+    //-----------------------------------------------------------------------
+    const String& BvhSceneManager::getTypeName(void) const
+    {
+        return BvhSceneManagerFactory::FACTORY_TYPE_NAME;
+    }
+    //-----------------------------------------------------------------------
+    SceneNode* BvhSceneManager::createSceneNodeImpl(void)
+    {
+        return OGRE_NEW BvhNode(this);
+    }
+    //-----------------------------------------------------------------------
+    SceneNode* BvhSceneManager::createSceneNodeImpl(const String& name)
+    {
+        return OGRE_NEW BvhNode(this, name);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::_notifyBvhNodeUpdated(BvhNode* node)
+    {
+        OGRE_LOCK_MUTEX(mPendingNodesMutex);
+        node->_setPendingPosition(mPendingNodes.size());
+        mPendingNodes.push_back(node);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::_removeBvhNode(BvhNode* node)
+    {
+        size_t pos = node->_getPendingPosition();
+        if (pos != BvhNode::NO_POSITION)
+        {
+            OGRE_LOCK_MUTEX(mPendingNodesMutex);
+            BvhNode* last = mPendingNodes.back();
+            mPendingNodes[pos] = last;
+            last->_setPendingPosition(pos);
+            mPendingNodes.pop_back();
+            node->_setPendingPosition(BvhNode::NO_POSITION);
+        }
+
+        if (node->_getBvhLeaf() != Bvh::NULL_NODE)
+        {
+            mBvh->remove(node);
+            ++mStats.removeCount;
+        }
+
+        if (node->_getInfinitePosition() != BvhNode::NO_POSITION)
+            removeInfiniteNode(node);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::addInfiniteNode(BvhNode* node)
+    {
+        node->_setInfinitePosition(mInfiniteNodes.size());
+        mInfiniteNodes.push_back(node);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::removeInfiniteNode(BvhNode* node)
+    {
+        size_t pos = node->_getInfinitePosition();
+        BvhNode* last = mInfiniteNodes.back();
+        mInfiniteNodes[pos] = last;
+        last->_setInfinitePosition(pos);
+        mInfiniteNodes.pop_back();
+        node->_setInfinitePosition(BvhNode::NO_POSITION);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::_updateBvh(void)
+    {
+        if (mPendingNodes.empty())
+            return;
+
+        size_t inserted = 0;
+        for (BvhNodeList::iterator i = mPendingNodes.begin(); i != mPendingNodes.end(); ++i)
+        {
+            BvhNode* node = *i;
+            node->_setPendingPosition(BvhNode::NO_POSITION);
+            const AxisAlignedBox& box = node->_getWorldAABB();
+
+            if (!node->isInSceneGraph() || box.isNull())
+            {
+                _removeBvhNode(node);
+            }
+            else if (box.isInfinite())
+            {
+                if (node->_getBvhLeaf() != Bvh::NULL_NODE)
+                {
+                    mBvh->remove(node);
+                    ++mStats.removeCount;
+                }
+                if (node->_getInfinitePosition() == BvhNode::NO_POSITION)
+                    addInfiniteNode(node);
+            }
+            else
+            {
+                if (node->_getInfinitePosition() != BvhNode::NO_POSITION)
+                    removeInfiniteNode(node);
+
+                if (node->_getBvhLeaf() != Bvh::NULL_NODE)
+                {
+                    mBvh->refit(node, box);
+                    ++mStats.refitCount;
+                }
+                else
+                {
+                    mBvh->insert(node, box);
+                    ++inserted;
+                }
+            }
+        }
+        mPendingNodes.clear();
+        mStats.insertCount += inserted;
+
+        // most of the tree was just inserted, as when a scene is loaded:
+        // build it properly at once
+        const size_t minRebuildInserts = 32;
+        if (inserted >= minRebuildInserts && inserted * 2 > mBvh->getLeafCount())
+            rebuildBvh();
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::rebuildBvh(void)
+    {
+        _updateBvh();
+
+        mBvh->rebuild();
+        ++mStats.rebuildCount;
+        mUpdatesSinceCheck = 0;
+    }
+    //-----------------------------------------------------------------------
+    const BvhSceneManager::Statistics& BvhSceneManager::getBvhStatistics(void)
+    {
+        _updateBvh();
+
+        mStats.leafCount = mBvh->getLeafCount();
+        mStats.infiniteCount = mInfiniteNodes.size();
+        mStats.depth = mBvh->getDepth();
+        mStats.cost = mBvh->calculateCost();
+        mStats.buildCost = mBvh->getBuildCost();
+        return mStats;
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::_updateSceneGraph(Camera* cam)
+    {
+        SceneManager::_updateSceneGraph(cam);
+
+        _updateBvh();
+
+        // rebuild the tree once refitting has made it too costly to traverse
+        if (mRebuildCheckInterval && ++mUpdatesSinceCheck >= mRebuildCheckInterval)
+        {
+            mUpdatesSinceCheck = 0;
+            if (mBvh->getLeafCount() > 2 &&
+                mBvh->calculateCost() > mBvh->getBuildCost() * mRebuildThreshold)
+            {
+                rebuildBvh();
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::_findVisibleObjects(Camera* cam,
+        VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+    {
+        _updateBvh();
+
+        getRenderQueue()->clear();
+        mVisible.clear();
+        mBoxesUsed = 0;
+
+        if (getCullingThreadCount() > 1)
+        {
+            // walk the tree gathering the visible nodes, whose objects are then
+            // queued by several threads
+            walkBvh(cam, 0, visibleBounds, onlyShadowCasters);
+
+            mVisibleObjectsItems.clear();
+            for (BvhNodeList::iterator i = mVisible.begin(); i != mVisible.end(); ++i)
+            {
+                mVisibleObjectsItems.push_back(VisibleObjectsItem(*i, false));
+            }
+            findVisibleObjectsParallel(cam, visibleBounds, onlyShadowCasters);
+        }
+        else
+        {
+            walkBvh(cam, getRenderQueue(), visibleBounds, onlyShadowCasters);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::findVisibleObjectsInItem(const VisibleObjectsItem& item, Camera* cam,
+        RenderQueue* queue, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+    {
+        static_cast<BvhNode*>(item.first)->_addToRenderQueue(cam, queue,
+            onlyShadowCasters, visibleBounds);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::walkBvh(Camera* cam, RenderQueue* queue,
+        VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+    {
+        for (BvhNodeList::iterator i = mInfiniteNodes.begin(); i != mInfiniteNodes.end(); ++i)
+        {
+            addVisibleNode(*i, cam, queue, visibleBounds, onlyShadowCasters);
+        }
+
+        if (mBvh->getRoot() == Bvh::NULL_NODE)
+            return;
+
+        // the planes culling the scene, skipping the far plane of an infinite frustum
+        const Frustum* cullFrustum = cam->getCullingFrustum() ? cam->getCullingFrustum() : cam;
+        Plane planes[6];
+        int numPlanes = 0;
+        for (unsigned short p = 0; p < 6; ++p)
+        {
+            if (p == FRUSTUM_PLANE_FAR && cullFrustum->getFarClipDistance() == 0)
+                continue;
+            planes[numPlanes++] = cam->getFrustumPlane(p);
+        }
+
+        // each entry carries the planes its parent was not entirely inside of,
+        // the only ones its subtree still has to be tested against
+        mStack.clear();
+        mStack.push_back(std::make_pair(mBvh->getRoot(), (1u << numPlanes) - 1));
+        while (!mStack.empty())
+        {
+            const Bvh::Node& node = mBvh->getNode(mStack.back().first);
+            uint32 planeMask = mStack.back().second;
+            mStack.pop_back();
+
+            if (planeMask)
+            {
+                Vector3 centre = (node.min + node.max) * 0.5f;
+                Vector3 halfSize = (node.max - node.min) * 0.5f;
+                bool culled = false;
+                for (int p = 0; p < numPlanes; ++p)
+                {
+                    if (!(planeMask & (1u << p)))
+                        continue;
+
+                    Plane::Side side = planes[p].getSide(centre, halfSize);
+                    if (side == Plane::NEGATIVE_SIDE)
+                    {
+                        culled = true;
+                        break;
+                    }
+                    if (side == Plane::POSITIVE_SIDE)
+                        planeMask &= ~(1u << p);
+                }
+                if (culled)
+                    continue;
+            }
+
+            if (mShowBoxes)
+                addTreeBox(node);
+
+            if (node.isLeaf())
+            {
+                addVisibleNode(node.item, cam, queue, visibleBounds, onlyShadowCasters);
+            }
+            else
+            {
+                mStack.push_back(std::make_pair(node.children[1], planeMask));
+                mStack.push_back(std::make_pair(node.children[0], planeMask));
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::addVisibleNode(BvhNode* node, Camera* cam, RenderQueue* queue,
+        VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+    {
+        // without a queue the nodes are only gathered in mVisible
+        if (queue)
+            node->_addToRenderQueue(cam, queue, onlyShadowCasters, visibleBounds);
+
+        mVisible.push_back(node);
+
+        if (mDisplayNodes)
+            getRenderQueue()->addRenderable(node->getDebugRenderable());
+
+        // check if the scene manager or this node wants the bounding box shown.
+        if (node->getShowBoundingBox() || mShowBoundingBoxes)
+            node->_addBoundingBoxToQueue(getRenderQueue());
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::addTreeBox(const Bvh::Node& node)
+    {
+        if (mBoxesUsed == mBoxes.size())
+            mBoxes.push_back(OGRE_NEW WireBoundingBox());
+
+        WireBoundingBox* box = mBoxes[mBoxesUsed++];
+        box->setupBoundingBox(AxisAlignedBox(node.min, node.max));
+        getRenderQueue()->addRenderable(box);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::findNodesIn(const AxisAlignedBox& box, SceneNodeVector& list,
+        SceneNode* exclude)
+    {
+        _updateBvh();
+
+        if (box.isNull())
+            return;
+
+        for (BvhNodeList::iterator i = mInfiniteNodes.begin(); i != mInfiniteNodes.end(); ++i)
+        {
+            if (*i != exclude)
+                list.push_back(*i);
+        }
+
+        if (box.isInfinite())
+        {
+            BoxTest test;
+            test.min = Vector3(Math::NEG_INFINITY);
+            test.max = Vector3(Math::POS_INFINITY);
+            findBvhNodes(*mBvh, test, list, exclude);
+        }
+        else
+        {
+            BoxTest test;
+            test.min = box.getMinimum();
+            test.max = box.getMaximum();
+            findBvhNodes(*mBvh, test, list, exclude);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::findNodesIn(const Sphere& sphere, SceneNodeVector& list,
+        SceneNode* exclude)
+    {
+        _updateBvh();
+
+        for (BvhNodeList::iterator i = mInfiniteNodes.begin(); i != mInfiniteNodes.end(); ++i)
+        {
+            if (*i != exclude)
+                list.push_back(*i);
+        }
+
+        SphereTest test;
+        test.centre = sphere.getCenter();
+        test.squaredRadius = Math::Sqr(sphere.getRadius());
+        findBvhNodes(*mBvh, test, list, exclude);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::findNodesIn(const PlaneBoundedVolume& volume, SceneNodeVector& list,
+        SceneNode* exclude)
+    {
+        _updateBvh();
+
+        for (BvhNodeList::iterator i = mInfiniteNodes.begin(); i != mInfiniteNodes.end(); ++i)
+        {
+            if (*i != exclude)
+                list.push_back(*i);
+        }
+
+        VolumeTest test;
+        test.volume = &volume;
+        findBvhNodes(*mBvh, test, list, exclude);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::findNodesIn(const Ray& ray, SceneNodeVector& list,
+        SceneNode* exclude)
+    {
+        _updateBvh();
+
+        for (BvhNodeList::iterator i = mInfiniteNodes.begin(); i != mInfiniteNodes.end(); ++i)
+        {
+            if (*i != exclude)
+                list.push_back(*i);
+        }
+
+        RayTest test;
+        test.origin = ray.getOrigin();
+        const Vector3& dir = ray.getDirection();
+        for (int i = 0; i < 3; ++i)
+        {
+            test.invDirection[i] = dir[i] != 0 ? 1 / dir[i] : Math::POS_INFINITY;
+        }
+        findBvhNodes(*mBvh, test, list, exclude);
+    }
+    //-----------------------------------------------------------------------
+    struct BvhSceneManager::BatchQueryPacket
+    {
+        BatchQueryType type;
+        /// First query of the packet in mBatchQuery, and number of queries
+        size_t first;
+        size_t count;
+        RayTest rays[BATCH_QUERY_PACKET_SIZE];
+        SphereTest spheres[BATCH_QUERY_PACKET_SIZE];
+        BoxTest boxes[BATCH_QUERY_PACKET_SIZE];
+
+        /// Returns the bits of mask whose queries hit the tree node
+        uint32 test(const Bvh::Node& node, uint32 mask) const
+        {
+            uint32 result = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint32 bit = static_cast<uint32>(1) << i;
+                if (!(mask & bit))
+                    continue;
+
+                bool hit;
+                switch (type)
+                {
+                case BQT_RAY:
+                    hit = rays[i](node.min, node.max);
+                    break;
+                case BQT_SPHERE:
+                    hit = spheres[i](node.min, node.max);
+                    break;
+                default:
+                    hit = boxes[i](node.min, node.max);
+                    break;
+                }
+                if (hit)
+                    result |= bit;
+            }
+            return result;
+        }
+    };
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::prepareBatchQueries(void)
+    {
+        // the objects are found through the tree rather than gathered up front
+        _updateBvh();
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::executeBatchQueryPacket(size_t first, size_t count)
+    {
+        BatchQueryPacket packet;
+        packet.type = mBatchQuery.type;
+        packet.first = first;
+        packet.count = count;
+        for (size_t i = 0; i < count; ++i)
+        {
+            switch (mBatchQuery.type)
+            {
+            case BQT_RAY:
+                {
+                    const Ray& ray = mBatchQuery.rays[first + i];
+                    packet.rays[i].origin = ray.getOrigin();
+                    const Vector3& dir = ray.getDirection();
+                    for (int j = 0; j < 3; ++j)
+                    {
+                        packet.rays[i].invDirection[j] = dir[j] != 0 ? 1 / dir[j] : Math::POS_INFINITY;
+                    }
+                }
+                break;
+            case BQT_SPHERE:
+                packet.spheres[i].centre = mBatchQuery.spheres[first + i].getCenter();
+                packet.spheres[i].squaredRadius = Math::Sqr(mBatchQuery.spheres[first + i].getRadius());
+                break;
+            case BQT_BOX:
+                packet.boxes[i].min = mBatchQuery.boxes[first + i].getMinimum();
+                packet.boxes[i].max = mBatchQuery.boxes[first + i].getMaximum();
+                break;
+            }
+        }
+
+        const uint32 all = count < 32 ?
+            (static_cast<uint32>(1) << count) - 1 : 0xFFFFFFFF;
+        for (BvhNodeList::iterator i = mInfiniteNodes.begin(); i != mInfiniteNodes.end(); ++i)
+        {
+            testBatchQueryObjects(*i, first, all);
+        }
+        if (mBvh->getRoot() != Bvh::NULL_NODE)
+            walkBatchQueryPacket(mBvh->getRoot(), all, packet);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::walkBatchQueryPacket(Bvh::NodeIndex root, uint32 mask,
+        const BatchQueryPacket& packet)
+    {
+        // a fixed stack so that packets run concurrently without allocating,
+        // going down recursively in the rare trees too deep for it
+        const size_t stackSize = 64;
+        std::pair<Bvh::NodeIndex, uint32> stack[stackSize];
+        size_t top = 0;
+        stack[top++] = std::make_pair(root, mask);
+        while (top)
+        {
+            --top;
+            const Bvh::Node& node = mBvh->getNode(stack[top].first);
+            uint32 active = packet.test(node, stack[top].second);
+            if (!active)
+                continue;
+
+            if (node.isLeaf())
+            {
+                testBatchQueryObjects(node.item, packet.first, active);
+            }
+            else if (top + 2 > stackSize)
+            {
+                walkBatchQueryPacket(node.children[1], active, packet);
+                stack[top++] = std::make_pair(node.children[0], active);
+            }
+            else
+            {
+                stack[top++] = std::make_pair(node.children[1], active);
+                stack[top++] = std::make_pair(node.children[0], active);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::testBatchQueryObjects(SceneNode* node, size_t first, uint32 mask)
+    {
+        SceneNode::ObjectIterator it = node->getAttachedObjectIterator();
+        while (it.hasMoreElements())
+        {
+            MovableObject* m = it.getNext();
+            if (!m->isInScene())
+                continue;
+
+            testBatchQueryObject(m, first, mask);
+
+            // deal with attached objects, since they are not directly attached to nodes
+            if (m->getMovableType() == EntityFactory::FACTORY_TYPE_NAME)
+            {
+                Entity::ChildObjectListIterator childIt =
+                    static_cast<Entity*>(m)->getAttachedObjectIterator();
+                while (childIt.hasMoreElements())
+                {
+                    MovableObject* c = childIt.getNext();
+                    if (c->isInScene())
+                        testBatchQueryObject(c, first, mask);
+                }
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::testBatchQueryObject(MovableObject* object, size_t first, uint32 mask)
+    {
+        if (!(object->getQueryFlags() & mBatchQuery.queryMask) ||
+            !(object->getTypeFlags() & mBatchQuery.queryTypeMask))
+        {
+            return;
+        }
+
+        const AxisAlignedBox& box = object->getWorldBoundingBox();
+        Real distance;
+        for (size_t i = 0; mask; ++i, mask >>= 1)
+        {
+            if ((mask & 1) && testBatchQuery(first + i, box, distance))
+                addBatchQueryHit(first + i, object, distance);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::findIntersectingNodes(SceneNodePairList& pairs)
+    {
+        _updateBvh();
+
+        // infinite nodes intersect every node
+        for (size_t i = 0; i < mInfiniteNodes.size(); ++i)
+        {
+            for (size_t j = i + 1; j < mInfiniteNodes.size(); ++j)
+                pairs.push_back(std::make_pair(mInfiniteNodes[i], mInfiniteNodes[j]));
+        }
+        if (!mInfiniteNodes.empty())
+        {
+            SceneNodeVector nodes;
+            BoxTest all;
+            all.min = Vector3(Math::NEG_INFINITY);
+            all.max = Vector3(Math::POS_INFINITY);
+            findBvhNodes(*mBvh, all, nodes, 0);
+            for (BvhNodeList::iterator i = mInfiniteNodes.begin(); i != mInfiniteNodes.end(); ++i)
+            {
+                for (SceneNodeVector::iterator j = nodes.begin(); j != nodes.end(); ++j)
+                    pairs.push_back(std::make_pair(static_cast<SceneNode*>(*i), *j));
+            }
+        }
+
+        if (mBvh->getRoot() == Bvh::NULL_NODE)
+            return;
+
+        // descend the tree against itself, a pair of the same node standing for
+        // the pairs of distinct nodes within its subtree
+        typedef std::pair<Bvh::NodeIndex, Bvh::NodeIndex> IndexPair;
+        vector<IndexPair>::type stack;
+        stack.push_back(IndexPair(mBvh->getRoot(), mBvh->getRoot()));
+        while (!stack.empty())
+        {
+            IndexPair p = stack.back();
+            stack.pop_back();
+            const Bvh::Node& a = mBvh->getNode(p.first);
+            const Bvh::Node& b = mBvh->getNode(p.second);
+
+            if (p.first == p.second)
+            {
+                if (!a.isLeaf())
+                {
+                    stack.push_back(IndexPair(a.children[0], a.children[0]));
+                    stack.push_back(IndexPair(a.children[1], a.children[1]));
+                    stack.push_back(IndexPair(a.children[0], a.children[1]));
+                }
+                continue;
+            }
+
+            BoxTest test;
+            test.min = a.min;
+            test.max = a.max;
+            if (!test(b.min, b.max))
+                continue;
+
+            if (a.isLeaf() && b.isLeaf())
+            {
+                pairs.push_back(std::make_pair(static_cast<SceneNode*>(a.item), 
+                    static_cast<SceneNode*>(b.item)));
+            }
+            else if (a.isLeaf() || (!b.isLeaf() &&
+                (b.max - b.min).squaredLength() > (a.max - a.min).squaredLength()))
+            {
+                // descend the larger node
+                stack.push_back(IndexPair(p.first, b.children[0]));
+                stack.push_back(IndexPair(p.first, b.children[1]));
+            }
+            else
+            {
+                stack.push_back(IndexPair(a.children[0], p.second));
+                stack.push_back(IndexPair(a.children[1], p.second));
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool BvhSceneManager::setOption(const String& key, const void* val)
+    {
+        if (key == "RebuildThreshold")
+        {
+            mRebuildThreshold = *static_cast<const Real*>(val);
+            return true;
+        }
+        else if (key == "RebuildCheckInterval")
+        {
+            mRebuildCheckInterval = *static_cast<const size_t*>(val);
+            mUpdatesSinceCheck = 0;
+            return true;
+        }
+        else if (key == "ShowBvh")
+        {
+            mShowBoxes = *static_cast<const bool*>(val);
+            return true;
+        }
+
+        return SceneManager::setOption(key, val);
+    }
+    //-----------------------------------------------------------------------
+    bool BvhSceneManager::getOption(const String& key, void* val)
+    {
+        if (key == "RebuildThreshold")
+        {
+            *static_cast<Real*>(val) = mRebuildThreshold;
+            return true;
+        }
+        else if (key == "RebuildCheckInterval")
+        {
+            *static_cast<size_t*>(val) = mRebuildCheckInterval;
+            return true;
+        }
+        else if (key == "ShowBvh")
+        {
+            *static_cast<bool*>(val) = mShowBoxes;
+            return true;
+        }
+
+        return SceneManager::getOption(key, val);
+    }
+    //-----------------------------------------------------------------------
+    bool BvhSceneManager::getOptionValues(const String& key, StringVector& refValueList)
+    {
+        return SceneManager::getOptionValues(key, refValueList);
+    }
+    //-----------------------------------------------------------------------
+    bool BvhSceneManager::getOptionKeys(StringVector& refKeys)
+    {
+        SceneManager::getOptionKeys(refKeys);
+        refKeys.push_back("RebuildThreshold");
+        refKeys.push_back("RebuildCheckInterval");
+        refKeys.push_back("ShowBvh");
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::clearScene(void)
+    {
+        SceneManager::clearScene();
+
+        // the root is all that is left
+        static_cast<BvhNode*>(getRootSceneNode())->_untrack();
+        mBvh->clear();
+        mInfiniteNodes.clear();
+        mPendingNodes.clear();
+        mVisible.clear();
+    }
+    //-----------------------------------------------------------------------
+    AxisAlignedBoxSceneQuery*
+    BvhSceneManager::createAABBQuery(const AxisAlignedBox& box, uint32 mask)
+    {
+        BvhAxisAlignedBoxSceneQuery* q = OGRE_NEW BvhAxisAlignedBoxSceneQuery(this);
+        q->setBox(box);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    SphereSceneQuery*
+    BvhSceneManager::createSphereQuery(const Sphere& sphere, uint32 mask)
+    {
+        BvhSphereSceneQuery* q = OGRE_NEW BvhSphereSceneQuery(this);
+        q->setSphere(sphere);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    PlaneBoundedVolumeListSceneQuery*
+    BvhSceneManager::createPlaneBoundedVolumeQuery(const PlaneBoundedVolumeList& volumes,
+        uint32 mask)
+    {
+        BvhPlaneBoundedVolumeListSceneQuery* q = OGRE_NEW BvhPlaneBoundedVolumeListSceneQuery(this);
+        q->setVolumes(volumes);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    RaySceneQuery*
+    BvhSceneManager::createRayQuery(const Ray& ray, uint32 mask)
+    {
+        BvhRaySceneQuery* q = OGRE_NEW BvhRaySceneQuery(this);
+        q->setRay(ray);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    IntersectionSceneQuery*
+    BvhSceneManager::createIntersectionQuery(uint32 mask)
+    {
+        BvhIntersectionSceneQuery* q = OGRE_NEW BvhIntersectionSceneQuery(this);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    const String BvhSceneManagerFactory::FACTORY_TYPE_NAME = "BvhSceneManager";
+    //-----------------------------------------------------------------------
+    void BvhSceneManagerFactory::initMetaData(void) const
+    {
+        mMetaData.typeName = FACTORY_TYPE_NAME;
+        mMetaData.description = "Scene manager organising the scene in a dynamic bounding volume hierarchy.";
+        mMetaData.sceneTypeMask = 0xFFFF; // support all types
+        mMetaData.worldGeometrySupported = false;
+    }
+    //-----------------------------------------------------------------------
+    SceneManager* BvhSceneManagerFactory::createInstance(const String& instanceName)
+    {
+        return OGRE_NEW BvhSceneManager(instanceName);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManagerFactory::destroyInstance(SceneManager* instance)
+    {
+        OGRE_DELETE instance;
+    }
+}
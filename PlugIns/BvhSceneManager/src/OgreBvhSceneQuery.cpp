@@ -0,0 +1,272 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBvhSceneQuery.h"
+#include "OgreBvhSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreEntity.h"
+
+#include <algorithm>
+
+namespace Ogre
+{
+    namespace
+    {
+        typedef vector<MovableObject*>::type MovableObjectVector;
+
+        /// Adds the objects of a node passing the masks to the list
+        void collectObjects(SceneNode* node, uint32 queryMask, uint32 typeMask,
+            MovableObjectVector& objects)
+        {
+            SceneNode::ObjectIterator it = node->getAttachedObjectIterator();
+            while (it.hasMoreElements())
+            {
+                MovableObject* m = it.getNext();
+                if (!m->isInScene())
+                    continue;
+
+                if ((m->getQueryFlags() & queryMask) && (m->getTypeFlags() & typeMask))
+                    objects.push_back(m);
+
+                // deal with attached objects, since they are not directly attached to nodes
+                if (m->getMovableType() == EntityFactory::FACTORY_TYPE_NAME)
+                {
+                    Entity::ChildObjectListIterator childIt =
+                        static_cast<Entity*>(m)->getAttachedObjectIterator();
+                    while (childIt.hasMoreElements())
+                    {
+                        MovableObject* c = childIt.getNext();
+                        if ((c->getQueryFlags() & queryMask) && (c->getTypeFlags() & typeMask) &&
+                            c->isInScene())
+                        {
+                            objects.push_back(c);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    BvhIntersectionSceneQuery::BvhIntersectionSceneQuery(SceneManager* creator)
+        : DefaultIntersectionSceneQuery(creator)
+    {
+    }
+    //---------------------------------------------------------------------
+    BvhIntersectionSceneQuery::~BvhIntersectionSceneQuery()
+    {
+    }
+    //---------------------------------------------------------------------
+    void BvhIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+    {
+        BvhSceneManager* mgr = static_cast<BvhSceneManager*>(mParentSceneMgr);
+
+        // gather the objects of every node once, each node owning a range
+        BvhSceneManager::SceneNodeVector nodes;
+        mgr->findNodesIn(AxisAlignedBox::BOX_INFINITE, nodes);
+
+        typedef std::pair<size_t, size_t> Range;
+        typedef map<SceneNode*, Range>::type NodeRangeMap;
+        NodeRangeMap ranges;
+        MovableObjectVector objects;
+        for (BvhSceneManager::SceneNodeVector::iterator i = nodes.begin(); i != nodes.end(); ++i)
+        {
+            size_t begin = objects.size();
+            collectObjects(*i, mQueryMask, mQueryTypeMask, objects);
+            if (objects.size() != begin)
+                ranges[*i] = Range(begin, objects.size());
+        }
+
+        // objects of the same node
+        for (NodeRangeMap::iterator r = ranges.begin(); r != ranges.end(); ++r)
+        {
+            for (size_t a = r->second.first; a < r->second.second; ++a)
+            {
+                const AxisAlignedBox& boxA = objects[a]->getWorldBoundingBox();
+                for (size_t b = a + 1; b < r->second.second; ++b)
+                {
+                    if (boxA.intersects(objects[b]->getWorldBoundingBox()))
+                    {
+                        if (!listener->queryResult(objects[a], objects[b])) return;
+                    }
+                }
+            }
+        }
+
+        // objects of intersecting nodes
+        BvhSceneManager::SceneNodePairList pairs;
+        mgr->findIntersectingNodes(pairs);
+        for (BvhSceneManager::SceneNodePairList::iterator p = pairs.begin(); p != pairs.end(); ++p)
+        {
+            NodeRangeMap::iterator ra = ranges.find(p->first);
+            NodeRangeMap::iterator rb = ranges.find(p->second);
+            if (ra == ranges.end() || rb == ranges.end())
+                continue;
+
+            for (size_t a = ra->second.first; a < ra->second.second; ++a)
+            {
+                const AxisAlignedBox& boxA = objects[a]->getWorldBoundingBox();
+                for (size_t b = rb->second.first; b < rb->second.second; ++b)
+                {
+                    if (boxA.intersects(objects[b]->getWorldBoundingBox()))
+                    {
+                        if (!listener->queryResult(objects[a], objects[b])) return;
+                    }
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    BvhAxisAlignedBoxSceneQuery::BvhAxisAlignedBoxSceneQuery(SceneManager* creator)
+        : DefaultAxisAlignedBoxSceneQuery(creator)
+    {
+    }
+    //---------------------------------------------------------------------
+    BvhAxisAlignedBoxSceneQuery::~BvhAxisAlignedBoxSceneQuery()
+    {
+    }
+    //---------------------------------------------------------------------
+    void BvhAxisAlignedBoxSceneQuery::execute(SceneQueryListener* listener)
+    {
+        BvhSceneManager::SceneNodeVector nodes;
+        static_cast<BvhSceneManager*>(mParentSceneMgr)->findNodesIn(mAABB, nodes);
+
+        MovableObjectVector objects;
+        for (BvhSceneManager::SceneNodeVector::iterator i = nodes.begin(); i != nodes.end(); ++i)
+        {
+            objects.clear();
+            collectObjects(*i, mQueryMask, mQueryTypeMask, objects);
+            for (MovableObjectVector::iterator m = objects.begin(); m != objects.end(); ++m)
+            {
+                if (mAABB.intersects((*m)->getWorldBoundingBox()))
+                {
+                    if (!listener->queryResult(*m)) return;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    BvhRaySceneQuery::BvhRaySceneQuery(SceneManager* creator)
+        : DefaultRaySceneQuery(creator)
+    {
+    }
+    //---------------------------------------------------------------------
+    BvhRaySceneQuery::~BvhRaySceneQuery()
+    {
+    }
+    //---------------------------------------------------------------------
+    void BvhRaySceneQuery::execute(RaySceneQueryListener* listener)
+    {
+        BvhSceneManager::SceneNodeVector nodes;
+        static_cast<BvhSceneManager*>(mParentSceneMgr)->findNodesIn(mRay, nodes);
+
+        MovableObjectVector objects;
+        for (BvhSceneManager::SceneNodeVector::iterator i = nodes.begin(); i != nodes.end(); ++i)
+        {
+            objects.clear();
+            collectObjects(*i, mQueryMask, mQueryTypeMask, objects);
+            for (MovableObjectVector::iterator m = objects.begin(); m != objects.end(); ++m)
+            {
+                std::pair<bool, Real> result = mRay.intersects((*m)->getWorldBoundingBox());
+                if (result.first)
+                {
+                    if (!listener->queryResult(*m, result.second)) return;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    BvhSphereSceneQuery::BvhSphereSceneQuery(SceneManager* creator)
+        : DefaultSphereSceneQuery(creator)
+    {
+    }
+    //---------------------------------------------------------------------
+    BvhSphereSceneQuery::~BvhSphereSceneQuery()
+    {
+    }
+    //---------------------------------------------------------------------
+    void BvhSphereSceneQuery::execute(SceneQueryListener* listener)
+    {
+        BvhSceneManager::SceneNodeVector nodes;
+        static_cast<BvhSceneManager*>(mParentSceneMgr)->findNodesIn(mSphere, nodes);
+
+        MovableObjectVector objects;
+        for (BvhSceneManager::SceneNodeVector::iterator i = nodes.begin(); i != nodes.end(); ++i)
+        {
+            objects.clear();
+            collectObjects(*i, mQueryMask, mQueryTypeMask, objects);
+            for (MovableObjectVector::iterator m = objects.begin(); m != objects.end(); ++m)
+            {
+                if (mSphere.intersects((*m)->getWorldBoundingBox()))
+                {
+                    if (!listener->queryResult(*m)) return;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    BvhPlaneBoundedVolumeListSceneQuery::BvhPlaneBoundedVolumeListSceneQuery(SceneManager* creator)
+        : DefaultPlaneBoundedVolumeListSceneQuery(creator)
+    {
+    }
+    //---------------------------------------------------------------------
+    BvhPlaneBoundedVolumeListSceneQuery::~BvhPlaneBoundedVolumeListSceneQuery()
+    {
+    }
+    //---------------------------------------------------------------------
+    void BvhPlaneBoundedVolumeListSceneQuery::execute(SceneQueryListener* listener)
+    {
+        BvhSceneManager* mgr = static_cast<BvhSceneManager*>(mParentSceneMgr);
+
+        // nodes found by several volumes are checked once, against all volumes
+        BvhSceneManager::SceneNodeVector nodes;
+        for (PlaneBoundedVolumeList::iterator v = mVolumes.begin(); v != mVolumes.end(); ++v)
+        {
+            mgr->findNodesIn(*v, nodes);
+        }
+        std::sort(nodes.begin(), nodes.end());
+        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+        MovableObjectVector objects;
+        for (BvhSceneManager::SceneNodeVector::iterator i = nodes.begin(); i != nodes.end(); ++i)
+        {
+            objects.clear();
+            collectObjects(*i, mQueryMask, mQueryTypeMask, objects);
+            for (MovableObjectVector::iterator m = objects.begin(); m != objects.end(); ++m)
+            {
+                const AxisAlignedBox& box = (*m)->getWorldBoundingBox();
+                for (PlaneBoundedVolumeList::iterator v = mVolumes.begin(); v != mVolumes.end(); ++v)
+                {
+                    if (v->intersects(box))
+                    {
+                        if (!listener->queryResult(*m)) return;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -127,6 +127,40 @@ public:
     */
     NodeList mNodes;
 
+    /** Hardware occlusion culling state of an octant.
+    @remarks
+    Maintained by the OctreeSceneManager for its occlusion culling camera,
+    see OctreeSceneManager::setOcclusionCullingCamera.
+    */
+    struct OcclusionState
+    {
+        /// The octant was found hidden by the last query of it or of all its children
+        bool occluded;
+        /// A query of this octant is waiting for its result
+        bool pending;
+        /// Number of consecutive queries which found the octant hidden
+        unsigned int occludedCount;
+        /// Number of objects in the octant and its children when last queried
+        size_t objectCount;
+        /// Occlusion culled frame in which the octant was last traversed
+        unsigned long lastVisitedFrame;
+        /// Occlusion culled frame in which the octant was last queried
+        unsigned long lastQueriedFrame;
+
+        OcclusionState()
+            : occluded( false ), pending( false ), occludedCount( 0 ), objectCount( 0 ),
+              lastVisitedFrame( 0 ), lastQueriedFrame( 0 )
+        {
+        }
+    };
+    OcclusionState mOcclusion;
+
+    /** Returns the octree this octant is a child of, 0 for the root */
+    Octree * _getParent() const
+    {
+        return mParent;
+    };
+
 protected:
 
     /** Increments the overall node count of this octree and all its parents
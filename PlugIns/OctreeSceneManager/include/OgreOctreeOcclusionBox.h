@@ -0,0 +1,69 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __OctreeOcclusionBox_H__
+#define __OctreeOcclusionBox_H__
+
+#include "OgreOctreePrerequisites.h"
+#include "OgreSimpleRenderable.h"
+
+namespace Ogre
+{
+
+/** Solid box rendered by the OctreeSceneManager inside its hardware
+    occlusion queries.
+@remarks
+A single unit cube is scaled and translated onto each box queried, so the
+geometry never has to be rebuilt.
+*/
+class _OgreOctreePluginExport OctreeOcclusionBox : public SimpleRenderable
+{
+public:
+    OctreeOcclusionBox();
+    ~OctreeOcclusionBox();
+
+    /** Places the cube onto the given world space box. */
+    void setupBox( const AxisAlignedBox &box );
+
+    /** Returns the placement of the cube, ignoring any parent node. */
+    void getWorldTransforms( Matrix4 *xform ) const;
+
+    Real getSquaredViewDepth( const Camera *cam ) const;
+
+    Real getBoundingRadius( void ) const
+    {
+        return mRadius;
+    }
+
+protected:
+    Real mRadius;
+};
+
+}
+
+#endif
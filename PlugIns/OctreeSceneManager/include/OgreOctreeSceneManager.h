@@ -51,6 +51,7 @@ namespace Ogre
 
 class OctreeNode;
 class OctreeCamera;
+class OctreeOcclusionBox;
 
 typedef list< WireBoundingBox * >::type BoxList;
 typedef list< unsigned long >::type ColorList;
@@ -92,6 +93,10 @@ public:
     /** Deletes a scene node */
     virtual void destroySceneNode( const String &name );
 
+    using SceneManager::destroyCamera;
+    /** Destroys a camera, disabling occlusion culling if it was made for it */
+    virtual void destroyCamera( const String &name );
+
 
 
     /** Does nothing more */
@@ -100,6 +105,11 @@ public:
     virtual void _findVisibleObjects ( Camera * cam, 
         VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters );
 
+    /** Renders the visible objects, then issues the hardware occlusion
+        queries of the frame, see setOcclusionCullingCamera.
+    */
+    virtual void _renderVisibleObjects( void );
+
     /** Alerts each unculled object, notifying it that it will be drawn.
      * Useful for doing calculations only on nodes that will be drawn, prior
      * to drawing them...
@@ -110,11 +120,18 @@ public:
     @remarks
     If any octant in the octree if completely within the view frustum,
     all subchildren are automatically added with no visibility tests.
+    With a null queue the visible nodes are only gathered in mVisible.
     */
     void walkOctree( OctreeCamera *, RenderQueue *, Octree *, 
         VisibleObjectsBoundsInfo* visibleBounds, bool foundvisible, 
         bool onlyShadowCasters);
 
+    /** Queues the objects of a visible node gathered by walkOctree, when
+        searching for visible objects on several threads.
+    */
+    virtual void findVisibleObjectsInItem( const VisibleObjectsItem& item, Camera* cam, 
+        RenderQueue* queue, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters );
+
     /** Checks the given OctreeNode, and determines if it needs to be moved
     * to a different octant.
     */
@@ -154,12 +171,90 @@ public:
     /** Resizes the octree to the given size */
     void resize( const AxisAlignedBox &box );
 
+    /** Statistics of the hardware occlusion culling of the last frame. */
+    struct OcclusionStatistics
+    {
+        /// Number of hardware occlusion queries issued
+        size_t queriesIssued;
+        /// Number of octants tested by these queries, hidden octants sharing queries
+        size_t octantsQueried;
+        /// Number of queries whose result wasn't available yet when the frame started
+        size_t queriesPending;
+        /// Number of octants skipped because they were hidden
+        size_t octantsCulled;
+        /// Number of objects in the skipped octants and their children
+        size_t objectsCulled;
+
+        OcclusionStatistics()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            queriesIssued = octantsQueried = queriesPending = 0;
+            octantsCulled = objectsCulled = 0;
+        }
+    };
+
+    /** Enables hardware occlusion culling of the octree for the views of a camera.
+    @remarks
+    This is a coherent hierarchical occlusion culling in the spirit of
+    CHC++. The octants of the octree are queried with the solid boxes of
+    their contents, drawn after the visible objects of the frame; the
+    results are only read back the next frame, so that the CPU never waits
+    for the GPU, and a query still outstanding leaves the octant as it was.
+    Octants found hidden are skipped, with all their children, until a
+    query finds them visible again, which makes their children visible
+    too; octants whose children are all hidden become hidden as a whole.
+    Visible octants holding objects are only queried every few frames, see
+    setOcclusionQueryInterval, and octants which stayed hidden for several
+    queries share queries, up to 8 at a time.
+    @par
+    Only the first view of the camera in each frame is occlusion culled,
+    and only if the render system supports hardware occlusion queries.
+    Since the results are one frame late, objects which become visible may
+    appear one frame late.
+    @param cam The camera, or 0 to disable occlusion culling, which is the default.
+    */
+    void setOcclusionCullingCamera( Camera *cam );
+
+    /** Returns the camera occlusion culling is made for, if any. */
+    Camera *getOcclusionCullingCamera( void ) const
+    {
+        return mOcclusionCamera;
+    }
+
+    /** Sets the number of frames after which visible octants are queried again.
+    @remarks
+    The queries of octants which become visible at the same time are spread
+    over that many frames. The default is 8.
+    */
+    void setOcclusionQueryInterval( unsigned int frames );
+
+    /** Returns the number of frames after which visible octants are queried again. */
+    unsigned int getOcclusionQueryInterval( void ) const
+    {
+        return mOcclusionQueryInterval;
+    }
+
+    /** Returns the statistics of the occlusion culling of the last frame. */
+    const OcclusionStatistics &getOcclusionStatistics( void ) const
+    {
+        return mOcclusionStats;
+    }
+
     /** Sets the given option for the SceneManager
                @remarks
         Options are:
         "Size", AxisAlignedBox *;
         "Depth", int *;
         "ShowOctree", bool *;
+        "OcclusionCullingCamera", Camera *;
+        "OcclusionQueryInterval", unsigned int *;
+    @par
+        In addition "OcclusionStatistics", OcclusionStatistics *, can be read
+        with getOption.
     */
 
     virtual bool setOption( const String &, const void * );
@@ -181,13 +276,94 @@ public:
     IntersectionSceneQuery* createIntersectionQuery(uint32 mask);
 
 protected:
+    /** Does nothing, the batched queries walk the octree. */
+    void prepareBatchQueries( void );
+    /** Walks the octree once for a packet of batched queries, each octant
+        being tested against the queries which reached its parent.
+    */
+    void executeBatchQueryPacket( size_t first, size_t count );
+    /** Returns the bits of mask whose queries of the packet starting at first hit the box. */
+    uint32 testBatchQueryPacket( const AxisAlignedBox &box, size_t first, uint32 mask ) const;
+    /** Walks an octant with the queries of the packet starting at first whose bits are set in mask. */
+    void walkBatchQueryPacket( Octree *octant, size_t first, uint32 mask );
+    /** Tests an object against the queries of a packet, see walkBatchQueryPacket. */
+    void testBatchQueryObject( MovableObject *object, size_t first, uint32 mask );
+
+    /** Pulls the results of the occlusion queries which are available,
+        updating the octants tested.
+    */
+    void pullOcclusionQueries( void );
+    /** Decides whether an octant in view is skipped because it is hidden,
+        requesting the occlusion queries it needs.
+    */
+    bool cullOccludedOctant( OctreeCamera *camera, Octree *octant );
+    /** Requests a query of an octant, drawn with the box of its contents. */
+    void requestOcclusionQuery( Octree *octant );
+    /** Computes the box of the contents of an octant and its children.
+    @return The number of objects in the octant and its children
+    */
+    size_t getOcclusionBounds( Octree *octant, AxisAlignedBox &box ) const;
+    /** Makes a hidden octant and its children visible. */
+    void setOctantVisible( Octree *octant );
+    /** Makes the parents of a hidden octant hidden while all their children are. */
+    void pullUpOcclusion( Octree *octant );
+    /** Issues the occlusion queries requested by the last octree walk. */
+    void issueOcclusionQueries( void );
+    /** Returns the pass the occlusion query boxes are rendered with. */
+    Pass *getOcclusionQueryPass( void );
+    /** Forgets the occlusion queries in flight, keeping them for reuse. */
+    void releaseOcclusionQueries( void );
+    /** Resets the occlusion state of an octant and its children. */
+    void resetOcclusionState( Octree *octant );
+
+    /// Largest number of hidden octants tested by a single query
+    static const size_t MAX_OCTANTS_PER_QUERY = 8;
+
+    /// Occlusion query in flight, with the octants it tests
+    struct OcclusionQueryBatch
+    {
+        HardwareOcclusionQuery *query;
+        Octree *octants[ MAX_OCTANTS_PER_QUERY ];
+        size_t count;
+    };
+    typedef vector< OcclusionQueryBatch >::type OcclusionQueryBatchList;
 
+    /// Query requested for an octant by the octree walk
+    struct OcclusionQueryRequest
+    {
+        Octree *octant;
+        AxisAlignedBox box;
+    };
+    typedef vector< OcclusionQueryRequest >::type OcclusionQueryRequestList;
+
+    /// Camera occlusion culling is made for
+    Camera *mOcclusionCamera;
+    /// Frames between two queries of a visible octant
+    unsigned int mOcclusionQueryInterval;
+    /// Number of frames occlusion culled so far, from 1 so that octants never visited are out of date
+    unsigned long mOcclusionFrame;
+    /// Root frame number of the last frame occlusion culled
+    unsigned long mOcclusionRootFrame;
+    /// Whether the view being rendered is occlusion culled
+    bool mOcclusionCullingActive;
+    /// Spreads the queries of octants becoming visible together
+    unsigned int mOcclusionQueryOffset;
+    OcclusionStatistics mOcclusionStats;
+    OcclusionQueryBatchList mOcclusionBatches;
+    OcclusionQueryRequestList mOcclusionRequests;
+    /// Queries whose results were read, for reuse
+    vector< HardwareOcclusionQuery * >::type mFreeOcclusionQueries;
+    OctreeOcclusionBox *mOcclusionBox;
+    Pass *mOcclusionPass;
 
     Octree::NodeList mVisible;
 
     /// The root octree
     Octree *mOctree;
 
+    /// Serialises octree changes made by nodes updated from several threads
+    OGRE_MUTEX(mOctreeUpdateMutex);
+
     /// List of boxes to be rendered
     BoxList mBoxes;
 
@@ -0,0 +1,105 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreOctreeOcclusionBox.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreCamera.h"
+
+namespace Ogre
+{
+
+OctreeOcclusionBox::OctreeOcclusionBox() : mRadius( 0 )
+{
+    mRenderOp.vertexData = OGRE_NEW VertexData();
+    mRenderOp.vertexData->vertexCount = 8;
+    mRenderOp.vertexData->vertexStart = 0;
+    mRenderOp.indexData = OGRE_NEW IndexData();
+    mRenderOp.indexData->indexCount = 36;
+    mRenderOp.indexData->indexStart = 0;
+    mRenderOp.operationType = RenderOperation::OT_TRIANGLE_LIST;
+    mRenderOp.useIndexes = true;
+    mRenderOp.useGlobalInstancingVertexBufferIsAvailable = false;
+
+    VertexDeclaration *decl = mRenderOp.vertexData->vertexDeclaration;
+    decl->addElement( 0, 0, VET_FLOAT3, VES_POSITION );
+
+    HardwareVertexBufferSharedPtr vbuf =
+        HardwareBufferManager::getSingleton().createVertexBuffer(
+            decl->getVertexSize( 0 ), 8, HardwareBuffer::HBU_STATIC_WRITE_ONLY );
+    mRenderOp.vertexData->vertexBufferBinding->setBinding( 0, vbuf );
+
+    // corner i has its x, y and z at +0.5 when bits 0, 1 and 2 are set
+    float vertices[ 24 ];
+    for ( int i = 0; i < 8; ++i )
+    {
+        vertices[ i * 3 + 0 ] = ( i & 1 ) ? 0.5f : -0.5f;
+        vertices[ i * 3 + 1 ] = ( i & 2 ) ? 0.5f : -0.5f;
+        vertices[ i * 3 + 2 ] = ( i & 4 ) ? 0.5f : -0.5f;
+    }
+    vbuf->writeData( 0, vbuf->getSizeInBytes(), vertices, true );
+
+    static const uint16 indexes[ 36 ] = {
+        0, 2, 3, 0, 3, 1,       // -z
+        4, 5, 7, 4, 7, 6,       // +z
+        0, 4, 6, 0, 6, 2,       // -x
+        1, 3, 7, 1, 7, 5,       // +x
+        0, 1, 5, 0, 5, 4,       // -y
+        2, 6, 7, 2, 7, 3 };     // +y
+    mRenderOp.indexData->indexBuffer =
+        HardwareBufferManager::getSingleton().createIndexBuffer(
+            HardwareIndexBuffer::IT_16BIT, 36, HardwareBuffer::HBU_STATIC_WRITE_ONLY );
+    mRenderOp.indexData->indexBuffer->writeData(
+        0, mRenderOp.indexData->indexBuffer->getSizeInBytes(), indexes, true );
+}
+
+OctreeOcclusionBox::~OctreeOcclusionBox()
+{
+    OGRE_DELETE mRenderOp.vertexData;
+    OGRE_DELETE mRenderOp.indexData;
+}
+
+void OctreeOcclusionBox::setupBox( const AxisAlignedBox &box )
+{
+    Matrix4 xform;
+    xform.makeTransform( box.getCenter(), box.getSize(), Quaternion::IDENTITY );
+    setTransform( xform );
+    setBoundingBox( box );
+    mRadius = box.getHalfSize().length();
+}
+
+void OctreeOcclusionBox::getWorldTransforms( Matrix4 *xform ) const
+{
+    *xform = mTransform;
+}
+
+Real OctreeOcclusionBox::getSquaredViewDepth( const Camera *cam ) const
+{
+    return ( mBox.getCenter() - cam->getDerivedPosition() ).squaredLength();
+}
+
+}
@@ -38,7 +38,16 @@ email                : janders@users.sf.net
 #include "OgreOctreeSceneQuery.h"
 #include "OgreOctreeNode.h"
 #include "OgreOctreeCamera.h"
+#include "OgreOctreeOcclusionBox.h"
 #include "OgreWireBoundingBox.h"
+#include "OgreEntity.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+#include "OgreRenderSystemCapabilities.h"
+#include "OgreHardwareOcclusionQuery.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
 
 extern "C"
 {
@@ -291,6 +300,9 @@ unsigned long OctreeSceneManager::mColors[ 8 ] = {white, white, white, white, wh
 
 
 OctreeSceneManager::OctreeSceneManager(const String& name) : SceneManager(name)
+    , mOcclusionCamera( 0 ), mOcclusionQueryInterval( 8 ), mOcclusionFrame( 1 ),
+      mOcclusionRootFrame( ~0UL ), mOcclusionCullingActive( false ), mOcclusionQueryOffset( 0 ),
+      mOcclusionBox( 0 ), mOcclusionPass( 0 )
 {
     AxisAlignedBox b( -10000, -10000, -10000, 10000, 10000, 10000 );
     int depth = 8; 
@@ -300,6 +312,9 @@ OctreeSceneManager::OctreeSceneManager(const String& name) : SceneManager(name)
 
 OctreeSceneManager::OctreeSceneManager(const String& name, AxisAlignedBox &box, int max_depth ) 
 : SceneManager(name)
+    , mOcclusionCamera( 0 ), mOcclusionQueryInterval( 8 ), mOcclusionFrame( 1 ),
+      mOcclusionRootFrame( ~0UL ), mOcclusionCullingActive( false ), mOcclusionQueryOffset( 0 ),
+      mOcclusionBox( 0 ), mOcclusionPass( 0 )
 {
     mOctree = 0;
     init( box, max_depth );
@@ -313,6 +328,9 @@ const String& OctreeSceneManager::getTypeName(void) const
 void OctreeSceneManager::init( AxisAlignedBox &box, int depth )
 {
 
+    // the octants tested by the queries in flight are about to go
+    releaseOcclusionQueries();
+
     if ( mOctree != 0 )
         OGRE_DELETE mOctree;
 
@@ -350,6 +368,11 @@ void OctreeSceneManager::init( AxisAlignedBox &box, int depth )
 
 OctreeSceneManager::~OctreeSceneManager()
 {
+    releaseOcclusionQueries();
+    for ( size_t i = 0; i < mFreeOcclusionQueries.size(); ++i )
+        mDestRenderSystem->destroyHardwareOcclusionQuery( mFreeOcclusionQueries[ i ] );
+    mFreeOcclusionQueries.clear();
+    OGRE_DELETE mOcclusionBox;
 
     if ( mOctree )
     {
@@ -388,6 +411,14 @@ void OctreeSceneManager::destroySceneNode( const String &name )
     SceneManager::destroySceneNode( name );
 }
 
+void OctreeSceneManager::destroyCamera( const String &name )
+{
+    if ( mOcclusionCamera && mOcclusionCamera->getName() == name )
+        setOcclusionCullingCamera( 0 );
+
+    SceneManager::destroyCamera( name );
+}
+
 bool OctreeSceneManager::getOptionValues( const String & key, StringVector  &refValueList )
 {
     return SceneManager::getOptionValues( key, refValueList );
@@ -399,6 +430,8 @@ bool OctreeSceneManager::getOptionKeys( StringVector & refKeys )
     refKeys.push_back( "Size" );
     refKeys.push_back( "ShowOctree" );
     refKeys.push_back( "Depth" );
+    refKeys.push_back( "OcclusionCullingCamera" );
+    refKeys.push_back( "OcclusionQueryInterval" );
 
     return true;
 }
@@ -417,6 +450,8 @@ void OctreeSceneManager::_updateOctreeNode( OctreeNode * onode )
 
     if ( onode -> getOctant() == 0 )
     {
+        OGRE_LOCK_MUTEX(mOctreeUpdateMutex);
+
         //if outside the octree, force into the root node.
         if ( ! onode -> _isIn( mOctree -> mBox ) )
             mOctree->_addNode( onode );
@@ -427,6 +462,8 @@ void OctreeSceneManager::_updateOctreeNode( OctreeNode * onode )
 
     if ( ! onode -> _isIn( onode -> getOctant() -> mBox ) )
     {
+        OGRE_LOCK_MUTEX(mOctreeUpdateMutex);
+
         _removeOctreeNode( onode );
 
         //if outside the octree, force into the root node.
@@ -572,9 +609,43 @@ void OctreeSceneManager::_findVisibleObjects(Camera * cam,
 
     mNumObjects = 0;
 
-    //walk the octree, adding all visible Octreenodes nodes to the render queue.
-    walkOctree( static_cast < OctreeCamera * > ( cam ), getRenderQueue(), mOctree, 
-                visibleBounds, false, onlyShadowCasters );
+    // only the first view of the occlusion culling camera in a frame is
+    // occlusion culled, the queries being issued once it has been rendered
+    mOcclusionCullingActive = false;
+    mOcclusionRequests.clear();
+    if ( cam == mOcclusionCamera && !onlyShadowCasters && mIlluminationStage != IRS_RENDER_TO_TEXTURE &&
+         mDestRenderSystem && mDestRenderSystem->getCapabilities()->hasCapability( RSC_HWOCCLUSION ) )
+    {
+        unsigned long rootFrame = Root::getSingleton().getNextFrameNumber();
+        if ( rootFrame != mOcclusionRootFrame )
+        {
+            mOcclusionRootFrame = rootFrame;
+            ++mOcclusionFrame;
+            mOcclusionCullingActive = true;
+            pullOcclusionQueries();
+        }
+    }
+
+    if ( getCullingThreadCount() > 1 )
+    {
+        // walk the octree gathering the visible nodes, whose objects are then
+        // queued by several threads
+        walkOctree( static_cast < OctreeCamera * > ( cam ), 0, mOctree, 
+                    visibleBounds, false, onlyShadowCasters );
+
+        mVisibleObjectsItems.clear();
+        for ( Octree::NodeList::iterator it = mVisible.begin(); it != mVisible.end(); ++it )
+        {
+            mVisibleObjectsItems.push_back( VisibleObjectsItem( *it, false ) );
+        }
+        findVisibleObjectsParallel( cam, visibleBounds, onlyShadowCasters );
+    }
+    else
+    {
+        //walk the octree, adding all visible Octreenodes nodes to the render queue.
+        walkOctree( static_cast < OctreeCamera * > ( cam ), getRenderQueue(), mOctree, 
+                    visibleBounds, false, onlyShadowCasters );
+    }
 
     // Show the octree boxes & cull camera if required
     if ( mShowBoxes )
@@ -618,44 +689,63 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
     // if the octant is visible, or if it's the root node...
     if ( v != OctreeCamera::NONE )
     {
+        // skip the octants hidden last time they were queried
+        if ( mOcclusionCullingActive && octant != mOctree && cullOccludedOctant( camera, octant ) )
+            return ;
 
         //Add stuff to be rendered;
         Octree::NodeList::iterator it = octant -> mNodes.begin();
+        Octree::NodeList::iterator itend = octant -> mNodes.end();
 
         if ( mShowBoxes )
         {
             mBoxes.push_back( octant->getWireBoundingBox() );
         }
 
-        bool vis = true;
+        // nodes are culled a batch at a time
+        const size_t batchSize = 32;
+        OctreeNode * nodes[ batchSize ];
+        const AxisAlignedBox * bounds[ batchSize ];
+        bool vis[ batchSize ];
 
-        while ( it != octant -> mNodes.end() )
+        while ( it != itend )
         {
-            OctreeNode * sn = *it;
+            size_t count = 0;
+            for ( ; it != itend && count < batchSize; ++it, ++count )
+            {
+                nodes[ count ] = *it;
+                bounds[ count ] = &nodes[ count ] -> _getWorldAABB();
+            }
 
             // if this octree is partially visible, manually cull all
             // scene nodes attached directly to this level.
 
             if ( v == OctreeCamera::PARTIAL )
-                vis = camera -> isVisible( sn -> _getWorldAABB() );
+                camera -> areVisible( bounds, count, vis );
+            else
+                std::fill( vis, vis + count, true );
 
-            if ( vis )
+            for ( size_t i = 0; i < count; ++i )
             {
+                if ( !vis[ i ] )
+                    continue;
+
+                OctreeNode * sn = nodes[ i ];
 
                 mNumObjects++;
-                sn -> _addToRenderQueue(camera, queue, onlyShadowCasters, visibleBounds );
+                // without a queue the nodes are only gathered in mVisible
+                if ( queue )
+                    sn -> _addToRenderQueue(camera, queue, onlyShadowCasters, visibleBounds );
 
                 mVisible.push_back( sn );
 
                 if ( mDisplayNodes )
-                    queue -> addRenderable( sn->getDebugRenderable() );
+                    getRenderQueue() -> addRenderable( sn->getDebugRenderable() );
 
                 // check if the scene manager or this node wants the bounding box shown.
                 if (sn->getShowBoundingBox() || mShowBoundingBoxes)
-                    sn->_addBoundingBoxToQueue(queue);
+                    sn->_addBoundingBoxToQueue(getRenderQueue());
             }
-
-            ++it;
         }
 
         Octree* child;
@@ -688,6 +778,340 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
 
 }
 
+void OctreeSceneManager::findVisibleObjectsInItem( const VisibleObjectsItem& item, Camera* cam, 
+    RenderQueue* queue, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters )
+{
+    static_cast < OctreeNode * > ( item.first ) -> _addToRenderQueue( cam, queue, 
+        onlyShadowCasters, visibleBounds );
+}
+
+void OctreeSceneManager::_renderVisibleObjects( void )
+{
+    SceneManager::_renderVisibleObjects();
+
+    // the depth buffer now holds the visible objects of the frame
+    if ( mOcclusionCullingActive )
+    {
+        issueOcclusionQueries();
+        mOcclusionCullingActive = false;
+    }
+}
+
+void OctreeSceneManager::setOcclusionCullingCamera( Camera *cam )
+{
+    if ( cam == mOcclusionCamera )
+        return ;
+
+    // what was found hidden from the previous camera says nothing for this one
+    releaseOcclusionQueries();
+    resetOcclusionState( mOctree );
+    mOcclusionCamera = cam;
+    mOcclusionStats.reset();
+}
+
+void OctreeSceneManager::setOcclusionQueryInterval( unsigned int frames )
+{
+    mOcclusionQueryInterval = std::max( frames, 1u );
+}
+
+void OctreeSceneManager::pullOcclusionQueries( void )
+{
+    mOcclusionStats.reset();
+
+    size_t outstanding = 0;
+    for ( size_t i = 0; i < mOcclusionBatches.size(); ++i )
+    {
+        OcclusionQueryBatch &batch = mOcclusionBatches[ i ];
+
+        // never wait for the GPU, the octants stay as they were meanwhile
+        if ( batch.query->isStillOutstanding() )
+        {
+            mOcclusionBatches[ outstanding++ ] = batch;
+            continue;
+        }
+
+        unsigned int samples = 0;
+        batch.query->pullOcclusionQuery( &samples );
+        mFreeOcclusionQueries.push_back( batch.query );
+
+        for ( size_t j = 0; j < batch.count; ++j )
+        {
+            Octree *octant = batch.octants[ j ];
+            Octree::OcclusionState &state = octant->mOcclusion;
+            state.pending = false;
+
+            // a visible query of several octants makes all of them visible,
+            // to be queried on their own
+            if ( samples > 0 )
+            {
+                if ( state.occluded )
+                    setOctantVisible( octant );
+                state.occludedCount = 0;
+
+                // and so are its parents, hidden meanwhile
+                for ( Octree *parent = octant->_getParent(); parent && parent->mOcclusion.occluded;
+                      parent = parent->_getParent() )
+                {
+                    parent->mOcclusion.occluded = false;
+                    parent->mOcclusion.occludedCount = 0;
+                }
+            }
+            else
+            {
+                state.occluded = true;
+                ++state.occludedCount;
+                pullUpOcclusion( octant );
+            }
+        }
+    }
+    mOcclusionBatches.resize( outstanding );
+    mOcclusionStats.queriesPending = outstanding;
+}
+
+bool OctreeSceneManager::cullOccludedOctant( OctreeCamera *camera, Octree *octant )
+{
+    Octree::OcclusionState &state = octant->mOcclusion;
+
+    // the state of an octant out of view last frame is out of date, so it's
+    // assumed visible and queried straight away
+    bool outdated = state.lastVisitedFrame + 1 != mOcclusionFrame;
+    state.lastVisitedFrame = mOcclusionFrame;
+    if ( outdated )
+        state.occluded = false;
+
+    // the box of an octant around the camera can't hide it
+    AxisAlignedBox box;
+    octant -> _getCullBounds( &box );
+    Vector3 margin = Vector3::UNIT_SCALE * camera->getNearClipDistance();
+    box.setExtents( box.getMinimum() - margin, box.getMaximum() + margin );
+    if ( box.contains( camera->getDerivedPosition() ) )
+    {
+        state.occluded = false;
+        return false;
+    }
+
+    if ( state.occluded )
+    {
+        // hidden octants are queried every frame to find out when they show up
+        ++mOcclusionStats.octantsCulled;
+        mOcclusionStats.objectsCulled += state.objectCount;
+        if ( !state.pending )
+            requestOcclusionQuery( octant );
+        return true;
+    }
+
+    // visible octants holding objects are queried now and then to find out
+    // when they become hidden, the others follow their children
+    bool leaf = octant->numNodes() == static_cast < int > ( octant->mNodes.size() );
+    if ( !state.pending && ( leaf || !octant->mNodes.empty() ) &&
+         ( outdated || mOcclusionFrame - state.lastQueriedFrame >= mOcclusionQueryInterval ) )
+        requestOcclusionQuery( octant );
+
+    return false;
+}
+
+void OctreeSceneManager::requestOcclusionQuery( Octree *octant )
+{
+    OcclusionQueryRequest request;
+    request.octant = octant;
+    octant->mOcclusion.objectCount = getOcclusionBounds( octant, request.box );
+
+    // an infinite box hides nothing, an empty one has nothing to hide
+    if ( request.box.isInfinite() )
+        octant->mOcclusion.occluded = false;
+    else if ( !request.box.isNull() )
+        mOcclusionRequests.push_back( request );
+}
+
+size_t OctreeSceneManager::getOcclusionBounds( Octree *octant, AxisAlignedBox &box ) const
+{
+    size_t objects = 0;
+    for ( Octree::NodeList::iterator it = octant->mNodes.begin(); it != octant->mNodes.end(); ++it )
+    {
+        box.merge( ( *it )->_getWorldAABB() );
+        objects += ( *it )->numAttachedObjects();
+    }
+
+    for ( int i = 0; i < 2; ++i )
+    {
+        for ( int j = 0; j < 2; ++j )
+        {
+            for ( int k = 0; k < 2; ++k )
+            {
+                Octree *child = octant->mChildren[ i ][ j ][ k ];
+                if ( child && child->numNodes() != 0 )
+                    objects += getOcclusionBounds( child, box );
+            }
+        }
+    }
+    return objects;
+}
+
+void OctreeSceneManager::setOctantVisible( Octree *octant )
+{
+    Octree::OcclusionState &state = octant->mOcclusion;
+    state.occluded = false;
+    state.occludedCount = 0;
+    // spread the next queries of the octants showing up together
+    state.lastQueriedFrame = mOcclusionFrame - ( mOcclusionQueryOffset++ % mOcclusionQueryInterval );
+
+    for ( int i = 0; i < 2; ++i )
+    {
+        for ( int j = 0; j < 2; ++j )
+        {
+            for ( int k = 0; k < 2; ++k )
+            {
+                Octree *child = octant->mChildren[ i ][ j ][ k ];
+                if ( child && child->mOcclusion.occluded )
+                    setOctantVisible( child );
+            }
+        }
+    }
+}
+
+void OctreeSceneManager::pullUpOcclusion( Octree *octant )
+{
+    // the root is always traversed, and an octant holding objects is only
+    // hidden when its own query says so
+    for ( Octree *parent = octant->_getParent(); parent && parent != mOctree;
+          parent = parent->_getParent() )
+    {
+        if ( parent->mOcclusion.occluded || !parent->mNodes.empty() )
+            return ;
+
+        size_t objects = 0;
+        unsigned int occludedCount = ~0u;
+        for ( int i = 0; i < 2; ++i )
+        {
+            for ( int j = 0; j < 2; ++j )
+            {
+                for ( int k = 0; k < 2; ++k )
+                {
+                    Octree *child = parent->mChildren[ i ][ j ][ k ];
+                    if ( !child || child->numNodes() == 0 )
+                        continue;
+                    if ( !child->mOcclusion.occluded )
+                        return ;
+                    objects += child->mOcclusion.objectCount;
+                    occludedCount = std::min( occludedCount, child->mOcclusion.occludedCount );
+                }
+            }
+        }
+
+        parent->mOcclusion.occluded = true;
+        parent->mOcclusion.occludedCount = occludedCount;
+        parent->mOcclusion.objectCount = objects;
+    }
+}
+
+void OctreeSceneManager::issueOcclusionQueries( void )
+{
+    if ( mOcclusionRequests.empty() )
+        return ;
+
+    if ( !mOcclusionBox )
+        mOcclusionBox = OGRE_NEW OctreeOcclusionBox();
+    Pass *pass = getOcclusionQueryPass();
+
+    size_t i = 0;
+    while ( i < mOcclusionRequests.size() )
+    {
+        OcclusionQueryBatch batch;
+        batch.count = 0;
+
+        // octants which stayed hidden for a while will likely stay so, and
+        // share a query with their neighbours in the walk
+        do
+        {
+            batch.octants[ batch.count++ ] = mOcclusionRequests[ i++ ].octant;
+        }
+        while ( batch.octants[ 0 ]->mOcclusion.occludedCount > 1 && batch.count < MAX_OCTANTS_PER_QUERY &&
+                i < mOcclusionRequests.size() && mOcclusionRequests[ i ].octant->mOcclusion.occludedCount > 1 );
+
+        if ( mFreeOcclusionQueries.empty() )
+        {
+            batch.query = mDestRenderSystem->createHardwareOcclusionQuery();
+        }
+        else
+        {
+            batch.query = mFreeOcclusionQueries.back();
+            mFreeOcclusionQueries.pop_back();
+        }
+
+        batch.query->beginOcclusionQuery();
+        for ( size_t j = i - batch.count; j < i; ++j )
+        {
+            mOcclusionBox->setupBox( mOcclusionRequests[ j ].box );
+            _injectRenderWithPass( pass, mOcclusionBox, false );
+
+            Octree::OcclusionState &state = mOcclusionRequests[ j ].octant->mOcclusion;
+            state.pending = true;
+            state.lastQueriedFrame = mOcclusionFrame;
+        }
+        batch.query->endOcclusionQuery();
+
+        mOcclusionBatches.push_back( batch );
+        ++mOcclusionStats.queriesIssued;
+        mOcclusionStats.octantsQueried += batch.count;
+    }
+
+    mOcclusionRequests.clear();
+}
+
+Pass *OctreeSceneManager::getOcclusionQueryPass( void )
+{
+    if ( !mOcclusionPass )
+    {
+        static const String name = "Octree/OcclusionQuery";
+        MaterialPtr mat = MaterialManager::getSingleton().getByName(
+            name, ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME );
+        if ( mat.isNull() )
+        {
+            mat = MaterialManager::getSingleton().create(
+                name, ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME );
+            // the boxes are only depth tested
+            Pass *pass = mat->getTechnique( 0 )->getPass( 0 );
+            pass->setLightingEnabled( false );
+            pass->setDepthWriteEnabled( false );
+            pass->setColourWriteEnabled( false );
+            pass->setCullingMode( CULL_NONE );
+            pass->setManualCullingMode( MANUAL_CULL_NONE );
+            pass->setFog( true, FOG_NONE );
+        }
+        mat->load();
+        mOcclusionPass = mat->getTechnique( 0 )->getPass( 0 );
+    }
+    return mOcclusionPass;
+}
+
+void OctreeSceneManager::releaseOcclusionQueries( void )
+{
+    for ( size_t i = 0; i < mOcclusionBatches.size(); ++i )
+    {
+        for ( size_t j = 0; j < mOcclusionBatches[ i ].count; ++j )
+            mOcclusionBatches[ i ].octants[ j ]->mOcclusion.pending = false;
+        mFreeOcclusionQueries.push_back( mOcclusionBatches[ i ].query );
+    }
+    mOcclusionBatches.clear();
+    mOcclusionRequests.clear();
+}
+
+void OctreeSceneManager::resetOcclusionState( Octree *octant )
+{
+    if ( !octant )
+        return ;
+
+    octant->mOcclusion = Octree::OcclusionState();
+    for ( int i = 0; i < 2; ++i )
+    {
+        for ( int j = 0; j < 2; ++j )
+        {
+            for ( int k = 0; k < 2; ++k )
+                resetOcclusionState( octant->mChildren[ i ][ j ][ k ] );
+        }
+    }
+}
+
 // --- non template versions
 void _findNodes( const AxisAlignedBox &t, list< SceneNode * >::type &list, SceneNode *exclude, bool full, Octree *octant )
 {
@@ -1002,6 +1426,90 @@ void OctreeSceneManager::findNodesIn( const Ray &r, list< SceneNode * >::type &l
     _findNodes( r, list, exclude, false, mOctree );
 }
 
+void OctreeSceneManager::prepareBatchQueries( void )
+{
+    // the objects are found through the octree rather than gathered up front
+}
+
+void OctreeSceneManager::executeBatchQueryPacket( size_t first, size_t count )
+{
+    const uint32 all = count < 32 ? ( static_cast< uint32 >( 1 ) << count ) - 1 : 0xFFFFFFFF;
+    walkBatchQueryPacket( mOctree, first, all );
+}
+
+uint32 OctreeSceneManager::testBatchQueryPacket( const AxisAlignedBox &box, size_t first, uint32 mask ) const
+{
+    uint32 result = 0;
+    Real distance;
+    for ( size_t i = 0; mask; ++i, mask >>= 1 )
+    {
+        if ( ( mask & 1 ) && testBatchQuery( first + i, box, distance ) )
+            result |= static_cast< uint32 >( 1 ) << i;
+    }
+    return result;
+}
+
+void OctreeSceneManager::walkBatchQueryPacket( Octree *octant, size_t first, uint32 mask )
+{
+    // the octant is tested once for all the queries which reached its parent
+    AxisAlignedBox obox;
+    octant -> _getCullBounds( &obox );
+    mask = testBatchQueryPacket( obox, first, mask );
+    if ( !mask )
+        return;
+
+    for ( Octree::NodeList::iterator it = octant -> mNodes.begin(); it != octant -> mNodes.end(); ++it )
+    {
+        uint32 nodeMask = testBatchQueryPacket( ( *it ) -> _getWorldAABB(), first, mask );
+        if ( !nodeMask )
+            continue;
+
+        SceneNode::ObjectIterator oit = ( *it ) -> getAttachedObjectIterator();
+        while ( oit.hasMoreElements() )
+        {
+            MovableObject * m = oit.getNext();
+            if ( !m -> isInScene() )
+                continue;
+
+            testBatchQueryObject( m, first, nodeMask );
+
+            // deal with attached objects, since they are not directly attached to nodes
+            if ( m -> getMovableType() == "Entity" )
+            {
+                Entity::ChildObjectListIterator childIt = static_cast< Entity * >( m ) -> getAttachedObjectIterator();
+                while ( childIt.hasMoreElements() )
+                {
+                    MovableObject * c = childIt.getNext();
+                    if ( c -> isInScene() )
+                        testBatchQueryObject( c, first, nodeMask );
+                }
+            }
+        }
+    }
+
+    for ( int i = 0; i < 8; ++i )
+    {
+        Octree * child = octant -> mChildren[ i & 1 ][ ( i >> 1 ) & 1 ][ i >> 2 ];
+        if ( child )
+            walkBatchQueryPacket( child, first, mask );
+    }
+}
+
+void OctreeSceneManager::testBatchQueryObject( MovableObject *object, size_t first, uint32 mask )
+{
+    if ( !( object -> getQueryFlags() & mBatchQuery.queryMask ) ||
+        !( object -> getTypeFlags() & mBatchQuery.queryTypeMask ) )
+        return;
+
+    const AxisAlignedBox &box = object -> getWorldBoundingBox();
+    Real distance;
+    for ( size_t i = 0; mask; ++i, mask >>= 1 )
+    {
+        if ( ( mask & 1 ) && testBatchQuery( first + i, box, distance ) )
+            addBatchQueryHit( first + i, object, distance );
+    }
+}
+
 void OctreeSceneManager::resize( const AxisAlignedBox &box )
 {
     list< SceneNode * >::type nodes;
@@ -1009,6 +1517,7 @@ void OctreeSceneManager::resize( const AxisAlignedBox &box )
 
     _findNodes( mOctree->mBox, nodes, 0, true, mOctree );
 
+    releaseOcclusionQueries();
     OGRE_DELETE mOctree;
 
     mOctree = OGRE_NEW Octree( 0 );
@@ -1053,6 +1562,18 @@ bool OctreeSceneManager::setOption( const String & key, const void * val )
         return true;
     }
 
+    else if ( key == "OcclusionCullingCamera" )
+    {
+        setOcclusionCullingCamera( const_cast < Camera * > ( static_cast < const Camera * > ( val ) ) );
+        return true;
+    }
+
+    else if ( key == "OcclusionQueryInterval" )
+    {
+        setOcclusionQueryInterval( * static_cast < const unsigned int * > ( val ) );
+        return true;
+    }
+
 
     return SceneManager::setOption( key, val );
 
@@ -1081,6 +1602,24 @@ bool OctreeSceneManager::getOption( const String & key, void *val )
         return true;
     }
 
+    else if ( key == "OcclusionCullingCamera" )
+    {
+        * static_cast < Camera ** > ( val ) = mOcclusionCamera;
+        return true;
+    }
+
+    else if ( key == "OcclusionQueryInterval" )
+    {
+        * static_cast < unsigned int * > ( val ) = mOcclusionQueryInterval;
+        return true;
+    }
+
+    else if ( key == "OcclusionStatistics" )
+    {
+        * static_cast < OcclusionStatistics * > ( val ) = mOcclusionStats;
+        return true;
+    }
+
 
     return SceneManager::getOption( key, val );
 
@@ -74,6 +74,9 @@ namespace Ogre
         /* Overridden isVisible function for aabb */
         virtual bool isVisible( const AxisAlignedBox &bound, FrustumPlane *culledBy=0) const;
 
+        /* Overridden areVisible function, checking the extra culling planes too */
+        virtual void areVisible( const AxisAlignedBox* const* bounds, size_t count, bool* visible ) const;
+
         /* isVisible() function for portals */
         bool isVisible(PortalBase* portal, FrustumPlane* culledBy = 0) const;
 
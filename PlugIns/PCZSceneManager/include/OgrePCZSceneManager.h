@@ -144,6 +144,10 @@ namespace Ogre
         /** Update Scene Graph (does several things now) */
         virtual void _updateSceneGraph( Camera * cam );
 
+        /** Overridden from SceneManager, zone membership of PCZSceneNodes is
+            not updated in a thread safe manner. */
+        bool supportsParallelSceneGraphUpdate(void) const { return false; }
+
         /** Recurses through the PCZTree determining which nodes are visible. */
         virtual void _findVisibleObjects ( Camera * cam, 
             VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters );
@@ -66,7 +66,7 @@ namespace Ogre
         /** Standard destructor */
         ~PCZSceneNode();
         void _update(bool updateChildren, bool parentHasChanged);
-        void updateFromParentImpl() const;
+        void derivedTransformUpdated() const;
 
         /** Creates an unnamed new SceneNode as a child of this node.
         @param
@@ -96,9 +96,9 @@ namespace Ogre
         mPrevPosition = mNewPosition;
         mNewPosition = mDerivedPosition;
     }
-    void PCZSceneNode::updateFromParentImpl() const
+    void PCZSceneNode::derivedTransformUpdated() const
     {
-        SceneNode::updateFromParentImpl();
+        SceneNode::derivedTransformUpdated();
         mMoved = true;
     }
     //-----------------------------------------------------------------------
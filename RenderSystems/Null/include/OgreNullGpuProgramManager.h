@@ -0,0 +1,137 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullGpuProgramManager_H__
+#define __NullGpuProgramManager_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreGpuProgram.h"
+#include "OgreGpuProgramManager.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreHighLevelGpuProgramManager.h"
+
+namespace Ogre {
+
+    /** GPU program which is never compiled.
+    @remarks
+        The NullRenderSystem reports the common assembly profiles as
+        supported, so techniques using these programs are supported and
+        their programs are bound, which does nothing but count the bind.
+    */
+    class _OgreNullExport NullGpuProgram : public GpuProgram
+    {
+    public:
+        NullGpuProgram(ResourceManager* creator, const String& name, ResourceHandle handle,
+            const String& group, bool isManual = false, ManualResourceLoader* loader = 0)
+            : GpuProgram(creator, name, handle, group, isManual, loader)
+        {
+        }
+
+    protected:
+        /// @copydoc GpuProgram::loadFromSource
+        void loadFromSource(void) {}
+        /// @copydoc Resource::unloadImpl
+        void unloadImpl(void) {}
+    };
+
+    /** High-level GPU program which is never compiled.
+    @remarks
+        Stands in for the programs of every language the NullRenderSystem
+        registers a NullHighLevelGpuProgramFactory for. The program is its
+        own binding delegate, ignores all its parameters and accepts any
+        named constant, so materials using shaders can be loaded and
+        rendered.
+    */
+    class _OgreNullExport NullHighLevelGpuProgram : public HighLevelGpuProgram
+    {
+    public:
+        NullHighLevelGpuProgram(ResourceManager* creator, const String& name, ResourceHandle handle,
+            const String& group, bool isManual, ManualResourceLoader* loader, const String& language);
+
+        /// @copydoc GpuProgram::getLanguage
+        const String& getLanguage(void) const { return mLanguage; }
+        /// @copydoc GpuProgram::_getBindingDelegate
+        GpuProgram* _getBindingDelegate(void) { return this; }
+        /// @copydoc HighLevelGpuProgram::calculateSize
+        size_t calculateSize(void) const { return 0; }
+
+        /// Overridden from StringInterface, so the parameters of every language are accepted
+        bool setParameter(const String& name, const String& value) { return true; }
+
+    protected:
+        /// @copydoc GpuProgram::loadFromSource
+        void loadFromSource(void) {}
+        /// @copydoc HighLevelGpuProgram::createLowLevelImpl
+        void createLowLevelImpl(void) {}
+        /// @copydoc HighLevelGpuProgram::unloadHighLevelImpl
+        void unloadHighLevelImpl(void) {}
+        /// @copydoc HighLevelGpuProgram::populateParameterNames
+        void populateParameterNames(GpuProgramParametersSharedPtr params);
+        /// @copydoc HighLevelGpuProgram::buildConstantDefinitions
+        void buildConstantDefinitions() const {}
+
+        String mLanguage;
+    };
+
+    /// Factory of NullHighLevelGpuProgram instances for one language
+    class _OgreNullExport NullHighLevelGpuProgramFactory : public HighLevelGpuProgramFactory
+    {
+    public:
+        NullHighLevelGpuProgramFactory(const String& language) : mLanguage(language) {}
+
+        /// @copydoc HighLevelGpuProgramFactory::getLanguage
+        const String& getLanguage(void) const { return mLanguage; }
+        /// @copydoc HighLevelGpuProgramFactory::create
+        HighLevelGpuProgram* create(ResourceManager* creator, const String& name, ResourceHandle handle,
+            const String& group, bool isManual, ManualResourceLoader* loader);
+        /// @copydoc HighLevelGpuProgramFactory::destroy
+        void destroy(HighLevelGpuProgram* prog);
+
+    protected:
+        String mLanguage;
+    };
+
+    /// GpuProgramManager creating NullGpuProgram instances
+    class _OgreNullExport NullGpuProgramManager : public GpuProgramManager
+    {
+    public:
+        NullGpuProgramManager();
+        virtual ~NullGpuProgramManager();
+
+    protected:
+        /// @copydoc ResourceManager::createImpl
+        Resource* createImpl(const String& name, ResourceHandle handle, 
+            const String& group, bool isManual, ManualResourceLoader* loader,
+            const NameValuePairList* createParams);
+        /// Specialised create method with specific parameters
+        Resource* createImpl(const String& name, ResourceHandle handle, 
+            const String& group, bool isManual, ManualResourceLoader* loader,
+            GpuProgramType gptype, const String& syntaxCode);
+    };
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullHardwareBufferManager_H__
+#define __NullHardwareBufferManager_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreDefaultHardwareBufferManager.h"
+
+namespace Ogre {
+
+    /// Software vertex buffer which reports the bytes written into it
+    class _OgreNullExport NullHardwareVertexBuffer : public DefaultHardwareVertexBuffer
+    {
+    protected:
+        NullRenderSystem* mRenderSystem;
+    public:
+        NullHardwareVertexBuffer(HardwareBufferManagerBase* mgr, NullRenderSystem* rs,
+            size_t vertexSize, size_t numVertices, HardwareBuffer::Usage usage);
+        /** See HardwareBuffer. */
+        void writeData(size_t offset, size_t length, const void* pSource,
+                bool discardWholeBuffer = false);
+        /** See HardwareBuffer. */
+        void* lock(size_t offset, size_t length, LockOptions options, UploadOptions uploadOpt = HBU_DEFAULT);
+    };
+
+    /// Software index buffer which reports the bytes written into it
+    class _OgreNullExport NullHardwareIndexBuffer : public DefaultHardwareIndexBuffer
+    {
+    protected:
+        NullRenderSystem* mRenderSystem;
+    public:
+        NullHardwareIndexBuffer(NullRenderSystem* rs, IndexType idxType, size_t numIndexes, 
+            HardwareBuffer::Usage usage);
+        /** See HardwareBuffer. */
+        void writeData(size_t offset, size_t length, const void* pSource,
+                bool discardWholeBuffer = false);
+        /** See HardwareBuffer. */
+        void* lock(size_t offset, size_t length, LockOptions options, UploadOptions uploadOpt = HBU_DEFAULT);
+    };
+
+    /** Buffer manager base for the NullRenderSystem.
+    @remarks
+        Buffers are emulated in system memory exactly like
+        DefaultHardwareBufferManagerBase, but every write or writable lock
+        is reported to the render system as uploaded bytes.
+    */
+    class _OgreNullExport NullHardwareBufferManagerBase : public DefaultHardwareBufferManagerBase
+    {
+    protected:
+        NullRenderSystem* mRenderSystem;
+    public:
+        NullHardwareBufferManagerBase(NullRenderSystem* rs);
+        /// Creates a vertex buffer
+        HardwareVertexBufferSharedPtr 
+            createVertexBuffer(size_t vertexSize, size_t numVerts, 
+                HardwareBuffer::Usage usage, bool useShadowBuffer = false);
+        /// Create a hardware index buffer
+        HardwareIndexBufferSharedPtr 
+            createIndexBuffer(HardwareIndexBuffer::IndexType itype, size_t numIndexes, 
+                HardwareBuffer::Usage usage, bool useShadowBuffer = false);
+    };
+
+    /// NullHardwareBufferManagerBase as a Singleton
+    class _OgreNullExport NullHardwareBufferManager : public HardwareBufferManager
+    {
+    public:
+        NullHardwareBufferManager(NullRenderSystem* rs)
+            : HardwareBufferManager(OGRE_NEW NullHardwareBufferManagerBase(rs)) 
+        {
+
+        }
+        ~NullHardwareBufferManager()
+        {
+            OGRE_DELETE mImpl;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,78 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullHardwarePixelBuffer_H__
+#define __NullHardwarePixelBuffer_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreStringVector.h"
+
+namespace Ogre {
+
+    /** Pixel buffer of a NullTexture.
+    @remarks
+        No pixel data is kept; locks hand out a zeroed scratch area which is
+        discarded again on unlock, and uploads are only counted. Render
+        target textures create one NullRenderTexture per slice.
+    */
+    class _OgreNullExport NullHardwarePixelBuffer : public HardwarePixelBuffer
+    {
+    public:
+        NullHardwarePixelBuffer(NullRenderSystem* rs, const String& baseName, 
+            uint32 width, uint32 height, uint32 depth, PixelFormat format, 
+            HardwareBuffer::Usage usage);
+        ~NullHardwarePixelBuffer();
+
+        /// @copydoc HardwarePixelBuffer::blitFromMemory
+        void blitFromMemory(const PixelBox &src, const Image::Box &dstBox);
+        /// @copydoc HardwarePixelBuffer::blitToMemory
+        void blitToMemory(const Image::Box &srcBox, const PixelBox &dst);
+        /// @copydoc HardwarePixelBuffer::getRenderTarget
+        RenderTexture* getRenderTarget(size_t slice = 0);
+        /// Notify that a slice render target has been destroyed elsewhere
+        void _clearSliceRTT(size_t zoffset);
+
+    protected:
+        /// @copydoc HardwarePixelBuffer::lockImpl
+        PixelBox lockImpl(const Image::Box &lockBox, LockOptions options);
+        /// @copydoc HardwareBuffer::unlockImpl
+        void unlockImpl(void);
+
+        NullRenderSystem* mRenderSystem;
+        /// Scratch memory handed out by the current lock
+        uint8* mScratch;
+        /// Whether the current lock may have been written to
+        bool mScratchWritable;
+
+        typedef vector<RenderTexture*>::type SliceTRT;
+        SliceTRT mSliceTRT;
+        StringVector mSliceTRTNames;
+    };
+}
+
+#endif
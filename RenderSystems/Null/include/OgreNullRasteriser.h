@@ -0,0 +1,89 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullRasteriser_H__
+#define __NullRasteriser_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreMatrix4.h"
+#include "OgreVector4.h"
+#include "OgreCommon.h"
+
+namespace Ogre {
+
+    /** Coarse software depth rasteriser of the NullRenderSystem.
+    @remarks
+        Triangles are rasterised into a single depth buffer of RESOLUTION
+        by RESOLUTION samples covering the whole viewport, whatever its
+        size, so that occlusion queries can be answered without a GPU. Only
+        the position of the vertices, the world, view and projection
+        matrices and the depth buffer state are taken into account:
+        vertex programs, culling and colour writes are ignored. The result
+        only depends on the geometry submitted, which makes the answers of
+        the queries deterministic.
+    */
+    class _OgreNullExport NullRasteriser : public RenderSysAlloc
+    {
+    public:
+        /// Number of depth samples along each side of the viewport
+        static const size_t RESOLUTION = 128;
+
+        NullRasteriser();
+
+        /** Sets every sample of the depth buffer to depth, in [0,1]. */
+        void clearDepth(Real depth);
+        /** Sets the transform from the vertex positions to clip space. */
+        void setTransform(const Matrix4& worldViewProj) { mTransform = worldViewProj; }
+        /** Sets the depth buffer state used by the triangles rasterised next. */
+        void setDepthState(bool check, bool write, CompareFunction func);
+
+        /** Rasterises the triangles of an operation.
+        @return
+            The number of samples which passed the depth test.
+        */
+        size_t rasterise(const RenderOperation& op);
+
+    protected:
+        /** Clips a triangle, in clip space, against the near plane and
+            rasterises what is left. */
+        size_t rasteriseClipped(const Vector4& a, const Vector4& b, const Vector4& c);
+        /** Rasterises a triangle in sample space, z being the depth. */
+        size_t rasteriseTriangle(const Vector3& a, const Vector3& b, const Vector3& c);
+        /** Projects a clip space position into sample space. */
+        Vector3 toSampleSpace(const Vector4& p) const;
+
+        vector<float>::type mDepth;
+        /// Clip space positions of the vertices of the operation being rasterised
+        vector<Vector4>::type mClipPositions;
+        Matrix4 mTransform;
+        bool mDepthCheck;
+        bool mDepthWrite;
+        CompareFunction mDepthFunc;
+    };
+}
+
+#endif
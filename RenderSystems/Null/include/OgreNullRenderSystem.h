@@ -0,0 +1,371 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullRenderSystem_H__
+#define __NullRenderSystem_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreRenderSystem.h"
+#include "OgreAtomicScalar.h"
+#include "OgreNullRasteriser.h"
+
+namespace Ogre {
+
+    /** Counters recorded by the NullRenderSystem for a single frame.
+    @remarks
+        A frame ends whenever Root swaps the render target buffers, at
+        which point the running counters become the 'last frame' counters
+        and start again from zero.
+    */
+    struct _OgreNullExport NullFrameStats
+    {
+        /// Number of _render calls
+        size_t drawCalls;
+        /// Number of primitives submitted, as counted by RenderSystem::_render
+        size_t primitives;
+        /// Number of vertices submitted
+        size_t vertices;
+        /// Number of render state changes of any kind
+        size_t stateChanges;
+        /// Number of texture units bound or unbound
+        size_t textureBinds;
+        /// Number of GPU programs bound or unbound
+        size_t gpuProgramBinds;
+        /// Number of GPU program parameter uploads
+        size_t parameterBinds;
+        /// Number of times the active render target changed
+        size_t renderTargetChanges;
+        /// Number of frame buffer clears
+        size_t clears;
+        /// Number of bytes written into vertex, index and pixel buffers
+        size_t bytesUploaded;
+
+        NullFrameStats() { reset(); }
+
+        void reset()
+        {
+            drawCalls = primitives = vertices = stateChanges = textureBinds = 0;
+            gpuProgramBinds = parameterBinds = renderTargetChanges = clears = 0;
+            bytesUploaded = 0;
+        }
+    };
+
+    /** Headless implementation of RenderSystem.
+    @remarks
+        This render system does not talk to any graphics API. Render windows
+        are off-screen surfaces with no backing storage, hardware buffers are
+        software emulated and every state change and draw call is merely
+        counted. It exists so that the CPU side of the engine (scene
+        traversal, culling, queueing, animation and resource loading) can be
+        run and measured on machines without a GPU or display.
+    @par
+        Vertex, fragment and geometry programs are reported as supported in
+        the common assembly profiles and in the GLSL, HLSL and Cg
+        languages, through NullGpuProgram and NullHighLevelGpuProgram
+        instances which are never compiled. Materials therefore use their
+        shader techniques, and compositors and shader based shadows run,
+        with every program bind counted like the other state changes.
+    @par
+        When the "Occlusion Queries" config option is set to "Yes", which
+        also reports RSC_HWOCCLUSION, the triangles drawn are also
+        rasterised at a coarse resolution by a NullRasteriser, so that
+        occlusion queries report whether their geometry is hidden by what
+        was drawn before, deterministically. It defaults to "No", since
+        that costs far more than the rest of a draw call.
+    @par
+        The counters can be read directly via getFrameStats and
+        getLastFrameStats, or through getCustomAttribute with the names
+        "FRAME_STATS" and "LAST_FRAME_STATS" and a NullFrameStats* as data,
+        which copies the counters out.
+    */
+    class _OgreNullExport NullRenderSystem : public RenderSystem
+    {
+    public:
+        NullRenderSystem();
+        ~NullRenderSystem();
+
+        /// @copydoc RenderSystem::getName
+        const String& getName(void) const;
+        /// @copydoc RenderSystem::getFriendlyName
+        const String& getFriendlyName(void) const;
+        /// @copydoc RenderSystem::getConfigOptions
+        ConfigOptionMap& getConfigOptions(void);
+        /// @copydoc RenderSystem::setConfigOption
+        void setConfigOption(const String &name, const String &value);
+        /// @copydoc RenderSystem::validateConfigOptions
+        String validateConfigOptions(void);
+        /// @copydoc RenderSystem::_initialise
+        RenderWindow* _initialise(bool autoCreateWindow, const String& windowTitle = "OGRE Render Window");
+        /// @copydoc RenderSystem::createRenderSystemCapabilities
+        RenderSystemCapabilities* createRenderSystemCapabilities() const;
+        /// @copydoc RenderSystem::reinitialise
+        void reinitialise(void);
+        /// @copydoc RenderSystem::shutdown
+        void shutdown(void);
+        /// @copydoc RenderSystem::getCustomAttribute
+        void getCustomAttribute(const String& name, void* pData);
+
+        /// @copydoc RenderSystem::setAmbientLight
+        void setAmbientLight(float r, float g, float b);
+        /// @copydoc RenderSystem::setShadingType
+        void setShadingType(ShadeOptions so);
+        /// @copydoc RenderSystem::setLightingEnabled
+        void setLightingEnabled(bool enabled);
+
+        /// @copydoc RenderSystem::_createRenderWindow
+        RenderWindow* _createRenderWindow(const String &name, unsigned int width, unsigned int height, 
+            bool fullScreen, const NameValuePairList *miscParams = 0);
+        /// @copydoc RenderSystem::_createDepthBufferFor
+        DepthBuffer* _createDepthBufferFor(RenderTarget *renderTarget);
+        /// @copydoc RenderSystem::createMultiRenderTarget
+        MultiRenderTarget* createMultiRenderTarget(const String & name);
+        /// @copydoc RenderSystem::createHardwareOcclusionQuery
+        HardwareOcclusionQuery* createHardwareOcclusionQuery(void);
+
+        /// @copydoc RenderSystem::getErrorDescription
+        String getErrorDescription(long errorNumber) const;
+        /// @copydoc RenderSystem::getColourVertexElementType
+        VertexElementType getColourVertexElementType(void) const;
+        /// @copydoc RenderSystem::setNormaliseNormals
+        void setNormaliseNormals(bool normalise);
+
+        /// @copydoc RenderSystem::_useLights
+        void _useLights(const LightList& lights, unsigned short limit);
+        /// @copydoc RenderSystem::_setWorldMatrix
+        void _setWorldMatrix(const Matrix4 &m);
+        /// @copydoc RenderSystem::_setViewMatrix
+        void _setViewMatrix(const Matrix4 &m);
+        /// @copydoc RenderSystem::_setProjectionMatrix
+        void _setProjectionMatrix(const Matrix4 &m);
+        /// @copydoc RenderSystem::_setSurfaceParams
+        void _setSurfaceParams(const ColourValue &ambient,
+            const ColourValue &diffuse, const ColourValue &specular,
+            const ColourValue &emissive, Real shininess,
+            TrackVertexColourType tracking);
+        /// @copydoc RenderSystem::_setPointSpritesEnabled
+        void _setPointSpritesEnabled(bool enabled);
+        /// @copydoc RenderSystem::_setPointParameters
+        void _setPointParameters(Real size, bool attenuationEnabled, 
+            Real constant, Real linear, Real quadratic, Real minSize, Real maxSize);
+        /// @copydoc RenderSystem::_setTexture
+        void _setTexture(size_t unit, bool enabled, const TexturePtr &tex);
+        /// @copydoc RenderSystem::_setGeometryTexture
+        void _setGeometryTexture(size_t unit, const TexturePtr &tex);
+        /// @copydoc RenderSystem::_setTextureCoordSet
+        void _setTextureCoordSet(size_t unit, size_t index);
+        /// @copydoc RenderSystem::_setTextureCoordCalculation
+        void _setTextureCoordCalculation(size_t unit, TexCoordCalcMethod m, 
+            const Frustum* frustum = 0);
+        /// @copydoc RenderSystem::_setTextureBlendMode
+        void _setTextureBlendMode(size_t unit, const LayerBlendModeEx& bm);
+        /// @copydoc RenderSystem::_setTextureUnitFiltering
+        void _setTextureUnitFiltering(size_t unit, FilterType ftype, FilterOptions filter);
+        /// @copydoc RenderSystem::_setTextureUnitCompareEnabled
+        void _setTextureUnitCompareEnabled(size_t unit, bool compare);
+        /// @copydoc RenderSystem::_setTextureUnitCompareFunction
+        void _setTextureUnitCompareFunction(size_t unit, CompareFunction function);
+        /// @copydoc RenderSystem::_setTextureLayerAnisotropy
+        void _setTextureLayerAnisotropy(size_t unit, unsigned int maxAnisotropy);
+        /// @copydoc RenderSystem::_setTextureAddressingMode
+        void _setTextureAddressingMode(size_t unit, const TextureUnitState::UVWAddressingMode& uvw);
+        /// @copydoc RenderSystem::_setTextureBorderColour
+        void _setTextureBorderColour(size_t unit, const ColourValue& colour);
+        /// @copydoc RenderSystem::_setTextureMipmapBias
+        void _setTextureMipmapBias(size_t unit, float bias);
+        /// @copydoc RenderSystem::_setTextureMatrix
+        void _setTextureMatrix(size_t unit, const Matrix4& xform);
+        /// @copydoc RenderSystem::_setSceneBlending
+        void _setSceneBlending(SceneBlendFactor sourceFactor, SceneBlendFactor destFactor, SceneBlendOperation op = SBO_ADD);
+        /// @copydoc RenderSystem::_setSeparateSceneBlending
+        void _setSeparateSceneBlending(SceneBlendFactor sourceFactor, SceneBlendFactor destFactor, SceneBlendFactor sourceFactorAlpha, 
+            SceneBlendFactor destFactorAlpha, SceneBlendOperation op = SBO_ADD, SceneBlendOperation alphaOp = SBO_ADD);
+        /// @copydoc RenderSystem::_setAlphaRejectSettings
+        void _setAlphaRejectSettings(CompareFunction func, unsigned char value, bool alphaToCoverage);
+        /// @copydoc RenderSystem::_beginFrame
+        void _beginFrame(void);
+        /// @copydoc RenderSystem::_endFrame
+        void _endFrame(void);
+        /// @copydoc RenderSystem::_setViewport
+        void _setViewport(Viewport *vp);
+        /// @copydoc RenderSystem::_setCullingMode
+        void _setCullingMode(CullingMode mode);
+        /// @copydoc RenderSystem::_setDepthBufferParams
+        void _setDepthBufferParams(bool depthTest = true, bool depthWrite = true, CompareFunction depthFunction = CMPF_LESS_EQUAL);
+        /// @copydoc RenderSystem::_setDepthBufferCheckEnabled
+        void _setDepthBufferCheckEnabled(bool enabled = true);
+        /// @copydoc RenderSystem::_setDepthBufferWriteEnabled
+        void _setDepthBufferWriteEnabled(bool enabled = true);
+        /// @copydoc RenderSystem::_setDepthBufferFunction
+        void _setDepthBufferFunction(CompareFunction func = CMPF_LESS_EQUAL);
+        /// @copydoc RenderSystem::_setColourBufferWriteEnabled
+        void _setColourBufferWriteEnabled(bool red, bool green, bool blue, bool alpha);
+        /// @copydoc RenderSystem::_setDepthBias
+        void _setDepthBias(float constantBias, float slopeScaleBias = 0.0f);
+        /// @copydoc RenderSystem::_setFog
+        void _setFog(FogMode mode, const ColourValue& colour, Real expDensity, Real linearStart, Real linearEnd);
+        /// @copydoc RenderSystem::_setPolygonMode
+        void _setPolygonMode(PolygonMode level);
+        /// @copydoc RenderSystem::setStencilCheckEnabled
+        void setStencilCheckEnabled(bool enabled);
+        /// @copydoc RenderSystem::setStencilBufferParams
+        void setStencilBufferParams(CompareFunction func = CMPF_ALWAYS_PASS, 
+            uint32 refValue = 0, uint32 compareMask = 0xFFFFFFFF, uint32 writeMask = 0xFFFFFFFF,
+            StencilOperation stencilFailOp = SOP_KEEP, 
+            StencilOperation depthFailOp = SOP_KEEP,
+            StencilOperation passOp = SOP_KEEP, 
+            bool twoSidedOperation = false,
+            bool readBackAsTexture = false);
+        /// @copydoc RenderSystem::setVertexDeclaration
+        void setVertexDeclaration(VertexDeclaration* decl);
+        /// @copydoc RenderSystem::setVertexBufferBinding
+        void setVertexBufferBinding(VertexBufferBinding* binding);
+        /// @copydoc RenderSystem::_render
+        void _render(const RenderOperation& op);
+        /// @copydoc RenderSystem::bindGpuProgram
+        void bindGpuProgram(GpuProgram* prg);
+        /// @copydoc RenderSystem::unbindGpuProgram
+        void unbindGpuProgram(GpuProgramType gptype);
+        /// @copydoc RenderSystem::bindGpuProgramParameters
+        void bindGpuProgramParameters(GpuProgramType gptype, 
+            GpuProgramParametersSharedPtr params, uint16 variabilityMask);
+        /// @copydoc RenderSystem::bindGpuProgramPassIterationParameters
+        void bindGpuProgramPassIterationParameters(GpuProgramType gptype);
+        /// @copydoc RenderSystem::setScissorTest
+        void setScissorTest(bool enabled, size_t left = 0, size_t top = 0, size_t right = 800, size_t bottom = 600);
+        /// @copydoc RenderSystem::clearFrameBuffer
+        void clearFrameBuffer(unsigned int buffers, 
+            const ColourValue& colour = ColourValue::Black, 
+            Real depth = 1.0f, unsigned short stencil = 0);
+        /// @copydoc RenderSystem::_setRenderTarget
+        void _setRenderTarget(RenderTarget *target);
+        /// @copydoc RenderSystem::_swapAllRenderTargetBuffers
+        void _swapAllRenderTargetBuffers();
+
+        /// @copydoc RenderSystem::_convertProjectionMatrix
+        void _convertProjectionMatrix(const Matrix4& matrix,
+            Matrix4& dest, bool forGpuProgram = false);
+        /// @copydoc RenderSystem::_makeProjectionMatrix(const Radian&, Real, Real, Real, Matrix4&, bool)
+        void _makeProjectionMatrix(const Radian& fovy, Real aspect, Real nearPlane, Real farPlane, 
+            Matrix4& dest, bool forGpuProgram = false);
+        /// @copydoc RenderSystem::_makeProjectionMatrix(Real, Real, Real, Real, Real, Real, Matrix4&, bool)
+        void _makeProjectionMatrix(Real left, Real right, Real bottom, Real top, 
+            Real nearPlane, Real farPlane, Matrix4& dest, bool forGpuProgram = false);
+        /// @copydoc RenderSystem::_makeOrthoMatrix
+        void _makeOrthoMatrix(const Radian& fovy, Real aspect, Real nearPlane, Real farPlane, 
+            Matrix4& dest, bool forGpuProgram = false);
+        /// @copydoc RenderSystem::_applyObliqueDepthProjection
+        void _applyObliqueDepthProjection(Matrix4& matrix, const Plane& plane, 
+            bool forGpuProgram);
+
+        /// @copydoc RenderSystem::getHorizontalTexelOffset
+        Real getHorizontalTexelOffset(void);
+        /// @copydoc RenderSystem::getVerticalTexelOffset
+        Real getVerticalTexelOffset(void);
+        /// @copydoc RenderSystem::getMinimumDepthInputValue
+        Real getMinimumDepthInputValue(void);
+        /// @copydoc RenderSystem::getMaximumDepthInputValue
+        Real getMaximumDepthInputValue(void);
+
+        /// @copydoc RenderSystem::preExtraThreadsStarted
+        void preExtraThreadsStarted() {}
+        /// @copydoc RenderSystem::postExtraThreadsStarted
+        void postExtraThreadsStarted() {}
+        /// @copydoc RenderSystem::registerThread
+        void registerThread() {}
+        /// @copydoc RenderSystem::unregisterThread
+        void unregisterThread() {}
+        /// @copydoc RenderSystem::getDisplayMonitorCount
+        unsigned int getDisplayMonitorCount() const { return 1; }
+        /// @copydoc RenderSystem::hasAnisotropicMipMapFilter
+        bool hasAnisotropicMipMapFilter() const { return false; }
+        /// @copydoc RenderSystem::beginProfileEvent
+        void beginProfileEvent(const String &eventName) {}
+        /// @copydoc RenderSystem::endProfileEvent
+        void endProfileEvent(void) {}
+        /// @copydoc RenderSystem::markProfileEvent
+        void markProfileEvent(const String &eventName) {}
+
+        /** Gets the counters of the frame currently being rendered. */
+        NullFrameStats getFrameStats(void) const;
+        /** Gets the counters of the last completed frame. */
+        const NullFrameStats& getLastFrameStats(void) const { return mLastFrameStats; }
+        /** Resets the counters of both the current and the last frame. */
+        void resetFrameStats(void);
+
+        /** Records bytes written into a buffer owned by this render system.
+        @remarks
+            Called by the hardware and pixel buffers, possibly from background
+            loading threads.
+        */
+        void _notifyBytesUploaded(size_t bytes) { mBytesUploaded += bytes; }
+
+        /** Gets the total number of depth samples which passed the depth
+            test since the render system was created.
+        @remarks
+            Used by the occlusion queries; samples are only counted while
+            RSC_HWOCCLUSION is supported.
+        */
+        size_t _getSamplesPassed(void) const { return mSamplesPassed; }
+
+    protected:
+        /// @copydoc RenderSystem::setClipPlanesImpl
+        void setClipPlanesImpl(const PlaneList& clipPlanes);
+        /// @copydoc RenderSystem::initialiseFromRenderSystemCapabilities
+        void initialiseFromRenderSystemCapabilities(RenderSystemCapabilities* caps, RenderTarget* primary);
+
+        /// Counts a single render state change
+        void _stateChanged(void) { ++mFrameStats.stateChanges; }
+
+        void initConfigOptions(void);
+
+        ConfigOptionMap mOptions;
+        NullHardwareBufferManager* mHardwareBufferManager;
+        NullGpuProgramManager* mGpuProgramManager;
+        /// Factories of the high-level languages programs are accepted in
+        vector<NullHighLevelGpuProgramFactory*>::type mProgramFactories;
+        bool mInitialised;
+
+        NullFrameStats mFrameStats;
+        NullFrameStats mLastFrameStats;
+        /// Uploads may come from background threads, so are kept apart
+        AtomicScalar<size_t> mBytesUploaded;
+
+        /// Answers the occlusion queries
+        NullRasteriser mRasteriser;
+        /// Whether draw calls are rasterised, as RSC_HWOCCLUSION is supported
+        bool mTrackDepth;
+        size_t mSamplesPassed;
+        Matrix4 mWorldMatrix;
+        Matrix4 mViewMatrix;
+        Matrix4 mProjMatrix;
+        bool mDepthCheck;
+        bool mDepthWrite;
+        CompareFunction mDepthFunc;
+    };
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullRenderTarget_H__
+#define __NullRenderTarget_H__
+
+#include "OgreNullPrerequisites.h"
+#include "OgreRenderWindow.h"
+#include "OgreRenderTexture.h"
+
+namespace Ogre {
+
+    /** Off-screen render window with no backing storage.
+    @remarks
+        Recognised misc params are "left", "top" and "colourDepth"; all other
+        parameters are accepted and ignored so that configurations written
+        for other render systems can be reused unchanged.
+    */
+    class _OgreNullExport NullRenderWindow : public RenderWindow
+    {
+    public:
+        NullRenderWindow();
+        ~NullRenderWindow();
+
+        /// @copydoc RenderWindow::create
+        void create(const String& name, unsigned int widthPt, unsigned int heightPt,
+            bool fullScreen, const NameValuePairList *miscParams);
+        /// @copydoc RenderWindow::setFullscreen
+        void setFullscreen(bool fullScreen, unsigned int widthPt, unsigned int heightPt);
+        /// @copydoc RenderWindow::destroy
+        void destroy(void);
+        /// @copydoc RenderWindow::resize
+        void resize(unsigned int widthPt, unsigned int heightPt);
+        /// @copydoc RenderWindow::reposition
+        void reposition(int leftPt, int topPt);
+        /// @copydoc RenderWindow::isClosed
+        bool isClosed(void) const { return mClosed; }
+        /// @copydoc RenderTarget::copyContentsToMemory
+        void copyContentsToMemory(const Box& src, const PixelBox &dst, FrameBuffer buffer = FB_AUTO);
+        /// @copydoc RenderTarget::requiresTextureFlipping
+        bool requiresTextureFlipping() const { return false; }
+
+    protected:
+        bool mClosed;
+    };
+
+    /// Render texture targeting a slice of a NullHardwarePixelBuffer
+    class _OgreNullExport NullRenderTexture : public RenderTexture
+    {
+    public:
+        NullRenderTexture(const String &name, HardwarePixelBuffer *buffer, uint32 zoffset);
+
+        /// @copydoc RenderTarget::requiresTextureFlipping
+        bool requiresTextureFlipping() const { return false; }
+    };
+
+    /// Multiple render target which only tracks its bound surfaces
+    class _OgreNullExport NullMultiRenderTarget : public MultiRenderTarget
+    {
+    public:
+        NullMultiRenderTarget(const String &name);
+
+        /// @copydoc RenderTarget::requiresTextureFlipping
+        bool requiresTextureFlipping() const { return false; }
+
+    protected:
+        /// @copydoc MultiRenderTarget::bindSurfaceImpl
+        void bindSurfaceImpl(size_t attachment, RenderTexture *target);
+        /// @copydoc MultiRenderTarget::unbindSurfaceImpl
+        void unbindSurfaceImpl(size_t attachment);
+    };
+}
+
+#endif
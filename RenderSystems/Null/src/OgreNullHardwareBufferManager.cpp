@@ -0,0 +1,96 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreNullHardwareBufferManager.h"
+#include "OgreNullRenderSystem.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    NullHardwareVertexBuffer::NullHardwareVertexBuffer(HardwareBufferManagerBase* mgr, NullRenderSystem* rs,
+        size_t vertexSize, size_t numVertices, HardwareBuffer::Usage usage)
+        : DefaultHardwareVertexBuffer(mgr, vertexSize, numVertices, usage)
+        , mRenderSystem(rs)
+    {
+    }
+    //-----------------------------------------------------------------------
+    void NullHardwareVertexBuffer::writeData(size_t offset, size_t length, const void* pSource,
+            bool discardWholeBuffer)
+    {
+        DefaultHardwareVertexBuffer::writeData(offset, length, pSource, discardWholeBuffer);
+        mRenderSystem->_notifyBytesUploaded(length);
+    }
+    //-----------------------------------------------------------------------
+    void* NullHardwareVertexBuffer::lock(size_t offset, size_t length, LockOptions options, UploadOptions uploadOpt)
+    {
+        // A writable lock stands in for an upload of the locked range
+        if (options != HBL_READ_ONLY)
+            mRenderSystem->_notifyBytesUploaded(length);
+        return DefaultHardwareVertexBuffer::lock(offset, length, options, uploadOpt);
+    }
+    //-----------------------------------------------------------------------
+    NullHardwareIndexBuffer::NullHardwareIndexBuffer(NullRenderSystem* rs, IndexType idxType, 
+        size_t numIndexes, HardwareBuffer::Usage usage)
+        : DefaultHardwareIndexBuffer(idxType, numIndexes, usage)
+        , mRenderSystem(rs)
+    {
+    }
+    //-----------------------------------------------------------------------
+    void NullHardwareIndexBuffer::writeData(size_t offset, size_t length, const void* pSource,
+            bool discardWholeBuffer)
+    {
+        DefaultHardwareIndexBuffer::writeData(offset, length, pSource, discardWholeBuffer);
+        mRenderSystem->_notifyBytesUploaded(length);
+    }
+    //-----------------------------------------------------------------------
+    void* NullHardwareIndexBuffer::lock(size_t offset, size_t length, LockOptions options, UploadOptions uploadOpt)
+    {
+        if (options != HBL_READ_ONLY)
+            mRenderSystem->_notifyBytesUploaded(length);
+        return DefaultHardwareIndexBuffer::lock(offset, length, options, uploadOpt);
+    }
+    //-----------------------------------------------------------------------
+    NullHardwareBufferManagerBase::NullHardwareBufferManagerBase(NullRenderSystem* rs)
+        : mRenderSystem(rs)
+    {
+    }
+    //-----------------------------------------------------------------------
+    HardwareVertexBufferSharedPtr 
+        NullHardwareBufferManagerBase::createVertexBuffer(size_t vertexSize, 
+        size_t numVerts, HardwareBuffer::Usage usage, bool useShadowBuffer)
+    {
+        NullHardwareVertexBuffer* vb = OGRE_NEW NullHardwareVertexBuffer(this, mRenderSystem, vertexSize, numVerts, usage);
+        return HardwareVertexBufferSharedPtr(vb);
+    }
+    //-----------------------------------------------------------------------
+    HardwareIndexBufferSharedPtr 
+        NullHardwareBufferManagerBase::createIndexBuffer(HardwareIndexBuffer::IndexType itype, 
+        size_t numIndexes, HardwareBuffer::Usage usage, bool useShadowBuffer)
+    {
+        NullHardwareIndexBuffer* ib = OGRE_NEW NullHardwareIndexBuffer(mRenderSystem, itype, numIndexes, usage);
+        return HardwareIndexBufferSharedPtr(ib);
+    }
+}
@@ -0,0 +1,144 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreNullHardwarePixelBuffer.h"
+#include "OgreNullRenderSystem.h"
+#include "OgreNullRenderTarget.h"
+#include "OgreRoot.h"
+#include "OgreStringConverter.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------------
+    NullHardwarePixelBuffer::NullHardwarePixelBuffer(NullRenderSystem* rs, const String& baseName,
+        uint32 width, uint32 height, uint32 depth, PixelFormat format, HardwareBuffer::Usage usage)
+        : HardwarePixelBuffer(width, height, depth, format, usage, false, false)
+        , mRenderSystem(rs)
+        , mScratch(0)
+        , mScratchWritable(false)
+    {
+        mSizeInBytes = PixelUtil::getMemorySize(mWidth, mHeight, mDepth, mFormat);
+
+        if (mUsage & TU_RENDERTARGET)
+        {
+            // Create render target for each slice
+            mSliceTRT.reserve(mDepth);
+            mSliceTRTNames.reserve(mDepth);
+            for (uint32 zoffset = 0; zoffset < mDepth; ++zoffset)
+            {
+                String name = "rtt/" + StringConverter::toString((size_t)this) + "/" + 
+                    StringConverter::toString(zoffset) + "/" + baseName;
+                RenderTexture* trt = OGRE_NEW NullRenderTexture(name, this, zoffset);
+                mSliceTRT.push_back(trt);
+                mSliceTRTNames.push_back(name);
+                mRenderSystem->attachRenderTarget(*trt);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------------
+    NullHardwarePixelBuffer::~NullHardwarePixelBuffer()
+    {
+        if (mScratch)
+        {
+            OGRE_FREE(mScratch, MEMCATEGORY_RENDERSYS);
+            mScratch = 0;
+        }
+
+        // Destroy the slice targets by name; any the user destroyed already
+        // are simply no longer attached
+        for (StringVector::const_iterator it = mSliceTRTNames.begin(); it != mSliceTRTNames.end(); ++it)
+        {
+            mRenderSystem->destroyRenderTarget(*it);
+        }
+    }
+    //-----------------------------------------------------------------------------
+    PixelBox NullHardwarePixelBuffer::lockImpl(const Image::Box &lockBox, LockOptions options)
+    {
+        size_t size = PixelUtil::getMemorySize(lockBox.getWidth(), lockBox.getHeight(), 
+            lockBox.getDepth(), mFormat);
+        mScratch = static_cast<uint8*>(OGRE_MALLOC(size, MEMCATEGORY_RENDERSYS));
+        memset(mScratch, 0, size);
+        mScratchWritable = options != HBL_READ_ONLY;
+        if (mScratchWritable)
+            mRenderSystem->_notifyBytesUploaded(size);
+
+        return PixelBox(lockBox.getWidth(), lockBox.getHeight(), lockBox.getDepth(), mFormat, mScratch);
+    }
+    //-----------------------------------------------------------------------------
+    void NullHardwarePixelBuffer::unlockImpl(void)
+    {
+        OGRE_FREE(mScratch, MEMCATEGORY_RENDERSYS);
+        mScratch = 0;
+        mScratchWritable = false;
+    }
+    //-----------------------------------------------------------------------------
+    void NullHardwarePixelBuffer::blitFromMemory(const PixelBox &src, const Image::Box &dstBox)
+    {
+        if (!Image::Box(0, 0, 0, mWidth, mHeight, mDepth).contains(dstBox))
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Destination box out of range",
+                "NullHardwarePixelBuffer::blitFromMemory");
+
+        mRenderSystem->_notifyBytesUploaded(PixelUtil::getMemorySize(
+            dstBox.getWidth(), dstBox.getHeight(), dstBox.getDepth(), mFormat));
+    }
+    //-----------------------------------------------------------------------------
+    void NullHardwarePixelBuffer::blitToMemory(const Image::Box &srcBox, const PixelBox &dst)
+    {
+        if (!Image::Box(0, 0, 0, mWidth, mHeight, mDepth).contains(srcBox))
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Source box out of range",
+                "NullHardwarePixelBuffer::blitToMemory");
+
+        // There is no content, so hand back black pixels in the requested format
+        size_t size = PixelUtil::getMemorySize(srcBox.getWidth(), srcBox.getHeight(), 
+            srcBox.getDepth(), mFormat);
+        uint8* scratch = static_cast<uint8*>(OGRE_MALLOC(size, MEMCATEGORY_RENDERSYS));
+        memset(scratch, 0, size);
+        PixelBox blank(srcBox.getWidth(), srcBox.getHeight(), srcBox.getDepth(), mFormat, scratch);
+        if (blank.getWidth() != dst.getWidth() || blank.getHeight() != dst.getHeight() ||
+            blank.getDepth() != dst.getDepth())
+        {
+            Image::scale(blank, dst);
+        }
+        else
+        {
+            PixelUtil::bulkPixelConversion(blank, dst);
+        }
+        OGRE_FREE(scratch, MEMCATEGORY_RENDERSYS);
+    }
+    //-----------------------------------------------------------------------------
+    RenderTexture* NullHardwarePixelBuffer::getRenderTarget(size_t zoffset)
+    {
+        assert(mUsage & TU_RENDERTARGET);
+        assert(zoffset < mDepth);
+        return mSliceTRT[zoffset];
+    }
+    //-----------------------------------------------------------------------------
+    void NullHardwarePixelBuffer::_clearSliceRTT(size_t zoffset)
+    {
+        if (zoffset < mSliceTRT.size())
+            mSliceTRT[zoffset] = 0;
+    }
+}
@@ -0,0 +1,276 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreNullRasteriser.h"
+#include "OgreRenderOperation.h"
+#include "OgreVertexIndexData.h"
+#include "OgreHardwareVertexBuffer.h"
+#include "OgreHardwareIndexBuffer.h"
+
+namespace Ogre {
+    namespace
+    {
+        bool depthTest(CompareFunction func, float depth, float stored)
+        {
+            switch (func)
+            {
+            case CMPF_ALWAYS_FAIL:
+                return false;
+            case CMPF_ALWAYS_PASS:
+                return true;
+            case CMPF_LESS:
+                return depth < stored;
+            case CMPF_LESS_EQUAL:
+                return depth <= stored;
+            case CMPF_EQUAL:
+                return depth == stored;
+            case CMPF_NOT_EQUAL:
+                return depth != stored;
+            case CMPF_GREATER_EQUAL:
+                return depth >= stored;
+            case CMPF_GREATER:
+                return depth > stored;
+            }
+            return true;
+        }
+
+        /// Signed distance to the near plane in clip space, with depth in [-w,w]
+        Real nearDistance(const Vector4& p)
+        {
+            return p.z + p.w;
+        }
+    }
+    //-----------------------------------------------------------------------------
+    NullRasteriser::NullRasteriser()
+        : mDepth(RESOLUTION * RESOLUTION, 1.0f)
+        , mTransform(Matrix4::IDENTITY)
+        , mDepthCheck(true)
+        , mDepthWrite(true)
+        , mDepthFunc(CMPF_LESS_EQUAL)
+    {
+    }
+    //-----------------------------------------------------------------------------
+    void NullRasteriser::clearDepth(Real depth)
+    {
+        std::fill(mDepth.begin(), mDepth.end(), static_cast<float>(depth));
+    }
+    //-----------------------------------------------------------------------------
+    void NullRasteriser::setDepthState(bool check, bool write, CompareFunction func)
+    {
+        mDepthCheck = check;
+        mDepthWrite = write;
+        mDepthFunc = func;
+    }
+    //-----------------------------------------------------------------------------
+    size_t NullRasteriser::rasterise(const RenderOperation& op)
+    {
+        if (!op.vertexData || op.vertexData->vertexCount == 0)
+            return 0;
+
+        if (op.operationType != RenderOperation::OT_TRIANGLE_LIST &&
+            op.operationType != RenderOperation::OT_TRIANGLE_STRIP &&
+            op.operationType != RenderOperation::OT_TRIANGLE_FAN)
+            return 0;
+
+        const VertexElement* posElem =
+            op.vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        if (!posElem || (posElem->getType() != VET_FLOAT3 && posElem->getType() != VET_FLOAT4) ||
+            !op.vertexData->vertexBufferBinding->isBufferBound(posElem->getSource()))
+            return 0;
+
+        // transform all the vertices of the operation into clip space
+        HardwareVertexBufferSharedPtr vbuf =
+            op.vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+        size_t vertexCount = op.vertexData->vertexCount;
+        const unsigned char* pVert = static_cast<const unsigned char*>(
+            vbuf->lock(op.vertexData->vertexStart * vbuf->getVertexSize(),
+                vertexCount * vbuf->getVertexSize(), HardwareBuffer::HBL_READ_ONLY));
+
+        mClipPositions.resize(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v, pVert += vbuf->getVertexSize())
+        {
+            float* pPos;
+            posElem->baseVertexPointerToElement(const_cast<unsigned char*>(pVert), &pPos);
+            mClipPositions[v] = mTransform * Vector4(pPos[0], pPos[1], pPos[2], 1.0f);
+        }
+        vbuf->unlock();
+
+        // indexes are relative to the start of the vertex data
+        HardwareIndexBufferSharedPtr ibuf;
+        const uint16* pIdx16 = 0;
+        const uint32* pIdx32 = 0;
+        size_t count = vertexCount;
+        if (op.useIndexes && op.indexData && !op.indexData->indexBuffer.isNull())
+        {
+            ibuf = op.indexData->indexBuffer;
+            count = op.indexData->indexCount;
+            const void* pIdx = ibuf->lock(op.indexData->indexStart * ibuf->getIndexSize(),
+                count * ibuf->getIndexSize(), HardwareBuffer::HBL_READ_ONLY);
+            if (ibuf->getType() == HardwareIndexBuffer::IT_32BIT)
+                pIdx32 = static_cast<const uint32*>(pIdx);
+            else
+                pIdx16 = static_cast<const uint16*>(pIdx);
+        }
+
+        size_t passed = 0;
+        size_t idx[3];
+        for (size_t i = 2; i < count; )
+        {
+            switch (op.operationType)
+            {
+            case RenderOperation::OT_TRIANGLE_LIST:
+                idx[0] = i - 2; idx[1] = i - 1; idx[2] = i;
+                i += 3;
+                break;
+            case RenderOperation::OT_TRIANGLE_FAN:
+                idx[0] = 0; idx[1] = i - 1; idx[2] = i;
+                ++i;
+                break;
+            default:
+                idx[0] = i - 2; idx[1] = i - 1; idx[2] = i;
+                ++i;
+                break;
+            }
+
+            bool valid = true;
+            for (int k = 0; k < 3; ++k)
+            {
+                if (pIdx32)
+                    idx[k] = pIdx32[idx[k]];
+                else if (pIdx16)
+                    idx[k] = pIdx16[idx[k]];
+                valid = valid && idx[k] < vertexCount;
+            }
+
+            if (valid)
+            {
+                passed += rasteriseClipped(mClipPositions[idx[0]],
+                    mClipPositions[idx[1]], mClipPositions[idx[2]]);
+            }
+        }
+
+        if (!ibuf.isNull())
+            ibuf->unlock();
+
+        return passed;
+    }
+    //-----------------------------------------------------------------------------
+    size_t NullRasteriser::rasteriseClipped(const Vector4& a, const Vector4& b, const Vector4& c)
+    {
+        const Vector4* in[3] = { &a, &b, &c };
+        Vector4 out[4];
+        size_t outCount = 0;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            const Vector4& p = *in[i];
+            const Vector4& q = *in[(i + 1) % 3];
+            Real dp = nearDistance(p);
+            Real dq = nearDistance(q);
+
+            if (dp >= 0)
+                out[outCount++] = p;
+            // edge crossing the near plane
+            if ((dp >= 0) != (dq >= 0))
+            {
+                Real t = dp / (dp - dq);
+                out[outCount++] = p + (q - p) * t;
+            }
+        }
+
+        if (outCount < 3)
+            return 0;
+
+        Vector3 s0 = toSampleSpace(out[0]);
+        Vector3 s1 = toSampleSpace(out[1]);
+        size_t passed = 0;
+        for (size_t i = 2; i < outCount; ++i)
+        {
+            Vector3 s2 = toSampleSpace(out[i]);
+            passed += rasteriseTriangle(s0, s1, s2);
+            s1 = s2;
+        }
+        return passed;
+    }
+    //-----------------------------------------------------------------------------
+    Vector3 NullRasteriser::toSampleSpace(const Vector4& p) const
+    {
+        // in front of the near plane w is positive for both perspective and
+        // orthographic projections, depth in [-1,1] maps to [0,1]
+        Real invW = p.w > 0 ? 1 / p.w : 0;
+        return Vector3(
+            (p.x * invW * 0.5f + 0.5f) * RESOLUTION,
+            (p.y * invW * 0.5f + 0.5f) * RESOLUTION,
+            p.z * invW * 0.5f + 0.5f);
+    }
+    //-----------------------------------------------------------------------------
+    size_t NullRasteriser::rasteriseTriangle(const Vector3& a, const Vector3& b, const Vector3& c)
+    {
+        Real area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (Math::Abs(area) < 1e-8f)
+            return 0;
+        // both windings are rasterised, culling being ignored
+        Real sign = area > 0 ? 1.0f : -1.0f;
+        Real invArea = 1 / Math::Abs(area);
+
+        // samples are at the centre of each cell
+        int minX = std::max(0, (int)Math::Floor(std::min(a.x, std::min(b.x, c.x)) - 0.5f));
+        int maxX = std::min((int)RESOLUTION - 1, (int)Math::Ceil(std::max(a.x, std::max(b.x, c.x)) - 0.5f));
+        int minY = std::max(0, (int)Math::Floor(std::min(a.y, std::min(b.y, c.y)) - 0.5f));
+        int maxY = std::min((int)RESOLUTION - 1, (int)Math::Ceil(std::max(a.y, std::max(b.y, c.y)) - 0.5f));
+
+        size_t passed = 0;
+        for (int y = minY; y <= maxY; ++y)
+        {
+            Real py = y + 0.5f;
+            for (int x = minX; x <= maxX; ++x)
+            {
+                Real px = x + 0.5f;
+                Real w0 = sign * ((c.x - b.x) * (py - b.y) - (c.y - b.y) * (px - b.x));
+                Real w1 = sign * ((a.x - c.x) * (py - c.y) - (a.y - c.y) * (px - c.x));
+                Real w2 = sign * ((b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x));
+                if (w0 < 0 || w1 < 0 || w2 < 0)
+                    continue;
+
+                float z = static_cast<float>((w0 * a.z + w1 * b.z + w2 * c.z) * invArea);
+                // beyond the far plane
+                if (z < 0 || z > 1)
+                    continue;
+
+                float& stored = mDepth[y * RESOLUTION + x];
+                if (mDepthCheck && !depthTest(mDepthFunc, z, stored))
+                    continue;
+
+                ++passed;
+                // like OpenGL, nothing is written with the depth test disabled
+                if (mDepthCheck && mDepthWrite)
+                    stored = z;
+            }
+        }
+        return passed;
+    }
+}
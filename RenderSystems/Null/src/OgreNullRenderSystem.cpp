@@ -0,0 +1,902 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreNullRenderSystem.h"
+#include "OgreNullRenderTarget.h"
+#include "OgreNullTextureManager.h"
+#include "OgreNullHardwareBufferManager.h"
+#include "OgreNullGpuProgramManager.h"
+#include "OgreNullHardwareOcclusionQuery.h"
+#include "OgreDepthBuffer.h"
+#include "OgreFrustum.h"
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+#include "OgreViewport.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    NullRenderSystem::NullRenderSystem()
+        : mHardwareBufferManager(0)
+        , mGpuProgramManager(0)
+        , mInitialised(false)
+        , mBytesUploaded(0)
+        , mTrackDepth(false)
+        , mSamplesPassed(0)
+        , mWorldMatrix(Matrix4::IDENTITY)
+        , mViewMatrix(Matrix4::IDENTITY)
+        , mProjMatrix(Matrix4::IDENTITY)
+        , mDepthCheck(true)
+        , mDepthWrite(true)
+        , mDepthFunc(CMPF_LESS_EQUAL)
+    {
+        LogManager::getSingleton().logMessage(getName() + " created.");
+
+        initConfigOptions();
+    }
+    //-----------------------------------------------------------------------
+    NullRenderSystem::~NullRenderSystem()
+    {
+        shutdown();
+    }
+    //-----------------------------------------------------------------------
+    const String& NullRenderSystem::getName(void) const
+    {
+        static String strName("Null Rendering Subsystem");
+        return strName;
+    }
+    //-----------------------------------------------------------------------
+    const String& NullRenderSystem::getFriendlyName(void) const
+    {
+        static String strName("Null");
+        return strName;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::initConfigOptions(void)
+    {
+        ConfigOption optFullScreen;
+        ConfigOption optVideoMode;
+        ConfigOption optOcclusion;
+
+        optFullScreen.name = "Full Screen";
+        optFullScreen.possibleValues.push_back("Yes");
+        optFullScreen.possibleValues.push_back("No");
+        optFullScreen.currentValue = "No";
+        optFullScreen.immutable = false;
+
+        optVideoMode.name = "Video Mode";
+        optVideoMode.possibleValues.push_back("640 x 480");
+        optVideoMode.possibleValues.push_back("800 x 600");
+        optVideoMode.possibleValues.push_back("1024 x 768");
+        optVideoMode.possibleValues.push_back("1280 x 720");
+        optVideoMode.possibleValues.push_back("1920 x 1080");
+        optVideoMode.currentValue = "800 x 600";
+        optVideoMode.immutable = false;
+
+        // Answering occlusion queries means rasterising every draw call,
+        // which would skew the CPU timings the Null render system is used for
+        optOcclusion.name = "Occlusion Queries";
+        optOcclusion.possibleValues.push_back("Yes");
+        optOcclusion.possibleValues.push_back("No");
+        optOcclusion.currentValue = "No";
+        optOcclusion.immutable = false;
+
+        mOptions[optFullScreen.name] = optFullScreen;
+        mOptions[optVideoMode.name] = optVideoMode;
+        mOptions[optOcclusion.name] = optOcclusion;
+    }
+    //-----------------------------------------------------------------------
+    ConfigOptionMap& NullRenderSystem::getConfigOptions(void)
+    {
+        return mOptions;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::setConfigOption(const String &name, const String &value)
+    {
+        ConfigOptionMap::iterator it = mOptions.find(name);
+        if (it == mOptions.end())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Option named '" + name + "' does not exist.", 
+                "NullRenderSystem::setConfigOption");
+        }
+        it->second.currentValue = value;
+    }
+    //-----------------------------------------------------------------------
+    String NullRenderSystem::validateConfigOptions(void)
+    {
+        ConfigOptionMap::iterator it = mOptions.find("Video Mode");
+        if (it != mOptions.end() && it->second.currentValue.find('x') == String::npos)
+            return "A video mode of the form 'width x height' must be selected.";
+
+        return BLANKSTRING;
+    }
+    //-----------------------------------------------------------------------
+    RenderWindow* NullRenderSystem::_initialise(bool autoCreateWindow, const String& windowTitle)
+    {
+        // Create the texture manager
+        mTextureManager = OGRE_NEW NullTextureManager(this);
+
+        RenderWindow* autoWindow = 0;
+        if (autoCreateWindow)
+        {
+            ConfigOptionMap::iterator opt;
+            bool fullScreen = false;
+            uint w = 800, h = 600;
+
+            if ((opt = mOptions.find("Full Screen")) != mOptions.end())
+                fullScreen = (opt->second.currentValue == "Yes");
+
+            if ((opt = mOptions.find("Video Mode")) != mOptions.end())
+            {
+                String val = opt->second.currentValue;
+                String::size_type pos = val.find('x');
+
+                if (pos != String::npos)
+                {
+                    w = StringConverter::parseUnsignedInt(val.substr(0, pos));
+                    h = StringConverter::parseUnsignedInt(val.substr(pos + 1));
+                }
+            }
+
+            autoWindow = _createRenderWindow(windowTitle, w, h, fullScreen);
+        }
+
+        RenderSystem::_initialise(autoCreateWindow, windowTitle);
+
+        return autoWindow;
+    }
+    //-----------------------------------------------------------------------
+    RenderSystemCapabilities* NullRenderSystem::createRenderSystemCapabilities() const
+    {
+        RenderSystemCapabilities* rsc = OGRE_NEW RenderSystemCapabilities();
+
+        rsc->setDriverVersion(mDriverVersion);
+        rsc->setDeviceName("Null");
+        rsc->setRenderSystemName(getName());
+        rsc->setVendor(GPU_UNKNOWN);
+
+        rsc->setNumTextureUnits(16);
+        rsc->setStencilBufferBitDepth(8);
+        rsc->setNumMultiRenderTargets(4);
+        rsc->setMaxPointSize(1024);
+        rsc->setNonPOW2TexturesLimited(false);
+        rsc->setNumVertexTextureUnits(0);
+        rsc->setVertexTextureUnitsShared(false);
+
+        rsc->setCapability(RSC_FIXED_FUNCTION);
+        rsc->setCapability(RSC_AUTOMIPMAP);
+        rsc->setCapability(RSC_BLENDING);
+        rsc->setCapability(RSC_ANISOTROPY);
+        rsc->setCapability(RSC_DOT3);
+        rsc->setCapability(RSC_CUBEMAPPING);
+        rsc->setCapability(RSC_HWSTENCIL);
+        rsc->setCapability(RSC_TWO_SIDED_STENCIL);
+        rsc->setCapability(RSC_STENCIL_WRAP);
+        rsc->setCapability(RSC_VBO);
+        rsc->setCapability(RSC_32BIT_INDEX);
+        rsc->setCapability(RSC_SCISSOR_TEST);
+        ConfigOptionMap::const_iterator opt = mOptions.find("Occlusion Queries");
+        if (opt != mOptions.end() && opt->second.currentValue == "Yes")
+            rsc->setCapability(RSC_HWOCCLUSION);
+        rsc->setCapability(RSC_USER_CLIP_PLANES);
+        rsc->setCapability(RSC_INFINITE_FAR_PLANE);
+        rsc->setCapability(RSC_HWRENDER_TO_TEXTURE);
+        rsc->setCapability(RSC_TEXTURE_FLOAT);
+        rsc->setCapability(RSC_NON_POWER_OF_2_TEXTURES);
+        rsc->setCapability(RSC_TEXTURE_1D);
+        rsc->setCapability(RSC_TEXTURE_3D);
+        rsc->setCapability(RSC_TEXTURE_COMPRESSION);
+        rsc->setCapability(RSC_TEXTURE_COMPRESSION_DXT);
+        rsc->setCapability(RSC_POINT_SPRITES);
+        rsc->setCapability(RSC_POINT_EXTENDED_PARAMETERS);
+        rsc->setCapability(RSC_MIPMAP_LOD_BIAS);
+        rsc->setCapability(RSC_VERTEX_FORMAT_UBYTE4);
+        rsc->setCapability(RSC_RTT_SEPARATE_DEPTHBUFFER);
+        rsc->setCapability(RSC_RTT_MAIN_DEPTHBUFFER_ATTACHABLE);
+        rsc->setCapability(RSC_RTT_DEPTHBUFFER_RESOLUTION_LESSEQUAL);
+
+        // Programs are accepted in every common profile and language and
+        // never compiled, so shader based techniques are used and counted
+        rsc->setCapability(RSC_VERTEX_PROGRAM);
+        rsc->setCapability(RSC_FRAGMENT_PROGRAM);
+        rsc->setCapability(RSC_GEOMETRY_PROGRAM);
+        rsc->setVertexProgramConstantFloatCount(256);
+        rsc->setVertexProgramConstantIntCount(16);
+        rsc->setVertexProgramConstantBoolCount(16);
+        rsc->setFragmentProgramConstantFloatCount(224);
+        rsc->setFragmentProgramConstantIntCount(16);
+        rsc->setFragmentProgramConstantBoolCount(16);
+        rsc->setGeometryProgramConstantFloatCount(256);
+        rsc->setGeometryProgramConstantIntCount(16);
+        rsc->setGeometryProgramConstantBoolCount(16);
+        rsc->setGeometryProgramNumOutputVertices(1024);
+
+        const char* profiles[] = {
+            "arbvp1", "arbfp1", "vp40", "fp40", "gp4vp", "gp4fp", "gpu_gp",
+            "vs_1_1", "vs_2_0", "vs_2_a", "vs_2_x", "vs_3_0", "vs_4_0", "vs_5_0",
+            "ps_2_0", "ps_2_a", "ps_2_b", "ps_2_x", "ps_3_0", "ps_4_0", "ps_5_0", "gs_4_0",
+            "glsl", "glsl150", "glsl330", "glsl400", "hlsl", "cg" };
+        for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); ++i)
+            rsc->addShaderProfile(profiles[i]);
+
+        return rsc;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::initialiseFromRenderSystemCapabilities(RenderSystemCapabilities* caps, RenderTarget* primary)
+    {
+        if (caps->getRenderSystemName() != getName())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Trying to initialize NullRenderSystem from RenderSystemCapabilities that do not support it",
+                "NullRenderSystem::initialiseFromRenderSystemCapabilities");
+        }
+
+        // Depth is tracked from the first draw call, so that the first
+        // queries are answered against everything rendered before them
+        mTrackDepth = caps->hasCapability(RSC_HWOCCLUSION);
+
+        mHardwareBufferManager = OGRE_NEW NullHardwareBufferManager(this);
+        mGpuProgramManager = OGRE_NEW NullGpuProgramManager();
+
+        const char* languages[] = { "glsl", "hlsl", "cg" };
+        for (size_t i = 0; i < sizeof(languages) / sizeof(languages[0]); ++i)
+        {
+            NullHighLevelGpuProgramFactory* factory = OGRE_NEW NullHighLevelGpuProgramFactory(languages[i]);
+            HighLevelGpuProgramManager::getSingleton().addFactory(factory);
+            mProgramFactories.push_back(factory);
+        }
+
+        Log* defaultLog = LogManager::getSingleton().getDefaultLog();
+        if (defaultLog)
+        {
+            caps->log(defaultLog);
+        }
+
+        mInitialised = true;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::reinitialise(void)
+    {
+        this->shutdown();
+        this->_initialise(true);
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::shutdown(void)
+    {
+        RenderSystem::shutdown();
+
+        for (size_t i = 0; i < mProgramFactories.size(); ++i)
+        {
+            // Remove from manager safely
+            if (HighLevelGpuProgramManager::getSingletonPtr())
+                HighLevelGpuProgramManager::getSingleton().removeFactory(mProgramFactories[i]);
+            OGRE_DELETE mProgramFactories[i];
+        }
+        mProgramFactories.clear();
+
+        OGRE_DELETE mGpuProgramManager;
+        mGpuProgramManager = 0;
+
+        OGRE_DELETE mHardwareBufferManager;
+        mHardwareBufferManager = 0;
+
+        OGRE_DELETE mTextureManager;
+        mTextureManager = 0;
+
+        // Capabilities are created again with the next primary window
+        if (mCurrentCapabilities == mRealCapabilities)
+            mCurrentCapabilities = 0;
+        OGRE_DELETE mRealCapabilities;
+        mRealCapabilities = 0;
+
+        mInitialised = false;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::getCustomAttribute(const String& name, void* pData)
+    {
+        if (name == "FRAME_STATS")
+        {
+            *static_cast<NullFrameStats*>(pData) = getFrameStats();
+            return;
+        }
+        else if (name == "LAST_FRAME_STATS")
+        {
+            *static_cast<NullFrameStats*>(pData) = mLastFrameStats;
+            return;
+        }
+
+        RenderSystem::getCustomAttribute(name, pData);
+    }
+    //-----------------------------------------------------------------------
+    NullFrameStats NullRenderSystem::getFrameStats(void) const
+    {
+        NullFrameStats stats = mFrameStats;
+        stats.bytesUploaded = mBytesUploaded.get();
+        return stats;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::resetFrameStats(void)
+    {
+        mFrameStats.reset();
+        mLastFrameStats.reset();
+        mBytesUploaded.set(0);
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_swapAllRenderTargetBuffers()
+    {
+        RenderSystem::_swapAllRenderTargetBuffers();
+
+        // The swap marks the end of the frame; uploads racing with this are
+        // kept for the next frame rather than lost
+        size_t bytes = mBytesUploaded.get();
+        mBytesUploaded -= bytes;
+        mLastFrameStats = mFrameStats;
+        mLastFrameStats.bytesUploaded = bytes;
+        mFrameStats.reset();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::setAmbientLight(float r, float g, float b)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::setShadingType(ShadeOptions so)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::setLightingEnabled(bool enabled)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    RenderWindow* NullRenderSystem::_createRenderWindow(const String &name, unsigned int width, unsigned int height, 
+        bool fullScreen, const NameValuePairList *miscParams)
+    {
+        if (mRenderTargets.find(name) != mRenderTargets.end())
+        {
+            OGRE_EXCEPT(
+                Exception::ERR_INVALIDPARAMS,
+                "Window with name '" + name + "' already exists",
+                "NullRenderSystem::_createRenderWindow" );
+        }
+
+        LogManager::getSingleton().stream() << "NullRenderSystem::_createRenderWindow \"" << name << "\", " <<
+            width << "x" << height << (fullScreen ? " fullscreen" : " windowed");
+
+        NullRenderWindow* win = OGRE_NEW NullRenderWindow();
+        win->create(name, width, height, fullScreen, miscParams);
+
+        attachRenderTarget(*win);
+
+        if (!mInitialised)
+        {
+            // Initialise after the first window has been created
+            mRealCapabilities = createRenderSystemCapabilities();
+
+            // use real capabilities if custom capabilities are not available
+            if (!mUseCustomCapabilities)
+                mCurrentCapabilities = mRealCapabilities;
+
+            fireEvent("RenderSystemCapabilitiesCreated");
+
+            initialiseFromRenderSystemCapabilities(mCurrentCapabilities, win);
+        }
+
+        if (win->getDepthBufferPool() != DepthBuffer::POOL_NO_DEPTH)
+        {
+            DepthBuffer* depthBuffer = OGRE_NEW DepthBuffer(DepthBuffer::POOL_DEFAULT, 32,
+                win->getWidth(), win->getHeight(), win->getFSAA(), win->getFSAAHint(), true);
+            mDepthBufferPool[depthBuffer->getPoolId()].push_back(depthBuffer);
+            win->attachDepthBuffer(depthBuffer);
+        }
+
+        return win;
+    }
+    //-----------------------------------------------------------------------
+    DepthBuffer* NullRenderSystem::_createDepthBufferFor(RenderTarget *renderTarget)
+    {
+        return OGRE_NEW DepthBuffer(DepthBuffer::POOL_DEFAULT, 32, renderTarget->getWidth(), 
+            renderTarget->getHeight(), renderTarget->getFSAA(), renderTarget->getFSAAHint(), false);
+    }
+    //-----------------------------------------------------------------------
+    MultiRenderTarget* NullRenderSystem::createMultiRenderTarget(const String & name)
+    {
+        MultiRenderTarget* retval = OGRE_NEW NullMultiRenderTarget(name);
+        attachRenderTarget(*retval);
+        return retval;
+    }
+    //-----------------------------------------------------------------------
+    HardwareOcclusionQuery* NullRenderSystem::createHardwareOcclusionQuery(void)
+    {
+        NullHardwareOcclusionQuery* ret = OGRE_NEW NullHardwareOcclusionQuery(this);
+        mHwOcclusionQueries.push_back(ret);
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    String NullRenderSystem::getErrorDescription(long errorNumber) const
+    {
+        return "Null Rendering Subsystem error " + StringConverter::toString(errorNumber);
+    }
+    //-----------------------------------------------------------------------
+    VertexElementType NullRenderSystem::getColourVertexElementType(void) const
+    {
+        return VET_COLOUR_ABGR;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::setNormaliseNormals(bool normalise)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_useLights(const LightList& lights, unsigned short limit)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setWorldMatrix(const Matrix4 &m)
+    {
+        mWorldMatrix = m;
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setViewMatrix(const Matrix4 &m)
+    {
+        mViewMatrix = m;
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setProjectionMatrix(const Matrix4 &m)
+    {
+        mProjMatrix = m;
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setSurfaceParams(const ColourValue &ambient,
+        const ColourValue &diffuse, const ColourValue &specular,
+        const ColourValue &emissive, Real shininess,
+        TrackVertexColourType tracking)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setPointSpritesEnabled(bool enabled)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setPointParameters(Real size, bool attenuationEnabled, 
+        Real constant, Real linear, Real quadratic, Real minSize, Real maxSize)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setTexture(size_t unit, bool enabled, const TexturePtr &tex)
+    {
+        ++mFrameStats.textureBinds;
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setGeometryTexture(size_t unit, const TexturePtr &tex)
+    {
+        _setTexture(unit, true, tex);
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setTextureCoordSet(size_t unit, size_t index)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setTextureCoordCalculation(size_t unit, TexCoordCalcMethod m, 
+        const Frustum* frustum)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setTextureBlendMode(size_t unit, const LayerBlendModeEx& bm)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setTextureUnitFiltering(size_t unit, FilterType ftype, FilterOptions filter)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setTextureUnitCompareEnabled(size_t unit, bool compare)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setTextureUnitCompareFunction(size_t unit, CompareFunction function)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setTextureLayerAnisotropy(size_t unit, unsigned int maxAnisotropy)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setTextureAddressingMode(size_t unit, const TextureUnitState::UVWAddressingMode& uvw)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setTextureBorderColour(size_t unit, const ColourValue& colour)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setTextureMipmapBias(size_t unit, float bias)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setTextureMatrix(size_t unit, const Matrix4& xform)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setSceneBlending(SceneBlendFactor sourceFactor, SceneBlendFactor destFactor, SceneBlendOperation op)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setSeparateSceneBlending(SceneBlendFactor sourceFactor, SceneBlendFactor destFactor, 
+        SceneBlendFactor sourceFactorAlpha, SceneBlendFactor destFactorAlpha, SceneBlendOperation op, SceneBlendOperation alphaOp)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setAlphaRejectSettings(CompareFunction func, unsigned char value, bool alphaToCoverage)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_beginFrame(void)
+    {
+        if (!mActiveViewport)
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+                "Cannot begin frame - no viewport selected.", 
+                "NullRenderSystem::_beginFrame");
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_endFrame(void)
+    {
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setViewport(Viewport *vp)
+    {
+        // Check if viewport is different
+        if (!vp)
+        {
+            mActiveViewport = NULL;
+            _setRenderTarget(NULL);
+        }
+        else if (vp != mActiveViewport || vp->_isUpdated())
+        {
+            _setRenderTarget(vp->getTarget());
+            mActiveViewport = vp;
+            _stateChanged();
+
+            vp->_clearUpdatedFlag();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setRenderTarget(RenderTarget *target)
+    {
+        if (target == mActiveRenderTarget)
+            return;
+
+        mActiveRenderTarget = target;
+        if (target)
+        {
+            ++mFrameStats.renderTargetChanges;
+
+            // Check the depth buffer status
+            if (target->getDepthBufferPool() != DepthBuffer::POOL_NO_DEPTH && !target->getDepthBuffer())
+                setDepthBufferFor(target);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setCullingMode(CullingMode mode)
+    {
+        mCullingMode = mode;
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setDepthBufferParams(bool depthTest, bool depthWrite, CompareFunction depthFunction)
+    {
+        mDepthCheck = depthTest;
+        mDepthWrite = depthWrite;
+        mDepthFunc = depthFunction;
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setDepthBufferCheckEnabled(bool enabled)
+    {
+        mDepthCheck = enabled;
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setDepthBufferWriteEnabled(bool enabled)
+    {
+        mDepthWrite = enabled;
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setDepthBufferFunction(CompareFunction func)
+    {
+        mDepthFunc = func;
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setColourBufferWriteEnabled(bool red, bool green, bool blue, bool alpha)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setDepthBias(float constantBias, float slopeScaleBias)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setFog(FogMode mode, const ColourValue& colour, Real expDensity, Real linearStart, Real linearEnd)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_setPolygonMode(PolygonMode level)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::setStencilCheckEnabled(bool enabled)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::setStencilBufferParams(CompareFunction func, 
+        uint32 refValue, uint32 compareMask, uint32 writeMask, StencilOperation stencilFailOp, 
+        StencilOperation depthFailOp, StencilOperation passOp, 
+        bool twoSidedOperation, bool readBackAsTexture)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::setVertexDeclaration(VertexDeclaration* decl)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::setVertexBufferBinding(VertexBufferBinding* binding)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::setClipPlanesImpl(const PlaneList& clipPlanes)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::setScissorTest(bool enabled, size_t left, size_t top, size_t right, size_t bottom)
+    {
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_render(const RenderOperation& op)
+    {
+        size_t faceCount = mFaceCount;
+        size_t vertexCount = mVertexCount;
+
+        // Call super class, which updates the geometry counts
+        RenderSystem::_render(op);
+
+        ++mFrameStats.drawCalls;
+        mFrameStats.primitives += mFaceCount - faceCount;
+        mFrameStats.vertices += mVertexCount - vertexCount;
+
+        // Only pay for the rasterisation when something may ask for it
+        if (mTrackDepth)
+        {
+            mRasteriser.setTransform(mProjMatrix * mViewMatrix * mWorldMatrix);
+            mRasteriser.setDepthState(mDepthCheck, mDepthWrite, mDepthFunc);
+            mSamplesPassed += mRasteriser.rasterise(op);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::bindGpuProgram(GpuProgram* prg)
+    {
+        RenderSystem::bindGpuProgram(prg);
+        ++mFrameStats.gpuProgramBinds;
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::unbindGpuProgram(GpuProgramType gptype)
+    {
+        RenderSystem::unbindGpuProgram(gptype);
+        ++mFrameStats.gpuProgramBinds;
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::bindGpuProgramParameters(GpuProgramType gptype, 
+        GpuProgramParametersSharedPtr params, uint16 variabilityMask)
+    {
+        ++mFrameStats.parameterBinds;
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::bindGpuProgramPassIterationParameters(GpuProgramType gptype)
+    {
+        ++mFrameStats.parameterBinds;
+        _stateChanged();
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::clearFrameBuffer(unsigned int buffers, 
+        const ColourValue& colour, Real depth, unsigned short stencil)
+    {
+        ++mFrameStats.clears;
+        if (buffers & FBT_DEPTH)
+            mRasteriser.clearDepth(depth);
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_convertProjectionMatrix(const Matrix4& matrix,
+        Matrix4& dest, bool forGpuProgram)
+    {
+        // Depth is kept in [-1,1] like OpenGL, so no conversion is needed
+        dest = matrix;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_makeProjectionMatrix(const Radian& fovy, Real aspect, Real nearPlane, 
+        Real farPlane, Matrix4& dest, bool forGpuProgram)
+    {
+        Radian thetaY (fovy / 2.0f);
+        Real tanThetaY = Math::Tan(thetaY);
+
+        // Calc matrix elements
+        Real w = (1.0f / tanThetaY) / aspect;
+        Real h = 1.0f / tanThetaY;
+        Real q, qn;
+        if (farPlane == 0)
+        {
+            // Infinite far plane
+            q = Frustum::INFINITE_FAR_PLANE_ADJUST - 1;
+            qn = nearPlane * (Frustum::INFINITE_FAR_PLANE_ADJUST - 2);
+        }
+        else
+        {
+            q = -(farPlane + nearPlane) / (farPlane - nearPlane);
+            qn = -2 * (farPlane * nearPlane) / (farPlane - nearPlane);
+        }
+
+        dest = Matrix4::ZERO;
+        dest[0][0] = w;
+        dest[1][1] = h;
+        dest[2][2] = q;
+        dest[2][3] = qn;
+        dest[3][2] = -1;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_makeProjectionMatrix(Real left, Real right, Real bottom, Real top, 
+        Real nearPlane, Real farPlane, Matrix4& dest, bool forGpuProgram)
+    {
+        Real width = right - left;
+        Real height = top - bottom;
+        Real q, qn;
+        if (farPlane == 0)
+        {
+            // Infinite far plane
+            q = Frustum::INFINITE_FAR_PLANE_ADJUST - 1;
+            qn = nearPlane * (Frustum::INFINITE_FAR_PLANE_ADJUST - 2);
+        }
+        else
+        {
+            q = -(farPlane + nearPlane) / (farPlane - nearPlane);
+            qn = -2 * (farPlane * nearPlane) / (farPlane - nearPlane);
+        }
+        dest = Matrix4::ZERO;
+        dest[0][0] = 2 * nearPlane / width;
+        dest[0][2] = (right+left) / width;
+        dest[1][1] = 2 * nearPlane / height;
+        dest[1][2] = (top+bottom) / height;
+        dest[2][2] = q;
+        dest[2][3] = qn;
+        dest[3][2] = -1;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_makeOrthoMatrix(const Radian& fovy, Real aspect, Real nearPlane, 
+        Real farPlane, Matrix4& dest, bool forGpuProgram)
+    {
+        Radian thetaY (fovy / 2.0f);
+        Real tanThetaY = Math::Tan(thetaY);
+
+        Real tanThetaX = tanThetaY * aspect;
+        Real half_w = tanThetaX * nearPlane;
+        Real half_h = tanThetaY * nearPlane;
+        Real iw = 1.0f / half_w;
+        Real ih = 1.0f / half_h;
+        Real q;
+        if (farPlane == 0)
+        {
+            q = 0;
+        }
+        else
+        {
+            q = 2.0f / (farPlane - nearPlane);
+        }
+        dest = Matrix4::ZERO;
+        dest[0][0] = iw;
+        dest[1][1] = ih;
+        dest[2][2] = -q;
+        dest[2][3] = - (farPlane + nearPlane)/(farPlane - nearPlane);
+        dest[3][3] = 1;
+    }
+    //-----------------------------------------------------------------------
+    void NullRenderSystem::_applyObliqueDepthProjection(Matrix4& matrix, const Plane& plane, 
+        bool forGpuProgram)
+    {
+        // Calculate the clip-space corner point opposite the clipping plane
+        // as (sgn(clipPlane.x), sgn(clipPlane.y), 1, 1) and
+        // transform it into camera space by multiplying it
+        // by the inverse of the projection matrix
+        Vector4 q;
+        q.x = (Math::Sign(plane.normal.x) + matrix[0][2]) / matrix[0][0];
+        q.y = (Math::Sign(plane.normal.y) + matrix[1][2]) / matrix[1][1];
+        q.z = -1.0F;
+        q.w = (1.0F + matrix[2][2]) / matrix[2][3];
+
+        // Calculate the scaled plane vector
+        Vector4 clipPlane4d(plane.normal.x, plane.normal.y, plane.normal.z, plane.d);
+        Vector4 c = clipPlane4d * (2.0F / (clipPlane4d.dotProduct(q)));
+
+        // Replace the third row of the projection matrix
+        matrix[2][0] = c.x;
+        matrix[2][1] = c.y;
+        matrix[2][2] = c.z + 1.0F;
+        matrix[2][3] = c.w;
+    }
+    //-----------------------------------------------------------------------
+    Real NullRenderSystem::getHorizontalTexelOffset(void)
+    {
+        return 0.0f;
+    }
+    //-----------------------------------------------------------------------
+    Real NullRenderSystem::getVerticalTexelOffset(void)
+    {
+        return 0.0f;
+    }
+    //-----------------------------------------------------------------------
+    Real NullRenderSystem::getMinimumDepthInputValue(void)
+    {
+        return -1.0f;
+    }
+    //-----------------------------------------------------------------------
+    Real NullRenderSystem::getMaximumDepthInputValue(void)
+    {
+        return 1.0f;
+    }
+}
@@ -0,0 +1,201 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreNullTexture.h"
+#include "OgreNullHardwarePixelBuffer.h"
+#include "OgreNullRenderSystem.h"
+#include "OgreTextureManager.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreException.h"
+#include "OgreStringConverter.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------------
+    NullTexture::NullTexture(ResourceManager* creator, const String& name, 
+        ResourceHandle handle, const String& group, bool isManual, 
+        ManualResourceLoader* loader, NullRenderSystem* rs) 
+        : Texture(creator, name, handle, group, isManual, loader),
+          mRenderSystem(rs)
+    {
+    }
+    //-----------------------------------------------------------------------------
+    NullTexture::~NullTexture()
+    {
+        // have to call this here rather than in Resource destructor
+        // since calling virtual methods in base destructors causes crash
+        if (isLoaded())
+        {
+            unload(); 
+        }
+        else
+        {
+            freeInternalResources();
+        }
+    }
+    //-----------------------------------------------------------------------------
+    void NullTexture::createInternalResourcesImpl(void)
+    {
+        // Adjust format if required
+        mFormat = TextureManager::getSingleton().getNativeFormat(mTextureType, mFormat, mUsage);
+
+        // Check requested number of mipmaps
+        size_t maxMips = 0;
+        for (uint32 dim = std::max(std::max(mWidth, mHeight), mDepth); dim > 1; dim >>= 1)
+            ++maxMips;
+        mNumMipmaps = mNumRequestedMipmaps;
+        if (mNumMipmaps > maxMips)
+            mNumMipmaps = maxMips;
+
+        mMipmapsHardwareGenerated = 
+            mRenderSystem->getCapabilities()->hasCapability(RSC_AUTOMIPMAP);
+
+        // Create a surface for all faces and mipmaps
+        mSurfaceList.clear();
+        for (size_t face = 0; face < getNumFaces(); ++face)
+        {
+            uint32 width = mWidth;
+            uint32 height = mHeight;
+            uint32 depth = mDepth;
+            for (uint8 mip = 0; mip <= mNumMipmaps; ++mip)
+            {
+                String name = mName + "/face" + StringConverter::toString(face) + 
+                    "/mip" + StringConverter::toString(mip);
+                // Only the top level is ever rendered to
+                int usage = mip == 0 ? mUsage : (mUsage & ~TU_RENDERTARGET);
+                NullHardwarePixelBuffer* buf = OGRE_NEW NullHardwarePixelBuffer(mRenderSystem, name,
+                    width, height, depth, mFormat, static_cast<HardwareBuffer::Usage>(usage));
+                mSurfaceList.push_back(HardwarePixelBufferSharedPtr(buf));
+
+                if (width > 1)
+                    width = width / 2;
+                if (height > 1)
+                    height = height / 2;
+                if (depth > 1 && mTextureType != TEX_TYPE_2D_ARRAY)
+                    depth = depth / 2;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------------
+    static inline void do_image_io(const String &name, const String &group,
+                                   const String &ext,
+                                   vector<Image>::type &images,
+                                   Resource *r)
+    {
+        size_t imgIdx = images.size();
+        images.push_back(Image());
+
+        DataStreamPtr dstream = 
+            ResourceGroupManager::getSingleton().openResource(
+                name, group, true, r);
+
+        images[imgIdx].load(dstream, ext);
+    }
+    //-----------------------------------------------------------------------------
+    void NullTexture::prepareImpl(void)
+    {
+        if (mUsage & TU_RENDERTARGET) return;
+
+        String baseName, ext;
+        size_t pos = mName.find_last_of(".");
+        baseName = mName.substr(0, pos);
+        if (pos != String::npos)
+            ext = mName.substr(pos+1);
+
+        LoadedImages loadedImages = LoadedImages(new vector<Image>::type());
+
+        if (mTextureType == TEX_TYPE_CUBE_MAP && getSourceFileType() != "dds")
+        {
+            static const String suffixes[6] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
+
+            for (size_t i = 0; i < 6; i++)
+            {
+                String fullName = baseName + suffixes[i];
+                if (!ext.empty())
+                    fullName = fullName + "." + ext;
+                do_image_io(fullName, mGroup, ext, *loadedImages, this);
+            }
+        }
+        else
+        {
+            do_image_io(mName, mGroup, ext, *loadedImages, this);
+
+            // If this is a cube map, set the texture type flag accordingly.
+            if ((*loadedImages)[0].hasFlag(IF_CUBEMAP))
+                mTextureType = TEX_TYPE_CUBE_MAP;
+            // If this is a volumetric texture set the texture type flag accordingly.
+            if ((*loadedImages)[0].getDepth() > 1 && mTextureType != TEX_TYPE_2D_ARRAY)
+                mTextureType = TEX_TYPE_3D;
+        }
+
+        mLoadedImages = loadedImages;
+    }
+    //-----------------------------------------------------------------------------
+    void NullTexture::unprepareImpl(void)
+    {
+        mLoadedImages.setNull();
+    }
+    //-----------------------------------------------------------------------------
+    void NullTexture::loadImpl(void)
+    {
+        if (mUsage & TU_RENDERTARGET)
+        {
+            createInternalResources();
+            return;
+        }
+
+        // Now the only copy is on the stack and will be cleaned in case of
+        // exceptions being thrown from _loadImages
+        LoadedImages loadedImages = mLoadedImages;
+        mLoadedImages.setNull();
+
+        ConstImagePtrList imagePtrs;
+        for (size_t i = 0; i < loadedImages->size(); ++i)
+        {
+            imagePtrs.push_back(&(*loadedImages)[i]);
+        }
+
+        _loadImages(imagePtrs);
+    }
+    //-----------------------------------------------------------------------------
+    void NullTexture::freeInternalResourcesImpl(void)
+    {
+        mSurfaceList.clear();
+    }
+    //-----------------------------------------------------------------------------
+    HardwarePixelBufferSharedPtr NullTexture::getBuffer(size_t face, size_t mipmap)
+    {
+        if (face >= getNumFaces())
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Face index out of range",
+                    "NullTexture::getBuffer");
+        if (mipmap > mNumMipmaps)
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Mipmap index out of range",
+                    "NullTexture::getBuffer");
+        size_t idx = face * (mNumMipmaps + 1) + mipmap;
+        assert(idx < mSurfaceList.size());
+        return mSurfaceList[idx];
+    }
+}
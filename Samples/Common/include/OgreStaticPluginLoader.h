@@ -29,6 +29,9 @@ Description: Utility class to load plugins statically
 #ifdef OGRE_STATIC_CgProgramManager
 #  include "OgreCgPlugin.h"
 #endif
+#ifdef OGRE_STATIC_BVHSceneManager
+#  include "OgreBvhPlugin.h"
+#endif
 #ifdef OGRE_STATIC_OctreeSceneManager
 #  include "OgreOctreePlugin.h"
 #endif
@@ -56,6 +59,9 @@ Description: Utility class to load plugins statically
 #ifdef OGRE_STATIC_Direct3D11
 #  include "OgreD3D11Plugin.h"
 #endif
+#ifdef OGRE_STATIC_Null
+#  include "OgreNullPlugin.h"
+#endif
 #ifdef OGRE_STATIC_PCZSceneManager
 #  include "OgrePCZPlugin.h"
 #endif
@@ -80,6 +86,9 @@ namespace Ogre
 #ifdef OGRE_STATIC_CgProgramManager
         CgPlugin* mCgPlugin;
 #endif
+#ifdef OGRE_STATIC_BVHSceneManager
+        BvhPlugin* mBvhPlugin;
+#endif
 #ifdef OGRE_STATIC_OctreeSceneManager
         OctreePlugin* mOctreePlugin;
 #endif
@@ -112,6 +121,9 @@ namespace Ogre
 #endif
 #ifdef OGRE_STATIC_Direct3D11
         D3D11Plugin* mD3D11Plugin;
+#endif
+#ifdef OGRE_STATIC_Null
+        NullPlugin* mNullPlugin;
 #endif
     public:
         StaticPluginLoader() {}
@@ -145,10 +157,18 @@ namespace Ogre
             mD3D11Plugin = OGRE_NEW D3D11Plugin();
             root.installPlugin(mD3D11Plugin);
 #endif
+#ifdef OGRE_STATIC_Null
+            mNullPlugin = OGRE_NEW NullPlugin();
+            root.installPlugin(mNullPlugin);
+#endif
 #ifdef OGRE_STATIC_CgProgramManager
             mCgPlugin = OGRE_NEW CgPlugin();
             root.installPlugin(mCgPlugin);
 #endif
+#ifdef OGRE_STATIC_BVHSceneManager
+            mBvhPlugin = OGRE_NEW BvhPlugin();
+            root.installPlugin(mBvhPlugin);
+#endif
 #ifdef OGRE_STATIC_OctreeSceneManager
             mOctreePlugin = OGRE_NEW OctreePlugin();
             root.installPlugin(mOctreePlugin);
@@ -189,6 +209,9 @@ namespace Ogre
 #ifdef OGRE_STATIC_OctreeSceneManager
             OGRE_DELETE mOctreePlugin;
 #endif
+#ifdef OGRE_STATIC_BVHSceneManager
+            OGRE_DELETE mBvhPlugin;
+#endif
 #ifdef OGRE_STATIC_CgProgramManager
             OGRE_DELETE mCgPlugin;
 #endif
@@ -210,6 +233,9 @@ namespace Ogre
 #ifdef OGRE_STATIC_GLES2
             OGRE_DELETE mGLES2Plugin;
 #endif
+#ifdef OGRE_STATIC_Null
+            OGRE_DELETE mNullPlugin;
+#endif
             
         }
 
@@ -53,6 +53,9 @@
 #  ifdef OGRE_BUILD_RENDERSYSTEM_D3D9
 #     define OGRE_STATIC_Direct3D9
 #  endif
+#  ifdef OGRE_BUILD_RENDERSYSTEM_NULL
+#    define OGRE_STATIC_Null
+#  endif
 // dx11 will only work on vista and above, so be careful about statically linking
 #  ifdef OGRE_BUILD_RENDERSYSTEM_D3D11
 #    define OGRE_STATIC_Direct3D11
@@ -67,6 +70,9 @@
 #  ifdef OGRE_BUILD_PLUGIN_CG
 #  define OGRE_STATIC_CgProgramManager
 #  endif
+#  ifdef OGRE_BUILD_PLUGIN_BVH
+#  define OGRE_STATIC_BVHSceneManager
+#  endif
 
 #  ifdef OGRE_USE_PCZ
 #    ifdef OGRE_BUILD_PLUGIN_PCZ
@@ -39,6 +39,7 @@ public:
     virtual bool isVisible(const AxisAlignedBox& bound, FrustumPlane* culledBy = 0) const {return true;};
     virtual bool isVisible(const Sphere& bound, FrustumPlane* culledBy = 0) const {return true;};
     virtual bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const {return true;};
+    virtual void areVisible(const AxisAlignedBox* const* bounds, size_t count, bool* visible) const {std::fill(visible, visible + count, true);};
     bool projectSphere(const Sphere& sphere, 
         Real* left, Real* top, Real* right, Real* bottom) const {*left = *bottom = -1.0f; *right = *top = 1.0f; return true;};
     Real getNearClipDistance(void) const {return 1.0;};
@@ -0,0 +1,231 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __BenchmarkContext_H__
+#define __BenchmarkContext_H__
+
+#include "Ogre.h"
+#include "SampleContext.h"
+#include "SamplePlugin.h"
+#include "DynamicSceneQueries.h"
+#include "FrameStageCollector.h"
+#include "MediaLoading.h"
+#include "OptimisedUtilKernels.h"
+#include "SceneKernels.h"
+#include "SharedClipCrowd.h"
+#include "SkinnedCrowd.h"
+#include "StencilShadowCasters.h"
+#include "ZipPackLoading.h"
+#include "ResourceGroupLoading.h"
+
+#include <iostream> // for Apple
+
+#ifdef INCLUDE_RTSHADER_SYSTEM
+#include "ShaderGeneratorTechniqueResolverListener.h"
+#endif
+
+using namespace Ogre;
+
+/** Runs a fixed set of sample scenes for a number of frames and reports the
+    CPU time spent in each stage of the frame as JSON.
+@remarks
+    Samples are loaded from the plugins listed in samples.cfg and stepped with
+    a fixed timestep through Root::renderOneFrame, without input devices or
+    an event loop. Per-stage timings come from the Profiler, so OGRE must be
+    built with OGRE_PROFILING for anything beyond whole-frame times to be
+    reported. With the Null render system the draw call and upload counters
+    it keeps are reported alongside. A crowd of skinned characters built in
+    to the benchmark is run last, once per requested animation thread count,
+    followed by a crowd playing shared animations, without then with the
+    skeleton animation cache, and the stencil shadow visual test scene with
+    many more casters, once per requested shadow volume thread count, and a
+    scene of moving objects queried every frame, once per requested scene
+    manager type.
+    Finally the OptimisedUtil functions of every implementation the CPU
+    supports are timed on their own.
+@par
+    Before any sample runs, the meshes and images of the Samples media are
+    loaded once per requested file system archive mode, streamed or memory
+    mapped, reporting the time taken and the peak resident size. Then every
+    file of the Samples zip packs is inflated once per requested thread count.
+*/
+class BenchmarkContext : public OgreBites::SampleContext
+{
+ public:
+
+    BenchmarkContext(int argc = 0, char** argv = 0);
+    virtual ~BenchmarkContext();
+
+    /** Setup the Root */
+    virtual void createRoot();
+
+    /** Selects the render system from the command line, never shows a dialog */
+    virtual bool oneTimeConfig();
+
+    /** Does basic setup for the context */
+    virtual void setup();
+
+    /** No input devices are needed, and the Null render system has no window to grab */
+    virtual void setupInput(bool nograb = false) {}
+
+    /** Runs every selected sample in turn then writes the results */
+    virtual void go(OgreBites::Sample* initialSample = 0);
+
+    /** Passes a fixed timestep to the running sample */
+    virtual bool frameStarted(const FrameEvent& evt);
+
+    /** Passes a fixed timestep to the running sample */
+    virtual bool frameRenderingQueued(const FrameEvent& evt);
+
+    /** Passes a fixed timestep to the running sample */
+    virtual bool frameEnded(const FrameEvent& evt);
+
+    /** Runs the given sample, hooking up the shader generator if there is one */
+    virtual void runSample(OgreBites::Sample* s);
+
+ protected:
+
+    /// Results for one sample
+    struct SampleResult
+    {
+        String plugin;
+        String title;
+        /// Empty if the sample ran, otherwise why it was skipped
+        String skipReason;
+        /// Wall clock time of Root::renderOneFrame
+        StageStats frameTime;
+        FrameStageCollector::StageStatsMap stages;
+        /// Per frame counters from the render system, if it keeps any
+        std::map<String, StageStats> renderStats;
+        /// Per frame allocation counters
+        std::map<String, StageStats> memoryStats;
+        /// Per frame skeleton update and animation cache counters
+        std::map<String, StageStats> animationStats;
+    };
+    typedef std::vector<SampleResult> SampleResultList;
+
+    /// Throughput of the OptimisedUtil functions, per implementation name
+    typedef std::vector<std::pair<String, OptimisedUtilKernels::ThroughputMap> > KernelResultList;
+
+    /** Loads the requested sample plugins
+     *        @return The samples to benchmark, paired with their plugin name */
+    std::vector<std::pair<String, OgreBites::Sample*> > loadSamples();
+
+    /** Runs one sample for the warmup and measured frames */
+    SampleResult benchmarkSample(const String& plugin, OgreBites::Sample* s);
+
+    /** Reads the render system's counters for the frame just finished */
+    void recordRenderStats(SampleResult& result);
+
+    /** Reads the allocation counters for the frame just finished */
+    void recordMemoryStats(SampleResult& result);
+
+    /** Reads the skeleton counters of the scene managers for the frame just finished */
+    void recordAnimationStats(SampleResult& result);
+
+    /** Times the OptimisedUtil functions of each available implementation */
+    void benchmarkKernels();
+
+    /** Times the scene graph update, culling and render queue sorting */
+    void benchmarkSceneKernels();
+
+    /** Loads the media once per requested file system archive mode */
+    void benchmarkMediaLoading();
+
+    /** Loads every file of the zip packs once per requested thread count */
+    void benchmarkZipPackLoading();
+
+    /** Loads the requested resource groups once per requested loading thread count */
+    void benchmarkResourceGroupLoading();
+
+    /** Writes all results as a JSON document */
+    void writeResults(const String& filename);
+
+#ifdef INCLUDE_RTSHADER_SYSTEM
+    bool initialiseRTShaderSystem();
+    void finaliseRTShaderSystem();
+#endif
+
+    /// The timestep passed to samples and controllers each frame
+    Real mTimestep;
+    /// Number of frames measured per sample
+    size_t mFrameCount;
+    /// Number of frames run before measuring
+    size_t mWarmupFrames;
+    /// Name of the render system to use
+    String mRenderSystemName;
+    /// Where to write the JSON results
+    String mOutputFile;
+    /// The sample plugins to run, without any debug suffix
+    StringVector mSamplePlugins;
+    /// Number of characters in the built-in skinned crowd, 0 to skip it
+    size_t mCrowdSize;
+    /// Animation thread counts to run the skinned crowd with
+    std::vector<size_t> mAnimationThreadCounts;
+    /// Number of characters in the built-in shared clip crowd, 0 to skip it
+    size_t mSharedCrowdSize;
+    /// Number of vertices the OptimisedUtil functions are timed with, 0 to skip them
+    size_t mKernelVertices;
+    /// Number of nodes, boxes and renderables the scene manager is timed with, 0 to skip it
+    size_t mSceneKernelElements;
+    /// Number of copies of the casters of the stencil shadow scene, 0 to skip it
+    size_t mShadowCasterCount;
+    /// Shadow volume thread counts to run the stencil shadow scene with
+    std::vector<size_t> mShadowVolumeThreadCounts;
+    /// Number of objects in the dynamic query scene, 0 to skip it
+    size_t mDynamicObjectCount;
+    /// Scene manager types to run the dynamic query scene with
+    StringVector mDynamicSceneManagerTypes;
+    /// Batched query thread counts to run the dynamic query scene with
+    std::vector<size_t> mSceneQueryThreadCounts;
+    /// File system archive modes to load the media with, "stream" or "mapped"
+    StringVector mMediaLoadingModes;
+    /// Thread counts to load the zip packs with
+    std::vector<size_t> mZipPackThreadCounts;
+    /// Resource groups to load, and the loading thread counts to load them with
+    StringVector mLoadingGroups;
+    std::vector<size_t> mLoadingThreadCounts;
+    /// The profile names reported for every sample
+    StringVector mStageNames;
+    bool mHelp;
+
+    FrameStageCollector* mCollector;
+    SampleResultList mResults;
+    KernelResultList mKernelResults;
+    SceneKernels::ThroughputMap mSceneKernelResults;
+    std::vector<MediaLoading::Result> mMediaResults;
+    std::vector<ZipPackLoading::Result> mZipPackResults;
+    std::vector<ResourceGroupLoading::Result> mGroupLoadingResults;
+
+#ifdef INCLUDE_RTSHADER_SYSTEM
+    RTShader::ShaderGenerator* mShaderGenerator;
+    OgreBites::ShaderGeneratorTechniqueResolverListener* mMaterialMgrListener;
+#endif
+};
+
+#endif
@@ -0,0 +1,189 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __DynamicSceneQueries_H__
+#define __DynamicSceneQueries_H__
+
+#include "SdkSample.h"
+
+using namespace Ogre;
+using namespace OgreBites;
+
+/** A scene of objects of very different sizes, half of them moving, queried
+    with rays and spheres every frame, for comparing the spatial structures
+    of the scene manager plugins.
+@remarks
+    The scene is created with the scene manager of the given type, so the same
+    scene can be run with OctreeSceneManager and BvhSceneManager. Most objects
+    are small, some are a hundred times larger, and the moving ones bounce
+    around inside the world so that the structure has to follow them. The
+    queries are profiled as "SceneQueries", then the same rays and spheres
+    are run again through the batched queries of the SceneManager, with the
+    given number of threads, as "BatchedSceneQueries".
+*/
+class Sample_DynamicSceneQueries : public SdkSample
+{
+public:
+    Sample_DynamicSceneQueries(const String& sceneManagerType, size_t numObjects, size_t queryThreads)
+        : mSceneManagerType(sceneManagerType), mNumObjects(numObjects), mQueryThreads(queryThreads)
+    {
+        mInfo["Title"] = "Dynamic Scene Queries (" + sceneManagerType + ", " +
+            StringConverter::toString(numObjects) + " objects, " +
+            StringConverter::toString(queryThreads) + " query threads)";
+        mInfo["Description"] = "Many moving objects of mixed sizes, queried with rays and spheres.";
+        mInfo["Category"] = "Unsorted";
+    }
+
+    bool frameRenderingQueued(const FrameEvent& evt)
+    {
+        const Real halfWorld = WORLD_SIZE * 0.5f;
+        for (size_t i = 0; i < mMovingNodes.size(); ++i)
+        {
+            Vector3 pos = mMovingNodes[i]->getPosition() + mVelocities[i] * evt.timeSinceLastFrame;
+            for (int c = 0; c < 3; ++c)
+            {
+                if (Math::Abs(pos[c]) > halfWorld)
+                    mVelocities[i][c] = -mVelocities[i][c];
+            }
+            mMovingNodes[i]->setPosition(pos);
+        }
+
+        {
+            OgreProfileLiteral("SceneQueries");
+
+            // rays and spheres spread over the world, different each frame
+            for (size_t i = 0; i < NUM_QUERIES; ++i)
+            {
+                Vector3 origin(Math::RangeRandom(-halfWorld, halfWorld),
+                    Math::RangeRandom(-halfWorld, halfWorld), Math::RangeRandom(-halfWorld, halfWorld));
+                Vector3 dir(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1));
+                mRays[i] = Ray(origin, dir.normalisedCopy());
+                mSpheres[i] = Sphere(origin, 50);
+
+                mRayQuery->setRay(mRays[i]);
+                mRayQuery->execute();
+
+                mSphereQuery->setSphere(mSpheres[i]);
+                mSphereQuery->execute();
+            }
+        }
+
+        {
+            OgreProfileLiteral("BatchedSceneQueries");
+
+            mSceneMgr->executeRayQueries(mRays, NUM_QUERIES, mHits, MAX_HITS, mHitCounts);
+            mSceneMgr->executeSphereQueries(mSpheres, NUM_QUERIES, mHits, MAX_HITS, mHitCounts);
+        }
+
+        return SdkSample::frameRenderingQueued(evt);
+    }
+
+protected:
+
+    void createSceneManager()
+    {
+        mSceneMgr = Root::getSingleton().createSceneManager(mSceneManagerType);
+#ifdef INCLUDE_RTSHADER_SYSTEM
+        mShaderGenerator->addSceneManager(mSceneMgr);
+#endif
+        if (mOverlaySystem)
+            mSceneMgr->addRenderQueueListener(mOverlaySystem);
+    }
+
+    void setupContent()
+    {
+        mSceneMgr->setAmbientLight(ColourValue(0.5, 0.5, 0.5));
+        mSceneMgr->setSceneQueryThreadCount(mQueryThreads);
+
+        // the prefab cube is 100 units wide: most objects are a few units,
+        // one in ten is tens of units and one in a hundred hundreds of units
+        const Real halfWorld = WORLD_SIZE * 0.5f;
+        for (size_t i = 0; i < mNumObjects; ++i)
+        {
+            Real scale;
+            if (i % 100 == 0)
+                scale = Math::RangeRandom(2, 5);
+            else if (i % 10 == 0)
+                scale = Math::RangeRandom(0.2f, 1);
+            else
+                scale = Math::RangeRandom(0.01f, 0.05f);
+
+            SceneNode* sn = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+                Vector3(Math::RangeRandom(-halfWorld, halfWorld), Math::RangeRandom(-halfWorld, halfWorld),
+                    Math::RangeRandom(-halfWorld, halfWorld)));
+            sn->setScale(scale, scale, scale);
+            sn->attachObject(mSceneMgr->createEntity(SceneManager::PT_CUBE));
+
+            if (i % 2)
+            {
+                mMovingNodes.push_back(sn);
+                mVelocities.push_back(Vector3(Math::RangeRandom(-50, 50),
+                    Math::RangeRandom(-50, 50), Math::RangeRandom(-50, 50)));
+            }
+        }
+
+        mRayQuery = mSceneMgr->createRayQuery(Ray());
+        mRayQuery->setSortByDistance(true);
+        mSphereQuery = mSceneMgr->createSphereQuery(Sphere());
+
+        mCamera->setNearClipDistance(1);
+        mCamera->setFarClipDistance(WORLD_SIZE * 2);
+        mCamera->setPosition(0, halfWorld, WORLD_SIZE);
+        mCamera->lookAt(0, 0, 0);
+    }
+
+    void cleanupContent()
+    {
+        mSceneMgr->destroyQuery(mRayQuery);
+        mSceneMgr->destroyQuery(mSphereQuery);
+        mMovingNodes.clear();
+        mVelocities.clear();
+    }
+
+    /// Extent of the world along each axis
+    static const int WORLD_SIZE = 4000;
+    /// Number of rays and of spheres queried per frame
+    static const size_t NUM_QUERIES = 64;
+    /// Number of hits stored per batched query
+    static const size_t MAX_HITS = 16;
+
+    String mSceneManagerType;
+    size_t mNumObjects;
+    size_t mQueryThreads;
+    std::vector<SceneNode*> mMovingNodes;
+    std::vector<Vector3> mVelocities;
+    RaySceneQuery* mRayQuery;
+    SphereSceneQuery* mSphereQuery;
+    /// Queries of the current frame, and storage for the batched results
+    Ray mRays[NUM_QUERIES];
+    Sphere mSpheres[NUM_QUERIES];
+    SceneQueryBatchHit mHits[NUM_QUERIES * MAX_HITS];
+    size_t mHitCounts[NUM_QUERIES];
+};
+
+#endif
@@ -0,0 +1,171 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __FrameStageCollector_H__
+#define __FrameStageCollector_H__
+
+#include "Ogre.h"
+#include "OgreProfiler.h"
+
+/** Running min/max/total of one per-frame measurement, in milliseconds */
+struct StageStats
+{
+    /// Number of frames recorded
+    size_t frames;
+    /// Number of times the stage was entered over all recorded frames
+    size_t calls;
+    Ogre::Real total;
+    Ogre::Real min;
+    Ogre::Real max;
+
+    StageStats() { reset(); }
+
+    void reset()
+    {
+        frames = calls = 0;
+        total = min = max = 0;
+    }
+
+    void add(Ogre::Real millisecs, size_t numCalls = 1)
+    {
+        if (frames == 0 || millisecs < min)
+            min = millisecs;
+        if (frames == 0 || millisecs > max)
+            max = millisecs;
+        total += millisecs;
+        calls += numCalls;
+        ++frames;
+    }
+
+    Ogre::Real mean() const { return frames ? total / frames : 0; }
+};
+
+/** Collects per-frame CPU time of named profiles from the Ogre Profiler.
+@remarks
+    The Profiler only reports results through its session listeners, so this
+    registers as one and, for every frame processed while recording, sums the
+    inclusive time of each tracked profile over the whole hierarchy (a stage
+    such as _updateSceneGraph appears once per viewport and shadow texture).
+    Stages that did not run in a frame are recorded as zero, so means are
+    per frame rather than per call.
+@par
+    Nothing is collected unless OGRE was built with OGRE_PROFILING.
+*/
+class FrameStageCollector : public Ogre::ProfileSessionListener, public Ogre::GeneralAllocatedObject
+{
+public:
+    typedef std::map<Ogre::String, StageStats> StageStatsMap;
+
+    FrameStageCollector(const Ogre::StringVector& stages)
+        : mStages(stages), mRecording(false)
+    {
+        reset();
+    }
+
+    virtual void initializeSession() {}
+
+    virtual void finializeSession() {}
+
+    virtual void displayResults(const Ogre::ProfileInstance& root, Ogre::ulong maxTotalFrameTime)
+    {
+        if (!mRecording)
+            return;
+
+        FrameTimes times;
+        for (Ogre::StringVector::const_iterator i = mStages.begin(); i != mStages.end(); ++i)
+            times[*i] = FrameTime();
+
+        // the frame just ended is the most recent one any top level
+        // profile was entered in
+        Ogre::ulong frameNumber = 0;
+        Ogre::ProfileInstance::ProfileChildren::const_iterator i, iend = root.children.end();
+        for (i = root.children.begin(); i != iend; ++i)
+            frameNumber = std::max(frameNumber, i->second->frameNumber);
+
+        accumulate(root, frameNumber, times);
+
+        for (FrameTimes::iterator t = times.begin(); t != times.end(); ++t)
+            mStats[t->first].add(t->second.millisecs, t->second.calls);
+    }
+
+    /// Start or stop recording frames as they are reported by the Profiler
+    void setRecording(bool recording) { mRecording = recording; }
+
+    bool isRecording() const { return mRecording; }
+
+    /// Discard everything recorded so far
+    void reset()
+    {
+        mStats.clear();
+        for (Ogre::StringVector::const_iterator i = mStages.begin(); i != mStages.end(); ++i)
+            mStats[*i] = StageStats();
+    }
+
+    const Ogre::StringVector& getStages() const { return mStages; }
+
+    const StageStatsMap& getStageStats() const { return mStats; }
+
+protected:
+
+    struct FrameTime
+    {
+        Ogre::Real millisecs;
+        size_t calls;
+
+        FrameTime() : millisecs(0), calls(0) {}
+    };
+    typedef std::map<Ogre::String, FrameTime> FrameTimes;
+
+    void accumulate(const Ogre::ProfileInstance& instance, Ogre::ulong frameNumber, FrameTimes& times) const
+    {
+        Ogre::ProfileInstance::ProfileChildren::const_iterator i, iend = instance.children.end();
+        for (i = instance.children.begin(); i != iend; ++i)
+        {
+            const Ogre::ProfileInstance* child = i->second;
+
+            // profiles not entered this frame keep their stale timings
+            if (child->frameNumber != frameNumber || child->frame.calls == 0)
+                continue;
+
+            FrameTimes::iterator t = times.find(child->name);
+            if (t != times.end())
+            {
+                t->second.millisecs += child->history.currentTimeMillisecs;
+                t->second.calls += child->frame.calls;
+            }
+
+            accumulate(*child, frameNumber, times);
+        }
+    }
+
+    Ogre::StringVector mStages;
+    StageStatsMap mStats;
+    bool mRecording;
+};
+
+#endif
@@ -0,0 +1,258 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __MediaLoading_H__
+#define __MediaLoading_H__
+
+#include "Ogre.h"
+#include "OgreCodec.h"
+#include "OgreFileSystem.h"
+#include <fstream>
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX && defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace Ogre;
+
+/** Loads every mesh and image found in the file system resource locations,
+    the Samples media tree, timing how long it takes and how much memory it
+    needs at its peak.
+@remarks
+    The media is loaded once with the files streamed in, as the file system
+    archive does by default, and once with them memory mapped in every
+    archive scanned, see FileSystemArchive::setUseMemoryMapping. Every file
+    is read once beforehand, so both start with the media in the page cache.
+    The peak resident size is only measured on Linux, where it can be reset
+    between runs; it includes the pages of files mapped at the time.
+*/
+class MediaLoading
+{
+public:
+    struct Result
+    {
+        String mode;
+        /// Wall clock time to load everything
+        Real milliseconds;
+        /// Resident size before loading and its peak while loading, 0 if unknown
+        size_t residentKB;
+        size_t peakResidentKB;
+        size_t meshes;
+        size_t images;
+        /// Size of the files loaded
+        size_t bytes;
+        /// Files which failed to load
+        size_t failures;
+    };
+
+    MediaLoading()
+    {
+        StringVector codecs = Codec::getExtensions();
+        std::set<String> imageExtensions(codecs.begin(), codecs.end());
+        std::set<String> seen;
+
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        StringVector groups = rgm.getResourceGroups();
+        for (StringVector::iterator g = groups.begin(); g != groups.end(); ++g)
+        {
+            ResourceGroupManager::LocationList locations = rgm.getResourceLocationList(*g);
+            for (ResourceGroupManager::LocationList::iterator l = locations.begin(); l != locations.end(); ++l)
+            {
+                Archive* arch = (*l)->archive;
+                if (arch->getType() != "FileSystem")
+                    continue;
+                mArchives.insert(static_cast<FileSystemArchive*>(arch));
+
+                FileInfoListPtr files = arch->listFileInfo((*l)->recursive);
+                for (FileInfoList::iterator f = files->begin(); f != files->end(); ++f)
+                {
+                    // resource names are global, the first of a name is the one loaded
+                    if (!seen.insert(f->basename).second)
+                        continue;
+
+                    String base, ext;
+                    StringUtil::splitBaseFilename(f->basename, base, ext);
+                    StringUtil::toLowerCase(ext);
+
+                    MediaFile file = { f->basename, *g, arch, f->filename, f->uncompressedSize, ext == "mesh" };
+                    if (file.isMesh || imageExtensions.count(ext))
+                        mFiles.push_back(file);
+                }
+            }
+        }
+    }
+
+    /** Loads all the media, then unloads it again
+        @param mapped Whether the files are memory mapped or streamed in */
+    Result run(bool mapped)
+    {
+        Result result = { mapped ? "mapped" : "stream", 0, 0, 0, 0, 0, 0, 0 };
+
+        warmPageCache();
+
+        // only what this run loads is unloaded afterwards
+        std::set<String> skeletons = getResourceNames(SkeletonManager::getSingleton());
+        std::set<String> meshes = getResourceNames(MeshManager::getSingleton());
+
+        std::map<FileSystemArchive*, bool> wasMapped;
+        for (std::set<FileSystemArchive*>::iterator a = mArchives.begin(); a != mArchives.end(); ++a)
+        {
+            wasMapped[*a] = (*a)->getUseMemoryMapping();
+            (*a)->setUseMemoryMapping(mapped);
+        }
+
+        trimHeap();
+        result.residentKB = resetPeakResidentSize();
+
+        Timer timer;
+        for (size_t i = 0; i < mFiles.size(); ++i)
+        {
+            const MediaFile& file = mFiles[i];
+            try
+            {
+                if (file.isMesh)
+                {
+                    if (meshes.count(file.name))
+                        continue;
+                    MeshManager::getSingleton().load(file.name, file.group);
+                    ++result.meshes;
+                }
+                else
+                {
+                    Image image;
+                    image.load(file.name, file.group);
+                    ++result.images;
+                }
+                result.bytes += file.size;
+            }
+            catch (Exception&)
+            {
+                ++result.failures;
+            }
+        }
+        result.milliseconds = timer.getMicroseconds() / 1000.0f;
+        result.peakResidentKB = getPeakResidentSize();
+
+        for (std::map<FileSystemArchive*, bool>::iterator a = wasMapped.begin(); a != wasMapped.end(); ++a)
+            a->first->setUseMemoryMapping(a->second);
+
+        removeNewResources(MeshManager::getSingleton(), meshes);
+        removeNewResources(SkeletonManager::getSingleton(), skeletons);
+        return result;
+    }
+
+protected:
+    struct MediaFile
+    {
+        /// Resource name and group it is loaded from
+        String name;
+        String group;
+        Archive* archive;
+        /// Path within the archive
+        String path;
+        size_t size;
+        bool isMesh;
+    };
+    typedef std::vector<MediaFile> MediaFileList;
+
+    /// Reads every file, so the runs do not depend on the order they're in
+    void warmPageCache()
+    {
+        char buffer[65536];
+        for (size_t i = 0; i < mFiles.size(); ++i)
+        {
+            DataStreamPtr stream = mFiles[i].archive->open(mFiles[i].path);
+            while (stream->read(buffer, sizeof(buffer)) == sizeof(buffer))
+                ;
+        }
+    }
+
+    static std::set<String> getResourceNames(ResourceManager& mgr)
+    {
+        std::set<String> names;
+        ResourceManager::ResourceMapIterator it = mgr.getResourceIterator();
+        while (it.hasMoreElements())
+            names.insert(it.getNext()->getName());
+        return names;
+    }
+
+    static void removeNewResources(ResourceManager& mgr, const std::set<String>& keep)
+    {
+        std::set<String> names = getResourceNames(mgr);
+        for (std::set<String>::iterator i = names.begin(); i != names.end(); ++i)
+        {
+            if (!keep.count(*i))
+                mgr.remove(*i);
+        }
+    }
+
+    /// Gives the memory freed by the previous run back to the system
+    static void trimHeap()
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX && defined(__GLIBC__)
+        malloc_trim(0);
+#endif
+    }
+
+    /** Resets the peak resident size to the current one
+        @return The current resident size in KiB, 0 if unknown */
+    static size_t resetPeakResidentSize()
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5";
+#endif
+        return readStatus("VmRSS:");
+    }
+
+    /// @return The peak resident size since the last reset in KiB, 0 if unknown
+    static size_t getPeakResidentSize()
+    {
+        return readStatus("VmHWM:");
+    }
+
+    static size_t readStatus(const String& field)
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX
+        std::ifstream status("/proc/self/status");
+        String line;
+        while (std::getline(status, line))
+        {
+            if (StringUtil::startsWith(line, field, false))
+                return StringConverter::parseSizeT(line.substr(field.size()), 0);
+        }
+#endif
+        return 0;
+    }
+
+    MediaFileList mFiles;
+    /// Archives the files are in, memory mapped or not per run
+    std::set<FileSystemArchive*> mArchives;
+};
+
+#endif
@@ -0,0 +1,226 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __OptimisedUtilKernels_H__
+#define __OptimisedUtilKernels_H__
+
+#include "Ogre.h"
+#include "OgreOptimisedUtil.h"
+
+using namespace Ogre;
+
+/** Times the OptimisedUtil functions of an implementation on synthetic data,
+    so the SIMD implementations can be compared with each other without the
+    rest of a frame getting in the way.
+@remarks
+    Positions and normals are interleaved and skinned with 4 weights each,
+    as the software skinning of a typical mesh is. Throughput is reported in
+    millions of elements (vertices, matrices or faces) per second.
+*/
+class OptimisedUtilKernels
+{
+public:
+    typedef std::map<String, Real> ThroughputMap;
+
+    OptimisedUtilKernels(size_t numVertices)
+        : mNumVertices(std::max(numVertices, (size_t)8))
+        , mNumFaces(mNumVertices / 2)
+        , mNumMatrices(std::max(mNumVertices / 64, (size_t)1))
+    {
+        mSrc = allocate(mNumVertices * 6);
+        mSrc2 = allocate(mNumVertices * 6);
+        mDest = allocate(mNumVertices * 6);
+        mWeights = allocate(mNumVertices * NUM_WEIGHTS);
+        mIndices = static_cast<unsigned char*>(OGRE_MALLOC(mNumVertices * NUM_WEIGHTS, MEMCATEGORY_GENERAL));
+        mMatrices = reinterpret_cast<Matrix4*>(allocate(mNumMatrices * 16));
+        mDestMatrices = reinterpret_cast<Matrix4*>(allocate(mNumMatrices * 16));
+        mBones = reinterpret_cast<Matrix4*>(allocate(NUM_BONES * 16));
+        mFaceNormals = reinterpret_cast<Vector4*>(allocate(mNumFaces * 4));
+        mLightFacings = static_cast<char*>(OGRE_MALLOC(mNumFaces, MEMCATEGORY_GENERAL));
+        mTriangles.resize(mNumFaces);
+
+        for (size_t i = 0; i < NUM_BONES; ++i)
+        {
+            mBones[i].makeTransform(
+                Vector3(Math::RangeRandom(-10, 10), Math::RangeRandom(-10, 10), Math::RangeRandom(-10, 10)),
+                Vector3::UNIT_SCALE,
+                Quaternion(Degree(Math::RangeRandom(0, 360)), Vector3::UNIT_Y));
+            mBlendMatrices[i] = &mBones[i];
+        }
+
+        for (size_t v = 0; v < mNumVertices; ++v)
+        {
+            Vector3 normal(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom());
+            normal.normalise();
+            for (size_t i = 0; i < 3; ++i)
+            {
+                mSrc[v * 6 + i] = Math::RangeRandom(-10, 10);
+                mSrc2[v * 6 + i] = Math::RangeRandom(-10, 10);
+                mSrc[v * 6 + 3 + i] = normal[i];
+                mSrc2[v * 6 + 3 + i] = -normal[i];
+            }
+            for (size_t w = 0; w < NUM_WEIGHTS; ++w)
+            {
+                mWeights[v * NUM_WEIGHTS + w] = 1.0f / NUM_WEIGHTS;
+                mIndices[v * NUM_WEIGHTS + w] = static_cast<unsigned char>((v + w) % NUM_BONES);
+            }
+        }
+
+        for (size_t i = 0; i < mNumMatrices; ++i)
+            mMatrices[i] = mBones[i % NUM_BONES];
+
+        for (size_t f = 0; f < mNumFaces; ++f)
+        {
+            // neighbouring vertices, as the faces of a real mesh mostly are
+            for (size_t i = 0; i < 3; ++i)
+                mTriangles[f].vertIndex[i] = (f * 2 + i) % mNumVertices;
+            mFaceNormals[f] = Vector4(Math::SymmetricRandom(), Math::SymmetricRandom(),
+                Math::SymmetricRandom(), Math::RangeRandom(-10, 10));
+        }
+    }
+
+    ~OptimisedUtilKernels()
+    {
+        OGRE_FREE_SIMD(mSrc, MEMCATEGORY_GENERAL);
+        OGRE_FREE_SIMD(mSrc2, MEMCATEGORY_GENERAL);
+        OGRE_FREE_SIMD(mDest, MEMCATEGORY_GENERAL);
+        OGRE_FREE_SIMD(mWeights, MEMCATEGORY_GENERAL);
+        OGRE_FREE(mIndices, MEMCATEGORY_GENERAL);
+        OGRE_FREE_SIMD(mMatrices, MEMCATEGORY_GENERAL);
+        OGRE_FREE_SIMD(mDestMatrices, MEMCATEGORY_GENERAL);
+        OGRE_FREE_SIMD(mBones, MEMCATEGORY_GENERAL);
+        OGRE_FREE_SIMD(mFaceNormals, MEMCATEGORY_GENERAL);
+        OGRE_FREE(mLightFacings, MEMCATEGORY_GENERAL);
+    }
+
+    /** Runs every function of the implementation the given number of times
+        @return The throughput of each function, by name */
+    ThroughputMap run(OptimisedUtil* impl, size_t repeats)
+    {
+        ThroughputMap result;
+        Timer timer;
+        const Vector4 pointLight(5, 20, -5, 1);
+        const Vector4 directionalLight(1, -1, 0.5f, 0);
+        // faces use the positions only, packed at the start of mSrc2
+        const float* positions = mSrc2;
+
+        timer.reset();
+        for (size_t r = 0; r < repeats; ++r)
+        {
+            impl->softwareVertexSkinning(mSrc, mDest, mSrc + 3, mDest + 3,
+                mWeights, mIndices, mBlendMatrices,
+                6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float),
+                NUM_WEIGHTS * sizeof(float), NUM_WEIGHTS, NUM_WEIGHTS, mNumVertices);
+        }
+        result["softwareVertexSkinning"] = throughput(mNumVertices * repeats, timer);
+
+        timer.reset();
+        for (size_t r = 0; r < repeats; ++r)
+        {
+            impl->softwareVertexMorph(0.25f, mSrc, mSrc2, mDest,
+                6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float), mNumVertices, true);
+        }
+        result["softwareVertexMorph"] = throughput(mNumVertices * repeats, timer);
+
+        timer.reset();
+        for (size_t r = 0; r < repeats; ++r)
+        {
+            impl->concatenateAffineMatrices(mBones[0], mMatrices, mDestMatrices, mNumMatrices);
+        }
+        result["concatenateAffineMatrices"] = throughput(mNumMatrices * repeats, timer);
+
+        timer.reset();
+        for (size_t r = 0; r < repeats; ++r)
+        {
+            impl->calculateFaceNormals(positions, &mTriangles[0], mFaceNormals, mNumFaces);
+        }
+        result["calculateFaceNormals"] = throughput(mNumFaces * repeats, timer);
+
+        timer.reset();
+        for (size_t r = 0; r < repeats; ++r)
+        {
+            impl->calculateLightFacing(pointLight, mFaceNormals, mLightFacings, mNumFaces);
+        }
+        result["calculateLightFacing"] = throughput(mNumFaces * repeats, timer);
+
+        timer.reset();
+        for (size_t r = 0; r < repeats; ++r)
+        {
+            impl->extrudeVertices(pointLight, 1000, positions, mDest, mNumVertices);
+        }
+        result["extrudeVertices"] = throughput(mNumVertices * repeats, timer);
+
+        timer.reset();
+        for (size_t r = 0; r < repeats; ++r)
+        {
+            impl->extrudeVertices(directionalLight, 1000, positions, mDest, mNumVertices);
+        }
+        result["extrudeVerticesDirectional"] = throughput(mNumVertices * repeats, timer);
+
+        return result;
+    }
+
+protected:
+    enum
+    {
+        NUM_BONES = 32,
+        NUM_WEIGHTS = 4
+    };
+
+    static float* allocate(size_t numFloats)
+    {
+        float* buffer = static_cast<float*>(OGRE_MALLOC_SIMD(numFloats * sizeof(float), MEMCATEGORY_GENERAL));
+        memset(buffer, 0, numFloats * sizeof(float));
+        return buffer;
+    }
+
+    static Real throughput(size_t elements, Timer& timer)
+    {
+        unsigned long us = std::max(timer.getMicroseconds(), (unsigned long)1);
+        return (Real)elements / us;
+    }
+
+    size_t mNumVertices;
+    size_t mNumFaces;
+    size_t mNumMatrices;
+    float* mSrc;
+    float* mSrc2;
+    float* mDest;
+    float* mWeights;
+    unsigned char* mIndices;
+    /// Blend matrices must be SIMD aligned
+    Matrix4* mBones;
+    const Matrix4* mBlendMatrices[NUM_BONES];
+    Matrix4* mMatrices;
+    Matrix4* mDestMatrices;
+    EdgeData::TriangleList mTriangles;
+    Vector4* mFaceNormals;
+    char* mLightFacings;
+};
+
+#endif
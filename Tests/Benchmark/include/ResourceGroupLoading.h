@@ -0,0 +1,124 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __ResourceGroupLoading_H__
+#define __ResourceGroupLoading_H__
+
+#include "Ogre.h"
+
+using namespace Ogre;
+
+/** Loads resource groups, the Samples media, timing how long it takes with
+    a given number of loading threads.
+@remarks
+    See ResourceGroupManager::setLoadingThreadCount; with more than one
+    thread, the resources are prepared in parallel on the workers of the
+    Root's WorkQueue before being loaded one after the other. Each group is
+    loaded and unloaded once beforehand, so all runs start with its files in
+    the page cache, and unloaded again after each run.
+*/
+class ResourceGroupLoading : public ResourceGroupListener
+{
+public:
+    struct Result
+    {
+        String group;
+        size_t threads;
+        /// Wall clock time to load the group
+        Real milliseconds;
+        /// Resources loaded, including those loaded along with them
+        size_t resources;
+        /// Whether loading the group failed
+        bool failed;
+    };
+
+    ResourceGroupLoading() : mResourceCount(0) {}
+
+    /** Loads a group, then unloads it again
+        @param group The resource group to load
+        @param threads The number of threads to prepare the resources on */
+    Result run(const String& group, size_t threads)
+    {
+        Result result = { group, threads, 0, 0, false };
+
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        size_t oldThreads = rgm.getLoadingThreadCount();
+        if (mWarmGroups.insert(group).second)
+            loadGroup(group);
+
+        rgm.setLoadingThreadCount(threads);
+        rgm.addResourceGroupListener(this);
+        mResourceCount = 0;
+        Timer timer;
+        result.failed = !loadGroup(group);
+        result.milliseconds = timer.getMicroseconds() / 1000.0f;
+        rgm.removeResourceGroupListener(this);
+        rgm.setLoadingThreadCount(oldThreads);
+
+        result.resources = mResourceCount;
+        return result;
+    }
+
+    void resourceGroupScriptingStarted(const String& groupName, size_t scriptCount) {}
+    void scriptParseStarted(const String& scriptName, bool& skipThisScript) {}
+    void scriptParseEnded(const String& scriptName, bool skipped) {}
+    void resourceGroupScriptingEnded(const String& groupName) {}
+    void resourceGroupLoadStarted(const String& groupName, size_t resourceCount) {}
+    void resourceLoadStarted(const ResourcePtr& resource) { ++mResourceCount; }
+    void resourceLoadEnded(void) {}
+    void worldGeometryStageStarted(const String& description) {}
+    void worldGeometryStageEnded(void) {}
+    void resourceGroupLoadEnded(const String& groupName) {}
+
+protected:
+    /** Loads and unloads a group
+        @return Whether the group loaded */
+    bool loadGroup(const String& group)
+    {
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        bool loaded = true;
+        try
+        {
+            rgm.loadResourceGroup(group);
+        }
+        catch (Exception& e)
+        {
+            LogManager::getSingleton().logMessage("Benchmark: loading resource group " + group +
+                " failed: " + e.getDescription());
+            loaded = false;
+        }
+        rgm.unloadResourceGroup(group);
+        return loaded;
+    }
+
+    /// Groups loaded once already
+    std::set<String> mWarmGroups;
+    size_t mResourceCount;
+};
+
+#endif
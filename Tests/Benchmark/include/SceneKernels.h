@@ -0,0 +1,227 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SceneKernels_H__
+#define __SceneKernels_H__
+
+#include "Ogre.h"
+#include "OgreRenderQueueSortingGrouping.h"
+
+using namespace Ogre;
+
+/** Times the scene manager's per frame work on a synthetic scene, without
+    the rest of a frame getting in the way.
+@remarks
+    Covers the scene graph update per node transform storage and thread
+    count, culling boxes against a camera one at a time and batched, and
+    building and sorting a render queue collection per organisation mode.
+    Throughput is reported in millions of elements (nodes, boxes or
+    renderables) per second.
+*/
+class SceneKernels
+{
+public:
+    typedef std::map<String, Real> ThroughputMap;
+
+    SceneKernels(size_t numElements)
+        : mNumElements(std::max(numElements, (size_t)8))
+    {
+        mSceneMgr = Root::getSingleton().createSceneManager(ST_GENERIC);
+        mCamera = mSceneMgr->createCamera("SceneKernels");
+        mCamera->setPosition(Vector3(0, 0, 200));
+        mCamera->lookAt(Vector3::ZERO);
+        mCamera->setNearClipDistance(1);
+        mCamera->setFarClipDistance(1000);
+
+        // a hierarchy with 6 children per node
+        mNodes.push_back(mSceneMgr->getRootSceneNode());
+        for (size_t i = 1; i <= mNumElements; ++i)
+        {
+            SceneNode* child = mNodes[(i - 1) / 6]->createChildSceneNode(
+                Vector3(Real(i % 6), 1, Real(i % 6) * 0.5f),
+                Quaternion(Degree(Real((i % 6) * 15)), Vector3::UNIT_Y));
+            child->setScale(Vector3(1.01f, 1.0f, 0.99f));
+            mNodes.push_back(child);
+        }
+
+        // boxes around the frustum, a good part of them crossing its planes
+        for (size_t i = 0; i < mNumElements; ++i)
+        {
+            Vector3 centre(Math::RangeRandom(-600, 600), Math::RangeRandom(-600, 600),
+                Math::RangeRandom(-600, 600));
+            Vector3 halfSize(Math::RangeRandom(0, 50), Math::RangeRandom(0, 50),
+                Math::RangeRandom(0, 50));
+            mBoxes.push_back(AxisAlignedBox(centre - halfSize, centre + halfSize));
+        }
+        for (size_t i = 0; i < mNumElements; ++i)
+            mBoxPtrs.push_back(&mBoxes[i]);
+        mVisible = OGRE_ALLOC_T(bool, mNumElements, MEMCATEGORY_GENERAL);
+
+        // renderables spread over 200 passes told apart by their texture
+        for (size_t i = 0; i < 200; ++i)
+        {
+            String name = "SceneKernels" + StringConverter::toString(i);
+            MaterialPtr mat = MaterialManager::getSingleton().create(name,
+                ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME).staticCast<Material>();
+            Pass* pass = mat->createTechnique()->createPass();
+            pass->createTextureUnitState(name + ".png");
+            pass->_recalculateHash();
+            mMaterials.push_back(mat);
+        }
+        for (size_t i = 0; i < mNumElements; ++i)
+        {
+            mRenderables.push_back(PositionedRenderable(Vector3(
+                Math::RangeRandom(-1000, 1000), Math::RangeRandom(-1000, 1000),
+                Math::RangeRandom(-1000, 1000))));
+        }
+    }
+
+    ~SceneKernels()
+    {
+        OGRE_FREE(mVisible, MEMCATEGORY_GENERAL);
+        for (size_t i = 0; i < mMaterials.size(); ++i)
+            MaterialManager::getSingleton().remove(mMaterials[i]->getHandle());
+        Root::getSingleton().destroySceneManager(mSceneMgr);
+    }
+
+    /** Runs everything the given number of times
+        @return The throughput of each, by name */
+    ThroughputMap run(size_t repeats)
+    {
+        ThroughputMap result;
+        Timer timer;
+
+        const SceneManager::NodeTransformStorage storages[] =
+            { SceneManager::NTS_PER_NODE, SceneManager::NTS_SOA_BLOCKS };
+        const char* storageNames[] = { "PerNode", "SoABlocks" };
+        const size_t threadCounts[] = { 1, 4 };
+        for (size_t s = 0; s < 2; ++s)
+        {
+            mSceneMgr->setNodeTransformStorage(storages[s]);
+            for (size_t t = 0; t < 2; ++t)
+            {
+                mSceneMgr->setSceneGraphUpdateThreadCount(threadCounts[t]);
+
+                timer.reset();
+                for (size_t r = 0; r < repeats; ++r)
+                {
+                    // moving the root dirties the whole hierarchy
+                    mNodes.front()->yaw(Degree(1));
+                    mSceneMgr->_updateSceneGraph(mCamera);
+                }
+                result[String("updateSceneGraph") + storageNames[s] +
+                    StringConverter::toString(threadCounts[t]) + "Threads"] =
+                    throughput(mNumElements * repeats, timer);
+            }
+        }
+        mSceneMgr->setNodeTransformStorage(SceneManager::NTS_PER_NODE);
+        mSceneMgr->setSceneGraphUpdateThreadCount(1);
+
+        timer.reset();
+        for (size_t r = 0; r < repeats; ++r)
+        {
+            for (size_t i = 0; i < mNumElements; ++i)
+                mVisible[i] = mCamera->isVisible(mBoxes[i]);
+        }
+        result["isVisible"] = throughput(mNumElements * repeats, timer);
+
+        timer.reset();
+        for (size_t r = 0; r < repeats; ++r)
+        {
+            mCamera->areVisible(&mBoxPtrs[0], mNumElements, mVisible);
+        }
+        result["areVisible"] = throughput(mNumElements * repeats, timer);
+
+        const QueuedRenderableCollection::OrganisationMode modes[] =
+            { QueuedRenderableCollection::OM_PASS_GROUP, QueuedRenderableCollection::OM_SORT_KEY };
+        const char* modeNames[] = { "renderQueuePassGroup", "renderQueueSortKey" };
+        for (size_t m = 0; m < 2; ++m)
+        {
+            QueuedRenderableCollection collection;
+            collection.addOrganisationMode(modes[m]);
+
+            timer.reset();
+            for (size_t r = 0; r < repeats; ++r)
+            {
+                // objects move a little every frame
+                mCamera->setPosition(Vector3(Real(r), 0, 200));
+
+                collection.clear();
+                for (size_t i = 0; i < mNumElements; ++i)
+                {
+                    Pass* pass = mMaterials[(i * 7) % mMaterials.size()]->getTechnique(0)->getPass(0);
+                    collection.addRenderable(pass, &mRenderables[i]);
+                }
+                collection.sort(mCamera);
+            }
+            result[modeNames[m]] = throughput(mNumElements * repeats, timer);
+        }
+        mCamera->setPosition(Vector3(0, 0, 200));
+
+        return result;
+    }
+
+protected:
+    /// Renderable standing at a fixed position
+    class PositionedRenderable : public Renderable
+    {
+    public:
+        PositionedRenderable(const Vector3& pos) : mPosition(pos) {}
+
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+        void getRenderOperation(RenderOperation& op) {}
+        void getWorldTransforms(Matrix4* xform) const { *xform = Matrix4::IDENTITY; }
+        Real getSquaredViewDepth(const Camera* cam) const
+        {
+            return (mPosition - cam->getDerivedPosition()).squaredLength();
+        }
+        const LightList& getLights(void) const { return mLights; }
+
+    protected:
+        Vector3 mPosition;
+        MaterialPtr mMaterial;
+        LightList mLights;
+    };
+
+    static Real throughput(size_t elements, Timer& timer)
+    {
+        unsigned long us = std::max(timer.getMicroseconds(), (unsigned long)1);
+        return (Real)elements / us;
+    }
+
+    size_t mNumElements;
+    SceneManager* mSceneMgr;
+    Camera* mCamera;
+    std::vector<SceneNode*> mNodes;
+    std::vector<AxisAlignedBox> mBoxes;
+    std::vector<const AxisAlignedBox*> mBoxPtrs;
+    bool* mVisible;
+    std::vector<MaterialPtr> mMaterials;
+    std::vector<PositionedRenderable> mRenderables;
+};
+
+#endif
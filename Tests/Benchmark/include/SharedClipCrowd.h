@@ -0,0 +1,112 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __SharedClipCrowd_H__
+#define __SharedClipCrowd_H__
+
+#include "SdkSample.h"
+
+using namespace Ogre;
+using namespace OgreBites;
+
+/** A crowd of characters playing a few animations in step, for measuring
+    how much the SkeletonAnimationCache saves.
+@remarks
+    The characters are spread over 8 animations and 4 evenly spaced starting
+    points within each, and all advance at the same speed, so each frame has
+    32 distinct poses however many characters there are. The scene is run
+    with and without SceneManager::setSkeletonAnimationCacheEnabled.
+*/
+class Sample_SharedClipCrowd : public SdkSample
+{
+public:
+    Sample_SharedClipCrowd(size_t numCharacters, bool useCache)
+        : mNumCharacters(numCharacters), mUseCache(useCache)
+    {
+        mInfo["Title"] = "Shared Clip Crowd (" + StringConverter::toString(numCharacters) +
+            " characters, animation cache " + (useCache ? "on" : "off") + ")";
+        mInfo["Description"] = "Many characters playing the same few animations in step.";
+        mInfo["Category"] = "Animation";
+    }
+
+    bool frameRenderingQueued(const FrameEvent& evt)
+    {
+        for (size_t i = 0; i < mAnimStates.size(); ++i)
+        {
+            mAnimStates[i]->addTime(evt.timeSinceLastFrame);
+        }
+
+        return SdkSample::frameRenderingQueued(evt);
+    }
+
+protected:
+
+    void setupContent()
+    {
+        static const char* clips[] = { "Walk", "Idle1", "Idle2", "Idle3",
+            "Attack1", "Attack3", "Stealth", "Spin" };
+        const size_t numClips = sizeof(clips) / sizeof(clips[0]);
+        const size_t numPhases = 4;
+
+        mSceneMgr->setAmbientLight(ColourValue(0.5, 0.5, 0.5));
+        mSceneMgr->setSkeletonAnimationCacheEnabled(mUseCache);
+
+        // lay the characters out on a square grid, all in view of the camera
+        const Real spacing = 150;
+        size_t columns = (size_t)Math::Ceil(Math::Sqrt((Real)mNumCharacters));
+        Real halfSize = spacing * (columns - 1) * 0.5f;
+
+        for (size_t i = 0; i < mNumCharacters; ++i)
+        {
+            SceneNode* sn = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+                Vector3((i % columns) * spacing - halfSize, 0, (i / columns) * spacing - halfSize));
+
+            Entity* ent = mSceneMgr->createEntity("ninja.mesh");
+            sn->attachObject(ent);
+
+            AnimationState* as = ent->getAnimationState(clips[i % numClips]);
+            as->setEnabled(true);
+            as->setTimePosition(as->getLength() * ((i / numClips) % numPhases) / numPhases);
+            mAnimStates.push_back(as);
+        }
+
+        mCamera->setPosition(0, halfSize + 500, halfSize * 2 + 500);
+        mCamera->lookAt(0, 0, 0);
+    }
+
+    void cleanupContent()
+    {
+        mAnimStates.clear();
+    }
+
+    size_t mNumCharacters;
+    bool mUseCache;
+    std::vector<AnimationState*> mAnimStates;
+};
+
+#endif
@@ -0,0 +1,113 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __SkinnedCrowd_H__
+#define __SkinnedCrowd_H__
+
+#include "SdkSample.h"
+
+using namespace Ogre;
+using namespace OgreBites;
+
+/** A crowd of skinned characters, each playing its own animation, for
+    measuring the cost of skeletal animation and software skinning.
+@remarks
+    Software skinning is requested for every character, whatever the
+    render system supports, so the CPU path is always measured. The
+    animation is evaluated with the given number of threads, see
+    SceneManager::setAnimationThreadCount.
+*/
+class Sample_SkinnedCrowd : public SdkSample
+{
+public:
+    Sample_SkinnedCrowd(size_t numCharacters, size_t animationThreads)
+        : mNumCharacters(numCharacters), mAnimationThreads(animationThreads)
+    {
+        mInfo["Title"] = "Skinned Crowd (" + StringConverter::toString(numCharacters) +
+            " characters, " + StringConverter::toString(animationThreads) + " animation threads)";
+        mInfo["Description"] = "Many software skinned characters, each with its own animation.";
+        mInfo["Category"] = "Animation";
+    }
+
+    bool frameRenderingQueued(const FrameEvent& evt)
+    {
+        for (size_t i = 0; i < mAnimStates.size(); ++i)
+        {
+            mAnimStates[i]->addTime(mAnimSpeeds[i] * evt.timeSinceLastFrame);
+        }
+
+        return SdkSample::frameRenderingQueued(evt);
+    }
+
+protected:
+
+    void setupContent()
+    {
+        mSceneMgr->setAmbientLight(ColourValue(0.5, 0.5, 0.5));
+        mSceneMgr->setAnimationThreadCount(mAnimationThreads);
+
+        // lay the characters out on a square grid, all in view of the camera
+        const Real spacing = 10;
+        size_t columns = (size_t)Math::Ceil(Math::Sqrt((Real)mNumCharacters));
+        Real halfSize = spacing * (columns - 1) * 0.5f;
+
+        for (size_t i = 0; i < mNumCharacters; ++i)
+        {
+            SceneNode* sn = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+                Vector3((i % columns) * spacing - halfSize, 0, (i / columns) * spacing - halfSize));
+            sn->yaw(Degree(Math::RangeRandom(0, 360)));
+
+            Entity* ent = mSceneMgr->createEntity("jaiqua.mesh");
+            ent->addSoftwareAnimationRequest(false);
+            sn->attachObject(ent);
+
+            // start each character at a different point of the animation
+            AnimationState* as = ent->getAnimationState("Sneak");
+            as->setEnabled(true);
+            as->setTimePosition(Math::RangeRandom(0, as->getLength()));
+            mAnimSpeeds.push_back(Math::RangeRandom(0.5, 1.5));
+            mAnimStates.push_back(as);
+        }
+
+        mCamera->setPosition(0, halfSize + 50, halfSize * 2 + 50);
+        mCamera->lookAt(0, 0, 0);
+    }
+
+    void cleanupContent()
+    {
+        mAnimStates.clear();
+        mAnimSpeeds.clear();
+    }
+
+    size_t mNumCharacters;
+    size_t mAnimationThreads;
+    std::vector<AnimationState*> mAnimStates;
+    std::vector<Real> mAnimSpeeds;
+};
+
+#endif
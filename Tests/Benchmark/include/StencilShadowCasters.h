@@ -0,0 +1,151 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __StencilShadowCasters_H__
+#define __StencilShadowCasters_H__
+
+#include "SdkSample.h"
+#include "OgreMovablePlane.h"
+
+using namespace Ogre;
+using namespace OgreBites;
+
+/** The scene of the StencilShadowTest visual test, with its casters copied
+    many times over, for measuring the cost of generating shadow volumes.
+@remarks
+    The two point lights, ground plane and casters are those of the visual
+    test. The barrel, head and knot are repeated on a grid in front of the
+    camera and spin so that no volume is the same from one frame to the next.
+    The volumes are generated with the given number of threads, see
+    SceneManager::setShadowVolumeThreadCount.
+*/
+class Sample_StencilShadowCasters : public SdkSample
+{
+public:
+    Sample_StencilShadowCasters(size_t numCopies, size_t shadowVolumeThreads)
+        : mNumCopies(numCopies), mShadowVolumeThreads(shadowVolumeThreads)
+    {
+        mInfo["Title"] = "Stencil Shadow Casters (" + StringConverter::toString(numCopies * 3) +
+            " casters, " + StringConverter::toString(shadowVolumeThreads) + " shadow volume threads)";
+        mInfo["Description"] = "The stencil shadow visual test with many more casters.";
+        mInfo["Category"] = "Lighting";
+    }
+
+    bool frameRenderingQueued(const FrameEvent& evt)
+    {
+        for (size_t i = 0; i < mCasterNodes.size(); ++i)
+        {
+            mCasterNodes[i]->yaw(Degree(30 * evt.timeSinceLastFrame));
+        }
+
+        return SdkSample::frameRenderingQueued(evt);
+    }
+
+protected:
+
+    void setupContent()
+    {
+        mSceneMgr->setAmbientLight(ColourValue(0.0, 0.0, 0.0));
+        mSceneMgr->setShadowTechnique(SHADOWTYPE_STENCIL_ADDITIVE);
+        mSceneMgr->setShadowVolumeThreadCount(mShadowVolumeThreads);
+
+        Light* light = mSceneMgr->createLight("Light1");
+        light->setDiffuseColour(0.5f, 0.4f, 0.35f);
+        light->setSpecularColour(0, 0, 0);
+        light->setAttenuation(8000, 1, 0.0005, 0);
+        light->setPosition(220, 100, 0);
+        light->setCastShadows(true);
+        light->setType(Light::LT_POINT);
+        light = mSceneMgr->createLight("Light2");
+        light->setDiffuseColour(0.5f, 0.4f, 0.35f);
+        light->setSpecularColour(0, 0, 0);
+        light->setAttenuation(8000, 1, 0.0005, 0);
+        light->setPosition(220, 100, -200);
+        light->setCastShadows(true);
+        light->setType(Light::LT_POINT);
+
+        Plane pln = MovablePlane("plane");
+        pln.normal = Vector3::UNIT_Y;
+        pln.d = 107;
+        MeshManager::getSingleton().createPlane("ground_plane",
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, pln,
+            1500, 1500, 50, 50, true, 1, 5, 5, Vector3::UNIT_Z);
+        Entity* groundPlane = mSceneMgr->createEntity("plane", "ground_plane");
+        groundPlane->setMaterialName("Examples/Rocky");
+        groundPlane->setCastShadows(false);
+        mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(groundPlane);
+
+        // one copy of the casters is a row of barrel, head and knot, the
+        // copies are laid out on a grid going away from the camera
+        const Real spacing = 300;
+        size_t columns = (size_t)Math::Ceil(Math::Sqrt((Real)mNumCopies));
+        for (size_t i = 0; i < mNumCopies; ++i)
+        {
+            Vector3 origin(((i % columns) - (columns - 1) * 0.5f) * spacing, 0,
+                -320 - (Real)(i / columns) * 100);
+
+            Entity* bar = mSceneMgr->createEntity("Barrel.mesh");
+            bar->setCastShadows(true);
+            SceneNode* barNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+            barNode->attachObject(bar);
+            barNode->setScale(7, 7, 7);
+            barNode->setPosition(origin + Vector3(0, -85, 0));
+            mCasterNodes.push_back(barNode);
+
+            Entity* head = mSceneMgr->createEntity("ogrehead.mesh");
+            head->setCastShadows(true);
+            SceneNode* headNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+            headNode->attachObject(head);
+            headNode->setPosition(origin + Vector3(-100, -80, 0));
+            mCasterNodes.push_back(headNode);
+
+            Entity* torus = mSceneMgr->createEntity("knot.mesh");
+            torus->setCastShadows(true);
+            torus->setMaterialName("Examples/RustySteel");
+            SceneNode* torusNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+            torusNode->setScale(0.5, 0.5, 0.5);
+            torusNode->attachObject(torus);
+            torusNode->setPosition(origin + Vector3(100, -60, 0));
+            mCasterNodes.push_back(torusNode);
+        }
+
+        mCamera->setPosition(0, 0, 500);
+        mCamera->pitch(Degree(-20.f));
+    }
+
+    void cleanupContent()
+    {
+        mCasterNodes.clear();
+        MeshManager::getSingleton().remove("ground_plane");
+    }
+
+    size_t mNumCopies;
+    size_t mShadowVolumeThreads;
+    std::vector<SceneNode*> mCasterNodes;
+};
+
+#endif
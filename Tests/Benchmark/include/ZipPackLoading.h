@@ -0,0 +1,253 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __ZipPackLoading_H__
+#define __ZipPackLoading_H__
+
+#include "Ogre.h"
+#include "OgreFileSystem.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+#if OGRE_NO_ZIP_ARCHIVE == 0
+#include "OgreIndexedZip.h"
+#endif
+
+using namespace Ogre;
+
+/** Opens every file of every zip pack next to the packs in the Zip resource
+    locations, the Samples media packs, timing how long it takes with a given
+    number of threads.
+@remarks
+    The packs are read through IndexedZipArchive, which inflates the files on
+    the threads opening them. The files are shared out between the calling
+    thread and requests to the Root's WorkQueue the same way the scene manager
+    shares out its tasks, so no more threads than the queue has workers, plus
+    the calling one, can take part. Every pack is read once beforehand, so
+    all runs start with the packs in the page cache.
+*/
+class ZipPackLoading : public WorkQueue::RequestHandler
+{
+public:
+    struct Result
+    {
+        /// Threads requested and those which could take part
+        size_t threads;
+        size_t usedThreads;
+        /// Wall clock time to open and read every file
+        Real milliseconds;
+        size_t packs;
+        size_t files;
+        /// Uncompressed size of the files read
+        size_t bytes;
+        /// Files which failed to open
+        size_t failures;
+    };
+
+    ZipPackLoading() : mQueue(0), mChannel(0)
+    {
+#if OGRE_NO_ZIP_ARCHIVE == 0
+        std::set<String> folders;
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        StringVector groups = rgm.getResourceGroups();
+        for (StringVector::iterator g = groups.begin(); g != groups.end(); ++g)
+        {
+            ResourceGroupManager::LocationList locations = rgm.getResourceLocationList(*g);
+            for (ResourceGroupManager::LocationList::iterator l = locations.begin(); l != locations.end(); ++l)
+            {
+                String name, folder;
+                if ((*l)->archive->getType() == "Zip")
+                    StringUtil::splitFilename((*l)->archive->getName(), name, folder);
+                if (!folder.empty())
+                    folders.insert(folder);
+            }
+        }
+
+        // not just the packs in use, all of them
+        for (std::set<String>::iterator f = folders.begin(); f != folders.end(); ++f)
+        {
+            FileSystemArchive folder(*f, "FileSystem", true);
+            StringVectorPtr packs = folder.find("*.zip", false);
+            for (StringVector::iterator p = packs->begin(); p != packs->end(); ++p)
+            {
+                IndexedZipArchive* pack = OGRE_NEW IndexedZipArchive(*f + *p, "IndexedZip");
+                try
+                {
+                    pack->load();
+                }
+                catch (Exception&)
+                {
+                    OGRE_DELETE pack;
+                    continue;
+                }
+                mPacks.push_back(pack);
+
+                FileInfoListPtr files = pack->listFileInfo(true);
+                for (FileInfoList::iterator i = files->begin(); i != files->end(); ++i)
+                {
+                    PackFile file = { pack, i->path + i->filename };
+                    mFiles.push_back(file);
+                }
+            }
+        }
+#endif
+    }
+
+    ~ZipPackLoading()
+    {
+        for (size_t i = 0; i < mPacks.size(); ++i)
+            OGRE_DELETE mPacks[i];
+
+        Root* root = Root::getSingletonPtr();
+        if (mQueue && root && root->getWorkQueue() == mQueue)
+            mQueue->removeRequestHandler(mChannel, this);
+    }
+
+    /// Whether there's anything to load
+    bool hasPacks() const { return !mFiles.empty(); }
+
+    /** Opens and reads every file of every pack
+        @param threads The number of threads to share the files out between */
+    Result run(size_t threads)
+    {
+        Result result = { threads, 1, 0, mPacks.size(), mFiles.size(), 0, 0 };
+
+        warmPageCache();
+
+        WorkQueue* wq = Root::getSingleton().getWorkQueue();
+        if (mQueue != wq)
+        {
+            mQueue = wq;
+            mChannel = wq->getChannel("Benchmark/ZipPackLoading");
+            wq->addRequestHandler(mChannel, this);
+        }
+
+        mNextFile.set(0);
+        mBytes.set(0);
+        mFailures.set(0);
+        mPendingTasks.set(0);
+
+        Timer timer;
+#if OGRE_THREAD_SUPPORT
+        size_t workers = static_cast<DefaultWorkQueue*>(wq)->getWorkerThreadCount();
+        for (size_t i = 1; i < threads && i <= workers; ++i)
+        {
+            ++mPendingTasks;
+            if (!wq->addRequest(mChannel, 0, Any(this)))
+            {
+                --mPendingTasks;
+                break;
+            }
+            ++result.usedThreads;
+        }
+#endif
+        loadFiles();
+        while (mPendingTasks.get())
+        {
+            OGRE_THREAD_YIELD;
+        }
+        result.milliseconds = timer.getMicroseconds() / 1000.0f;
+
+        result.bytes = mBytes.get();
+        result.failures = mFailures.get();
+        return result;
+    }
+
+    /// @copydoc WorkQueue::RequestHandler::canHandleRequest
+    bool canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+    {
+        return any_cast<ZipPackLoading*>(req->getData()) == this;
+    }
+
+    /// @copydoc WorkQueue::RequestHandler::handleRequest
+    WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+    {
+        loadFiles();
+        --mPendingTasks;
+        return OGRE_NEW WorkQueue::Response(req, true, Any());
+    }
+
+protected:
+    struct PackFile
+    {
+        Archive* pack;
+        /// Path within the pack
+        String path;
+    };
+    typedef std::vector<PackFile> PackFileList;
+
+    /// Opens and reads files until there are none left
+    void loadFiles()
+    {
+        char buffer[65536];
+        for (size_t i = mNextFile++; i < mFiles.size(); i = mNextFile++)
+        {
+            try
+            {
+                DataStreamPtr stream = mFiles[i].pack->open(mFiles[i].path);
+                if (stream.isNull())
+                {
+                    ++mFailures;
+                    continue;
+                }
+                // the stream is inflated already, reading it is what loading it would do
+                size_t bytes = 0, read;
+                while ((read = stream->read(buffer, sizeof(buffer))) > 0)
+                    bytes += read;
+                mBytes += bytes;
+            }
+            catch (Exception&)
+            {
+                ++mFailures;
+            }
+        }
+    }
+
+    /// Reads every pack, so the runs do not depend on the order they're in
+    void warmPageCache()
+    {
+        char buffer[65536];
+        for (size_t i = 0; i < mPacks.size(); ++i)
+        {
+            std::ifstream pack(mPacks[i]->getName().c_str(), std::ios::in | std::ios::binary);
+            while (pack.read(buffer, sizeof(buffer)))
+                ;
+        }
+    }
+
+    std::vector<Archive*> mPacks;
+    PackFileList mFiles;
+
+    WorkQueue* mQueue;
+    uint16 mChannel;
+    /// Next file to load, shared by all threads
+    AtomicScalar<size_t> mNextFile;
+    AtomicScalar<size_t> mBytes;
+    AtomicScalar<size_t> mFailures;
+    AtomicScalar<size_t> mPendingTasks;
+};
+
+#endif
@@ -0,0 +1,949 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "BenchmarkContext.h"
+#include "OgreConfigFile.h"
+#include "OgreFrameAllocator.h"
+#include "OgreMemoryTracker.h"
+#include "OgreSkeletonAnimationCache.h"
+#include "OgrePlatform.h"
+#include <fstream>
+#include <iostream>
+
+#ifdef OGRE_BUILD_RENDERSYSTEM_NULL
+#include "OgreNullRenderSystem.h"
+#endif
+
+namespace
+{
+    /// Quotes and escapes a string for JSON output
+    String jsonString(const String& str)
+    {
+        StringStream ss;
+        ss << '"';
+        for (String::const_iterator i = str.begin(); i != str.end(); ++i)
+        {
+            switch (*i)
+            {
+            case '"':  ss << "\\\""; break;
+            case '\\': ss << "\\\\"; break;
+            case '\n': ss << "\\n"; break;
+            case '\r': ss << "\\r"; break;
+            case '\t': ss << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(*i) < 0x20)
+                    ss << ' ';
+                else
+                    ss << *i;
+            }
+        }
+        ss << '"';
+        return ss.str();
+    }
+
+    void writeStats(std::ostream& out, const StageStats& stats, bool withCalls)
+    {
+        out << "{ \"mean\": " << stats.mean()
+            << ", \"min\": " << stats.min
+            << ", \"max\": " << stats.max
+            << ", \"total\": " << stats.total;
+        if (withCalls)
+            out << ", \"calls\": " << stats.calls;
+        out << " }";
+    }
+}
+//-----------------------------------------------------------------------
+
+BenchmarkContext::BenchmarkContext(int argc, char** argv)
+    : mTimestep(0.01f), mFrameCount(300), mWarmupFrames(30), mCrowdSize(500), mSharedCrowdSize(2000), mKernelVertices(65536), mSceneKernelElements(100000), mShadowCasterCount(64), mHelp(false), mCollector(0)
+{
+    Ogre::UnaryOptionList unOpt;
+    Ogre::BinaryOptionList binOpt;
+
+    // Prepopulate expected options.
+    unOpt["-h"] = false;        // help, give usage details
+    unOpt["--help"] = false;    // help, give usage details
+    binOpt["-rs"] = "Null Rendering Subsystem"; // rendersystem to use
+    binOpt["-f"] = "300";       // number of measured frames per sample
+    binOpt["-w"] = "30";        // number of warmup frames per sample
+    binOpt["-t"] = "0.01";      // fixed timestep in seconds
+    binOpt["-o"] = "benchmark.json"; // file to write the results to
+    // sample plugins to run, only those that do not skip themselves on the Null render system
+    binOpt["-s"] = "Sample_Instancing,Sample_ParticleFX,Sample_SkeletalAnimation,Sample_Shadows";
+    binOpt["-c"] = "500";       // number of characters in the skinned crowd
+    binOpt["-at"] = "1,4";      // animation thread counts to run the skinned crowd with
+    binOpt["-sc"] = "2000";     // number of characters in the shared clip crowd
+    binOpt["-kv"] = "65536";    // number of vertices to time the OptimisedUtil functions with
+    binOpt["-sn"] = "100000";   // number of nodes, boxes and renderables to time the scene manager with
+    binOpt["-ss"] = "64";       // number of copies of the casters of the stencil shadow scene
+    binOpt["-st"] = "1,4";      // shadow volume thread counts to run the stencil shadow scene with
+    binOpt["-dn"] = "20000";    // number of objects in the dynamic query scene
+    binOpt["-dm"] = "OctreeSceneManager,BvhSceneManager"; // scene manager types to run it with
+    binOpt["-dt"] = "1,4";      // batched query thread counts to run it with
+    binOpt["-ml"] = "stream,mapped"; // file system archive modes to load the media with
+    binOpt["-zt"] = "1,4";      // thread counts to load the zip packs with
+    binOpt["-lg"] = "Popular";  // resource groups to load
+    binOpt["-lt"] = "1,8";      // loading thread counts to load them with
+
+    // Parse.
+    Ogre::findCommandLineOpts(argc, argv, unOpt, binOpt);
+
+    mHelp = unOpt["-h"] || unOpt["--help"];
+    mRenderSystemName = binOpt["-rs"];
+    mFrameCount = StringConverter::parseSizeT(binOpt["-f"], mFrameCount);
+    mWarmupFrames = StringConverter::parseSizeT(binOpt["-w"], mWarmupFrames);
+    mTimestep = StringConverter::parseReal(binOpt["-t"], mTimestep);
+    mOutputFile = binOpt["-o"];
+    mSamplePlugins = StringUtil::split(binOpt["-s"], ", ");
+    mCrowdSize = StringConverter::parseSizeT(binOpt["-c"], 500);
+    mSharedCrowdSize = StringConverter::parseSizeT(binOpt["-sc"], 2000);
+    mKernelVertices = StringConverter::parseSizeT(binOpt["-kv"], 65536);
+    mSceneKernelElements = StringConverter::parseSizeT(binOpt["-sn"], 100000);
+    mShadowCasterCount = StringConverter::parseSizeT(binOpt["-ss"], 64);
+    mDynamicObjectCount = StringConverter::parseSizeT(binOpt["-dn"], 20000);
+    mDynamicSceneManagerTypes = StringUtil::split(binOpt["-dm"], ", ");
+    mMediaLoadingModes = StringUtil::split(binOpt["-ml"], ", ");
+    mLoadingGroups = StringUtil::split(binOpt["-lg"], ", ");
+
+    StringVector threadCounts = StringUtil::split(binOpt["-at"], ", ");
+    for (StringVector::iterator i = threadCounts.begin(); i != threadCounts.end(); ++i)
+        mAnimationThreadCounts.push_back(std::max(StringConverter::parseSizeT(*i, 1), (size_t)1));
+
+    threadCounts = StringUtil::split(binOpt["-st"], ", ");
+    for (StringVector::iterator i = threadCounts.begin(); i != threadCounts.end(); ++i)
+        mShadowVolumeThreadCounts.push_back(std::max(StringConverter::parseSizeT(*i, 1), (size_t)1));
+
+    threadCounts = StringUtil::split(binOpt["-zt"], ", ");
+    for (StringVector::iterator i = threadCounts.begin(); i != threadCounts.end(); ++i)
+        mZipPackThreadCounts.push_back(std::max(StringConverter::parseSizeT(*i, 1), (size_t)1));
+
+    threadCounts = StringUtil::split(binOpt["-lt"], ", ");
+    for (StringVector::iterator i = threadCounts.begin(); i != threadCounts.end(); ++i)
+        mLoadingThreadCounts.push_back(std::max(StringConverter::parseSizeT(*i, 1), (size_t)1));
+
+    threadCounts = StringUtil::split(binOpt["-dt"], ", ");
+    for (StringVector::iterator i = threadCounts.begin(); i != threadCounts.end(); ++i)
+        mSceneQueryThreadCounts.push_back(std::max(StringConverter::parseSizeT(*i, 1), (size_t)1));
+
+    if (mFrameCount == 0)
+        mFrameCount = 1;
+
+    // The stages of a frame, in the order they happen; see Root::_fireFrameStarted
+    // and SceneManager::_renderScene for where these are profiled
+    mStageNames.push_back("Frame");
+    mStageNames.push_back("ParticleSystem::_update");
+    mStageNames.push_back("_renderScene");
+    mStageNames.push_back("_applySceneAnimations");
+    mStageNames.push_back("_updateSceneGraph");
+    mStageNames.push_back("updateAnimationsParallel");
+    mStageNames.push_back("prepareShadowTextures");
+    mStageNames.push_back("_findVisibleObjects");
+    mStageNames.push_back("_renderVisibleObjects");
+    mStageNames.push_back("renderShadowVolumesToStencil");
+    mStageNames.push_back("SceneQueries");
+    mStageNames.push_back("BatchedSceneQueries");
+
+#ifdef INCLUDE_RTSHADER_SYSTEM
+    mShaderGenerator     = NULL;
+    mMaterialMgrListener = NULL;
+#endif // INCLUDE_RTSHADER_SYSTEM
+}
+//-----------------------------------------------------------------------
+
+BenchmarkContext::~BenchmarkContext()
+{
+    OGRE_DELETE mCollector;
+}
+//-----------------------------------------------------------------------
+
+void BenchmarkContext::createRoot()
+{
+    Ogre::String pluginsPath = Ogre::BLANKSTRING;
+#ifndef OGRE_STATIC_LIB
+    pluginsPath = mFSLayer->getConfigFilePath("plugins.cfg");
+#endif
+    // we use separate config and log files for the benchmark
+    mRoot = OGRE_NEW Ogre::Root(pluginsPath, mFSLayer->getWritablePath("ogrebenchmark.cfg"),
+                                mFSLayer->getWritablePath("ogrebenchmark.log"));
+
+#ifdef OGRE_STATIC_LIB
+    mStaticPluginLoader.load();
+#endif
+    mOverlaySystem = OGRE_NEW Ogre::OverlaySystem();
+}
+//-----------------------------------------------------------------------
+
+bool BenchmarkContext::oneTimeConfig()
+{
+    RenderSystem* rs = mRoot->getRenderSystemByName(mRenderSystemName);
+    if (!rs)
+    {
+        LogManager::getSingleton().logMessage("Benchmark: render system '" + mRenderSystemName +
+                                              "' is not available, using the first one loaded");
+        const RenderSystemList& lstRend = mRoot->getAvailableRenderers();
+        rs = lstRend.empty() ? NULL : lstRend.front();
+    }
+
+    mRoot->setRenderSystem(rs);
+
+    if (rs)
+    {
+        // set sane defaults, the window size affects fill-rate bound stages only
+        rs->setConfigOption("Full Screen", "No");
+        try {
+            rs->setConfigOption("Video Mode", "800 x 600");
+        } catch(...) {}
+        try {
+            rs->setConfigOption("VSync", "No");
+        } catch(...) {}
+        // the Null render system would rasterise every draw call to answer them
+        try {
+            rs->setConfigOption("Occlusion Queries", "No");
+        } catch(...) {}
+    }
+
+    mRenderSystemName = rs ? rs->getName() : "";
+
+    return rs != NULL;
+}
+//-----------------------------------------------------------------------
+
+void BenchmarkContext::setup()
+{
+    mWindow = createWindow();
+    mWindow->setDeactivateOnFocusChange(false);
+
+    locateResources();
+
+#ifdef INCLUDE_RTSHADER_SYSTEM
+    // Must be before resource loading in order to allow parsing extended material attributes.
+    if (!initialiseRTShaderSystem())
+    {
+        OGRE_EXCEPT(Ogre::Exception::ERR_FILE_NOT_FOUND,
+                    "Shader Generator Initialization failed - Core shader libs path not found",
+                    "BenchmarkContext::setup");
+    }
+#endif // INCLUDE_RTSHADER_SYSTEM
+
+    loadResources();
+    Ogre::TextureManager::getSingleton().setDefaultNumMipmaps(5);
+    mRoot->addFrameListener(this);
+
+    mCollector = OGRE_NEW FrameStageCollector(mStageNames);
+#if OGRE_PROFILING
+    Profiler* prof = Profiler::getSingletonPtr();
+    prof->addListener(mCollector);
+    // report every frame rather than every 10th
+    prof->setUpdateDisplayFrequency(1);
+    prof->setEnabled(true);
+#else
+    // the stages are only timed by the profiler, without it they would silently come out empty
+    const char* warning = "Benchmark: OGRE_PROFILING is disabled, the per stage times will be empty "
+        "and only whole frame times will be reported. Rebuild with OGRE_PROFILING enabled to time the stages.";
+    LogManager::getSingleton().logMessage(warning, LML_CRITICAL);
+    std::cerr << "WARNING: " << warning << std::endl;
+#endif
+}
+//-----------------------------------------------------------------------
+
+std::vector<std::pair<String, OgreBites::Sample*> > BenchmarkContext::loadSamples()
+{
+    std::vector<std::pair<String, OgreBites::Sample*> > samples;
+
+    Ogre::ConfigFile cfg;
+    cfg.load(mFSLayer->getConfigFilePath("samples.cfg"));
+
+    Ogre::String sampleDir = cfg.getSetting("SampleFolder");
+    Ogre::StringVector available = cfg.getMultiSetting("SamplePlugin");
+
+#if OGRE_PLATFORM != OGRE_PLATFORM_APPLE && OGRE_PLATFORM != OGRE_PLATFORM_APPLE_IOS
+    if (sampleDir.empty()) sampleDir = ".";   // user didn't specify plugins folder, try current one
+#endif
+
+    // add slash or backslash based on platform
+    char lastChar = sampleDir[sampleDir.length() - 1];
+    if (lastChar != '/' && lastChar != '\\')
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || (OGRE_PLATFORM == OGRE_PLATFORM_WINRT)
+        sampleDir += "\\";
+#elif OGRE_PLATFORM == OGRE_PLATFORM_LINUX
+        sampleDir += "/";
+#endif
+    }
+
+    for (Ogre::StringVector::iterator i = mSamplePlugins.begin(); i != mSamplePlugins.end(); ++i)
+    {
+        // samples.cfg names the debug plugins with a suffix, match either
+        Ogre::String plugin;
+        for (Ogre::StringVector::iterator j = available.begin(); j != available.end(); ++j)
+        {
+            if (*j == *i || *j == *i + "_d")
+            {
+                plugin = *j;
+                break;
+            }
+        }
+
+        if (plugin.empty())
+        {
+            SampleResult result;
+            result.plugin = *i;
+            result.skipReason = "Not listed in samples.cfg";
+            mResults.push_back(result);
+            continue;
+        }
+
+        try
+        {
+            mRoot->loadPlugin(sampleDir + plugin);
+        }
+        catch (Ogre::Exception& e)
+        {
+            SampleResult result;
+            result.plugin = *i;
+            result.skipReason = e.getDescription();
+            mResults.push_back(result);
+            continue;
+        }
+
+        Ogre::Plugin* p = mRoot->getInstalledPlugins().back();
+        OgreBites::SamplePlugin* sp = dynamic_cast<OgreBites::SamplePlugin*>(p);
+        if (!sp)
+            continue;
+
+        OgreBites::SampleSet newSamples = sp->getSamples();
+        for (OgreBites::SampleSet::iterator j = newSamples.begin(); j != newSamples.end(); ++j)
+            samples.push_back(std::make_pair(*i, *j));
+    }
+
+    return samples;
+}
+//-----------------------------------------------------------------------
+
+BenchmarkContext::SampleResult BenchmarkContext::benchmarkSample(const String& plugin, OgreBites::Sample* s)
+{
+    SampleResult result;
+    result.plugin = plugin;
+    result.title = s->getInfo()["Title"];
+
+    // reset frame timing
+    Ogre::ControllerManager::getSingleton().setFrameDelay(0);
+    Ogre::ControllerManager::getSingleton().setTimeFactor(1.f);
+
+    try
+    {
+        // Seed rand with a predictable value, scenes are often randomly populated
+        srand(5);
+        runSample(s);
+    }
+    catch (Ogre::Exception& e)
+    {
+        result.skipReason = e.getDescription();
+        runSample(0);
+        return result;
+    }
+
+    // Give a fixed timestep for particles and other time-dependent things in OGRE
+    Ogre::ControllerManager::getSingleton().setFrameDelay(mTimestep);
+    LogManager::getSingleton().logMessage("----- Benchmarking " + result.title + " -----");
+
+    for (size_t i = 0; i < mWarmupFrames; ++i)
+        mRoot->renderOneFrame();
+
+    Timer timer;
+    mCollector->reset();
+    mCollector->setRecording(true);
+    for (size_t i = 0; i < mFrameCount; ++i)
+    {
+        timer.reset();
+        mRoot->renderOneFrame();
+        result.frameTime.add(timer.getMicroseconds() / 1000.0f);
+
+        recordRenderStats(result);
+        recordMemoryStats(result);
+        recordAnimationStats(result);
+    }
+    mCollector->setRecording(false);
+    result.stages = mCollector->getStageStats();
+
+    runSample(0);
+#ifdef INCLUDE_RTSHADER_SYSTEM
+    mShaderGenerator->removeAllShaderBasedTechniques(); // clear techniques from the RTSS
+#endif
+
+    return result;
+}
+//-----------------------------------------------------------------------
+
+void BenchmarkContext::recordRenderStats(SampleResult& result)
+{
+#ifdef OGRE_BUILD_RENDERSYSTEM_NULL
+    RenderSystem* rs = mRoot->getRenderSystem();
+    if (rs->getName() != "Null Rendering Subsystem")
+        return;
+
+    // counters are rolled over when the window buffers are swapped
+    NullFrameStats stats;
+    rs->getCustomAttribute("LAST_FRAME_STATS", &stats);
+
+    result.renderStats["drawCalls"].add((Real)stats.drawCalls);
+    result.renderStats["primitives"].add((Real)stats.primitives);
+    result.renderStats["vertices"].add((Real)stats.vertices);
+    result.renderStats["stateChanges"].add((Real)stats.stateChanges);
+    result.renderStats["textureBinds"].add((Real)stats.textureBinds);
+    result.renderStats["gpuProgramBinds"].add((Real)stats.gpuProgramBinds);
+    result.renderStats["renderTargetChanges"].add((Real)stats.renderTargetChanges);
+    result.renderStats["bytesUploaded"].add((Real)stats.bytesUploaded);
+#endif
+}
+//-----------------------------------------------------------------------
+
+void BenchmarkContext::recordMemoryStats(SampleResult& result)
+{
+    const FrameAllocator::Stats& arena = FrameAllocator::getSingleton().getLastFrameStats();
+    result.memoryStats["frameArenaAllocations"].add((Real)arena.allocations);
+    result.memoryStats["frameArenaBytes"].add((Real)arena.bytes);
+    result.memoryStats["frameArenaFallbacks"].add((Real)arena.fallbacks);
+#if OGRE_MEMORY_TRACKER
+    // allocations the arena did not catch
+    result.memoryStats["heapAllocations"].add((Real)MemoryTracker::get().getLastFrameAllocationCount());
+#endif
+}
+//-----------------------------------------------------------------------
+
+void BenchmarkContext::recordAnimationStats(SampleResult& result)
+{
+    SceneManager::SkeletonUpdateStats updates = { 0, 0, 0 };
+    SkeletonAnimationCache::Stats cache = { 0, 0, 0 };
+    SceneManagerEnumerator::SceneManagerIterator it = mRoot->getSceneManagerIterator();
+    while (it.hasMoreElements())
+    {
+        SceneManager* sm = it.getNext();
+        SceneManager::SkeletonUpdateStats smUpdates = sm->getSkeletonUpdateStats();
+        updates.evaluatedSkeletons += smUpdates.evaluatedSkeletons;
+        updates.interpolatedSkeletons += smUpdates.interpolatedSkeletons;
+        updates.skippedSkeletons += smUpdates.skippedSkeletons;
+        if (sm->getSkeletonAnimationCache())
+        {
+            SkeletonAnimationCache::Stats smCache = sm->getSkeletonAnimationCache()->getStats();
+            cache.lookups += smCache.lookups;
+            cache.hits += smCache.hits;
+            cache.entries += smCache.entries;
+        }
+    }
+
+    result.animationStats["skeletonsEvaluated"].add((Real)updates.evaluatedSkeletons);
+    result.animationStats["skeletonsInterpolated"].add((Real)updates.interpolatedSkeletons);
+    result.animationStats["skeletonsSkipped"].add((Real)updates.skippedSkeletons);
+    result.animationStats["cacheLookups"].add((Real)cache.lookups);
+    result.animationStats["cacheHits"].add((Real)cache.hits);
+    result.animationStats["cacheEntries"].add((Real)cache.entries);
+}
+//-----------------------------------------------------------------------
+
+void BenchmarkContext::benchmarkKernels()
+{
+    const OptimisedUtil::ImplementationType types[] = {
+        OptimisedUtil::IMPL_GENERAL, OptimisedUtil::IMPL_SSE, OptimisedUtil::IMPL_AVX2 };
+    const char* names[] = { "General", "SSE", "AVX2" };
+
+    OptimisedUtilKernels kernels(mKernelVertices);
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); ++i)
+    {
+        OptimisedUtil* impl = OptimisedUtil::_getImplementation(types[i]);
+        if (!impl)
+            continue;
+
+        LogManager::getSingleton().logMessage(String("Benchmark: timing OptimisedUtil ") + names[i]);
+        // warm the caches up, then measure
+        kernels.run(impl, 1);
+        mKernelResults.push_back(std::make_pair(String(names[i]), kernels.run(impl, mFrameCount)));
+    }
+}
+//-----------------------------------------------------------------------
+
+void BenchmarkContext::benchmarkSceneKernels()
+{
+    LogManager::getSingleton().logMessage("Benchmark: timing the scene manager");
+
+    SceneKernels kernels(mSceneKernelElements);
+    // warm the caches up, then measure
+    kernels.run(1);
+    mSceneKernelResults = kernels.run(std::max(mFrameCount / 10, (size_t)1));
+}
+//-----------------------------------------------------------------------
+
+void BenchmarkContext::benchmarkMediaLoading()
+{
+    MediaLoading media;
+    for (size_t i = 0; i < mMediaLoadingModes.size(); ++i)
+    {
+        if (mMediaLoadingModes[i] == "mapped" && !MappedFileDataStream::isSupported())
+        {
+            LogManager::getSingleton().logMessage("Benchmark: memory mapped files are not supported, "
+                                                  "skipping the mapped media loading");
+            continue;
+        }
+
+        LogManager::getSingleton().logMessage("Benchmark: loading the media, " + mMediaLoadingModes[i]);
+        mMediaResults.push_back(media.run(mMediaLoadingModes[i] == "mapped"));
+    }
+}
+//-----------------------------------------------------------------------
+
+void BenchmarkContext::benchmarkZipPackLoading()
+{
+    if (mZipPackThreadCounts.empty())
+        return;
+
+    ZipPackLoading packs;
+    if (!packs.hasPacks())
+    {
+        LogManager::getSingleton().logMessage("Benchmark: no zip packs found, skipping the zip pack loading");
+        return;
+    }
+
+    for (size_t i = 0; i < mZipPackThreadCounts.size(); ++i)
+    {
+        LogManager::getSingleton().logMessage("Benchmark: loading the zip packs, " +
+            StringConverter::toString(mZipPackThreadCounts[i]) + " threads");
+        mZipPackResults.push_back(packs.run(mZipPackThreadCounts[i]));
+    }
+}
+//-----------------------------------------------------------------------
+
+void BenchmarkContext::benchmarkResourceGroupLoading()
+{
+    ResourceGroupLoading loading;
+    StringVector groups = ResourceGroupManager::getSingleton().getResourceGroups();
+    for (size_t g = 0; g < mLoadingGroups.size(); ++g)
+    {
+        if (std::find(groups.begin(), groups.end(), mLoadingGroups[g]) == groups.end())
+        {
+            LogManager::getSingleton().logMessage("Benchmark: no resource group " + mLoadingGroups[g] +
+                                                  ", skipping loading it");
+            continue;
+        }
+
+        for (size_t i = 0; i < mLoadingThreadCounts.size(); ++i)
+        {
+            LogManager::getSingleton().logMessage("Benchmark: loading resource group " + mLoadingGroups[g] +
+                ", " + StringConverter::toString(mLoadingThreadCounts[i]) + " threads");
+            mGroupLoadingResults.push_back(loading.run(mLoadingGroups[g], mLoadingThreadCounts[i]));
+        }
+    }
+}
+//-----------------------------------------------------------------------
+
+void BenchmarkContext::go(OgreBites::Sample* initialSample)
+{
+    if (mHelp)
+    {
+        std::cout<<"\nOgre CPU Frame Benchmark:\n";
+        std::cout<<"Runs sample scenes with a fixed timestep and reports CPU time per frame stage as JSON.\n\n";
+        std::cout<<"Usage: Benchmark [opts]\n\n";
+        std::cout<<"Options:\n";
+        std::cout<<"\t-h, --help   Show usage details.\n";
+        std::cout<<"\t-rs [name]   Render system to use (default: Null Rendering Subsystem).\n";
+        std::cout<<"\t-f [count]   Number of frames measured per sample (default: 300).\n";
+        std::cout<<"\t-w [count]   Number of warmup frames per sample (default: 30).\n";
+        std::cout<<"\t-t [secs]    Fixed timestep per frame (default: 0.01).\n";
+        std::cout<<"\t-s [list]    Comma separated sample plugins to run\n";
+        std::cout<<"\t             (default: Sample_Instancing,Sample_ParticleFX,Sample_SkeletalAnimation,Sample_Shadows).\n";
+        std::cout<<"\t-c [count]   Number of characters in the skinned crowd, 0 to skip it (default: 500).\n";
+        std::cout<<"\t-at [list]   Comma separated animation thread counts to run the crowd with (default: 1,4).\n";
+        std::cout<<"\t-sc [count]  Number of characters in the shared clip crowd, 0 to skip it (default: 2000).\n";
+        std::cout<<"\t-kv [count]  Number of vertices to time the SIMD functions with, 0 to skip them (default: 65536).\n";
+        std::cout<<"\t-sn [count]  Number of nodes, boxes and renderables to time the scene graph update, culling\n";
+        std::cout<<"\t             and render queue sorting with, 0 to skip them (default: 100000).\n";
+        std::cout<<"\t-ss [count]  Copies of the casters of the stencil shadow scene, 0 to skip it (default: 64).\n";
+        std::cout<<"\t-st [list]   Comma separated shadow volume thread counts to run it with (default: 1,4).\n";
+        std::cout<<"\t-dn [count]  Number of objects in the dynamic query scene, 0 to skip it (default: 20000).\n";
+        std::cout<<"\t-dm [list]   Comma separated scene manager types to run it with\n";
+        std::cout<<"\t             (default: OctreeSceneManager,BvhSceneManager).\n";
+        std::cout<<"\t-dt [list]   Comma separated batched query thread counts to run it with (default: 1,4).\n";
+        std::cout<<"\t-ml [list]   Comma separated ways to read the files when loading the media, stream\n";
+        std::cout<<"\t             or mapped, empty to skip it (default: stream,mapped).\n";
+        std::cout<<"\t-zt [list]   Comma separated thread counts to load the zip packs with, empty to skip it\n";
+        std::cout<<"\t             (default: 1,4).\n";
+        std::cout<<"\t-lg [list]   Comma separated resource groups to load, empty to skip it (default: Popular).\n";
+        std::cout<<"\t-lt [list]   Comma separated loading thread counts to load them with (default: 1,8).\n";
+        std::cout<<"\t-o [path]    File to write the JSON results to (default: benchmark.json).\n\n";
+        return;
+    }
+
+    createRoot();
+    if (!oneTimeConfig())
+        return;
+
+    setup();
+
+    // before any sample has loaded some of the media
+    benchmarkMediaLoading();
+    benchmarkZipPackLoading();
+    benchmarkResourceGroupLoading();
+
+    std::vector<std::pair<String, OgreBites::Sample*> > samples = loadSamples();
+    for (size_t i = 0; i < samples.size(); ++i)
+        mResults.push_back(benchmarkSample(samples[i].first, samples[i].second));
+
+    // the built-in crowd, once per thread count so they can be compared
+    for (size_t i = 0; mCrowdSize > 0 && i < mAnimationThreadCounts.size(); ++i)
+    {
+        Sample_SkinnedCrowd crowd(mCrowdSize, mAnimationThreadCounts[i]);
+        mResults.push_back(benchmarkSample("SkinnedCrowd", &crowd));
+    }
+
+    // the shared clip crowd, without then with the animation cache
+    for (int useCache = 0; mSharedCrowdSize > 0 && useCache < 2; ++useCache)
+    {
+        Sample_SharedClipCrowd crowd(mSharedCrowdSize, useCache != 0);
+        mResults.push_back(benchmarkSample("SharedClipCrowd", &crowd));
+    }
+
+    // the stencil shadow scene, once per thread count
+    for (size_t i = 0; mShadowCasterCount > 0 && i < mShadowVolumeThreadCounts.size(); ++i)
+    {
+        Sample_StencilShadowCasters casters(mShadowCasterCount, mShadowVolumeThreadCounts[i]);
+        mResults.push_back(benchmarkSample("StencilShadowCasters", &casters));
+    }
+
+    // the dynamic query scene, once per scene manager type and thread count
+    for (size_t i = 0; mDynamicObjectCount > 0 && i < mDynamicSceneManagerTypes.size(); ++i)
+    {
+        for (size_t j = 0; j < mSceneQueryThreadCounts.size(); ++j)
+        {
+            Sample_DynamicSceneQueries scene(mDynamicSceneManagerTypes[i], mDynamicObjectCount,
+                mSceneQueryThreadCounts[j]);
+            mResults.push_back(benchmarkSample("DynamicSceneQueries", &scene));
+        }
+    }
+
+    if (mKernelVertices > 0)
+        benchmarkKernels();
+    if (mSceneKernelElements > 0)
+        benchmarkSceneKernels();
+
+    writeResults(mOutputFile);
+
+#if OGRE_PROFILING
+    Profiler::getSingleton().removeListener(mCollector);
+#endif
+#ifdef INCLUDE_RTSHADER_SYSTEM
+    finaliseRTShaderSystem();
+#endif
+    closeApp();
+}
+//-----------------------------------------------------------------------
+
+bool BenchmarkContext::frameStarted(const Ogre::FrameEvent& evt)
+{
+    // pass a fixed timestep along to the samples
+    Ogre::FrameEvent fixed_evt = Ogre::FrameEvent();
+    fixed_evt.timeSinceLastFrame = mTimestep;
+    fixed_evt.timeSinceLastEvent = mTimestep;
+
+    return SampleContext::frameStarted(fixed_evt);
+}
+//-----------------------------------------------------------------------
+
+bool BenchmarkContext::frameRenderingQueued(const Ogre::FrameEvent& evt)
+{
+    Ogre::FrameEvent fixed_evt = Ogre::FrameEvent();
+    fixed_evt.timeSinceLastFrame = mTimestep;
+    fixed_evt.timeSinceLastEvent = mTimestep;
+
+    return SampleContext::frameRenderingQueued(fixed_evt);
+}
+//-----------------------------------------------------------------------
+
+bool BenchmarkContext::frameEnded(const Ogre::FrameEvent& evt)
+{
+    Ogre::FrameEvent fixed_evt = Ogre::FrameEvent();
+    fixed_evt.timeSinceLastFrame = mTimestep;
+    fixed_evt.timeSinceLastEvent = mTimestep;
+
+    return SampleContext::frameEnded(fixed_evt);
+}
+//-----------------------------------------------------------------------
+
+void BenchmarkContext::runSample(OgreBites::Sample* s)
+{
+#ifdef INCLUDE_RTSHADER_SYSTEM
+    if (s)
+        s->setShaderGenerator(mShaderGenerator);
+#endif
+
+    SampleContext::runSample(s);
+}
+//-----------------------------------------------------------------------
+
+void BenchmarkContext::writeResults(const String& filename)
+{
+    std::ofstream out(filename.c_str());
+    if (!out.is_open())
+    {
+        OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE, "Cannot open " + filename + " for writing",
+                    "BenchmarkContext::writeResults");
+    }
+
+    out << "{\n";
+    out << "  \"ogreVersion\": " << jsonString(StringConverter::toString(OGRE_VERSION_MAJOR) + "." +
+                                               StringConverter::toString(OGRE_VERSION_MINOR) + "." +
+                                               StringConverter::toString(OGRE_VERSION_PATCH) +
+                                               OGRE_VERSION_SUFFIX) << ",\n";
+    out << "  \"renderSystem\": " << jsonString(mRenderSystemName) << ",\n";
+    out << "  \"profiling\": " << (OGRE_PROFILING ? "true" : "false") << ",\n";
+    out << "  \"frames\": " << mFrameCount << ",\n";
+    out << "  \"warmupFrames\": " << mWarmupFrames << ",\n";
+    out << "  \"timestep\": " << mTimestep << ",\n";
+    out << "  \"units\": \"milliseconds\",\n";
+    out << "  \"samples\": [";
+
+    for (size_t i = 0; i < mResults.size(); ++i)
+    {
+        const SampleResult& r = mResults[i];
+
+        out << (i ? ",\n" : "\n") << "    {\n";
+        out << "      \"plugin\": " << jsonString(r.plugin) << ",\n";
+        out << "      \"title\": " << jsonString(r.title) << ",\n";
+        if (!r.skipReason.empty())
+        {
+            out << "      \"skipped\": " << jsonString(r.skipReason) << "\n";
+            out << "    }";
+            continue;
+        }
+
+        out << "      \"frameTime\": ";
+        writeStats(out, r.frameTime, false);
+        out << ",\n";
+
+        out << "      \"stages\": {";
+        for (size_t j = 0; j < mStageNames.size(); ++j)
+        {
+            FrameStageCollector::StageStatsMap::const_iterator s = r.stages.find(mStageNames[j]);
+            out << (j ? ",\n" : "\n") << "        " << jsonString(mStageNames[j]) << ": ";
+            writeStats(out, s != r.stages.end() ? s->second : StageStats(), true);
+        }
+        out << "\n      },\n";
+
+        out << "      \"renderStats\": {";
+        std::map<String, StageStats>::const_iterator k;
+        for (k = r.renderStats.begin(); k != r.renderStats.end(); ++k)
+        {
+            out << (k != r.renderStats.begin() ? ",\n" : "\n") << "        " << jsonString(k->first) << ": ";
+            writeStats(out, k->second, false);
+        }
+        out << (r.renderStats.empty() ? "},\n" : "\n      },\n");
+
+        out << "      \"memoryStats\": {";
+        for (k = r.memoryStats.begin(); k != r.memoryStats.end(); ++k)
+        {
+            out << (k != r.memoryStats.begin() ? ",\n" : "\n") << "        " << jsonString(k->first) << ": ";
+            writeStats(out, k->second, false);
+        }
+        out << (r.memoryStats.empty() ? "},\n" : "\n      },\n");
+
+        out << "      \"animationStats\": {";
+        for (k = r.animationStats.begin(); k != r.animationStats.end(); ++k)
+        {
+            out << (k != r.animationStats.begin() ? ",\n" : "\n") << "        " << jsonString(k->first) << ": ";
+            writeStats(out, k->second, false);
+        }
+        out << (r.animationStats.empty() ? "}\n" : "\n      }\n");
+        out << "    }";
+    }
+
+    out << "\n  ],\n";
+
+    out << "  \"mediaLoading\": [";
+    for (size_t i = 0; i < mMediaResults.size(); ++i)
+    {
+        const MediaLoading::Result& m = mMediaResults[i];
+
+        out << (i ? ",\n" : "\n") << "    {\n";
+        out << "      \"mode\": " << jsonString(m.mode) << ",\n";
+        out << "      \"time\": " << m.milliseconds << ",\n";
+        out << "      \"residentKB\": " << m.residentKB << ",\n";
+        out << "      \"peakResidentKB\": " << m.peakResidentKB << ",\n";
+        out << "      \"meshes\": " << m.meshes << ",\n";
+        out << "      \"images\": " << m.images << ",\n";
+        out << "      \"bytes\": " << m.bytes << ",\n";
+        out << "      \"failures\": " << m.failures << "\n";
+        out << "    }";
+    }
+    out << (mMediaResults.empty() ? "],\n" : "\n  ],\n");
+
+    out << "  \"zipPackLoading\": [";
+    for (size_t i = 0; i < mZipPackResults.size(); ++i)
+    {
+        const ZipPackLoading::Result& z = mZipPackResults[i];
+
+        out << (i ? ",\n" : "\n") << "    {\n";
+        out << "      \"threads\": " << z.threads << ",\n";
+        out << "      \"usedThreads\": " << z.usedThreads << ",\n";
+        out << "      \"time\": " << z.milliseconds << ",\n";
+        out << "      \"packs\": " << z.packs << ",\n";
+        out << "      \"files\": " << z.files << ",\n";
+        out << "      \"bytes\": " << z.bytes << ",\n";
+        out << "      \"failures\": " << z.failures << "\n";
+        out << "    }";
+    }
+    out << (mZipPackResults.empty() ? "],\n" : "\n  ],\n");
+
+    out << "  \"resourceGroupLoading\": [";
+    for (size_t i = 0; i < mGroupLoadingResults.size(); ++i)
+    {
+        const ResourceGroupLoading::Result& l = mGroupLoadingResults[i];
+
+        out << (i ? ",\n" : "\n") << "    {\n";
+        out << "      \"group\": " << jsonString(l.group) << ",\n";
+        out << "      \"threads\": " << l.threads << ",\n";
+        out << "      \"time\": " << l.milliseconds << ",\n";
+        out << "      \"resources\": " << l.resources << ",\n";
+        out << "      \"failed\": " << (l.failed ? "true" : "false") << "\n";
+        out << "    }";
+    }
+    out << (mGroupLoadingResults.empty() ? "],\n" : "\n  ],\n");
+
+    out << "  \"kernelUnits\": \"million elements per second\",\n";
+    out << "  \"kernels\": [";
+    for (size_t i = 0; i < mKernelResults.size(); ++i)
+    {
+        const OptimisedUtilKernels::ThroughputMap& t = mKernelResults[i].second;
+
+        out << (i ? ",\n" : "\n") << "    {\n";
+        out << "      \"implementation\": " << jsonString(mKernelResults[i].first) << ",\n";
+        out << "      \"throughput\": {";
+        for (OptimisedUtilKernels::ThroughputMap::const_iterator k = t.begin(); k != t.end(); ++k)
+            out << (k != t.begin() ? ",\n" : "\n") << "        " << jsonString(k->first) << ": " << k->second;
+        out << "\n      }\n";
+        out << "    }";
+    }
+    out << (mKernelResults.empty() ? "],\n" : "\n  ],\n");
+
+    out << "  \"sceneKernels\": {";
+    for (SceneKernels::ThroughputMap::const_iterator k = mSceneKernelResults.begin();
+        k != mSceneKernelResults.end(); ++k)
+    {
+        out << (k != mSceneKernelResults.begin() ? ",\n" : "\n") << "    " << jsonString(k->first) << ": " << k->second;
+    }
+    out << (mSceneKernelResults.empty() ? "}\n}\n" : "\n  }\n}\n");
+
+    LogManager::getSingleton().logMessage("Benchmark: results written to " + filename);
+}
+//-----------------------------------------------------------------------
+
+#ifdef INCLUDE_RTSHADER_SYSTEM
+
+/*-----------------------------------------------------------------------------
+  | Initialize the RT Shader system.
+  -----------------------------------------------------------------------------*/
+bool BenchmarkContext::initialiseRTShaderSystem()
+{
+    if (Ogre::RTShader::ShaderGenerator::initialize())
+    {
+        mShaderGenerator = Ogre::RTShader::ShaderGenerator::getSingletonPtr();
+
+        // Setup core libraries and shader cache path.
+        Ogre::StringVector groupVector = Ogre::ResourceGroupManager::getSingleton().getResourceGroups();
+        Ogre::StringVector::iterator itGroup = groupVector.begin();
+        Ogre::StringVector::iterator itGroupEnd = groupVector.end();
+        Ogre::String shaderCoreLibsPath;
+
+        for (; itGroup != itGroupEnd && shaderCoreLibsPath.empty(); ++itGroup)
+        {
+            Ogre::ResourceGroupManager::LocationList resLocationsList = Ogre::ResourceGroupManager::getSingleton().getResourceLocationList(*itGroup);
+            Ogre::ResourceGroupManager::LocationList::iterator it = resLocationsList.begin();
+            Ogre::ResourceGroupManager::LocationList::iterator itEnd = resLocationsList.end();
+
+            // Try to find the location of the core shader lib functions
+            for (; it != itEnd; ++it)
+            {
+                if ((*it)->archive->getName().find("RTShaderLib") != Ogre::String::npos)
+                {
+                    shaderCoreLibsPath = (*it)->archive->getName() + "/cache/";
+                    break;
+                }
+            }
+        }
+
+        // Core shader libs not found -> shader generating will fail.
+        if (shaderCoreLibsPath.empty())
+            return false;
+
+        // Create and register the material manager listener if it doesn't exist yet.
+        if (mMaterialMgrListener == NULL) {
+            mMaterialMgrListener = new OgreBites::ShaderGeneratorTechniqueResolverListener(mShaderGenerator);
+            Ogre::MaterialManager::getSingleton().addListener(mMaterialMgrListener);
+        }
+    }
+
+    return true;
+}
+
+/*-----------------------------------------------------------------------------
+  | Destroy the RT Shader system.
+  -----------------------------------------------------------------------------*/
+void BenchmarkContext::finaliseRTShaderSystem()
+{
+    // Restore default scheme.
+    Ogre::MaterialManager::getSingleton().setActiveScheme(Ogre::MaterialManager::DEFAULT_SCHEME_NAME);
+
+    // Unregister the material manager listener.
+    if (mMaterialMgrListener != NULL)
+    {
+        Ogre::MaterialManager::getSingleton().removeListener(mMaterialMgrListener);
+        delete mMaterialMgrListener;
+        mMaterialMgrListener = NULL;
+    }
+
+    // Destroy RTShader system.
+    if (mShaderGenerator != NULL)
+    {
+        Ogre::RTShader::ShaderGenerator::destroy();
+        mShaderGenerator = NULL;
+    }
+}
+#endif // INCLUDE_RTSHADER_SYSTEM
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        BenchmarkContext bc(argc, argv);
+        bc.go();
+    }
+    catch (Ogre::Exception& e)
+    {
+        std::cerr << "An exception has occurred: " << e.getFullDescription().c_str() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
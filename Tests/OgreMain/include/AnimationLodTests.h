@@ -0,0 +1,77 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __AnimationLodTests_H__
+#define __AnimationLodTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OgreBuildSettings.h"
+#include "OgrePrerequisites.h"
+#include "OgreSceneManager.h"
+#include "NullRenderSystemTestUtils.h"
+
+class AnimationLodTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(AnimationLodTests);
+    CPPUNIT_TEST(testFullDetail);
+    CPPUNIT_TEST(testUpdateInterval);
+    CPPUNIT_TEST(testOffscreenNeverUpdated);
+    CPPUNIT_TEST(testOffscreenInterval);
+    CPPUNIT_TEST(testBoneMask);
+    CPPUNIT_TEST(testConcurrentUpdateLod);
+    CPPUNIT_TEST(testInvalidInterval);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    NullRenderSystemFixture mFixture;
+    Ogre::Root* mRoot;
+    Ogre::SceneManager* mSceneMgr;
+    Ogre::Camera* mCamera;
+    Ogre::Entity* mEntity;
+    Ogre::AnimationState* mAnimState;
+
+    /** Runs the given number of frames with the entity queued for the camera
+        or only animated, and returns the skeleton updates counted over them */
+    Ogre::SceneManager::SkeletonUpdateStats runFrames(size_t count, bool onScreen);
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testFullDetail();
+    void testUpdateInterval();
+    void testOffscreenNeverUpdated();
+    void testOffscreenInterval();
+    void testBoneMask();
+    void testConcurrentUpdateLod();
+    void testInvalidInterval();
+};
+
+#endif
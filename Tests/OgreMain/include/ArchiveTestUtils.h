@@ -0,0 +1,48 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ArchiveTestUtils_H__
+#define __ArchiveTestUtils_H__
+
+#include "OgrePrerequisites.h"
+
+/** Opens files of an archive from several threads at once and compares
+    their contents with the expected ones.
+@remarks
+    Each thread opens the files in turn, starting from a different one,
+    so that every file is read by several threads at the same time.
+@param archive
+    The archive to read, already loaded.
+@param filenames, expected
+    Names of the files and their contents, fileCount of each.
+@return
+    The number of reads, across all threads, which failed or did not match.
+*/
+size_t readArchiveConcurrently(Ogre::Archive* archive, const Ogre::String* filenames,
+    const Ogre::String* expected, size_t fileCount, size_t threadCount, size_t readsPerThread);
+
+#endif
@@ -0,0 +1,74 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __CompressedNodeTracksTests_H__
+#define __CompressedNodeTracksTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OgrePrerequisites.h"
+#include "OgreCompressedNodeTracks.h"
+#include "OgreSkeleton.h"
+
+class CompressedNodeTracksTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(CompressedNodeTracksTests);
+    CPPUNIT_TEST(testKeysWithinTolerance);
+    CPPUNIT_TEST(testRedundantKeysDropped);
+    CPPUNIT_TEST(testSampleBetweenKeys);
+    CPPUNIT_TEST(testCursorMatchesSearch);
+    CPPUNIT_TEST(testSerializerRoundTrip);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    Ogre::SkeletonPtr mSkeleton;
+    /// Uncompressed animation, owned by mSkeleton
+    Ogre::Animation* mAnimation;
+    /// Compressed clone of mAnimation
+    Ogre::Animation* mCompressed;
+    Ogre::CompressedNodeTracks::Tolerance mTolerance;
+
+    /// Creates an empty manual skeleton
+    Ogre::SkeletonPtr createSkeleton(const Ogre::String& name);
+    /// Checks samples against the uncompressed animation at the given time
+    bool samplesMatch(const Ogre::CompressedNodeTracks* compressed, Ogre::Real time,
+        const Ogre::CompressedNodeTracks::SampledTransform* samples, Ogre::Real slack);
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testKeysWithinTolerance();
+    void testRedundantKeysDropped();
+    void testSampleBetweenKeys();
+    void testCursorMatchesSearch();
+    void testSerializerRoundTrip();
+};
+
+#endif
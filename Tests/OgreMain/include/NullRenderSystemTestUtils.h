@@ -0,0 +1,86 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __NullRenderSystemTestUtils_H__
+#define __NullRenderSystemTestUtils_H__
+
+#include "OgreBuildSettings.h"
+#include "OgrePrerequisites.h"
+#include "OgreCommon.h"
+#include "OgreHardwareBufferManager.h"
+#ifdef OGRE_STATIC_LIB
+#include "../../../Samples/Common/include/OgreStaticPluginLoader.h"
+#endif
+
+/** Creates and destroys the Root of tests which need a render system, but
+    don't render anything, using the Null render system.
+@remarks
+    Suites using it are only registered when the Null render system is
+    built, see OGRE_BUILD_RENDERSYSTEM_NULL.
+*/
+class NullRenderSystemFixture
+{
+public:
+    NullRenderSystemFixture();
+    ~NullRenderSystemFixture();
+
+    /** Creates the Root and makes the Null render system its render system.
+    @param windowName
+        If empty, the render system is left uninitialised and, unless there
+        already is one, a default hardware buffer manager is created, which is
+        all cameras and frustums need. Otherwise the render system is initialised with a hidden window
+        of that name, which compiling materials and the scene manager
+        factories of plugins need.
+    @param windowSize Width and height of the window.
+    */
+    Ogre::Root* setUp(const Ogre::String& windowName = Ogre::BLANKSTRING,
+        unsigned int windowSize = 64);
+
+    /** Sets a config option of the Null render system when setUp selects it,
+        such as "Occlusion Queries", which has to be before it is initialised */
+    void setConfigOption(const Ogre::String& name, const Ogre::String& value)
+    {
+        mConfigOptions[name] = value;
+    }
+
+    /// Destroys the Root, scene managers using the buffer manager must be destroyed first
+    void tearDown();
+
+    /// The window created by setUp, if any
+    Ogre::RenderWindow* getWindow() const { return mWindow; }
+
+protected:
+#ifdef OGRE_STATIC_LIB
+    Ogre::StaticPluginLoader mStaticPluginLoader;
+#endif
+    Ogre::Root* mRoot;
+    Ogre::HardwareBufferManager* mBufMgr;
+    Ogre::RenderWindow* mWindow;
+    Ogre::NameValuePairList mConfigOptions;
+};
+
+#endif
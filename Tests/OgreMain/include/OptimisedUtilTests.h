@@ -0,0 +1,86 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __OptimisedUtilTests_H__
+#define __OptimisedUtilTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OgrePrerequisites.h"
+#include "OgreOptimisedUtil.h"
+
+/** Checks the SIMD implementations of OptimisedUtil against the general one.
+@remarks
+    Only the implementations the CPU running the tests supports are checked,
+    and they are only expected to match within a tolerance since fused
+    multiply-add and the order of the sums change the rounding.
+*/
+class OptimisedUtilTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(OptimisedUtilTests);
+    CPPUNIT_TEST(testSoftwareVertexSkinning);
+    CPPUNIT_TEST(testSoftwareVertexMorph);
+    CPPUNIT_TEST(testConcatenateAffineMatrices);
+    CPPUNIT_TEST(testCalculateFaceNormals);
+    CPPUNIT_TEST(testCalculateLightFacing);
+    CPPUNIT_TEST(testExtrudeVertices);
+    CPPUNIT_TEST(testInterpolateNodeTransforms);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    typedef Ogre::vector<Ogre::OptimisedUtil*>::type OptimisedUtilList;
+
+    Ogre::OptimisedUtil* mGeneral;
+    /// The SIMD implementations available on this CPU
+    OptimisedUtilList mCandidates;
+    Ogre::uint32 mSeed;
+    /// Buffers to free on tearDown
+    Ogre::vector<void*>::type mBuffers;
+
+    /// Allocates a SIMD aligned buffer, freed on tearDown
+    float* allocate(size_t numFloats);
+    /// Deterministic random number in the given range
+    Ogre::Real random(Ogre::Real low, Ogre::Real high);
+    /// Whether every float is within tolerance of the expected one, scaled by its magnitude
+    bool allClose(const float* expected, const float* actual, size_t count, Ogre::Real tolerance);
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testSoftwareVertexSkinning();
+    void testSoftwareVertexMorph();
+    void testConcatenateAffineMatrices();
+    void testCalculateFaceNormals();
+    void testCalculateLightFacing();
+    void testExtrudeVertices();
+    void testInterpolateNodeTransforms();
+};
+
+#endif
@@ -0,0 +1,73 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SkeletonAnimationCacheTests_H__
+#define __SkeletonAnimationCacheTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OgrePrerequisites.h"
+#include "OgreSkeletonAnimationCache.h"
+#include "OgreSkeletonInstance.h"
+
+class SkeletonAnimationCacheTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(SkeletonAnimationCacheTests);
+    CPPUNIT_TEST(testHitMatchesEvaluation);
+    CPPUNIT_TEST(testDifferentPosesMiss);
+    CPPUNIT_TEST(testTimeQuantum);
+    CPPUNIT_TEST(testBlendMaskNotCached);
+    CPPUNIT_TEST(testClear);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    Ogre::SkeletonPtr mSkeleton;
+    Ogre::SkeletonInstance* mInstances[2];
+    Ogre::AnimationStateSet* mStates[2];
+    Ogre::SkeletonAnimationCache* mCache;
+
+    /// Enables only the given animation of a state set, at the given time
+    void play(Ogre::AnimationStateSet* states, const Ogre::String& name, Ogre::Real time,
+        Ogre::Real weight = 1.0f);
+    /// Checks the matrices against those of the instance posed directly
+    bool matchesEvaluation(Ogre::SkeletonInstance* instance, Ogre::AnimationStateSet* states,
+        const Ogre::Matrix4* matrices);
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testHitMatchesEvaluation();
+    void testDifferentPosesMiss();
+    void testTimeQuantum();
+    void testBlendMaskNotCached();
+    void testClear();
+};
+
+#endif
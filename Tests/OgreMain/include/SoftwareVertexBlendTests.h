@@ -0,0 +1,65 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SoftwareVertexBlendTests_H__
+#define __SoftwareVertexBlendTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OgrePrerequisites.h"
+#include "OgreMatrix4.h"
+#include "OgreHardwareBufferManager.h"
+
+class SoftwareVertexBlendTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(SoftwareVertexBlendTests);
+    CPPUNIT_TEST(testSplitBlendMatchesBlend);
+    CPPUNIT_TEST(testSharedSourceLockedOnce);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    Ogre::HardwareBufferManager* mBufMgr;
+    Ogre::VertexData* mSource;
+    Ogre::Matrix4 mMatrices[2];
+    const Ogre::Matrix4* mBlendMatrices[2];
+
+    /// Creates a target for mSource with interleaved positions and normals
+    Ogre::VertexData* createTarget();
+    /// Whether the positions and normals of two targets are the same
+    bool targetsMatch(Ogre::VertexData* a, Ogre::VertexData* b);
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testSplitBlendMatchesBlend();
+    void testSharedSourceLockedOnce();
+};
+
+#endif
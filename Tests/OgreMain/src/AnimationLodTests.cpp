@@ -0,0 +1,300 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "AnimationLodTests.h"
+#include "OgreRoot.h"
+#include "OgreRenderWindow.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreSkeletonManager.h"
+#include "OgreSkeleton.h"
+#include "OgreMeshManager.h"
+#include "OgreMesh.h"
+#include "OgreSubMesh.h"
+#include "OgreEntity.h"
+#include "OgreSubEntity.h"
+#include "OgreCamera.h"
+#include "OgreSceneNode.h"
+#include "OgreAnimation.h"
+#include "OgreKeyFrame.h"
+#include "OgreBone.h"
+#include "OgreException.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+#ifdef OGRE_BUILD_RENDERSYSTEM_NULL
+CPPUNIT_TEST_SUITE_REGISTRATION(AnimationLodTests);
+#endif
+
+//--------------------------------------------------------------------------
+void AnimationLodTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    // entities compile their materials against the render system capabilities,
+    // which are only known once it is initialised with a window
+    mRoot = mFixture.setUp("AnimationLodTests");
+
+    mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+    mCamera = mSceneMgr->createCamera("AnimationLodTests");
+    mCamera->setPosition(Vector3::ZERO);
+    mCamera->lookAt(Vector3::NEGATIVE_UNIT_Z);
+
+    // Two independent bones, both moving along x
+    SkeletonPtr skeleton = SkeletonManager::getSingleton().create("AnimationLodTests",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+    skeleton->load();
+    skeleton->createBone("left", 0);
+    skeleton->createBone("right", 1)->setPosition(Vector3(1, 0, 0));
+    skeleton->setBindingPose();
+    Animation* anim = skeleton->createAnimation("Walk", 10);
+    for (unsigned short b = 0; b < 2; ++b)
+    {
+        NodeAnimationTrack* track = anim->createNodeTrack(b, skeleton->getBone(b));
+        track->createNodeKeyFrame(0)->setTranslate(Vector3::ZERO);
+        track->createNodeKeyFrame(10)->setTranslate(Vector3(100, 0, 0));
+    }
+
+    // One triangle per bone
+    MeshPtr mesh = MeshManager::getSingleton().createManual("AnimationLodTests",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    SubMesh* sub = mesh->createSubMesh();
+    sub->useSharedVertices = false;
+    sub->vertexData = OGRE_NEW VertexData();
+    sub->vertexData->vertexCount = 6;
+    sub->vertexData->vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+    HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+        sizeof(float) * 3, 6, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+    float* pPos = static_cast<float*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+    for (size_t v = 0; v < 6; ++v)
+    {
+        *pPos++ = Real(v % 3 == 1) + Real(v / 3);
+        *pPos++ = Real(v % 3 == 2);
+        *pPos++ = 0;
+    }
+    vbuf->unlock();
+    sub->vertexData->vertexBufferBinding->setBinding(0, vbuf);
+
+    HardwareIndexBufferSharedPtr ibuf = HardwareBufferManager::getSingleton().createIndexBuffer(
+        HardwareIndexBuffer::IT_16BIT, 6, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+    uint16* pIdx = static_cast<uint16*>(ibuf->lock(HardwareBuffer::HBL_DISCARD));
+    for (uint16 i = 0; i < 6; ++i)
+        pIdx[i] = i;
+    ibuf->unlock();
+    sub->indexData->indexBuffer = ibuf;
+    sub->indexData->indexCount = 6;
+
+    for (unsigned int v = 0; v < 6; ++v)
+    {
+        VertexBoneAssignment vba;
+        vba.vertexIndex = v;
+        vba.boneIndex = static_cast<unsigned short>(v / 3);
+        vba.weight = 1;
+        sub->addBoneAssignment(vba);
+    }
+    mesh->_setBounds(AxisAlignedBox(-1, -1, -1, 2, 1, 1));
+    mesh->_setBoundingSphereRadius(2);
+    mesh->setSkeletonName("AnimationLodTests");
+    mesh->load();
+
+    mEntity = mSceneMgr->createEntity("AnimationLodTests", "AnimationLodTests");
+    // Keep the entity out of the queue, it has nothing to render with
+    mEntity->getSubEntity(0)->setVisible(false);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, -100))->attachObject(mEntity);
+    mSceneMgr->getRootSceneNode()->_update(true, false);
+
+    mAnimState = mEntity->getAnimationState("Walk");
+    mAnimState->setEnabled(true);
+}
+//--------------------------------------------------------------------------
+void AnimationLodTests::tearDown()
+{
+    mSceneMgr->clearScene();
+    mRoot->destroySceneManager(mSceneMgr);
+    MeshManager::getSingleton().removeAll();
+    SkeletonManager::getSingleton().removeAll();
+    mFixture.tearDown();
+}
+//--------------------------------------------------------------------------
+SceneManager::SkeletonUpdateStats AnimationLodTests::runFrames(size_t count, bool onScreen)
+{
+    SceneManager::SkeletonUpdateStats before = mSceneMgr->getSkeletonUpdateStats();
+    for (size_t i = 0; i < count; ++i)
+    {
+        mRoot->_fireFrameRenderingQueued();
+        mAnimState->addTime(0.1f);
+        if (onScreen)
+        {
+            mEntity->_notifyCurrentCamera(mCamera);
+            mEntity->_updateRenderQueue(mSceneMgr->getRenderQueue());
+        }
+        else
+        {
+            // e.g. only attached for its bone positions or as a shadow caster
+            mEntity->_updateAnimation();
+        }
+    }
+    SceneManager::SkeletonUpdateStats after = mSceneMgr->getSkeletonUpdateStats();
+    after.evaluatedSkeletons -= before.evaluatedSkeletons;
+    after.interpolatedSkeletons -= before.interpolatedSkeletons;
+    after.skippedSkeletons -= before.skippedSkeletons;
+    return after;
+}
+//--------------------------------------------------------------------------
+void AnimationLodTests::testFullDetail()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Closer than the first level, so every frame is evaluated
+    Entity::AnimationLodLevelList levels;
+    levels.push_back(Entity::AnimationLodLevel(1000, 4));
+    mEntity->setAnimationLodLevels(levels);
+
+    SceneManager::SkeletonUpdateStats stats = runFrames(10, true);
+    CPPUNIT_ASSERT_EQUAL((ushort)0, mEntity->getCurrentAnimationLodIndex());
+    CPPUNIT_ASSERT_EQUAL((size_t)10, stats.evaluatedSkeletons);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.interpolatedSkeletons);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.skippedSkeletons);
+}
+//--------------------------------------------------------------------------
+void AnimationLodTests::testUpdateInterval()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Entity::AnimationLodLevelList levels;
+    levels.push_back(Entity::AnimationLodLevel(50, 3));
+    mEntity->setAnimationLodLevels(levels);
+
+    // Frames 0 to 9: the first evaluation has nothing to blend from, so the
+    // frames up to the next one keep its pose, and the later ones blend
+    // from one evaluation to the next: E S S E I I E I I E
+    SceneManager::SkeletonUpdateStats stats = runFrames(10, true);
+    CPPUNIT_ASSERT_EQUAL((ushort)1, mEntity->getCurrentAnimationLodIndex());
+    CPPUNIT_ASSERT_EQUAL((size_t)4, stats.evaluatedSkeletons);
+    CPPUNIT_ASSERT_EQUAL((size_t)4, stats.interpolatedSkeletons);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, stats.skippedSkeletons);
+
+    // Interpolated frames are in between the evaluations around them
+    runFrames(1, true);
+    Real first = mEntity->_getBoneMatrices()[0].getTrans().x;
+    runFrames(1, true);
+    Real second = mEntity->_getBoneMatrices()[0].getTrans().x;
+    CPPUNIT_ASSERT(second > first);
+}
+//--------------------------------------------------------------------------
+void AnimationLodTests::testOffscreenNeverUpdated()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    mEntity->setOffscreenAnimationInterval(0);
+    SceneManager::SkeletonUpdateStats stats = runFrames(1, true);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, stats.evaluatedSkeletons);
+
+    // Still on screen in the frame after it was queued, then no longer evaluated
+    stats = runFrames(5, false);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, stats.evaluatedSkeletons);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.interpolatedSkeletons);
+    CPPUNIT_ASSERT_EQUAL((size_t)4, stats.skippedSkeletons);
+    Matrix4 offscreen = mEntity->_getBoneMatrices()[0];
+
+    // Coming back on screen evaluates it straight away
+    stats = runFrames(1, true);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, stats.evaluatedSkeletons);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.skippedSkeletons);
+    CPPUNIT_ASSERT(mEntity->_getBoneMatrices()[0] != offscreen);
+}
+//--------------------------------------------------------------------------
+void AnimationLodTests::testOffscreenInterval()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    mEntity->setOffscreenAnimationInterval(2);
+    runFrames(1, true);
+
+    // The grace frame, then every other frame: E S E S E S
+    SceneManager::SkeletonUpdateStats stats = runFrames(6, false);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, stats.evaluatedSkeletons);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.interpolatedSkeletons);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, stats.skippedSkeletons);
+}
+//--------------------------------------------------------------------------
+void AnimationLodTests::testBoneMask()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Entity::AnimationLodLevelList levels;
+    levels.push_back(Entity::AnimationLodLevel(50, 1));
+    levels.back().boneMask.push_back(1);
+    levels.back().boneMask.push_back(0);
+    mEntity->setAnimationLodLevels(levels);
+
+    SceneManager::SkeletonUpdateStats stats = runFrames(3, true);
+    CPPUNIT_ASSERT_EQUAL((ushort)1, mEntity->getCurrentAnimationLodIndex());
+    CPPUNIT_ASSERT_EQUAL((size_t)3, stats.evaluatedSkeletons);
+
+    // The masked bone stays in its binding pose
+    const Matrix4* matrices = mEntity->_getBoneMatrices();
+    CPPUNIT_ASSERT(matrices[0].getTrans().x > 1);
+    CPPUNIT_ASSERT(matrices[1].getTrans().length() < 1e-4f);
+
+    // Closer than the level, both bones move again
+    levels.back().userValue = 1000;
+    mEntity->setAnimationLodLevels(levels);
+    runFrames(1, true);
+    CPPUNIT_ASSERT_EQUAL((ushort)0, mEntity->getCurrentAnimationLodIndex());
+    CPPUNIT_ASSERT(matrices[1].getTrans().x > 1);
+}
+//--------------------------------------------------------------------------
+void AnimationLodTests::testConcurrentUpdateLod()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Entity::AnimationLodLevelList levels;
+    levels.push_back(Entity::AnimationLodLevel(50, 3));
+    mEntity->setAnimationLodLevels(levels);
+
+    // The level applies before the entity is queued for the camera
+    Mesh::VertexBlendLockMap locks;
+    mRoot->_fireFrameRenderingQueued();
+    mAnimState->addTime(0.1f);
+    if (mEntity->_prepareConcurrentAnimationUpdate(mCamera, locks))
+        mEntity->_updateAnimationConcurrently();
+    Mesh::_unlockForSoftwareVertexBlend(locks);
+    CPPUNIT_ASSERT_EQUAL((ushort)1, mEntity->getCurrentAnimationLodIndex());
+}
+//--------------------------------------------------------------------------
+void AnimationLodTests::testInvalidInterval()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Entity::AnimationLodLevelList levels;
+    levels.push_back(Entity::AnimationLodLevel(50, 0));
+    CPPUNIT_ASSERT_THROW(mEntity->setAnimationLodLevels(levels), InvalidParametersException);
+    CPPUNIT_ASSERT(mEntity->getAnimationLodLevels().empty());
+}
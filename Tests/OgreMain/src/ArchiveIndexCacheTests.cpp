@@ -0,0 +1,315 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ArchiveIndexCacheTests.h"
+#include "OgreFileSystem.h"
+#if OGRE_NO_PACK_ARCHIVE == 0
+#include "OgrePackArchive.h"
+#endif
+#include "OgreStringConverter.h"
+#include "OgreRoot.h"
+#include "OgreScriptLoader.h"
+#include "OgreZip.h"
+
+#include "UnitTestSuite.h"
+
+#include <cstdio>
+#include <ctime>
+#if OGRE_PLATFORM != OGRE_PLATFORM_WIN32
+#include <utime.h>
+#endif
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+#include "macUtils.h"
+#endif
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION( ArchiveIndexCacheTests );
+
+namespace
+{
+    DataStreamPtr makeStream(const String& contents)
+    {
+        MemoryDataStream* stream = OGRE_NEW MemoryDataStream(contents.size());
+        if (!contents.empty())
+            memcpy(stream->getPtr(), contents.data(), contents.size());
+        return DataStreamPtr(stream);
+    }
+
+    /// The file names of a list, in order, and whether they all point at an archive
+    StringVector fileNames(const FileInfoListPtr& files, Archive* arch)
+    {
+        StringVector names;
+        for (FileInfoList::const_iterator i = files->begin(); i != files->end(); ++i)
+            names.push_back(i->archive == arch ? i->filename : "<wrong archive> " + i->filename);
+        return names;
+    }
+
+    /// Records the scripts it is given to parse
+    class RecordingScriptLoader : public ScriptLoader
+    {
+    public:
+        StringVector patterns;
+        StringVector parsed;
+
+        RecordingScriptLoader() { patterns.push_back("*.material"); }
+        const StringVector& getScriptPatterns(void) const { return patterns; }
+        void parseScript(DataStreamPtr& stream, const String& groupName)
+        {
+            parsed.push_back(stream->getName());
+        }
+        Real getLoadingOrder(void) const { return 1000; }
+    };
+}
+
+//--------------------------------------------------------------------------
+void ArchiveIndexCacheTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+    mTestPath = macBundlePath() + "/Contents/Resources/Media/misc/ArchiveTest";
+#elif OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+    mTestPath = "../../Tests/OgreMain/misc/ArchiveTest";
+#else
+    mTestPath = "./Tests/OgreMain/misc/ArchiveTest";
+#endif
+    mZipPath = mTestPath + ".zip";
+    mPackPath = "ArchiveIndexCacheTest.pack";
+}
+//--------------------------------------------------------------------------
+void ArchiveIndexCacheTests::tearDown()
+{
+    std::remove(mPackPath.c_str());
+}
+//--------------------------------------------------------------------------
+void ArchiveIndexCacheTests::writePack(size_t files)
+{
+#if OGRE_NO_PACK_ARCHIVE == 0
+    {
+        PackArchiveWriter writer(mPackPath);
+        for (size_t i = 0; i < files; ++i)
+            writer.addFile("Models/file" + StringConverter::toString(i) + ".mesh", makeStream("mesh"));
+        writer.finish();
+    }
+
+#if OGRE_PLATFORM != OGRE_PLATFORM_WIN32
+    // otherwise the pack is too recent to be cached
+    static time_t modified = time(0) - 10;
+    utimbuf times = { modified, modified };
+    utime(mPackPath.c_str(), &times);
+#endif
+#endif
+}
+//--------------------------------------------------------------------------
+void ArchiveIndexCacheTests::testFindAllMatchesArchive()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    FileSystemArchive arch(mTestPath, "FileSystem", true);
+    arch.load();
+    ArchiveIndexCache cache;
+
+    StringVector expected = fileNames(arch.findFileInfo("*", true, false), &arch);
+    CPPUNIT_ASSERT_EQUAL((size_t)6, expected.size());
+
+    // listed, then from the cache
+    CPPUNIT_ASSERT(fileNames(cache.findFileInfo(&arch, "*", true), &arch) == expected);
+    CPPUNIT_ASSERT(cache.isDirty());
+    CPPUNIT_ASSERT(fileNames(cache.findFileInfo(&arch, "*", true), &arch) == expected);
+
+    CPPUNIT_ASSERT(fileNames(cache.findFileInfo(&arch, "*", false), &arch) ==
+        fileNames(arch.findFileInfo("*", false, false), &arch));
+}
+//--------------------------------------------------------------------------
+void ArchiveIndexCacheTests::testFindMatchesArchive()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    FileSystemArchive arch(mTestPath, "FileSystem", true);
+    arch.load();
+    ArchiveIndexCache cache;
+
+    const char* patterns[] = { "*", "*.material", "*.txt", "file?.material",
+        "level1/materials/scripts/*.material", "*.program" };
+    for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); ++i)
+    {
+        CPPUNIT_ASSERT(fileNames(cache.findFileInfo(&arch, patterns[i], true), &arch) ==
+            fileNames(arch.findFileInfo(patterns[i], true, false), &arch));
+        CPPUNIT_ASSERT(fileNames(cache.findFileInfo(&arch, patterns[i], false), &arch) ==
+            fileNames(arch.findFileInfo(patterns[i], false, false), &arch));
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)4, cache.findFileInfo(&arch, "*.material", true)->size());
+}
+//--------------------------------------------------------------------------
+void ArchiveIndexCacheTests::testSaveLoad()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    FileSystemArchive arch(mTestPath, "FileSystem", true);
+    arch.load();
+    ArchiveIndexCache cache;
+    StringVector expected = fileNames(cache.findFileInfo(&arch, "*", true), &arch);
+
+    DataStreamPtr stream(OGRE_NEW MemoryDataStream(65536));
+    cache.save(stream);
+    CPPUNIT_ASSERT(!cache.isDirty());
+
+    stream->seek(0);
+    ArchiveIndexCache loaded;
+    loaded.load(stream);
+    CPPUNIT_ASSERT(fileNames(loaded.findFileInfo(&arch, "*", true), &arch) == expected);
+    // the folders haven't changed, so nothing was listed again
+    CPPUNIT_ASSERT(!loaded.isDirty());
+}
+//--------------------------------------------------------------------------
+void ArchiveIndexCacheTests::testInvalidStream()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    FileSystemArchive arch(mTestPath, "FileSystem", true);
+    arch.load();
+    ArchiveIndexCache cache;
+    StringVector expected = fileNames(cache.findFileInfo(&arch, "*", true), &arch);
+
+    MemoryDataStream* saved = OGRE_NEW MemoryDataStream(65536);
+    DataStreamPtr stream(saved);
+    cache.save(stream);
+    size_t size = stream->tell();
+
+    // cut short, and not a cache at all
+    ArchiveIndexCache truncated;
+    truncated.load(makeStream(String(reinterpret_cast<char*>(saved->getPtr()), size - 5)));
+    CPPUNIT_ASSERT(fileNames(truncated.findFileInfo(&arch, "*", true), &arch) == expected);
+    CPPUNIT_ASSERT(truncated.isDirty());
+
+    ArchiveIndexCache garbage;
+    garbage.load(makeStream("OGREINDX this is not an index cache"));
+    CPPUNIT_ASSERT(fileNames(garbage.findFileInfo(&arch, "*", true), &arch) == expected);
+    CPPUNIT_ASSERT(garbage.isDirty());
+}
+//--------------------------------------------------------------------------
+void ArchiveIndexCacheTests::testChangedPack()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+#if OGRE_NO_PACK_ARCHIVE == 0
+    ArchiveIndexCache cache;
+    writePack(2);
+    {
+        PackArchive arch(mPackPath, "Pack");
+        arch.load();
+        CPPUNIT_ASSERT_EQUAL((size_t)2, cache.findFileInfo(&arch, "*", true)->size());
+        CPPUNIT_ASSERT_EQUAL((size_t)2, cache.findFileInfo(&arch, "*", true)->size());
+    }
+
+    // same modification time, different size
+    writePack(3);
+    {
+        PackArchive arch(mPackPath, "Pack");
+        arch.load();
+        CPPUNIT_ASSERT(fileNames(cache.findFileInfo(&arch, "*", true), &arch) ==
+            fileNames(arch.findFileInfo("*", true, false), &arch));
+        CPPUNIT_ASSERT_EQUAL((size_t)3, cache.findFileInfo(&arch, "*.mesh", true)->size());
+    }
+#endif
+}
+//--------------------------------------------------------------------------
+void ArchiveIndexCacheTests::testZipMatchesArchive()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+#if OGRE_NO_ZIP_ARCHIVE == 0
+    ZipArchive arch(mZipPath, "Zip");
+    arch.load();
+    ArchiveIndexCache cache;
+
+    // a zip names its files without their folder, and finds all of them with
+    // a wildcard even when not recursive
+    const char* patterns[] = { "*", "*.material", "file.material", "rootfile.txt" };
+    for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); ++i)
+    {
+        CPPUNIT_ASSERT(fileNames(cache.findFileInfo(&arch, patterns[i], true), &arch) ==
+            fileNames(arch.findFileInfo(patterns[i], true, false), &arch));
+        CPPUNIT_ASSERT(fileNames(cache.findFileInfo(&arch, patterns[i], false), &arch) ==
+            fileNames(arch.findFileInfo(patterns[i], false, false), &arch));
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)4, cache.findFileInfo(&arch, "*.material", false)->size());
+
+    // and still does once saved and loaded back
+    DataStreamPtr stream(OGRE_NEW MemoryDataStream(65536));
+    cache.save(stream);
+    stream->seek(0);
+    ArchiveIndexCache loaded;
+    loaded.load(stream);
+    CPPUNIT_ASSERT(fileNames(loaded.findFileInfo(&arch, "*", false), &arch) ==
+        fileNames(arch.findFileInfo("*", false, false), &arch));
+#endif
+}
+//--------------------------------------------------------------------------
+void ArchiveIndexCacheTests::testZipLocationNotRecursive()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+#if OGRE_NO_ZIP_ARCHIVE == 0
+    Root* root = OGRE_NEW Root(BLANKSTRING);
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    RecordingScriptLoader loader;
+    rgm._registerScriptLoader(&loader);
+
+    // the same scripts are parsed without the cache, with it, and with it
+    // saved and loaded back
+    const char* groups[] = { "Listed", "Cached", "Loaded" };
+    vector<StringVector>::type parsed;
+    DataStreamPtr stream(OGRE_NEW MemoryDataStream(65536));
+    for (size_t g = 0; g < 3; ++g)
+    {
+        if (g == 1)
+        {
+            rgm.setUseIndexCache(true);
+        }
+        else if (g == 2)
+        {
+            rgm.saveIndexCache(stream);
+            stream->seek(0);
+            rgm.loadIndexCache(stream);
+        }
+        rgm.addResourceLocation(mZipPath, "Zip", groups[g], false);
+        loader.parsed.clear();
+        rgm.initialiseResourceGroup(groups[g]);
+        parsed.push_back(loader.parsed);
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)4, parsed[0].size());
+    CPPUNIT_ASSERT(parsed[1] == parsed[0]);
+    CPPUNIT_ASSERT(parsed[2] == parsed[0]);
+
+    rgm._unregisterScriptLoader(&loader);
+    OGRE_DELETE root;
+#endif
+}
@@ -0,0 +1,81 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ArchiveTestUtils.h"
+#include "OgreArchive.h"
+#include "Threading/OgreThreads.h"
+
+using namespace Ogre;
+
+namespace
+{
+    /// What each thread of readArchiveConcurrently reads and compares
+    struct ConcurrentRead
+    {
+        Archive* archive;
+        const String* filenames;
+        const String* expected;
+        size_t fileCount;
+        size_t reads;
+        size_t mismatches;
+    };
+
+    unsigned long readConcurrently(ThreadHandle* threadHandle)
+    {
+        ConcurrentRead* read = static_cast<ConcurrentRead*>(threadHandle->getUserParam());
+        for (size_t i = 0; i < read->reads; ++i)
+        {
+            size_t file = (i + threadHandle->getThreadIdx()) % read->fileCount;
+            DataStreamPtr stream = read->archive->open(read->filenames[file]);
+            if (stream.isNull() || stream->getAsString() != read->expected[file])
+                ++read->mismatches;
+        }
+        return 0;
+    }
+    THREAD_DECLARE(readConcurrently);
+}
+
+//--------------------------------------------------------------------------
+size_t readArchiveConcurrently(Archive* archive, const String* filenames,
+    const String* expected, size_t fileCount, size_t threadCount, size_t readsPerThread)
+{
+    vector<ConcurrentRead>::type reads(threadCount);
+    ThreadHandleVec threads;
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        ConcurrentRead read = { archive, filenames, expected, fileCount, readsPerThread, 0 };
+        reads[i] = read;
+    }
+    for (size_t i = 0; i < threadCount; ++i)
+        threads.push_back(Threads::CreateThread(THREAD_GET(readConcurrently), i, &reads[i]));
+    Threads::WaitForThreads(threads);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < threadCount; ++i)
+        mismatches += reads[i].mismatches;
+    return mismatches;
+}
@@ -0,0 +1,281 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "CompressedNodeTracksTests.h"
+#include "OgreAnimation.h"
+#include "OgreKeyFrame.h"
+#include "OgreBone.h"
+#include "OgreSkeletonManager.h"
+#include "OgreSkeletonSerializer.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreDataStream.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(CompressedNodeTracksTests);
+
+static const size_t NUM_KEYS = 61;
+static const Real ANIMATION_LENGTH = 2.0f;
+
+//--------------------------------------------------------------------------
+void CompressedNodeTracksTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    OGRE_NEW ResourceGroupManager();
+    OGRE_NEW SkeletonManager();
+
+    mSkeleton = createSkeleton("CompressedNodeTracksTests");
+    Bone* root = mSkeleton->createBone("root", 0);
+    Bone* arm = root->createChild(1, Vector3(0, 1, 0));
+    Bone* hand = arm->createChild(2, Vector3(0, 1, 0));
+
+    mAnimation = mSkeleton->createAnimation("Wave", ANIMATION_LENGTH);
+    NodeAnimationTrack* rootTrack = mAnimation->createNodeTrack(0, root);
+    NodeAnimationTrack* armTrack = mAnimation->createNodeTrack(1, arm);
+    NodeAnimationTrack* handTrack = mAnimation->createNodeTrack(2, hand);
+    for (size_t k = 0; k < NUM_KEYS; ++k)
+    {
+        Real t = ANIMATION_LENGTH * k / (NUM_KEYS - 1);
+
+        // Root follows curves, every key matters
+        TransformKeyFrame* kf = rootTrack->createNodeKeyFrame(t);
+        kf->setTranslate(Vector3(Math::Sin(t * 3), Math::Cos(t * 2), t));
+        kf->setRotation(Quaternion(Radian(Math::Sin(t * 2)), Vector3::UNIT_Y));
+        kf->setScale(Vector3::UNIT_SCALE * (1 + 0.2f * Math::Sin(t * 4)));
+
+        // Arm moves at constant speed, only the ends are needed
+        kf = armTrack->createNodeKeyFrame(t);
+        kf->setTranslate(Vector3(t * 0.5f, 0, 0));
+
+        // Hand stays put
+        handTrack->createNodeKeyFrame(t);
+    }
+
+    mTolerance = CompressedNodeTracks::Tolerance(0.001f, Degree(0.5f), 0.001f);
+    mCompressed = mAnimation->clone("WaveCompressed");
+    mCompressed->compressNodeTracks(mTolerance.position, mTolerance.rotation, mTolerance.scale);
+}
+//--------------------------------------------------------------------------
+void CompressedNodeTracksTests::tearDown()
+{
+    OGRE_DELETE mCompressed;
+    mSkeleton.setNull();
+
+    OGRE_DELETE SkeletonManager::getSingletonPtr();
+    OGRE_DELETE ResourceGroupManager::getSingletonPtr();
+}
+//--------------------------------------------------------------------------
+SkeletonPtr CompressedNodeTracksTests::createSkeleton(const String& name)
+{
+    SkeletonPtr skel = SkeletonManager::getSingleton().create(name,
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+    skel->load();
+    return skel;
+}
+//--------------------------------------------------------------------------
+bool CompressedNodeTracksTests::samplesMatch(const CompressedNodeTracks* compressed, Real time,
+    const CompressedNodeTracks::SampledTransform* samples, Real slack)
+{
+    for (size_t i = 0; i < compressed->getNumTracks(); ++i)
+    {
+        const NodeAnimationTrack* track = mAnimation->getNodeTrack(compressed->getTrackHandle(i));
+        TransformKeyFrame kf(0, time);
+        track->getInterpolatedKeyFrame(mAnimation->_getTimeIndex(time), &kf);
+
+        // Allow for the precision of acos close to 1
+        Real cosHalfAngle = std::min(Math::Abs(kf.getRotation().Dot(samples[i].rotation)), Real(1.0f));
+        if (Math::ACos(cosHalfAngle).valueRadians() * 2 >
+            mTolerance.rotation.valueRadians() * slack + 5e-4f)
+            return false;
+        if (kf.getTranslate().distance(samples[i].translation) > mTolerance.position * slack + 1e-5f)
+            return false;
+        if (kf.getScale().distance(samples[i].scale) > mTolerance.scale * slack + 1e-5f)
+            return false;
+    }
+    return true;
+}
+//--------------------------------------------------------------------------
+void CompressedNodeTracksTests::testKeysWithinTolerance()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const CompressedNodeTracks* compressed = mCompressed->getCompressedNodeTracks();
+    CPPUNIT_ASSERT(compressed);
+    CPPUNIT_ASSERT_EQUAL((unsigned short)0, mCompressed->getNumNodeTracks());
+    CPPUNIT_ASSERT_EQUAL((size_t)3, compressed->getNumTracks());
+
+    vector<CompressedNodeTracks::SampledTransform>::type samples(compressed->getNumTracks());
+    for (size_t k = 0; k < NUM_KEYS; ++k)
+    {
+        Real t = ANIMATION_LENGTH * k / (NUM_KEYS - 1);
+        compressed->sample(t, 0, &samples[0]);
+        CPPUNIT_ASSERT(samplesMatch(compressed, t, &samples[0], 1.0f));
+    }
+}
+//--------------------------------------------------------------------------
+void CompressedNodeTracksTests::testRedundantKeysDropped()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const CompressedNodeTracks* compressed = mCompressed->getCompressedNodeTracks();
+
+    // The arm and hand tracks only need their first and last keys
+    CPPUNIT_ASSERT(compressed->getNumKeyFrames() <= NUM_KEYS + 4);
+    CPPUNIT_ASSERT(compressed->getNumKeyFrames() > 6);
+
+    // Way less than a TransformKeyFrame per key
+    CPPUNIT_ASSERT(compressed->getMemoryUsage() < NUM_KEYS * 3 * sizeof(TransformKeyFrame));
+}
+//--------------------------------------------------------------------------
+void CompressedNodeTracksTests::testSampleBetweenKeys()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const CompressedNodeTracks* compressed = mCompressed->getCompressedNodeTracks();
+    vector<CompressedNodeTracks::SampledTransform>::type samples(compressed->getNumTracks());
+    AnimationState::KeyCursor cursor;
+    for (Real t = 0; t <= ANIMATION_LENGTH; t += 0.0137f)
+    {
+        compressed->sample(t, &cursor, &samples[0]);
+        CPPUNIT_ASSERT(samplesMatch(compressed, t, &samples[0], 1.5f));
+    }
+}
+//--------------------------------------------------------------------------
+void CompressedNodeTracksTests::testCursorMatchesSearch()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const CompressedNodeTracks* compressed = mCompressed->getCompressedNodeTracks();
+    size_t numTracks = compressed->getNumTracks();
+    vector<CompressedNodeTracks::SampledTransform>::type withCursor(numTracks), searched(numTracks);
+    AnimationState::KeyCursor cursor;
+
+    // Forwards, backwards and past the end
+    const Real times[] = { 0, 0.1f, 0.5f, 0.51f, 1.9f, 2.0f, 0.3f, 0, 2.5f, 4.75f, 1.0f };
+    for (size_t i = 0; i < sizeof(times) / sizeof(times[0]); ++i)
+    {
+        compressed->sample(times[i], &cursor, &withCursor[0]);
+        compressed->sample(times[i], 0, &searched[0]);
+        CPPUNIT_ASSERT_EQUAL(numTracks, cursor.size());
+        for (size_t j = 0; j < numTracks; ++j)
+        {
+            CPPUNIT_ASSERT(withCursor[j].rotation == searched[j].rotation);
+            CPPUNIT_ASSERT(withCursor[j].translation == searched[j].translation);
+            CPPUNIT_ASSERT(withCursor[j].scale == searched[j].scale);
+        }
+    }
+
+    // Time wraps like for regular tracks
+    compressed->sample(2.5f, 0, &withCursor[0]);
+    compressed->sample(0.5f, 0, &searched[0]);
+    CPPUNIT_ASSERT(withCursor[0].translation == searched[0].translation);
+}
+//--------------------------------------------------------------------------
+static bool hasVersionHeader(MemoryDataStream* buffer, const String& version)
+{
+    // The header chunk id is followed by the version string
+    const char* header = reinterpret_cast<const char*>(buffer->getPtr()) + sizeof(uint16);
+    return buffer->tell() > sizeof(uint16) + version.size() &&
+        String(header, version.size()) == version;
+}
+//--------------------------------------------------------------------------
+void CompressedNodeTracksTests::testSerializerRoundTrip()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Compressing the same data the same way gives the same result as mCompressed
+    mAnimation->compressNodeTracks(mTolerance.position, mTolerance.rotation, mTolerance.scale);
+    const CompressedNodeTracks* expected = mCompressed->getCompressedNodeTracks();
+    size_t numTracks = expected->getNumTracks();
+    vector<CompressedNodeTracks::SampledTransform>::type expectedSamples(numTracks), samples(numTracks);
+
+    SkeletonSerializer serializer;
+    MemoryDataStream* buffer = OGRE_NEW MemoryDataStream(65536);
+    DataStreamPtr out(buffer);
+
+    // Current version keeps the data compressed
+    serializer.exportSkeleton(mSkeleton.get(), out);
+    CPPUNIT_ASSERT(hasVersionHeader(buffer, "[Serializer_v1.100]"));
+    DataStreamPtr in(OGRE_NEW MemoryDataStream(buffer->getPtr(), buffer->tell()));
+    SkeletonPtr imported = createSkeleton("CompressedNodeTracksTests_Latest");
+    serializer.importSkeleton(in, imported.get());
+
+    Animation* anim = imported->getAnimation("Wave");
+    CPPUNIT_ASSERT(anim->hasCompressedNodeTracks());
+    CPPUNIT_ASSERT_EQUAL((unsigned short)0, anim->getNumNodeTracks());
+    const CompressedNodeTracks* compressed = anim->getCompressedNodeTracks();
+    CPPUNIT_ASSERT_EQUAL(numTracks, compressed->getNumTracks());
+    CPPUNIT_ASSERT_EQUAL(expected->getNumKeyFrames(), compressed->getNumKeyFrames());
+    for (Real t = 0; t <= ANIMATION_LENGTH; t += 0.1f)
+    {
+        expected->sample(t, 0, &expectedSamples[0]);
+        compressed->sample(t, 0, &samples[0]);
+        for (size_t i = 0; i < numTracks; ++i)
+        {
+            CPPUNIT_ASSERT(expectedSamples[i].rotation == samples[i].rotation);
+            CPPUNIT_ASSERT(expectedSamples[i].translation == samples[i].translation);
+            CPPUNIT_ASSERT(expectedSamples[i].scale == samples[i].scale);
+        }
+    }
+
+    // Older versions get the remaining keys in full
+    buffer->seek(0);
+    serializer.exportSkeleton(mSkeleton.get(), out, SKELETON_VERSION_1_8);
+    CPPUNIT_ASSERT(hasVersionHeader(buffer, "[Serializer_v1.80]"));
+    in = DataStreamPtr(OGRE_NEW MemoryDataStream(buffer->getPtr(), buffer->tell()));
+    imported = createSkeleton("CompressedNodeTracksTests_1_8");
+    serializer.importSkeleton(in, imported.get());
+
+    anim = imported->getAnimation("Wave");
+    CPPUNIT_ASSERT(!anim->hasCompressedNodeTracks());
+    CPPUNIT_ASSERT_EQUAL((unsigned short)numTracks, anim->getNumNodeTracks());
+    size_t numKeys = 0;
+    for (size_t i = 0; i < numTracks; ++i)
+    {
+        const NodeAnimationTrack* track = anim->getNodeTrack(expected->getTrackHandle(i));
+        numKeys += track->getNumKeyFrames();
+        for (unsigned short k = 0; k < track->getNumKeyFrames(); ++k)
+        {
+            const TransformKeyFrame* kf = track->getNodeKeyFrame(k);
+            expected->sample(kf->getTime(), 0, &expectedSamples[0]);
+            CPPUNIT_ASSERT(kf->getTranslate().positionEquals(expectedSamples[i].translation, 1e-5f));
+            CPPUNIT_ASSERT(kf->getScale().positionEquals(expectedSamples[i].scale, 1e-5f));
+            CPPUNIT_ASSERT(kf->getRotation().equals(expectedSamples[i].rotation, Degree(0.1f)));
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(expected->getNumKeyFrames(), numKeys);
+
+    // Without compressed tracks the current version stays readable by older ones
+    mAnimation->decompressNodeTracks(mSkeleton.get());
+    buffer->seek(0);
+    serializer.exportSkeleton(mSkeleton.get(), out);
+    CPPUNIT_ASSERT(hasVersionHeader(buffer, "[Serializer_v1.80]"));
+}
@@ -345,6 +345,49 @@ void FileSystemArchiveTests::testReadInterleave()
     CPPUNIT_ASSERT(stream2->eof());
 }
 //--------------------------------------------------------------------------
+void FileSystemArchiveTests::testMappedFileRead()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    if (!MappedFileDataStream::isSupported())
+        return;
+
+    FileSystemArchive arch(mTestPath, "FileSystem", true);
+    arch.setUseMemoryMapping(true);
+    arch.load();
+
+    DataStreamPtr stream = arch.open("rootfile.txt");
+    MemoryDataStreamPtr memStream = stream.dynamicCast<MemoryDataStream>();
+    CPPUNIT_ASSERT(!memStream.isNull());
+    CPPUNIT_ASSERT(!memStream->isWriteable());
+    if (mFileSizeRoot1 > 0)
+        CPPUNIT_ASSERT_EQUAL(mFileSizeRoot1, memStream->size());
+
+    // the contents are there without reading anything
+    String firstLine("this is line 1 in file 1");
+    CPPUNIT_ASSERT(memcmp(memStream->getPtr(), firstLine.c_str(), firstLine.size()) == 0);
+
+    CPPUNIT_ASSERT_EQUAL(firstLine, stream->getLine());
+    CPPUNIT_ASSERT_EQUAL(String("this is line 2 in file 1"), stream->getLine());
+    CPPUNIT_ASSERT(memcmp(memStream->getCurrentPtr(), "this is line 3", 14) == 0);
+    stream->skipLine();
+    stream->skipLine();
+    CPPUNIT_ASSERT_EQUAL(String("this is line 5 in file 1"), stream->getLine());
+    CPPUNIT_ASSERT_EQUAL(BLANKSTRING, stream->getLine()); // blank at end of file
+    CPPUNIT_ASSERT(stream->eof());
+
+    // other archives of the same folder still stream from the file
+    FileSystemArchive other(mTestPath, "FileSystem", true);
+    other.load();
+    CPPUNIT_ASSERT(other.open("rootfile.txt").dynamicCast<MemoryDataStream>().isNull());
+
+    // switching it off goes back to streaming from the file
+    arch.setUseMemoryMapping(false);
+    stream = arch.open("rootfile.txt");
+    CPPUNIT_ASSERT(stream.dynamicCast<MemoryDataStream>().isNull());
+    CPPUNIT_ASSERT_EQUAL(firstLine, stream->getLine());
+}
+//--------------------------------------------------------------------------
 void FileSystemArchiveTests::testCreateAndRemoveFile()
 {
     UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
@@ -0,0 +1,157 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "FrameAllocatorTests.h"
+#include "OgreFrameAllocator.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(FrameAllocatorTests);
+
+//--------------------------------------------------------------------------
+void FrameAllocatorTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mAllocator = OGRE_NEW FrameAllocator(1024);
+}
+//--------------------------------------------------------------------------
+void FrameAllocatorTests::tearDown()
+{
+    OGRE_DELETE mAllocator;
+}
+//--------------------------------------------------------------------------
+void FrameAllocatorTests::testAlignment()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    char* a = static_cast<char*>(mAllocator->allocate(1));
+    void* b = mAllocator->allocate(4, 64);
+    void* c = mAllocator->allocate(3);
+
+    CPPUNIT_ASSERT(mAllocator->owns(a));
+    CPPUNIT_ASSERT(mAllocator->owns(b));
+    CPPUNIT_ASSERT(mAllocator->owns(c));
+    CPPUNIT_ASSERT_EQUAL((size_t)0, reinterpret_cast<size_t>(b) & 63);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, reinterpret_cast<size_t>(c) & (2 * sizeof(void*) - 1));
+    CPPUNIT_ASSERT(!mAllocator->owns(&a));
+
+    FrameAllocator::Stats stats = mAllocator->getFrameStats();
+    CPPUNIT_ASSERT_EQUAL((size_t)3, stats.allocations);
+    CPPUNIT_ASSERT_EQUAL((size_t)8, stats.bytes);
+}
+//--------------------------------------------------------------------------
+void FrameAllocatorTests::testScopes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    void* outer = mAllocator->allocate(16);
+    void* first;
+    {
+        FrameAllocator::Scope scope(mAllocator);
+        first = mAllocator->allocate(32);
+        {
+            FrameAllocator::Scope nested(mAllocator);
+            CPPUNIT_ASSERT(mAllocator->allocate(2000) != 0);
+        }
+        // the nested scope released its memory
+        CPPUNIT_ASSERT(mAllocator->allocate(32) == static_cast<char*>(first) + 32);
+    }
+
+    // the scope memory is reused, the memory allocated before it is kept
+    CPPUNIT_ASSERT(mAllocator->allocate(32) == first);
+    CPPUNIT_ASSERT(first != outer);
+
+    // null scopes do nothing
+    FrameAllocator::Scope scope(0);
+}
+//--------------------------------------------------------------------------
+void FrameAllocatorTests::testResetMergesBlocks()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    for (int i = 0; i < 10; ++i)
+        mAllocator->allocate(600);
+    size_t capacity = mAllocator->getCapacity();
+    CPPUNIT_ASSERT(capacity >= 6000);
+
+    mAllocator->_frameEnded();
+    CPPUNIT_ASSERT_EQUAL((size_t)10, mAllocator->getLastFrameStats().allocations);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, mAllocator->getFrameStats().allocations);
+    CPPUNIT_ASSERT_EQUAL(capacity, mAllocator->getCapacity());
+
+    // the same frame now fits in a single block
+    char* first = static_cast<char*>(mAllocator->allocate(600));
+    for (int i = 1; i < 10; ++i)
+    {
+        char* p = static_cast<char*>(mAllocator->allocate(600));
+        CPPUNIT_ASSERT(p > first && p < first + capacity);
+    }
+}
+//--------------------------------------------------------------------------
+void FrameAllocatorTests::testAllocPolicy()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    typedef std::vector<int, STLAllocator<int, FrameAllocPolicy> > FrameIntVector;
+    {
+        FrameIntVector v;
+        for (int i = 0; i < 100; ++i)
+            v.push_back(i);
+        CPPUNIT_ASSERT(mAllocator->owns(&v[0]));
+        CPPUNIT_ASSERT_EQUAL(99, v.back());
+    }
+    CPPUNIT_ASSERT(mAllocator->getFrameStats().allocations > 0);
+
+    int* ints = OGRE_ALLOC_T(int, 16, MEMCATEGORY_FRAME);
+    CPPUNIT_ASSERT(mAllocator->owns(ints));
+    OGRE_FREE(ints, MEMCATEGORY_FRAME);
+
+    float* aligned = OGRE_ALLOC_T_SIMD(float, 4, MEMCATEGORY_FRAME);
+    CPPUNIT_ASSERT(mAllocator->owns(aligned));
+    CPPUNIT_ASSERT_EQUAL((size_t)0, reinterpret_cast<size_t>(aligned) & (OGRE_SIMD_ALIGNMENT - 1));
+    OGRE_FREE_SIMD(aligned, MEMCATEGORY_FRAME);
+}
+//--------------------------------------------------------------------------
+void FrameAllocatorTests::testDisabled()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    mAllocator->setEnabled(false);
+
+    int* ints = OGRE_ALLOC_T(int, 16, MEMCATEGORY_FRAME);
+    CPPUNIT_ASSERT(!mAllocator->owns(ints));
+    OGRE_FREE(ints, MEMCATEGORY_FRAME);
+
+    FrameAllocator::Stats stats = mAllocator->getFrameStats();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.allocations);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, stats.fallbacks);
+}
+//--------------------------------------------------------------------------
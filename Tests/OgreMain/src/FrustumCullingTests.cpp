@@ -0,0 +1,166 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "FrustumCullingTests.h"
+#include "OgreRoot.h"
+#include "OgreCamera.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Frustum seeing everything, to check that areVisible respects isVisible overrides
+    class SeeAllFrustum : public Frustum
+    {
+    public:
+        bool isVisible(const AxisAlignedBox& bound, FrustumPlane* culledBy = 0) const
+        { return !bound.isNull(); }
+    };
+}
+
+// Register the test suite
+#ifdef OGRE_BUILD_RENDERSYSTEM_NULL
+CPPUNIT_TEST_SUITE_REGISTRATION(FrustumCullingTests);
+#endif
+
+//--------------------------------------------------------------------------
+void FrustumCullingTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = mFixture.setUp();
+
+    mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+
+    // Camera tests the boxes together, unlike the default Frustum::areVisible
+    mCamera = mSceneMgr->createCamera("FrustumCullingCamera");
+    mCamera->setNearClipDistance(1);
+    mCamera->setFarClipDistance(500);
+    mCamera->setFOVy(Degree(60));
+
+    SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+        Vector3(10, 20, 30), Quaternion(Degree(30), Vector3::UNIT_Y));
+    node->attachObject(mCamera);
+    node->_update(true, false);
+}
+//--------------------------------------------------------------------------
+void FrustumCullingTests::tearDown()
+{
+    mBoxes.clear();
+    mBoxPtrs.clear();
+    mRoot->destroySceneManager(mSceneMgr);
+    mFixture.tearDown();
+}
+//--------------------------------------------------------------------------
+void FrustumCullingTests::createBoxes(size_t count)
+{
+    // Boxes around the frustum, a good part of them crossing its planes
+    srand(1234);
+    mBoxes.clear();
+    for (size_t i = 0; i < count; ++i)
+    {
+        Vector3 centre(Math::RangeRandom(-600, 600), Math::RangeRandom(-600, 600), 
+            Math::RangeRandom(-600, 600));
+        Vector3 halfSize(Math::RangeRandom(0, 50), Math::RangeRandom(0, 50), 
+            Math::RangeRandom(0, 50));
+        mBoxes.push_back(AxisAlignedBox(centre - halfSize, centre + halfSize));
+    }
+
+    mBoxPtrs.clear();
+    for (size_t i = 0; i < count; ++i)
+        mBoxPtrs.push_back(&mBoxes[i]);
+}
+//--------------------------------------------------------------------------
+void FrustumCullingTests::checkBatchMatchesSingle()
+{
+    // deque as vector<bool> has no contiguous storage
+    deque<bool>::type expected;
+    size_t numVisible = 0;
+    for (size_t i = 0; i < mBoxes.size(); ++i)
+    {
+        expected.push_back(mCamera->isVisible(mBoxes[i]));
+        numVisible += expected.back() ? 1 : 0;
+    }
+    CPPUNIT_ASSERT(numVisible > 0 && numVisible < mBoxes.size());
+
+    bool* visible = OGRE_ALLOC_T(bool, mBoxes.size(), MEMCATEGORY_GENERAL);
+    mCamera->areVisible(&mBoxPtrs[0], mBoxPtrs.size(), visible);
+    for (size_t i = 0; i < mBoxes.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(expected[i], visible[i]);
+    }
+    OGRE_FREE(visible, MEMCATEGORY_GENERAL);
+}
+//--------------------------------------------------------------------------
+void FrustumCullingTests::testBatchMatchesSingle()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Not a multiple of the chunk or block size
+    createBoxes(1001);
+    mBoxes[3].setNull();
+    mBoxes[5].setInfinite();
+    mBoxes[7].setExtents(Vector3(10, 20, -30), Vector3(10, 20, -30));
+    checkBatchMatchesSingle();
+}
+//--------------------------------------------------------------------------
+void FrustumCullingTests::testInfiniteFarPlane()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    mCamera->setFarClipDistance(0);
+    createBoxes(1001);
+    checkBatchMatchesSingle();
+}
+//--------------------------------------------------------------------------
+void FrustumCullingTests::testOverriddenIsVisible()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    createBoxes(101);
+    mBoxes[3].setNull();
+
+    SeeAllFrustum frustum;
+    bool visible[101];
+    frustum.areVisible(&mBoxPtrs[0], mBoxPtrs.size(), visible);
+    for (size_t i = 0; i < mBoxes.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(i != 3, visible[i]);
+    }
+
+    // A camera culling through it gets the same answers
+    mCamera->setCullingFrustum(&frustum);
+    mCamera->areVisible(&mBoxPtrs[0], mBoxPtrs.size(), visible);
+    mCamera->setCullingFrustum(0);
+    for (size_t i = 0; i < mBoxes.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(i != 3, visible[i]);
+    }
+}
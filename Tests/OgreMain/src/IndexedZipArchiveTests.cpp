@@ -0,0 +1,240 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "IndexedZipArchiveTests.h"
+#include "ArchiveTestUtils.h"
+#include "OgreIndexedZip.h"
+#include "OgreCommon.h"
+
+#include "UnitTestSuite.h"
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+#include "macUtils.h"
+#endif
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION( IndexedZipArchiveTests );
+
+//--------------------------------------------------------------------------
+void IndexedZipArchiveTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+    mTestPath = macBundlePath() + "/Contents/Resources/Media/misc/ArchiveTest.zip";
+#elif OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+    mTestPath = "../../Tests/OgreMain/misc/ArchiveTest.zip";
+#else
+    mTestPath = "./Tests/OgreMain/misc/ArchiveTest.zip";
+#endif
+}
+//--------------------------------------------------------------------------
+void IndexedZipArchiveTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+IndexedZipArchive* IndexedZipArchiveTests::loadArchive()
+{
+    IndexedZipArchive* arch = OGRE_NEW IndexedZipArchive(mTestPath, "IndexedZip");
+    try {
+        arch->load();
+    } catch (Ogre::Exception e) {
+        // If it starts in build/bin/debug
+        OGRE_DELETE arch;
+        arch = OGRE_NEW IndexedZipArchive("../../../" + mTestPath, "IndexedZip");
+        arch->load();
+    }
+    return arch;
+}
+//--------------------------------------------------------------------------
+void IndexedZipArchiveTests::testListRecursive()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    IndexedZipArchive* arch = loadArchive();
+    StringVectorPtr vec = arch->list(true);
+
+    CPPUNIT_ASSERT_EQUAL((size_t)6, vec->size());
+    CPPUNIT_ASSERT_EQUAL(String("file.material"), vec->at(0));
+    CPPUNIT_ASSERT_EQUAL(String("file2.material"), vec->at(1));
+    CPPUNIT_ASSERT_EQUAL(String("file3.material"), vec->at(2));
+    CPPUNIT_ASSERT_EQUAL(String("file4.material"), vec->at(3));
+    CPPUNIT_ASSERT_EQUAL(String("rootfile.txt"), vec->at(4));
+    CPPUNIT_ASSERT_EQUAL(String("rootfile2.txt"), vec->at(5));
+
+    vec = arch->list(true, true);
+    CPPUNIT_ASSERT_EQUAL((size_t)6, vec->size());
+    CPPUNIT_ASSERT_EQUAL(String("level1"), vec->at(0));
+    CPPUNIT_ASSERT_EQUAL(String("level1/materials"), vec->at(1));
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void IndexedZipArchiveTests::testListFileInfoRecursive()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    IndexedZipArchive* arch = loadArchive();
+    FileInfoListPtr vec = arch->listFileInfo(true);
+
+    CPPUNIT_ASSERT_EQUAL((size_t)6, vec->size());
+    FileInfo& fi3 = vec->at(0);
+    CPPUNIT_ASSERT_EQUAL(String("file.material"), fi3.filename);
+    CPPUNIT_ASSERT_EQUAL(String("level1/materials/scripts/"), fi3.path);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, fi3.compressedSize);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, fi3.uncompressedSize);
+
+    FileInfo& fi1 = vec->at(4);
+    CPPUNIT_ASSERT_EQUAL(String("rootfile.txt"), fi1.filename);
+    CPPUNIT_ASSERT_EQUAL(BLANKSTRING, fi1.path);
+    CPPUNIT_ASSERT_EQUAL((size_t)40, fi1.compressedSize);
+    CPPUNIT_ASSERT_EQUAL((size_t)130, fi1.uncompressedSize);
+
+    FileInfo& fi2 = vec->at(5);
+    CPPUNIT_ASSERT_EQUAL(String("rootfile2.txt"), fi2.filename);
+    CPPUNIT_ASSERT_EQUAL(BLANKSTRING, fi2.path);
+    CPPUNIT_ASSERT_EQUAL((size_t)45, fi2.compressedSize);
+    CPPUNIT_ASSERT_EQUAL((size_t)156, fi2.uncompressedSize);
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void IndexedZipArchiveTests::testFindNonRecursive()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    IndexedZipArchive* arch = loadArchive();
+    StringVectorPtr vec = arch->find("*.txt", false);
+
+    CPPUNIT_ASSERT_EQUAL((size_t)2, vec->size());
+    CPPUNIT_ASSERT_EQUAL(String("rootfile.txt"), vec->at(0));
+    CPPUNIT_ASSERT_EQUAL(String("rootfile2.txt"), vec->at(1));
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void IndexedZipArchiveTests::testExists()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    IndexedZipArchive* arch = loadArchive();
+
+    CPPUNIT_ASSERT(arch->exists("rootfile.txt"));
+    CPPUNIT_ASSERT(arch->exists("ROOTFILE2.TXT"));
+    CPPUNIT_ASSERT(arch->exists("file3.material"));
+    CPPUNIT_ASSERT(arch->exists("level1/materials/scripts/file.material"));
+    CPPUNIT_ASSERT(!arch->exists("file5.material"));
+    // A path must match, only a bare name is looked up in every folder
+    CPPUNIT_ASSERT(!arch->exists("level2/file.material"));
+    CPPUNIT_ASSERT(arch->open("file5.material").isNull());
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void IndexedZipArchiveTests::testFileRead()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    IndexedZipArchive* arch = loadArchive();
+
+    DataStreamPtr stream = arch->open("rootfile.txt");
+    CPPUNIT_ASSERT_EQUAL(String("this is line 1 in file 1"), stream->getLine());
+    CPPUNIT_ASSERT_EQUAL(String("this is line 2 in file 1"), stream->getLine());
+    CPPUNIT_ASSERT_EQUAL(String("this is line 3 in file 1"), stream->getLine());
+    CPPUNIT_ASSERT_EQUAL(String("this is line 4 in file 1"), stream->getLine());
+    CPPUNIT_ASSERT_EQUAL(String("this is line 5 in file 1"), stream->getLine());
+    CPPUNIT_ASSERT(stream->eof());
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void IndexedZipArchiveTests::testReadByPath()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    IndexedZipArchive* arch = loadArchive();
+
+    DataStreamPtr stream = arch->open("level2/materials/scripts/file4.material");
+    CPPUNIT_ASSERT(!stream.isNull());
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stream->size());
+
+    stream = arch->open("File4.Material");
+    CPPUNIT_ASSERT(!stream.isNull());
+
+    stream = arch->open("level1/materials/scripts/file4.material");
+    CPPUNIT_ASSERT(stream.isNull());
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void IndexedZipArchiveTests::testDecompress()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    IndexedZipArchive* arch = loadArchive();
+
+    char buffer[256];
+    CPPUNIT_ASSERT_EQUAL((size_t)130, arch->decompress("rootfile.txt", buffer, sizeof(buffer)));
+    CPPUNIT_ASSERT_EQUAL(String("this is line 1 in file 1"), String(buffer, 24));
+    CPPUNIT_ASSERT_EQUAL(String("this is line 5 in file 1"), String(buffer + 104, 24));
+
+    CPPUNIT_ASSERT_EQUAL((size_t)156, arch->decompress("rootfile2.txt", buffer, 156));
+    CPPUNIT_ASSERT_EQUAL(String("this is line 1 in file 2"), String(buffer, 24));
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void IndexedZipArchiveTests::testDecompressBufferTooSmall()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    IndexedZipArchive* arch = loadArchive();
+
+    char buffer[129];
+    CPPUNIT_ASSERT_THROW(arch->decompress("rootfile.txt", buffer, sizeof(buffer)), InvalidParametersException);
+    CPPUNIT_ASSERT_THROW(arch->decompress("missing.txt", buffer, sizeof(buffer)), FileNotFoundException);
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void IndexedZipArchiveTests::testConcurrentOpen()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    IndexedZipArchive* arch = loadArchive();
+
+    // Every thread reads both files while the others do
+    const String filenames[2] = { "rootfile.txt", "rootfile2.txt" };
+    const String expected[2] = { arch->open(filenames[0])->getAsString(),
+        arch->open(filenames[1])->getAsString() };
+    CPPUNIT_ASSERT_EQUAL((size_t)0, readArchiveConcurrently(arch, filenames, expected, 2, 8, 200));
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,334 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreLodStrategyManager.h"
+#include "OgreMeshManager.h"
+#include "OgreMesh.h"
+#include "OgreSubMesh.h"
+#include "OgreRay.h"
+#include "OgreMatrix4.h"
+#include "MeshTriangleBvhTests.h"
+
+#include "UnitTestSuite.h"
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(MeshTriangleBvhTests);
+
+//--------------------------------------------------------------------------
+void MeshTriangleBvhTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    OGRE_NEW ResourceGroupManager();
+    OGRE_NEW LodStrategyManager();
+    mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+    mMeshMgr = OGRE_NEW MeshManager();
+    srand(1234);
+}
+//--------------------------------------------------------------------------
+void MeshTriangleBvhTests::tearDown()
+{
+    OGRE_DELETE mMeshMgr;
+    OGRE_DELETE mBufMgr;
+    OGRE_DELETE LodStrategyManager::getSingletonPtr();
+    OGRE_DELETE ResourceGroupManager::getSingletonPtr();
+}
+//--------------------------------------------------------------------------
+VertexData* MeshTriangleBvhTests::createVertexData(const float* positions,
+    size_t vertexCount, bool blendWeights)
+{
+    VertexData* vertexData = OGRE_NEW VertexData();
+    vertexData->vertexCount = vertexCount;
+
+    // position, then optionally a single weight and four indices, interleaved
+    VertexDeclaration* decl = vertexData->vertexDeclaration;
+    size_t offset = 0;
+    offset += decl->addElement(0, offset, VET_FLOAT3, VES_POSITION).getSize();
+    if (blendWeights)
+    {
+        offset += decl->addElement(0, offset, VET_FLOAT1, VES_BLEND_WEIGHTS).getSize();
+        offset += decl->addElement(0, offset, VET_UBYTE4, VES_BLEND_INDICES).getSize();
+    }
+
+    HardwareVertexBufferSharedPtr vbuf = mBufMgr->createVertexBuffer(
+        offset, vertexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+    unsigned char* data = static_cast<unsigned char*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+    for (size_t i = 0; i < vertexCount; ++i, data += offset)
+    {
+        memcpy(data, positions + i * 3, sizeof(float) * 3);
+        if (blendWeights)
+        {
+            float weight = 1.0f;
+            memcpy(data + sizeof(float) * 3, &weight, sizeof(float));
+            memset(data + sizeof(float) * 4, 0, 4);
+        }
+    }
+    vbuf->unlock();
+    vertexData->vertexBufferBinding->setBinding(0, vbuf);
+
+    return vertexData;
+}
+//--------------------------------------------------------------------------
+void MeshTriangleBvhTests::createRandomSubMesh(Mesh* mesh, size_t triangleCount)
+{
+    // a soup of small triangles scattered through a box, indexed in reverse
+    vector<float>::type positions;
+    for (size_t i = 0; i < triangleCount; ++i)
+    {
+        Vector3 centre(Math::RangeRandom(-100, 100), Math::RangeRandom(-100, 100),
+            Math::RangeRandom(-100, 100));
+        for (int v = 0; v < 3; ++v)
+        {
+            positions.push_back(centre.x + Math::RangeRandom(-10, 10));
+            positions.push_back(centre.y + Math::RangeRandom(-10, 10));
+            positions.push_back(centre.z + Math::RangeRandom(-10, 10));
+        }
+    }
+
+    SubMesh* sub = mesh->createSubMesh();
+    sub->useSharedVertices = false;
+    sub->vertexData = createVertexData(&positions[0], triangleCount * 3, false);
+
+    HardwareIndexBufferSharedPtr ibuf = mBufMgr->createIndexBuffer(
+        HardwareIndexBuffer::IT_16BIT, triangleCount * 3, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+    uint16* indices = static_cast<uint16*>(ibuf->lock(HardwareBuffer::HBL_DISCARD));
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+        indices[i] = static_cast<uint16>(triangleCount * 3 - 1 - i);
+    ibuf->unlock();
+    sub->indexData->indexBuffer = ibuf;
+    sub->indexData->indexCount = triangleCount * 3;
+}
+//--------------------------------------------------------------------------
+void MeshTriangleBvhTests::checkRays(const MeshTriangleBvh* bvh, size_t rayCount,
+    const MeshTriangleBvh::Pose* pose)
+{
+    const float* positions = pose ? &pose->positions[0] : &bvh->getPositions()[0];
+    size_t hits = 0;
+    for (size_t i = 0; i < rayCount; ++i)
+    {
+        Vector3 origin(Math::RangeRandom(-200, 200), Math::RangeRandom(-200, 200),
+            Math::RangeRandom(-200, 200));
+        Vector3 target(Math::RangeRandom(-100, 100), Math::RangeRandom(-100, 100),
+            Math::RangeRandom(-100, 100));
+        Ray ray(origin, (target - origin).normalisedCopy());
+
+        MeshTriangleBvh::Hit treeHit, bruteHit;
+        bool treeResult = pose ? bvh->intersects(ray, *pose, treeHit) :
+            bvh->intersects(ray, treeHit);
+        bool bruteResult = bvh->intersects(ray, positions, bruteHit);
+        CPPUNIT_ASSERT_EQUAL(bruteResult, treeResult);
+        if (treeResult)
+        {
+            ++hits;
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(bruteHit.distance, treeHit.distance, 1e-3);
+            CPPUNIT_ASSERT_EQUAL(bruteHit.subMeshIndex, treeHit.subMeshIndex);
+            CPPUNIT_ASSERT_EQUAL(bruteHit.triangleIndex, treeHit.triangleIndex);
+            CPPUNIT_ASSERT(treeHit.u >= 0 && treeHit.v >= 0 && treeHit.u + treeHit.v <= 1.001f);
+        }
+    }
+    // make sure the rays actually exercised the tree
+    CPPUNIT_ASSERT(hits > 0);
+}
+//--------------------------------------------------------------------------
+void MeshTriangleBvhTests::testMatchesBruteForce()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    MeshPtr mesh = mMeshMgr->createManual("TriangleSoup",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    createRandomSubMesh(mesh.get(), 2000);
+    createRandomSubMesh(mesh.get(), 500);
+
+    const MeshTriangleBvh* bvh = mesh->getTriangleBvh();
+    CPPUNIT_ASSERT_EQUAL((size_t)2500, bvh->getTriangleCount());
+    CPPUNIT_ASSERT(bvh->getNodeCount() > 1);
+    checkRays(bvh, 1000);
+
+    mMeshMgr->remove(mesh->getHandle());
+}
+//--------------------------------------------------------------------------
+void MeshTriangleBvhTests::testRefitMatchesBruteForce()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    MeshPtr mesh = mMeshMgr->createManual("TriangleSoup",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    createRandomSubMesh(mesh.get(), 2000);
+    const MeshTriangleBvh* bvh = mesh->getTriangleBvh();
+
+    // every vertex moved on its own, far enough for triangles to leave their nodes
+    MeshTriangleBvh::Pose pose;
+    pose.positions = bvh->getPositions();
+    for (size_t i = 0; i < pose.positions.size(); ++i)
+        pose.positions[i] += Math::RangeRandom(-30, 30);
+    bvh->refit(pose);
+    CPPUNIT_ASSERT_EQUAL(bvh->getNodeCount(), pose.bounds.size());
+    checkRays(bvh, 1000, &pose);
+
+    // a pose of another mesh is never walked
+    MeshTriangleBvh::Pose other;
+    other.positions.resize(9);
+    bvh->refit(other);
+    MeshTriangleBvh::Hit hit;
+    CPPUNIT_ASSERT(other.bounds.empty());
+    CPPUNIT_ASSERT(!bvh->intersects(Ray(Vector3::ZERO, Vector3::UNIT_Y), other, hit));
+
+    mMeshMgr->remove(mesh->getHandle());
+}
+//--------------------------------------------------------------------------
+void MeshTriangleBvhTests::testSharedAndStripSubMeshes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // a grid of quads in the shared vertex data, rendered as one strip per row
+    const size_t gridSize = 20;
+    vector<float>::type positions;
+    for (size_t z = 0; z <= gridSize; ++z)
+    {
+        for (size_t x = 0; x <= gridSize; ++x)
+        {
+            positions.push_back(x * 10.0f - 100.0f);
+            positions.push_back(Math::RangeRandom(-20, 20));
+            positions.push_back(z * 10.0f - 100.0f);
+        }
+    }
+
+    MeshPtr mesh = mMeshMgr->createManual("StripGrid",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    mesh->sharedVertexData = createVertexData(&positions[0], positions.size() / 3, false);
+    for (size_t z = 0; z < gridSize; ++z)
+    {
+        SubMesh* sub = mesh->createSubMesh();
+        sub->useSharedVertices = true;
+        sub->operationType = RenderOperation::OT_TRIANGLE_STRIP;
+
+        HardwareIndexBufferSharedPtr ibuf = mBufMgr->createIndexBuffer(
+            HardwareIndexBuffer::IT_32BIT, (gridSize + 1) * 2, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        uint32* indices = static_cast<uint32*>(ibuf->lock(HardwareBuffer::HBL_DISCARD));
+        for (size_t x = 0; x <= gridSize; ++x)
+        {
+            *indices++ = static_cast<uint32>(z * (gridSize + 1) + x);
+            *indices++ = static_cast<uint32>((z + 1) * (gridSize + 1) + x);
+        }
+        ibuf->unlock();
+        sub->indexData->indexBuffer = ibuf;
+        sub->indexData->indexCount = (gridSize + 1) * 2;
+    }
+    // and a dedicated soup on top
+    createRandomSubMesh(mesh.get(), 300);
+
+    const MeshTriangleBvh* bvh = mesh->getTriangleBvh();
+    CPPUNIT_ASSERT_EQUAL(gridSize * gridSize * 2 + 300, bvh->getTriangleCount());
+    checkRays(bvh, 1000);
+
+    // straight up from below, the grid is never further than its highest point
+    MeshTriangleBvh::Hit hit;
+    CPPUNIT_ASSERT(bvh->intersects(Ray(Vector3(5, -1000, 5), Vector3::UNIT_Y), hit));
+    CPPUNIT_ASSERT(hit.distance <= 1020);
+
+    mMeshMgr->remove(mesh->getHandle());
+}
+//--------------------------------------------------------------------------
+void MeshTriangleBvhTests::testMiss()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    MeshPtr mesh = mMeshMgr->createManual("TriangleSoup",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    createRandomSubMesh(mesh.get(), 100);
+    const MeshTriangleBvh* bvh = mesh->getTriangleBvh();
+
+    MeshTriangleBvh::Hit hit;
+    // pointing away from the mesh, and passing beside it
+    CPPUNIT_ASSERT(!bvh->intersects(Ray(Vector3(0, 500, 0), Vector3::UNIT_Y), hit));
+    CPPUNIT_ASSERT(!bvh->intersects(Ray(Vector3(500, 500, 0), Vector3::UNIT_Z), hit));
+
+    // an empty mesh never hits anything
+    MeshPtr empty = mMeshMgr->createManual("Empty",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, empty->getTriangleBvh()->getTriangleCount());
+    CPPUNIT_ASSERT(!empty->getTriangleBvh()->intersects(Ray(Vector3::ZERO, Vector3::UNIT_Y), hit));
+
+    mMeshMgr->remove(mesh->getHandle());
+    mMeshMgr->remove(empty->getHandle());
+}
+//--------------------------------------------------------------------------
+void MeshTriangleBvhTests::testSkinPositions()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const float positions[] = { 0, 0, 0,  10, 0, 0,  0, 10, 0 };
+    MeshPtr mesh = mMeshMgr->createManual("Skinned",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    SubMesh* sub = mesh->createSubMesh();
+    sub->useSharedVertices = false;
+    sub->vertexData = createVertexData(positions, 3, true);
+    sub->blendIndexToBoneIndexMap.push_back(0);
+
+    HardwareIndexBufferSharedPtr ibuf = mBufMgr->createIndexBuffer(
+        HardwareIndexBuffer::IT_16BIT, 3, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+    uint16* indices = static_cast<uint16*>(ibuf->lock(HardwareBuffer::HBL_DISCARD));
+    indices[0] = 0; indices[1] = 1; indices[2] = 2;
+    ibuf->unlock();
+    sub->indexData->indexBuffer = ibuf;
+    sub->indexData->indexCount = 3;
+
+    const MeshTriangleBvh* bvh = mesh->getTriangleBvh();
+    vector<float>::type skinned;
+
+    // the identity pose leaves the bind pose alone
+    Matrix4 bone = Matrix4::IDENTITY;
+    bvh->skinPositions(mesh.get(), &bone, skinned);
+    CPPUNIT_ASSERT_EQUAL(bvh->getPositions().size(), skinned.size());
+    for (size_t i = 0; i < skinned.size(); ++i)
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(bvh->getPositions()[i], skinned[i], 1e-5);
+
+    // a translated bone moves the triangle, and rays follow it
+    bone.makeTrans(0, 0, 50);
+    bvh->skinPositions(mesh.get(), &bone, skinned);
+    for (size_t i = 0; i < skinned.size(); i += 3)
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(bvh->getPositions()[i + 2] + 50, skinned[i + 2], 1e-5);
+
+    MeshTriangleBvh::Hit hit;
+    Ray ray(Vector3(1, 1, 100), Vector3::NEGATIVE_UNIT_Z);
+    CPPUNIT_ASSERT(bvh->intersects(ray, hit));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0, hit.distance, 1e-4);
+    CPPUNIT_ASSERT(bvh->intersects(ray, &skinned[0], hit));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(50.0, hit.distance, 1e-4);
+
+    // and so does the tree, once refitted
+    MeshTriangleBvh::Pose pose;
+    pose.positions = skinned;
+    bvh->refit(pose);
+    CPPUNIT_ASSERT(bvh->intersects(ray, pose, hit));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(50.0, hit.distance, 1e-4);
+
+    mMeshMgr->remove(mesh->getHandle());
+}
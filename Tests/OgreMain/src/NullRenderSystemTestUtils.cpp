@@ -0,0 +1,86 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "NullRenderSystemTestUtils.h"
+#include "OgreRoot.h"
+#include "OgreRenderWindow.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreFileSystemLayer.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace Ogre;
+
+//--------------------------------------------------------------------------
+NullRenderSystemFixture::NullRenderSystemFixture()
+    : mRoot(0), mBufMgr(0), mWindow(0)
+{
+}
+//--------------------------------------------------------------------------
+NullRenderSystemFixture::~NullRenderSystemFixture()
+{
+    tearDown();
+}
+//--------------------------------------------------------------------------
+Root* NullRenderSystemFixture::setUp(const String& windowName, unsigned int windowSize)
+{
+#ifdef OGRE_STATIC_LIB
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+    mStaticPluginLoader.load();
+#else
+    FileSystemLayer fsLayer(OGRE_VERSION_NAME);
+    mRoot = OGRE_NEW Root(fsLayer.getConfigFilePath("plugins.cfg"));
+#endif
+
+    RenderSystem* rs = mRoot->getRenderSystemByName("Null Rendering Subsystem");
+    CPPUNIT_ASSERT_MESSAGE("the Null render system is built but its plugin could not be loaded", rs);
+    for (NameValuePairList::const_iterator i = mConfigOptions.begin(); i != mConfigOptions.end(); ++i)
+        rs->setConfigOption(i->first, i->second);
+    mRoot->setRenderSystem(rs);
+
+    if (windowName.empty())
+    {
+        if (!HardwareBufferManager::getSingletonPtr())
+            mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+    }
+    else
+    {
+        mRoot->initialise(false);
+        mWindow = mRoot->createRenderWindow(windowName, windowSize, windowSize, false);
+        mWindow->setHidden(true);
+    }
+    return mRoot;
+}
+//--------------------------------------------------------------------------
+void NullRenderSystemFixture::tearDown()
+{
+    OGRE_DELETE mBufMgr;
+    mBufMgr = 0;
+    OGRE_DELETE mRoot;
+    mRoot = 0;
+    mWindow = 0;
+}
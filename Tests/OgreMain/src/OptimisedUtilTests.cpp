@@ -0,0 +1,380 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OptimisedUtilTests.h"
+#include "OgreMatrix4.h"
+#include "OgreVector4.h"
+#include "OgreEdgeListBuilder.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(OptimisedUtilTests);
+
+// Odd and not a multiple of 8, so every remainder path is taken
+static const size_t NUM_VERTICES = 101;
+static const size_t NUM_FACES = 37;
+
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mSeed = 12345;
+    mGeneral = OptimisedUtil::_getImplementation(OptimisedUtil::IMPL_GENERAL);
+
+    OptimisedUtil* sse = OptimisedUtil::_getImplementation(OptimisedUtil::IMPL_SSE);
+    if (sse)
+        mCandidates.push_back(sse);
+    OptimisedUtil* avx2 = OptimisedUtil::_getImplementation(OptimisedUtil::IMPL_AVX2);
+    if (avx2)
+        mCandidates.push_back(avx2);
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::tearDown()
+{
+    for (size_t i = 0; i < mBuffers.size(); ++i)
+        OGRE_FREE_SIMD(mBuffers[i], MEMCATEGORY_GENERAL);
+    mBuffers.clear();
+    mCandidates.clear();
+}
+//--------------------------------------------------------------------------
+float* OptimisedUtilTests::allocate(size_t numFloats)
+{
+    void* buffer = OGRE_MALLOC_SIMD(numFloats * sizeof(float), MEMCATEGORY_GENERAL);
+    memset(buffer, 0, numFloats * sizeof(float));
+    mBuffers.push_back(buffer);
+    return static_cast<float*>(buffer);
+}
+//--------------------------------------------------------------------------
+Real OptimisedUtilTests::random(Real low, Real high)
+{
+    mSeed = mSeed * 1664525 + 1013904223;
+    return low + (high - low) * (mSeed >> 8) / (Real)(1 << 24);
+}
+//--------------------------------------------------------------------------
+bool OptimisedUtilTests::allClose(const float* expected, const float* actual, size_t count, Real tolerance)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (Math::Abs(expected[i] - actual[i]) > tolerance * std::max(Real(1), Math::Abs(expected[i])))
+            return false;
+    }
+    return true;
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testSoftwareVertexSkinning()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t numMatrices = 6;
+    const size_t numWeights = 4;
+
+    Matrix4* matrices = reinterpret_cast<Matrix4*>(allocate(numMatrices * 16));
+    const Matrix4* blendMatrices[numMatrices];
+    for (size_t i = 0; i < numMatrices; ++i)
+    {
+        Vector3 axis(random(-1, 1), random(-1, 1), random(-1, 1));
+        axis.normalise();
+        Real scale = random(0.5f, 2.0f);
+        matrices[i].makeTransform(
+            Vector3(random(-10, 10), random(-10, 10), random(-10, 10)),
+            Vector3(scale, scale, scale),
+            Quaternion(Radian(random(0, Math::TWO_PI)), axis));
+        blendMatrices[i] = &matrices[i];
+    }
+
+    // Positions and normals interleaved
+    float* src = allocate(NUM_VERTICES * 6);
+    float* weights = allocate(NUM_VERTICES * numWeights);
+    unsigned char indices[NUM_VERTICES * numWeights];
+    for (size_t v = 0; v < NUM_VERTICES; ++v)
+    {
+        Vector3 normal(random(-1, 1), random(-1, 1), random(-1, 1));
+        normal.normalise();
+        src[v * 6 + 0] = random(-5, 5);
+        src[v * 6 + 1] = random(-5, 5);
+        src[v * 6 + 2] = random(-5, 5);
+        src[v * 6 + 3] = normal.x;
+        src[v * 6 + 4] = normal.y;
+        src[v * 6 + 5] = normal.z;
+
+        Real total = 0;
+        for (size_t w = 0; w < numWeights; ++w)
+        {
+            weights[v * numWeights + w] = random(0.1f, 1);
+            total += weights[v * numWeights + w];
+            indices[v * numWeights + w] = static_cast<unsigned char>(random(0, numMatrices - 0.01f));
+        }
+        for (size_t w = 0; w < numWeights; ++w)
+            weights[v * numWeights + w] /= total;
+    }
+
+    float* expected = allocate(NUM_VERTICES * 6);
+    float* actual = allocate(NUM_VERTICES * 6);
+    mGeneral->softwareVertexSkinning(
+        src, expected, src + 3, expected + 3,
+        weights, indices, blendMatrices,
+        6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float),
+        numWeights * sizeof(float), numWeights,
+        numWeights, NUM_VERTICES);
+
+    for (size_t i = 0; i < mCandidates.size(); ++i)
+    {
+        memset(actual, 0, NUM_VERTICES * 6 * sizeof(float));
+        mCandidates[i]->softwareVertexSkinning(
+            src, actual, src + 3, actual + 3,
+            weights, indices, blendMatrices,
+            6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float),
+            numWeights * sizeof(float), numWeights,
+            numWeights, NUM_VERTICES);
+        CPPUNIT_ASSERT(allClose(expected, actual, NUM_VERTICES * 6, 1e-3f));
+    }
+
+    // Positions only, into a separate packed buffer
+    mGeneral->softwareVertexSkinning(
+        src, expected, 0, 0,
+        weights, indices, blendMatrices,
+        6 * sizeof(float), 3 * sizeof(float), 0, 0,
+        numWeights * sizeof(float), numWeights,
+        numWeights, NUM_VERTICES);
+
+    for (size_t i = 0; i < mCandidates.size(); ++i)
+    {
+        memset(actual, 0, NUM_VERTICES * 6 * sizeof(float));
+        mCandidates[i]->softwareVertexSkinning(
+            src, actual, 0, 0,
+            weights, indices, blendMatrices,
+            6 * sizeof(float), 3 * sizeof(float), 0, 0,
+            numWeights * sizeof(float), numWeights,
+            numWeights, NUM_VERTICES);
+        CPPUNIT_ASSERT(allClose(expected, actual, NUM_VERTICES * 3, 1e-3f));
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testSoftwareVertexMorph()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    float* src1 = allocate(NUM_VERTICES * 6);
+    float* src2 = allocate(NUM_VERTICES * 6);
+    for (size_t i = 0; i < NUM_VERTICES * 6; ++i)
+    {
+        src1[i] = random(-10, 10);
+        src2[i] = random(-10, 10);
+    }
+
+    float* expected = allocate(NUM_VERTICES * 6);
+    float* actual = allocate(NUM_VERTICES * 6);
+
+    // Packed positions, then positions and normals
+    for (int morphNormals = 0; morphNormals < 2; ++morphNormals)
+    {
+        size_t vertexSize = (morphNormals ? 6 : 3) * sizeof(float);
+        mGeneral->softwareVertexMorph(0.3f, src1, src2, expected,
+            vertexSize, vertexSize, vertexSize, NUM_VERTICES, morphNormals != 0);
+
+        for (size_t i = 0; i < mCandidates.size(); ++i)
+        {
+            memset(actual, 0, NUM_VERTICES * 6 * sizeof(float));
+            mCandidates[i]->softwareVertexMorph(0.3f, src1, src2, actual,
+                vertexSize, vertexSize, vertexSize, NUM_VERTICES, morphNormals != 0);
+            CPPUNIT_ASSERT(allClose(expected, actual, NUM_VERTICES * vertexSize / sizeof(float), 1e-3f));
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testConcatenateAffineMatrices()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t numMatrices = 21;
+    Matrix4 base;
+    base.makeTransform(Vector3(1, -2, 3), Vector3(1, 2, 0.5f), Quaternion(Degree(40), Vector3::UNIT_Y));
+
+    Matrix4* src = reinterpret_cast<Matrix4*>(allocate(numMatrices * 16));
+    Matrix4* expected = reinterpret_cast<Matrix4*>(allocate(numMatrices * 16));
+    Matrix4* actual = reinterpret_cast<Matrix4*>(allocate(numMatrices * 16));
+    for (size_t i = 0; i < numMatrices; ++i)
+    {
+        Vector3 axis(random(-1, 1), random(-1, 1), random(-1, 1));
+        axis.normalise();
+        src[i].makeTransform(
+            Vector3(random(-10, 10), random(-10, 10), random(-10, 10)),
+            Vector3(random(0.5f, 2), random(0.5f, 2), random(0.5f, 2)),
+            Quaternion(Radian(random(0, Math::TWO_PI)), axis));
+    }
+
+    mGeneral->concatenateAffineMatrices(base, src, expected, numMatrices);
+
+    for (size_t i = 0; i < mCandidates.size(); ++i)
+    {
+        memset(actual, 0, numMatrices * sizeof(Matrix4));
+        mCandidates[i]->concatenateAffineMatrices(base, src, actual, numMatrices);
+        CPPUNIT_ASSERT(allClose(expected[0][0], actual[0][0], numMatrices * 16, 1e-4f));
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testCalculateFaceNormals()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    float* positions = allocate(NUM_VERTICES * 3);
+    for (size_t i = 0; i < NUM_VERTICES * 3; ++i)
+        positions[i] = random(-10, 10);
+
+    EdgeData::Triangle triangles[NUM_FACES];
+    for (size_t i = 0; i < NUM_FACES; ++i)
+    {
+        for (size_t v = 0; v < 3; ++v)
+            triangles[i].vertIndex[v] = static_cast<size_t>(random(0, NUM_VERTICES - 0.01f));
+    }
+
+    Vector4* expected = reinterpret_cast<Vector4*>(allocate(NUM_FACES * 4));
+    Vector4* actual = reinterpret_cast<Vector4*>(allocate(NUM_FACES * 4));
+    mGeneral->calculateFaceNormals(positions, triangles, expected, NUM_FACES);
+
+    for (size_t i = 0; i < mCandidates.size(); ++i)
+    {
+        memset(actual, 0, NUM_FACES * sizeof(Vector4));
+        mCandidates[i]->calculateFaceNormals(positions, triangles, actual, NUM_FACES);
+        CPPUNIT_ASSERT(allClose(expected->ptr(), actual->ptr(), NUM_FACES * 4, 1e-4f));
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testCalculateLightFacing()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Vector4 lightPos(3, 10, -2, 1);
+    Vector4* faceNormals = reinterpret_cast<Vector4*>(allocate(NUM_FACES * 4));
+    for (size_t i = 0; i < NUM_FACES; ++i)
+        faceNormals[i] = Vector4(random(-1, 1), random(-1, 1), random(-1, 1), random(-10, 10));
+
+    char expected[NUM_FACES];
+    char actual[NUM_FACES];
+    mGeneral->calculateLightFacing(lightPos, faceNormals, expected, NUM_FACES);
+
+    for (size_t i = 0; i < mCandidates.size(); ++i)
+    {
+        memset(actual, 2, NUM_FACES);
+        mCandidates[i]->calculateLightFacing(lightPos, faceNormals, actual, NUM_FACES);
+        for (size_t f = 0; f < NUM_FACES; ++f)
+        {
+            // Rounding may only flip faces that are edge on to the light
+            if (Math::Abs(lightPos.dotProduct(faceNormals[f])) > 1e-3f)
+                CPPUNIT_ASSERT_EQUAL(expected[f], actual[f]);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testExtrudeVertices()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    float* src = allocate(NUM_VERTICES * 3);
+    for (size_t i = 0; i < NUM_VERTICES * 3; ++i)
+        src[i] = random(-10, 10);
+
+    float* expected = allocate(NUM_VERTICES * 3);
+    float* actual = allocate(NUM_VERTICES * 3);
+
+    // Directional then point light
+    Vector4 lights[2] = { Vector4(1, -3, 2, 0), Vector4(20, 30, -5, 1) };
+    for (size_t l = 0; l < 2; ++l)
+    {
+        mGeneral->extrudeVertices(lights[l], 100, src, expected, NUM_VERTICES);
+
+        for (size_t i = 0; i < mCandidates.size(); ++i)
+        {
+            memset(actual, 0, NUM_VERTICES * 3 * sizeof(float));
+            mCandidates[i]->extrudeVertices(lights[l], 100, src, actual, NUM_VERTICES);
+            CPPUNIT_ASSERT(allClose(expected, actual, NUM_VERTICES * 3, 1e-3f));
+        }
+    }
+}
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testInterpolateNodeTransforms()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t numBlocks = 8;
+    float* weights = allocate(numBlocks * 4);
+    float* keys1 = allocate(numBlocks * 40);
+    float* keys2 = allocate(numBlocks * 40);
+    float* expected = allocate(numBlocks * 40);
+    for (size_t n = 0; n < numBlocks * 4; ++n)
+    {
+        float* k1 = keys1 + (n / 4) * 40 + (n & 3);
+        float* k2 = keys2 + (n / 4) * 40 + (n & 3);
+        float* e = expected + (n / 4) * 40 + (n & 3);
+
+        Quaternion q[2];
+        for (size_t k = 0; k < 2; ++k)
+        {
+            Vector3 axis(random(-1, 1), random(-1, 1), random(-1, 1));
+            axis.normalise();
+            q[k].FromAngleAxis(Radian(random(0, Math::TWO_PI)), axis);
+        }
+        Real t = (n % 5) == 0 ? Real(n % 2) : random(0, 1);
+        weights[n] = t;
+
+        for (size_t c = 0; c < 3; ++c)
+        {
+            k1[c * 4] = random(-10, 10);
+            k2[c * 4] = random(-10, 10);
+            k1[28 + c * 4] = random(0.5f, 2.0f);
+            k2[28 + c * 4] = random(0.5f, 2.0f);
+            e[c * 4] = k1[c * 4] + (k2[c * 4] - k1[c * 4]) * t;
+            e[28 + c * 4] = k1[28 + c * 4] + (k2[28 + c * 4] - k1[28 + c * 4]) * t;
+        }
+        for (size_t c = 0; c < 4; ++c)
+        {
+            k1[12 + c * 4] = q[0][c];
+            k2[12 + c * 4] = q[1][c];
+        }
+        Quaternion r = Quaternion::nlerp(t, q[0], q[1], true);
+        for (size_t c = 0; c < 4; ++c)
+            e[12 + c * 4] = r[c];
+    }
+
+    OptimisedUtilList impls = mCandidates;
+    impls.push_back(mGeneral);
+    float* dest = allocate(numBlocks * 40);
+    for (size_t i = 0; i < impls.size(); ++i)
+    {
+        impls[i]->interpolateNodeTransforms(weights, keys1, keys2, dest, numBlocks);
+        CPPUNIT_ASSERT(allClose(expected, dest, numBlocks * 40, 1e-5f));
+    }
+
+    // in place, over the first keyframe
+    impls[0]->interpolateNodeTransforms(weights, keys1, keys2, keys1, numBlocks);
+    CPPUNIT_ASSERT(allClose(expected, keys1, numBlocks * 40, 1e-5f));
+}
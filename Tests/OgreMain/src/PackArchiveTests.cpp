@@ -0,0 +1,409 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "PackArchiveTests.h"
+#include "ArchiveTestUtils.h"
+#include "OgreFileSystem.h"
+#include "OgreCommon.h"
+#include "OgreStringConverter.h"
+
+#include "UnitTestSuite.h"
+
+#include <cstdio>
+#include <fstream>
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+#include "macUtils.h"
+#endif
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION( PackArchiveTests );
+
+namespace
+{
+    const char* const readme =
+        "this is line 1 of the readme\n"
+        "this is line 2 of the readme\n"
+        "this is line 3 of the readme\n";
+
+    /* Material repeated 4 times, and the block the reference lz4 command line
+       tool (v1.9.4, lz4 -12 -BD --no-frame-crc) compressed it to, taken out of
+       the frame it writes.
+    */
+    const char* const referenceMaterial =
+        "material Ogre/PackTest\n{\n    technique\n    {\n        pass\n"
+        "        {\n            diffuse 1 1 1\n        }\n    }\n}\n";
+    const uchar referenceBlock[] =
+    {
+        0xf1, 0x17, 0x6d, 0x61, 0x74, 0x65, 0x72, 0x69, 0x61, 0x6c, 0x20, 0x4f,
+        0x67, 0x72, 0x65, 0x2f, 0x50, 0x61, 0x63, 0x6b, 0x54, 0x65, 0x73, 0x74,
+        0x0a, 0x7b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x74, 0x65, 0x63, 0x68, 0x6e,
+        0x69, 0x71, 0x75, 0x65, 0x0e, 0x00, 0x02, 0x14, 0x00, 0x00, 0x01, 0x00,
+        0x45, 0x70, 0x61, 0x73, 0x73, 0x0d, 0x00, 0x06, 0x17, 0x00, 0x00, 0x01,
+        0x00, 0x90, 0x64, 0x69, 0x66, 0x66, 0x75, 0x73, 0x65, 0x20, 0x31, 0x02,
+        0x00, 0x05, 0x1a, 0x00, 0x22, 0x7d, 0x0a, 0x06, 0x00, 0x2f, 0x7d, 0x0a,
+        0x70, 0x00, 0xff, 0x39, 0x50, 0x20, 0x7d, 0x0a, 0x7d, 0x0a
+    };
+
+    void writeUInt(vector<char>::type& data, size_t offset, uint64 value, size_t bytes)
+    {
+        for (size_t i = 0; i < bytes; ++i)
+            data[offset + i] = static_cast<char>(value >> (i * 8));
+    }
+    uint64 readUInt(const vector<char>::type& data, size_t offset, size_t bytes)
+    {
+        uint64 value = 0;
+        for (size_t i = 0; i < bytes; ++i)
+            value |= static_cast<uint64>(static_cast<uchar>(data[offset + i])) << (i * 8);
+        return value;
+    }
+
+    DataStreamPtr makeStream(const String& contents)
+    {
+        MemoryDataStream* stream = OGRE_NEW MemoryDataStream(contents.size());
+        if (!contents.empty())
+            memcpy(stream->getPtr(), contents.data(), contents.size());
+        return DataStreamPtr(stream);
+    }
+}
+
+//--------------------------------------------------------------------------
+void PackArchiveTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+    mTestPath = macBundlePath() + "/Contents/Resources/Media/misc/ArchiveTest";
+#elif OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+    mTestPath = "../../Tests/OgreMain/misc/ArchiveTest";
+#else
+    mTestPath = "./Tests/OgreMain/misc/ArchiveTest";
+#endif
+    mPackPath = "PackArchiveTest.pack";
+
+    // Spans many chunks and compresses well
+    mCompressible.clear();
+    for (size_t i = 0; mCompressible.size() < 200000; ++i)
+        mCompressible += "vertex " + StringConverter::toString(i % 97) + " 0.5 1.0 -2.25\n";
+
+    // Doesn't compress at all
+    mNoise.resize(50000);
+    uint32 seed = 12345;
+    for (size_t i = 0; i < mNoise.size(); ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        mNoise[i] = static_cast<char>(seed >> 24);
+    }
+}
+//--------------------------------------------------------------------------
+void PackArchiveTests::tearDown()
+{
+    std::remove(mPackPath.c_str());
+}
+//--------------------------------------------------------------------------
+void PackArchiveTests::writePack(PackArchive::Codec codec)
+{
+    // Small chunks, so files start and end in the middle of them
+    PackArchiveWriter writer(mPackPath, codec, 4096);
+    writer.addFile("readme.txt", makeStream(readme));
+    writer.addFile("Models/Level1/crate.mesh", makeStream(mCompressible));
+    writer.addFile("empty.txt", makeStream(""));
+    writer.addFile("Models\\Level1\\noise.bin", makeStream(mNoise));
+    writer.addFile("Models/Level2/tiny.material", makeStream("material Tiny {}"));
+    writer.finish();
+}
+//--------------------------------------------------------------------------
+PackArchive* PackArchiveTests::loadPack()
+{
+    PackArchive* arch = OGRE_NEW PackArchive(mPackPath, "Pack");
+    arch->load();
+    return arch;
+}
+//--------------------------------------------------------------------------
+void PackArchiveTests::testListRecursive()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    writePack(PackArchive::CODEC_LZ4);
+    PackArchive* arch = loadPack();
+
+    // Files are listed in the order they were added
+    StringVectorPtr vec = arch->list(true);
+    CPPUNIT_ASSERT_EQUAL((size_t)5, vec->size());
+    CPPUNIT_ASSERT_EQUAL(String("readme.txt"), vec->at(0));
+    CPPUNIT_ASSERT_EQUAL(String("Models/Level1/crate.mesh"), vec->at(1));
+    CPPUNIT_ASSERT_EQUAL(String("empty.txt"), vec->at(2));
+    CPPUNIT_ASSERT_EQUAL(String("Models/Level1/noise.bin"), vec->at(3));
+    CPPUNIT_ASSERT_EQUAL(String("Models/Level2/tiny.material"), vec->at(4));
+
+    vec = arch->list(false);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, vec->size());
+
+    vec = arch->list(true, true);
+    CPPUNIT_ASSERT_EQUAL((size_t)3, vec->size());
+    CPPUNIT_ASSERT_EQUAL(String("Models"), vec->at(0));
+    CPPUNIT_ASSERT_EQUAL(String("Models/Level1"), vec->at(1));
+    CPPUNIT_ASSERT_EQUAL(String("Models/Level2"), vec->at(2));
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void PackArchiveTests::testListFileInfoRecursive()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    writePack(PackArchive::CODEC_LZ4);
+    PackArchive* arch = loadPack();
+    FileInfoListPtr vec = arch->listFileInfo(true);
+
+    CPPUNIT_ASSERT_EQUAL((size_t)5, vec->size());
+    FileInfo& fi1 = vec->at(0);
+    CPPUNIT_ASSERT_EQUAL(String("readme.txt"), fi1.filename);
+    CPPUNIT_ASSERT_EQUAL(String("readme.txt"), fi1.basename);
+    CPPUNIT_ASSERT_EQUAL(BLANKSTRING, fi1.path);
+    CPPUNIT_ASSERT_EQUAL(strlen(readme), fi1.uncompressedSize);
+
+    FileInfo& fi2 = vec->at(1);
+    CPPUNIT_ASSERT_EQUAL(String("Models/Level1/crate.mesh"), fi2.filename);
+    CPPUNIT_ASSERT_EQUAL(String("crate.mesh"), fi2.basename);
+    CPPUNIT_ASSERT_EQUAL(String("Models/Level1/"), fi2.path);
+    CPPUNIT_ASSERT_EQUAL(mCompressible.size(), fi2.uncompressedSize);
+
+    FileInfo& fi3 = vec->at(2);
+    CPPUNIT_ASSERT_EQUAL(String("empty.txt"), fi3.filename);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, fi3.uncompressedSize);
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void PackArchiveTests::testFindNonRecursive()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    writePack(PackArchive::CODEC_LZ4);
+    PackArchive* arch = loadPack();
+
+    StringVectorPtr vec = arch->find("*.txt", false);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, vec->size());
+    CPPUNIT_ASSERT_EQUAL(String("readme.txt"), vec->at(0));
+    CPPUNIT_ASSERT_EQUAL(String("empty.txt"), vec->at(1));
+
+    vec = arch->find("*.MESH", true);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, vec->size());
+    CPPUNIT_ASSERT_EQUAL(String("Models/Level1/crate.mesh"), vec->at(0));
+
+    vec = arch->find("Models/Level2/*", false);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, vec->size());
+    CPPUNIT_ASSERT_EQUAL(String("Models/Level2/tiny.material"), vec->at(0));
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void PackArchiveTests::testExists()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    writePack(PackArchive::CODEC_LZ4);
+    PackArchive* arch = loadPack();
+
+    CPPUNIT_ASSERT(arch->exists("readme.txt"));
+    CPPUNIT_ASSERT(arch->exists("README.TXT"));
+    CPPUNIT_ASSERT(arch->exists("models/level1/CRATE.mesh"));
+    CPPUNIT_ASSERT(arch->exists("Models\\Level1\\noise.bin"));
+    CPPUNIT_ASSERT(!arch->exists("crate.mesh"));
+    CPPUNIT_ASSERT(!arch->exists("Models/Level1"));
+    CPPUNIT_ASSERT(arch->open("missing.txt").isNull());
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void PackArchiveTests::testFileRead()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    writePack(PackArchive::CODEC_LZ4);
+    PackArchive* arch = loadPack();
+
+    DataStreamPtr stream = arch->open("readme.txt");
+    CPPUNIT_ASSERT_EQUAL(String("this is line 1 of the readme"), stream->getLine());
+    CPPUNIT_ASSERT_EQUAL(String("this is line 2 of the readme"), stream->getLine());
+    CPPUNIT_ASSERT_EQUAL(String("this is line 3 of the readme"), stream->getLine());
+    CPPUNIT_ASSERT(stream->eof());
+
+    stream = arch->open("Empty.txt");
+    CPPUNIT_ASSERT(!stream.isNull());
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stream->size());
+
+    stream = arch->open("models/level2/tiny.material");
+    CPPUNIT_ASSERT_EQUAL(String("material Tiny {}"), stream->getAsString());
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void PackArchiveTests::testMultiChunkFile()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    writePack(PackArchive::CODEC_LZ4);
+    PackArchive* arch = loadPack();
+
+    DataStreamPtr stream = arch->open("Models/Level1/crate.mesh");
+    CPPUNIT_ASSERT_EQUAL(mCompressible.size(), stream->size());
+    CPPUNIT_ASSERT(stream->getAsString() == mCompressible);
+
+    OGRE_DELETE arch;
+
+    // The pack is smaller than its largest file
+    std::ifstream pack(mPackPath.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+    CPPUNIT_ASSERT(static_cast<size_t>(pack.tellg()) < mCompressible.size());
+}
+//--------------------------------------------------------------------------
+void PackArchiveTests::testIncompressibleFile()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    writePack(PackArchive::CODEC_LZ4);
+    PackArchive* arch = loadPack();
+
+    DataStreamPtr stream = arch->open("Models/Level1/noise.bin");
+    CPPUNIT_ASSERT_EQUAL(mNoise.size(), stream->size());
+    CPPUNIT_ASSERT(stream->getAsString() == mNoise);
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void PackArchiveTests::testCodecs()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    PackArchive::Codec codecs[] = { PackArchive::CODEC_NONE, PackArchive::CODEC_LZ4, PackArchive::CODEC_ZLIB };
+    for (size_t i = 0; i < 3; ++i)
+    {
+        if (!PackArchive::isCodecSupported(codecs[i]))
+        {
+            CPPUNIT_ASSERT_THROW(PackArchiveWriter(mPackPath, codecs[i]), InvalidParametersException);
+            continue;
+        }
+
+        writePack(codecs[i]);
+        PackArchive* arch = loadPack();
+        CPPUNIT_ASSERT_EQUAL(String(readme), arch->open("readme.txt")->getAsString());
+        CPPUNIT_ASSERT(arch->open("Models/Level1/crate.mesh")->getAsString() == mCompressible);
+        CPPUNIT_ASSERT(arch->open("Models/Level1/noise.bin")->getAsString() == mNoise);
+        OGRE_DELETE arch;
+    }
+}
+//--------------------------------------------------------------------------
+void PackArchiveTests::testAddArchive()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    FileSystemArchive folder(mTestPath, "FileSystem", true);
+    folder.load();
+    {
+        PackArchiveWriter writer(mPackPath);
+        CPPUNIT_ASSERT_EQUAL((size_t)6, writer.addArchive(&folder));
+    }
+
+    PackArchive* arch = loadPack();
+    CPPUNIT_ASSERT_EQUAL((size_t)6, arch->list(true)->size());
+    CPPUNIT_ASSERT_EQUAL(folder.open("rootfile.txt")->getAsString(),
+        arch->open("rootfile.txt")->getAsString());
+    CPPUNIT_ASSERT_EQUAL(folder.open("level1/materials/scripts/file2.material")->getAsString(),
+        arch->open("level1/materials/scripts/file2.material")->getAsString());
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+void PackArchiveTests::testDuplicateFile()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    PackArchiveWriter writer(mPackPath);
+    writer.addFile("Models/crate.mesh", makeStream("crate"));
+    CPPUNIT_ASSERT_THROW(writer.addFile("models\\Crate.mesh", makeStream("crate")), ItemIdentityException);
+    writer.finish();
+    CPPUNIT_ASSERT_THROW(writer.addFile("barrel.mesh", makeStream("barrel")), InvalidStateException);
+}
+//--------------------------------------------------------------------------
+void PackArchiveTests::testConcurrentOpen()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    writePack(PackArchive::CODEC_LZ4);
+    PackArchive* arch = loadPack();
+
+    // Every thread reads both files while the others do
+    const String filenames[2] = { "Models/Level1/noise.bin", "Models/Level1/crate.mesh" };
+    const String expected[2] = { mNoise, mCompressible };
+    CPPUNIT_ASSERT_EQUAL((size_t)0, readArchiveConcurrently(arch, filenames, expected, 2, 8, 50));
+
+    OGRE_DELETE arch;
+}
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+void PackArchiveTests::testReferenceLz4Block()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    String material;
+    for (size_t i = 0; i < 4; ++i)
+        material += referenceMaterial;
+
+    // Two files in a single stored chunk, so one of them only needs part of it
+    {
+        PackArchiveWriter writer(mPackPath, PackArchive::CODEC_NONE);
+        writer.addFile("first.material", makeStream(material.substr(0, 100)));
+        writer.addFile("second.material", makeStream(material.substr(100)));
+        writer.finish();
+    }
+
+    // Swap the chunk for the block from the reference tool
+    vector<char>::type pack;
+    {
+        std::ifstream file(mPackPath.c_str(), std::ios::in | std::ios::binary);
+        pack.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    size_t contentsOffset = static_cast<size_t>(readUInt(pack, 32, 8));
+    size_t chunkRecord = contentsOffset + 2 * 32;
+    size_t chunkOffset = static_cast<size_t>(readUInt(pack, chunkRecord, 8));
+    CPPUNIT_ASSERT_EQUAL((uint64)material.size(), readUInt(pack, chunkRecord + 8, 4));
+    memcpy(&pack[chunkOffset], referenceBlock, sizeof(referenceBlock));
+    writeUInt(pack, chunkRecord + 8, sizeof(referenceBlock), 4);
+    writeUInt(pack, chunkRecord + 12, PackArchive::CODEC_LZ4, 2);
+    {
+        std::ofstream file(mPackPath.c_str(), std::ios::out | std::ios::binary);
+        file.write(&pack[0], pack.size());
+    }
+
+    PackArchive* arch = loadPack();
+    CPPUNIT_ASSERT_EQUAL(material.substr(0, 100), arch->open("first.material")->getAsString());
+    CPPUNIT_ASSERT_EQUAL(material.substr(100), arch->open("second.material")->getAsString());
+    OGRE_DELETE arch;
+}
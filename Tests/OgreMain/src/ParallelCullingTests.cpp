@@ -0,0 +1,265 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ParallelCullingTests.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreMovableObject.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+#ifdef OGRE_BUILD_RENDERSYSTEM_NULL
+CPPUNIT_TEST_SUITE_REGISTRATION(ParallelCullingTests);
+#endif
+
+namespace
+{
+    /// Object counting the times it is queued, and whether it was to the main queue
+    class CountingObject : public MovableObject
+    {
+    public:
+        size_t mQueued;
+        bool mQueuedToMain;
+        bool mConcurrent;
+        AxisAlignedBox mBox;
+
+        CountingObject(const String& name, bool concurrent)
+            : MovableObject(name), mQueued(0), mQueuedToMain(false), mConcurrent(concurrent)
+            , mBox(-Vector3::UNIT_SCALE, Vector3::UNIT_SCALE)
+        {
+            setCastShadows(concurrent);
+        }
+
+        const String& getMovableType(void) const
+        {
+            static String type = "CountingObject";
+            return type;
+        }
+        const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+        Real getBoundingRadius(void) const { return Math::Sqrt(3); }
+        void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) {}
+        bool _canUpdateRenderQueueConcurrently(void) const { return mConcurrent; }
+        void _updateRenderQueue(RenderQueue* queue)
+        {
+            ++mQueued;
+            mQueuedToMain = queue == mManager->getRenderQueue();
+        }
+    };
+
+#if OGRE_THREAD_SUPPORT
+    /// Illumination passes of a technique as seen by one thread
+    struct IlluminationPassesResult
+    {
+        IlluminationPass* first;
+        size_t count;
+    };
+
+    /// Requests the illumination passes of a technique, like queueing does
+    struct IlluminationPassesRequest
+    {
+        Technique* technique;
+        IlluminationPassesResult* result;
+
+        void operator()()
+        {
+            Technique::IlluminationPassIterator i = technique->getIlluminationPassIterator();
+            result->first = i.hasMoreElements() ? i.peekNext() : 0;
+            result->count = 0;
+            for ( ; i.hasMoreElements(); i.moveNext())
+                ++result->count;
+        }
+    };
+#endif
+}
+
+//--------------------------------------------------------------------------
+void ParallelCullingTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = mFixture.setUp();
+
+    mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+    mCamera = mSceneMgr->createCamera("ParallelCullingTests");
+    mCamera->setPosition(Vector3(0, 0, 200));
+    mCamera->lookAt(Vector3::ZERO);
+    mCamera->setNearClipDistance(1);
+    mCamera->setFarClipDistance(1000);
+
+    // 5^1 + ... + 5^5 = 3905 nodes spread around the camera target
+    createHierarchy(mSceneMgr->getRootSceneNode(), 5, 5);
+    mSceneMgr->_updateSceneGraph(mCamera);
+}
+//--------------------------------------------------------------------------
+void ParallelCullingTests::tearDown()
+{
+    mSceneMgr->clearScene();
+    for (size_t i = 0; i < mObjects.size(); ++i)
+        OGRE_DELETE mObjects[i];
+    mObjects.clear();
+    mRoot->destroySceneManager(mSceneMgr);
+    mFixture.tearDown();
+}
+//--------------------------------------------------------------------------
+void ParallelCullingTests::createHierarchy(SceneNode* parent, size_t fanout, size_t depth)
+{
+    if (!depth)
+        return;
+
+    for (size_t i = 0; i < fanout; ++i)
+    {
+        // Half of the subtrees leave the frustum
+        SceneNode* child = parent->createChildSceneNode(
+            Vector3(Real(i) * 40 - 40, Real(depth), Real(i) * 10));
+        // One object in three must be queued on the calling thread
+        size_t index = mObjects.size();
+        CountingObject* obj = OGRE_NEW CountingObject(
+            "CountingObject" + StringConverter::toString(index), index % 3 != 0);
+        obj->_notifyManager(mSceneMgr);
+        child->attachObject(obj);
+        mObjects.push_back(obj);
+        createHierarchy(child, fanout, depth - 1);
+    }
+}
+//--------------------------------------------------------------------------
+void ParallelCullingTests::setWorkerThreadCount(size_t threads)
+{
+    // The calling thread takes part in the search, so it needs one worker less
+    DefaultWorkQueue* wq = static_cast<DefaultWorkQueue*>(mRoot->getWorkQueue());
+    wq->setWorkerThreadCount(std::max(threads, (size_t)2) - 1);
+    wq->startup(true);
+    mSceneMgr->setCullingThreadCount(threads);
+}
+//--------------------------------------------------------------------------
+void ParallelCullingTests::findVisibleObjects(bool onlyShadowCasters, 
+    vector<size_t>::type& counts, VisibleObjectsBoundsInfo& bounds)
+{
+    for (size_t i = 0; i < mObjects.size(); ++i)
+        static_cast<CountingObject*>(mObjects[i])->mQueued = 0;
+
+    bounds.reset();
+    mSceneMgr->_findVisibleObjects(mCamera, &bounds, onlyShadowCasters);
+
+    counts.clear();
+    for (size_t i = 0; i < mObjects.size(); ++i)
+    {
+        CountingObject* obj = static_cast<CountingObject*>(mObjects[i]);
+        counts.push_back(obj->mQueued);
+        // objects which cannot be queued concurrently end up in the main queue
+        if (obj->mQueued && !obj->mConcurrent)
+            CPPUNIT_ASSERT(obj->mQueuedToMain);
+    }
+}
+//--------------------------------------------------------------------------
+void ParallelCullingTests::testParallelMatchesSerial()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    vector<size_t>::type serialCounts, counts;
+    VisibleObjectsBoundsInfo serialBounds, bounds;
+    findVisibleObjects(false, serialCounts, serialBounds);
+
+    size_t visible = std::count(serialCounts.begin(), serialCounts.end(), (size_t)1);
+    CPPUNIT_ASSERT(visible > 0 && visible < mObjects.size());
+    CPPUNIT_ASSERT(std::count(serialCounts.begin(), serialCounts.end(), (size_t)0) + 
+        visible == mObjects.size());
+
+    setWorkerThreadCount(4);
+    findVisibleObjects(false, counts, bounds);
+
+    CPPUNIT_ASSERT(counts == serialCounts);
+    CPPUNIT_ASSERT(bounds.aabb == serialBounds.aabb);
+    CPPUNIT_ASSERT(bounds.receiverAabb == serialBounds.receiverAabb);
+    CPPUNIT_ASSERT_EQUAL(serialBounds.minDistance, bounds.minDistance);
+    CPPUNIT_ASSERT_EQUAL(serialBounds.maxDistance, bounds.maxDistance);
+}
+//--------------------------------------------------------------------------
+void ParallelCullingTests::testShadowCastersOnly()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    vector<size_t>::type serialCounts, counts;
+    VisibleObjectsBoundsInfo serialBounds, bounds;
+    findVisibleObjects(true, serialCounts, serialBounds);
+
+    setWorkerThreadCount(3);
+    findVisibleObjects(true, counts, bounds);
+
+    CPPUNIT_ASSERT(counts == serialCounts);
+    CPPUNIT_ASSERT(bounds.aabb == serialBounds.aabb);
+    CPPUNIT_ASSERT_EQUAL(serialBounds.minDistanceInFrustum, bounds.minDistanceInFrustum);
+    CPPUNIT_ASSERT_EQUAL(serialBounds.maxDistanceInFrustum, bounds.maxDistanceInFrustum);
+}
+//--------------------------------------------------------------------------
+void ParallelCullingTests::testIlluminationPassesFromThreads()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+#if OGRE_THREAD_SUPPORT
+    MaterialPtr mat = MaterialManager::getSingleton().create("ParallelCullingTests",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME).staticCast<Material>();
+    Technique* technique = mat->createTechnique();
+    technique->createPass()->setIteratePerLight(true);
+    technique->createPass();
+
+    // All threads see the same passes, compiled once by whichever came first
+    const size_t numThreads = 4;
+    IlluminationPassesResult results[numThreads];
+    OGRE_THREAD_TYPE* threads[numThreads];
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        IlluminationPassesRequest request = { technique, &results[i] };
+        OGRE_THREAD_CREATE(thread, request);
+        threads[i] = thread;
+    }
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        threads[i]->join();
+        OGRE_THREAD_DESTROY(threads[i]);
+    }
+
+    Technique::IlluminationPassIterator passes = technique->getIlluminationPassIterator();
+    CPPUNIT_ASSERT(passes.hasMoreElements());
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(passes.peekNext(), results[i].first);
+        CPPUNIT_ASSERT_EQUAL(results[0].count, results[i].count);
+    }
+    CPPUNIT_ASSERT(results[0].count > 1);
+
+    MaterialManager::getSingleton().remove(mat->getHandle());
+#endif
+}
+//--------------------------------------------------------------------------
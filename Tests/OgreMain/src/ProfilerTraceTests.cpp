@@ -0,0 +1,245 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ProfilerTraceTests.h"
+#include "OgreProfiler.h"
+#include "OgreTimer.h"
+#include "Threading/OgreThreadHeaders.h"
+
+#include "UnitTestSuite.h"
+
+#include <sstream>
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ProfilerTraceTests);
+
+//--------------------------------------------------------------------------
+void ProfilerTraceTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mTimer = OGRE_NEW Timer();
+    mProfiler = OGRE_NEW Profiler();
+    mProfiler->setTimer(mTimer);
+}
+//--------------------------------------------------------------------------
+void ProfilerTraceTests::tearDown()
+{
+    OGRE_DELETE mProfiler;
+    OGRE_DELETE mTimer;
+}
+//--------------------------------------------------------------------------
+void ProfilerTraceTests::testBufferWrapAround()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // capacity is rounded up to a power of two
+    ProfileTraceBuffer buffer(5, 0);
+    for (uint32 i = 0; i < 20; ++i)
+        buffer.push(i, i, (i & 1) == 0);
+
+    ProfileTraceBuffer::EventList events;
+    size_t lost = buffer.getEvents(events);
+
+    // only the newest events survive, oldest first
+    CPPUNIT_ASSERT_EQUAL((size_t)8, events.size());
+    CPPUNIT_ASSERT_EQUAL((size_t)12, lost);
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL((ulong)(12 + i), events[i].time);
+        CPPUNIT_ASSERT_EQUAL((uint32)(12 + i), events[i].nameId);
+        CPPUNIT_ASSERT_EQUAL(((12 + i) & 1) == 0, events[i].begin);
+    }
+}
+//--------------------------------------------------------------------------
+void ProfilerTraceTests::testBufferClear()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ProfileTraceBuffer buffer(16, 3);
+    CPPUNIT_ASSERT_EQUAL((uint32)3, buffer.getThreadIndex());
+
+    ProfileTraceBuffer::EventList events;
+    CPPUNIT_ASSERT_EQUAL((size_t)0, buffer.getEvents(events));
+    CPPUNIT_ASSERT(events.empty());
+
+    buffer.push(1, 0, true);
+    buffer.push(2, 0, false);
+    buffer.clear();
+    buffer.push(3, 1, true);
+
+    buffer.getEvents(events);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, events.size());
+    CPPUNIT_ASSERT_EQUAL((ulong)3, events[0].time);
+    CPPUNIT_ASSERT_EQUAL((uint32)1, events[0].nameId);
+}
+//--------------------------------------------------------------------------
+void ProfilerTraceTests::testNameInterning()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    uint32 a = mProfiler->getTraceNameId("A");
+    uint32 b = mProfiler->getTraceNameId("B");
+    CPPUNIT_ASSERT(a != b);
+    CPPUNIT_ASSERT_EQUAL(a, mProfiler->getTraceNameId("A"));
+    CPPUNIT_ASSERT_EQUAL(String("A"), mProfiler->getTraceName(a));
+    CPPUNIT_ASSERT_EQUAL(String("B"), mProfiler->getTraceName(b));
+    CPPUNIT_ASSERT_EQUAL(String(), mProfiler->getTraceName(b + 100));
+}
+//--------------------------------------------------------------------------
+void ProfilerTraceTests::testInternedName()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ProfileName name("Interned");
+    CPPUNIT_ASSERT_EQUAL(String("Interned"), name.name);
+    CPPUNIT_ASSERT_EQUAL(mProfiler->getTraceNameId("Interned"), name.traceNameId);
+
+    // the identifiers outlive the profiler, as the macros keep them in statics
+    OGRE_DELETE mProfiler;
+    mProfiler = OGRE_NEW Profiler();
+    mProfiler->setTimer(mTimer);
+    CPPUNIT_ASSERT_EQUAL(String("Interned"), mProfiler->getTraceName(name.traceNameId));
+
+    mProfiler->setTraceEnabled(true);
+    {
+        Profile profile(name);
+    }
+    mProfiler->beginProfile(name);
+    mProfiler->endProfile("Interned");
+
+    std::stringstream stream;
+    mProfiler->exportTrace(stream);
+    String trace = stream.str();
+
+    // both ways of naming the profile give the same events
+    size_t count = 0;
+    for (size_t pos = trace.find("\"name\":\"Interned\""); pos != String::npos;
+         pos = trace.find("\"name\":\"Interned\"", pos + 1))
+        ++count;
+    CPPUNIT_ASSERT_EQUAL((size_t)4, count);
+}
+//--------------------------------------------------------------------------
+void ProfilerTraceTests::testExportTrace()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // tracing works without enabling the hierarchical profiler
+    mProfiler->setTraceEnabled(true);
+    mProfiler->setTraceThreadName("Test \"main\"");
+    mProfiler->beginProfile("Outer");
+    mProfiler->beginProfile("Inner");
+    mProfiler->endProfile("Inner");
+    mProfiler->endProfile("Outer");
+    mProfiler->setTraceEnabled(false);
+    mProfiler->beginProfile("Ignored");
+    mProfiler->endProfile("Ignored");
+
+    std::stringstream stream;
+    mProfiler->exportTrace(stream);
+    String trace = stream.str();
+
+    CPPUNIT_ASSERT(trace.find("\"traceEvents\"") != String::npos);
+    CPPUNIT_ASSERT(trace.find("Test \\\"main\\\"") != String::npos);
+    CPPUNIT_ASSERT(trace.find("\"name\":\"Outer\"") != String::npos);
+    CPPUNIT_ASSERT(trace.find("\"name\":\"Inner\"") != String::npos);
+    CPPUNIT_ASSERT(trace.find("Ignored") == String::npos);
+
+    // two begin and two end events
+    size_t begins = 0, ends = 0;
+    for (size_t pos = 0; (pos = trace.find("\"ph\":\"B\"", pos)) != String::npos; ++pos)
+        ++begins;
+    for (size_t pos = 0; (pos = trace.find("\"ph\":\"E\"", pos)) != String::npos; ++pos)
+        ++ends;
+    CPPUNIT_ASSERT_EQUAL((size_t)2, begins);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, ends);
+
+    mProfiler->clearTrace();
+    stream.str("");
+    mProfiler->exportTrace(stream);
+    CPPUNIT_ASSERT(stream.str().find("Outer") == String::npos);
+}
+//--------------------------------------------------------------------------
+#if OGRE_THREAD_SUPPORT
+/** Records a few profiles from the thread it runs on. */
+struct TraceWorker
+{
+    void operator()()
+    {
+        Profiler::getSingleton().setTraceThreadName("Worker");
+        static const ProfileName interned("WorkerInterned");
+        for (int i = 0; i < 3; ++i)
+        {
+            Profile profile("WorkerProfile");
+            Profile internedProfile(interned);
+        }
+    }
+};
+#endif
+//--------------------------------------------------------------------------
+void ProfilerTraceTests::testWorkerThread()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+#if OGRE_THREAD_SUPPORT
+    mProfiler->setTraceEnabled(true);
+    mProfiler->beginProfile("Main");
+    TraceWorker worker;
+    OGRE_THREAD_CREATE(thread, worker);
+    thread->join();
+    OGRE_THREAD_DESTROY(thread);
+    mProfiler->endProfile("Main");
+
+    std::stringstream stream;
+    mProfiler->exportTrace(stream);
+    String trace = stream.str();
+
+    // each thread has its own track, the worker's created when it first recorded
+    CPPUNIT_ASSERT(trace.find("\"tid\":0,\"args\":{\"name\":\"Main\"}") != String::npos);
+    CPPUNIT_ASSERT(trace.find("\"tid\":1,\"args\":{\"name\":\"Worker\"}") != String::npos);
+
+    const char* names[] = { "\"name\":\"WorkerProfile\"", "\"name\":\"WorkerInterned\"" };
+    for (size_t n = 0; n < 2; ++n)
+    {
+        size_t count = 0;
+        for (size_t pos = trace.find(names[n]); pos != String::npos; pos = trace.find(names[n], pos + 1))
+        {
+            String line = trace.substr(pos, trace.find('\n', pos) - pos);
+            CPPUNIT_ASSERT(line.find("\"tid\":1}") != String::npos);
+            ++count;
+        }
+        CPPUNIT_ASSERT_EQUAL((size_t)6, count);
+    }
+
+    size_t mainPos = trace.find("\"name\":\"Main\",\"ph\":\"B\"");
+    CPPUNIT_ASSERT(mainPos != String::npos);
+    CPPUNIT_ASSERT(trace.find("\"tid\":0}", mainPos) < trace.find('\n', mainPos));
+#endif
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,344 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "RenderQueueEntryCacheTests.h"
+#include "OgreRoot.h"
+#include "OgreRenderWindow.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreMovableObject.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreRenderQueueSortingGrouping.h"
+#include "OgreEntity.h"
+#include "OgreSubEntity.h"
+#include "OgreMeshManager.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+#ifdef OGRE_BUILD_RENDERSYSTEM_NULL
+CPPUNIT_TEST_SUITE_REGISTRATION(RenderQueueEntryCacheTests);
+#endif
+
+namespace
+{
+    /// Renderable using the first technique of its material
+    class TestRenderable : public Renderable, public RenderQueueAlloc
+    {
+    public:
+        MaterialPtr mMaterial;
+        LightList mLights;
+
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+        Technique* getTechnique(void) const { return mMaterial->getTechnique(0); }
+        void getRenderOperation(RenderOperation& op) {}
+        void getWorldTransforms(Matrix4* xform) const { *xform = Matrix4::IDENTITY; }
+        Real getSquaredViewDepth(const Camera* cam) const { return 0; }
+        const LightList& getLights(void) const { return mLights; }
+    };
+
+    /// Object queueing two renderables, with a signature set by the test
+    class SignedObject : public MovableObject
+    {
+    public:
+        TestRenderable mRenderables[2];
+        uint32 mSignature;
+        size_t mUpdates;
+        AxisAlignedBox mBox;
+
+        SignedObject(const String& name, const MaterialPtr& mat, uint32 signature)
+            : MovableObject(name), mSignature(signature), mUpdates(0)
+            , mBox(-Vector3::UNIT_SCALE, Vector3::UNIT_SCALE)
+        {
+            mRenderables[0].mMaterial = mRenderables[1].mMaterial = mat;
+        }
+
+        const String& getMovableType(void) const
+        {
+            static String type = "SignedObject";
+            return type;
+        }
+        const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+        Real getBoundingRadius(void) const { return Math::Sqrt(3); }
+        void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) {}
+        uint32 _getRenderQueueSignature(void) const { return mSignature; }
+        void _updateRenderQueue(RenderQueue* queue)
+        {
+            ++mUpdates;
+            queue->addRenderable(&mRenderables[0]);
+            queue->addRenderable(&mRenderables[1], RENDER_QUEUE_MAIN, 50);
+        }
+    };
+
+    /// Visitor counting the queued renderables
+    class CountingVisitor : public QueuedRenderableVisitor
+    {
+    public:
+        size_t mCount;
+
+        CountingVisitor() : mCount(0) {}
+
+        void visit(RenderablePass* rp) { ++mCount; }
+        bool visit(const Pass* p) { return true; }
+        void visit(Renderable* r) { ++mCount; }
+    };
+
+    size_t countQueuedRenderables(RenderQueue* queue)
+    {
+        CountingVisitor visitor;
+        RenderQueue::QueueGroupIterator g = queue->_getQueueGroupIterator();
+        while (g.hasMoreElements())
+        {
+            RenderQueueGroup::PriorityMapIterator p = g.getNext()->getIterator();
+            while (p.hasMoreElements())
+            {
+                p.getNext()->getSolidsBasic().acceptVisitor(&visitor, 
+                    QueuedRenderableCollection::OM_PASS_GROUP);
+            }
+        }
+        return visitor.mCount;
+    }
+}
+
+//--------------------------------------------------------------------------
+void RenderQueueEntryCacheTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    // queued materials are compiled against the render system capabilities,
+    // which are only known once it is initialised with a window
+    mRoot = mFixture.setUp("RenderQueueEntryCacheTests");
+
+    mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+    mSceneMgr->setRenderQueueEntryCacheEnabled(true);
+    mCamera = mSceneMgr->createCamera("RenderQueueEntryCacheTests");
+    mCamera->setPosition(Vector3(0, 0, 200));
+    mCamera->lookAt(Vector3::ZERO);
+    mCamera->setNearClipDistance(1);
+    mCamera->setFarClipDistance(1000);
+
+    mMaterial = MaterialManager::getSingleton().create("RenderQueueEntryCacheTests", 
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME).staticCast<Material>();
+    mMaterial->createTechnique()->createPass();
+
+    // 10 objects in front of the camera, the last one always updating the queue
+    for (size_t i = 0; i < 10; ++i)
+    {
+        SignedObject* obj = OGRE_NEW SignedObject(
+            "SignedObject" + StringConverter::toString(i), mMaterial, i < 9 ? 1 : 0);
+        obj->_notifyManager(mSceneMgr);
+        mSceneMgr->getRootSceneNode()->createChildSceneNode(
+            Vector3(Real(i) * 5 - 25, 0, 0))->attachObject(obj);
+        mObjects.push_back(obj);
+    }
+    mSceneMgr->_updateSceneGraph(mCamera);
+}
+//--------------------------------------------------------------------------
+void RenderQueueEntryCacheTests::tearDown()
+{
+    mSceneMgr->clearScene();
+    for (size_t i = 0; i < mObjects.size(); ++i)
+        OGRE_DELETE mObjects[i];
+    mObjects.clear();
+    mMaterial.setNull();
+    mRoot->destroySceneManager(mSceneMgr);
+    mFixture.tearDown();
+}
+//--------------------------------------------------------------------------
+RenderQueue::EntryCacheStats RenderQueueEntryCacheTests::findVisibleObjects(void)
+{
+    RenderQueue* queue = mSceneMgr->getRenderQueue();
+    queue->clear();
+
+    VisibleObjectsBoundsInfo bounds;
+    queue->_beginEntryCachePass(mCamera);
+    mSceneMgr->_findVisibleObjects(mCamera, &bounds, false);
+    return queue->_endEntryCachePass();
+}
+//--------------------------------------------------------------------------
+size_t RenderQueueEntryCacheTests::takeUpdateCount(void)
+{
+    size_t updates = 0;
+    for (size_t i = 0; i < mObjects.size(); ++i)
+    {
+        updates += static_cast<SignedObject*>(mObjects[i])->mUpdates;
+        static_cast<SignedObject*>(mObjects[i])->mUpdates = 0;
+    }
+    return updates;
+}
+//--------------------------------------------------------------------------
+void RenderQueueEntryCacheTests::testReuseUnchangedObjects()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    RenderQueue::EntryCacheStats stats = findVisibleObjects();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.reusedRenderables);
+    CPPUNIT_ASSERT_EQUAL((size_t)20, stats.reinsertedRenderables);
+    CPPUNIT_ASSERT_EQUAL((size_t)10, stats.enteredObjects);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.leftObjects);
+    CPPUNIT_ASSERT_EQUAL((size_t)10, takeUpdateCount());
+    CPPUNIT_ASSERT_EQUAL((size_t)20, countQueuedRenderables(mSceneMgr->getRenderQueue()));
+
+    // Only the object without a signature updates the queue
+    stats = findVisibleObjects();
+    CPPUNIT_ASSERT_EQUAL((size_t)18, stats.reusedRenderables);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, stats.reinsertedRenderables);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.enteredObjects);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.leftObjects);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, takeUpdateCount());
+    CPPUNIT_ASSERT_EQUAL((size_t)20, countQueuedRenderables(mSceneMgr->getRenderQueue()));
+
+    // A changed signature makes the object update the queue again
+    static_cast<SignedObject*>(mObjects[3])->mSignature = 2;
+    stats = findVisibleObjects();
+    CPPUNIT_ASSERT_EQUAL((size_t)16, stats.reusedRenderables);
+    CPPUNIT_ASSERT_EQUAL((size_t)4, stats.reinsertedRenderables);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, takeUpdateCount());
+
+    // Another camera has entries of its own
+    Camera* other = mSceneMgr->createCamera("RenderQueueEntryCacheTestsOther");
+    other->setPosition(Vector3(0, 0, 200));
+    other->lookAt(Vector3::ZERO);
+    other->setNearClipDistance(1);
+    other->setFarClipDistance(1000);
+    RenderQueue* queue = mSceneMgr->getRenderQueue();
+    VisibleObjectsBoundsInfo bounds;
+    queue->clear();
+    queue->_beginEntryCachePass(other);
+    mSceneMgr->_findVisibleObjects(other, &bounds, false);
+    stats = queue->_endEntryCachePass();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.reusedRenderables);
+    CPPUNIT_ASSERT_EQUAL((size_t)10, takeUpdateCount());
+    mSceneMgr->destroyCamera(other);
+
+    stats = findVisibleObjects();
+    CPPUNIT_ASSERT_EQUAL((size_t)18, stats.reusedRenderables);
+}
+//--------------------------------------------------------------------------
+void RenderQueueEntryCacheTests::testObjectsEnteringAndLeaving()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    findVisibleObjects();
+    takeUpdateCount();
+
+    mObjects[2]->setVisible(false);
+    mObjects[5]->setVisible(false);
+    RenderQueue::EntryCacheStats stats = findVisibleObjects();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.enteredObjects);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, stats.leftObjects);
+    CPPUNIT_ASSERT_EQUAL((size_t)14, stats.reusedRenderables);
+    CPPUNIT_ASSERT_EQUAL((size_t)16, countQueuedRenderables(mSceneMgr->getRenderQueue()));
+    CPPUNIT_ASSERT_EQUAL((size_t)1, takeUpdateCount());
+
+    // Objects coming back were not queued by the previous pass
+    mObjects[5]->setVisible(true);
+    stats = findVisibleObjects();
+    CPPUNIT_ASSERT_EQUAL((size_t)1, stats.enteredObjects);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.leftObjects);
+    CPPUNIT_ASSERT_EQUAL((size_t)14, stats.reusedRenderables);
+    CPPUNIT_ASSERT_EQUAL((size_t)4, stats.reinsertedRenderables);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, takeUpdateCount());
+}
+//--------------------------------------------------------------------------
+void RenderQueueEntryCacheTests::testDestroyedPassInvalidates()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    findVisibleObjects();
+    takeUpdateCount();
+
+    // Cached techniques may belong to the destroyed passes
+    MaterialPtr mat = MaterialManager::getSingleton().create("RenderQueueEntryCacheTestsOther", 
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME).staticCast<Material>();
+    mat->createTechnique()->createPass();
+    mat->removeAllTechniques();
+
+    RenderQueue::EntryCacheStats stats = findVisibleObjects();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.reusedRenderables);
+    CPPUNIT_ASSERT_EQUAL((size_t)20, stats.reinsertedRenderables);
+    CPPUNIT_ASSERT_EQUAL((size_t)10, takeUpdateCount());
+
+    stats = findVisibleObjects();
+    CPPUNIT_ASSERT_EQUAL((size_t)18, stats.reusedRenderables);
+}
+//--------------------------------------------------------------------------
+void RenderQueueEntryCacheTests::testEntitySignature()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    MeshPtr mesh = MeshManager::getSingleton().createPlane("RenderQueueEntryCacheTests",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, Plane(Vector3::UNIT_Z, 0), 10, 10);
+    Entity* ent = mSceneMgr->createEntity(mesh);
+    ent->setMaterial(mMaterial);
+    mMaterial->load();
+
+    uint32 signature = ent->_getRenderQueueSignature();
+    CPPUNIT_ASSERT(signature != 0);
+    CPPUNIT_ASSERT_EQUAL(signature, ent->_getRenderQueueSignature());
+
+    // Another material
+    MaterialPtr other = MaterialManager::getSingleton().create("RenderQueueEntryCacheTestsOther", 
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME).staticCast<Material>();
+    other->createTechnique()->createPass();
+    other->load();
+    ent->setMaterial(other);
+    CPPUNIT_ASSERT(ent->_getRenderQueueSignature() != signature);
+    ent->setMaterial(mMaterial);
+    CPPUNIT_ASSERT_EQUAL(signature, ent->_getRenderQueueSignature());
+
+    // The techniques of an unloaded material are only known once it is loaded
+    // again, and may then be different
+    mMaterial->unload();
+    CPPUNIT_ASSERT_EQUAL((uint32)0, ent->_getRenderQueueSignature());
+    mMaterial->load();
+    CPPUNIT_ASSERT(ent->_getRenderQueueSignature() != 0);
+    CPPUNIT_ASSERT(ent->_getRenderQueueSignature() != signature);
+    signature = ent->_getRenderQueueSignature();
+
+    // The scheme techniques are chosen for
+    MaterialManager::getSingleton().setActiveScheme("RenderQueueEntryCacheTests");
+    CPPUNIT_ASSERT(ent->_getRenderQueueSignature() != signature);
+    MaterialManager::getSingleton().setActiveScheme(MaterialManager::DEFAULT_SCHEME_NAME);
+    CPPUNIT_ASSERT_EQUAL(signature, ent->_getRenderQueueSignature());
+
+    // Hidden sub entities and queue settings
+    ent->getSubEntity(0)->setVisible(false);
+    CPPUNIT_ASSERT(ent->_getRenderQueueSignature() != signature);
+    ent->getSubEntity(0)->setVisible(true);
+    ent->setRenderQueueGroup(RENDER_QUEUE_8);
+    CPPUNIT_ASSERT(ent->_getRenderQueueSignature() != signature);
+
+    mSceneMgr->destroyEntity(ent);
+    MaterialManager::getSingleton().remove(other->getHandle());
+    MeshManager::getSingleton().remove(mesh->getHandle());
+}
@@ -0,0 +1,186 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "RenderQueueSortTests.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreCamera.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreRenderQueueSortingGrouping.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+#ifdef OGRE_BUILD_RENDERSYSTEM_NULL
+CPPUNIT_TEST_SUITE_REGISTRATION(RenderQueueSortTests);
+#endif
+
+namespace
+{
+    /// Renderable standing at a fixed position
+    class PositionedRenderable : public Renderable, public RenderQueueAlloc
+    {
+    public:
+        Vector3 mPosition;
+        MaterialPtr mMaterial;
+        LightList mLights;
+
+        PositionedRenderable(const Vector3& pos) : mPosition(pos) {}
+
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+        void getRenderOperation(RenderOperation& op) {}
+        void getWorldTransforms(Matrix4* xform) const { *xform = Matrix4::IDENTITY; }
+        Real getSquaredViewDepth(const Camera* cam) const
+        {
+            return (mPosition - cam->getDerivedPosition()).squaredLength();
+        }
+        const LightList& getLights(void) const { return mLights; }
+    };
+
+    /// Visitor recording the visited passes and renderables
+    class RecordingVisitor : public QueuedRenderableVisitor
+    {
+    public:
+        typedef std::pair<const Pass*, Renderable*> Entry;
+        vector<Entry>::type mEntries;
+        size_t mPassVisits;
+        const Pass* mCurrentPass;
+
+        RecordingVisitor() : mPassVisits(0), mCurrentPass(0) {}
+
+        void visit(RenderablePass* rp) { mEntries.push_back(Entry(rp->pass, rp->renderable)); }
+        bool visit(const Pass* p)
+        {
+            ++mPassVisits;
+            mCurrentPass = p;
+            return true;
+        }
+        void visit(Renderable* r) { mEntries.push_back(Entry(mCurrentPass, r)); }
+    };
+}
+
+//--------------------------------------------------------------------------
+void RenderQueueSortTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = mFixture.setUp();
+
+    SceneManager* sceneMgr = mRoot->createSceneManager(ST_GENERIC);
+    mCamera = sceneMgr->createCamera("RenderQueueSortTests");
+    srand(1234);
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortTests::tearDown()
+{
+    for (size_t i = 0; i < mRenderables.size(); ++i)
+        OGRE_DELETE mRenderables[i];
+    mRenderables.clear();
+    mPasses.clear();
+    mRoot->destroySceneManager(mCamera->getSceneManager());
+    mFixture.tearDown();
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortTests::createPasses(size_t count)
+{
+    // One material per pass, told apart by the texture they use
+    for (size_t i = 0; i < count; ++i)
+    {
+        String name = "RenderQueueSortTests" + StringConverter::toString(i);
+        MaterialPtr mat = MaterialManager::getSingleton().create(name, 
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME).staticCast<Material>();
+        Pass* pass = mat->createTechnique()->createPass();
+        pass->createTextureUnitState(name + ".png");
+        pass->_recalculateHash();
+        mPasses.push_back(pass);
+    }
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortTests::createRenderables(size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        mRenderables.push_back(OGRE_NEW PositionedRenderable(Vector3(
+            Math::RangeRandom(-1000, 1000), Math::RangeRandom(-1000, 1000), 
+            Math::RangeRandom(-1000, 1000))));
+    }
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortTests::testSortKeyGroupsByPass()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    createPasses(50);
+    createRenderables(5000);
+
+    QueuedRenderableCollection grouped, keyed;
+    grouped.addOrganisationMode(QueuedRenderableCollection::OM_PASS_GROUP);
+    keyed.addOrganisationMode(QueuedRenderableCollection::OM_SORT_KEY);
+    for (size_t i = 0; i < mRenderables.size(); ++i)
+    {
+        Pass* pass = mPasses[i % mPasses.size()];
+        grouped.addRenderable(pass, mRenderables[i]);
+        keyed.addRenderable(pass, mRenderables[i]);
+    }
+    grouped.sort(mCamera);
+    keyed.sort(mCamera);
+
+    RecordingVisitor groupedVisitor, keyedVisitor;
+    grouped.acceptVisitor(&groupedVisitor, QueuedRenderableCollection::OM_PASS_GROUP);
+    // Pass grouping requests fall back on the keyed list
+    keyed.acceptVisitor(&keyedVisitor, QueuedRenderableCollection::OM_PASS_GROUP);
+
+    // Same contents, each pass visited once with its renderables front to back
+    set<uint32>::type hashes;
+    for (size_t i = 0; i < mPasses.size(); ++i)
+        hashes.insert(mPasses[i]->getHash());
+    if (hashes.size() == mPasses.size())
+        CPPUNIT_ASSERT_EQUAL(mPasses.size(), keyedVisitor.mPassVisits);
+    CPPUNIT_ASSERT_EQUAL(mPasses.size(), groupedVisitor.mPassVisits);
+
+    vector<RecordingVisitor::Entry>::type groupedEntries = groupedVisitor.mEntries;
+    vector<RecordingVisitor::Entry>::type keyedEntries = keyedVisitor.mEntries;
+    CPPUNIT_ASSERT_EQUAL(mRenderables.size(), keyedEntries.size());
+    for (size_t i = 1; i < keyedEntries.size(); ++i)
+    {
+        const RecordingVisitor::Entry& prev = keyedEntries[i - 1];
+        const RecordingVisitor::Entry& cur = keyedEntries[i];
+        CPPUNIT_ASSERT(prev.first->getHash() <= cur.first->getHash());
+        if (prev.first == cur.first)
+        {
+            CPPUNIT_ASSERT(prev.second->getSquaredViewDepth(mCamera) <= 
+                cur.second->getSquaredViewDepth(mCamera));
+        }
+    }
+    std::sort(groupedEntries.begin(), groupedEntries.end());
+    std::sort(keyedEntries.begin(), keyedEntries.end());
+    CPPUNIT_ASSERT(groupedEntries == keyedEntries);
+}
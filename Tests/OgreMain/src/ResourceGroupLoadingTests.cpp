@@ -0,0 +1,252 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ResourceGroupLoadingTests.h"
+#include "OgreRoot.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreResourceManager.h"
+#include "OgreStringConverter.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ResourceGroupLoadingTests);
+
+static const String GROUP_NAME = "ResourceGroupLoadingTests";
+
+/// Order resources of all types are prepared in
+static AtomicScalar<size_t> gPrepareSequence(0);
+
+/** Resource recording how often and where it is prepared and loaded. */
+class CountingResource : public Resource
+{
+public:
+    AtomicScalar<size_t> prepareCount;
+    size_t loadCount;
+    size_t prepareSequence;
+    bool loadedOnCallingThread;
+#if OGRE_THREAD_SUPPORT
+    OGRE_THREAD_ID_TYPE callingThread;
+#endif
+
+    CountingResource(ResourceManager* creator, const String& name, ResourceHandle handle,
+        const String& group)
+        : Resource(creator, name, handle, group), prepareCount(0), loadCount(0),
+        prepareSequence(0), loadedOnCallingThread(true)
+    {
+#if OGRE_THREAD_SUPPORT
+        callingThread = OGRE_THREAD_CURRENT_ID;
+#endif
+    }
+
+protected:
+    void prepareImpl(void)
+    {
+        ++prepareCount;
+        prepareSequence = gPrepareSequence++;
+        if (StringUtil::startsWith(mName, "fail"))
+        {
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "Cannot prepare " + mName,
+                "CountingResource::prepareImpl");
+        }
+    }
+    void loadImpl(void)
+    {
+        ++loadCount;
+#if OGRE_THREAD_SUPPORT
+        loadedOnCallingThread = OGRE_THREAD_CURRENT_ID == callingThread;
+#endif
+    }
+    void unloadImpl(void) {}
+    size_t calculateSize(void) const { return 0; }
+};
+
+/** Manager of CountingResource, with a given loading order. */
+class CountingResourceManager : public ResourceManager
+{
+public:
+    CountingResourceManager(const String& type, Real loadingOrder)
+    {
+        mResourceType = type;
+        mLoadOrder = loadingOrder;
+        ResourceGroupManager::getSingleton()._registerResourceManager(mResourceType, this);
+    }
+    ~CountingResourceManager()
+    {
+        ResourceGroupManager::getSingleton()._unregisterResourceManager(mResourceType);
+    }
+
+    CountingResource* createCounting(const String& name)
+    {
+        return static_cast<CountingResource*>(createResource(name, GROUP_NAME).getPointer());
+    }
+
+protected:
+    Resource* createImpl(const String& name, ResourceHandle handle, const String& group,
+        bool isManual, ManualResourceLoader* loader, const NameValuePairList* createParams)
+    {
+        return OGRE_NEW CountingResource(this, name, handle, group);
+    }
+};
+
+//--------------------------------------------------------------------------
+void ResourceGroupLoadingTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+    mFirstManager = OGRE_NEW CountingResourceManager("FirstCounting", 100);
+    mSecondManager = OGRE_NEW CountingResourceManager("SecondCounting", 200);
+    ResourceGroupManager::getSingleton().createResourceGroup(GROUP_NAME);
+}
+//--------------------------------------------------------------------------
+void ResourceGroupLoadingTests::tearDown()
+{
+    ResourceGroupManager::getSingleton().destroyResourceGroup(GROUP_NAME);
+    OGRE_DELETE mSecondManager;
+    OGRE_DELETE mFirstManager;
+    OGRE_DELETE mRoot;
+}
+//--------------------------------------------------------------------------
+void ResourceGroupLoadingTests::setLoadingThreadCount(size_t threads)
+{
+    // The calling thread takes part in preparing, so it needs one worker less
+    DefaultWorkQueue* wq = static_cast<DefaultWorkQueue*>(mRoot->getWorkQueue());
+    wq->setWorkerThreadCount(std::max(threads, (size_t)2) - 1);
+    wq->startup(true);
+    ResourceGroupManager::getSingleton().setLoadingThreadCount(threads);
+}
+//--------------------------------------------------------------------------
+void ResourceGroupLoadingTests::testParallelPrepareLoadsEverything()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    vector<CountingResource*>::type resources;
+    for (size_t i = 0; i < 200; ++i)
+        resources.push_back(mFirstManager->createCounting("res" + StringConverter::toString(i)));
+
+    setLoadingThreadCount(4);
+    ResourceGroupManager::getSingleton().loadResourceGroup(GROUP_NAME);
+
+    // Every resource prepared once, wherever, and loaded once on this thread
+    for (size_t i = 0; i < resources.size(); ++i)
+    {
+        CPPUNIT_ASSERT(resources[i]->isLoaded());
+        CPPUNIT_ASSERT_EQUAL((size_t)1, resources[i]->prepareCount.get());
+        CPPUNIT_ASSERT_EQUAL((size_t)1, resources[i]->loadCount);
+        CPPUNIT_ASSERT(resources[i]->loadedOnCallingThread);
+    }
+
+    // Reloading after unloading prepares everything again
+    ResourceGroupManager::getSingleton().unloadResourceGroup(GROUP_NAME);
+    ResourceGroupManager::getSingleton().prepareResourceGroup(GROUP_NAME);
+    for (size_t i = 0; i < resources.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(Resource::LOADSTATE_PREPARED, resources[i]->getLoadingState());
+        CPPUNIT_ASSERT_EQUAL((size_t)2, resources[i]->prepareCount.get());
+    }
+}
+//--------------------------------------------------------------------------
+void ResourceGroupLoadingTests::testLoadingOrdersPreparedInTurn()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Created in the wrong order, the second depending on the first
+    vector<CountingResource*>::type first, second;
+    for (size_t i = 0; i < 50; ++i)
+    {
+        second.push_back(mSecondManager->createCounting("second" + StringConverter::toString(i)));
+        first.push_back(mFirstManager->createCounting("first" + StringConverter::toString(i)));
+    }
+
+    setLoadingThreadCount(4);
+    ResourceGroupManager::getSingleton().prepareResourceGroup(GROUP_NAME);
+
+    size_t lastFirst = 0, firstSecond = std::numeric_limits<size_t>::max();
+    for (size_t i = 0; i < first.size(); ++i)
+    {
+        lastFirst = std::max(lastFirst, first[i]->prepareSequence);
+        firstSecond = std::min(firstSecond, second[i]->prepareSequence);
+    }
+    CPPUNIT_ASSERT(lastFirst < firstSecond);
+}
+//--------------------------------------------------------------------------
+void ResourceGroupLoadingTests::testPrepareFailureRaised()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Among the others of its loading order, so it is prepared alongside them
+    vector<CountingResource*>::type before, after;
+    for (size_t i = 0; i < 10; ++i)
+        before.push_back(mFirstManager->createCounting("before" + StringConverter::toString(i)));
+    CountingResource* fail = mFirstManager->createCounting("fail");
+    for (size_t i = 0; i < 10; ++i)
+        after.push_back(mFirstManager->createCounting("after" + StringConverter::toString(i)));
+
+    // Raised on this thread, as it would be without other threads
+    setLoadingThreadCount(4);
+    CPPUNIT_ASSERT_THROW(ResourceGroupManager::getSingleton().loadResourceGroup(GROUP_NAME),
+        FileNotFoundException);
+
+    // The resources before the failing one are loaded, the ones after it only
+    // prepared, and the failing one was tried again on this thread
+    for (size_t i = 0; i < before.size(); ++i)
+    {
+        CPPUNIT_ASSERT(before[i]->isLoaded());
+        CPPUNIT_ASSERT_EQUAL((size_t)1, before[i]->prepareCount.get());
+    }
+    for (size_t i = 0; i < after.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(Resource::LOADSTATE_PREPARED, after[i]->getLoadingState());
+        CPPUNIT_ASSERT_EQUAL((size_t)1, after[i]->prepareCount.get());
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)2, fail->prepareCount.get());
+    CPPUNIT_ASSERT_EQUAL(Resource::LOADSTATE_UNLOADED, fail->getLoadingState());
+}
+//--------------------------------------------------------------------------
+void ResourceGroupLoadingTests::testSerialBeforeWorkQueueStarted()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    vector<CountingResource*>::type resources;
+    for (size_t i = 0; i < 20; ++i)
+        resources.push_back(mFirstManager->createCounting("res" + StringConverter::toString(i)));
+
+    // Nothing would pick up the work before the queue is started
+    ResourceGroupManager::getSingleton().setLoadingThreadCount(4);
+    ResourceGroupManager::getSingleton().loadResourceGroup(GROUP_NAME);
+
+    for (size_t i = 0; i < resources.size(); ++i)
+    {
+        CPPUNIT_ASSERT(resources[i]->isLoaded());
+        CPPUNIT_ASSERT_EQUAL((size_t)1, resources[i]->prepareCount.get());
+        CPPUNIT_ASSERT(resources[i]->loadedOnCallingThread);
+    }
+}
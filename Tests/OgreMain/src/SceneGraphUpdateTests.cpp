@@ -0,0 +1,203 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "SceneGraphUpdateTests.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+#ifdef OGRE_BUILD_RENDERSYSTEM_NULL
+CPPUNIT_TEST_SUITE_REGISTRATION(SceneGraphUpdateTests);
+#endif
+
+//--------------------------------------------------------------------------
+void SceneGraphUpdateTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = mFixture.setUp();
+
+    mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+    mCamera = mSceneMgr->createCamera("SceneGraphUpdateTests");
+
+    // 6^1 + ... + 6^6 = 55986 nodes
+    createHierarchy(mSceneMgr->getRootSceneNode(), 6, 6);
+}
+//--------------------------------------------------------------------------
+void SceneGraphUpdateTests::tearDown()
+{
+    mNodes.clear();
+    mRoot->destroySceneManager(mSceneMgr);
+    mFixture.tearDown();
+}
+//--------------------------------------------------------------------------
+void SceneGraphUpdateTests::createHierarchy(SceneNode* parent, size_t fanout, size_t depth)
+{
+    if (!depth)
+        return;
+
+    for (size_t i = 0; i < fanout; ++i)
+    {
+        SceneNode* child = parent->createChildSceneNode(
+            Vector3(Real(i), Real(depth), Real(i) * 0.5f),
+            Quaternion(Degree(Real(i * 15)), Vector3::UNIT_Y));
+        child->setScale(Vector3(1.01f, 1.0f, 0.99f));
+        mNodes.push_back(child);
+        createHierarchy(child, fanout, depth - 1);
+    }
+}
+//--------------------------------------------------------------------------
+void SceneGraphUpdateTests::setWorkerThreadCount(size_t threads)
+{
+    // The calling thread takes part in the update, so it needs one worker less
+    DefaultWorkQueue* wq = static_cast<DefaultWorkQueue*>(mRoot->getWorkQueue());
+    wq->setWorkerThreadCount(std::max(threads, (size_t)2) - 1);
+    wq->startup(true);
+    mSceneMgr->setSceneGraphUpdateThreadCount(threads);
+}
+//--------------------------------------------------------------------------
+void SceneGraphUpdateTests::testParallelMatchesSerial()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    setWorkerThreadCount(4);
+    mSceneMgr->_updateSceneGraph(mCamera);
+
+    vector<Vector3>::type positions;
+    vector<Quaternion>::type orientations;
+    for (size_t i = 0; i < mNodes.size(); ++i)
+    {
+        positions.push_back(mNodes[i]->_getDerivedPosition());
+        orientations.push_back(mNodes[i]->_getDerivedOrientation());
+    }
+
+    // Redo the whole update serially and compare
+    mSceneMgr->setSceneGraphUpdateThreadCount(1);
+    mSceneMgr->getRootSceneNode()->needUpdate();
+    mSceneMgr->_updateSceneGraph(mCamera);
+
+    for (size_t i = 0; i < mNodes.size(); ++i)
+    {
+        CPPUNIT_ASSERT(positions[i] == mNodes[i]->_getDerivedPosition());
+        CPPUNIT_ASSERT(orientations[i] == mNodes[i]->_getDerivedOrientation());
+    }
+
+    // Partial updates must only touch the moved subtrees
+    mNodes.back()->translate(Vector3::UNIT_X);
+    setWorkerThreadCount(4);
+    mSceneMgr->_updateSceneGraph(mCamera);
+    SceneNode* parent = mNodes.back()->getParentSceneNode();
+    Vector3 expected = positions.back() + 
+        parent->_getDerivedOrientation() * (parent->_getDerivedScale() * Vector3::UNIT_X);
+    CPPUNIT_ASSERT(mNodes.back()->_getDerivedPosition().positionEquals(expected));
+}
+//--------------------------------------------------------------------------
+void SceneGraphUpdateTests::testSoABlocksMatchPerNode()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Nodes not inheriting orientation or scale cannot be concatenated in blocks
+    mNodes[1]->setInheritOrientation(false);
+    mNodes[2]->setInheritScale(false);
+
+    mSceneMgr->_updateSceneGraph(mCamera);
+
+    vector<Vector3>::type positions, scales;
+    vector<Quaternion>::type orientations;
+    for (size_t i = 0; i < mNodes.size(); ++i)
+    {
+        positions.push_back(mNodes[i]->_getDerivedPosition());
+        orientations.push_back(mNodes[i]->_getDerivedOrientation());
+        scales.push_back(mNodes[i]->_getDerivedScale());
+    }
+
+    const size_t threadCounts[] = { 1, 4 };
+    for (size_t t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]); ++t)
+    {
+        setWorkerThreadCount(threadCounts[t]);
+        SceneManager::NodeTransformStorage storage = SceneManager::NTS_SOA_BLOCKS;
+        CPPUNIT_ASSERT(mSceneMgr->setOption("NodeTransformStorage", &storage));
+        CPPUNIT_ASSERT_EQUAL(SceneManager::NTS_SOA_BLOCKS, mSceneMgr->getNodeTransformStorage());
+
+        mSceneMgr->getRootSceneNode()->needUpdate();
+        mSceneMgr->_updateSceneGraph(mCamera);
+
+        for (size_t i = 0; i < mNodes.size(); ++i)
+        {
+            CPPUNIT_ASSERT(positions[i].positionEquals(mNodes[i]->_getDerivedPosition()));
+            CPPUNIT_ASSERT(orientations[i].orientationEquals(mNodes[i]->_getDerivedOrientation(), 1e-6f));
+            CPPUNIT_ASSERT(scales[i].positionEquals(mNodes[i]->_getDerivedScale()));
+        }
+
+        mSceneMgr->setNodeTransformStorage(SceneManager::NTS_PER_NODE);
+    }
+
+    // Partial updates must only touch the moved subtrees
+    mSceneMgr->setNodeTransformStorage(SceneManager::NTS_SOA_BLOCKS);
+    mNodes.back()->translate(Vector3::UNIT_X);
+    mSceneMgr->_updateSceneGraph(mCamera);
+    SceneNode* parent = mNodes.back()->getParentSceneNode();
+    Vector3 expected = positions.back() + 
+        parent->_getDerivedOrientation() * (parent->_getDerivedScale() * Vector3::UNIT_X);
+    CPPUNIT_ASSERT(mNodes.back()->_getDerivedPosition().positionEquals(expected));
+    CPPUNIT_ASSERT(mNodes.front()->_getDerivedPosition() == positions.front());
+}
+//--------------------------------------------------------------------------
+void SceneGraphUpdateTests::testStoppedQueueRunsSerially()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    mSceneMgr->_updateSceneGraph(mCamera);
+    vector<Vector3>::type positions;
+    for (size_t i = 0; i < mNodes.size(); ++i)
+        positions.push_back(mNodes[i]->_getDerivedPosition());
+
+    // Before the queue is started and after it is shut down there are no
+    // workers, so the update has to be done by the calling thread alone
+    DefaultWorkQueue* wq = static_cast<DefaultWorkQueue*>(mRoot->getWorkQueue());
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+        if (pass == 1)
+        {
+            setWorkerThreadCount(4);
+            wq->shutdown();
+        }
+        mSceneMgr->setSceneGraphUpdateThreadCount(4);
+        mSceneMgr->getRootSceneNode()->needUpdate();
+        mSceneMgr->_updateSceneGraph(mCamera);
+
+        for (size_t i = 0; i < mNodes.size(); ++i)
+            CPPUNIT_ASSERT(positions[i] == mNodes[i]->_getDerivedPosition());
+    }
+}
@@ -0,0 +1,310 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "SceneQueryBatchTests.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreMovableObject.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(SceneQueryBatchTests);
+
+namespace
+{
+    /// Object of a given size, created through its factory so that the default queries find it
+    class BatchBoxObject : public MovableObject
+    {
+    public:
+        AxisAlignedBox mBox;
+
+        BatchBoxObject(const String& name, Real halfSize)
+            : MovableObject(name)
+            , mBox(-Vector3::UNIT_SCALE * halfSize, Vector3::UNIT_SCALE * halfSize)
+        {
+        }
+
+        const String& getMovableType(void) const;
+        const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+        Real getBoundingRadius(void) const { return mBox.getHalfSize().length(); }
+        void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) {}
+        void _updateRenderQueue(RenderQueue* queue) {}
+    };
+
+    class BatchBoxObjectFactory : public MovableObjectFactory
+    {
+    protected:
+        MovableObject* createInstanceImpl(const String& name, const NameValuePairList* params)
+        {
+            return OGRE_NEW BatchBoxObject(name, 
+                StringConverter::parseReal(params->find("size")->second));
+        }
+    public:
+        static String FACTORY_TYPE_NAME;
+        const String& getType(void) const { return FACTORY_TYPE_NAME; }
+        // a type flag of its own, so that queries may exclude the type
+        bool requestTypeFlags(void) const { return true; }
+        void destroyInstance(MovableObject* obj) { OGRE_DELETE obj; }
+    };
+    String BatchBoxObjectFactory::FACTORY_TYPE_NAME = "BatchBoxObject";
+
+    const String& BatchBoxObject::getMovableType(void) const
+    {
+        return BatchBoxObjectFactory::FACTORY_TYPE_NAME;
+    }
+}
+
+//--------------------------------------------------------------------------
+void SceneQueryBatchTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root(BLANKSTRING);
+    mFactory = OGRE_NEW BatchBoxObjectFactory();
+    mRoot->addMovableObjectFactory(mFactory);
+    mSceneMgr = mRoot->createSceneManager(ST_GENERIC);
+
+    srand(4321);
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        // mostly small objects, with a few large ones
+        NameValuePairList params;
+        params["size"] = StringConverter::toString(
+            Math::UnitRandom() < 0.95f ? Math::RangeRandom(0.5f, 5) : Math::RangeRandom(20, 100));
+        MovableObject* obj = mSceneMgr->createMovableObject(
+            "BatchBoxObject" + StringConverter::toString(i), 
+            BatchBoxObjectFactory::FACTORY_TYPE_NAME, &params);
+        obj->setQueryFlags(i % 2 ? 1 : 2);
+        mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(
+            Math::RangeRandom(-500, 500), Math::RangeRandom(-200, 200), Math::RangeRandom(-500, 500)))
+            ->attachObject(obj);
+        mObjects.push_back(obj);
+    }
+    mSceneMgr->getRootSceneNode()->_update(true, false);
+}
+//--------------------------------------------------------------------------
+void SceneQueryBatchTests::tearDown()
+{
+    mObjects.clear();
+    mRoot->destroySceneManager(mSceneMgr);
+    mRoot->removeMovableObjectFactory(mFactory);
+    OGRE_DELETE mFactory;
+    OGRE_DELETE mRoot;
+}
+//--------------------------------------------------------------------------
+void SceneQueryBatchTests::setThreadCount(size_t threads)
+{
+    // The calling thread takes part in the queries, so it needs one worker less
+    DefaultWorkQueue* wq = static_cast<DefaultWorkQueue*>(mRoot->getWorkQueue());
+    wq->setWorkerThreadCount(std::max(threads, (size_t)2) - 1);
+    wq->startup(true);
+    mSceneMgr->setSceneQueryThreadCount(threads);
+}
+//--------------------------------------------------------------------------
+void SceneQueryBatchTests::testRayQueries()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t count = 100;
+    const size_t maxHits = 3;
+    vector<Ray>::type rays;
+    for (size_t i = 0; i < count; ++i)
+    {
+        rays.push_back(Ray(
+            Vector3(Math::RangeRandom(-500, 500), Math::RangeRandom(-200, 200), Math::RangeRandom(-500, 500)),
+            Vector3(Math::SymmetricRandom(), Math::SymmetricRandom(), Math::SymmetricRandom()).normalisedCopy()));
+    }
+
+    RaySceneQuery* query = mSceneMgr->createRayQuery(Ray());
+    query->setSortByDistance(true);
+
+    vector<SceneQueryBatchHit>::type hits(count * maxHits);
+    vector<size_t>::type hitCounts(count);
+    for (size_t threads = 1; threads <= 4; threads += 3)
+    {
+        setThreadCount(threads);
+        size_t stored = mSceneMgr->executeRayQueries(&rays[0], count, &hits[0], maxHits, &hitCounts[0]);
+
+        size_t expectedStored = 0;
+        for (size_t q = 0; q < count; ++q)
+        {
+            // same hits as the ray query, the nearest ones stored first
+            query->setRay(rays[q]);
+            RaySceneQueryResult& results = query->execute();
+            CPPUNIT_ASSERT_EQUAL(results.size(), hitCounts[q]);
+            for (size_t h = 0; h < std::min(results.size(), maxHits); ++h)
+            {
+                const SceneQueryBatchHit& hit = hits[q * maxHits + h];
+                CPPUNIT_ASSERT_EQUAL(results[h].distance, hit.distance);
+                CPPUNIT_ASSERT_EQUAL(hit.distance,
+                    rays[q].intersects(hit.movable->getWorldBoundingBox()).second);
+            }
+            expectedStored += std::min(results.size(), maxHits);
+        }
+        CPPUNIT_ASSERT_EQUAL(expectedStored, stored);
+    }
+
+    mSceneMgr->destroyQuery(query);
+}
+//--------------------------------------------------------------------------
+void SceneQueryBatchTests::testVolumeQueries()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t count = 70;
+    vector<Sphere>::type spheres;
+    vector<AxisAlignedBox>::type boxes;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Vector3 centre(Math::RangeRandom(-500, 500), Math::RangeRandom(-200, 200), Math::RangeRandom(-500, 500));
+        spheres.push_back(Sphere(centre, Math::RangeRandom(10, 100)));
+        boxes.push_back(AxisAlignedBox(centre - Vector3(Math::RangeRandom(10, 100)), 
+            centre + Vector3(Math::RangeRandom(10, 100))));
+    }
+
+    AxisAlignedBoxSceneQuery* boxQuery = mSceneMgr->createAABBQuery(AxisAlignedBox());
+
+    // room for every hit, so that all of them can be compared
+    const size_t maxHits = mObjects.size();
+    vector<SceneQueryBatchHit>::type hits(count * maxHits);
+    vector<size_t>::type hitCounts(count);
+    for (size_t threads = 1; threads <= 4; threads += 3)
+    {
+        setThreadCount(threads);
+
+        mSceneMgr->executeSphereQueries(&spheres[0], count, &hits[0], maxHits, &hitCounts[0]);
+        size_t hitQueries = 0;
+        for (size_t q = 0; q < count; ++q)
+        {
+            // the sphere query tests bounding spheres, the batch bounding boxes
+            set<MovableObject*>::type expected;
+            for (size_t i = 0; i < mObjects.size(); ++i)
+            {
+                if (Math::intersects(spheres[q], mObjects[i]->getWorldBoundingBox()))
+                    expected.insert(mObjects[i]);
+            }
+            CPPUNIT_ASSERT_EQUAL(expected.size(), hitCounts[q]);
+            for (size_t h = 0; h < hitCounts[q]; ++h)
+            {
+                CPPUNIT_ASSERT(expected.erase(hits[q * maxHits + h].movable));
+                CPPUNIT_ASSERT_EQUAL((Real)0, hits[q * maxHits + h].distance);
+            }
+            hitQueries += hitCounts[q] ? 1 : 0;
+        }
+        CPPUNIT_ASSERT(hitQueries > 0);
+
+        mSceneMgr->executeBoxQueries(&boxes[0], count, &hits[0], maxHits, &hitCounts[0]);
+        for (size_t q = 0; q < count; ++q)
+        {
+            boxQuery->setBox(boxes[q]);
+            SceneQueryResultMovableList& results = boxQuery->execute().movables;
+            CPPUNIT_ASSERT_EQUAL(results.size(), hitCounts[q]);
+            set<MovableObject*>::type expected(results.begin(), results.end());
+            for (size_t h = 0; h < hitCounts[q]; ++h)
+                CPPUNIT_ASSERT(expected.erase(hits[q * maxHits + h].movable));
+        }
+    }
+
+    mSceneMgr->destroyQuery(boxQuery);
+}
+//--------------------------------------------------------------------------
+void SceneQueryBatchTests::testMasks()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // a box around the whole scene, with room for a few hits only
+    AxisAlignedBox box(Vector3(-1000, -1000, -1000), Vector3(1000, 1000, 1000));
+    SceneQueryBatchHit hits[4];
+    size_t hitCount;
+
+    CPPUNIT_ASSERT_EQUAL((size_t)4, mSceneMgr->executeBoxQueries(&box, 1, hits, 4, &hitCount));
+    CPPUNIT_ASSERT_EQUAL(mObjects.size(), hitCount);
+
+    CPPUNIT_ASSERT_EQUAL((size_t)4, mSceneMgr->executeBoxQueries(&box, 1, hits, 4, &hitCount, 2));
+    CPPUNIT_ASSERT_EQUAL(mObjects.size() / 2, hitCount);
+    for (size_t h = 0; h < 4; ++h)
+        CPPUNIT_ASSERT_EQUAL((uint32)2, hits[h].movable->getQueryFlags());
+
+    // excluding the type of the objects leaves nothing
+    CPPUNIT_ASSERT_EQUAL((size_t)0, mSceneMgr->executeBoxQueries(&box, 1, hits, 4, &hitCount,
+        0xFFFFFFFF, SceneManager::ENTITY_TYPE_MASK));
+    CPPUNIT_ASSERT_EQUAL((size_t)0, hitCount);
+
+    // nothing is written without room for it
+    CPPUNIT_ASSERT_EQUAL((size_t)0, mSceneMgr->executeBoxQueries(&box, 1, 0, 0, &hitCount));
+    CPPUNIT_ASSERT_EQUAL(mObjects.size(), hitCount);
+}
+//--------------------------------------------------------------------------
+void SceneQueryBatchTests::testStoppedQueueRunsSerially()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // enough queries for several packets
+    const size_t count = 100;
+    vector<Sphere>::type spheres;
+    for (size_t i = 0; i < count; ++i)
+    {
+        spheres.push_back(Sphere(Vector3(Math::RangeRandom(-500, 500), 
+            Math::RangeRandom(-200, 200), Math::RangeRandom(-500, 500)), Math::RangeRandom(10, 100)));
+    }
+
+    const size_t maxHits = 8;
+    vector<SceneQueryBatchHit>::type expectedHits(count * maxHits), hits(count * maxHits);
+    vector<size_t>::type expectedCounts(count), hitCounts(count);
+    size_t expectedStored = mSceneMgr->executeSphereQueries(&spheres[0], count, 
+        &expectedHits[0], maxHits, &expectedCounts[0]);
+
+    // Before the queue is started and after it is shut down there are no
+    // workers, so the queries have to be executed by the calling thread alone
+    DefaultWorkQueue* wq = static_cast<DefaultWorkQueue*>(mRoot->getWorkQueue());
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+        if (pass == 1)
+        {
+            setThreadCount(4);
+            wq->shutdown();
+        }
+        mSceneMgr->setSceneQueryThreadCount(4);
+        size_t stored = mSceneMgr->executeSphereQueries(&spheres[0], count, 
+            &hits[0], maxHits, &hitCounts[0]);
+
+        CPPUNIT_ASSERT_EQUAL(expectedStored, stored);
+        CPPUNIT_ASSERT(hitCounts == expectedCounts);
+        for (size_t q = 0; q < count; ++q)
+        {
+            for (size_t h = 0; h < std::min(hitCounts[q], maxHits); ++h)
+                CPPUNIT_ASSERT(hits[q * maxHits + h].movable == expectedHits[q * maxHits + h].movable);
+        }
+    }
+}
+//--------------------------------------------------------------------------
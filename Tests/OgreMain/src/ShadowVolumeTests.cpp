@@ -0,0 +1,452 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ShadowVolumeTests.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreShadowCaster.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+#include "OgreRoot.h"
+#include "OgreLight.h"
+
+#include "UnitTestSuite.h"
+
+#include <algorithm>
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ShadowVolumeTests);
+
+namespace
+{
+    /// Shadow renderable which only holds its index range
+    class TestShadowRenderable : public ShadowRenderable
+    {
+    public:
+        TestShadowRenderable(const HardwareIndexBufferSharedPtr& indexBuffer, bool separateLightCap)
+        {
+            mRenderOp.indexData = OGRE_NEW IndexData();
+            mRenderOp.indexData->indexBuffer = indexBuffer;
+            if (separateLightCap)
+                mLightCap = OGRE_NEW TestShadowRenderable(indexBuffer, false);
+        }
+        ~TestShadowRenderable() { OGRE_DELETE mRenderOp.indexData; }
+        void getWorldTransforms(Matrix4* xform) const { *xform = Matrix4::IDENTITY; }
+        void rebindIndexBuffer(const HardwareIndexBufferSharedPtr& indexBuffer)
+        {
+            mRenderOp.indexData->indexBuffer = indexBuffer;
+            if (mLightCap)
+                static_cast<TestShadowRenderable*>(mLightCap)->rebindIndexBuffer(indexBuffer);
+        }
+    };
+
+    /// Shadow caster at the origin of the world using the given edge list
+    class TestShadowCaster : public ShadowCaster
+    {
+    public:
+        EdgeData* mEdgeData;
+        AxisAlignedBox mBounds;
+        ShadowRenderableList mShadowRenderables;
+
+        TestShadowCaster(EdgeData* edgeData, const HardwareIndexBufferSharedPtr& indexBuffer,
+            bool separateLightCap)
+            : mEdgeData(edgeData), mBounds(-1, -1, -1, 1, 1, 1)
+        {
+            for (size_t i = 0; i < edgeData->edgeGroups.size(); ++i)
+                mShadowRenderables.push_back(OGRE_NEW TestShadowRenderable(indexBuffer, separateLightCap));
+        }
+        ~TestShadowCaster() { clearShadowRenderableList(mShadowRenderables); }
+
+        bool getCastShadows(void) const { return true; }
+        EdgeData* getEdgeList(void) { return mEdgeData; }
+        bool hasEdgeList(void) { return true; }
+        const AxisAlignedBox& getWorldBoundingBox(bool derive) const { return mBounds; }
+        const AxisAlignedBox& getLightCapBounds(void) const { return mBounds; }
+        const AxisAlignedBox& getDarkCapBounds(const Light& light, Real dirLightExtrusionDist) const
+        { return mBounds; }
+        Real getPointExtrusionDistance(const Light* l) const { return 100; }
+
+        ShadowRenderableListIterator getShadowVolumeRenderableIterator(
+            ShadowTechnique shadowTechnique, const Light* light,
+            HardwareIndexBufferSharedPtr* indexBuffer, size_t* indexBufferUsedSize,
+            bool extrudeVertices, Real extrusionDistance, unsigned long flags)
+        {
+            updateEdgeListLightFacing(mEdgeData, light->getAs4DVector());
+            generateShadowVolume(mEdgeData, *indexBuffer, *indexBufferUsedSize,
+                light, mShadowRenderables, flags);
+            return ShadowRenderableListIterator(mShadowRenderables.begin(), mShadowRenderables.end());
+        }
+
+        bool _prepareShadowVolume(
+            ShadowTechnique shadowTechnique, const Light* light,
+            HardwareIndexBufferSharedPtr* indexBuffer,
+            bool extrudeVertices, Real extrusionDistance, unsigned long flags,
+            ShadowVolumeBuild& build)
+        {
+            build.lightPos = light->getAs4DVector();
+            initShadowVolumeBuild(build, mEdgeData, light, mShadowRenderables, flags);
+            return true;
+        }
+    };
+
+    typedef vector<unsigned short>::type IndexList;
+
+    /** Appends the index count then the indexes of each renderable, and of
+        its separate light cap if the flags include one, like it is rendered
+    */
+    void collectIndexes(const ShadowCaster::ShadowRenderableList& renderables,
+        const unsigned short* pIndexes, unsigned long flags, IndexList& result)
+    {
+        const int numParts = (flags & SRF_INCLUDE_LIGHT_CAP) ? 2 : 1;
+        for (size_t i = 0; i < renderables.size(); ++i)
+        {
+            ShadowRenderable* sr = renderables[i];
+            for (int part = 0; part < numParts && sr; ++part)
+            {
+                const IndexData* indexData = sr->getRenderOperationForUpdate()->indexData;
+                result.push_back(static_cast<unsigned short>(indexData->indexCount));
+                result.insert(result.end(), pIndexes + indexData->indexStart,
+                    pIndexes + indexData->indexStart + indexData->indexCount);
+                sr = sr->getLightCapRenderable();
+            }
+        }
+    }
+
+    /// Generates a shadow volume the way casters do on their own
+    IndexList generateShadowVolume(TestShadowCaster& caster, const Light& light,
+        HardwareIndexBufferSharedPtr& indexBuffer, unsigned long flags)
+    {
+        size_t usedSize = 0;
+        caster.getShadowVolumeRenderableIterator(SHADOWTYPE_STENCIL_ADDITIVE, &light,
+            &indexBuffer, &usedSize, false, 100, flags);
+
+        IndexList result;
+        const unsigned short* pIndexes = static_cast<const unsigned short*>(
+            indexBuffer->lock(HardwareBuffer::HBL_READ_ONLY));
+        collectIndexes(caster.mShadowRenderables, pIndexes, flags, result);
+        indexBuffer->unlock();
+        return result;
+    }
+
+    /** Scene manager recording the indexes of the shadow volumes it renders,
+        in the order it renders them, instead of sending them to a render system
+    */
+    class RecordingSceneManager : public DefaultSceneManager
+    {
+    public:
+        vector<IndexList>::type mRendered;
+
+        RecordingSceneManager() : DefaultSceneManager("RecordingSceneManager")
+        {
+            mShadowIndexBufferSize = 1024;
+            mShadowIndexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+                HardwareIndexBuffer::IT_16BIT, mShadowIndexBufferSize,
+                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false);
+        }
+
+        const HardwareIndexBufferSharedPtr& getShadowIndexBuffer(void) const { return mShadowIndexBuffer; }
+
+        /// Renders the shadow volumes of the casters one at a time
+        void renderSerial(const vector<TestShadowCaster*>::type& casters, const Light& light,
+            unsigned long flags)
+        {
+            for (size_t i = 0; i < casters.size(); ++i)
+            {
+                renderShadowVolume(casters[i]->getShadowVolumeRenderableIterator(mShadowTechnique,
+                    &light, &mShadowIndexBuffer, &mShadowIndexBufferUsedSize, false, 100, flags),
+                    0, flags, false, true);
+            }
+        }
+
+        /// Renders the shadow volumes of the casters as renderShadowVolumesToStencil does
+        void renderParallel(const vector<TestShadowCaster*>::type& casters, const Light& light,
+            unsigned long flags, size_t threads)
+        {
+            setShadowVolumeThreadCount(threads);
+            mNumShadowVolumeItems = 0;
+            for (size_t i = 0; i < casters.size(); ++i)
+            {
+                if (mNumShadowVolumeItems == mShadowVolumeItems.size())
+                    mShadowVolumeItems.push_back(ShadowVolumeItem());
+                ShadowVolumeItem& item = mShadowVolumeItems[mNumShadowVolumeItems++];
+                casters[i]->_prepareShadowVolume(mShadowTechnique, &light, &mShadowIndexBuffer,
+                    false, 100, flags, item.build);
+                item.zfail = false;
+            }
+            renderShadowVolumesParallel(0, true);
+        }
+
+    protected:
+        void renderSingleObject(Renderable* rend, const Pass* pass,
+            bool lightScissoringClipping, bool doLightIteration, const LightList* manualLightList)
+        {
+            const IndexData* indexData =
+                static_cast<ShadowRenderable*>(rend)->getRenderOperationForUpdate()->indexData;
+            const unsigned short* pIndexes = static_cast<const unsigned short*>(
+                indexData->indexBuffer->lock(HardwareBuffer::HBL_READ_ONLY));
+            mRendered.push_back(IndexList(pIndexes + indexData->indexStart,
+                pIndexes + indexData->indexStart + indexData->indexCount));
+            indexData->indexBuffer->unlock();
+        }
+
+        void setShadowVolumeStencilState(bool secondpass, bool zfail, bool twosided) {}
+    };
+
+    /// Lights around and inside the unit cube
+    void setUpLights(Light* lights)
+    {
+        lights[0].setType(Light::LT_DIRECTIONAL);
+        lights[0].setDirection(-1, -0.5f, -0.25f);
+        lights[1].setType(Light::LT_POINT);
+        lights[1].setPosition(5, -4, 3);
+        lights[2].setType(Light::LT_POINT);
+        lights[2].setPosition(0.1f, 0.2f, 0.5f);
+    }
+}
+//--------------------------------------------------------------------------
+void ShadowVolumeTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+
+    // Unit cube, vertex i is at x = bit 0, y = bit 1, z = bit 2
+    mVertexData = OGRE_NEW VertexData();
+    mVertexData->vertexCount = 8;
+    mVertexData->vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+    HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+        sizeof(float) * 3, 8, HardwareBuffer::HBU_STATIC, true);
+    mVertexData->vertexBufferBinding->setBinding(0, vbuf);
+    float* pFloat = static_cast<float*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+    for (int i = 0; i < 8; ++i)
+    {
+        *pFloat++ = (i & 1) ? 1.0f : -1.0f;
+        *pFloat++ = (i & 2) ? 1.0f : -1.0f;
+        *pFloat++ = (i & 4) ? 1.0f : -1.0f;
+    }
+    vbuf->unlock();
+
+    static const unsigned short indexes[36] = {
+        4, 5, 7,  4, 7, 6,  // +z
+        0, 2, 3,  0, 3, 1,  // -z
+        1, 3, 7,  1, 7, 5,  // +x
+        0, 4, 6,  0, 6, 2,  // -x
+        2, 6, 7,  2, 7, 3,  // +y
+        0, 1, 5,  0, 5, 4   // -y
+    };
+    mIndexData = OGRE_NEW IndexData();
+    mIndexData->indexCount = 36;
+    mIndexData->indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+        HardwareIndexBuffer::IT_16BIT, 36, HardwareBuffer::HBU_STATIC, true);
+    mIndexData->indexBuffer->writeData(0, sizeof(indexes), indexes, true);
+
+    EdgeListBuilder builder;
+    builder.addVertexData(mVertexData);
+    builder.addIndexData(mIndexData);
+    mEdgeData = builder.build();
+}
+//--------------------------------------------------------------------------
+void ShadowVolumeTests::tearDown()
+{
+    OGRE_DELETE mEdgeData;
+    OGRE_DELETE mIndexData;
+    OGRE_DELETE mVertexData;
+    OGRE_DELETE mBufMgr;
+}
+//--------------------------------------------------------------------------
+void ShadowVolumeTests::testCubeSilhouette()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    CPPUNIT_ASSERT(mEdgeData->isClosed);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), mEdgeData->edgeGroups.size());
+
+    HardwareIndexBufferSharedPtr indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+        HardwareIndexBuffer::IT_16BIT, 1024, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false);
+    TestShadowCaster caster(mEdgeData, indexBuffer, false);
+    Light light;
+    light.setType(Light::LT_DIRECTIONAL);
+    light.setDirection(-1, -0.5f, -0.25f);
+
+    // Three faces are lit, the silhouette is a hexagon
+    ShadowCaster::ShadowVolumeBuild build;
+    CPPUNIT_ASSERT(caster._prepareShadowVolume(SHADOWTYPE_STENCIL_ADDITIVE, &light,
+        &indexBuffer, false, 100, 0, build));
+    ShadowCaster::_findShadowVolumeSilhouette(build);
+    CPPUNIT_ASSERT_EQUAL(size_t(6), build.silhouetteEdgeStarts[1] - build.silhouetteEdgeStarts[0]);
+    CPPUNIT_ASSERT_EQUAL(size_t(6), static_cast<size_t>(
+        std::count(build.lightFacings.begin(), build.lightFacings.end(), 1)));
+    CPPUNIT_ASSERT_EQUAL(size_t(6 * 6), build.indexCount);
+
+    // One triangle per edge when extruding to infinity, plus the 6 light
+    // facing triangles for the light cap and a fan of 5 triangles from the
+    // first edge for the dark cap
+    build.flags = SRF_EXTRUDE_TO_INFINITY | SRF_INCLUDE_LIGHT_CAP | SRF_INCLUDE_DARK_CAP;
+    ShadowCaster::_findShadowVolumeSilhouette(build);
+    CPPUNIT_ASSERT_EQUAL(size_t(6), build.lightFacingCounts[0]);
+    CPPUNIT_ASSERT_EQUAL(size_t((6 + 6 + 5) * 3), build.indexCount);
+}
+//--------------------------------------------------------------------------
+void ShadowVolumeTests::testBuildMatchesGenerated()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    HardwareIndexBufferSharedPtr indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+        HardwareIndexBuffer::IT_16BIT, 1024, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false);
+    Light lights[3];
+    setUpLights(lights);
+
+    static const unsigned long flagSets[] = {
+        0,
+        SRF_INCLUDE_LIGHT_CAP,
+        SRF_INCLUDE_DARK_CAP,
+        SRF_INCLUDE_LIGHT_CAP | SRF_INCLUDE_DARK_CAP,
+        SRF_EXTRUDE_TO_INFINITY,
+        SRF_EXTRUDE_TO_INFINITY | SRF_INCLUDE_LIGHT_CAP | SRF_INCLUDE_DARK_CAP
+    };
+
+    for (int separateLightCap = 0; separateLightCap < 2; ++separateLightCap)
+    {
+        TestShadowCaster generated(mEdgeData, indexBuffer, separateLightCap != 0);
+        TestShadowCaster built(mEdgeData, indexBuffer, separateLightCap != 0);
+
+        for (size_t l = 0; l < 3; ++l)
+        {
+            for (size_t f = 0; f < sizeof(flagSets) / sizeof(flagSets[0]); ++f)
+            {
+                IndexList expected = generateShadowVolume(generated, lights[l], indexBuffer, flagSets[f]);
+
+                ShadowCaster::ShadowVolumeBuild build;
+                CPPUNIT_ASSERT(built._prepareShadowVolume(SHADOWTYPE_STENCIL_ADDITIVE, &lights[l],
+                    &indexBuffer, false, 100, flagSets[f], build));
+                ShadowCaster::_findShadowVolumeSilhouette(build);
+
+                // Start past the beginning, as if other volumes came first
+                build.indexStart = 5;
+                IndexList indexes(build.indexStart + build.indexCount);
+                ShadowCaster::_writeShadowVolumeIndexes(build, &indexes[build.indexStart]);
+
+                IndexList actual;
+                collectIndexes(built.mShadowRenderables, &indexes[0], flagSets[f], actual);
+                CPPUNIT_ASSERT(expected == actual);
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void ShadowVolumeTests::testSharedEdgeList()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    HardwareIndexBufferSharedPtr indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+        HardwareIndexBuffer::IT_16BIT, 1024, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, false);
+    Light lights[3];
+    setUpLights(lights);
+    const unsigned long flags = SRF_INCLUDE_LIGHT_CAP | SRF_INCLUDE_DARK_CAP;
+
+    // Casters sharing the edge list have their silhouettes found before any
+    // of them is written, as the SceneManager does
+    TestShadowCaster* casters[3];
+    ShadowCaster::ShadowVolumeBuild builds[3];
+    size_t numIndexes = 0;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        casters[i] = OGRE_NEW TestShadowCaster(mEdgeData, indexBuffer, false);
+        casters[i]->_prepareShadowVolume(SHADOWTYPE_STENCIL_ADDITIVE, &lights[i],
+            &indexBuffer, false, 100, flags, builds[i]);
+        ShadowCaster::_findShadowVolumeSilhouette(builds[i]);
+        builds[i].indexStart = numIndexes;
+        numIndexes += builds[i].indexCount;
+    }
+
+    IndexList indexes(numIndexes);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        ShadowCaster::_writeShadowVolumeIndexes(builds[i], &indexes[builds[i].indexStart]);
+    }
+
+    TestShadowCaster generated(mEdgeData, indexBuffer, false);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        IndexList expected = generateShadowVolume(generated, lights[i], indexBuffer, flags);
+        IndexList actual;
+        collectIndexes(casters[i]->mShadowRenderables, &indexes[0], flags, actual);
+        CPPUNIT_ASSERT(expected == actual);
+        OGRE_DELETE casters[i];
+    }
+}
+//--------------------------------------------------------------------------
+void ShadowVolumeTests::testParallelMatchesSerial()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    NullRenderSystemFixture fixture;
+    Root* root = fixture.setUp();
+    DefaultWorkQueue* wq = static_cast<DefaultWorkQueue*>(root->getWorkQueue());
+    wq->setWorkerThreadCount(3);
+    wq->startup(true);
+
+    Light lights[3];
+    setUpLights(lights);
+    const unsigned long flags = SRF_INCLUDE_LIGHT_CAP | SRF_INCLUDE_DARK_CAP;
+
+    RecordingSceneManager* serialMgr = OGRE_NEW RecordingSceneManager();
+    RecordingSceneManager* parallelMgr = OGRE_NEW RecordingSceneManager();
+
+    // separate light caps set the culling and depth state between renderables,
+    // which needs a render system but not an initialised one
+    RenderSystem* rs = root->getRenderSystem();
+    serialMgr->_setDestinationRenderSystem(rs);
+    parallelMgr->_setDestinationRenderSystem(rs);
+
+    // Enough casters for the volumes of a light to wrap the index buffer
+    vector<TestShadowCaster*>::type serialCasters, parallelCasters;
+    for (size_t i = 0; i < 40; ++i)
+    {
+        bool separateLightCap = i % 2 != 0;
+        serialCasters.push_back(OGRE_NEW TestShadowCaster(mEdgeData,
+            serialMgr->getShadowIndexBuffer(), separateLightCap));
+        parallelCasters.push_back(OGRE_NEW TestShadowCaster(mEdgeData,
+            parallelMgr->getShadowIndexBuffer(), separateLightCap));
+    }
+
+    for (size_t l = 0; l < 3; ++l)
+    {
+        serialMgr->renderSerial(serialCasters, lights[l], flags);
+        parallelMgr->renderParallel(parallelCasters, lights[l], flags, 4);
+    }
+    CPPUNIT_ASSERT(!serialMgr->mRendered.empty());
+    CPPUNIT_ASSERT(serialMgr->mRendered == parallelMgr->mRendered);
+
+    for (size_t i = 0; i < serialCasters.size(); ++i)
+    {
+        OGRE_DELETE serialCasters[i];
+        OGRE_DELETE parallelCasters[i];
+    }
+    OGRE_DELETE parallelMgr;
+    OGRE_DELETE serialMgr;
+    fixture.tearDown();
+}
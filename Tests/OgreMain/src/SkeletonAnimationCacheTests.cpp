@@ -0,0 +1,220 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "SkeletonAnimationCacheTests.h"
+#include "OgreAnimation.h"
+#include "OgreKeyFrame.h"
+#include "OgreBone.h"
+#include "OgreSkeletonManager.h"
+#include "OgreResourceGroupManager.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(SkeletonAnimationCacheTests);
+
+static const size_t NUM_BONES = 3;
+
+//--------------------------------------------------------------------------
+void SkeletonAnimationCacheTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    OGRE_NEW ResourceGroupManager();
+    OGRE_NEW SkeletonManager();
+
+    mSkeleton = SkeletonManager::getSingleton().create("SkeletonAnimationCacheTests",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+    mSkeleton->load();
+    Bone* root = mSkeleton->createBone("root", 0);
+    Bone* arm = root->createChild(1, Vector3(0, 1, 0));
+    arm->createChild(2, Vector3(0, 1, 0));
+    mSkeleton->setBindingPose();
+
+    const char* names[] = { "Walk", "Wave" };
+    for (int a = 0; a < 2; ++a)
+    {
+        Animation* anim = mSkeleton->createAnimation(names[a], 1.0f);
+        for (unsigned short b = 0; b < NUM_BONES; ++b)
+        {
+            NodeAnimationTrack* track = anim->createNodeTrack(b, mSkeleton->getBone(b));
+            for (int k = 0; k <= 10; ++k)
+            {
+                Real t = k * 0.1f;
+                TransformKeyFrame* kf = track->createNodeKeyFrame(t);
+                kf->setTranslate(Vector3(t * (a + 1), 0, b * t));
+                kf->setRotation(Quaternion(Radian(t * (b + 1) * (a ? -1 : 1)), Vector3::UNIT_Z));
+            }
+        }
+    }
+
+    for (int i = 0; i < 2; ++i)
+    {
+        mInstances[i] = OGRE_NEW SkeletonInstance(mSkeleton);
+        mInstances[i]->load();
+        mStates[i] = OGRE_NEW AnimationStateSet();
+        mInstances[i]->_initAnimationState(mStates[i]);
+    }
+
+    mCache = OGRE_NEW SkeletonAnimationCache();
+}
+//--------------------------------------------------------------------------
+void SkeletonAnimationCacheTests::tearDown()
+{
+    OGRE_DELETE mCache;
+    for (int i = 0; i < 2; ++i)
+    {
+        OGRE_DELETE mStates[i];
+        OGRE_DELETE mInstances[i];
+    }
+    mSkeleton.setNull();
+
+    OGRE_DELETE SkeletonManager::getSingletonPtr();
+    OGRE_DELETE ResourceGroupManager::getSingletonPtr();
+}
+//--------------------------------------------------------------------------
+void SkeletonAnimationCacheTests::play(AnimationStateSet* states, const String& name, Real time,
+    Real weight)
+{
+    AnimationStateIterator it = states->getAnimationStateIterator();
+    while (it.hasMoreElements())
+    {
+        AnimationState* state = it.getNext();
+        state->setEnabled(state->getAnimationName() == name);
+        state->setTimePosition(time);
+        state->setWeight(weight);
+    }
+}
+//--------------------------------------------------------------------------
+bool SkeletonAnimationCacheTests::matchesEvaluation(SkeletonInstance* instance,
+    AnimationStateSet* states, const Matrix4* matrices)
+{
+    Matrix4 expected[NUM_BONES];
+    instance->setAnimationState(*states);
+    instance->_getBoneMatrices(expected);
+    for (size_t b = 0; b < NUM_BONES; ++b)
+    {
+        if (expected[b] != matrices[b])
+            return false;
+    }
+    return true;
+}
+//--------------------------------------------------------------------------
+void SkeletonAnimationCacheTests::testHitMatchesEvaluation()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Matrix4 matrices[2][NUM_BONES];
+    play(mStates[0], "Walk", 0.35f);
+    play(mStates[1], "Walk", 0.35f);
+
+    CPPUNIT_ASSERT(!mCache->getBoneMatrices(mInstances[0], *mStates[0], matrices[0]));
+    CPPUNIT_ASSERT(mCache->getBoneMatrices(mInstances[1], *mStates[1], matrices[1]));
+    CPPUNIT_ASSERT(matchesEvaluation(mInstances[0], mStates[0], matrices[0]));
+    CPPUNIT_ASSERT(matchesEvaluation(mInstances[1], mStates[1], matrices[1]));
+
+    SkeletonAnimationCache::Stats stats = mCache->getStats();
+    CPPUNIT_ASSERT_EQUAL((size_t)2, stats.lookups);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, stats.hits);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, stats.entries);
+}
+//--------------------------------------------------------------------------
+void SkeletonAnimationCacheTests::testDifferentPosesMiss()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Matrix4 matrices[NUM_BONES];
+    play(mStates[0], "Walk", 0.35f);
+    mCache->getBoneMatrices(mInstances[0], *mStates[0], matrices);
+
+    // Other time, animation, weight and blend mode
+    play(mStates[1], "Walk", 0.4f);
+    CPPUNIT_ASSERT(!mCache->getBoneMatrices(mInstances[1], *mStates[1], matrices));
+    play(mStates[1], "Wave", 0.35f);
+    CPPUNIT_ASSERT(!mCache->getBoneMatrices(mInstances[1], *mStates[1], matrices));
+    CPPUNIT_ASSERT(matchesEvaluation(mInstances[1], mStates[1], matrices));
+    play(mStates[1], "Walk", 0.35f, 0.5f);
+    CPPUNIT_ASSERT(!mCache->getBoneMatrices(mInstances[1], *mStates[1], matrices));
+    play(mStates[1], "Walk", 0.35f);
+    mInstances[1]->setBlendMode(ANIMBLEND_CUMULATIVE);
+    CPPUNIT_ASSERT(!mCache->getBoneMatrices(mInstances[1], *mStates[1], matrices));
+
+    CPPUNIT_ASSERT_EQUAL((size_t)0, mCache->getStats().hits);
+    CPPUNIT_ASSERT_EQUAL((size_t)5, mCache->getStats().entries);
+}
+//--------------------------------------------------------------------------
+void SkeletonAnimationCacheTests::testTimeQuantum()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Matrix4 matrices[2][NUM_BONES];
+    mCache->setTimeQuantum(0.1f);
+    play(mStates[0], "Walk", 0.31f);
+    play(mStates[1], "Walk", 0.38f);
+
+    CPPUNIT_ASSERT(!mCache->getBoneMatrices(mInstances[0], *mStates[0], matrices[0]));
+    CPPUNIT_ASSERT(mCache->getBoneMatrices(mInstances[1], *mStates[1], matrices[1]));
+    // Both get the pose at the start of the step, whichever came first
+    play(mStates[0], "Walk", Math::Floor(0.31f / 0.1f) * 0.1f);
+    CPPUNIT_ASSERT(matchesEvaluation(mInstances[0], mStates[0], matrices[0]));
+    CPPUNIT_ASSERT(matchesEvaluation(mInstances[0], mStates[0], matrices[1]));
+
+    // Next step of time
+    play(mStates[1], "Walk", 0.41f);
+    CPPUNIT_ASSERT(!mCache->getBoneMatrices(mInstances[1], *mStates[1], matrices[1]));
+}
+//--------------------------------------------------------------------------
+void SkeletonAnimationCacheTests::testBlendMaskNotCached()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Matrix4 matrices[NUM_BONES];
+    play(mStates[0], "Walk", 0.35f);
+    mStates[0]->getAnimationState("Walk")->createBlendMask(NUM_BONES, 0.5f);
+
+    CPPUNIT_ASSERT(!mCache->getBoneMatrices(mInstances[0], *mStates[0], matrices));
+    CPPUNIT_ASSERT(!mCache->getBoneMatrices(mInstances[0], *mStates[0], matrices));
+    CPPUNIT_ASSERT(matchesEvaluation(mInstances[0], mStates[0], matrices));
+    CPPUNIT_ASSERT_EQUAL((size_t)0, mCache->getStats().lookups);
+}
+//--------------------------------------------------------------------------
+void SkeletonAnimationCacheTests::testClear()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Matrix4 matrices[NUM_BONES];
+    play(mStates[0], "Walk", 0.35f);
+    mCache->getBoneMatrices(mInstances[0], *mStates[0], matrices);
+    mCache->clear();
+
+    SkeletonAnimationCache::Stats stats = mCache->getStats();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.lookups);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.entries);
+    CPPUNIT_ASSERT(!mCache->getBoneMatrices(mInstances[0], *mStates[0], matrices));
+}
@@ -0,0 +1,192 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "SoftwareVertexBlendTests.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreVertexIndexData.h"
+#include "OgreMesh.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(SoftwareVertexBlendTests);
+
+static const size_t NUM_VERTICES = 16;
+
+//--------------------------------------------------------------------------
+void SoftwareVertexBlendTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mBufMgr = OGRE_NEW DefaultHardwareBufferManager();
+
+    // Positions and normals in one buffer, weights and indices in another
+    mSource = OGRE_NEW VertexData();
+    mSource->vertexCount = NUM_VERTICES;
+    VertexDeclaration* decl = mSource->vertexDeclaration;
+    size_t offset = decl->addElement(0, 0, VET_FLOAT3, VES_POSITION).getSize();
+    decl->addElement(0, offset, VET_FLOAT3, VES_NORMAL);
+    offset = decl->addElement(1, 0, VET_FLOAT2, VES_BLEND_WEIGHTS).getSize();
+    decl->addElement(1, offset, VET_UBYTE4, VES_BLEND_INDICES);
+
+    HardwareVertexBufferSharedPtr geom = mBufMgr->createVertexBuffer(
+        decl->getVertexSize(0), NUM_VERTICES, HardwareBuffer::HBU_STATIC);
+    HardwareVertexBufferSharedPtr blend = mBufMgr->createVertexBuffer(
+        decl->getVertexSize(1), NUM_VERTICES, HardwareBuffer::HBU_STATIC);
+    mSource->vertexBufferBinding->setBinding(0, geom);
+    mSource->vertexBufferBinding->setBinding(1, blend);
+
+    float* pGeom = static_cast<float*>(geom->lock(HardwareBuffer::HBL_DISCARD));
+    unsigned char* pBlend = static_cast<unsigned char*>(blend->lock(HardwareBuffer::HBL_DISCARD));
+    for (size_t v = 0; v < NUM_VERTICES; ++v)
+    {
+        Vector3 pos(Real(v % 4), Real(v / 4), Real(v) * 0.5f);
+        Vector3 norm = pos.normalisedCopy();
+        *pGeom++ = pos.x; *pGeom++ = pos.y; *pGeom++ = pos.z;
+        *pGeom++ = norm.x; *pGeom++ = norm.y; *pGeom++ = norm.z;
+
+        float* pWeights = reinterpret_cast<float*>(pBlend);
+        pWeights[0] = Real(v) / NUM_VERTICES;
+        pWeights[1] = 1 - pWeights[0];
+        unsigned char* pIndices = pBlend + 2 * sizeof(float);
+        pIndices[0] = 0;
+        pIndices[1] = 1;
+        pIndices[2] = pIndices[3] = 0;
+        pBlend += blend->getVertexSize();
+    }
+    blend->unlock();
+    geom->unlock();
+
+    mMatrices[0].makeTransform(Vector3(1, 2, 3), Vector3::UNIT_SCALE, 
+        Quaternion(Degree(30), Vector3::UNIT_Y));
+    mMatrices[1].makeTransform(Vector3(-2, 0, 1), Vector3(2, 2, 2), 
+        Quaternion(Degree(-45), Vector3::UNIT_X));
+    mBlendMatrices[0] = &mMatrices[0];
+    mBlendMatrices[1] = &mMatrices[1];
+}
+//--------------------------------------------------------------------------
+void SoftwareVertexBlendTests::tearDown()
+{
+    OGRE_DELETE mSource;
+    OGRE_DELETE mBufMgr;
+}
+//--------------------------------------------------------------------------
+VertexData* SoftwareVertexBlendTests::createTarget()
+{
+    VertexData* target = OGRE_NEW VertexData();
+    target->vertexCount = NUM_VERTICES;
+    size_t offset = target->vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION).getSize();
+    target->vertexDeclaration->addElement(0, offset, VET_FLOAT3, VES_NORMAL);
+    target->vertexBufferBinding->setBinding(0, mBufMgr->createVertexBuffer(
+        target->vertexDeclaration->getVertexSize(0), NUM_VERTICES, HardwareBuffer::HBU_DYNAMIC));
+    return target;
+}
+//--------------------------------------------------------------------------
+bool SoftwareVertexBlendTests::targetsMatch(VertexData* a, VertexData* b)
+{
+    HardwareVertexBufferSharedPtr bufA = a->vertexBufferBinding->getBuffer(0);
+    HardwareVertexBufferSharedPtr bufB = b->vertexBufferBinding->getBuffer(0);
+    const float* pA = static_cast<const float*>(bufA->lock(HardwareBuffer::HBL_READ_ONLY));
+    const float* pB = static_cast<const float*>(bufB->lock(HardwareBuffer::HBL_READ_ONLY));
+
+    bool match = true;
+    for (size_t i = 0; i < NUM_VERTICES * 6; ++i)
+        match = match && Math::RealEqual(pA[i], pB[i], 1e-5f);
+
+    bufB->unlock();
+    bufA->unlock();
+    return match;
+}
+//--------------------------------------------------------------------------
+void SoftwareVertexBlendTests::testSplitBlendMatchesBlend()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    VertexData* expected = createTarget();
+    VertexData* actual = createTarget();
+
+    Mesh::softwareVertexBlend(mSource, expected, mBlendMatrices, 2, true);
+
+    Mesh::VertexBlendLockMap locks;
+    Mesh::SoftwareVertexBlendData data;
+    Mesh::_lockForSoftwareVertexBlend(mSource, actual, true, locks, data);
+    Mesh::_softwareVertexBlend(data, mBlendMatrices);
+    Mesh::_unlockForSoftwareVertexBlend(locks);
+
+    CPPUNIT_ASSERT(locks.empty());
+    CPPUNIT_ASSERT(targetsMatch(expected, actual));
+
+    // The blend must have moved the vertices
+    const float* pSrc = static_cast<const float*>(
+        mSource->vertexBufferBinding->getBuffer(0)->lock(HardwareBuffer::HBL_READ_ONLY));
+    const float* pDest = static_cast<const float*>(
+        actual->vertexBufferBinding->getBuffer(0)->lock(HardwareBuffer::HBL_READ_ONLY));
+    CPPUNIT_ASSERT(!Math::RealEqual(pSrc[0], pDest[0], 1e-3f) || 
+        !Math::RealEqual(pSrc[1], pDest[1], 1e-3f) || !Math::RealEqual(pSrc[2], pDest[2], 1e-3f));
+    actual->vertexBufferBinding->getBuffer(0)->unlock();
+    mSource->vertexBufferBinding->getBuffer(0)->unlock();
+
+    OGRE_DELETE actual;
+    OGRE_DELETE expected;
+}
+//--------------------------------------------------------------------------
+void SoftwareVertexBlendTests::testSharedSourceLockedOnce()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    VertexData* expected = createTarget();
+    VertexData* first = createTarget();
+    VertexData* second = createTarget();
+
+    Mesh::softwareVertexBlend(mSource, expected, mBlendMatrices, 2, true);
+
+    // Both blends read the same source buffers, which must only be locked once
+    Mesh::VertexBlendLockMap locks;
+    Mesh::SoftwareVertexBlendData firstData, secondData;
+    Mesh::_lockForSoftwareVertexBlend(mSource, first, true, locks, firstData);
+    Mesh::_lockForSoftwareVertexBlend(mSource, second, true, locks, secondData);
+    CPPUNIT_ASSERT_EQUAL((size_t)4, locks.size());
+    CPPUNIT_ASSERT(mSource->vertexBufferBinding->getBuffer(0)->isLocked());
+    CPPUNIT_ASSERT(mSource->vertexBufferBinding->getBuffer(1)->isLocked());
+    CPPUNIT_ASSERT(firstData.srcPos == secondData.srcPos);
+
+    Mesh::_softwareVertexBlend(secondData, mBlendMatrices);
+    Mesh::_softwareVertexBlend(firstData, mBlendMatrices);
+    Mesh::_unlockForSoftwareVertexBlend(locks);
+
+    CPPUNIT_ASSERT(!mSource->vertexBufferBinding->getBuffer(0)->isLocked());
+    CPPUNIT_ASSERT(!mSource->vertexBufferBinding->getBuffer(1)->isLocked());
+    CPPUNIT_ASSERT(!first->vertexBufferBinding->getBuffer(0)->isLocked());
+    CPPUNIT_ASSERT(targetsMatch(expected, first));
+    CPPUNIT_ASSERT(targetsMatch(expected, second));
+
+    OGRE_DELETE second;
+    OGRE_DELETE first;
+    OGRE_DELETE expected;
+}
@@ -0,0 +1,84 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BvhSceneManagerTests_H__
+#define __BvhSceneManagerTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OgreBuildSettings.h"
+#include "OgrePrerequisites.h"
+#include "NullRenderSystemTestUtils.h"
+
+namespace Ogre
+{
+    class BvhSceneManager;
+}
+
+class BvhSceneManagerTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(BvhSceneManagerTests);
+    CPPUNIT_TEST(testFrustumCulling);
+    CPPUNIT_TEST(testQueries);
+    CPPUNIT_TEST(testBatchedQueries);
+    CPPUNIT_TEST(testIntersectionQuery);
+    CPPUNIT_TEST(testRebuild);
+    CPPUNIT_TEST(testRemoveNodes);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    NullRenderSystemFixture mFixture;
+    Ogre::Root* mRoot;
+    Ogre::BvhSceneManager* mSceneMgr;
+    Ogre::Camera* mCamera;
+    Ogre::vector<Ogre::SceneNode*>::type mNodes;
+    Ogre::vector<Ogre::MovableObject*>::type mObjects;
+    Ogre::uint32 mRandomState;
+
+    Ogre::Real random(Ogre::Real min, Ogre::Real max);
+    /// Adds a node at a random position holding an object of a random size
+    void createNode(void);
+    /// Moves some of the nodes and updates the scene graph
+    void moveNodes(size_t step);
+    /// Checks that every tree node is bounded by its children or its scene node
+    void checkTree(void);
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testFrustumCulling();
+    void testQueries();
+    void testBatchedQueries();
+    void testIntersectionQuery();
+    void testRebuild();
+    void testRemoveNodes();
+};
+
+#endif
@@ -0,0 +1,571 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "BvhSceneManagerTests.h"
+#include "OgreBvhSceneManager.h"
+#include "OgreBvhNode.h"
+#include "OgreRoot.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreMovableObject.h"
+#include "OgreRenderWindow.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+#ifdef OGRE_BUILD_RENDERSYSTEM_NULL
+CPPUNIT_TEST_SUITE_REGISTRATION(BvhSceneManagerTests);
+#endif
+
+namespace
+{
+    /// Object of a given size counting the times it is queued
+    class BoxObject : public MovableObject
+    {
+    public:
+        size_t mQueued;
+        AxisAlignedBox mBox;
+
+        BoxObject(const String& name, Real halfSize)
+            : MovableObject(name), mQueued(0)
+            , mBox(-Vector3::UNIT_SCALE * halfSize, Vector3::UNIT_SCALE * halfSize)
+        {
+        }
+
+        const String& getMovableType(void) const
+        {
+            static String type = "BoxObject";
+            return type;
+        }
+        const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+        Real getBoundingRadius(void) const { return mBox.getHalfSize().length(); }
+        void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) {}
+        void _updateRenderQueue(RenderQueue* queue) { ++mQueued; }
+    };
+
+    typedef set<MovableObject*>::type ObjectSet;
+    typedef std::pair<MovableObject*, MovableObject*> ObjectPair;
+    typedef set<ObjectPair>::type ObjectPairSet;
+
+    ObjectPair orderedPair(MovableObject* a, MovableObject* b)
+    {
+        return a < b ? ObjectPair(a, b) : ObjectPair(b, a);
+    }
+
+    void getResults(RegionSceneQuery* query, ObjectSet& results)
+    {
+        results.clear();
+        SceneQueryResultMovableList& movables = query->execute().movables;
+        for (SceneQueryResultMovableList::iterator i = movables.begin(); i != movables.end(); ++i)
+        {
+            // each object is reported once
+            CPPUNIT_ASSERT(results.insert(*i).second);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------
+void BvhSceneManagerTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRandomState = 12345;
+    // plugins only register their scene managers once the first window
+    // is created, although nothing is rendered
+    mRoot = mFixture.setUp("BvhSceneManagerTests");
+
+    mSceneMgr = static_cast<BvhSceneManager*>(
+        mRoot->createSceneManager("BvhSceneManager"));
+
+    mCamera = mSceneMgr->createCamera("BvhSceneManagerTests");
+    mCamera->setPosition(Vector3(0, 0, 600));
+    mCamera->lookAt(Vector3::ZERO);
+    mCamera->setNearClipDistance(1);
+    mCamera->setFarClipDistance(1000);
+
+    for (size_t i = 0; i < 2000; ++i)
+        createNode();
+    mSceneMgr->_updateSceneGraph(mCamera);
+}
+//--------------------------------------------------------------------------
+void BvhSceneManagerTests::tearDown()
+{
+    mSceneMgr->clearScene();
+    for (size_t i = 0; i < mObjects.size(); ++i)
+        OGRE_DELETE mObjects[i];
+    mObjects.clear();
+    mNodes.clear();
+    mRoot->destroySceneManager(mSceneMgr);
+    mFixture.tearDown();
+}
+//--------------------------------------------------------------------------
+Real BvhSceneManagerTests::random(Real min, Real max)
+{
+    mRandomState = mRandomState * 1664525 + 1013904223;
+    return min + (max - min) * Real(mRandomState >> 8) / Real(1 << 24);
+}
+//--------------------------------------------------------------------------
+void BvhSceneManagerTests::createNode(void)
+{
+    // mostly small objects, with a few large ones
+    Real size = random(0, 1) < 0.95f ? random(0.5f, 5) : random(20, 200);
+    BoxObject* obj = OGRE_NEW BoxObject(
+        "BoxObject" + StringConverter::toString(mObjects.size()), size);
+    obj->_notifyManager(mSceneMgr);
+    obj->setQueryFlags(mObjects.size() % 2 ? 1 : 2);
+
+    SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(
+        Vector3(random(-1000, 1000), random(-500, 500), random(-1000, 1000)));
+    node->attachObject(obj);
+
+    mNodes.push_back(node);
+    mObjects.push_back(obj);
+}
+//--------------------------------------------------------------------------
+void BvhSceneManagerTests::moveNodes(size_t step)
+{
+    for (size_t i = step % 3; i < mNodes.size(); i += 3)
+    {
+        if (mNodes[i])
+            mNodes[i]->translate(random(-50, 50), random(-50, 50), random(-50, 50));
+    }
+    mSceneMgr->_updateSceneGraph(mCamera);
+}
+//--------------------------------------------------------------------------
+void BvhSceneManagerTests::checkTree(void)
+{
+    const Bvh& bvh = mSceneMgr->getBvh();
+    if (bvh.getRoot() == Bvh::NULL_NODE)
+    {
+        CPPUNIT_ASSERT_EQUAL((size_t)0, bvh.getLeafCount());
+        return;
+    }
+
+    size_t leaves = 0;
+    vector<Bvh::NodeIndex>::type stack(1, bvh.getRoot());
+    while (!stack.empty())
+    {
+        Bvh::NodeIndex index = stack.back();
+        stack.pop_back();
+        const Bvh::Node& node = bvh.getNode(index);
+
+        if (node.isLeaf())
+        {
+            ++leaves;
+            CPPUNIT_ASSERT(node.item);
+            CPPUNIT_ASSERT_EQUAL(index, node.item->_getBvhLeaf());
+            CPPUNIT_ASSERT(node.item->isInSceneGraph());
+            CPPUNIT_ASSERT(node.item->_getWorldAABB() == AxisAlignedBox(node.min, node.max));
+            continue;
+        }
+
+        const Bvh::Node& child0 = bvh.getNode(node.children[0]);
+        const Bvh::Node& child1 = bvh.getNode(node.children[1]);
+        CPPUNIT_ASSERT_EQUAL(index, child0.parent);
+        CPPUNIT_ASSERT_EQUAL(index, child1.parent);
+        Vector3 min = child0.min, max = child0.max;
+        min.makeFloor(child1.min);
+        max.makeCeil(child1.max);
+        CPPUNIT_ASSERT(min == node.min && max == node.max);
+
+        stack.push_back(node.children[0]);
+        stack.push_back(node.children[1]);
+    }
+    CPPUNIT_ASSERT_EQUAL(bvh.getLeafCount(), leaves);
+}
+//--------------------------------------------------------------------------
+void BvhSceneManagerTests::testFrustumCulling()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    for (size_t step = 0; step < 10; ++step)
+    {
+        moveNodes(step);
+        checkTree();
+
+        for (size_t i = 0; i < mObjects.size(); ++i)
+            static_cast<BoxObject*>(mObjects[i])->mQueued = 0;
+
+        VisibleObjectsBoundsInfo bounds;
+        bounds.reset();
+        mSceneMgr->_findVisibleObjects(mCamera, &bounds, false);
+
+        size_t visible = 0;
+        for (size_t i = 0; i < mObjects.size(); ++i)
+        {
+            size_t expected = mCamera->isVisible(mObjects[i]->getWorldBoundingBox(true)) ? 1 : 0;
+            CPPUNIT_ASSERT_EQUAL(expected, static_cast<BoxObject*>(mObjects[i])->mQueued);
+            visible += expected;
+        }
+        CPPUNIT_ASSERT(visible > 0 && visible < mObjects.size());
+    }
+}
+//--------------------------------------------------------------------------
+void BvhSceneManagerTests::testQueries()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    RaySceneQuery* rayQuery = mSceneMgr->createRayQuery(Ray(), 1);
+    AxisAlignedBoxSceneQuery* boxQuery = mSceneMgr->createAABBQuery(AxisAlignedBox(), 1);
+    SphereSceneQuery* sphereQuery = mSceneMgr->createSphereQuery(Sphere(), 1);
+    PlaneBoundedVolumeListSceneQuery* volumeQuery =
+        mSceneMgr->createPlaneBoundedVolumeQuery(PlaneBoundedVolumeList(), 1);
+
+    ObjectSet results, expected;
+    for (size_t step = 0; step < 20; ++step)
+    {
+        // the queries see moved nodes before the scene graph is updated again
+        for (size_t i = step % 3; i < mNodes.size(); i += 3)
+            mNodes[i]->translate(random(-50, 50), random(-50, 50), random(-50, 50));
+        mSceneMgr->getRootSceneNode()->_update(true, false);
+
+        // centred on an object matching the query mask, so that every query hits
+        Vector3 centre = mNodes[(2 * step + 1) * 97 % mNodes.size()]->_getDerivedPosition();
+        Ray ray(centre, Vector3(random(-1, 1), random(-1, 1), random(-1, 1)).normalisedCopy());
+        AxisAlignedBox box(centre - Vector3(random(10, 300)), centre + Vector3(random(10, 300)));
+        Sphere sphere(centre, random(10, 300));
+        PlaneBoundedVolumeList volumes;
+        volumes.push_back(mCamera->getPlaneBoundedVolume());
+
+        rayQuery->setRay(ray);
+        RaySceneQueryResult& rayResults = rayQuery->execute();
+        results.clear();
+        for (RaySceneQueryResult::iterator i = rayResults.begin(); i != rayResults.end(); ++i)
+            CPPUNIT_ASSERT(results.insert(i->movable).second);
+        expected.clear();
+        for (size_t i = 0; i < mObjects.size(); ++i)
+        {
+            if ((mObjects[i]->getQueryFlags() & 1) &&
+                ray.intersects(mObjects[i]->getWorldBoundingBox()).first)
+                expected.insert(mObjects[i]);
+        }
+        CPPUNIT_ASSERT(results == expected);
+
+        boxQuery->setBox(box);
+        getResults(boxQuery, results);
+        expected.clear();
+        for (size_t i = 0; i < mObjects.size(); ++i)
+        {
+            if ((mObjects[i]->getQueryFlags() & 1) &&
+                box.intersects(mObjects[i]->getWorldBoundingBox()))
+                expected.insert(mObjects[i]);
+        }
+        CPPUNIT_ASSERT(!expected.empty());
+        CPPUNIT_ASSERT(results == expected);
+
+        sphereQuery->setSphere(sphere);
+        getResults(sphereQuery, results);
+        expected.clear();
+        for (size_t i = 0; i < mObjects.size(); ++i)
+        {
+            if ((mObjects[i]->getQueryFlags() & 1) &&
+                sphere.intersects(mObjects[i]->getWorldBoundingBox()))
+                expected.insert(mObjects[i]);
+        }
+        CPPUNIT_ASSERT(results == expected);
+
+        volumeQuery->setVolumes(volumes);
+        getResults(volumeQuery, results);
+        expected.clear();
+        for (size_t i = 0; i < mObjects.size(); ++i)
+        {
+            if ((mObjects[i]->getQueryFlags() & 1) &&
+                volumes[0].intersects(mObjects[i]->getWorldBoundingBox()))
+                expected.insert(mObjects[i]);
+        }
+        CPPUNIT_ASSERT(!expected.empty());
+        CPPUNIT_ASSERT(results == expected);
+    }
+
+    mSceneMgr->destroyQuery(rayQuery);
+    mSceneMgr->destroyQuery(boxQuery);
+    mSceneMgr->destroyQuery(sphereQuery);
+    mSceneMgr->destroyQuery(volumeQuery);
+}
+//--------------------------------------------------------------------------
+void BvhSceneManagerTests::testBatchedQueries()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // enough queries for several packets, the last one incomplete
+    const size_t count = 150;
+    const size_t maxHits = 4;
+    vector<Ray>::type rays;
+    vector<Sphere>::type spheres;
+    vector<AxisAlignedBox>::type boxes;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Vector3 centre(random(-800, 800), random(-400, 400), random(-800, 800));
+        rays.push_back(Ray(centre, Vector3(random(-1, 1), random(-1, 1), random(-1, 1)).normalisedCopy()));
+        spheres.push_back(Sphere(centre, random(10, 100)));
+        boxes.push_back(AxisAlignedBox(centre - Vector3(random(10, 100)), centre + Vector3(random(10, 100))));
+    }
+    // the batches see moved nodes before the scene graph is updated again
+    for (size_t i = 0; i < mNodes.size(); i += 3)
+        mNodes[i]->translate(random(-50, 50), random(-50, 50), random(-50, 50));
+    mSceneMgr->getRootSceneNode()->_update(true, false);
+
+    vector<SceneQueryBatchHit>::type hits(count * maxHits);
+    vector<size_t>::type hitCounts(count);
+    for (size_t threads = 1; threads <= 4; threads += 3)
+    {
+        // the calling thread takes part, so it needs one worker less
+        DefaultWorkQueue* wq = static_cast<DefaultWorkQueue*>(mRoot->getWorkQueue());
+        wq->setWorkerThreadCount(threads - 1);
+        wq->startup(true);
+        mSceneMgr->setSceneQueryThreadCount(threads);
+
+        size_t stored = mSceneMgr->executeRayQueries(&rays[0], count, &hits[0], maxHits, &hitCounts[0], 1);
+        size_t expectedStored = 0;
+        for (size_t q = 0; q < count; ++q)
+        {
+            // the nearest hits, nearest first
+            vector<std::pair<Real, MovableObject*> >::type expected;
+            for (size_t i = 0; i < mObjects.size(); ++i)
+            {
+                std::pair<bool, Real> result = rays[q].intersects(mObjects[i]->getWorldBoundingBox());
+                if ((mObjects[i]->getQueryFlags() & 1) && result.first)
+                    expected.push_back(std::make_pair(result.second, mObjects[i]));
+            }
+            std::sort(expected.begin(), expected.end());
+            CPPUNIT_ASSERT_EQUAL(expected.size(), hitCounts[q]);
+            for (size_t h = 0; h < std::min(expected.size(), maxHits); ++h)
+            {
+                // objects at the same distance may come in any order
+                const SceneQueryBatchHit& hit = hits[q * maxHits + h];
+                CPPUNIT_ASSERT_EQUAL(expected[h].first, hit.distance);
+                CPPUNIT_ASSERT(hit.movable->getQueryFlags() & 1);
+                CPPUNIT_ASSERT_EQUAL(hit.distance,
+                    rays[q].intersects(hit.movable->getWorldBoundingBox()).second);
+            }
+            expectedStored += std::min(expected.size(), maxHits);
+        }
+        CPPUNIT_ASSERT_EQUAL(expectedStored, stored);
+
+        mSceneMgr->executeSphereQueries(&spheres[0], count, &hits[0], maxHits, &hitCounts[0], 1);
+        for (size_t q = 0; q < count; ++q)
+        {
+            ObjectSet expected;
+            for (size_t i = 0; i < mObjects.size(); ++i)
+            {
+                if ((mObjects[i]->getQueryFlags() & 1) &&
+                    spheres[q].intersects(mObjects[i]->getWorldBoundingBox()))
+                    expected.insert(mObjects[i]);
+            }
+            CPPUNIT_ASSERT_EQUAL(expected.size(), hitCounts[q]);
+            for (size_t h = 0; h < std::min(expected.size(), maxHits); ++h)
+                CPPUNIT_ASSERT(expected.count(hits[q * maxHits + h].movable));
+        }
+
+        mSceneMgr->executeBoxQueries(&boxes[0], count, &hits[0], maxHits, &hitCounts[0], 1);
+        for (size_t q = 0; q < count; ++q)
+        {
+            ObjectSet expected;
+            for (size_t i = 0; i < mObjects.size(); ++i)
+            {
+                if ((mObjects[i]->getQueryFlags() & 1) &&
+                    boxes[q].intersects(mObjects[i]->getWorldBoundingBox()))
+                    expected.insert(mObjects[i]);
+            }
+            CPPUNIT_ASSERT_EQUAL(expected.size(), hitCounts[q]);
+            for (size_t h = 0; h < std::min(expected.size(), maxHits); ++h)
+                CPPUNIT_ASSERT(expected.count(hits[q * maxHits + h].movable));
+        }
+    }
+    mSceneMgr->setSceneQueryThreadCount(1);
+}
+//--------------------------------------------------------------------------
+void BvhSceneManagerTests::testIntersectionQuery()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // a second object on some nodes, and one everywhere
+    for (size_t i = 0; i < 100; ++i)
+    {
+        BoxObject* obj = OGRE_NEW BoxObject(
+            "ExtraObject" + StringConverter::toString(i), random(1, 20));
+        obj->_notifyManager(mSceneMgr);
+        mNodes[i * 7]->attachObject(obj);
+        mObjects.push_back(obj);
+    }
+    BoxObject* everywhere = OGRE_NEW BoxObject("Everywhere", 1);
+    everywhere->mBox.setInfinite();
+    everywhere->_notifyManager(mSceneMgr);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(everywhere);
+    mObjects.push_back(everywhere);
+    mSceneMgr->_updateSceneGraph(mCamera);
+
+    IntersectionSceneQuery* query = mSceneMgr->createIntersectionQuery();
+    for (size_t step = 0; step < 3; ++step)
+    {
+        moveNodes(step);
+
+        IntersectionSceneQueryResult& result = query->execute();
+        ObjectPairSet pairs, expected;
+        for (SceneQueryMovableIntersectionList::iterator i = result.movables2movables.begin();
+            i != result.movables2movables.end(); ++i)
+        {
+            CPPUNIT_ASSERT(i->first != i->second);
+            CPPUNIT_ASSERT(pairs.insert(orderedPair(i->first, i->second)).second);
+        }
+
+        for (size_t i = 0; i < mObjects.size(); ++i)
+        {
+            for (size_t j = i + 1; j < mObjects.size(); ++j)
+            {
+                if (mObjects[i]->getWorldBoundingBox().intersects(mObjects[j]->getWorldBoundingBox()))
+                    expected.insert(orderedPair(mObjects[i], mObjects[j]));
+            }
+        }
+        CPPUNIT_ASSERT(expected.size() > mObjects.size());
+        CPPUNIT_ASSERT(pairs == expected);
+    }
+    mSceneMgr->destroyQuery(query);
+}
+//--------------------------------------------------------------------------
+void BvhSceneManagerTests::testRebuild()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // the nodes created at once were built into the tree
+    const BvhSceneManager::Statistics& stats = mSceneMgr->getBvhStatistics();
+    CPPUNIT_ASSERT_EQUAL(mNodes.size(), stats.leafCount);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, stats.rebuildCount);
+    CPPUNIT_ASSERT_EQUAL(stats.buildCost, stats.cost);
+    CPPUNIT_ASSERT(stats.depth < 40);
+    Real buildCost = stats.buildCost;
+
+    // refitting never rebuilds without checks
+    size_t interval = 0;
+    CPPUNIT_ASSERT(mSceneMgr->setOption("RebuildCheckInterval", &interval));
+    for (size_t step = 0; step < 30; ++step)
+    {
+        // swap positions, which makes the refitted tree much worse
+        for (size_t i = 0; i + 1 < mNodes.size(); i += 2)
+        {
+            Vector3 pos = mNodes[i]->getPosition();
+            mNodes[i]->setPosition(mNodes[i + 1]->getPosition());
+            mNodes[i + 1]->setPosition(pos);
+        }
+        mSceneMgr->_updateSceneGraph(mCamera);
+    }
+    checkTree();
+    mSceneMgr->getBvhStatistics();
+    CPPUNIT_ASSERT_EQUAL((size_t)1, stats.rebuildCount);
+    CPPUNIT_ASSERT(stats.refitCount >= mNodes.size() * 30);
+
+    // the swaps did not change the bounds of the scene, only the tree
+    for (size_t step = 0; step < 200 && mSceneMgr->getBvhStatistics().cost < buildCost * 1.3f; ++step)
+    {
+        for (size_t i = 0; i < mNodes.size(); ++i)
+        {
+            size_t j = static_cast<size_t>(random(0, Real(mNodes.size() - 1)));
+            Vector3 pos = mNodes[i]->getPosition();
+            mNodes[i]->setPosition(mNodes[j]->getPosition());
+            mNodes[j]->setPosition(pos);
+        }
+        mSceneMgr->_updateSceneGraph(mCamera);
+    }
+    CPPUNIT_ASSERT(mSceneMgr->getBvhStatistics().cost >= buildCost * 1.3f);
+
+    // the next check rebuilds the tree
+    interval = 2;
+    Real threshold = 1.3f;
+    CPPUNIT_ASSERT(mSceneMgr->setOption("RebuildCheckInterval", &interval));
+    CPPUNIT_ASSERT(mSceneMgr->setOption("RebuildThreshold", &threshold));
+    mSceneMgr->_updateSceneGraph(mCamera);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, mSceneMgr->getBvhStatistics().rebuildCount);
+    mSceneMgr->_updateSceneGraph(mCamera);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, mSceneMgr->getBvhStatistics().rebuildCount);
+    CPPUNIT_ASSERT(stats.cost < buildCost * 1.3f);
+    checkTree();
+
+    Real value = 0;
+    CPPUNIT_ASSERT(mSceneMgr->getOption("RebuildThreshold", &value));
+    CPPUNIT_ASSERT_EQUAL(threshold, value);
+}
+//--------------------------------------------------------------------------
+void BvhSceneManagerTests::testRemoveNodes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // destroyed, detached, emptied and infinite nodes
+    for (size_t i = 0; i < mNodes.size(); i += 4)
+    {
+        mSceneMgr->destroySceneNode(mNodes[i]);
+        mNodes[i] = 0;
+    }
+    for (size_t i = 1; i < mNodes.size(); i += 8)
+        mNodes[i]->getParentSceneNode()->removeChild(mNodes[i]);
+    for (size_t i = 2; i < mNodes.size(); i += 8)
+        mNodes[i]->detachAllObjects();
+    for (size_t i = 3; i < mNodes.size(); i += 40)
+        static_cast<BoxObject*>(mNodes[i]->getAttachedObject(0))->mBox.setInfinite();
+    for (size_t i = 3; i < mNodes.size(); i += 40)
+        mNodes[i]->needUpdate();
+
+    size_t inTree = 0, infinite = 0;
+    for (size_t i = 0; i < mNodes.size(); ++i)
+    {
+        if (!mNodes[i] || !mNodes[i]->isInSceneGraph() || !mNodes[i]->numAttachedObjects())
+            continue;
+        if (i % 40 == 3)
+            ++infinite;
+        else
+            ++inTree;
+    }
+
+    moveNodes(0);
+    checkTree();
+    const BvhSceneManager::Statistics& stats = mSceneMgr->getBvhStatistics();
+    CPPUNIT_ASSERT_EQUAL(inTree, stats.leafCount);
+    CPPUNIT_ASSERT_EQUAL(infinite, stats.infiniteCount);
+
+    // infinite nodes are always visible and found by every query
+    ObjectSet results;
+    AxisAlignedBoxSceneQuery* query =
+        mSceneMgr->createAABBQuery(AxisAlignedBox(Vector3(5000), Vector3(5001)), 3);
+    getResults(query, results);
+    CPPUNIT_ASSERT_EQUAL(infinite, results.size());
+    mSceneMgr->destroyQuery(query);
+
+    // nodes put back in the graph are found again
+    for (size_t i = 1; i < mNodes.size(); i += 8)
+        mSceneMgr->getRootSceneNode()->addChild(mNodes[i]);
+    moveNodes(1);
+    checkTree();
+    CPPUNIT_ASSERT_EQUAL(inTree + (mNodes.size() + 7) / 8, mSceneMgr->getBvhStatistics().leafCount);
+
+    mSceneMgr->clearScene();
+    mNodes.clear();
+    checkTree();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, mSceneMgr->getBvhStatistics().leafCount);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, stats.infiniteCount);
+}
@@ -0,0 +1,96 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __OctreeOcclusionCullingTests_H__
+#define __OctreeOcclusionCullingTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OgreBuildSettings.h"
+#include "OgrePrerequisites.h"
+#include "OgreRenderObjectListener.h"
+#include "NullRenderSystemTestUtils.h"
+
+namespace Ogre
+{
+    class OctreeSceneManager;
+}
+
+/** Hardware occlusion culling of the OctreeSceneManager, rendered with the
+    Null render system which answers the queries with its software depth
+    rasteriser.
+*/
+class OctreeOcclusionCullingTests : public CppUnit::TestFixture,
+    public Ogre::RenderObjectListener
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(OctreeOcclusionCullingTests);
+    CPPUNIT_TEST(testHiddenObjectsCulled);
+    CPPUNIT_TEST(testObjectsShowUpAgain);
+    CPPUNIT_TEST(testQueriesShared);
+    CPPUNIT_TEST(testDisabled);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    NullRenderSystemFixture mFixture;
+    Ogre::Root* mRoot;
+    Ogre::OctreeSceneManager* mSceneMgr;
+    Ogre::Camera* mCamera;
+    /// Wall between the camera and the hidden boxes
+    Ogre::ManualObject* mWall;
+    /// Box in front of the wall
+    Ogre::ManualObject* mFront;
+    /// Boxes behind the wall
+    Ogre::vector<Ogre::ManualObject*>::type mHidden;
+    /// Renderables rendered by the last frame
+    Ogre::set<Ogre::Renderable*>::type mRendered;
+
+    /// Creates a box of the given size at the given position
+    Ogre::ManualObject* createBox(const Ogre::Vector3& position, Ogre::Real halfSize);
+    /// Renders a frame, recording the renderables rendered
+    void renderFrame(void);
+    /// Returns whether an object was rendered by the last frame
+    bool isRendered(Ogre::ManualObject* object) const;
+    /// Returns the number of hidden boxes rendered by the last frame
+    size_t countHiddenRendered(void) const;
+
+public:
+    void setUp();
+    void tearDown();
+
+    void notifyRenderSingleObject(Ogre::Renderable* rend, const Ogre::Pass* pass,
+        const Ogre::AutoParamDataSource* source, const Ogre::LightList* pLightList,
+        bool suppressRenderStateChanges);
+
+    void testHiddenObjectsCulled();
+    void testObjectsShowUpAgain();
+    void testQueriesShared();
+    void testDisabled();
+};
+
+#endif
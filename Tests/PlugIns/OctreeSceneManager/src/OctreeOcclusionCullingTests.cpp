@@ -0,0 +1,234 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OctreeOcclusionCullingTests.h"
+#include "OgreOctreeSceneManager.h"
+#include "OgreRoot.h"
+#include "OgreRenderWindow.h"
+#include "OgreRenderSystem.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreViewport.h"
+#include "OgreManualObject.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+#ifdef OGRE_BUILD_RENDERSYSTEM_NULL
+CPPUNIT_TEST_SUITE_REGISTRATION(OctreeOcclusionCullingTests);
+#endif
+
+//--------------------------------------------------------------------------
+void OctreeOcclusionCullingTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    // the queries are answered by the software rasteriser of the Null
+    // render system, which draws into the window and is off by default
+    mFixture.setConfigOption("Occlusion Queries", "Yes");
+    mRoot = mFixture.setUp("OctreeOcclusionCullingTests", 256);
+    RenderWindow* window = mFixture.getWindow();
+
+    mSceneMgr = static_cast<OctreeSceneManager*>(mRoot->createSceneManager("OctreeSceneManager"));
+    mSceneMgr->addRenderObjectListener(this);
+
+    mCamera = mSceneMgr->createCamera("OctreeOcclusionCullingTests");
+    mCamera->setPosition(Vector3(0, 0, 500));
+    mCamera->lookAt(Vector3::ZERO);
+    mCamera->setNearClipDistance(1);
+    mCamera->setFarClipDistance(5000);
+    mCamera->setAspectRatio(1);
+    window->addViewport(mCamera);
+
+    // a wall filling the view, with a grid of boxes behind it spread over
+    // several octants and a box in front of it
+    mWall = mSceneMgr->createManualObject();
+    mWall->begin("BaseWhiteNoLighting", RenderOperation::OT_TRIANGLE_STRIP);
+    mWall->position(-1000, -1000, 0);
+    mWall->position(1000, -1000, 0);
+    mWall->position(-1000, 1000, 0);
+    mWall->position(1000, 1000, 0);
+    mWall->end();
+    mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(mWall);
+
+    for (int x = 0; x < 4; ++x)
+    {
+        for (int y = 0; y < 4; ++y)
+            mHidden.push_back(createBox(Vector3(x * 200.0f - 300, y * 200.0f - 300, -300), 15));
+    }
+    mFront = createBox(Vector3(0, 0, 200), 15);
+}
+//--------------------------------------------------------------------------
+void OctreeOcclusionCullingTests::tearDown()
+{
+    mHidden.clear();
+    mRendered.clear();
+    mRoot->destroySceneManager(mSceneMgr);
+    mFixture.tearDown();
+}
+//--------------------------------------------------------------------------
+ManualObject* OctreeOcclusionCullingTests::createBox(const Vector3& position, Real halfSize)
+{
+    ManualObject* box = mSceneMgr->createManualObject();
+    box->begin("BaseWhiteNoLighting", RenderOperation::OT_TRIANGLE_LIST);
+    for (int i = 0; i < 8; ++i)
+    {
+        box->position((i & 1) ? halfSize : -halfSize,
+            (i & 2) ? halfSize : -halfSize, (i & 4) ? halfSize : -halfSize);
+    }
+    static const uint16 indexes[36] = {
+        0, 2, 3, 0, 3, 1, 4, 5, 7, 4, 7, 6, 0, 4, 6, 0, 6, 2,
+        1, 3, 7, 1, 7, 5, 0, 1, 5, 0, 5, 4, 2, 6, 7, 2, 7, 3 };
+    for (int i = 0; i < 36; ++i)
+        box->index(indexes[i]);
+    box->end();
+
+    mSceneMgr->getRootSceneNode()->createChildSceneNode(position)->attachObject(box);
+    return box;
+}
+//--------------------------------------------------------------------------
+void OctreeOcclusionCullingTests::renderFrame(void)
+{
+    mRendered.clear();
+    mRoot->renderOneFrame();
+}
+//--------------------------------------------------------------------------
+void OctreeOcclusionCullingTests::notifyRenderSingleObject(Renderable* rend, const Pass* pass,
+    const AutoParamDataSource* source, const LightList* pLightList, bool suppressRenderStateChanges)
+{
+    mRendered.insert(rend);
+}
+//--------------------------------------------------------------------------
+bool OctreeOcclusionCullingTests::isRendered(ManualObject* object) const
+{
+    return mRendered.find(object->getSection(0)) != mRendered.end();
+}
+//--------------------------------------------------------------------------
+size_t OctreeOcclusionCullingTests::countHiddenRendered(void) const
+{
+    size_t count = 0;
+    for (size_t i = 0; i < mHidden.size(); ++i)
+    {
+        if (isRendered(mHidden[i]))
+            ++count;
+    }
+    return count;
+}
+//--------------------------------------------------------------------------
+void OctreeOcclusionCullingTests::testHiddenObjectsCulled()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+    mSceneMgr->setOcclusionCullingCamera(mCamera);
+
+    // nothing is known yet, so everything is rendered and queried
+    renderFrame();
+    CPPUNIT_ASSERT_EQUAL(mHidden.size(), countHiddenRendered());
+    CPPUNIT_ASSERT(isRendered(mWall));
+    CPPUNIT_ASSERT(isRendered(mFront));
+    CPPUNIT_ASSERT(mSceneMgr->getOcclusionStatistics().queriesIssued > 0);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, mSceneMgr->getOcclusionStatistics().objectsCulled);
+
+    // the boxes behind the wall are then skipped, but still queried
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        renderFrame();
+        const OctreeSceneManager::OcclusionStatistics& stats = mSceneMgr->getOcclusionStatistics();
+        CPPUNIT_ASSERT_EQUAL((size_t)0, countHiddenRendered());
+        CPPUNIT_ASSERT(isRendered(mWall));
+        CPPUNIT_ASSERT(isRendered(mFront));
+        CPPUNIT_ASSERT_EQUAL(mHidden.size(), stats.objectsCulled);
+        CPPUNIT_ASSERT(stats.octantsCulled > 0);
+        CPPUNIT_ASSERT(stats.octantsQueried >= stats.octantsCulled);
+        CPPUNIT_ASSERT_EQUAL((size_t)0, stats.queriesPending);
+    }
+}
+//--------------------------------------------------------------------------
+void OctreeOcclusionCullingTests::testObjectsShowUpAgain()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+    mSceneMgr->setOcclusionCullingCamera(mCamera);
+    renderFrame();
+    renderFrame();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, countHiddenRendered());
+
+    // the queries of this frame find the boxes visible, which are rendered
+    // from the next one on
+    mWall->setVisible(false);
+    renderFrame();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, countHiddenRendered());
+    renderFrame();
+    CPPUNIT_ASSERT_EQUAL(mHidden.size(), countHiddenRendered());
+    CPPUNIT_ASSERT_EQUAL((size_t)0, mSceneMgr->getOcclusionStatistics().objectsCulled);
+
+    // and culled again once the wall is back, visible octants being queried
+    // again after the query interval only
+    mWall->setVisible(true);
+    for (unsigned int frame = 0; frame < mSceneMgr->getOcclusionQueryInterval() + 2; ++frame)
+        renderFrame();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, countHiddenRendered());
+    CPPUNIT_ASSERT(isRendered(mFront));
+}
+//--------------------------------------------------------------------------
+void OctreeOcclusionCullingTests::testQueriesShared()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+    // visible octants aren't queried again during the test, so only the
+    // hidden octants are, which share queries once hidden a few times
+    mSceneMgr->setOcclusionCullingCamera(mCamera);
+    mSceneMgr->setOcclusionQueryInterval(100);
+    for (int frame = 0; frame < 5; ++frame)
+        renderFrame();
+
+    const OctreeSceneManager::OcclusionStatistics& stats = mSceneMgr->getOcclusionStatistics();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, countHiddenRendered());
+    CPPUNIT_ASSERT_EQUAL(stats.octantsCulled, stats.octantsQueried);
+    CPPUNIT_ASSERT(stats.octantsQueried > 1);
+    CPPUNIT_ASSERT(stats.queriesIssued < stats.octantsQueried);
+}
+//--------------------------------------------------------------------------
+void OctreeOcclusionCullingTests::testDisabled()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        renderFrame();
+        CPPUNIT_ASSERT_EQUAL(mHidden.size(), countHiddenRendered());
+        CPPUNIT_ASSERT_EQUAL((size_t)0, mSceneMgr->getOcclusionStatistics().queriesIssued);
+    }
+
+    mSceneMgr->setOcclusionCullingCamera(mCamera);
+    renderFrame();
+    renderFrame();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, countHiddenRendered());
+
+    // switching it off restores the plain frustum culling
+    mSceneMgr->setOcclusionCullingCamera(0);
+    renderFrame();
+    CPPUNIT_ASSERT_EQUAL(mHidden.size(), countHiddenRendered());
+}
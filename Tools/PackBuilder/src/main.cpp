@@ -0,0 +1,110 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2016 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Ogre.h"
+#include "OgreFileSystem.h"
+#include "OgrePackArchive.h"
+
+#include <iostream>
+
+using namespace std;
+using namespace Ogre;
+
+void help(void)
+{
+    // Print help message
+    cout << endl << "OgrePackBuilder: Packs a folder of media into an OGRE pack file." << endl << endl;
+    cout << "Usage: OgrePackBuilder [opts] sourcefolder destfile" << endl;
+    cout << "-c codec       = Compression of the chunks, 'lz4' (default), 'zlib' or 'none'" << endl;
+    cout << "                 zlib packs are smaller but slower to read, and can only be" << endl;
+    cout << "                 built and read with zip support" << endl;
+    cout << "-s chunksize   = Uncompressed size of the chunks in KiB (default 64)" << endl;
+    cout << "sourcefolder   = folder to pack, with all its sub folders" << endl;
+    cout << "destfile       = name of the pack to write" << endl;
+
+    cout << endl;
+}
+
+int main(int numargs, char** args)
+{
+    UnaryOptionList unOptList;
+    BinaryOptionList binOptList;
+    binOptList["-c"] = "lz4";
+    binOptList["-s"] = StringConverter::toString(PackArchive::DEFAULT_CHUNK_SIZE / 1024);
+
+    int startIdx = findCommandLineOpts(numargs, args, unOptList, binOptList);
+    if (numargs - startIdx != 2)
+    {
+        help();
+        return -1;
+    }
+    String source(args[startIdx]);
+    String dest(args[startIdx + 1]);
+
+    PackArchive::Codec codec;
+    if (binOptList["-c"] == "lz4")
+        codec = PackArchive::CODEC_LZ4;
+    else if (binOptList["-c"] == "zlib")
+        codec = PackArchive::CODEC_ZLIB;
+    else if (binOptList["-c"] == "none")
+        codec = PackArchive::CODEC_NONE;
+    else
+    {
+        cout << "Unknown codec " << binOptList["-c"] << endl;
+        help();
+        return -1;
+    }
+    size_t chunkSize = StringConverter::parseSizeT(binOptList["-s"]) * 1024;
+
+    int retCode = 0;
+    LogManager* logMgr = new LogManager();
+    logMgr->createLog("OgrePackBuilder.log", true, false);
+    try
+    {
+        FileSystemArchive folder(source, "FileSystem", true);
+        folder.load();
+
+        Timer timer;
+        PackArchiveWriter writer(dest, codec, chunkSize);
+        size_t files = writer.addArchive(&folder);
+        writer.finish();
+
+        cout << "Packed " << files << " files, " << writer.getDataSize() << " bytes into "
+            << writer.getCompressedSize() << " bytes of chunks in "
+            << timer.getMilliseconds() << " ms" << endl;
+    }
+    catch (Exception& e)
+    {
+        cout << "Exception caught: " << e.getDescription() << endl;
+        retCode = 1;
+    }
+
+    delete logMgr;
+
+    return retCode;
+}
@@ -401,7 +401,18 @@ namespace Ogre {
             Animation* pAnim = pSkeleton->getAnimation(i);
             msg = "Exporting animation: " + pAnim->getName();
             LogManager::getSingleton().logMessage(msg);
-            writeAnimation(animsNode, pAnim);
+            if (pAnim->hasCompressedNodeTracks())
+            {
+                // XML only knows regular keyframes
+                Animation* expanded = pAnim->clone(pAnim->getName());
+                expanded->decompressNodeTracks(pSkeleton);
+                writeAnimation(animsNode, expanded);
+                OGRE_DELETE expanded;
+            }
+            else
+            {
+                writeAnimation(animsNode, pAnim);
+            }
             LogManager::getSingleton().logMessage("Animation exported.");
 
         }
@@ -71,6 +71,7 @@ struct XmlOptions
     bool tangentSplitRotated;
     bool reorganiseBuffers;
     bool optimiseAnimations;
+    bool compressAnimations;
     bool quietMode;
     bool d3d;
     bool gl;
@@ -98,6 +99,7 @@ void help(void)
     cout << "                 n0 and n1 must be in the same buffer source & adjacent" << endl;
     cout << "                 to each other for the merge to work." << endl;
     cout << "-o             = DON'T optimise out redundant tracks & keyframes" << endl;
+    cout << "-ac            = Compress skeleton animation tracks (lossy, smaller)" << endl;
     cout << "-d3d           = Prefer D3D packed colour formats (default on Windows)" << endl;
     cout << "-gl            = Prefer GL packed colour formats (default on non-Windows)" << endl;
     cout << "-E endian      = Set endian mode 'big' 'little' or 'native' (default)" << endl;
@@ -136,6 +138,7 @@ XmlOptions parseArgs(int numArgs, char **args)
     //opts.tangentSplitRotated = false;
     //opts.reorganiseBuffers = true;
     opts.optimiseAnimations = true;
+    opts.compressAnimations = false;
     opts.quietMode = false;
     opts.endian = Serializer::ENDIAN_NATIVE;
 
@@ -154,6 +157,7 @@ XmlOptions parseArgs(int numArgs, char **args)
     unOpt["-tm"] = false;
     unOpt["-tr"] = false;
     unOpt["-o"] = false;
+    unOpt["-ac"] = false;
     unOpt["-q"] = false;
     unOpt["-d3d"] = false;
     unOpt["-gl"] = false;
@@ -200,6 +204,12 @@ XmlOptions parseArgs(int numArgs, char **args)
             opts.optimiseAnimations = false;
         }
 
+        ui = unOpt.find("-ac");
+        if (ui->second)
+        {
+            opts.compressAnimations = true;
+        }
+
         bi = binOpt.find("-merge");
         if (!bi->second.empty())
         {
@@ -484,6 +494,13 @@ void XMLToBinary(XmlOptions opts)
         {
             newSkel->optimiseAllAnimations();
         }
+        if (opts.compressAnimations)
+        {
+            for (unsigned short i = 0; i < newSkel->getNumAnimations(); ++i)
+            {
+                newSkel->getAnimation(i)->compressNodeTracks();
+            }
+        }
         skeletonSerializer->exportSkeleton(newSkel.getPointer(), opts.dest, SKELETON_VERSION_LATEST, opts.endian);
 
         // Clean up the conversion skeleton